@@ -0,0 +1,226 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPTools.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkSMPTools.h"
+
+#include "vtkSMPToolsRuntime.h"
+#include "../STDThread/vtkSMPThreadPool.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+// Implementation dispatching to a back-end selected at run-time, among
+// Sequential, STDThread (always available) and OpenMP and TBB (when they
+// were found at build time). The thread local storage is that of STDThread,
+// which works with threads of any origin.
+
+namespace
+{
+enum
+{
+  SEQUENTIAL = 0,
+  STDTHREAD,
+  OPENMP,
+  TBB,
+  NUMBER_OF_BACKENDS
+};
+
+const char* const vtkSMPBackendNames[NUMBER_OF_BACKENDS] =
+{
+  "Sequential", "STDThread", "OpenMP", "TBB"
+};
+
+bool IsBackendEnabled(int backend)
+{
+  switch (backend)
+    {
+    case SEQUENTIAL:
+    case STDTHREAD:
+      return true;
+#ifdef VTK_SMP_RUNTIME_ENABLE_OPENMP
+    case OPENMP:
+      return true;
+#endif
+#ifdef VTK_SMP_RUNTIME_ENABLE_TBB
+    case TBB:
+      return true;
+#endif
+    default:
+      return false;
+    }
+}
+
+// Return the enabled back-end of the given name, -1 if there is none.
+int FindBackend(const char* name)
+{
+  if (!name)
+    {
+    return -1;
+    }
+  for (int i = 0; i < NUMBER_OF_BACKENDS; ++i)
+    {
+    if (strcmp(name, vtkSMPBackendNames[i]) == 0)
+      {
+      return IsBackendEnabled(i) ? i : -1;
+      }
+    }
+  return -1;
+}
+
+std::mutex BackendMutex;
+std::atomic<int> BackendInUse(-1);
+int NumberOfSpecifiedThreads = 0;
+
+// Apply the number of threads given to vtkSMPTools::Initialize() to a
+// back-end. Called with BackendMutex locked.
+void InitializeBackend(int backend, int numThreads)
+{
+  switch (backend)
+    {
+    case STDTHREAD:
+      vtk::detail::smp::vtkSMPThreadPoolInitialize(numThreads);
+      break;
+#ifdef VTK_SMP_RUNTIME_ENABLE_OPENMP
+    case OPENMP:
+      vtk::detail::smp::vtkSMPToolsOpenMPInitialize(numThreads);
+      break;
+#endif
+#ifdef VTK_SMP_RUNTIME_ENABLE_TBB
+    case TBB:
+      vtk::detail::smp::vtkSMPToolsTBBInitialize(numThreads);
+      break;
+#endif
+    default:
+      break;
+    }
+}
+
+// Return the back-end in use, selecting it on first use.
+int GetBackendInUse()
+{
+  int backend = BackendInUse.load();
+  if (backend < 0)
+    {
+    std::lock_guard<std::mutex> lock(BackendMutex);
+    backend = BackendInUse.load();
+    if (backend < 0)
+      {
+      backend = FindBackend(getenv("VTK_SMP_BACKEND_IN_USE"));
+      if (backend < 0)
+        {
+        backend = FindBackend(VTK_SMP_DEFAULT_BACKEND);
+        }
+      if (backend < 0)
+        {
+        backend = STDTHREAD;
+        }
+      BackendInUse.store(backend);
+      }
+    }
+  return backend;
+}
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPTools::SetBackend(const char* backend)
+{
+  int newBackend = FindBackend(backend);
+  if (newBackend < 0 || vtkSMPTools::IsParallelScope())
+    {
+    return false;
+    }
+  std::lock_guard<std::mutex> lock(BackendMutex);
+  if (NumberOfSpecifiedThreads > 0)
+    {
+    InitializeBackend(newBackend, NumberOfSpecifiedThreads);
+    }
+  BackendInUse.store(newBackend);
+  return true;
+}
+
+//--------------------------------------------------------------------------------
+const char* vtkSMPTools::GetBackend()
+{
+  return vtkSMPBackendNames[GetBackendInUse()];
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPTools::Initialize(int numThreads)
+{
+  int backend = GetBackendInUse();
+  std::lock_guard<std::mutex> lock(BackendMutex);
+  if (numThreads > 0)
+    {
+    NumberOfSpecifiedThreads = numThreads;
+    }
+  InitializeBackend(backend, numThreads);
+}
+
+//--------------------------------------------------------------------------------
+int vtkSMPTools::GetEstimatedNumberOfThreads()
+{
+  return vtk::detail::smp::GetNumberOfThreads();
+}
+
+//--------------------------------------------------------------------------------
+int vtk::detail::smp::GetNumberOfThreads()
+{
+  switch (GetBackendInUse())
+    {
+    case STDTHREAD:
+      return vtk::detail::smp::vtkSMPThreadPoolGetNumberOfThreads();
+#ifdef VTK_SMP_RUNTIME_ENABLE_OPENMP
+    case OPENMP:
+      return vtk::detail::smp::vtkSMPToolsOpenMPGetNumberOfThreads();
+#endif
+#ifdef VTK_SMP_RUNTIME_ENABLE_TBB
+    case TBB:
+      return vtk::detail::smp::vtkSMPToolsTBBGetNumberOfThreads();
+#endif
+    default:
+      return 1;
+    }
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::vtkSMPTools_Impl_For_Runtime(vtkIdType first,
+  vtkIdType last, vtkIdType grain, ExecuteFunctorPtrType functorExecuter,
+  void *functor)
+{
+  switch (GetBackendInUse())
+    {
+    case STDTHREAD:
+      vtk::detail::smp::vtkSMPThreadPoolFor(first, last, grain,
+                                            functorExecuter, functor);
+      break;
+#ifdef VTK_SMP_RUNTIME_ENABLE_OPENMP
+    case OPENMP:
+      vtk::detail::smp::vtkSMPToolsOpenMPFor(first, last, grain,
+                                             functorExecuter, functor);
+      break;
+#endif
+#ifdef VTK_SMP_RUNTIME_ENABLE_TBB
+    case TBB:
+      vtk::detail::smp::vtkSMPToolsTBBFor(first, last, grain,
+                                          functorExecuter, functor);
+      break;
+#endif
+    default:
+      functorExecuter(functor, first, last - first, last);
+      break;
+    }
+}
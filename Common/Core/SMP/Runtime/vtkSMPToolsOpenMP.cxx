@@ -0,0 +1,61 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsOpenMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#define VTK_SMP_RUNTIME_ENABLE_OPENMP
+#include "vtkSMPToolsRuntime.h"
+
+#include <omp.h>
+
+// The OpenMP back-end of the Runtime implementation (see
+// SMP/OpenMP/vtkSMPTools.cxx).
+
+namespace
+{
+int vtkSMPNumberOfSpecifiedThreads = 0;
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::vtkSMPToolsOpenMPInitialize(int numThreads)
+{
+  if (numThreads > 0)
+    {
+    vtkSMPNumberOfSpecifiedThreads = numThreads;
+    omp_set_num_threads(numThreads);
+    }
+}
+
+//--------------------------------------------------------------------------------
+int vtk::detail::smp::vtkSMPToolsOpenMPGetNumberOfThreads()
+{
+  return vtkSMPNumberOfSpecifiedThreads ? vtkSMPNumberOfSpecifiedThreads :
+         omp_get_max_threads();
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::vtkSMPToolsOpenMPFor(vtkIdType first, vtkIdType last,
+  vtkIdType grain, ExecuteFunctorPtrType functorExecuter, void *functor)
+{
+  if (grain <= 0)
+    {
+    vtkIdType estimateGrain = (last - first)/(omp_get_max_threads() * 4);
+    grain = (estimateGrain > 0) ? estimateGrain : 1;
+    }
+
+# pragma omp parallel for schedule(runtime)
+  for (vtkIdType from = first; from < last; from += grain)
+    {
+    functorExecuter(functor, from, grain, last);
+    }
+}
@@ -0,0 +1,51 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsRuntime.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// The optional back-ends of the Runtime vtkSMPTools implementation, each
+// built in its own translation unit with the flags it requires. This is an
+// internal header of vtkCommonCore.
+
+#ifndef vtkSMPToolsRuntime_h
+#define vtkSMPToolsRuntime_h
+
+#include "vtkSMPTools.h" // For ExecuteFunctorPtrType
+
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+#ifdef VTK_SMP_RUNTIME_ENABLE_OPENMP
+void vtkSMPToolsOpenMPInitialize(int numThreads);
+int vtkSMPToolsOpenMPGetNumberOfThreads();
+void vtkSMPToolsOpenMPFor(vtkIdType first, vtkIdType last, vtkIdType grain,
+                          ExecuteFunctorPtrType functorExecuter,
+                          void *functor);
+#endif
+
+#ifdef VTK_SMP_RUNTIME_ENABLE_TBB
+void vtkSMPToolsTBBInitialize(int numThreads);
+int vtkSMPToolsTBBGetNumberOfThreads();
+void vtkSMPToolsTBBFor(vtkIdType first, vtkIdType last, vtkIdType grain,
+                       ExecuteFunctorPtrType functorExecuter, void *functor);
+#endif
+
+}//namespace smp
+}//namespace detail
+}//namespace vtk
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSMPToolsRuntime.h
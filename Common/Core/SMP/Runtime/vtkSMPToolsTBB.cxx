@@ -0,0 +1,95 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsTBB.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#define VTK_SMP_RUNTIME_ENABLE_TBB
+#include "vtkSMPToolsRuntime.h"
+
+#include "vtkCriticalSection.h"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_scheduler_init.h>
+
+// The TBB back-end of the Runtime implementation (see
+// SMP/TBB/vtkSMPTools.cxx).
+
+namespace
+{
+using vtk::detail::smp::ExecuteFunctorPtrType;
+
+class FuncCall
+{
+  ExecuteFunctorPtrType Executer;
+  void *Functor;
+  vtkIdType Last;
+
+public:
+  FuncCall(ExecuteFunctorPtrType executer, void *functor, vtkIdType last)
+    : Executer(executer), Functor(functor), Last(last)
+    {
+    }
+
+  void operator() (const tbb::blocked_range<vtkIdType>& r) const
+    {
+      this->Executer(this->Functor, r.begin(), r.end() - r.begin(),
+                     this->Last);
+    }
+};
+
+bool vtkSMPToolsInitialized = false;
+int vtkTBBNumSpecifiedThreads = 0;
+vtkSimpleCriticalSection vtkSMPToolsCS;
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::vtkSMPToolsTBBInitialize(int numThreads)
+{
+  vtkSMPToolsCS.Lock();
+  if (!vtkSMPToolsInitialized)
+    {
+    // If numThreads <= 0, don't create a task_scheduler_init
+    // and let TBB do the default thing.
+    if (numThreads > 0)
+      {
+      static tbb::task_scheduler_init aInit(numThreads);
+      vtkTBBNumSpecifiedThreads = numThreads;
+      }
+    vtkSMPToolsInitialized = true;
+    }
+  vtkSMPToolsCS.Unlock();
+}
+
+//--------------------------------------------------------------------------------
+int vtk::detail::smp::vtkSMPToolsTBBGetNumberOfThreads()
+{
+  return vtkTBBNumSpecifiedThreads ? vtkTBBNumSpecifiedThreads
+    : tbb::task_scheduler_init::default_num_threads();
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::vtkSMPToolsTBBFor(vtkIdType first, vtkIdType last,
+  vtkIdType grain, ExecuteFunctorPtrType functorExecuter, void *functor)
+{
+  FuncCall call(functorExecuter, functor, last);
+  if (grain > 0)
+    {
+    tbb::parallel_for(tbb::blocked_range<vtkIdType>(first, last, grain),
+                      call);
+    }
+  else
+    {
+    tbb::parallel_for(tbb::blocked_range<vtkIdType>(first, last), call);
+    }
+}
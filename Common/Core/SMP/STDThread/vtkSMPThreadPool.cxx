@@ -0,0 +1,334 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPThreadPool.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkSMPThreadPool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A persistent pool of std::thread workers.
+//
+// Each worker owns a queue of tasks (chunks of the range of a For()). A
+// worker pops tasks from the back of its own queue, and when it runs out of
+// work, steals tasks from the front of the other queues. Threads that are
+// not part of the pool share one additional queue. The thread calling For()
+// queues the tasks of the range and then executes tasks itself until all of
+// them are done; a nested For(), called by a functor running in the pool,
+// therefore makes progress on the calling worker instead of blocking it.
+
+namespace
+{
+using vtk::detail::smp::ExecuteFunctorPtrType;
+
+// The state of one For() call, owned by the calling thread.
+struct Job
+{
+  ExecuteFunctorPtrType Executer;
+  void *Functor;
+  vtkIdType Grain;
+  vtkIdType Last;
+  std::atomic<vtkIdType> Remaining;
+};
+
+struct Task
+{
+  Job *J;
+  vtkIdType From;
+};
+
+struct TaskQueue
+{
+  std::mutex Mutex;
+  std::deque<Task> Tasks;
+};
+
+class ThreadPool;
+
+// The pool of which the current thread is a worker (NULL outside of any
+// pool), and the index of the queue it owns.
+VTK_THREAD_LOCAL ThreadPool *WorkerPool = NULL;
+VTK_THREAD_LOCAL int ThreadQueueIndex = -1;
+
+class ThreadPool
+{
+public:
+  explicit ThreadPool(int numThreads);
+  ~ThreadPool();
+
+  int GetNumberOfThreads() const
+  {
+    return this->NumberOfThreads;
+  }
+
+  void For(vtkIdType first, vtkIdType last, vtkIdType grain,
+           ExecuteFunctorPtrType functorExecuter, void *functor);
+
+private:
+  bool PopTask(int queueIdx, Task &task);
+  bool StealTask(int queueIdx, Task &task);
+  void RunTask(const Task &task);
+  void WorkerLoop(int queueIdx);
+
+  int NumberOfThreads;
+  // one queue per worker, plus one shared by the threads outside the pool
+  std::vector<TaskQueue*> Queues;
+  std::vector<std::thread> Threads;
+  std::atomic<vtkIdType> PendingTasks;
+  std::mutex WakeMutex;
+  std::condition_variable Wake;
+  bool Stop;
+
+  ThreadPool(const ThreadPool&);  // Not implemented.
+  void operator=(const ThreadPool&);  // Not implemented.
+};
+
+//--------------------------------------------------------------------------------
+// The calling thread participates in the work, so numThreads-1 workers are
+// started.
+ThreadPool::ThreadPool(int numThreads)
+  : NumberOfThreads(numThreads), PendingTasks(0), Stop(false)
+{
+  for (int i = 0; i < numThreads; ++i)
+    {
+    this->Queues.push_back(new TaskQueue);
+    }
+  for (int i = 0; i < numThreads - 1; ++i)
+    {
+    this->Threads.push_back(std::thread(&ThreadPool::WorkerLoop, this, i));
+    }
+}
+
+//--------------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+  {
+  std::lock_guard<std::mutex> lock(this->WakeMutex);
+  this->Stop = true;
+  }
+  this->Wake.notify_all();
+  for (size_t i = 0; i < this->Threads.size(); ++i)
+    {
+    this->Threads[i].join();
+    }
+  for (size_t i = 0; i < this->Queues.size(); ++i)
+    {
+    delete this->Queues[i];
+    }
+}
+
+//--------------------------------------------------------------------------------
+// Take the most recently queued task of the given queue.
+bool ThreadPool::PopTask(int queueIdx, Task &task)
+{
+  TaskQueue *queue = this->Queues[queueIdx];
+  std::lock_guard<std::mutex> lock(queue->Mutex);
+  if (queue->Tasks.empty())
+    {
+    return false;
+    }
+  task = queue->Tasks.back();
+  queue->Tasks.pop_back();
+  --this->PendingTasks;
+  return true;
+}
+
+//--------------------------------------------------------------------------------
+// Take the oldest task of another queue, visiting the queues starting after
+// the given one.
+bool ThreadPool::StealTask(int queueIdx, Task &task)
+{
+  int numQueues = static_cast<int>(this->Queues.size());
+  for (int i = 1; i < numQueues; ++i)
+    {
+    TaskQueue *queue = this->Queues[(queueIdx + i) % numQueues];
+    std::unique_lock<std::mutex> lock(queue->Mutex, std::try_to_lock);
+    if (lock.owns_lock() && !queue->Tasks.empty())
+      {
+      task = queue->Tasks.front();
+      queue->Tasks.pop_front();
+      --this->PendingTasks;
+      return true;
+      }
+    }
+  return false;
+}
+
+//--------------------------------------------------------------------------------
+void ThreadPool::RunTask(const Task &task)
+{
+  Job *job = task.J;
+  job->Executer(job->Functor, task.From, job->Grain, job->Last);
+  // the job may be released by its owner as soon as it is done
+  --job->Remaining;
+}
+
+//--------------------------------------------------------------------------------
+void ThreadPool::WorkerLoop(int queueIdx)
+{
+  WorkerPool = this;
+  ThreadQueueIndex = queueIdx;
+  Task task;
+  for (;;)
+    {
+    if (this->PopTask(queueIdx, task) || this->StealTask(queueIdx, task))
+      {
+      this->RunTask(task);
+      continue;
+      }
+
+    std::unique_lock<std::mutex> lock(this->WakeMutex);
+    while (!this->Stop && this->PendingTasks.load() == 0)
+      {
+      this->Wake.wait(lock);
+      }
+    if (this->Stop)
+      {
+      return;
+      }
+    }
+}
+
+//--------------------------------------------------------------------------------
+void ThreadPool::For(vtkIdType first, vtkIdType last, vtkIdType grain,
+                     ExecuteFunctorPtrType functorExecuter, void *functor)
+{
+  vtkIdType n = last - first;
+  if (grain <= 0)
+    {
+    vtkIdType estimateGrain = n / (this->NumberOfThreads * 4);
+    grain = (estimateGrain > 0) ? estimateGrain : 1;
+    }
+  vtkIdType numTasks = (n + grain - 1) / grain;
+
+  Job job;
+  job.Executer = functorExecuter;
+  job.Functor = functor;
+  job.Grain = grain;
+  job.Last = last;
+  job.Remaining = numTasks;
+
+  int queueIdx = (WorkerPool == this ? ThreadQueueIndex :
+                  this->NumberOfThreads - 1);
+  TaskQueue *queue = this->Queues[queueIdx];
+  {
+  std::lock_guard<std::mutex> lock(queue->Mutex);
+  for (vtkIdType from = first; from < last; from += grain)
+    {
+    Task task = { &job, from };
+    queue->Tasks.push_back(task);
+    }
+  this->PendingTasks += numTasks;
+  }
+  {
+  std::lock_guard<std::mutex> lock(this->WakeMutex);
+  }
+  this->Wake.notify_all();
+
+  // Help until all the tasks of this job are done. Tasks of other jobs may
+  // be executed meanwhile, which is how nested parallelism progresses.
+  Task task;
+  while (job.Remaining.load() > 0)
+    {
+    if (this->PopTask(queueIdx, task) || this->StealTask(queueIdx, task))
+      {
+      this->RunTask(task);
+      }
+    else
+      {
+      std::this_thread::yield();
+      }
+    }
+}
+
+//--------------------------------------------------------------------------------
+// The current pool. Each For() called from outside of a pool holds a
+// reference to the pool it runs on, so that a pool replaced by Initialize()
+// is only deleted (joining its threads) once the loops using it are done.
+// The last reference is released when the library is unloaded.
+std::mutex PoolMutex;
+std::shared_ptr<ThreadPool> Pool;
+
+int GetDefaultNumberOfThreads()
+{
+  int numThreads = static_cast<int>(std::thread::hardware_concurrency());
+  return numThreads > 0 ? numThreads : 1;
+}
+
+std::shared_ptr<ThreadPool> GetPool()
+{
+  std::lock_guard<std::mutex> lock(PoolMutex);
+  if (!Pool)
+    {
+    Pool = std::make_shared<ThreadPool>(GetDefaultNumberOfThreads());
+    }
+  return Pool;
+}
+}
+
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::vtkSMPThreadPoolInitialize(int numThreads)
+{
+  std::lock_guard<std::mutex> lock(PoolMutex);
+  if (numThreads <= 0)
+    {
+    if (!Pool)
+      {
+      Pool = std::make_shared<ThreadPool>(GetDefaultNumberOfThreads());
+      }
+    return;
+    }
+  if (Pool && (Pool->GetNumberOfThreads() == numThreads || WorkerPool))
+    {
+    return;
+    }
+  // loops still running on the previous pool keep it alive until they end
+  Pool = std::make_shared<ThreadPool>(numThreads);
+}
+
+//--------------------------------------------------------------------------------
+int vtk::detail::smp::vtkSMPThreadPoolGetNumberOfThreads()
+{
+  if (WorkerPool)
+    {
+    return WorkerPool->GetNumberOfThreads();
+    }
+  return GetPool()->GetNumberOfThreads();
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::vtkSMPThreadPoolFor(vtkIdType first, vtkIdType last,
+  vtkIdType grain, ExecuteFunctorPtrType functorExecuter, void *functor)
+{
+  // A nested For() stays on the pool of the calling worker, which is kept
+  // alive by the outer For().
+  if (WorkerPool)
+    {
+    WorkerPool->For(first, last, grain, functorExecuter, functor);
+    return;
+    }
+  std::shared_ptr<ThreadPool> pool = GetPool();
+  if (pool->GetNumberOfThreads() == 1)
+    {
+    functorExecuter(functor, first, last - first, last);
+    return;
+    }
+  pool->For(first, last, grain, functorExecuter, functor);
+}
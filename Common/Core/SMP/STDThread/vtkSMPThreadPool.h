@@ -0,0 +1,53 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPThreadPool.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// The thread pool of the STDThread vtkSMPTools back-end, also used by the
+// Runtime back-end. This is an internal header of vtkCommonCore.
+
+#ifndef vtkSMPThreadPool_h
+#define vtkSMPThreadPool_h
+
+#include "vtkSMPTools.h" // For ExecuteFunctorPtrType
+
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+// Description:
+// Create the pool with numThreads threads (including the calling thread),
+// or with one thread per core when numThreads is 0. An existing pool of a
+// different size is replaced unless called from one of its threads; loops
+// running on the replaced pool complete on it before it is deleted.
+void vtkSMPThreadPoolInitialize(int numThreads);
+
+// Description:
+// Return the number of threads of the pool, creating it if needed.
+int vtkSMPThreadPoolGetNumberOfThreads();
+
+// Description:
+// Execute the functor over [first,last) in chunks of grain items (estimated
+// when grain is 0) and return when all of them are done.
+void vtkSMPThreadPoolFor(vtkIdType first, vtkIdType last, vtkIdType grain,
+                         ExecuteFunctorPtrType functorExecuter, void *functor);
+
+}//namespace smp
+}//namespace detail
+}//namespace vtk
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSMPThreadPool.h
@@ -0,0 +1,82 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsAPI.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkSMPTools.h"
+
+#include <cstring>
+
+// Parts of vtkSMPTools common to all back-ends: the tracking of nested
+// parallel operations and, unless the back-end is selected at run-time,
+// the back-end selection API.
+
+namespace
+{
+// Number of functor executions in progress on the current thread.
+VTK_THREAD_LOCAL int vtkSMPScopeDepth = 0;
+
+// Whether nested For() calls are handed over to the back-end, rather than
+// run serially. It is only written between parallel operations.
+bool vtkSMPNestedParallelism = true;
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::vtkSMPTools_EnterScope()
+{
+  ++vtkSMPScopeDepth;
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::vtkSMPTools_ExitScope()
+{
+  --vtkSMPScopeDepth;
+}
+
+//--------------------------------------------------------------------------------
+bool vtk::detail::smp::vtkSMPTools_ShouldSerialize()
+{
+  return vtkSMPScopeDepth > 0 && !vtkSMPNestedParallelism;
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPTools::SetNestedParallelism(bool isNested)
+{
+  vtkSMPNestedParallelism = isNested;
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPTools::GetNestedParallelism()
+{
+  return vtkSMPNestedParallelism;
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPTools::IsParallelScope()
+{
+  return vtkSMPScopeDepth > 0;
+}
+
+#ifndef VTK_SMP_Runtime
+//--------------------------------------------------------------------------------
+bool vtkSMPTools::SetBackend(const char* backend)
+{
+  return backend && strcmp(backend, VTK_SMP_BACKEND) == 0;
+}
+
+//--------------------------------------------------------------------------------
+const char* vtkSMPTools::GetBackend()
+{
+  return VTK_SMP_BACKEND;
+}
+#endif
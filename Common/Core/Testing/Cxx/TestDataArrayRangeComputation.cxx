@@ -0,0 +1,108 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataArrayRangeComputation.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Test the parallel computation of the ranges of data arrays, and the
+// handling of NaN values and ghost tuples.
+
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkSMPTools.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <cmath>
+
+#define TEST_ASSERT(cond, msg) \
+  if (!(cond)) \
+    { \
+    cerr << "Failure at line " << __LINE__ << ": " << msg << endl; \
+    return EXIT_FAILURE; \
+    }
+
+int TestDataArrayRangeComputation(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+  const vtkIdType numTuples = 100000;
+  double range[2];
+
+  // Several components, a NaN value and the largest values in the middle
+  vtkNew<vtkFloatArray> floats;
+  floats->SetNumberOfComponents(3);
+  floats->SetNumberOfTuples(numTuples);
+  for (vtkIdType i = 0; i < numTuples; ++i)
+    {
+    floats->SetTuple3(i, i % 100, -(i % 10), 2.0);
+    }
+  floats->SetComponent(numTuples / 2, 0, 1000.0);
+  floats->SetComponent(numTuples / 3, 0, vtkMath::Nan());
+  floats->GetRange(range, 0);
+  TEST_ASSERT(range[0] == 0.0 && range[1] == 1000.0, "wrong range");
+  floats->GetRange(range, 1);
+  TEST_ASSERT(range[0] == -9.0 && range[1] == 0.0, "wrong second range");
+  floats->GetRange(range, -1);
+  TEST_ASSERT(std::fabs(range[0] - 2.0) < 1e-6 &&
+              std::fabs(range[1] - sqrt(1000.0*1000.0 + 4.0)) < 1e-3,
+              "wrong magnitude range");
+
+  // The range is cached until the array is modified
+  floats->GetPointer(0)[0] = -5.0f;
+  floats->GetRange(range, 0);
+  TEST_ASSERT(range[0] == 0.0, "range not cached");
+  floats->Modified();
+  floats->GetRange(range, 0);
+  TEST_ASSERT(range[0] == -5.0, "range not updated");
+
+  // Ghost tuples
+  vtkNew<vtkUnsignedCharArray> ghosts;
+  ghosts->SetNumberOfTuples(numTuples);
+  ghosts->FillComponent(0, 0);
+  ghosts->SetValue(0, 1);
+  ghosts->SetValue(numTuples / 2, 2);
+  floats->GetRange(range, 0, ghosts.GetPointer());
+  TEST_ASSERT(range[0] == 0.0 && range[1] == 99.0, "wrong ghost range");
+  floats->GetRange(range, 0, ghosts.GetPointer(), 1);
+  TEST_ASSERT(range[0] == 0.0 && range[1] == 1000.0,
+              "wrong range of selected ghosts");
+  floats->GetRange(range, -1, ghosts.GetPointer());
+  TEST_ASSERT(std::fabs(range[1] - sqrt(99.0*99.0 + 81.0 + 4.0)) < 1e-3,
+              "wrong ghost magnitude range");
+  ghosts->SetValue(numTuples / 2, 0);
+  ghosts->Modified();
+  floats->GetRange(range, -1, ghosts.GetPointer());
+  TEST_ASSERT(range[1] > 1000.0, "ghost range not updated");
+  floats->GetRange(range, 0);
+  TEST_ASSERT(range[0] == -5.0, "wrong range after ghost range");
+
+  // Only NaN values
+  vtkNew<vtkDoubleArray> nans;
+  nans->SetNumberOfTuples(10);
+  nans->FillComponent(0, vtkMath::Nan());
+  nans->GetRange(range, 0);
+  TEST_ASSERT(range[0] > range[1], "range of NaN values not empty");
+
+  // Integer values
+  vtkNew<vtkIntArray> ints;
+  ints->SetNumberOfTuples(numTuples);
+  for (vtkIdType i = 0; i < numTuples; ++i)
+    {
+    ints->SetValue(i, static_cast<int>((i * 7919) % numTuples) - 10);
+    }
+  ints->GetRange(range);
+  TEST_ASSERT(range[0] == -10.0 && range[1] == numTuples - 11,
+              "wrong integer range");
+
+  return EXIT_SUCCESS;
+}
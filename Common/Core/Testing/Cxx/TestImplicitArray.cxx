@@ -0,0 +1,179 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImplicitArray.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Test vtkImplicitArray and its backends.
+
+#include "vtkArrayDispatch.h"
+#include "vtkDataArrayAccessor.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImplicitArray.h"
+#include "vtkImplicitArrayBackends.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkSmartPointer.h"
+
+#define TEST_ASSERT(cond, msg) \
+  if (!(cond)) \
+    { \
+    cerr << "Failure at line " << __LINE__ << ": " << msg << endl; \
+    return EXIT_FAILURE; \
+    }
+
+namespace
+{
+typedef vtkImplicitArray<vtkConstantImplicitBackend<int> > ConstantArray;
+typedef vtkImplicitArray<vtkAffineImplicitBackend<double> > AffineArray;
+typedef vtkImplicitArray<vtkStructuredPointsImplicitBackend<double> >
+  StructuredPointsArray;
+typedef vtkImplicitArray<vtkRectilinearPointsImplicitBackend<float> >
+  RectilinearPointsArray;
+typedef vtkImplicitArray<vtkCompositeImplicitBackend<double> > CompositeArray;
+
+// Sum all the values of an array through the typed API.
+struct SumWorker
+{
+  double Sum;
+
+  SumWorker() : Sum(0.0) {}
+
+  template <class ArrayT>
+  void operator()(ArrayT *array)
+  {
+    vtkDataArrayAccessor<ArrayT> access(array);
+    vtkIdType numTuples = array->GetNumberOfTuples();
+    int numComps = array->GetNumberOfComponents();
+    for (vtkIdType t = 0; t < numTuples; ++t)
+      {
+      for (int c = 0; c < numComps; ++c)
+        {
+        this->Sum += access.Get(t, c);
+        }
+      }
+  }
+};
+}
+
+int TestImplicitArray(int, char*[])
+{
+  // Constant values
+  vtkNew<ConstantArray> constant;
+  constant->SetBackend(vtkConstantImplicitBackend<int>(7));
+  constant->SetNumberOfComponents(2);
+  constant->SetNumberOfTuples(1000000);
+  TEST_ASSERT(constant->GetNumberOfValues() == 2000000, "wrong size");
+  TEST_ASSERT(constant->GetDataType() == VTK_INT, "wrong data type");
+  TEST_ASSERT(constant->GetActualMemorySize() < 10, "values are stored");
+  TEST_ASSERT(constant->GetValue(1999999) == 7 &&
+              constant->GetTypedComponent(10, 1) == 7 &&
+              constant->GetComponent(500000, 0) == 7.0, "wrong constant");
+  double range[2];
+  constant->GetRange(range, 1);
+  TEST_ASSERT(range[0] == 7.0 && range[1] == 7.0, "wrong constant range");
+
+  // Affine ramp, through the dispatcher
+  vtkNew<AffineArray> ramp;
+  ramp->SetBackend(vtkAffineImplicitBackend<double>(0.5, -1.0));
+  ramp->SetNumberOfTuples(101);
+  TEST_ASSERT(ramp->GetValue(0) == -1.0 && ramp->GetValue(100) == 49.0,
+              "wrong ramp");
+  SumWorker worker;
+  TEST_ASSERT((vtkArrayDispatch::DispatchByArray<
+                 vtkTypeList_Create_1(AffineArray)>::Execute(
+                 ramp.GetPointer(), worker)), "dispatch failed");
+  TEST_ASSERT(worker.Sum == 0.5 * 5050 - 101, "wrong dispatched sum");
+
+  // Image data point coordinates
+  int extent[6] = { 1, 4, 0, 2, -1, 1 };
+  double origin[3] = { 1.0, 2.0, 3.0 };
+  double spacing[3] = { 0.5, 1.0, 2.0 };
+  vtkStructuredPointsImplicitBackend<double> structured(extent, origin,
+                                                        spacing);
+  vtkNew<StructuredPointsArray> points;
+  points->SetNumberOfComponents(3);
+  points->SetBackend(structured);
+  points->SetNumberOfTuples(structured.GetNumberOfTuples());
+  TEST_ASSERT(points->GetNumberOfTuples() == 4*3*3, "wrong point count");
+  double pt[3];
+  // point (i,j,k) = (3,1,0) of the extent
+  points->GetTuple(2 + 4*(1 + 3*1), pt);
+  TEST_ASSERT(pt[0] == 2.5 && pt[1] == 3.0 && pt[2] == 3.0,
+              "wrong structured point");
+  points->GetRange(range, 2);
+  TEST_ASSERT(range[0] == 1.0 && range[1] == 5.0, "wrong structured range");
+
+  // Rectilinear grid point coordinates
+  vtkNew<vtkDoubleArray> x;
+  vtkNew<vtkIntArray> y;
+  vtkNew<vtkFloatArray> z;
+  x->InsertNextValue(0.0);
+  x->InsertNextValue(0.25);
+  y->InsertNextValue(10);
+  y->InsertNextValue(20);
+  y->InsertNextValue(40);
+  z->InsertNextValue(-1.0f);
+  vtkNew<RectilinearPointsArray> rpoints;
+  rpoints->SetNumberOfComponents(3);
+  rpoints->SetBackend(vtkRectilinearPointsImplicitBackend<float>(
+    x.GetPointer(), y.GetPointer(), z.GetPointer()));
+  rpoints->SetNumberOfTuples(rpoints->GetBackend().GetNumberOfTuples());
+  TEST_ASSERT(rpoints->GetNumberOfTuples() == 6, "wrong rectilinear count");
+  float rpt[3];
+  rpoints->GetTypedTuple(5, rpt);
+  TEST_ASSERT(rpt[0] == 0.25f && rpt[1] == 40.0f && rpt[2] == -1.0f,
+              "wrong rectilinear point");
+
+  // Concatenation of arrays
+  vtkCompositeImplicitBackend<double> composite;
+  composite.AddArray(x.GetPointer());
+  composite.AddArray(y.GetPointer());
+  composite.AddArray(ramp.GetPointer());
+  vtkNew<CompositeArray> all;
+  all->SetBackend(composite);
+  all->SetNumberOfTuples(composite.GetNumberOfTuples());
+  TEST_ASSERT(all->GetNumberOfTuples() == 2 + 3 + 101, "wrong composite size");
+  TEST_ASSERT(all->GetValue(1) == 0.25 && all->GetValue(2) == 10.0 &&
+              all->GetValue(4) == 40.0 && all->GetValue(5) == -1.0 &&
+              all->GetValue(105) == 49.0, "wrong composite values");
+
+  // Copies
+  vtkSmartPointer<vtkDataArray> instance;
+  instance.TakeReference(points->vtkDataArray::NewInstance());
+  TEST_ASSERT(vtkArrayDownCast<vtkDoubleArray>(instance), "NewInstance is not "
+              "a regular array");
+  instance->DeepCopy(points.GetPointer());
+  TEST_ASSERT(instance->GetNumberOfTuples() == points->GetNumberOfTuples() &&
+              instance->GetComponent(35, 2) == points->GetComponent(35, 2),
+              "wrong deep copy to a regular array");
+  vtkNew<StructuredPointsArray> copy;
+  copy->DeepCopy(points.GetPointer());
+  TEST_ASSERT(copy->GetNumberOfComponents() == 3 &&
+              copy->GetNumberOfTuples() == 36 &&
+              copy->GetComponent(35, 0) == 3.0, "wrong implicit deep copy");
+
+  vtkObject::GlobalWarningDisplayOff();
+  // Read only
+  copy->SetComponent(0, 0, 100.0);
+  TEST_ASSERT(copy->GetComponent(0, 0) == 1.5, "read only value modified");
+  copy->DeepCopy(instance);
+  TEST_ASSERT(copy->GetComponent(35, 0) == 3.0, "read only array modified");
+
+  // Materialized values
+  double *values = static_cast<double*>(points->GetVoidPointer(0));
+  vtkObject::GlobalWarningDisplayOn();
+  TEST_ASSERT(values && values[3*35] == 3.0 && values[3*35+2] == 5.0,
+              "wrong materialized values");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,139 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestMemoryMappedArray.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Test the use of memory mapped files as the storage of data arrays.
+
+#include "vtkFloatArray.h"
+#include "vtkMemoryMappedFile.h"
+#include "vtkNew.h"
+#include "vtkTestUtilities.h"
+
+#include <cstdio>
+#include <string>
+
+#define TEST_ASSERT(cond, msg) \
+  if (!(cond)) \
+    { \
+    cerr << "Failure at line " << __LINE__ << ": " << msg << endl; \
+    return EXIT_FAILURE; \
+    }
+
+int TestMemoryMappedArray(int argc, char *argv[])
+{
+  if (!vtkMemoryMappedFile::IsSupported())
+    {
+    cout << "Memory mapped files are not supported." << endl;
+    return EXIT_SUCCESS;
+    }
+
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  std::string fileName = std::string(tempDir) + "/TestMemoryMappedArray.raw";
+  delete [] tempDir;
+
+  // A header of 8 bytes followed by the values
+  const vtkIdType numValues = 100000;
+  FILE *file = fopen(fileName.c_str(), "wb");
+  TEST_ASSERT(file != NULL, "cannot create " << fileName);
+  double header = 0.0;
+  fwrite(&header, sizeof(header), 1, file);
+  for (vtkIdType i = 0; i < numValues; ++i)
+    {
+    float value = static_cast<float>(i);
+    fwrite(&value, sizeof(value), 1, file);
+    }
+  fclose(file);
+
+  // Read only mapping of the values
+  vtkMemoryMappedFile *mapping = vtkMemoryMappedFile::New();
+  mapping->SetModeToReadOnly();
+  TEST_ASSERT(mapping->Map(fileName.c_str(), sizeof(header)), "map failed");
+  TEST_ASSERT(mapping->GetLength() ==
+              static_cast<vtkTypeInt64>(numValues * sizeof(float)),
+              "wrong mapped length");
+  vtkNew<vtkFloatArray> values;
+  values->SetNumberOfComponents(2);
+  vtkObject::GlobalWarningDisplayOff();
+  TEST_ASSERT(!values->SetMappedArray(mapping, numValues + 1),
+              "values outside of the mapping accepted");
+  TEST_ASSERT(!values->SetMappedArray(mapping, 10, 2),
+              "unaligned values accepted");
+  vtkObject::GlobalWarningDisplayOn();
+  TEST_ASSERT(values->SetMappedArray(mapping, numValues), "SetMappedArray");
+  // The array keeps the mapping alive
+  mapping->Delete();
+  TEST_ASSERT(values->IsMapped(), "array not mapped");
+  TEST_ASSERT(values->GetNumberOfTuples() == numValues / 2,
+              "wrong number of tuples");
+  for (vtkIdType i = 0; i < numValues; i += 997)
+    {
+    TEST_ASSERT(values->GetValue(i) == static_cast<float>(i), "wrong value");
+    }
+  double range[2];
+  values->GetRange(range, 1);
+  TEST_ASSERT(range[0] == 1.0 && range[1] == numValues - 1, "wrong range");
+
+  // Shallow copies share the mapping, deep copies do not
+  vtkNew<vtkFloatArray> shallow;
+  shallow->ShallowCopy(values.GetPointer());
+  TEST_ASSERT(shallow->IsMapped() &&
+              shallow->GetPointer(0) == values->GetPointer(0),
+              "shallow copy does not share the mapping");
+  vtkNew<vtkFloatArray> deep;
+  deep->DeepCopy(values.GetPointer());
+  TEST_ASSERT(!deep->IsMapped() && deep->GetValue(10) == 10.0f,
+              "wrong deep copy");
+
+  // Resizing copies the values to the heap and releases the mapping
+  values->InsertNextTuple2(-1.0, -2.0);
+  TEST_ASSERT(!values->IsMapped(), "mapping not released by a resize");
+  TEST_ASSERT(values->GetValue(numValues - 1) == numValues - 1 &&
+              values->GetValue(numValues + 1) == -2.0f,
+              "wrong values after resize");
+
+  // Copy-on-write mapping: modifications are not written to the file
+  vtkNew<vtkMemoryMappedFile> cow;
+  TEST_ASSERT(cow->GetMode() == vtkMemoryMappedFile::COPY_ON_WRITE,
+              "wrong default mode");
+  TEST_ASSERT(cow->Map(fileName.c_str()), "copy-on-write map failed");
+  vtkNew<vtkFloatArray> writable;
+  TEST_ASSERT(writable->SetMappedArray(cow.GetPointer(), 10, sizeof(header)),
+              "SetMappedArray with an offset");
+  writable->SetValue(3, 42.0f);
+  TEST_ASSERT(writable->GetValue(3) == 42.0f, "value not modified");
+
+  vtkNew<vtkMemoryMappedFile> check;
+  check->SetModeToReadOnly();
+  TEST_ASSERT(check->Map(fileName.c_str(), sizeof(header) + 3*sizeof(float),
+                         sizeof(float)), "map with an unaligned offset");
+  TEST_ASSERT(*static_cast<float*>(check->GetData()) == 3.0f,
+              "copy-on-write modified the file");
+  check->Unmap();
+  TEST_ASSERT(!check->IsMapped() && check->GetData() == NULL, "Unmap");
+
+  // Errors
+  vtkObject::GlobalWarningDisplayOff();
+  TEST_ASSERT(!check->Map(fileName.c_str(), 0,
+                          sizeof(header) + (numValues + 1)*sizeof(float)),
+              "region outside of the file mapped");
+  TEST_ASSERT(!check->Map((fileName + ".missing").c_str()),
+              "missing file mapped");
+  vtkObject::GlobalWarningDisplayOn();
+
+  writable->Initialize();
+  cow->Unmap();
+  remove(fileName.c_str());
+
+  return EXIT_SUCCESS;
+}
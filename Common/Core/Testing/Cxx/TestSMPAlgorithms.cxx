@@ -0,0 +1,194 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSMPAlgorithms.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Test the parallel algorithms of vtkSMPTools and vtkSMPArrayTools: Reduce,
+// InclusiveScan, ExclusiveScan, Transform and Fill.
+
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkSMPArrayTools.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#define TEST_ASSERT(cond, msg) \
+  if (!(cond)) \
+    { \
+    cerr << "Failure at line " << __LINE__ << " with back-end " \
+         << vtkSMPTools::GetBackend() << ": " << msg << endl; \
+    return EXIT_FAILURE; \
+    }
+
+namespace
+{
+const vtkIdType NumberOfItems = 1000003;
+
+struct SquareIndex
+{
+  double operator()(vtkIdType i) const
+  {
+    return static_cast<double>(i) * i;
+  }
+};
+
+struct Square
+{
+  double operator()(double x) const
+  {
+    return x * x;
+  }
+};
+
+struct Max
+{
+  int operator()(int a, int b) const
+  {
+    return a > b ? a : b;
+  }
+};
+
+struct Add
+{
+  double operator()(double a, double b) const
+  {
+    return a + b;
+  }
+};
+
+int TestAlgorithms(double& floatSum)
+{
+  // Reduce over an index range; floating point sums are deterministic
+  floatSum = vtkSMPTools::Reduce(0, NumberOfItems, 0.0, SquareIndex(),
+                                 Add());
+  double sum = vtkSMPTools::Reduce(vtkIdType(0), NumberOfItems, 0.0,
+                                   SquareIndex(), Add());
+  TEST_ASSERT(sum == floatSum, "non deterministic reduction");
+  double expected = 0.0;
+  for (vtkIdType i = 0; i < NumberOfItems; ++i)
+    {
+    expected += static_cast<double>(i) * i;
+    }
+  TEST_ASSERT(sum > 0.999999 * expected && sum < 1.000001 * expected,
+              "wrong reduction");
+  TEST_ASSERT(vtkSMPTools::Reduce(5, 5, 3.0, SquareIndex(), Add()) == 3.0,
+              "wrong empty reduction");
+
+  // Reduce, Fill and Transform over iterators
+  std::vector<int> counts(NumberOfItems);
+  vtkSMPTools::Fill(counts.begin(), counts.end(), 3);
+  TEST_ASSERT(std::count(counts.begin(), counts.end(), 3) == NumberOfItems,
+              "wrong fill");
+  counts[NumberOfItems/3] = 7;
+  TEST_ASSERT(vtkSMPTools::Reduce(counts.begin(), counts.end(), 0, Max()) ==
+              7, "wrong iterator reduction");
+  std::vector<double> squares(NumberOfItems);
+  vtkSMPTools::Transform(counts.begin(), counts.end(), squares.begin(),
+                         Square());
+  TEST_ASSERT(squares[0] == 9.0 && squares[NumberOfItems/3] == 49.0,
+              "wrong transform");
+  vtkSMPTools::Transform(squares.begin(), squares.end(), counts.begin(),
+                         squares.begin(), Add());
+  TEST_ASSERT(squares[1] == 12.0 && squares[NumberOfItems/3] == 56.0,
+              "wrong binary transform");
+
+  // Scans, in place and not
+  std::vector<vtkIdType> offsets(NumberOfItems);
+  vtkIdType total = vtkSMPTools::ExclusiveScan(counts.begin(), counts.end(),
+                                               offsets.begin(), vtkIdType(10));
+  TEST_ASSERT(total == 10 + 3 * NumberOfItems + 4, "wrong scan total");
+  TEST_ASSERT(offsets[0] == 10 && offsets[1] == 13 &&
+              offsets[NumberOfItems-1] == total - 3, "wrong exclusive scan");
+  vtkSMPTools::InclusiveScan(counts.begin(), counts.end(), counts.begin());
+  for (vtkIdType i = 0; i < NumberOfItems; ++i)
+    {
+    TEST_ASSERT(counts[i] == offsets[i] - 10 + (i == NumberOfItems/3 ? 7 : 3),
+                "wrong inclusive scan");
+    }
+
+  // Data arrays
+  vtkNew<vtkIntArray> sizes;
+  sizes->SetNumberOfComponents(2);
+  sizes->SetNumberOfTuples(NumberOfItems);
+  vtkSMPArrayTools::Fill(sizes.GetPointer(), 2);
+  sizes->SetComponent(1, 1, 5);
+  TEST_ASSERT(vtkSMPArrayTools::Reduce(sizes.GetPointer(), 0, Max()) == 5,
+              "wrong array reduction");
+  TEST_ASSERT(vtkSMPArrayTools::Reduce(static_cast<vtkDataArray*>(
+                sizes.GetPointer()), 0.0, Add()) == 4.0 * NumberOfItems + 3,
+              "wrong generic array reduction");
+  vtkNew<vtkIdTypeArray> arrayOffsets;
+  total = vtkSMPArrayTools::ExclusiveScan(sizes.GetPointer(),
+                                          arrayOffsets.GetPointer(), 0);
+  TEST_ASSERT(total == 4 * NumberOfItems + 3 &&
+              arrayOffsets->GetNumberOfComponents() == 2 &&
+              arrayOffsets->GetNumberOfTuples() == NumberOfItems &&
+              arrayOffsets->GetComponent(1, 1) == 6 &&
+              arrayOffsets->GetComponent(2, 0) == 11,
+              "wrong array exclusive scan");
+  vtkSMPArrayTools::InclusiveScan(sizes.GetPointer(), sizes.GetPointer());
+  TEST_ASSERT(sizes->GetComponent(1, 1) == 11 &&
+              sizes->GetComponent(NumberOfItems-1, 1) == total,
+              "wrong array inclusive scan");
+  vtkNew<vtkDoubleArray> transformed;
+  vtkSMPArrayTools::Transform(
+    static_cast<vtkDataArray*>(arrayOffsets.GetPointer()),
+    static_cast<vtkDataArray*>(transformed.GetPointer()), Square());
+  TEST_ASSERT(transformed->GetNumberOfTuples() == NumberOfItems &&
+              transformed->GetComponent(2, 0) == 121.0,
+              "wrong array transform");
+
+  return EXIT_SUCCESS;
+}
+}
+
+int TestSMPAlgorithms(int, char*[])
+{
+  // The results must be the same with all the available back-ends and
+  // numbers of threads.
+  const char* backends[] = { "Sequential", "STDThread", "OpenMP", "TBB" };
+  std::string defaultBackend = vtkSMPTools::GetBackend();
+  double reference = 0.0;
+  bool hasReference = false;
+  for (int i = 0; i < 4; ++i)
+    {
+    if (!vtkSMPTools::SetBackend(backends[i]))
+      {
+      continue;
+      }
+    for (int numThreads = 1; numThreads <= 4; numThreads *= 2)
+      {
+      vtkSMPTools::Initialize(numThreads);
+      double floatSum;
+      if (TestAlgorithms(floatSum) != EXIT_SUCCESS)
+        {
+        return EXIT_FAILURE;
+        }
+      if (hasReference && floatSum != reference)
+        {
+        cerr << "Error: different sums with " << vtkSMPTools::GetBackend()
+             << " and " << numThreads << " threads" << endl;
+        return EXIT_FAILURE;
+        }
+      reference = floatSum;
+      hasReference = true;
+      }
+    }
+  vtkSMPTools::SetBackend(defaultBackend.c_str());
+
+  return EXIT_SUCCESS;
+}
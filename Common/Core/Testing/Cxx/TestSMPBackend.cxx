@@ -0,0 +1,211 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSMPBackend.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Test the selection of the vtkSMPTools back-end and the handling of nested
+// parallel operations.
+
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace
+{
+const vtkIdType NumberOfItems = 1000;
+
+// Count the items and the calls to operator().
+class CountFunctor
+{
+public:
+  vtkSMPThreadLocal<vtkIdType> Items;
+  vtkSMPThreadLocal<int> Calls;
+  bool InScope;
+
+  CountFunctor() : Items(0), Calls(0), InScope(true)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    this->Items.Local() += end - begin;
+    ++this->Calls.Local();
+    if (!vtkSMPTools::IsParallelScope())
+      {
+      this->InScope = false;
+      }
+  }
+
+  vtkIdType GetItems()
+  {
+    vtkIdType total = 0;
+    vtkSMPThreadLocal<vtkIdType>::iterator itr;
+    for (itr = this->Items.begin(); itr != this->Items.end(); ++itr)
+      {
+      total += *itr;
+      }
+    return total;
+  }
+
+  int GetCalls()
+  {
+    int total = 0;
+    vtkSMPThreadLocal<int>::iterator itr;
+    for (itr = this->Calls.begin(); itr != this->Calls.end(); ++itr)
+      {
+      total += *itr;
+      }
+    return total;
+  }
+};
+
+// Run an inner loop of NumberOfItems items, with a grain of 1, per item.
+class NestedFunctor
+{
+public:
+  vtkSMPThreadLocal<vtkIdType> Items;
+  vtkSMPThreadLocal<int> MaxCalls;
+
+  NestedFunctor() : Items(0), MaxCalls(0)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      CountFunctor inner;
+      vtkSMPTools::For(0, NumberOfItems, 1, inner);
+      this->Items.Local() += inner.GetItems();
+      if (inner.GetCalls() > this->MaxCalls.Local())
+        {
+        this->MaxCalls.Local() = inner.GetCalls();
+        }
+      }
+  }
+};
+
+int TestBackend()
+{
+  CountFunctor functor;
+  vtkSMPTools::For(0, NumberOfItems, functor);
+  if (functor.GetItems() != NumberOfItems || !functor.InScope)
+    {
+    cerr << "Error: wrong loop with " << vtkSMPTools::GetBackend() << endl;
+    return EXIT_FAILURE;
+    }
+
+  for (int nested = 0; nested <= 1; ++nested)
+    {
+    vtkSMPTools::SetNestedParallelism(nested != 0);
+    NestedFunctor nestedFunctor;
+    vtkSMPTools::For(0, 20, 1, nestedFunctor);
+    vtkIdType total = 0;
+    int maxCalls = 0;
+    vtkSMPThreadLocal<vtkIdType>::iterator itr;
+    for (itr = nestedFunctor.Items.begin(); itr != nestedFunctor.Items.end();
+         ++itr)
+      {
+      total += *itr;
+      }
+    vtkSMPThreadLocal<int>::iterator citr;
+    for (citr = nestedFunctor.MaxCalls.begin();
+         citr != nestedFunctor.MaxCalls.end(); ++citr)
+      {
+      maxCalls = *citr > maxCalls ? *citr : maxCalls;
+      }
+    if (total != 20 * NumberOfItems)
+      {
+      cerr << "Error: wrong nested loop with " << vtkSMPTools::GetBackend()
+           << endl;
+      return EXIT_FAILURE;
+      }
+    if (!nested && maxCalls != 1)
+      {
+      cerr << "Error: nested loop not serialized with "
+           << vtkSMPTools::GetBackend() << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Large enough to be sorted in parallel by the back-ends that can.
+  vtkSMPTools::Initialize(4);
+  std::vector<int> values(100000);
+  for (size_t i = 0; i < values.size(); ++i)
+    {
+    values[i] = static_cast<int>((i * 7919) % 100003);
+    }
+  std::vector<int> expected(values);
+  std::sort(expected.begin(), expected.end());
+  vtkSMPTools::Sort(values.begin(), values.end());
+  if (values != expected)
+    {
+    cerr << "Error: wrong sort with " << vtkSMPTools::GetBackend() << endl;
+    return EXIT_FAILURE;
+    }
+  vtkSMPTools::Sort(values.begin(), values.end(), std::greater<int>());
+  if (!std::equal(values.begin(), values.end(), expected.rbegin()))
+    {
+    cerr << "Error: wrong sort with a comparison with "
+         << vtkSMPTools::GetBackend() << endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int TestSMPBackend(int, char*[])
+{
+  const char* initialBackend = vtkSMPTools::GetBackend();
+  if (!initialBackend)
+    {
+    cerr << "Error: no back-end in use" << endl;
+    return EXIT_FAILURE;
+    }
+  std::string defaultBackend = initialBackend;
+  cout << "Default back-end: " << defaultBackend << endl;
+  if (!vtkSMPTools::SetBackend(defaultBackend.c_str()) ||
+      vtkSMPTools::SetBackend("Bogus") || vtkSMPTools::SetBackend(NULL) ||
+      defaultBackend != vtkSMPTools::GetBackend())
+    {
+    cerr << "Error: wrong back-end selection" << endl;
+    return EXIT_FAILURE;
+    }
+
+  if (vtkSMPTools::IsParallelScope() || !vtkSMPTools::GetNestedParallelism())
+    {
+    cerr << "Error: wrong initial state" << endl;
+    return EXIT_FAILURE;
+    }
+
+  const char* backends[] = { "Sequential", "STDThread", "OpenMP", "TBB" };
+  for (int i = 0; i < 4; ++i)
+    {
+    if (!vtkSMPTools::SetBackend(backends[i]))
+      {
+      continue;
+      }
+    cout << "Testing " << vtkSMPTools::GetBackend() << endl;
+    if (TestBackend() != EXIT_SUCCESS)
+      {
+      return EXIT_FAILURE;
+      }
+    }
+  vtkSMPTools::SetBackend(defaultBackend.c_str());
+  vtkSMPTools::SetNestedParallelism(true);
+
+  return EXIT_SUCCESS;
+}
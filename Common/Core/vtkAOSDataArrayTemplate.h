@@ -32,6 +32,8 @@
 #include "vtkGenericDataArray.h"
 #include "vtkBuffer.h" // For storage buffer.
 
+class vtkMemoryMappedFile;
+
 // The export macro below makes no sense, but is necessary for older compilers
 // when we export instantiations of this class from vtkCommonCore.
 template <class ValueTypeT>
@@ -133,6 +135,22 @@ public:
   virtual void SetVoidArray(void* array, vtkIdType size, int save,
                             int deleteMethod);
 
+  // Description:
+  // Use numValues values stored in a memory mapped file, starting
+  // byteOffset bytes after the beginning of the mapped region, without
+  // copying them. Pages of the file are only read when they are accessed.
+  // The array keeps a reference to the mapping until its memory is released
+  // or reallocated; resizing the array copies the values to the heap.
+  // Values must not be modified when the mapping is READ_ONLY. Returns false
+  // if the values are not inside the mapped region or are not aligned for
+  // ValueType; the array is unchanged in that case.
+  bool SetMappedArray(vtkMemoryMappedFile* mapping, vtkIdType numValues,
+                      vtkTypeInt64 byteOffset = 0);
+
+  // Description:
+  // Return true if the values are stored in a memory mapped file.
+  bool IsMapped() const { return this->Buffer->GetMapping() != NULL; }
+
   // Description:
   // Tell the array explicitly that a single data element has
   // changed. Like DataChanged(), then is only necessary when you
@@ -18,6 +18,7 @@
 #include "vtkAOSDataArrayTemplate.h"
 
 #include "vtkArrayIteratorTemplate.h"
+#include "vtkMemoryMappedFile.h"
 
 //-----------------------------------------------------------------------------
 template <class ValueTypeT>
@@ -61,6 +62,34 @@ void vtkAOSDataArrayTemplate<ValueTypeT>
   this->SetArray(array, size, save, VTK_DATA_ARRAY_FREE);
 }
 
+//-----------------------------------------------------------------------------
+template <class ValueTypeT>
+bool vtkAOSDataArrayTemplate<ValueTypeT>
+::SetMappedArray(vtkMemoryMappedFile *mapping, vtkIdType numValues,
+                 vtkTypeInt64 byteOffset)
+{
+  if (!mapping || !mapping->IsMapped() || numValues < 0 || byteOffset < 0 ||
+      byteOffset + static_cast<vtkTypeInt64>(numValues * sizeof(ValueType)) >
+        mapping->GetLength())
+    {
+    vtkErrorMacro("The values are not inside the mapped region.");
+    return false;
+    }
+  char *data = static_cast<char*>(mapping->GetData()) + byteOffset;
+  if (reinterpret_cast<size_t>(data) % sizeof(ValueType) != 0)
+    {
+    vtkErrorMacro("The mapped values are not aligned.");
+    return false;
+    }
+
+  this->Buffer->SetMappedBuffer(reinterpret_cast<ValueType*>(data),
+                                numValues, mapping);
+  this->Size = numValues;
+  this->MaxId = this->Size - 1;
+  this->DataChanged();
+  return true;
+}
+
 //-----------------------------------------------------------------------------
 template <class ValueTypeT>
 void vtkAOSDataArrayTemplate<ValueTypeT>
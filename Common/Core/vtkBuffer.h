@@ -53,6 +53,18 @@ public:
   void SetBuffer(ScalarType* array, vtkIdType size, bool save=false,
                  int deleteMethod=VTK_DATA_ARRAY_FREE);
 
+  // Description:
+  // Use memory owned by @a mapping (usually a vtkMemoryMappedFile) as the
+  // buffer. The mapping is registered for as long as the buffer uses its
+  // memory; the memory is never freed by this object. Resizing the buffer
+  // copies the data to the heap and releases the mapping.
+  void SetMappedBuffer(ScalarType* array, vtkIdType size, vtkObject* mapping);
+
+  // Description:
+  // Return the object owning the memory set by SetMappedBuffer(), or NULL
+  // when the buffer is not mapped.
+  vtkObject* GetMapping() const { return this->Mapping; }
+
   // Description:
   // Return the number of elements the current buffer can hold.
   inline vtkIdType GetSize() const { return this->Size; }
@@ -71,7 +83,8 @@ protected:
     : Pointer(NULL),
       Size(0),
       Save(false),
-      DeleteMethod(VTK_DATA_ARRAY_FREE)
+      DeleteMethod(VTK_DATA_ARRAY_FREE),
+      Mapping(NULL)
   {
   }
 
@@ -84,6 +97,7 @@ protected:
   vtkIdType Size;
   bool Save;
   int DeleteMethod;
+  vtkObject* Mapping;
 
 private:
   vtkBuffer(const vtkBuffer&);  // Not implemented.
@@ -104,7 +118,13 @@ void vtkBuffer<ScalarT>::SetBuffer(
 {
   if (this->Pointer != array)
     {
-    if (!this->Save)
+    if (this->Mapping)
+      {
+      // the memory belongs to the mapping.
+      this->Mapping->UnRegister(NULL);
+      this->Mapping = NULL;
+      }
+    else if (!this->Save)
       {
       if (this->DeleteMethod == VTK_DATA_ARRAY_FREE)
         {
@@ -122,6 +142,22 @@ void vtkBuffer<ScalarT>::SetBuffer(
   this->DeleteMethod = deleteMethod;
 }
 
+//------------------------------------------------------------------------------
+template <typename ScalarT>
+void vtkBuffer<ScalarT>::SetMappedBuffer(
+    typename vtkBuffer<ScalarT>::ScalarType *array,
+    vtkIdType size, vtkObject *mapping)
+{
+  if (mapping)
+    {
+    mapping->Register(NULL);
+    }
+  // release old memory, and the old mapping if any.
+  this->SetBuffer(NULL, 0);
+  this->SetBuffer(array, size, true);
+  this->Mapping = mapping;
+}
+
 //------------------------------------------------------------------------------
 template <typename ScalarT>
 bool vtkBuffer<ScalarT>::Allocate(vtkIdType size)
@@ -43,6 +43,7 @@
 #include "vtkUnsignedShortArray.h"
 
 #include <algorithm> // for min(), max()
+#include <vector>
 
 namespace {
 
@@ -425,6 +426,20 @@ bool hasValidKey(InfoType info, KeyType key, ComponentKeyType ckey,
 vtkInformationKeyRestrictedMacro(vtkDataArray, COMPONENT_RANGE, DoubleVector, 2);
 vtkInformationKeyRestrictedMacro(vtkDataArray, L2_NORM_RANGE, DoubleVector, 2);
 
+//----------------------------------------------------------------------------
+// The last range computed with a ghosts array, and what it depends on. The
+// ghosts array is not referenced: its modification time tells whether it
+// changed since the computation.
+class vtkDataArrayGhostRange
+{
+public:
+  double Range[2];
+  int Component;
+  vtkUnsignedCharArray* Ghosts;
+  unsigned char GhostsToSkip;
+  vtkTimeStamp ComputeTime;
+};
+
 //----------------------------------------------------------------------------
 // Construct object with default tuple dimension (number of components) of 1.
 vtkDataArray::vtkDataArray()
@@ -432,6 +447,7 @@ vtkDataArray::vtkDataArray()
   this->LookupTable = NULL;
   this->Range[0] = 0;
   this->Range[1] = 0;
+  this->GhostRange = NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -441,6 +457,7 @@ vtkDataArray::~vtkDataArray()
     {
     this->LookupTable->Delete();
     }
+  delete this->GhostRange;
   this->SetName(0);
 }
 
@@ -1574,14 +1591,20 @@ struct ScalarRangeDispatchWrapper
 {
   bool Success;
   double *Range;
+  const unsigned char *Ghosts;
+  unsigned char GhostsToSkip;
 
-  ScalarRangeDispatchWrapper(double *range) : Success(false), Range(range) {}
+  ScalarRangeDispatchWrapper(double *range,
+                             const unsigned char *ghosts = NULL,
+                             unsigned char ghostsToSkip = 0xff)
+    : Success(false), Range(range), Ghosts(ghosts),
+      GhostsToSkip(ghostsToSkip) {}
 
   template <typename ArrayT>
   void operator()(ArrayT *array)
   {
-    this->Success = vtkDataArrayPrivate::DoComputeScalarRange(array,
-                                                              this->Range);
+    this->Success = vtkDataArrayPrivate::DoComputeScalarRange(
+      array, this->Range, this->Ghosts, this->GhostsToSkip);
   }
 
 };
@@ -1590,20 +1613,97 @@ struct VectorRangeDispatchWrapper
 {
   bool Success;
   double *Range;
+  const unsigned char *Ghosts;
+  unsigned char GhostsToSkip;
 
-  VectorRangeDispatchWrapper(double *range) : Success(false), Range(range) {}
+  VectorRangeDispatchWrapper(double *range,
+                             const unsigned char *ghosts = NULL,
+                             unsigned char ghostsToSkip = 0xff)
+    : Success(false), Range(range), Ghosts(ghosts),
+      GhostsToSkip(ghostsToSkip) {}
 
   template <typename ArrayT>
   void operator()(ArrayT *array)
   {
-    this->Success = vtkDataArrayPrivate::DoComputeVectorRange(array,
-                                                              this->Range);
+    this->Success = vtkDataArrayPrivate::DoComputeVectorRange(
+      array, this->Range, this->Ghosts, this->GhostsToSkip);
   }
 
 };
 
 } // end anon namespace
 
+//----------------------------------------------------------------------------
+void vtkDataArray::GetRange(double range[2], int comp,
+                            vtkUnsignedCharArray* ghosts,
+                            unsigned char ghostsToSkip)
+{
+  if (!ghosts)
+    {
+    this->GetRange(range, comp);
+    return;
+    }
+  if ( comp >= this->NumberOfComponents )
+    { // Ignore requests for nonexistent components.
+    return;
+    }
+  if (comp < 0 && this->NumberOfComponents == 1)
+    {
+    comp = 0;
+    }
+  if (ghosts->GetNumberOfTuples() < this->GetNumberOfTuples())
+    {
+    vtkErrorMacro("The ghosts array has " << ghosts->GetNumberOfTuples()
+                  << " tuples instead of " << this->GetNumberOfTuples());
+    this->GetRange(range, comp);
+    return;
+    }
+
+  vtkDataArrayGhostRange* cache = this->GhostRange;
+  if (cache && cache->Component == comp && cache->Ghosts == ghosts &&
+      cache->GhostsToSkip == ghostsToSkip &&
+      this->GetMTime() <= cache->ComputeTime &&
+      ghosts->GetMTime() <= cache->ComputeTime)
+    {
+    range[0] = cache->Range[0];
+    range[1] = cache->Range[1];
+    return;
+    }
+
+  const unsigned char* ghostValues = ghosts->GetPointer(0);
+  if (comp < 0)
+    {
+    VectorRangeDispatchWrapper worker(range, ghostValues, ghostsToSkip);
+    if (!vtkArrayDispatch::Dispatch::Execute(this, worker))
+      {
+      worker(this);
+      }
+    }
+  else
+    {
+    std::vector<double> allCompRanges(2 * this->NumberOfComponents);
+    ScalarRangeDispatchWrapper worker(&allCompRanges[0], ghostValues,
+                                      ghostsToSkip);
+    if (!vtkArrayDispatch::Dispatch::Execute(this, worker))
+      {
+      worker(this);
+      }
+    range[0] = allCompRanges[2 * comp];
+    range[1] = allCompRanges[2 * comp + 1];
+    }
+
+  if (!cache)
+    {
+    cache = this->GhostRange = new vtkDataArrayGhostRange;
+    }
+  cache->Range[0] = range[0];
+  cache->Range[1] = range[1];
+  cache->Component = comp;
+  cache->Ghosts = ghosts;
+  cache->GhostsToSkip = ghostsToSkip;
+  cache->ComputeTime.Modified();
+}
+
 //----------------------------------------------------------------------------
 bool vtkDataArray::ComputeScalarRange(double* ranges)
 {
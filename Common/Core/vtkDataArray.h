@@ -35,11 +35,13 @@
 #include "vtkCommonCoreModule.h" // For export macro
 #include "vtkAbstractArray.h"
 
+class vtkDataArrayGhostRange;
 class vtkDoubleArray;
 class vtkIdList;
 class vtkInformationDoubleVectorKey;
 class vtkLookupTable;
 class vtkPoints;
+class vtkUnsignedCharArray;
 
 class VTKCOMMONCORE_EXPORT vtkDataArray : public vtkAbstractArray
 {
@@ -277,7 +279,8 @@ public:
   // of the magnitude (L2 norm) over all components will be provided. The
   // range is computed and then cached, and will not be re-computed on
   // subsequent calls to GetRange() unless the array is modified or the
-  // requested component changes.
+  // requested component changes. The range is computed in parallel with
+  // vtkSMPTools, and NaN values are ignored.
   // THIS METHOD IS NOT THREAD SAFE.
   void GetRange(double range[2], int comp)
     {
@@ -320,6 +323,19 @@ public:
     this->GetRange(range,0);
     }
 
+  // Description:
+  // Compute the range of the given component, or of the magnitude if comp
+  // is -1, ignoring the tuples whose ghost value has any of the
+  // ghostsToSkip bits set, e.g. vtkDataSetAttributes::DUPLICATEPOINT to
+  // only account for the points owned by this process. The ghosts array
+  // has one value per tuple; when it is NULL, this is GetRange(range, comp).
+  // The last range computed with a ghosts array is cached and not
+  // re-computed unless the arrays are modified or the arguments change.
+  // NaN values are ignored.
+  // THIS METHOD IS NOT THREAD SAFE.
+  void GetRange(double range[2], int comp, vtkUnsignedCharArray* ghosts,
+                unsigned char ghostsToSkip = 0xff);
+
   // Description:
   // These methods return the Min and Max possible range of the native
   // data type. For example if a vtkScalars consists of unsigned char
@@ -405,6 +421,9 @@ protected:
 private:
   double* GetTupleN(vtkIdType i, int n);
 
+  // The cached range computed with a ghosts array.
+  vtkDataArrayGhostRange* GhostRange;
+
 private:
   vtkDataArray(const vtkDataArray&);  // Not implemented.
   void operator=(const vtkDataArray&);  // Not implemented.
@@ -18,9 +18,13 @@
 #include "vtkAssume.h"
 #include "vtkDataArray.h"
 #include "vtkDataArrayAccessor.h"
+#include "vtkMath.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkTypeTraits.h"
 #include <algorithm>
 #include <cassert> // for assert()
+#include <vector>
 
 namespace vtkDataArrayPrivate
 {
@@ -65,54 +69,159 @@ using std::max;
 }
 
 //----------------------------------------------------------------------------
-template <class APIType, int NumComps, int RangeSize>
-struct ComputeScalarRange
+// NaN values are skipped by the range computations.
+template <class ValueType>
+inline bool IsNan(ValueType)
 {
-  template<class ArrayT>
-  bool operator()(ArrayT *array, double *ranges)
-  {
-    VTK_ASSUME(array->GetNumberOfComponents() == NumComps);
+  return false;
+}
+
+inline bool IsNan(float value)
+{
+  return vtkMath::IsNan(value) != 0;
+}
+
+inline bool IsNan(double value)
+{
+  return vtkMath::IsNan(value) != 0;
+}
+
+//----------------------------------------------------------------------------
+// The values of the arrays that are not dispatched to a concrete type are
+// read through the vtkDataArray API, which some arrays implement with
+// shared temporary buffers, so their ranges are computed serially.
+template <class ArrayT>
+inline bool CanComputeRangeInParallel(ArrayT*)
+{
+  return true;
+}
 
-    vtkDataArrayAccessor<ArrayT> access(array);
-    APIType tempRange[RangeSize];
+inline bool CanComputeRangeInParallel(vtkDataArray*)
+{
+  return false;
+}
+
+template <class ArrayT, class Functor>
+void ExecuteRangeFunctor(ArrayT *array, Functor& functor)
+{
+  if (CanComputeRangeInParallel(array))
+    {
+    vtkSMPTools::For(0, array->GetNumberOfTuples(), functor);
+    }
+  else
+    {
+    functor.Initialize();
+    functor(0, array->GetNumberOfTuples());
+    functor.Reduce();
+    }
+}
+
+//----------------------------------------------------------------------------
+// Compute the range of each component over the tuples of the array in
+// parallel, skipping NaN values and the tuples whose ghost value has any of
+// the GhostsToSkip bits set. NumComps is the number of components when it is
+// known at compile time, which lets the compiler unroll the inner loop, and
+// 0 otherwise.
+template <class ArrayT, class APIType, int NumComps>
+class ScalarRangeFunctor
+{
+  ArrayT *Array;
+  int NumberOfComponents;
+  const unsigned char *Ghosts;
+  unsigned char GhostsToSkip;
+  vtkSMPThreadLocal<std::vector<APIType> > TLRange;
 
-    for(int i = 0, j = 0; i < NumComps; ++i, j+=2)
+public:
+  // The reduced range of each component, as min,max pairs.
+  std::vector<APIType> Range;
+
+  ScalarRangeFunctor(ArrayT *array, const unsigned char *ghosts,
+                     unsigned char ghostsToSkip)
+    : Array(array), NumberOfComponents(array->GetNumberOfComponents()),
+      Ghosts(ghosts), GhostsToSkip(ghostsToSkip)
+  {
+    VTK_ASSUME(NumComps == 0 || this->NumberOfComponents == NumComps);
+    this->InitializeRange(this->Range);
+  }
+
+  void InitializeRange(std::vector<APIType>& range)
+  {
+    range.resize(2 * this->NumberOfComponents);
+    for (int i = 0, j = 0; i < this->NumberOfComponents; ++i, j+=2)
       {
-      tempRange[j] = vtkTypeTraits<APIType>::Max();
-      tempRange[j+1] = vtkTypeTraits<APIType>::Min();
+      range[j] = vtkTypeTraits<APIType>::Max();
+      range[j+1] = vtkTypeTraits<APIType>::Min();
       }
+  }
 
-    //compute the range for each component of the data array at the same time
-    const int numTuples = array->GetNumberOfTuples();
-    for(vtkIdType tupleIdx = 0; tupleIdx < numTuples; ++tupleIdx)
+  void Initialize()
+  {
+    this->InitializeRange(this->TLRange.Local());
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkDataArrayAccessor<ArrayT> access(this->Array);
+    const int numComps = NumComps > 0 ? NumComps : this->NumberOfComponents;
+    APIType *range = &this->TLRange.Local()[0];
+    for (vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
       {
-      for(int compIdx = 0, j = 0; compIdx < NumComps; ++compIdx, j+=2)
+      if (this->Ghosts && (this->Ghosts[tupleIdx] & this->GhostsToSkip))
         {
-        tempRange[j]   = detail::min(tempRange[j],
-                                     access.Get(tupleIdx, compIdx));
-        tempRange[j+1] = detail::max(tempRange[j+1],
-                                     access.Get(tupleIdx, compIdx));
+        continue;
+        }
+      for (int compIdx = 0, j = 0; compIdx < numComps; ++compIdx, j+=2)
+        {
+        const APIType value = access.Get(tupleIdx, compIdx);
+        if (!IsNan(value))
+          {
+          range[j]   = detail::min(range[j], value);
+          range[j+1] = detail::max(range[j+1], value);
+          }
         }
       }
+  }
 
-    //convert the range to doubles
-    for (int i = 0, j = 0; i < NumComps; ++i, j+=2)
+  void Reduce()
+  {
+    typename vtkSMPThreadLocal<std::vector<APIType> >::iterator itr;
+    for (itr = this->TLRange.begin(); itr != this->TLRange.end(); ++itr)
       {
-      ranges[j] = static_cast<double>(tempRange[j]);
-      ranges[j+1] = static_cast<double>(tempRange[j+1]);
+      for (int j = 0; j < 2 * this->NumberOfComponents; j+=2)
+        {
+        this->Range[j]   = detail::min(this->Range[j], (*itr)[j]);
+        this->Range[j+1] = detail::max(this->Range[j+1], (*itr)[j+1]);
+        }
       }
-    return true;
   }
 };
 
 //----------------------------------------------------------------------------
-template <typename ArrayT>
-bool DoComputeScalarRange(ArrayT *array, double *ranges)
+template <int NumComps, class ArrayT>
+bool ComputeScalarRange(ArrayT *array, double *ranges,
+                        const unsigned char *ghosts,
+                        unsigned char ghostsToSkip)
 {
-  vtkDataArrayAccessor<ArrayT> access(array);
   typedef typename vtkDataArrayAccessor<ArrayT>::APIType APIType;
+  ScalarRangeFunctor<ArrayT, APIType, NumComps> functor(array, ghosts,
+                                                        ghostsToSkip);
+  ExecuteRangeFunctor(array, functor);
 
-  const int numTuples = array->GetNumberOfTuples();
+  //convert the range to doubles
+  for (int j = 0; j < 2 * array->GetNumberOfComponents(); ++j)
+    {
+    ranges[j] = static_cast<double>(functor.Range[j]);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayT>
+bool DoComputeScalarRange(ArrayT *array, double *ranges,
+                          const unsigned char *ghosts = NULL,
+                          unsigned char ghostsToSkip = 0xff)
+{
+  const vtkIdType numTuples = array->GetNumberOfTuples();
   const int numComp = array->GetNumberOfComponents();
 
   //setup the initial ranges to be the max,min for double
@@ -128,88 +237,102 @@ bool DoComputeScalarRange(ArrayT *array, double *ranges)
     return false;
     }
 
-  //Special case for single value scalar range. This is done to help the
+  //Special case for small numbers of components. This is done to help the
   //compiler detect it can perform loop optimizations.
-  if (numComp == 1)
+  switch (numComp)
     {
-    return ComputeScalarRange<APIType,1,2>()(array, ranges);
+    case 1:
+      return ComputeScalarRange<1>(array, ranges, ghosts, ghostsToSkip);
+    case 2:
+      return ComputeScalarRange<2>(array, ranges, ghosts, ghostsToSkip);
+    case 3:
+      return ComputeScalarRange<3>(array, ranges, ghosts, ghostsToSkip);
+    case 4:
+      return ComputeScalarRange<4>(array, ranges, ghosts, ghostsToSkip);
+    case 6:
+      return ComputeScalarRange<6>(array, ranges, ghosts, ghostsToSkip);
+    case 9:
+      return ComputeScalarRange<9>(array, ranges, ghosts, ghostsToSkip);
+    default:
+      return ComputeScalarRange<0>(array, ranges, ghosts, ghostsToSkip);
     }
-  else if (numComp == 2)
-    {
-    return ComputeScalarRange<APIType,2,4>()(array, ranges);
-    }
-  else if (numComp == 3)
-    {
-    return ComputeScalarRange<APIType,3,6>()(array, ranges);
-    }
-  else if (numComp == 4)
-    {
-    return ComputeScalarRange<APIType,4,8>()(array, ranges);
-    }
-  else if (numComp == 5)
-    {
-    return ComputeScalarRange<APIType,5,10>()(array, ranges);
-    }
-  else if (numComp == 6)
-    {
-    return ComputeScalarRange<APIType,6,12>()(array, ranges);
-    }
-  else if (numComp == 7)
-    {
-    return ComputeScalarRange<APIType,7,14>()(array, ranges);
-    }
-  else if (numComp == 8)
-    {
-    return ComputeScalarRange<APIType,8,16>()(array, ranges);
-    }
-  else if (numComp == 9)
-    {
-    return ComputeScalarRange<APIType,9,18>()(array, ranges);
-    }
-  else
-    {
-    //initialize the temp range storage to min/max pairs
-    APIType* tempRange = new APIType[numComp*2];
-    for (int i = 0, j = 0; i < numComp; ++i, j+=2)
-      {
-      tempRange[j] = vtkTypeTraits<APIType>::Max();
-      tempRange[j+1] = vtkTypeTraits<APIType>::Min();
-      }
+}
+
+//----------------------------------------------------------------------------
+// Compute the range of the squared magnitude of the tuples in parallel,
+// skipping NaN magnitudes and ghost tuples.
+template <class ArrayT>
+class VectorRangeFunctor
+{
+  ArrayT *Array;
+  const unsigned char *Ghosts;
+  unsigned char GhostsToSkip;
+  vtkSMPThreadLocal<double> TLMin;
+  vtkSMPThreadLocal<double> TLMax;
+
+public:
+  double Range[2];
+
+  VectorRangeFunctor(ArrayT *array, const unsigned char *ghosts,
+                     unsigned char ghostsToSkip)
+    : Array(array), Ghosts(ghosts), GhostsToSkip(ghostsToSkip),
+      TLMin(vtkTypeTraits<double>::Max()), TLMax(vtkTypeTraits<double>::Min())
+  {
+    this->Range[0] = vtkTypeTraits<double>::Max();
+    this->Range[1] = vtkTypeTraits<double>::Min();
+  }
+
+  void Initialize()
+  {
+  }
 
-    //compute the range for each component of the data array at the same time
-    for (vtkIdType tupleIdx = 0; tupleIdx < numTuples; ++tupleIdx)
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkDataArrayAccessor<ArrayT> access(this->Array);
+    const int numComps = this->Array->GetNumberOfComponents();
+    double &rangeMin = this->TLMin.Local();
+    double &rangeMax = this->TLMax.Local();
+    for (vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
       {
-      for(int compIdx = 0, j = 0; compIdx < numComp; ++compIdx, j+=2)
+      if (this->Ghosts && (this->Ghosts[tupleIdx] & this->GhostsToSkip))
+        {
+        continue;
+        }
+      double squaredSum = 0.0;
+      for (int compIdx = 0; compIdx < numComps; ++compIdx)
         {
-        tempRange[j]   = detail::min(tempRange[j],
-                                     access.Get(tupleIdx, compIdx));
-        tempRange[j+1] = detail::max(tempRange[j+1],
-                                     access.Get(tupleIdx, compIdx));
+        const double t = static_cast<double>(access.Get(tupleIdx, compIdx));
+        squaredSum += t * t;
+        }
+      if (!IsNan(squaredSum))
+        {
+        rangeMin = detail::min(rangeMin, squaredSum);
+        rangeMax = detail::max(rangeMax, squaredSum);
         }
       }
+  }
 
-    //convert the range to doubles
-    for (int i = 0, j = 0; i < numComp; ++i, j+=2)
+  void Reduce()
+  {
+    vtkSMPThreadLocal<double>::iterator itr;
+    for (itr = this->TLMin.begin(); itr != this->TLMin.end(); ++itr)
       {
-      ranges[j] = static_cast<double>(tempRange[j]);
-      ranges[j+1] = static_cast<double>(tempRange[j+1]);
+      this->Range[0] = detail::min(this->Range[0], *itr);
       }
-
-    //cleanup temp range storage
-    delete[] tempRange;
-
-    return true;
-    }
-}
+    for (itr = this->TLMax.begin(); itr != this->TLMax.end(); ++itr)
+      {
+      this->Range[1] = detail::max(this->Range[1], *itr);
+      }
+  }
+};
 
 //----------------------------------------------------------------------------
 template <typename ArrayT>
-bool DoComputeVectorRange(ArrayT *array, double range[2])
+bool DoComputeVectorRange(ArrayT *array, double range[2],
+                          const unsigned char *ghosts = NULL,
+                          unsigned char ghostsToSkip = 0xff)
 {
-  vtkDataArrayAccessor<ArrayT> access(array);
-
-  const int numTuples = array->GetNumberOfTuples();
-  const int numComps = array->GetNumberOfComponents();
+  const vtkIdType numTuples = array->GetNumberOfTuples();
 
   range[0] = vtkTypeTraits<double>::Max();
   range[1] = vtkTypeTraits<double>::Min();
@@ -220,23 +343,16 @@ bool DoComputeVectorRange(ArrayT *array, double range[2])
     return false;
     }
 
-  //iterate over all the tuples
-  for (vtkIdType tupleIdx = 0; tupleIdx < numTuples; ++tupleIdx)
-    {
-    double squaredSum = 0.0;
-    for (int compIdx = 0; compIdx < numComps; ++compIdx)
-      {
-      const double t = static_cast<double>(access.Get(tupleIdx, compIdx));
-      squaredSum += t * t;
-      }
-    range[0] = detail::min(range[0], squaredSum);
-    range[1] = detail::max(range[1], squaredSum);
-    }
+  VectorRangeFunctor<ArrayT> functor(array, ghosts, ghostsToSkip);
+  ExecuteRangeFunctor(array, functor);
 
   //now that we have computed the smallest and largest value, take the
   //square root of that value.
-  range[0] = sqrt(range[0]);
-  range[1] = sqrt(range[1]);
+  if (functor.Range[0] <= functor.Range[1])
+    {
+    range[0] = sqrt(functor.Range[0]);
+    range[1] = sqrt(functor.Range[1]);
+    }
 
   return true;
 }
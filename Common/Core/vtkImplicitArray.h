@@ -0,0 +1,158 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImplicitArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkImplicitArray - read-only array computing its values on the fly.
+//
+// .SECTION Description
+// vtkImplicitArray is a vtkGenericDataArray whose values are not stored but
+// computed by a functor, the backend, when they are accessed. The array uses
+// a constant amount of memory whatever its number of tuples, and since the
+// backend is a template parameter, value access can be inlined when the array
+// is used through vtkArrayDispatch and vtkDataArrayAccessor.
+//
+// The backend must be copyable and provide:
+// - a ValueType typedef, the type of the values of the array,
+// - ValueType operator()(vtkIdType tupleIdx, int compIdx) const, which returns
+//   the component compIdx of the tuple tupleIdx. It is called concurrently by
+//   threaded code and must not modify the backend.
+//
+// The number of components and tuples are set as for any other array, with
+// SetNumberOfComponents() and SetNumberOfTuples(); no memory is allocated.
+// See vtkImplicitArrayBackends.h for backends implementing constant values,
+// affine ramps, the point coordinates of structured data and the
+// concatenation of other arrays:
+//
+// \code
+// vtkImplicitArray<vtkConstantImplicitBackend<double> > *ones =
+//   vtkImplicitArray<vtkConstantImplicitBackend<double> >::New();
+// ones->SetBackend(vtkConstantImplicitBackend<double>(1.0));
+// ones->SetNumberOfTuples(numberOfPoints);
+// \endcode
+//
+// The array is read-only: methods modifying the values print an error.
+// vtkDataArray::NewInstance() returns an array storing its values
+// (vtkAOSDataArrayTemplate), so that filters copying the data produce
+// regular arrays. GetVoidPointer()
+// computes all the values in a temporary buffer and should be avoided.
+//
+// .SECTION See Also
+// vtkGenericDataArray vtkImplicitArrayBackends vtkArrayDispatch
+
+#ifndef vtkImplicitArray_h
+#define vtkImplicitArray_h
+
+#include "vtkGenericDataArray.h"
+#include "vtkBuffer.h" // For the GetVoidPointer copy.
+
+template <class BackendT>
+class vtkImplicitArray :
+    public vtkGenericDataArray<vtkImplicitArray<BackendT>,
+                               typename BackendT::ValueType>
+{
+  typedef vtkGenericDataArray<vtkImplicitArray<BackendT>,
+                              typename BackendT::ValueType>
+          GenericDataArrayType;
+public:
+  typedef vtkImplicitArray<BackendT> SelfType;
+  vtkAbstractTemplateTypeMacro(SelfType, GenericDataArrayType)
+  vtkAOSArrayNewInstanceMacro(SelfType)
+  typedef typename Superclass::ValueType ValueType;
+  typedef BackendT BackendType;
+
+  static vtkImplicitArray* New();
+  virtual void PrintSelf(ostream &os, vtkIndent indent);
+
+  // Description:
+  // Set/Get the functor computing the values.
+  void SetBackend(const BackendType &backend);
+  const BackendType& GetBackend() const { return this->Backend; }
+
+  // Description:
+  // Get the value at @a valueIdx. @a valueIdx assumes AOS ordering.
+  inline ValueType GetValue(vtkIdType valueIdx) const
+  {
+    vtkIdType tupleIdx = valueIdx / this->NumberOfComponents;
+    return this->Backend(tupleIdx, static_cast<int>(
+                           valueIdx - tupleIdx * this->NumberOfComponents));
+  }
+
+  // Description:
+  // Copy the tuple at @a tupleIdx into @a tuple.
+  inline void GetTypedTuple(vtkIdType tupleIdx, ValueType* tuple) const
+  {
+    for (int c = 0; c < this->NumberOfComponents; ++c)
+      {
+      tuple[c] = this->Backend(tupleIdx, c);
+      }
+  }
+
+  // Description:
+  // Get component @a comp of the tuple at @a tupleIdx.
+  inline ValueType GetTypedComponent(vtkIdType tupleIdx, int comp) const
+  {
+    return this->Backend(tupleIdx, comp);
+  }
+
+  // Description:
+  // Read only container, print an error.
+  void SetValue(vtkIdType valueIdx, ValueType value);
+  void SetTypedTuple(vtkIdType tupleIdx, const ValueType* tuple);
+  void SetTypedComponent(vtkIdType tupleIdx, int comp, ValueType value);
+
+  // Description:
+  // Use of this method is discouraged: it computes all the values in a
+  // temporary AoS-ordered buffer and prints a warning. Modifications of the
+  // buffer are not reflected in the array.
+  virtual void *GetVoidPointer(vtkIdType valueIdx);
+
+  // Description:
+  // Export a copy of the values in AoS ordering to the preallocated memory
+  // buffer.
+  void ExportToVoidPointer(void *ptr);
+
+  // Description:
+  // Copy the backend and the dimensions of another array of the same type.
+  // Other arrays cannot be copied into this read-only container.
+  virtual void DeepCopy(vtkAbstractArray *aa);
+  virtual void DeepCopy(vtkDataArray *da);
+
+  // Description:
+  // Return the memory in kibibytes used by this array: the size of the
+  // values is not included since they are not stored.
+  virtual unsigned long GetActualMemorySize();
+
+protected:
+  vtkImplicitArray();
+  ~vtkImplicitArray();
+
+  // Description:
+  // No memory is needed to hold the tuples.
+  bool AllocateTuples(vtkIdType) { return true; }
+  bool ReallocateTuples(vtkIdType) { return true; }
+
+  BackendType Backend;
+  vtkBuffer<ValueType> *AoSCopy;
+
+private:
+  vtkImplicitArray(const vtkImplicitArray&); // Not implemented.
+  void operator=(const vtkImplicitArray&); // Not implemented.
+
+  friend class vtkGenericDataArray<vtkImplicitArray<BackendT>,
+                                   typename BackendT::ValueType>;
+};
+
+#include "vtkImplicitArray.txx"
+
+#endif
+// VTK-HeaderTest-Exclude: vtkImplicitArray.h
@@ -0,0 +1,185 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImplicitArray.txx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#ifndef vtkImplicitArray_txx
+#define vtkImplicitArray_txx
+
+#include "vtkImplicitArray.h"
+
+#include <cstdlib>
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+vtkImplicitArray<BackendT>* vtkImplicitArray<BackendT>::New()
+{
+  VTK_STANDARD_NEW_BODY(vtkImplicitArray<BackendT>);
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+vtkImplicitArray<BackendT>::vtkImplicitArray()
+  : AoSCopy(NULL)
+{
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+vtkImplicitArray<BackendT>::~vtkImplicitArray()
+{
+  if (this->AoSCopy)
+    {
+    this->AoSCopy->Delete();
+    this->AoSCopy = NULL;
+    }
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::PrintSelf(ostream &os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "AoSCopy: " << this->AoSCopy << "\n";
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::SetBackend(const BackendType &backend)
+{
+  this->Backend = backend;
+  this->DataChanged();
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::SetValue(vtkIdType, ValueType)
+{
+  vtkErrorMacro("Read only container.");
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::SetTypedTuple(vtkIdType, const ValueType*)
+{
+  vtkErrorMacro("Read only container.");
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::SetTypedComponent(vtkIdType, int, ValueType)
+{
+  vtkErrorMacro("Read only container.");
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void *vtkImplicitArray<BackendT>::GetVoidPointer(vtkIdType valueIdx)
+{
+  // Allow warnings to be silenced:
+  const char *silence = getenv("VTK_SILENCE_GET_VOID_POINTER_WARNINGS");
+  if (!silence)
+    {
+    vtkWarningMacro(<<"GetVoidPointer called. This is very expensive for "
+                      "implicit arrays, as all the values must be computed "
+                      "for each call. Using the vtkGenericDataArray API with "
+                      "vtkArrayDispatch are preferred. Define the environment "
+                      "variable VTK_SILENCE_GET_VOID_POINTER_WARNINGS to "
+                      "silence this warning.");
+    }
+
+  vtkIdType numValues = this->GetNumberOfValues();
+
+  if (!this->AoSCopy)
+    {
+    this->AoSCopy = vtkBuffer<ValueType>::New();
+    }
+
+  if (!this->AoSCopy->Allocate(numValues))
+    {
+    vtkErrorMacro(<<"Error allocating a buffer of " << numValues << " '"
+                  << this->GetDataTypeAsString() << "' elements.");
+    return NULL;
+    }
+
+  this->ExportToVoidPointer(static_cast<void*>(this->AoSCopy->GetBuffer()));
+
+  return static_cast<void*>(this->AoSCopy->GetBuffer() + valueIdx);
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::ExportToVoidPointer(void *voidPtr)
+{
+  vtkIdType numTuples = this->GetNumberOfTuples();
+  if (this->NumberOfComponents * numTuples == 0)
+    {
+    // Nothing to do.
+    return;
+    }
+
+  if (!voidPtr)
+    {
+    vtkErrorMacro(<< "Buffer is NULL.");
+    return;
+    }
+
+  ValueType *ptr = static_cast<ValueType*>(voidPtr);
+  for (vtkIdType t = 0; t < numTuples; ++t)
+    {
+    for (int c = 0; c < this->NumberOfComponents; ++c)
+      {
+      *ptr++ = this->Backend(t, c);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::DeepCopy(vtkAbstractArray *aa)
+{
+  this->DeepCopy(vtkArrayDownCast<vtkDataArray>(aa));
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::DeepCopy(vtkDataArray *da)
+{
+  if (da == NULL || da == this)
+    {
+    return;
+    }
+  SelfType *other = SelfType::SafeDownCast(da);
+  if (!other)
+    {
+    vtkErrorMacro("Read only container, cannot copy a "
+                  << da->GetClassName() << ".");
+    return;
+    }
+
+  this->SetNumberOfComponents(other->GetNumberOfComponents());
+  this->SetNumberOfTuples(other->GetNumberOfTuples());
+  this->CopyComponentNames(other);
+  this->SetBackend(other->GetBackend());
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+unsigned long vtkImplicitArray<BackendT>::GetActualMemorySize()
+{
+  vtkIdType copySize = this->AoSCopy ? this->AoSCopy->GetSize() : 0;
+  return static_cast<unsigned long>(
+    (sizeof(*this) + copySize * sizeof(ValueType)) / 1024 + 1);
+}
+
+#endif
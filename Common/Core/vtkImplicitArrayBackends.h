@@ -0,0 +1,249 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImplicitArrayBackends.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkImplicitArrayBackends - functors computing the values of
+// vtkImplicitArray.
+//
+// .SECTION Description
+// This file provides backends for common implicit arrays:
+// - vtkConstantImplicitBackend: the same value everywhere.
+// - vtkAffineImplicitBackend: Slope * tupleIdx + Intercept, for all the
+//   components of the tuple.
+// - vtkStructuredPointsImplicitBackend: the coordinates of the points of a
+//   structured extent given its origin and spacing, as in vtkImageData.
+// - vtkRectilinearPointsImplicitBackend: the coordinates of the points of a
+//   structured extent given the coordinates along each axis, as in
+//   vtkRectilinearGrid.
+// - vtkCompositeImplicitBackend: the tuples of several arrays, one array
+//   after the other.
+//
+// .SECTION See Also
+// vtkImplicitArray
+
+#ifndef vtkImplicitArrayBackends_h
+#define vtkImplicitArrayBackends_h
+
+#include "vtkDataArray.h"
+#include "vtkSmartPointer.h" // For vtkCompositeImplicitBackend
+
+#include <algorithm> // For std::upper_bound
+#include <vector> // For the coordinates and arrays
+
+//-----------------------------------------------------------------------------
+template <class ValueTypeT>
+struct vtkConstantImplicitBackend
+{
+  typedef ValueTypeT ValueType;
+
+  vtkConstantImplicitBackend(ValueType value = ValueType())
+    : Value(value)
+  {
+  }
+
+  ValueType operator()(vtkIdType, int) const
+  {
+    return this->Value;
+  }
+
+  ValueType Value;
+};
+
+//-----------------------------------------------------------------------------
+template <class ValueTypeT>
+struct vtkAffineImplicitBackend
+{
+  typedef ValueTypeT ValueType;
+
+  vtkAffineImplicitBackend(ValueType slope = ValueType(1),
+                           ValueType intercept = ValueType(0))
+    : Slope(slope), Intercept(intercept)
+  {
+  }
+
+  ValueType operator()(vtkIdType tupleIdx, int) const
+  {
+    return static_cast<ValueType>(this->Slope * tupleIdx + this->Intercept);
+  }
+
+  ValueType Slope;
+  ValueType Intercept;
+};
+
+//-----------------------------------------------------------------------------
+// Tuples are the points of the extent, the x index varying fastest.
+template <class ValueTypeT>
+struct vtkStructuredPointsImplicitBackend
+{
+  typedef ValueTypeT ValueType;
+
+  vtkStructuredPointsImplicitBackend()
+  {
+    for (int i = 0; i < 3; ++i)
+      {
+      this->Dimensions[i] = 1;
+      this->Start[i] = 0;
+      this->Origin[i] = 0.0;
+      this->Spacing[i] = 1.0;
+      }
+  }
+
+  vtkStructuredPointsImplicitBackend(const int extent[6],
+                                     const double origin[3],
+                                     const double spacing[3])
+  {
+    for (int i = 0; i < 3; ++i)
+      {
+      this->Dimensions[i] = extent[2*i+1] - extent[2*i] + 1;
+      this->Start[i] = extent[2*i];
+      this->Origin[i] = origin[i];
+      this->Spacing[i] = spacing[i];
+      }
+  }
+
+  // Description:
+  // Return the number of points of the extent.
+  vtkIdType GetNumberOfTuples() const
+  {
+    return this->Dimensions[0] * this->Dimensions[1] * this->Dimensions[2];
+  }
+
+  ValueType operator()(vtkIdType tupleIdx, int comp) const
+  {
+    vtkIdType ijk;
+    switch (comp)
+      {
+      case 0:
+        ijk = tupleIdx % this->Dimensions[0];
+        break;
+      case 1:
+        ijk = (tupleIdx / this->Dimensions[0]) % this->Dimensions[1];
+        break;
+      default:
+        ijk = tupleIdx / (this->Dimensions[0] * this->Dimensions[1]);
+        break;
+      }
+    return static_cast<ValueType>(
+      this->Origin[comp] + (this->Start[comp] + ijk) * this->Spacing[comp]);
+  }
+
+  vtkIdType Dimensions[3];
+  vtkIdType Start[3];
+  double Origin[3];
+  double Spacing[3];
+};
+
+//-----------------------------------------------------------------------------
+// Tuples are the points of the extent, the x index varying fastest. The
+// coordinates along each axis are copied, so the memory used is proportional
+// to the sum of the dimensions and not to their product.
+template <class ValueTypeT>
+struct vtkRectilinearPointsImplicitBackend
+{
+  typedef ValueTypeT ValueType;
+
+  vtkRectilinearPointsImplicitBackend()
+  {
+  }
+
+  vtkRectilinearPointsImplicitBackend(vtkDataArray *x, vtkDataArray *y,
+                                      vtkDataArray *z)
+  {
+    vtkDataArray *coords[3] = { x, y, z };
+    for (int i = 0; i < 3; ++i)
+      {
+      vtkIdType n = coords[i] ? coords[i]->GetNumberOfTuples() : 0;
+      this->Coordinates[i].resize(n > 0 ? n : 1, ValueType(0));
+      for (vtkIdType j = 0; j < n; ++j)
+        {
+        this->Coordinates[i][j] =
+          static_cast<ValueType>(coords[i]->GetComponent(j, 0));
+        }
+      }
+  }
+
+  // Description:
+  // Return the number of points of the extent.
+  vtkIdType GetNumberOfTuples() const
+  {
+    return static_cast<vtkIdType>(this->Coordinates[0].size() *
+                                  this->Coordinates[1].size() *
+                                  this->Coordinates[2].size());
+  }
+
+  ValueType operator()(vtkIdType tupleIdx, int comp) const
+  {
+    vtkIdType nx = static_cast<vtkIdType>(this->Coordinates[0].size());
+    vtkIdType ny = static_cast<vtkIdType>(this->Coordinates[1].size());
+    switch (comp)
+      {
+      case 0:
+        return this->Coordinates[0][tupleIdx % nx];
+      case 1:
+        return this->Coordinates[1][(tupleIdx / nx) % ny];
+      default:
+        return this->Coordinates[2][tupleIdx / (nx * ny)];
+      }
+  }
+
+  std::vector<ValueType> Coordinates[3];
+};
+
+//-----------------------------------------------------------------------------
+// The arrays are referenced, not copied, and must have the number of
+// components of the implicit array. Values are read through the vtkDataArray
+// API, which is slower than the other backends.
+template <class ValueTypeT>
+struct vtkCompositeImplicitBackend
+{
+  typedef ValueTypeT ValueType;
+
+  vtkCompositeImplicitBackend()
+  {
+    this->Offsets.push_back(0);
+  }
+
+  // Description:
+  // Append the tuples of an array.
+  void AddArray(vtkDataArray *array)
+  {
+    if (array)
+      {
+      this->Arrays.push_back(array);
+      this->Offsets.push_back(this->Offsets.back() +
+                              array->GetNumberOfTuples());
+      }
+  }
+
+  // Description:
+  // Return the total number of tuples of the arrays.
+  vtkIdType GetNumberOfTuples() const
+  {
+    return this->Offsets.back();
+  }
+
+  ValueType operator()(vtkIdType tupleIdx, int comp) const
+  {
+    // Offsets[a] is the first tuple of array a.
+    size_t a = std::upper_bound(this->Offsets.begin(), this->Offsets.end(),
+                                tupleIdx) - this->Offsets.begin() - 1;
+    return static_cast<ValueType>(
+      this->Arrays[a]->GetComponent(tupleIdx - this->Offsets[a], comp));
+  }
+
+  std::vector<vtkSmartPointer<vtkDataArray> > Arrays;
+  std::vector<vtkIdType> Offsets;
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkImplicitArrayBackends.h
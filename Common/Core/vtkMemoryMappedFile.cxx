@@ -0,0 +1,224 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMemoryMappedFile.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkMemoryMappedFile.h"
+
+#include "vtkObjectFactory.h"
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+# define VTK_MEMORY_MAPPED_FILE_WIN32
+# include "vtkWindows.h"
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+vtkStandardNewMacro(vtkMemoryMappedFile);
+
+//----------------------------------------------------------------------------
+vtkMemoryMappedFile::vtkMemoryMappedFile()
+{
+  this->Mode = COPY_ON_WRITE;
+  this->Data = NULL;
+  this->Length = 0;
+  this->View = NULL;
+  this->ViewLength = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMemoryMappedFile::~vtkMemoryMappedFile()
+{
+  this->Unmap();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMemoryMappedFile::IsSupported()
+{
+  return true;
+}
+
+#ifdef VTK_MEMORY_MAPPED_FILE_WIN32
+//----------------------------------------------------------------------------
+bool vtkMemoryMappedFile::Map(const char* fileName, vtkTypeInt64 offset,
+                              vtkTypeInt64 length)
+{
+  this->Unmap();
+  if (!fileName || offset < 0 || length < 0)
+    {
+    vtkErrorMacro("Invalid file region.");
+    return false;
+    }
+
+  HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+    {
+    vtkErrorMacro("Cannot open file " << fileName);
+    return false;
+    }
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize))
+    {
+    CloseHandle(file);
+    vtkErrorMacro("Cannot get the size of file " << fileName);
+    return false;
+    }
+  if (length == 0)
+    {
+    length = fileSize.QuadPart - offset;
+    }
+  if (length <= 0 || offset + length > fileSize.QuadPart)
+    {
+    CloseHandle(file);
+    vtkErrorMacro("The region is not in file " << fileName);
+    return false;
+    }
+
+  // Views must start on a multiple of the allocation granularity.
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  vtkTypeInt64 viewOffset = offset - offset % info.dwAllocationGranularity;
+  vtkTypeInt64 viewLength = length + (offset - viewOffset);
+
+  HANDLE mapping = CreateFileMappingA(file, NULL,
+    this->Mode == READ_ONLY ? PAGE_READONLY : PAGE_WRITECOPY, 0, 0, NULL);
+  CloseHandle(file);
+  if (!mapping)
+    {
+    vtkErrorMacro("Cannot map file " << fileName);
+    return false;
+    }
+  void* view = MapViewOfFile(mapping,
+    this->Mode == READ_ONLY ? FILE_MAP_READ : FILE_MAP_COPY,
+    static_cast<DWORD>(viewOffset >> 32),
+    static_cast<DWORD>(viewOffset & 0xffffffff),
+    static_cast<SIZE_T>(viewLength));
+  // The view keeps the mapping alive.
+  CloseHandle(mapping);
+  if (!view)
+    {
+    vtkErrorMacro("Cannot map a view of file " << fileName);
+    return false;
+    }
+
+  this->View = view;
+  this->ViewLength = viewLength;
+  this->Data = static_cast<char*>(view) + (offset - viewOffset);
+  this->Length = length;
+  this->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMemoryMappedFile::Unmap()
+{
+  if (this->View)
+    {
+    UnmapViewOfFile(this->View);
+    this->View = NULL;
+    this->ViewLength = 0;
+    this->Data = NULL;
+    this->Length = 0;
+    this->Modified();
+    }
+}
+
+#else
+//----------------------------------------------------------------------------
+bool vtkMemoryMappedFile::Map(const char* fileName, vtkTypeInt64 offset,
+                              vtkTypeInt64 length)
+{
+  this->Unmap();
+  if (!fileName || offset < 0 || length < 0)
+    {
+    vtkErrorMacro("Invalid file region.");
+    return false;
+    }
+
+  int fd = open(fileName, O_RDONLY);
+  if (fd < 0)
+    {
+    vtkErrorMacro("Cannot open file " << fileName);
+    return false;
+    }
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0)
+    {
+    close(fd);
+    vtkErrorMacro("Cannot get the size of file " << fileName);
+    return false;
+    }
+  vtkTypeInt64 fileSize = static_cast<vtkTypeInt64>(fileStat.st_size);
+  if (length == 0)
+    {
+    length = fileSize - offset;
+    }
+  if (length <= 0 || offset + length > fileSize)
+    {
+    close(fd);
+    vtkErrorMacro("The region is not in file " << fileName);
+    return false;
+    }
+
+  // Views must start on a page boundary.
+  vtkTypeInt64 pageSize = static_cast<vtkTypeInt64>(sysconf(_SC_PAGESIZE));
+  vtkTypeInt64 viewOffset = offset - offset % pageSize;
+  vtkTypeInt64 viewLength = length + (offset - viewOffset);
+
+  // A private writable mapping is copy-on-write: the file is never modified.
+  void* view = mmap(NULL, static_cast<size_t>(viewLength),
+    this->Mode == READ_ONLY ? PROT_READ : PROT_READ | PROT_WRITE,
+    MAP_PRIVATE, fd, static_cast<off_t>(viewOffset));
+  // The mapping keeps a reference to the file.
+  close(fd);
+  if (view == MAP_FAILED)
+    {
+    vtkErrorMacro("Cannot map file " << fileName);
+    return false;
+    }
+
+  this->View = view;
+  this->ViewLength = viewLength;
+  this->Data = static_cast<char*>(view) + (offset - viewOffset);
+  this->Length = length;
+  this->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMemoryMappedFile::Unmap()
+{
+  if (this->View)
+    {
+    munmap(this->View, static_cast<size_t>(this->ViewLength));
+    this->View = NULL;
+    this->ViewLength = 0;
+    this->Data = NULL;
+    this->Length = 0;
+    this->Modified();
+    }
+}
+#endif
+
+//----------------------------------------------------------------------------
+void vtkMemoryMappedFile::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Mode: "
+     << (this->Mode == READ_ONLY ? "ReadOnly" : "CopyOnWrite") << endl;
+  os << indent << "Data: " << this->Data << endl;
+  os << indent << "Length: " << this->Length << endl;
+}
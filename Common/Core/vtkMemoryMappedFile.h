@@ -0,0 +1,106 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMemoryMappedFile.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkMemoryMappedFile - a region of a file mapped in memory
+// .SECTION Description
+// vtkMemoryMappedFile maps a region of a file in the address space of the
+// process, so that data stored in the file can be used without reading it.
+// Pages are only read from the file when they are first accessed, and the
+// system shares them between all the processes that map the same file.
+// The region stays mapped until Unmap() is called or the object is
+// destroyed; since the object is reference counted, arrays using the mapped
+// memory (see vtkAOSDataArrayTemplate::SetMappedArray()) keep it alive.
+//
+// In READ_ONLY mode, writing to the mapped memory crashes the program. In
+// COPY_ON_WRITE mode (the default), the pages that are written to become
+// private copies, and the file is never modified.
+//
+// .SECTION See Also
+// vtkAOSDataArrayTemplate vtkBuffer
+
+#ifndef vtkMemoryMappedFile_h
+#define vtkMemoryMappedFile_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkObject.h"
+
+class VTKCOMMONCORE_EXPORT vtkMemoryMappedFile : public vtkObject
+{
+public:
+  static vtkMemoryMappedFile* New();
+  vtkTypeMacro(vtkMemoryMappedFile, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  enum Modes
+    {
+    READ_ONLY = 0,
+    COPY_ON_WRITE
+    };
+
+  // Description:
+  // Set/Get how the file is mapped, READ_ONLY or COPY_ON_WRITE. Takes effect
+  // on the next call to Map().
+  vtkSetClampMacro(Mode, int, READ_ONLY, COPY_ON_WRITE);
+  vtkGetMacro(Mode, int);
+  void SetModeToReadOnly() { this->SetMode(READ_ONLY); }
+  void SetModeToCopyOnWrite() { this->SetMode(COPY_ON_WRITE); }
+
+  // Description:
+  // Map length bytes of the file starting at offset (in bytes), or the rest
+  // of the file when length is 0. The offset does not need to be aligned on
+  // pages. Any previous region is unmapped first. Returns false, with an
+  // error, if the file cannot be mapped.
+  bool Map(const char* fileName, vtkTypeInt64 offset = 0,
+           vtkTypeInt64 length = 0);
+
+  // Description:
+  // Release the mapped region. Memory obtained from GetData() must not be
+  // used anymore.
+  void Unmap();
+
+  // Description:
+  // Return the start of the mapped region, i.e. the byte at the requested
+  // offset in the file, or NULL when nothing is mapped.
+  void* GetData() { return this->Data; }
+
+  // Description:
+  // Return the size of the mapped region, in bytes.
+  vtkTypeInt64 GetLength() { return this->Length; }
+
+  // Description:
+  // Return true if a region is mapped.
+  bool IsMapped() { return this->Data != NULL; }
+
+  // Description:
+  // Return true if memory mapped files are supported on this platform.
+  static bool IsSupported();
+
+protected:
+  vtkMemoryMappedFile();
+  ~vtkMemoryMappedFile();
+
+  int Mode;
+  void* Data;
+  vtkTypeInt64 Length;
+
+  // The page aligned view that was mapped, which contains the region.
+  void* View;
+  vtkTypeInt64 ViewLength;
+
+private:
+  vtkMemoryMappedFile(const vtkMemoryMappedFile&);  // Not implemented.
+  void operator=(const vtkMemoryMappedFile&);  // Not implemented.
+};
+
+#endif
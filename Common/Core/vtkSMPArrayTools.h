@@ -0,0 +1,190 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPArrayTools.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkSMPArrayTools - Parallel algorithms on the values of data arrays.
+// .SECTION Description
+// vtkSMPArrayTools provides the algorithms of vtkSMPTools (Reduce, the
+// scans, Transform and Fill) for all the values of data arrays, in tuple
+// order. The arrays are either of a concrete type, e.g. in a
+// vtkArrayDispatch worker, or vtkDataArray, whose values are read and
+// written as double. The values of a vtkDataArray go through its virtual
+// API, which some arrays implement with shared temporary buffers, so these
+// arrays are processed serially, with the same results.
+// .SECTION See Also
+// vtkSMPTools vtkDataArrayAccessor
+
+#ifndef vtkSMPArrayTools_h
+#define vtkSMPArrayTools_h
+
+#include "vtkDataArrayAccessor.h" // For the values of the arrays
+#include "vtkSMPTools.h"
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+#ifndef __WRAP__
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+// Description:
+// Random access to the values of a data array in tuple order.
+template <typename ArrayT>
+struct vtkSMPTools_ArrayRange
+{
+  typedef typename vtkDataArrayAccessor<ArrayT>::APIType ValueType;
+  vtkDataArrayAccessor<ArrayT> Accessor;
+  int NumberOfComponents;
+  vtkSMPTools_ArrayRange(ArrayT* array)
+    : Accessor(array), NumberOfComponents(array->GetNumberOfComponents()) {}
+  ValueType Get(vtkIdType i) const
+  {
+    return this->NumberOfComponents == 1 ? this->Accessor.Get(i, 0) :
+      this->Accessor.Get(i / this->NumberOfComponents,
+                         static_cast<int>(i % this->NumberOfComponents));
+  }
+  template <typename T>
+  void Set(vtkIdType i, const T& value) const
+  {
+    if (this->NumberOfComponents == 1)
+      {
+      this->Accessor.Set(i, 0, static_cast<ValueType>(value));
+      }
+    else
+      {
+      this->Accessor.Set(i / this->NumberOfComponents,
+                         static_cast<int>(i % this->NumberOfComponents),
+                         static_cast<ValueType>(value));
+      }
+  }
+};
+} // namespace smp
+} // namespace detail
+} // namespace vtk
+#endif // __WRAP__
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+class vtkSMPArrayTools
+{
+public:
+  // Description:
+  // Combine all the values of a data array in parallel, as
+  // vtkSMPTools::Reduce().
+  template <typename ArrayT, typename T, typename BinaryOp>
+  static T Reduce(ArrayT* array, T init, BinaryOp op)
+  {
+    return vtkSMPTools::RangeReduce(
+      vtk::detail::smp::vtkSMPTools_ArrayRange<ArrayT>(array),
+      array->GetNumberOfValues(), init, op,
+      vtkSMPArrayTools::InParallel(array));
+  }
+
+  // Description:
+  // Compute the inclusive and exclusive prefix sums of all the values of a
+  // data array in parallel, as vtkSMPTools::InclusiveScan() and
+  // vtkSMPTools::ExclusiveScan(). The output array is resized as the input
+  // array and can be the input array; the sums are computed with its value
+  // type. ExclusiveScan() returns the sum of init and all the values.
+  template <typename InArrayT, typename OutArrayT>
+  static void InclusiveScan(InArrayT* in, OutArrayT* out)
+  {
+    typedef typename
+      vtk::detail::smp::vtkSMPTools_ArrayRange<OutArrayT>::ValueType T;
+    vtkSMPArrayTools::ResizeLike(in, out);
+    vtkSMPTools::RangeScan<T>(
+      vtk::detail::smp::vtkSMPTools_ArrayRange<InArrayT>(in),
+      vtk::detail::smp::vtkSMPTools_ArrayRange<OutArrayT>(out),
+      in->GetNumberOfValues(), NULL, std::plus<T>(), true,
+      vtkSMPArrayTools::InParallel(in) && vtkSMPArrayTools::InParallel(out));
+  }
+  template <typename InArrayT, typename OutArrayT, typename T>
+  static T ExclusiveScan(InArrayT* in, OutArrayT* out, T init)
+  {
+    typedef typename
+      vtk::detail::smp::vtkSMPTools_ArrayRange<OutArrayT>::ValueType ValueT;
+    vtkSMPArrayTools::ResizeLike(in, out);
+    ValueT start = static_cast<ValueT>(init);
+    return static_cast<T>(vtkSMPTools::RangeScan<ValueT>(
+      vtk::detail::smp::vtkSMPTools_ArrayRange<InArrayT>(in),
+      vtk::detail::smp::vtkSMPTools_ArrayRange<OutArrayT>(out),
+      in->GetNumberOfValues(), &start, std::plus<ValueT>(), false,
+      vtkSMPArrayTools::InParallel(in) && vtkSMPArrayTools::InParallel(out)));
+  }
+
+  // Description:
+  // Apply an operation to all the values of a data array in parallel and
+  // store the results in the output array, which is resized as the input
+  // array and can be the input array.
+  template <typename InArrayT, typename OutArrayT, typename UnaryOp>
+  static void Transform(InArrayT* in, OutArrayT* out, UnaryOp op)
+  {
+    vtkSMPArrayTools::ResizeLike(in, out);
+    vtk::detail::smp::vtkSMPTools_TransformFunctor<
+      vtk::detail::smp::vtkSMPTools_ArrayRange<InArrayT>,
+      vtk::detail::smp::vtkSMPTools_ArrayRange<OutArrayT>, UnaryOp>
+      transform(in, out, op);
+    vtkSMPArrayTools::ForValues(
+      in->GetNumberOfValues(), transform,
+      vtkSMPArrayTools::InParallel(in) && vtkSMPArrayTools::InParallel(out));
+  }
+
+  // Description:
+  // Assign a value to all the values of a data array in parallel.
+  template <typename ArrayT, typename T>
+  static void Fill(ArrayT* array, const T& value)
+  {
+    vtk::detail::smp::vtkSMPTools_FillFunctor<
+      vtk::detail::smp::vtkSMPTools_ArrayRange<ArrayT>, T> fill(array, value);
+    vtkSMPArrayTools::ForValues(array->GetNumberOfValues(), fill,
+                                vtkSMPArrayTools::InParallel(array));
+  }
+
+private:
+  // Only the arrays of a concrete type are processed in parallel.
+  template <typename ArrayT>
+  static bool InParallel(ArrayT*)
+  {
+    return true;
+  }
+  static bool InParallel(vtkDataArray*)
+  {
+    return false;
+  }
+
+  template <typename Functor>
+  static void ForValues(vtkIdType numValues, Functor& f, bool parallel)
+  {
+    if (parallel)
+      {
+      vtkSMPTools::For(0, numValues, f);
+      }
+    else if (numValues > 0)
+      {
+      f(0, numValues);
+      }
+  }
+
+  template <typename InArrayT, typename OutArrayT>
+  static void ResizeLike(InArrayT* in, OutArrayT* out)
+  {
+    if (static_cast<void*>(in) != static_cast<void*>(out))
+      {
+      out->SetNumberOfComponents(in->GetNumberOfComponents());
+      out->SetNumberOfTuples(in->GetNumberOfTuples());
+      }
+  }
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSMPArrayTools.h
@@ -17,7 +17,7 @@
 // vtkSMPTools provides a set of utility functions that can
 // be used to parallelize parts of VTK code using multiple threads.
 // There are several back-end implementations of parallel functionality
-// (currently Sequential, TBB and X-Kaapi) that actual execution is
+// (currently Sequential, STDThread, OpenMP and TBB) that actual execution is
 // delegated to.
 
 #ifndef vtkSMPTools_h
@@ -29,6 +29,11 @@
 #include "vtkSMPThreadLocal.h" // For Initialized
 #include "vtkSMPToolsInternal.h"
 
+#include <algorithm> // For std::min
+#include <functional> // For std::plus
+#include <iterator> // For std::iterator_traits
+#include <vector> // For the partial results of the blocks
+
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 #ifndef __WRAP__
@@ -38,6 +43,25 @@ namespace detail
 {
 namespace smp
 {
+// Description:
+// Count the functor executions in progress on the calling thread, to know
+// when a For() is nested in another one (see vtkSMPTools::IsParallelScope()).
+VTKCOMMONCORE_EXPORT void vtkSMPTools_EnterScope();
+VTKCOMMONCORE_EXPORT void vtkSMPTools_ExitScope();
+
+// Description:
+// Return true when a For() called from the current thread must run serially
+// on this thread, i.e. when it is nested in another For() and nested
+// parallelism is disabled.
+VTKCOMMONCORE_EXPORT bool vtkSMPTools_ShouldSerialize();
+
+class vtkSMPTools_Scope
+{
+public:
+  vtkSMPTools_Scope() { vtkSMPTools_EnterScope(); }
+  ~vtkSMPTools_Scope() { vtkSMPTools_ExitScope(); }
+};
+
 template <typename T>
 class vtkSMPTools_Has_Initialize
 {
@@ -72,10 +96,19 @@ struct vtkSMPTools_FunctorInternal<Functor, false>
   vtkSMPTools_FunctorInternal(Functor& f): F(f) {}
   void Execute(vtkIdType first, vtkIdType last)
   {
+    vtkSMPTools_Scope scope;
     this->F(first, last);
   }
   void For(vtkIdType first, vtkIdType last, vtkIdType grain)
   {
+    if (vtkSMPTools_ShouldSerialize())
+      {
+      if (first < last)
+        {
+        this->Execute(first, last);
+        }
+      return;
+      }
     vtk::detail::smp::vtkSMPTools_Impl_For(first, last, grain, *this);
   }
   vtkSMPTools_FunctorInternal<Functor, false>& operator=(
@@ -92,6 +125,7 @@ struct vtkSMPTools_FunctorInternal<Functor, true>
   vtkSMPTools_FunctorInternal(Functor& f): F(f), Initialized(0) {}
   void Execute(vtkIdType first, vtkIdType last)
   {
+    vtkSMPTools_Scope scope;
     unsigned char& inited = this->Initialized.Local();
     if (!inited)
       {
@@ -102,7 +136,17 @@ struct vtkSMPTools_FunctorInternal<Functor, true>
   }
   void For(vtkIdType first, vtkIdType last, vtkIdType grain)
   {
-    vtk::detail::smp::vtkSMPTools_Impl_For(first, last, grain, *this);
+    if (vtkSMPTools_ShouldSerialize())
+      {
+      if (first < last)
+        {
+        this->Execute(first, last);
+        }
+      }
+    else
+      {
+      vtk::detail::smp::vtkSMPTools_Impl_For(first, last, grain, *this);
+      }
     this->F.Reduce();
   }
   vtkSMPTools_FunctorInternal<Functor, true>& operator=(
@@ -126,6 +170,191 @@ class vtkSMPTools_Lookup_For<Functor const>
 public:
   typedef vtkSMPTools_FunctorInternal<Functor const, init> type;
 };
+
+// Description:
+// Size of the blocks processed by Reduce() and the scans. It only depends on
+// the number of items, so that the order in which values are combined, and
+// therefore the result for floating point values, is the same for all
+// back-ends and numbers of threads.
+inline vtkIdType vtkSMPTools_BlockSize(vtkIdType n)
+{
+  vtkIdType size = (n + 255) / 256;
+  return size < 1024 ? 1024 : size;
+}
+
+// Description:
+// Random access to the items of the ranges the algorithms of vtkSMPTools
+// work on: the values f(first+i) of a functor and the items of a random
+// access iterator range (see vtkSMPArrayTools for data arrays).
+template <typename ValueT, typename ValueFunctor>
+struct vtkSMPTools_FunctorRange
+{
+  typedef ValueT ValueType;
+  ValueFunctor F;
+  vtkIdType First;
+  vtkSMPTools_FunctorRange(ValueFunctor f, vtkIdType first)
+    : F(f), First(first) {}
+  ValueType Get(vtkIdType i) const { return this->F(this->First + i); }
+};
+
+template <typename Iterator>
+struct vtkSMPTools_IteratorRange
+{
+  typedef typename std::iterator_traits<Iterator>::value_type ValueType;
+  Iterator Begin;
+  vtkSMPTools_IteratorRange(Iterator begin) : Begin(begin) {}
+  ValueType Get(vtkIdType i) const { return this->Begin[i]; }
+  template <typename T>
+  void Set(vtkIdType i, const T& value) const { this->Begin[i] = value; }
+};
+
+// Description:
+// Combine the items of each block of a range, in order.
+template <typename T, typename Range, typename BinaryOp>
+struct vtkSMPTools_ReduceBlocks
+{
+  Range In;
+  BinaryOp Op;
+  vtkIdType Size;
+  vtkIdType BlockSize;
+  T* Results;
+
+  vtkSMPTools_ReduceBlocks(Range in, BinaryOp op, vtkIdType size,
+                           vtkIdType blockSize, T* results)
+    : In(in), Op(op), Size(size), BlockSize(blockSize), Results(results) {}
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+      {
+      vtkIdType i = block * this->BlockSize;
+      vtkIdType end = std::min(i + this->BlockSize, this->Size);
+      T value = static_cast<T>(this->In.Get(i));
+      for (++i; i < end; ++i)
+        {
+        value = this->Op(value, static_cast<T>(this->In.Get(i)));
+        }
+      this->Results[block] = value;
+      }
+  }
+};
+
+// Description:
+// Scan the items of each block of a range, starting from the combination
+// of the items of the previous blocks. When HasStart is false, the first
+// block starts with its first item (inclusive scan without initial value).
+template <typename T, typename InRange, typename OutRange, typename BinaryOp>
+struct vtkSMPTools_ScanBlocks
+{
+  InRange In;
+  OutRange Out;
+  BinaryOp Op;
+  vtkIdType Size;
+  vtkIdType BlockSize;
+  const T* Starts;
+  bool Inclusive;
+  bool HasStart;
+
+  vtkSMPTools_ScanBlocks(InRange in, OutRange out, BinaryOp op,
+                         vtkIdType size, vtkIdType blockSize,
+                         const T* starts, bool inclusive, bool hasStart)
+    : In(in), Out(out), Op(op), Size(size), BlockSize(blockSize),
+      Starts(starts), Inclusive(inclusive), HasStart(hasStart) {}
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+      {
+      vtkIdType i = block * this->BlockSize;
+      vtkIdType end = std::min(i + this->BlockSize, this->Size);
+      T value;
+      if (block == 0 && !this->HasStart)
+        {
+        value = static_cast<T>(this->In.Get(0));
+        this->Out.Set(0, value);
+        ++i;
+        }
+      else
+        {
+        value = this->Starts[block];
+        }
+      for (; i < end; ++i)
+        {
+        // Read the input before writing the output, for in-place scans.
+        T item = static_cast<T>(this->In.Get(i));
+        if (this->Inclusive)
+          {
+          value = this->Op(value, item);
+          this->Out.Set(i, value);
+          }
+        else
+          {
+          this->Out.Set(i, value);
+          value = this->Op(value, item);
+          }
+        }
+      }
+  }
+};
+
+template <typename InRange, typename OutRange, typename UnaryOp>
+struct vtkSMPTools_TransformFunctor
+{
+  InRange In;
+  OutRange Out;
+  UnaryOp Op;
+
+  vtkSMPTools_TransformFunctor(InRange in, OutRange out, UnaryOp op)
+    : In(in), Out(out), Op(op) {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Out.Set(i, this->Op(this->In.Get(i)));
+      }
+  }
+};
+
+template <typename InRange1, typename InRange2, typename OutRange,
+          typename BinaryOp>
+struct vtkSMPTools_BinaryTransformFunctor
+{
+  InRange1 In1;
+  InRange2 In2;
+  OutRange Out;
+  BinaryOp Op;
+
+  vtkSMPTools_BinaryTransformFunctor(InRange1 in1, InRange2 in2,
+                                     OutRange out, BinaryOp op)
+    : In1(in1), In2(in2), Out(out), Op(op) {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Out.Set(i, this->Op(this->In1.Get(i), this->In2.Get(i)));
+      }
+  }
+};
+
+template <typename OutRange, typename T>
+struct vtkSMPTools_FillFunctor
+{
+  OutRange Out;
+  T Value;
+
+  vtkSMPTools_FillFunctor(OutRange out, const T& value)
+    : Out(out), Value(value) {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Out.Set(i, this->Value);
+      }
+  }
+};
 } // namespace smp
 } // namespace detail
 } // namespace vtk
@@ -199,8 +428,10 @@ public:
   // not required as it is automatically called before the first
   // execution of any parallel code. However, it can be used to
   // control the maximum number of threads used when the back-end
-  // supports it (currently Simple and TBB only). Make sure to call
-  // it before any other parallel operation.
+  // supports it (currently STDThread, OpenMP and TBB). Make sure to call
+  // it before any other parallel operation. With STDThread, numThreads is
+  // the size of the thread pool (including the calling thread); a pool of
+  // one thread per core is created when it is 0.
   // When using Kaapi, use the KAAPI_CPUCOUNT env. variable to control
   // the number of threads used in the thread pool.
   static void Initialize(int numThreads=0);
@@ -212,10 +443,147 @@ public:
   // available threads.
   static int GetEstimatedNumberOfThreads();
 
+  // Description:
+  // Select the back-end used by the following parallel operations by name:
+  // "Sequential", "STDThread", "OpenMP" or "TBB". Back-ends can only be
+  // changed when VTK_SMP_IMPLEMENTATION_TYPE is Runtime, among those enabled
+  // at build time; other builds only accept the name of their back-end.
+  // The initial back-end of a Runtime build is VTK_SMP_DEFAULT_BACKEND, or
+  // the one named by the VTK_SMP_BACKEND_IN_USE environment variable.
+  // Returns false if the back-end is not available. Do not call this while
+  // parallel operations are running.
+  static bool SetBackend(const char* backend);
+
+  // Description:
+  // Get the name of the back-end in use.
+  static const char* GetBackend();
+
+  // Description:
+  // Control what happens when For() is called from a functor executed by
+  // another For(). When on (the default), the nested loop is handed over
+  // to the back-end like any other loop. When off, it runs serially on the
+  // calling thread, which avoids over-subscribing the threads when the
+  // outer loop already keeps them all busy.
+  static void SetNestedParallelism(bool isNested);
+  static bool GetNestedParallelism();
+
+  // Description:
+  // Return true when called from a functor executed by For(), on any thread.
+  static bool IsParallelScope();
+
+  // Description:
+  // Combine the values f(first), ..., f(last-1) of a functor in parallel,
+  // starting from init: op(...op(op(init, f(first)), f(first+1))...).
+  // The operation must be associative. The values are combined in blocks
+  // whose boundaries only depend on last-first, and the results of the
+  // blocks are combined in order, so the result is the same with all
+  // back-ends and numbers of threads, even for floating point sums.
+  template <typename T, typename ValueFunctor, typename BinaryOp>
+  static T Reduce(vtkIdType first, vtkIdType last, T init, ValueFunctor f,
+                  BinaryOp op)
+  {
+    return vtkSMPTools::RangeReduce(
+      vtk::detail::smp::vtkSMPTools_FunctorRange<T, ValueFunctor>(f, first),
+      last - first, init, op);
+  }
+
+  // Description:
+  // Combine the items of a random access iterator range in parallel, as
+  // Reduce() above.
+  template <typename Iterator, typename T, typename BinaryOp>
+  static T Reduce(Iterator begin, Iterator end, T init, BinaryOp op)
+  {
+    return vtkSMPTools::RangeReduce(
+      vtk::detail::smp::vtkSMPTools_IteratorRange<Iterator>(begin),
+      static_cast<vtkIdType>(end - begin), init, op);
+  }
+
+  // Description:
+  // Compute the inclusive prefix sum (or prefix op) of a random access
+  // iterator range in parallel: out[i] = in[0] op ... op in[i]. The output
+  // may be the input. The result is deterministic, as with Reduce().
+  template <typename InputIt, typename OutputIt>
+  static void InclusiveScan(InputIt begin, InputIt end, OutputIt out)
+  {
+    typedef typename std::iterator_traits<InputIt>::value_type T;
+    vtkSMPTools::InclusiveScan(begin, end, out, std::plus<T>());
+  }
+  template <typename InputIt, typename OutputIt, typename BinaryOp>
+  static void InclusiveScan(InputIt begin, InputIt end, OutputIt out,
+                            BinaryOp op)
+  {
+    typedef typename std::iterator_traits<InputIt>::value_type T;
+    vtkSMPTools::RangeScan<T>(
+      vtk::detail::smp::vtkSMPTools_IteratorRange<InputIt>(begin),
+      vtk::detail::smp::vtkSMPTools_IteratorRange<OutputIt>(out),
+      static_cast<vtkIdType>(end - begin), NULL, op, true);
+  }
+
+  // Description:
+  // Compute the exclusive prefix sum (or prefix op) of a random access
+  // iterator range in parallel: out[0] = init and out[i] = init op in[0]
+  // op ... op in[i-1]. The output may be the input. Returns the combination
+  // of init and all the items, e.g. the size of the data when computing
+  // offsets from sizes. The result is deterministic, as with Reduce().
+  template <typename InputIt, typename OutputIt, typename T>
+  static T ExclusiveScan(InputIt begin, InputIt end, OutputIt out, T init)
+  {
+    return vtkSMPTools::ExclusiveScan(begin, end, out, init, std::plus<T>());
+  }
+  template <typename InputIt, typename OutputIt, typename T,
+            typename BinaryOp>
+  static T ExclusiveScan(InputIt begin, InputIt end, OutputIt out, T init,
+                         BinaryOp op)
+  {
+    return vtkSMPTools::RangeScan<T>(
+      vtk::detail::smp::vtkSMPTools_IteratorRange<InputIt>(begin),
+      vtk::detail::smp::vtkSMPTools_IteratorRange<OutputIt>(out),
+      static_cast<vtkIdType>(end - begin), &init, op, false);
+  }
+
+  // Description:
+  // Apply an operation to the items of a random access iterator range, or
+  // to the pairs of items of two ranges, in parallel and store the results
+  // in the output range: out[i] = op(in[i]) or op(in1[i], in2[i]).
+  template <typename InputIt, typename OutputIt, typename UnaryOp>
+  static void Transform(InputIt begin, InputIt end, OutputIt out, UnaryOp op)
+  {
+    vtk::detail::smp::vtkSMPTools_TransformFunctor<
+      vtk::detail::smp::vtkSMPTools_IteratorRange<InputIt>,
+      vtk::detail::smp::vtkSMPTools_IteratorRange<OutputIt>, UnaryOp>
+      transform(begin, out, op);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(end - begin), transform);
+  }
+  template <typename InputIt1, typename InputIt2, typename OutputIt,
+            typename BinaryOp>
+  static void Transform(InputIt1 begin1, InputIt1 end1, InputIt2 begin2,
+                        OutputIt out, BinaryOp op)
+  {
+    vtk::detail::smp::vtkSMPTools_BinaryTransformFunctor<
+      vtk::detail::smp::vtkSMPTools_IteratorRange<InputIt1>,
+      vtk::detail::smp::vtkSMPTools_IteratorRange<InputIt2>,
+      vtk::detail::smp::vtkSMPTools_IteratorRange<OutputIt>, BinaryOp>
+      transform(begin1, begin2, out, op);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(end1 - begin1), transform);
+  }
+
+  // Description:
+  // Assign a value to the items of a random access iterator range in
+  // parallel.
+  template <typename Iterator, typename T>
+  static void Fill(Iterator begin, Iterator end, const T& value)
+  {
+    vtk::detail::smp::vtkSMPTools_FillFunctor<
+      vtk::detail::smp::vtkSMPTools_IteratorRange<Iterator>, T>
+      fill(begin, value);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(end - begin), fill);
+  }
+
   // Description:
   // A convenience method for sorting data. It is a drop in replacement for
   // std::sort(). Under the hood different methods are used. For example,
-  // tbb::parallel_sort is used in TBB.
+  // tbb::parallel_sort is used in TBB, and a merge sort of chunks sorted
+  // concurrently in STDThread (and Runtime).
   template<typename RandomAccessIterator>
     static void Sort(RandomAccessIterator begin, RandomAccessIterator end)
   {
@@ -234,6 +602,82 @@ public:
     vtk::detail::smp::vtkSMPTools_Impl_Sort(begin,end,comp);
   }
 
+private:
+  friend class vtkSMPArrayTools;
+
+  // Run the functor over the blocks in parallel, or serially on the calling
+  // thread, in which case the results are the same.
+  template <typename Functor>
+  static void ForBlocks(vtkIdType numBlocks, Functor& f, bool parallel)
+  {
+    if (parallel)
+      {
+      vtkSMPTools::For(0, numBlocks, 1, f);
+      }
+    else
+      {
+      f(0, numBlocks);
+      }
+  }
+
+  template <typename Range, typename T, typename BinaryOp>
+  static T RangeReduce(Range in, vtkIdType size, T init, BinaryOp op,
+                       bool parallel = true)
+  {
+    if (size <= 0)
+      {
+      return init;
+      }
+    vtkIdType blockSize = vtk::detail::smp::vtkSMPTools_BlockSize(size);
+    vtkIdType numBlocks = (size + blockSize - 1) / blockSize;
+    std::vector<T> results(numBlocks);
+    vtk::detail::smp::vtkSMPTools_ReduceBlocks<T, Range, BinaryOp>
+      reduce(in, op, size, blockSize, &results[0]);
+    vtkSMPTools::ForBlocks(numBlocks, reduce, parallel);
+    T value = init;
+    for (vtkIdType block = 0; block < numBlocks; ++block)
+      {
+      value = op(value, results[block]);
+      }
+    return value;
+  }
+
+  // Scan in two passes: the sums of the blocks, then the scans of the blocks
+  // starting from the sums of the previous blocks.
+  template <typename T, typename InRange, typename OutRange, typename BinaryOp>
+  static T RangeScan(InRange in, OutRange out, vtkIdType size, const T* init,
+                     BinaryOp op, bool inclusive, bool parallel = true)
+  {
+    if (size <= 0)
+      {
+      return init ? *init : T();
+      }
+    vtkIdType blockSize = vtk::detail::smp::vtkSMPTools_BlockSize(size);
+    vtkIdType numBlocks = (size + blockSize - 1) / blockSize;
+    std::vector<T> sums(numBlocks);
+    vtk::detail::smp::vtkSMPTools_ReduceBlocks<T, InRange, BinaryOp>
+      reduce(in, op, size, blockSize, &sums[0]);
+    vtkSMPTools::ForBlocks(numBlocks, reduce, parallel);
+
+    std::vector<T> starts(numBlocks);
+    T value = sums[0];
+    if (init)
+      {
+      starts[0] = *init;
+      value = op(*init, sums[0]);
+      }
+    for (vtkIdType block = 1; block < numBlocks; ++block)
+      {
+      starts[block] = value;
+      value = op(value, sums[block]);
+      }
+
+    vtk::detail::smp::vtkSMPTools_ScanBlocks<T, InRange, OutRange, BinaryOp>
+      scan(in, out, op, size, blockSize, &starts[0], inclusive, init != NULL);
+    vtkSMPTools::ForBlocks(numBlocks, scan, parallel);
+    return value;
+  }
+
 };
 
 #endif
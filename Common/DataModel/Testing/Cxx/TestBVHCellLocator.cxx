@@ -0,0 +1,393 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestBVHCellLocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check the queries of vtkBVHCellLocator against brute force searches over
+// all the cells, and its batched queries against the single ones, on a
+// triangulated sphere (with cells stored as vtkIdType or as 32-bit ids), a
+// hexahedral unstructured grid and an image.
+
+#include "vtkBVHCellLocator.h"
+#include "vtkCellArray.h"
+#include "vtkCellType.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+const double Tolerance = 1.0e-9;
+
+bool Same(double a, double b)
+{
+  return fabs(a - b) <= Tolerance * (1.0 + fabs(a));
+}
+
+bool SamePoints(const double a[3], const double b[3])
+{
+  return Same(a[0], b[0]) && Same(a[1], b[1]) && Same(a[2], b[2]);
+}
+
+void RandomPoint(const double bounds[6], double x[3])
+{
+  for (int i = 0; i < 3; ++i)
+    {
+    double margin = 0.25 * (bounds[2*i+1] - bounds[2*i]);
+    x[i] = vtkMath::Random(bounds[2*i] - margin, bounds[2*i+1] + margin);
+    }
+}
+
+// A triangulated sphere of 6400 triangles.
+vtkSmartPointer<vtkPolyData> CreateSphere()
+{
+  const int numTheta = 80, numPhi = 41;
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+  points->InsertNextPoint(0.0, 0.0, 1.0);
+  for (int j = 1; j < numPhi - 1; ++j)
+    {
+    double phi = vtkMath::Pi() * j / (numPhi - 1);
+    for (int i = 0; i < numTheta; ++i)
+      {
+      double theta = 2.0 * vtkMath::Pi() * i / numTheta;
+      points->InsertNextPoint(sin(phi) * cos(theta), sin(phi) * sin(theta),
+                              cos(phi));
+      }
+    }
+  points->InsertNextPoint(0.0, 0.0, -1.0);
+  vtkIdType south = points->GetNumberOfPoints() - 1;
+
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  for (int i = 0; i < numTheta; ++i)
+    {
+    int next = (i + 1) % numTheta;
+    vtkIdType top[3] = { 0, 1 + i, 1 + next };
+    vtkIdType bottom[3] = { south, south - numTheta + next,
+                            south - numTheta + i };
+    polys->InsertNextCell(3, top);
+    polys->InsertNextCell(3, bottom);
+    for (int j = 0; j < numPhi - 3; ++j)
+      {
+      vtkIdType a = 1 + j * numTheta + i, b = 1 + j * numTheta + next;
+      vtkIdType tri1[3] = { a, a + numTheta, b + numTheta };
+      vtkIdType tri2[3] = { a, b + numTheta, b };
+      polys->InsertNextCell(3, tri1);
+      polys->InsertNextCell(3, tri2);
+      }
+    }
+  vtkSmartPointer<vtkPolyData> sphere = vtkSmartPointer<vtkPolyData>::New();
+  sphere->SetPoints(points);
+  sphere->SetPolys(polys);
+  return sphere;
+}
+
+// 18x18x18 distorted hexahedra.
+vtkSmartPointer<vtkUnstructuredGrid> CreateHexahedra()
+{
+  const int n = 19;
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+  for (int k = 0; k < n; ++k)
+    {
+    for (int j = 0; j < n; ++j)
+      {
+      for (int i = 0; i < n; ++i)
+        {
+        points->InsertNextPoint(0.1 * i + 0.02 * sin(1.3 * j + 0.7 * k),
+                                0.1 * j + 0.02 * cos(0.9 * i + 1.1 * k),
+                                0.1 * k + 0.002 * i * j);
+        }
+      }
+    }
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(points);
+  grid->Allocate((n - 1) * (n - 1) * (n - 1));
+  for (int k = 0; k < n - 1; ++k)
+    {
+    for (int j = 0; j < n - 1; ++j)
+      {
+      for (int i = 0; i < n - 1; ++i)
+        {
+        vtkIdType p = i + n * (j + n * k);
+        vtkIdType hex[8] = { p, p + 1, p + n + 1, p + n,
+                             p + n * n, p + n * n + 1, p + n * n + n + 1,
+                             p + n * n + n };
+        grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+        }
+      }
+    }
+  return grid;
+}
+
+// Compare the queries of the locator with brute force searches.
+bool CheckQueries(vtkDataSet *dataSet, bool volumetric, const char *name)
+{
+  vtkSmartPointer<vtkBVHCellLocator> locator =
+    vtkSmartPointer<vtkBVHCellLocator>::New();
+  locator->SetDataSet(dataSet);
+  locator->BuildLocator();
+  if (locator->GetNumberOfNodes() < 2)
+    {
+    cerr << "No hierarchy for the " << name << endl;
+    return false;
+    }
+  vtkSmartPointer<vtkPolyData> representation =
+    vtkSmartPointer<vtkPolyData>::New();
+  locator->GenerateRepresentation(3, representation);
+  if (representation->GetNumberOfPolys() != 6 * 8)
+    {
+    cerr << "Wrong representation of the " << name << endl;
+    return false;
+    }
+
+  vtkSmartPointer<vtkGenericCell> cell = vtkSmartPointer<vtkGenericCell>::New();
+  vtkSmartPointer<vtkIdList> ids = vtkSmartPointer<vtkIdList>::New();
+  vtkSmartPointer<vtkPoints> hits = vtkSmartPointer<vtkPoints>::New();
+  hits->SetDataTypeToDouble();
+  double bounds[6], cellBounds[6];
+  dataSet->GetBounds(bounds);
+  vtkIdType numCells = dataSet->GetNumberOfCells();
+  double t, x[3], pcoords[3], dist2, closest[3];
+  double weights[VTK_CELL_SIZE];
+  int subId, inside;
+  vtkIdType cellId;
+
+  vtkMath::RandomSeed(8775070);
+  vtkSmartPointer<vtkPoints> starts = vtkSmartPointer<vtkPoints>::New();
+  starts->SetDataTypeToDouble();
+  vtkSmartPointer<vtkPoints> ends = vtkSmartPointer<vtkPoints>::New();
+  ends->SetDataTypeToDouble();
+  for (int q = 0; q < 100; ++q)
+    {
+    double a0[3], a1[3];
+    RandomPoint(bounds, a0);
+    RandomPoint(bounds, a1);
+    starts->InsertNextPoint(a0);
+    ends->InsertNextPoint(a1);
+
+    // First intersection, and all the intersections, along a line.
+    double bestT = VTK_DOUBLE_MAX, bestX[3] = { 0.0, 0.0, 0.0 };
+    vtkIdType numHits = 0;
+    for (vtkIdType c = 0; c < numCells; ++c)
+      {
+      dataSet->GetCell(c, cell);
+      if (cell->IntersectWithLine(a0, a1, 0.0, t, x, pcoords, subId))
+        {
+        ++numHits;
+        if (t < bestT)
+          {
+          bestT = t;
+          bestX[0] = x[0];
+          bestX[1] = x[1];
+          bestX[2] = x[2];
+          }
+        }
+      }
+    int hit = locator->IntersectWithLine(a0, a1, 0.0, t, x, pcoords, subId,
+                                         cellId, cell);
+    if (hit != (numHits > 0) ||
+        (hit && (!Same(t, bestT) || !SamePoints(x, bestX))))
+      {
+      cerr << "Wrong intersection " << q << " with the " << name << endl;
+      return false;
+      }
+    locator->IntersectWithLine(a0, a1, hits, ids);
+    if (ids->GetNumberOfIds() != numHits ||
+        hits->GetNumberOfPoints() != numHits ||
+        (numHits > 0 && !SamePoints(hits->GetPoint(0), bestX)))
+      {
+      cerr << "Wrong intersections " << q << " with the " << name << endl;
+      return false;
+      }
+
+    // Closest point, within a radius or not.
+    double bestDist2 = VTK_DOUBLE_MAX;
+    for (vtkIdType c = 0; c < numCells; ++c)
+      {
+      dataSet->GetCell(c, cell);
+      if (cell->EvaluatePosition(a0, x, subId, pcoords, dist2, weights) != -1)
+        {
+        bestDist2 = std::min(bestDist2, dist2);
+        }
+      }
+    locator->FindClosestPoint(a0, closest, cell, cellId, subId, dist2);
+    if (cellId < 0 || !Same(dist2, bestDist2) ||
+        !Same(vtkMath::Distance2BetweenPoints(a0, closest), dist2))
+      {
+      cerr << "Wrong closest point " << q << " to the " << name << endl;
+      return false;
+      }
+    double radius = 0.2;
+    int found = locator->FindClosestPointWithinRadius(
+      a0, radius, closest, cell, cellId, subId, dist2, inside);
+    if (found != (bestDist2 < radius * radius) ||
+        (found && !Same(dist2, bestDist2)))
+      {
+      cerr << "Wrong closest point " << q << " within a radius of the "
+           << name << endl;
+      return false;
+      }
+
+    // Cell containing a point.
+    if (volumetric)
+      {
+      vtkIdType containing = -1;
+      for (vtkIdType c = 0; c < numCells && containing < 0; ++c)
+        {
+        dataSet->GetCell(c, cell);
+        if (cell->EvaluatePosition(a0, x, subId, pcoords, dist2, weights) == 1)
+          {
+          containing = c;
+          }
+        }
+      cellId = locator->FindCell(a0, 0.0, cell, pcoords, weights);
+      if ((cellId < 0) != (containing < 0) ||
+          (cellId >= 0 &&
+           cell->EvaluatePosition(a0, x, subId, pcoords, dist2, weights) != 1))
+        {
+        cerr << "Wrong cell containing point " << q << " of the " << name
+             << endl;
+        return false;
+        }
+      }
+
+    // Cells within a box.
+    double box[6];
+    for (int i = 0; i < 3; ++i)
+      {
+      box[2*i] = std::min(a0[i], a1[i]);
+      box[2*i+1] = box[2*i] + 0.1 * fabs(a1[i] - a0[i]);
+      }
+    std::vector<vtkIdType> expected;
+    for (vtkIdType c = 0; c < numCells; ++c)
+      {
+      dataSet->GetCellBounds(c, cellBounds);
+      if (cellBounds[0] <= box[1] && box[0] <= cellBounds[1] &&
+          cellBounds[2] <= box[3] && box[2] <= cellBounds[3] &&
+          cellBounds[4] <= box[5] && box[4] <= cellBounds[5])
+        {
+        expected.push_back(c);
+        }
+      }
+    locator->FindCellsWithinBounds(box, ids);
+    std::vector<vtkIdType> within(ids->GetPointer(0),
+                                  ids->GetPointer(0) + ids->GetNumberOfIds());
+    std::sort(within.begin(), within.end());
+    if (within != expected)
+      {
+      cerr << "Wrong cells within box " << q << " of the " << name << endl;
+      return false;
+      }
+    }
+
+  // The batched queries give the results of the single ones.
+  vtkSmartPointer<vtkIdList> cellIds = vtkSmartPointer<vtkIdList>::New();
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+  locator->IntersectWithLines(starts, ends, 1.0e-6, cellIds, points);
+  vtkSmartPointer<vtkIdList> closestIds = vtkSmartPointer<vtkIdList>::New();
+  vtkSmartPointer<vtkPoints> closestPoints = vtkSmartPointer<vtkPoints>::New();
+  closestPoints->SetDataTypeToDouble();
+  vtkSmartPointer<vtkDoubleArray> distances2 =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  locator->FindClosestPoints(starts, closestIds, closestPoints, distances2);
+  for (vtkIdType q = 0; q < starts->GetNumberOfPoints(); ++q)
+    {
+    double a0[3], a1[3];
+    starts->GetPoint(q, a0);
+    ends->GetPoint(q, a1);
+    if (!locator->IntersectWithLine(a0, a1, 1.0e-6, t, x, pcoords, subId,
+                                    cellId, cell))
+      {
+      cellId = -1;
+      ends->GetPoint(q, x);
+      }
+    if (cellIds->GetId(q) != cellId || !SamePoints(points->GetPoint(q), x))
+      {
+      cerr << "Wrong batched intersection " << q << " with the " << name
+           << endl;
+      return false;
+      }
+    locator->FindClosestPoint(a0, closest, cell, cellId, subId, dist2);
+    if (closestIds->GetId(q) != cellId ||
+        !SamePoints(closestPoints->GetPoint(q), closest) ||
+        distances2->GetValue(q) != dist2)
+      {
+      cerr << "Wrong batched closest point " << q << " to the " << name
+           << endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int TestBVHCellLocator(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+
+  vtkSmartPointer<vtkPolyData> sphere = CreateSphere();
+  vtkSmartPointer<vtkUnstructuredGrid> hexahedra = CreateHexahedra();
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(-3, 14, 0, 11, 2, 20);
+  image->SetSpacing(0.2, 0.3, 0.25);
+
+  if (!CheckQueries(sphere, false, "sphere") ||
+      !CheckQueries(hexahedra, true, "hexahedra") ||
+      !CheckQueries(image, true, "image"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Cells stored as 32-bit ids are accessed from several threads as well.
+  vtkSmartPointer<vtkPolyData> sphere32 = CreateSphere();
+  if (!sphere32->GetPolys()->ConvertTo32BitStorage(
+        sphere32->GetNumberOfPoints()) ||
+      !CheckQueries(sphere32, false, "sphere with 32-bit cells"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Without cells, nothing is found.
+  vtkSmartPointer<vtkPolyData> empty = vtkSmartPointer<vtkPolyData>::New();
+  empty->SetPoints(vtkSmartPointer<vtkPoints>::New());
+  vtkSmartPointer<vtkBVHCellLocator> locator =
+    vtkSmartPointer<vtkBVHCellLocator>::New();
+  locator->SetDataSet(empty);
+  locator->BuildLocator();
+  double a0[3] = { 0.0, 0.0, 0.0 }, a1[3] = { 1.0, 1.0, 1.0 };
+  double t, x[3], pcoords[3], dist2;
+  int subId;
+  vtkIdType cellId;
+  locator->FindClosestPoint(a0, x, cellId, subId, dist2);
+  if (locator->GetNumberOfNodes() != 0 || cellId != -1 ||
+      locator->IntersectWithLine(a0, a1, 0.0, t, x, pcoords, subId))
+    {
+    cerr << "Cells found without cells" << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
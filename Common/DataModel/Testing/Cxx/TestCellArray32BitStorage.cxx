@@ -0,0 +1,312 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellArray32BitStorage.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Test the 32-bit storage of vtkCellArray and vtkStaticCellLinks.
+
+#include "vtkCellArray.h"
+#include "vtkCellType.h"
+#include "vtkIdList.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticCellLinks.h"
+#include "vtkTypeInt32Array.h"
+#include "vtkUnstructuredGrid.h"
+
+#define TEST_ASSERT(cond, msg) \
+  if (!(cond)) \
+    { \
+    cerr << "Failure at line " << __LINE__ << ": " << msg << endl; \
+    return EXIT_FAILURE; \
+    }
+
+namespace
+{
+// Cell i is a triangle or a quad using the points i, i+1, ...
+vtkIdType CellSize(vtkIdType cellId)
+{
+  return 3 + (cellId % 2);
+}
+
+int CheckCells(vtkCellArray *ca, vtkIdType numCells)
+{
+  TEST_ASSERT(ca->GetNumberOfCells() == numCells, "wrong number of cells");
+
+  vtkIdType npts, *pts, cellId;
+  for (cellId=0, ca->InitTraversal(); ca->GetNextCell(npts,pts); ++cellId)
+    {
+    TEST_ASSERT(npts == CellSize(cellId), "wrong traversal cell size");
+    for (vtkIdType i=0; i < npts; ++i)
+      {
+      TEST_ASSERT(pts[i] == cellId + i, "wrong traversal point id");
+      }
+    }
+  TEST_ASSERT(cellId == numCells, "wrong number of traversed cells");
+
+  vtkSmartPointer<vtkIdList> ids = vtkSmartPointer<vtkIdList>::New();
+  for (cellId=0; cellId < numCells; ++cellId)
+    {
+    ca->GetCellAtId(cellId, ids);
+    npts = ids->GetNumberOfIds();
+    TEST_ASSERT(npts == CellSize(cellId) &&
+                ca->GetCellSize(cellId) == CellSize(cellId) &&
+                ids->GetId(npts-1) == cellId + npts - 1,
+                "wrong random access cell");
+    }
+
+  for (cellId=0; cellId < numCells; ++cellId)
+    {
+    const vtkIdType *legacy = ca->GetLegacyCell(cellId);
+    TEST_ASSERT(legacy[0] == CellSize(cellId) && legacy[1] == cellId,
+                "wrong legacy cell");
+    }
+  TEST_ASSERT(ca->GetMaxCellSize() == 4, "wrong max cell size");
+  TEST_ASSERT(ca->GetStorageLayout() == vtkCellArray::OFFSETS_LAYOUT,
+              "layout changed by the accessors");
+
+  return EXIT_SUCCESS;
+}
+
+// Check the cells through the pointer versions from several threads.
+struct CheckCellPointers
+{
+  vtkCellArray *Cells;
+  int Failed;
+
+  CheckCellPointers(vtkCellArray *cells) : Cells(cells), Failed(0) {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdType npts, *pts;
+    for (vtkIdType cellId=begin; cellId < end; ++cellId)
+      {
+      this->Cells->GetCellAtId(cellId, npts, pts);
+      if (npts != CellSize(cellId))
+        {
+        this->Failed = 1;
+        continue;
+        }
+      for (vtkIdType i=0; i < npts; ++i)
+        {
+        if (pts[i] != cellId + i)
+          {
+          this->Failed = 1;
+          }
+        }
+      }
+  }
+};
+}
+
+int TestCellArray32BitStorage(int, char *[])
+{
+  const vtkIdType numCells = 1000;
+  const vtkIdType numPts = numCells + 3;
+  vtkIdType cellId, i;
+  vtkIdType pts[4];
+
+  // Conversion of existing cells
+  vtkSmartPointer<vtkCellArray> ca = vtkSmartPointer<vtkCellArray>::New();
+  for (cellId=0; cellId < numCells; ++cellId)
+    {
+    for (i=0; i < CellSize(cellId); ++i)
+      {
+      pts[i] = cellId + i;
+      }
+    ca->InsertNextCell(CellSize(cellId), pts);
+    }
+  TEST_ASSERT(ca->CanConvertTo32BitStorage(numPts), "cannot convert");
+  if (sizeof(vtkIdType) > sizeof(vtkTypeInt32))
+    {
+    TEST_ASSERT(!ca->CanConvertTo32BitStorage(VTK_ID_MAX), "can convert");
+    TEST_ASSERT(!ca->ConvertTo32BitStorage(VTK_ID_MAX), "converted");
+    TEST_ASSERT(ca->GetStorageLayout() == vtkCellArray::LEGACY_LAYOUT,
+                "layout changed by a failed conversion");
+    }
+  TEST_ASSERT(ca->ConvertTo32BitStorage(numPts), "conversion failed");
+  TEST_ASSERT(ca->GetStorageLayout() == vtkCellArray::OFFSETS_LAYOUT,
+              "32-bit storage requires the offsets layout");
+  if (sizeof(vtkIdType) > sizeof(vtkTypeInt32))
+    {
+    TEST_ASSERT(ca->IsStorage32Bit() &&
+                vtkArrayDownCast<vtkTypeInt32Array>(ca->GetOffsetsArray()) &&
+                vtkArrayDownCast<vtkTypeInt32Array>(
+                  ca->GetConnectivityArray()), "not stored as 32-bit");
+    }
+  TEST_ASSERT(CheckCells(ca, numCells) == EXIT_SUCCESS, "32-bit storage");
+
+  // Insertion, modification and copy with 32-bit storage
+  pts[0] = 0; pts[1] = 1; pts[2] = 2;
+  TEST_ASSERT(ca->InsertNextCell(3, pts) == numCells, "wrong cell id");
+  ca->InsertNextCell(4);
+  for (i=0; i < 3; ++i)
+    {
+    ca->InsertCellPoint(5 + i);
+    }
+  ca->UpdateCellCount(3);
+  vtkIdType npts, *cellPts;
+  ca->GetCellAtId(numCells+1, npts, cellPts);
+  TEST_ASSERT(npts == 3 && cellPts[2] == 7, "wrong inserted cell");
+  ca->ReverseCell(numCells+1);
+  pts[0] = 9;
+  ca->ReplaceCell(numCells, 3, pts);
+  ca->GetCellAtId(numCells+1, npts, cellPts);
+  TEST_ASSERT(cellPts[0] == 7 && cellPts[2] == 5, "wrong reversed cell");
+  ca->GetCellAtId(numCells, npts, cellPts);
+  TEST_ASSERT(cellPts[0] == 9 && cellPts[1] == 1, "wrong replaced cell");
+
+  vtkSmartPointer<vtkCellArray> copy = vtkSmartPointer<vtkCellArray>::New();
+  copy->DeepCopy(ca);
+  TEST_ASSERT(copy->IsStorage32Bit() == ca->IsStorage32Bit(),
+              "deep copy lost the storage type");
+  TEST_ASSERT(copy->GetNumberOfCells() == numCells+2, "wrong copy");
+
+  // Cells which do not fit convert back to vtkIdType storage
+  if (sizeof(vtkIdType) > sizeof(vtkTypeInt32))
+    {
+    pts[0] = 1; pts[1] = VTK_INT_MAX;
+    ++pts[1];
+    copy->InsertNextCell(2, pts);
+    TEST_ASSERT(!copy->IsStorage32Bit(), "large id stored as 32-bit");
+    copy->GetCellAtId(numCells+2, npts, cellPts);
+    TEST_ASSERT(npts == 2 && cellPts[1] == pts[1], "large id truncated");
+    copy->DeepCopy(ca);
+    copy->InsertNextCell(2);
+    copy->InsertCellPoint(1);
+    copy->InsertCellPoint(pts[1]);
+    TEST_ASSERT(!copy->IsStorage32Bit(), "large point stored as 32-bit");
+    copy->GetCellAtId(numCells+2, npts, cellPts);
+    TEST_ASSERT(npts == 2 && cellPts[1] == pts[1], "large point truncated");
+    }
+
+  ca->ConvertToIdTypeStorage();
+  TEST_ASSERT(!ca->IsStorage32Bit() &&
+              vtkArrayDownCast<vtkIdTypeArray>(ca->GetOffsetsArray()),
+              "not stored as vtkIdType");
+  ca->GetCellAtId(numCells, npts, cellPts);
+  TEST_ASSERT(cellPts[0] == 9, "wrong cell after conversion");
+
+  // Cells provided as 32-bit arrays
+  vtkSmartPointer<vtkTypeInt32Array> offsets =
+    vtkSmartPointer<vtkTypeInt32Array>::New();
+  vtkSmartPointer<vtkTypeInt32Array> conn =
+    vtkSmartPointer<vtkTypeInt32Array>::New();
+  offsets->InsertNextValue(0);
+  for (cellId=0; cellId < numCells; ++cellId)
+    {
+    for (i=0; i < CellSize(cellId); ++i)
+      {
+      conn->InsertNextValue(static_cast<vtkTypeInt32>(cellId + i));
+      }
+    offsets->InsertNextValue(conn->GetNumberOfTuples());
+    }
+  vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+  cells->SetData(offsets, conn);
+  TEST_ASSERT(cells->IsStorage32Bit(), "32-bit arrays not used");
+  TEST_ASSERT(CheckCells(cells, numCells) == EXIT_SUCCESS, "32-bit arrays");
+  CheckCellPointers check(cells);
+  vtkSMPTools::For(0, numCells, 10, check);
+  TEST_ASSERT(!check.Failed, "wrong cells read from several threads");
+
+  // Unstructured grid: selection of the storage by Squeeze(), and links
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  for (i=0; i < numPts; ++i)
+    {
+    points->InsertNextPoint(i, i % 2, 0.0);
+    }
+  vtkSmartPointer<vtkCellArray> ugCells = vtkSmartPointer<vtkCellArray>::New();
+  ugCells->SetStorageLayoutToOffsets();
+  int *types = new int[numCells];
+  for (cellId=0; cellId < numCells; ++cellId)
+    {
+    for (i=0; i < CellSize(cellId); ++i)
+      {
+      pts[i] = cellId + i;
+      }
+    ugCells->InsertNextCell(CellSize(cellId), pts);
+    types[cellId] = CellSize(cellId) == 3 ? VTK_TRIANGLE : VTK_QUAD;
+    }
+  vtkSmartPointer<vtkUnstructuredGrid> ug =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  ug->SetPoints(points);
+  ug->SetCells(types, ugCells);
+  delete [] types;
+  ug->Squeeze();
+  if (sizeof(vtkIdType) > sizeof(vtkTypeInt32))
+    {
+    TEST_ASSERT(ug->GetCells()->IsStorage32Bit(), "squeeze kept 64-bit ids");
+    }
+  vtkSmartPointer<vtkIdList> ids = vtkSmartPointer<vtkIdList>::New();
+  for (cellId=0; cellId < numCells; ++cellId)
+    {
+    ug->GetCellPoints(cellId, ids);
+    TEST_ASSERT(ids->GetNumberOfIds() == CellSize(cellId) &&
+                ids->GetId(0) == cellId, "wrong grid cell points");
+    }
+  TEST_ASSERT(ug->GetCell(3)->GetPointId(3) == 6, "wrong grid cell");
+  ug->GetPointCells(10, ids);
+  TEST_ASSERT(ids->GetNumberOfIds() == 4, "wrong grid point cells");
+
+  vtkSmartPointer<vtkStaticCellLinks> links =
+    vtkSmartPointer<vtkStaticCellLinks>::New();
+  links->BuildLinks(ug);
+  if (sizeof(vtkIdType) > sizeof(int))
+    {
+    TEST_ASSERT(links->IsStorage32Bit(), "links not stored as 32-bit");
+    }
+  TEST_ASSERT(links->GetNumberOfCells(10) == 4, "wrong number of links");
+  const vtkIdType *linkCells = links->GetCells(10);
+  for (i=0; i < 4; ++i)
+    {
+    TEST_ASSERT(linkCells[i] >= 7 && linkCells[i] <= 10, "wrong link");
+    }
+  links->GetCells(0, ids);
+  TEST_ASSERT(ids->GetNumberOfIds() == 1 && ids->GetId(0) == 0,
+              "wrong copied link");
+
+  // Polygonal data using several cell arrays and 32-bit storage
+  vtkSmartPointer<vtkCellArray> verts = vtkSmartPointer<vtkCellArray>::New();
+  pts[0] = 2;
+  verts->InsertNextCell(1, pts);
+  verts->ConvertTo32BitStorage(numPts);
+  vtkSmartPointer<vtkPolyData> pd = vtkSmartPointer<vtkPolyData>::New();
+  pd->SetPoints(points);
+  pd->SetVerts(verts);
+  pd->SetPolys(cells);
+  pd->BuildCells();
+  pd->GetCellPoints(numCells, npts, cellPts);
+  TEST_ASSERT(pd->GetCellType(numCells) == VTK_QUAD && npts == 4 &&
+              cellPts[0] == numCells-1, "wrong polydata cell");
+  links->BuildLinks(pd);
+  TEST_ASSERT(links->GetNumberOfCells(2) == 4, "wrong number of links");
+  links->GetCells(2, ids);
+  TEST_ASSERT(ids->IsId(0) >= 0 && ids->IsId(1) >= 0 && ids->IsId(3) >= 0,
+              "wrong polydata links");
+  links->GetCells(numPts-1, ids);
+  TEST_ASSERT(ids->GetNumberOfIds() == 1 && ids->GetId(0) == numCells,
+              "wrong polydata last link");
+
+  // Point replacement writes into the 32-bit storage
+  pd->ReplaceCellPoint(numCells, numCells-1, 0);
+  pd->GetCellPoints(numCells, ids);
+  TEST_ASSERT(ids->GetNumberOfIds() == 4 && ids->GetId(0) == 0 &&
+              ids->GetId(1) == numCells, "point not replaced");
+  pd->ReplaceCellPoint(0, 2, 1);
+  pd->GetCellPoints(0, ids);
+  TEST_ASSERT(ids->GetNumberOfIds() == 1 && ids->GetId(0) == 1,
+              "vertex point not replaced");
+
+  return EXIT_SUCCESS;
+}
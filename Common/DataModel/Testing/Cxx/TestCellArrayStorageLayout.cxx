@@ -0,0 +1,321 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellArrayStorageLayout.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Test the offsets storage layout of vtkCellArray and its use by
+// vtkUnstructuredGrid and vtkPolyData.
+
+#include "vtkCellArray.h"
+#include "vtkCellType.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#define TEST_ASSERT(cond, msg) \
+  if (!(cond)) \
+    { \
+    cerr << "Failure at line " << __LINE__ << ": " << msg << endl; \
+    return EXIT_FAILURE; \
+    }
+
+namespace
+{
+// Cell i has (i%4)+1 points: i, i+1, ...
+vtkIdType CellSize(vtkIdType cellId)
+{
+  return (cellId % 4) + 1;
+}
+
+// Fill disjoint ranges of cells from several threads once the offsets are
+// known.
+class FillCells
+{
+public:
+  const vtkIdType *Offsets;
+  vtkIdType *Connectivity;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType cellId=begin; cellId < end; ++cellId)
+      {
+      vtkIdType *pts = this->Connectivity + this->Offsets[cellId];
+      for (vtkIdType i=0; i < CellSize(cellId); ++i)
+        {
+        pts[i] = cellId + i;
+        }
+      }
+  }
+};
+
+int CheckCells(vtkCellArray *ca, vtkIdType numCells)
+{
+  TEST_ASSERT(ca->GetNumberOfCells() == numCells, "wrong number of cells");
+
+  vtkIdType npts, *pts, cellId;
+  for (cellId=0, ca->InitTraversal(); ca->GetNextCell(npts,pts); ++cellId)
+    {
+    TEST_ASSERT(npts == CellSize(cellId), "wrong traversal cell size");
+    for (vtkIdType i=0; i < npts; ++i)
+      {
+      TEST_ASSERT(pts[i] == cellId + i, "wrong traversal point id");
+      }
+    }
+  TEST_ASSERT(cellId == numCells, "wrong number of traversed cells");
+
+  vtkSmartPointer<vtkIdList> ids = vtkSmartPointer<vtkIdList>::New();
+  for (cellId=0; cellId < numCells; ++cellId)
+    {
+    ca->GetCellAtId(cellId, ids);
+    TEST_ASSERT(ids->GetNumberOfIds() == CellSize(cellId) &&
+                ca->GetCellSize(cellId) == CellSize(cellId),
+                "wrong random access cell size");
+    TEST_ASSERT(ids->GetId(0) == cellId, "wrong random access point id");
+    }
+
+  // The legacy view of the cells is always available
+  vtkIdType expectedEntries = 0;
+  for (cellId=0; cellId < numCells; ++cellId)
+    {
+    expectedEntries += CellSize(cellId) + 1;
+    }
+  TEST_ASSERT(ca->GetNumberOfConnectivityEntries() == expectedEntries,
+              "wrong number of connectivity entries");
+  int layout = ca->GetStorageLayout();
+  vtkIdType loc = 0;
+  for (cellId=0; cellId < numCells; ++cellId)
+    {
+    const vtkIdType *legacy = ca->GetLegacyCell(
+      layout == vtkCellArray::OFFSETS_LAYOUT ? cellId : loc);
+    TEST_ASSERT(*legacy == CellSize(cellId) && legacy[1] == cellId,
+                "wrong legacy cell");
+    loc += *legacy + 1;
+    }
+  TEST_ASSERT(ca->GetMaxCellSize() == 4, "wrong max cell size");
+  TEST_ASSERT(ca->GetStorageLayout() == layout,
+              "layout changed by the accessors");
+
+  return EXIT_SUCCESS;
+}
+}
+
+int TestCellArrayStorageLayout(int, char *[])
+{
+  const vtkIdType numCells = 1000;
+  vtkIdType cellId, i;
+  vtkIdType pts[4];
+
+  // Insertion in the legacy layout, then conversion back and forth.
+  vtkSmartPointer<vtkCellArray> ca = vtkSmartPointer<vtkCellArray>::New();
+  for (cellId=0; cellId < numCells; ++cellId)
+    {
+    for (i=0; i < CellSize(cellId); ++i)
+      {
+      pts[i] = cellId + i;
+      }
+    ca->InsertNextCell(CellSize(cellId), pts);
+    }
+  TEST_ASSERT(CheckCells(ca, numCells) == EXIT_SUCCESS, "legacy layout");
+  ca->SetStorageLayoutToOffsets();
+  TEST_ASSERT(ca->GetStorageLayout() == vtkCellArray::OFFSETS_LAYOUT,
+              "layout not changed");
+  TEST_ASSERT(ca->GetOffsetsArray()->GetNumberOfTuples() == numCells+1,
+              "wrong offsets size");
+  TEST_ASSERT(CheckCells(ca, numCells) == EXIT_SUCCESS, "converted layout");
+  ca->SetStorageLayoutToLegacy();
+  TEST_ASSERT(ca->GetOffsetsArray() == NULL, "offsets not released");
+  TEST_ASSERT(CheckCells(ca, numCells) == EXIT_SUCCESS, "round trip");
+
+  // Insertion in the offsets layout through all insertion methods.
+  vtkSmartPointer<vtkCellArray> oca = vtkSmartPointer<vtkCellArray>::New();
+  oca->SetStorageLayoutToOffsets();
+  oca->Allocate(oca->EstimateSize(numCells, 4));
+  vtkSmartPointer<vtkIdList> ids = vtkSmartPointer<vtkIdList>::New();
+  for (cellId=0; cellId < numCells; ++cellId)
+    {
+    vtkIdType npts = CellSize(cellId);
+    switch (cellId % 3)
+      {
+      case 0:
+        for (i=0; i < npts; ++i)
+          {
+          pts[i] = cellId + i;
+          }
+        TEST_ASSERT(oca->InsertNextCell(npts, pts) == cellId,
+                    "wrong inserted cell id");
+        break;
+      case 1:
+        ids->SetNumberOfIds(npts);
+        for (i=0; i < npts; ++i)
+          {
+          ids->SetId(i, cellId + i);
+          }
+        oca->InsertNextCell(ids);
+        break;
+      default:
+        // over-estimate the size and fix it afterwards
+        oca->InsertNextCell(5);
+        for (i=0; i < npts; ++i)
+          {
+          oca->InsertCellPoint(cellId + i);
+          }
+        oca->UpdateCellCount(npts);
+      }
+    TEST_ASSERT(oca->GetInsertLocation(npts) == cellId,
+                "wrong insert location");
+    }
+  TEST_ASSERT(CheckCells(oca, numCells) == EXIT_SUCCESS, "offsets insertion");
+
+  // Deep copy preserves the layout
+  vtkSmartPointer<vtkCellArray> copy = vtkSmartPointer<vtkCellArray>::New();
+  copy->DeepCopy(oca);
+  TEST_ASSERT(copy->GetStorageLayout() == vtkCellArray::OFFSETS_LAYOUT,
+              "deep copy lost the layout");
+  TEST_ASSERT(CheckCells(copy, numCells) == EXIT_SUCCESS, "deep copy");
+
+  // The legacy list switches the cells back to the legacy layout
+  const vtkIdType *legacy = copy->GetPointer();
+  TEST_ASSERT(copy->GetStorageLayout() == vtkCellArray::LEGACY_LAYOUT,
+              "legacy list without the legacy layout");
+  for (cellId=0; cellId < numCells; ++cellId)
+    {
+    TEST_ASSERT(legacy[0] == CellSize(cellId) && legacy[1] == cellId,
+                "wrong legacy list");
+    legacy += *legacy + 1;
+    }
+  TEST_ASSERT(CheckCells(copy, numCells) == EXIT_SUCCESS, "legacy list");
+
+  // Exact allocation and concurrent filling after a single scan
+  vtkSmartPointer<vtkCellArray> pca = vtkSmartPointer<vtkCellArray>::New();
+  vtkIdType connSize = 0;
+  for (cellId=0; cellId < numCells; ++cellId)
+    {
+    connSize += CellSize(cellId);
+    }
+  pca->AllocateExact(numCells, connSize);
+  vtkIdType *offsets =
+    vtkArrayDownCast<vtkIdTypeArray>(pca->GetOffsetsArray())->GetPointer(0);
+  for (cellId=0; cellId < numCells; ++cellId)
+    {
+    offsets[cellId+1] = offsets[cellId] + CellSize(cellId);
+    }
+  FillCells fill;
+  fill.Offsets = offsets;
+  fill.Connectivity = vtkArrayDownCast<vtkIdTypeArray>(
+    pca->GetConnectivityArray())->GetPointer(0);
+  vtkSMPTools::For(0, numCells, fill);
+  TEST_ASSERT(CheckCells(pca, numCells) == EXIT_SUCCESS, "exact allocation");
+
+  // Unstructured grid without a location array
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  for (i=0; i < numCells+4; ++i)
+    {
+    points->InsertNextPoint(i, 0.0, 0.0);
+    }
+  int *types = new int[numCells];
+  for (cellId=0; cellId < numCells; ++cellId)
+    {
+    types[cellId] = CellSize(cellId) == 1 ? VTK_VERTEX : VTK_POLY_VERTEX;
+    }
+  vtkSmartPointer<vtkUnstructuredGrid> ug =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  ug->SetPoints(points);
+  ug->SetCells(types, pca);
+  delete [] types;
+  TEST_ASSERT(ug->GetNumberOfCells() == numCells, "wrong grid cell count");
+  for (cellId=0; cellId < numCells; ++cellId)
+    {
+    ug->GetCellPoints(cellId, ids);
+    TEST_ASSERT(ids->GetNumberOfIds() == CellSize(cellId) &&
+                ids->GetId(0) == cellId, "wrong grid cell points");
+    }
+  pts[0] = 0; pts[1] = 2; pts[2] = 4;
+  TEST_ASSERT(ug->InsertNextCell(VTK_TRIANGLE, 3, pts) == numCells,
+              "wrong inserted grid cell id");
+  TEST_ASSERT(ug->GetCell(numCells)->GetPointId(2) == 4,
+              "wrong inserted grid cell");
+  ug->GetPointCells(2, ids);
+  TEST_ASSERT(ids->GetNumberOfIds() == 3, "wrong point cells");
+  vtkIdTypeArray *locs = ug->GetCellLocationsArray();
+  legacy = ug->GetCells()->GetPointer();
+  TEST_ASSERT(legacy[locs->GetValue(numCells)] == 3 &&
+              legacy[locs->GetValue(numCells)+3] == 4,
+              "wrong legacy locations");
+
+  // The locations follow the layout of the cells
+  ug->GetCells()->SetStorageLayoutToOffsets();
+  TEST_ASSERT(ug->GetCell(numCells)->GetPointId(2) == 4,
+              "wrong grid cell after switching to the offsets layout");
+  pts[0] = 1;
+  TEST_ASSERT(ug->InsertNextCell(VTK_LINE, 2, pts) == numCells+1,
+              "wrong inserted grid cell id");
+  ug->GetCells()->SetStorageLayoutToLegacy();
+  TEST_ASSERT(ug->GetCell(numCells)->GetPointId(2) == 4 &&
+              ug->GetCell(numCells+1)->GetPointId(1) == 2,
+              "wrong grid cells after switching to the legacy layout");
+
+  // Polygonal data with offsets layout polygons
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  polys->SetStorageLayoutToOffsets();
+  pts[0] = 0; pts[1] = 1; pts[2] = 2; pts[3] = 3;
+  polys->InsertNextCell(3, pts);
+  polys->InsertNextCell(4, pts);
+  vtkSmartPointer<vtkPolyData> pd = vtkSmartPointer<vtkPolyData>::New();
+  pd->SetPoints(points);
+  pd->SetPolys(polys);
+  TEST_ASSERT(pd->GetCellType(0) == VTK_TRIANGLE &&
+              pd->GetCellType(1) == VTK_QUAD, "wrong polydata cell types");
+  vtkIdType npts, *cellPts;
+  pd->GetCellPoints(1, npts, cellPts);
+  TEST_ASSERT(npts == 4 && cellPts[3] == 3, "wrong polydata cell points");
+  pd->ReverseCell(1);
+  pd->GetCellPoints(1, npts, cellPts);
+  TEST_ASSERT(cellPts[0] == 3 && cellPts[3] == 0, "wrong reversed cell");
+
+  // The [npts pid1 .. pidn] access copies the cells of the offsets layout
+  vtkIdType *cell;
+  TEST_ASSERT(pd->GetCell(1, cell) == VTK_QUAD && cell[0] == 4 &&
+              cell[1] == 3 && cell[4] == 0, "wrong polydata cell");
+  TEST_ASSERT(polys->GetStorageLayout() == vtkCellArray::OFFSETS_LAYOUT,
+              "polygons switched to the legacy layout");
+
+  // The locations of the cells follow the layout of the cell arrays, also
+  // for the shallow copies sharing them
+  vtkSmartPointer<vtkPolyData> pdCopy = vtkSmartPointer<vtkPolyData>::New();
+  pdCopy->ShallowCopy(pd);
+  polys->GetData();
+  TEST_ASSERT(polys->GetStorageLayout() == vtkCellArray::LEGACY_LAYOUT,
+              "polygons kept the offsets layout");
+  TEST_ASSERT(pd->GetCell(1, cell) == VTK_QUAD && cell[0] == 4 &&
+              cell[1] == 3 && cell[4] == 0,
+              "wrong polydata cell after switching to the legacy layout");
+  cell[2] = 1;
+  pd->GetCellPoints(1, npts, cellPts);
+  TEST_ASSERT(npts == 4 && cellPts[1] == 1, "write through the cell lost");
+  pd->GetCellPoints(0, npts, cellPts);
+  TEST_ASSERT(npts == 3 && cellPts[2] == 2, "wrong first polydata cell");
+  pdCopy->GetCellPoints(1, npts, cellPts);
+  TEST_ASSERT(npts == 4 && cellPts[1] == 1, "wrong shallow copy cell");
+  polys->SetStorageLayoutToOffsets();
+  pd->GetCellPoints(1, npts, cellPts);
+  TEST_ASSERT(npts == 4 && cellPts[0] == 3 && cellPts[1] == 1,
+              "wrong polydata cell after switching to the offsets layout");
+  pdCopy->GetCellPoints(0, npts, cellPts);
+  TEST_ASSERT(npts == 3 && cellPts[2] == 2, "wrong shallow copy cell");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,213 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPointLocatorsSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check the batched queries of the point locators, run with several
+// threads, against their single queries and against brute force.
+
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkIncrementalOctreePointLocator.h"
+#include "vtkKdTreePointLocator.h"
+#include "vtkMath.h"
+#include "vtkOctreePointLocator.h"
+#include "vtkPointLocator.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticPointLocator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+bool SameDistances(double a, double b)
+{
+  return fabs(a - b) <= 1.0e-5 * (a + b) + 1.0e-12;
+}
+
+bool CheckLocator(vtkAbstractPointLocator *locator, vtkPolyData *data,
+                  vtkPoints *queries, const char *name)
+{
+  const int N = 6;
+  const double radius = 0.08;
+  locator->SetDataSet(data);
+  locator->BuildLocator();
+
+  vtkSmartPointer<vtkIdTypeArray> closest =
+    vtkSmartPointer<vtkIdTypeArray>::New();
+  vtkSmartPointer<vtkDoubleArray> dist2 =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  locator->FindAllClosestNPoints(N, queries, closest, dist2);
+  vtkSmartPointer<vtkIdTypeArray> offsets =
+    vtkSmartPointer<vtkIdTypeArray>::New();
+  vtkSmartPointer<vtkIdTypeArray> ids = vtkSmartPointer<vtkIdTypeArray>::New();
+  locator->FindAllPointsWithinRadius(radius, queries, offsets, ids);
+  if (closest->GetNumberOfComponents() != N ||
+      closest->GetNumberOfTuples() != queries->GetNumberOfPoints() ||
+      dist2->GetNumberOfTuples() != queries->GetNumberOfPoints() ||
+      offsets->GetNumberOfTuples() != queries->GetNumberOfPoints() + 1 ||
+      offsets->GetValue(0) != 0 ||
+      ids->GetNumberOfTuples() !=
+      offsets->GetValue(queries->GetNumberOfPoints()))
+    {
+    cerr << "Wrong sizes of the batched results of " << name << endl;
+    return false;
+    }
+
+  vtkSmartPointer<vtkIdList> result = vtkSmartPointer<vtkIdList>::New();
+  std::vector<double> distances(data->GetNumberOfPoints());
+  vtkIdType numFound = 0;
+  for (vtkIdType i = 0; i < queries->GetNumberOfPoints(); ++i)
+    {
+    double x[3];
+    queries->GetPoint(i, x);
+    for (vtkIdType j = 0; j < data->GetNumberOfPoints(); ++j)
+      {
+      distances[j] = vtkMath::Distance2BetweenPoints(x, data->GetPoint(j));
+      }
+    std::sort(distances.begin(), distances.end());
+
+    locator->FindClosestNPoints(N, x, result);
+    for (int j = 0; j < N; ++j)
+      {
+      if (closest->GetComponent(i, j) != result->GetId(j) ||
+          !SameDistances(dist2->GetComponent(i, j), distances[j]))
+        {
+        cerr << "Wrong closest point " << j << " of " << i << " for "
+             << name << endl;
+        return false;
+        }
+      }
+
+    locator->FindPointsWithinRadius(radius, x, result);
+    std::vector<vtkIdType> expected(result->GetPointer(0),
+                                    result->GetPointer(0) +
+                                    result->GetNumberOfIds());
+    std::vector<vtkIdType> found(ids->GetPointer(0) + offsets->GetValue(i),
+                                 ids->GetPointer(0) + offsets->GetValue(i+1));
+    std::sort(expected.begin(), expected.end());
+    std::sort(found.begin(), found.end());
+    if (found != expected)
+      {
+      cerr << "Wrong points within the radius of " << i << " for " << name
+           << endl;
+      return false;
+      }
+    numFound += static_cast<vtkIdType>(found.size());
+    }
+  if (numFound == 0)
+    {
+    cerr << "No points found within the radius for " << name << endl;
+    return false;
+    }
+
+  // Ask for more points than there are.
+  vtkSmartPointer<vtkPolyData> few = vtkSmartPointer<vtkPolyData>::New();
+  vtkSmartPointer<vtkPoints> fewPoints = vtkSmartPointer<vtkPoints>::New();
+  fewPoints->InsertNextPoint(0.1, 0.2, 0.3);
+  fewPoints->InsertNextPoint(0.6, 0.5, 0.4);
+  fewPoints->InsertNextPoint(0.9, 0.1, 0.7);
+  few->SetPoints(fewPoints);
+  locator->SetDataSet(few);
+  locator->FindAllClosestNPoints(N, queries, closest, dist2);
+  for (vtkIdType i = 0; i < queries->GetNumberOfPoints(); ++i)
+    {
+    for (int j = 0; j < N; ++j)
+      {
+      if ((j < 3 && (closest->GetComponent(i, j) < 0 ||
+                     closest->GetComponent(i, j) > 2 ||
+                     dist2->GetComponent(i, j) >= VTK_DOUBLE_MAX)) ||
+          (j >= 3 && (closest->GetComponent(i, j) != -1 ||
+                      dist2->GetComponent(i, j) != VTK_DOUBLE_MAX)))
+        {
+        cerr << "Wrong padding of the closest points for " << name << endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+}
+
+int TestPointLocatorsSMP(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+  vtkMath::RandomSeed(5439);
+
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+  for (int i = 0; i < 5000; ++i)
+    {
+    points->InsertNextPoint(vtkMath::Random(), vtkMath::Random(),
+                            0.5 * vtkMath::Random());
+    }
+  vtkSmartPointer<vtkPolyData> data = vtkSmartPointer<vtkPolyData>::New();
+  data->SetPoints(points);
+
+  // Some of the query points lie outside the data.
+  vtkSmartPointer<vtkPoints> queries = vtkSmartPointer<vtkPoints>::New();
+  queries->SetDataTypeToDouble();
+  for (int i = 0; i < 500; ++i)
+    {
+    queries->InsertNextPoint(vtkMath::Random(-0.1, 1.1),
+                             vtkMath::Random(-0.1, 1.1),
+                             vtkMath::Random(-0.1, 0.6));
+    }
+
+  vtkSmartPointer<vtkPointLocator> pointLocator =
+    vtkSmartPointer<vtkPointLocator>::New();
+  vtkSmartPointer<vtkStaticPointLocator> staticLocator =
+    vtkSmartPointer<vtkStaticPointLocator>::New();
+  vtkSmartPointer<vtkKdTreePointLocator> kdTreeLocator =
+    vtkSmartPointer<vtkKdTreePointLocator>::New();
+  vtkSmartPointer<vtkOctreePointLocator> octreeLocator =
+    vtkSmartPointer<vtkOctreePointLocator>::New();
+  vtkSmartPointer<vtkIncrementalOctreePointLocator> incrementalLocator =
+    vtkSmartPointer<vtkIncrementalOctreePointLocator>::New();
+  if (!CheckLocator(pointLocator, data, queries, "vtkPointLocator") ||
+      !CheckLocator(staticLocator, data, queries, "vtkStaticPointLocator") ||
+      !CheckLocator(kdTreeLocator, data, queries, "vtkKdTreePointLocator") ||
+      !CheckLocator(octreeLocator, data, queries, "vtkOctreePointLocator") ||
+      !CheckLocator(incrementalLocator, data, queries,
+                    "vtkIncrementalOctreePointLocator"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Without points, nothing is found.
+  vtkSmartPointer<vtkPolyData> empty = vtkSmartPointer<vtkPolyData>::New();
+  vtkSmartPointer<vtkPoints> noPoints = vtkSmartPointer<vtkPoints>::New();
+  empty->SetPoints(noPoints);
+  pointLocator->SetDataSet(empty);
+  vtkSmartPointer<vtkIdTypeArray> closest =
+    vtkSmartPointer<vtkIdTypeArray>::New();
+  pointLocator->FindAllClosestNPoints(2, queries, closest);
+  vtkSmartPointer<vtkIdTypeArray> offsets =
+    vtkSmartPointer<vtkIdTypeArray>::New();
+  vtkSmartPointer<vtkIdTypeArray> ids = vtkSmartPointer<vtkIdTypeArray>::New();
+  pointLocator->FindAllPointsWithinRadius(0.1, queries, offsets, ids);
+  if (closest->GetNumberOfTuples() != queries->GetNumberOfPoints() ||
+      closest->GetValue(0) != -1 || closest->GetValue(999) != -1 ||
+      offsets->GetValue(500) != 0 || ids->GetNumberOfTuples() != 0)
+    {
+    cerr << "Points found without points" << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,190 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestScratchPool.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Test vtkScratchPool, the reuse of the internal cells of vtkGenericCell
+// and the point set cell search relying on them.
+
+#include "vtkCellType.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkPoints.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkScratchPool.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+#define TEST_ASSERT(cond, msg) \
+  if (!(cond)) \
+    { \
+    cerr << "Failure at line " << __LINE__ << ": " << msg << endl; \
+    return EXIT_FAILURE; \
+    }
+
+namespace
+{
+// Fetch the cells of a grid from several threads, using pooled objects in
+// each cell iteration, and count the cells whose point ids do not match.
+class GetCells
+{
+public:
+  vtkScratchPool *Pool;
+  vtkUnstructuredGrid *Grid;
+  vtkSMPThreadLocal<vtkIdType> Errors;
+
+  void Initialize()
+  {
+    this->Errors.Local() = 0;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdType &errors = this->Errors.Local();
+    for (vtkIdType cellId=begin; cellId < end; ++cellId)
+      {
+      vtkScratchPool::Scope scope(this->Pool);
+      vtkGenericCell *cell = this->Pool->GetGenericCell();
+      vtkIdList *ids = this->Pool->GetIdList();
+      this->Grid->GetCell(cellId, cell);
+      this->Grid->GetCellPoints(cellId, ids);
+      if (cell->GetCellType() != this->Grid->GetCellType(cellId) ||
+          cell->GetNumberOfPoints() != ids->GetNumberOfIds() ||
+          cell->GetPointId(0) != ids->GetId(0))
+        {
+        ++errors;
+        }
+      }
+  }
+
+  void Reduce()
+  {
+  }
+};
+}
+
+int TestScratchPool(int, char *[])
+{
+  vtkSmartPointer<vtkScratchPool> pool =
+    vtkSmartPointer<vtkScratchPool>::New();
+
+  // Objects are given back at the end of the scope and then reused.
+  vtkIdList *ids;
+  vtkPoints *points;
+    {
+    vtkScratchPool::Scope scope(pool);
+    ids = pool->GetIdList();
+    points = pool->GetPoints();
+    TEST_ASSERT(ids != pool->GetIdList(), "id list handed out twice");
+    ids->InsertNextId(3);
+    points->InsertNextPoint(1.0, 2.0, 3.0);
+      {
+      vtkScratchPool::Scope nested(pool);
+      TEST_ASSERT(pool->GetGenericCell() != NULL, "no generic cell");
+      }
+    TEST_ASSERT(pool->GetNumberOfPooledObjects() == 4,
+                "wrong number of pooled objects");
+    }
+    {
+    vtkScratchPool::Scope scope(pool);
+    TEST_ASSERT(pool->GetIdList() == ids, "id list not reused");
+    TEST_ASSERT(ids->GetNumberOfIds() == 0, "id list not reset");
+    TEST_ASSERT(pool->GetPoints() == points, "points not reused");
+    TEST_ASSERT(points->GetNumberOfPoints() == 0, "points not reset");
+    }
+  TEST_ASSERT(pool->GetNumberOfPooledObjects() == 4,
+              "pooled objects allocated again");
+  pool->ReleaseAll();
+  TEST_ASSERT(pool->GetNumberOfPooledObjects() == 0, "objects not released");
+
+  // A grid made of a row of alternating hexahedra and tetrahedra, with a
+  // generic cell switching back and forth between both types.
+  const vtkIdType numCells = 1000;
+  vtkSmartPointer<vtkPoints> gridPoints = vtkSmartPointer<vtkPoints>::New();
+  for (vtkIdType i=0; i <= numCells; ++i)
+    {
+    gridPoints->InsertNextPoint(i, 0.0, 0.0);
+    gridPoints->InsertNextPoint(i, 1.0, 0.0);
+    gridPoints->InsertNextPoint(i, 1.0, 1.0);
+    gridPoints->InsertNextPoint(i, 0.0, 1.0);
+    }
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(gridPoints);
+  grid->Allocate(numCells);
+  vtkIdType pts[8];
+  for (vtkIdType cellId=0; cellId < numCells; ++cellId)
+    {
+    if (cellId % 2)
+      {
+      pts[0] = 4*cellId; pts[1] = 4*cellId + 1;
+      pts[2] = 4*cellId + 3; pts[3] = 4*cellId + 4;
+      grid->InsertNextCell(VTK_TETRA, 4, pts);
+      }
+    else
+      {
+      for (int i=0; i < 4; ++i)
+        {
+        pts[i] = 4*cellId + i;
+        pts[i+4] = 4*(cellId+1) + i;
+        }
+      grid->InsertNextCell(VTK_HEXAHEDRON, 8, pts);
+      }
+    }
+
+  vtkSmartPointer<vtkGenericCell> cell = vtkSmartPointer<vtkGenericCell>::New();
+  vtkSmartPointer<vtkIdList> cellPts = vtkSmartPointer<vtkIdList>::New();
+  for (vtkIdType cellId=0; cellId < 4; ++cellId)
+    {
+    grid->GetCell(cellId, cell);
+    grid->GetCellPoints(cellId, cellPts);
+    TEST_ASSERT(cell->GetCellType() == grid->GetCellType(cellId),
+                "wrong generic cell type");
+    TEST_ASSERT(cell->GetPointId(3) == cellPts->GetId(3),
+                "wrong generic cell point id");
+    double bounds[6];
+    cell->GetBounds(bounds);
+    TEST_ASSERT(bounds[0] == cellId && bounds[1] == cellId+1,
+                "wrong generic cell points");
+    }
+  cell->SetCellTypeToEmptyCell();
+  TEST_ASSERT(cell->GetNumberOfPoints() == 0, "wrong empty cell");
+  cell->SetCellTypeToHexahedron();
+  TEST_ASSERT(cell->GetNumberOfPoints() == 8 &&
+              cell->GetPoints() != NULL, "wrong reused hexahedron");
+
+  // Point location through the pooled id lists of the grid.
+  double x[3] = {10.5, 0.5, 0.5}, pcoords[3], weights[8];
+  int subId;
+  for (int i=0; i < 3; ++i)
+    {
+    TEST_ASSERT(grid->FindCell(x, NULL, cell, -1, 1.0e-6, subId, pcoords,
+                               weights) == 10, "wrong cell found");
+    }
+
+  // Concurrent use of the pool.
+  GetCells getCells;
+  getCells.Pool = pool;
+  getCells.Grid = grid;
+  vtkSMPTools::For(0, numCells, getCells);
+  vtkSMPThreadLocal<vtkIdType>::iterator iter;
+  for (iter = getCells.Errors.begin(); iter != getCells.Errors.end(); ++iter)
+    {
+    TEST_ASSERT(*iter == 0, "wrong cells fetched from the threads");
+    }
+  TEST_ASSERT(pool->GetNumberOfPooledObjects() > 0 &&
+              pool->GetNumberOfPooledObjects() < numCells,
+              "pooled objects not reused by the threads");
+
+  return EXIT_SUCCESS;
+}
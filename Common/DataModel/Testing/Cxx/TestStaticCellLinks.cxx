@@ -23,6 +23,30 @@
 #include "vtkSphereSource.h"
 #include "vtkTimerLog.h"
 
+#include <algorithm>
+
+// Check that the links built in parallel are the links of the serial build.
+template <typename TIds, typename DataT>
+bool SameThreadedLinks(DataT *data)
+{
+  vtkStaticCellLinksTemplate<TIds> serial;
+  vtkStaticCellLinksTemplate<TIds> threaded;
+  serial.BuildLinks(data);
+  threaded.SetEnableSMP(true);
+  threaded.BuildLinks(data);
+  for (vtkIdType ptId=0; ptId < data->GetNumberOfPoints(); ++ptId)
+    {
+    TIds numCells = serial.GetNumberOfCells(ptId);
+    if ( threaded.GetNumberOfCells(ptId) != numCells ||
+         !std::equal(serial.GetCells(ptId), serial.GetCells(ptId)+numCells,
+                     threaded.GetCells(ptId)) )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
 // Test the building of static cell links in both unstructured and structured
 // grids.
 int TestStaticCellLinks( int, char *[] )
@@ -191,5 +215,16 @@ int TestStaticCellLinks( int, char *[] )
     return EXIT_FAILURE;
     }
 
+  //----------------------------------------------------------------------------
+  // Threaded builds
+  if ( !SameThreadedLinks<int>(ugrid.GetPointer()) ||
+       !SameThreadedLinks<vtkIdType>(ugrid.GetPointer()) ||
+       !SameThreadedLinks<int>(pdata.GetPointer()) ||
+       !SameThreadedLinks<vtkIdType>(pdata.GetPointer()) )
+    {
+    cout << "Threaded links differ from the serial links\n";
+    return EXIT_FAILURE;
+    }
+
   return EXIT_SUCCESS;
 }
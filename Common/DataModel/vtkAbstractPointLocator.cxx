@@ -15,7 +15,125 @@
 #include "vtkAbstractPointLocator.h"
 
 #include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkPoints.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+// Find the closest N points to a range of query points.
+struct FindAllClosestNPointsFunctor
+{
+  vtkAbstractPointLocator *Locator;
+  vtkDataSet *DataSet;
+  vtkPoints *Points;
+  int N;
+  int NumberOfFound; // N, or the number of points when smaller
+  vtkIdType *Ids;
+  double *Distances2;
+  vtkSMPThreadLocalObject<vtkIdList> Result;
+
+  void Initialize()
+    {
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    vtkIdList *result = this->Result.Local();
+    double x[3], p[3];
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Points->GetPoint(i, x);
+      this->Locator->FindClosestNPoints(this->NumberOfFound, x, result);
+      vtkIdType *ids = this->Ids + i * this->N;
+      double *dist2 = (this->Distances2 ? this->Distances2 + i * this->N :
+                       NULL);
+      vtkIdType numIds = result->GetNumberOfIds();
+      for (vtkIdType j = 0; j < this->N; ++j)
+        {
+        ids[j] = (j < numIds ? result->GetId(j) : -1);
+        if (dist2)
+          {
+          if (ids[j] < 0)
+            {
+            dist2[j] = VTK_DOUBLE_MAX;
+            }
+          else
+            {
+            this->DataSet->GetPoint(ids[j], p);
+            dist2[j] = vtkMath::Distance2BetweenPoints(x, p);
+            }
+          }
+        }
+      }
+    }
+
+  void Reduce()
+    {
+    }
+};
+
+// The ids found by a thread for a contiguous range of query points, stored
+// from Start in its buffer.
+struct RadiusRange
+{
+  vtkIdType Begin;
+  vtkIdType End;
+  size_t Start;
+};
+
+struct RadiusBuffer
+{
+  std::vector<vtkIdType> Ids;
+  std::vector<RadiusRange> Ranges;
+};
+
+// Find the points within a radius of a range of query points, counting them
+// in Counts and keeping them in a per-thread buffer.
+struct FindAllPointsWithinRadiusFunctor
+{
+  vtkAbstractPointLocator *Locator;
+  vtkPoints *Points;
+  double Radius;
+  vtkIdType *Counts;
+  vtkSMPThreadLocalObject<vtkIdList> Result;
+  vtkSMPThreadLocal<RadiusBuffer> Buffer;
+
+  void Initialize()
+    {
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    vtkIdList *result = this->Result.Local();
+    RadiusBuffer &buffer = this->Buffer.Local();
+    RadiusRange range = { begin, end, buffer.Ids.size() };
+    buffer.Ranges.push_back(range);
+    double x[3];
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Points->GetPoint(i, x);
+      this->Locator->FindPointsWithinRadius(this->Radius, x, result);
+      vtkIdType numIds = result->GetNumberOfIds();
+      this->Counts[i] = numIds;
+      buffer.Ids.insert(buffer.Ids.end(), result->GetPointer(0),
+                        result->GetPointer(0) + numIds);
+      }
+    }
+
+  void Reduce()
+    {
+    }
+};
+}
 
 
 //-----------------------------------------------------------------------------
@@ -68,6 +186,101 @@ void vtkAbstractPointLocator::FindPointsWithinRadius(double R, double x,
   this->FindPointsWithinRadius(R,p,result);
 }
 
+//-----------------------------------------------------------------------------
+void vtkAbstractPointLocator::FindAllClosestNPoints(int N, vtkPoints *points,
+                                                    vtkIdTypeArray *result,
+                                                    vtkDoubleArray *dist2)
+{
+  N = (N < 0 ? 0 : N);
+  vtkIdType numQueries = points->GetNumberOfPoints();
+  result->SetNumberOfComponents(N > 0 ? N : 1);
+  result->SetNumberOfTuples(N > 0 ? numQueries : 0);
+  if (dist2)
+    {
+    dist2->SetNumberOfComponents(N > 0 ? N : 1);
+    dist2->SetNumberOfTuples(N > 0 ? numQueries : 0);
+    }
+  if (N == 0 || numQueries == 0)
+    {
+    return;
+    }
+
+  vtkIdType numPts = (this->DataSet ? this->DataSet->GetNumberOfPoints() : 0);
+  if (numPts < 1)
+    {
+    std::fill_n(result->GetPointer(0), numQueries * N, -1);
+    if (dist2)
+      {
+      std::fill_n(dist2->GetPointer(0), numQueries * N, VTK_DOUBLE_MAX);
+      }
+    return;
+    }
+
+  // The queries are thread safe once the locator is built.
+  this->BuildLocator();
+  FindAllClosestNPointsFunctor functor;
+  functor.Locator = this;
+  functor.DataSet = this->DataSet;
+  functor.Points = points;
+  functor.N = N;
+  functor.NumberOfFound = static_cast<int>(std::min<vtkIdType>(N, numPts));
+  functor.Ids = result->GetPointer(0);
+  functor.Distances2 = (dist2 ? dist2->GetPointer(0) : NULL);
+  vtkSMPTools::For(0, numQueries, functor);
+}
+
+//-----------------------------------------------------------------------------
+void vtkAbstractPointLocator::FindAllPointsWithinRadius(double R,
+                                                        vtkPoints *points,
+                                                        vtkIdTypeArray *offsets,
+                                                        vtkIdTypeArray *ids)
+{
+  vtkIdType numQueries = points->GetNumberOfPoints();
+  offsets->SetNumberOfComponents(1);
+  offsets->SetNumberOfTuples(numQueries + 1);
+  ids->SetNumberOfComponents(1);
+  ids->SetNumberOfTuples(0);
+  vtkIdType *offset = offsets->GetPointer(0);
+  vtkIdType numPts = (this->DataSet ? this->DataSet->GetNumberOfPoints() : 0);
+  if (numPts < 1)
+    {
+    std::fill_n(offset, numQueries + 1, 0);
+    return;
+    }
+
+  // The queries are thread safe once the locator is built. Each query point
+  // is counted in offset[i+1], before the counts are turned into offsets.
+  this->BuildLocator();
+  FindAllPointsWithinRadiusFunctor functor;
+  functor.Locator = this;
+  functor.Points = points;
+  functor.Radius = R;
+  functor.Counts = offset + 1;
+  vtkSMPTools::For(0, numQueries, functor);
+  offset[0] = 0;
+  for (vtkIdType i = 0; i < numQueries; ++i)
+    {
+    offset[i+1] += offset[i];
+    }
+
+  // Gather the ids found by the threads.
+  ids->SetNumberOfTuples(offset[numQueries]);
+  vtkIdType *output = ids->GetPointer(0);
+  vtkSMPThreadLocal<RadiusBuffer>::iterator itr;
+  for (itr = functor.Buffer.begin(); itr != functor.Buffer.end(); ++itr)
+    {
+    const RadiusBuffer &buffer = *itr;
+    for (size_t r = 0; r < buffer.Ranges.size(); ++r)
+      {
+      const RadiusRange &range = buffer.Ranges[r];
+      vtkIdType numIds = offset[range.End] - offset[range.Begin];
+      std::copy(buffer.Ids.begin() + range.Start,
+                buffer.Ids.begin() + range.Start + numIds,
+                output + offset[range.Begin]);
+      }
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkAbstractPointLocator::GetBounds(double* bnds)
 {
@@ -20,9 +20,19 @@
 // lie in each bucket. Typical operation involves giving a position in 3D
 // and finding the closest point.  The points are provided from the specified
 // dataset input.
+//
+// Once BuildLocator() has been called from a single thread, the query
+// methods (FindClosestPoint(), FindClosestPointWithinRadius(),
+// FindClosestNPoints() and FindPointsWithinRadius()) only read the search
+// structure, and may be called concurrently as long as each thread passes
+// its own result list. All the locators in VTK honor this contract, and
+// subclasses must too. The batched queries FindAllClosestNPoints() and
+// FindAllPointsWithinRadius() rely on it to answer the queries of a whole
+// set of points with vtkSMPTools.
 
 // .SECTION See Also
-// vtkPointLocator vtkStaticPointLocator vtkMergePoints
+// vtkPointLocator vtkStaticPointLocator vtkMergePoints vtkKdTreePointLocator
+// vtkOctreePointLocator vtkSMPTools
 
 #ifndef vtkAbstractPointLocator_h
 #define vtkAbstractPointLocator_h
@@ -30,7 +40,10 @@
 #include "vtkCommonDataModelModule.h" // For export macro
 #include "vtkLocator.h"
 
+class vtkDoubleArray;
 class vtkIdList;
+class vtkIdTypeArray;
+class vtkPoints;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkAbstractPointLocator : public vtkLocator
 {
@@ -77,6 +90,27 @@ public:
   void FindPointsWithinRadius(double R, double x, double y, double z,
                                       vtkIdList *result);
 
+  // Description:
+  // Find the closest N points to each of the given points, in parallel. The
+  // result gets N components per point: the ids of its closest points,
+  // sorted from closest to farthest, padded with -1 when the dataset has
+  // fewer than N points. If dist2 is not NULL, it gets the matching squared
+  // distances (VTK_DOUBLE_MAX for the padding). The locator is built first
+  // if needed, so these methods must be called from a single thread.
+  void FindAllClosestNPoints(int N, vtkPoints *points,
+                             vtkIdTypeArray *result,
+                             vtkDoubleArray *dist2=NULL);
+
+  // Description:
+  // Find the points within the radius R of each of the given points, in
+  // parallel. The ids found for the point i are stored, unsorted, from
+  // ids[offsets[i]] to ids[offsets[i+1]-1]: offsets gets one more value
+  // than there are points. The locator is built first if needed, so these
+  // methods must be called from a single thread.
+  void FindAllPointsWithinRadius(double R, vtkPoints *points,
+                                 vtkIdTypeArray *offsets,
+                                 vtkIdTypeArray *ids);
+
   // Description:
   // Provide an accessor to the bounds.
   virtual double *GetBounds() { return this->Bounds; }
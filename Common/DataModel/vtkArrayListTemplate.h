@@ -45,6 +45,26 @@
 #include <vector>
 #include <algorithm>
 
+// Convert an interpolated value to the type of an array, rounding it for
+// integral types as vtkDataArray::InterpolateTuple() does.
+template <typename T>
+inline T ArrayPairValue(double v)
+{
+  return static_cast<T>((v >= 0.0) ? (v + 0.5) : (v - 0.5));
+}
+
+template <>
+inline float ArrayPairValue<float>(double v)
+{
+  return static_cast<float>(v);
+}
+
+template <>
+inline double ArrayPairValue<double>(double v)
+{
+  return v;
+}
+
 // Create a generic class supporting virtual dispatch to type-specific
 // subclasses.
 struct BaseArrayPair
@@ -66,6 +86,7 @@ struct BaseArrayPair
                            const double *weights, vtkIdType outId) = 0;
   virtual void InterpolateEdge(vtkIdType v0, vtkIdType v1,
                                double t, vtkIdType outId) = 0;
+  virtual void Average(int numIds, const vtkIdType *ids, vtkIdType outId) = 0;
   virtual void AssignNullValue(vtkIdType outId) = 0;
   virtual void Realloc(vtkIdType sze) = 0;
 };
@@ -104,7 +125,7 @@ struct ArrayPair : public BaseArrayPair
         {
         v += weights[i] * static_cast<double>(this->Input[ids[i]*this->NumComp+j]);
         }
-      this->Output[outId*this->NumComp+j] = static_cast<T>(v);
+      this->Output[outId*this->NumComp+j] = ArrayPairValue<T>(v);
       }
     }
 
@@ -116,7 +137,21 @@ struct ArrayPair : public BaseArrayPair
       {
       v = this->Input[v0*numComp+j] +
         t * (this->Input[v1*numComp+j] - this->Input[v0*numComp+j]);
-      this->Output[outId*numComp+j] = static_cast<T>(v);
+      this->Output[outId*numComp+j] = ArrayPairValue<T>(v);
+      }
+    }
+
+  virtual void Average(int numIds, const vtkIdType *ids, vtkIdType outId)
+    {
+    double weight = 1.0 / numIds;
+    for (int j=0; j < this->NumComp; ++j)
+      {
+      double v = 0.0;
+      for (int i=0; i < numIds; ++i)
+        {
+        v += weight * static_cast<double>(this->Input[ids[i]*this->NumComp+j]);
+        }
+      this->Output[outId*this->NumComp+j] = ArrayPairValue<T>(v);
       }
     }
 
@@ -155,6 +190,14 @@ struct ArrayList
   void AddArrays(vtkIdType numOutPts, vtkDataSetAttributes *inPD,
                  vtkDataSetAttributes *outPD, double nullValue=0.0);
 
+  // Add the data arrays of a field list (e.g., to convert cell data to point
+  // data), once vtkDataSetAttributes::InterpolateAllocate() was called with
+  // it. The arrays are matched by index rather than by name, so unnamed
+  // arrays are processed too.
+  void AddArrays(vtkIdType numOutPts, vtkDataSetAttributes::FieldList &list,
+                 int listIdx, vtkDataSetAttributes *inPD,
+                 vtkDataSetAttributes *outPD, double nullValue=0.0);
+
   // Add a pair of arrays (manual insertion). Returns the output array created,
   // if any. No array may be created if \c inArray was previously marked as
   // excluded using ExcludeArray().
@@ -196,6 +239,16 @@ struct ArrayList
         }
     }
 
+  // Loop over the arrays and average the values of the given ids
+  void Average(int numIds, const vtkIdType *ids, vtkIdType outId)
+    {
+      for (std::vector<BaseArrayPair*>::iterator it = Arrays.begin();
+           it != Arrays.end(); ++it)
+        {
+        (*it)->Average(numIds, ids, outId);
+        }
+    }
+
   // Loop over the arrays and assign the null value
   void AssignNullValue(vtkIdType outId)
     {
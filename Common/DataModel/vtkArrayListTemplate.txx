@@ -117,4 +117,41 @@ AddArrays(vtkIdType numOutPts, vtkDataSetAttributes *inPD, vtkDataSetAttributes
     }//for each candidate array
 }
 
+// Add the data arrays of a field list, matched by index.
+void ArrayList::
+AddArrays(vtkIdType numOutPts, vtkDataSetAttributes::FieldList &list,
+          int listIdx, vtkDataSetAttributes *inPD, vtkDataSetAttributes *outPD,
+          double nullValue)
+{
+  vtkDataArray *iArray, *oArray;
+  int i, inIdx, outIdx, numFields = list.GetNumberOfFields();
+  for (i=0; i < numFields; ++i)
+    {
+    inIdx = list.GetDSAIndex(listIdx,i);
+    outIdx = list.GetFieldIndex(i);
+    if ( inIdx < 0 || outIdx < 0 )
+      {
+      continue;
+      }
+    iArray = inPD->GetArray(inIdx);
+    oArray = outPD->GetArray(outIdx);
+    if ( iArray && oArray && ! this->IsExcluded(iArray) &&
+         ! this->IsExcluded(oArray) &&
+         iArray->GetDataType() == oArray->GetDataType() &&
+         iArray->GetNumberOfComponents() == oArray->GetNumberOfComponents() )
+      {
+      oArray->SetNumberOfTuples(numOutPts);
+      void *iD = iArray->GetVoidPointer(0);
+      void *oD = oArray->GetVoidPointer(0);
+      switch (iArray->GetDataType())
+        {
+        vtkTemplateMacro(CreateArrayPair(this, static_cast<VTK_TT *>(iD),
+                         static_cast<VTK_TT *>(oD),numOutPts,
+                         oArray->GetNumberOfComponents(),oArray,
+                         static_cast<VTK_TT>(nullValue)));
+        }//over all VTK types
+      }//if matching arrays
+    }//for each field
+}
+
 #endif
@@ -0,0 +1,1671 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBVHCellLocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkBVHCellLocator.h"
+
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkStructuredGrid.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+vtkStandardNewMacro(vtkBVHCellLocator);
+
+// The SAH is evaluated between this number of bins along each axis.
+static const int VTK_BVH_NUMBER_OF_BINS = 16;
+
+// Nodes with more cells than this are split from the calling thread, with
+// threaded binning; the smaller ones are the roots of subtrees built in
+// parallel.
+static const vtkIdType VTK_BVH_SUBTREE_SIZE = 4096;
+
+// Nodes are not split below this depth, which bounds the traversal stacks.
+static const int VTK_BVH_MAX_DEPTH = 64;
+static const int VTK_BVH_STACK_SIZE = 2 * VTK_BVH_MAX_DEPTH + 2;
+
+//-----------------------------------------------------------------------------
+// The following code supports threaded construction of the hierarchy and its
+// traversals. The hierarchy is built in three steps:
+// 1) The bounds and centers of all the cells are computed in parallel.
+// 2) Starting from the root, the nodes with many cells are split in turn:
+// their bounds are computed and their cell centers binned in parallel, the
+// SAH is evaluated between the bins, and the cells are partitioned.
+// 3) The remaining nodes are the roots of independent subtrees, which are
+// built in parallel into separate node arrays, and then appended to the
+// node array of the hierarchy.
+// The traversals only read the hierarchy, using fixed size stacks.
+
+// A node of the hierarchy. The cells of a leaf are stored from Offset; the
+// children of an interior node are stored at Offset and Offset+1.
+struct vtkBVHNode
+{
+  double Bounds[6];
+  vtkIdType Offset;
+  vtkIdType NumberOfCells; // 0 for interior nodes
+};
+
+namespace
+{
+// A cell during the construction.
+struct BVHPrimitive
+{
+  double Bounds[6];
+  double Center[3];
+  vtkIdType CellId;
+};
+
+// Whether the cells of a dataset may be accessed from several threads.
+bool CanAccessConcurrently(vtkDataSet *dataSet)
+{
+  return (vtkImageData::SafeDownCast(dataSet) ||
+          vtkRectilinearGrid::SafeDownCast(dataSet) ||
+          vtkStructuredGrid::SafeDownCast(dataSet) ||
+          vtkUnstructuredGrid::SafeDownCast(dataSet) ||
+          vtkPolyData::SafeDownCast(dataSet));
+}
+
+// Cells without points are not stored in the hierarchy.
+struct BVHHasNoCell
+{
+  bool operator()(const BVHPrimitive &primitive) const
+    {
+    return primitive.CellId < 0;
+    }
+};
+
+// An intersection of a line with a cell, ordered along the line.
+struct BVHHit
+{
+  double T;
+  double X[3];
+  vtkIdType CellId;
+
+  bool operator<(const BVHHit &other) const
+    {
+    return this->T < other.T ||
+      (this->T == other.T && this->CellId < other.CellId);
+    }
+};
+
+// Run a functor over a range, from several threads or from the calling one.
+template <typename Functor>
+void ExecuteRange(vtkIdType begin, vtkIdType end, bool threaded,
+                  Functor &functor)
+{
+  if (threaded)
+    {
+    vtkSMPTools::For(begin, end, functor);
+    }
+  else
+    {
+    functor.Initialize();
+    functor(begin, end);
+    functor.Reduce();
+    }
+}
+
+void InitializeBounds(double bounds[6])
+{
+  bounds[0] = bounds[2] = bounds[4] = VTK_DOUBLE_MAX;
+  bounds[1] = bounds[3] = bounds[5] = -VTK_DOUBLE_MAX;
+}
+
+void AddBounds(double bounds[6], const double other[6])
+{
+  for (int i = 0; i < 3; ++i)
+    {
+    bounds[2*i] = std::min(bounds[2*i], other[2*i]);
+    bounds[2*i+1] = std::max(bounds[2*i+1], other[2*i+1]);
+    }
+}
+
+void AddPoint(double bounds[6], const double x[3])
+{
+  for (int i = 0; i < 3; ++i)
+    {
+    bounds[2*i] = std::min(bounds[2*i], x[i]);
+    bounds[2*i+1] = std::max(bounds[2*i+1], x[i]);
+    }
+}
+
+// The measure of a box used by the SAH: half its area, or half its perimeter
+// for the nodes whose boxes are flat (measure 1).
+double BoxMeasure(const double bounds[6], int measure)
+{
+  if (bounds[0] > bounds[1])
+    {
+    return 0.0;
+    }
+  double dx = bounds[1] - bounds[0];
+  double dy = bounds[3] - bounds[2];
+  double dz = bounds[5] - bounds[4];
+  return measure == 0 ? dx * dy + dy * dz + dz * dx : dx + dy + dz;
+}
+
+// The squared distance from a point to a box (0 inside).
+inline double Distance2ToBounds(const double x[3], const double bounds[6])
+{
+  double dist2 = 0.0;
+  for (int i = 0; i < 3; ++i)
+    {
+    double d = 0.0;
+    if (x[i] < bounds[2*i])
+      {
+      d = bounds[2*i] - x[i];
+      }
+    else if (x[i] > bounds[2*i+1])
+      {
+      d = x[i] - bounds[2*i+1];
+      }
+    dist2 += d * d;
+    }
+  return dist2;
+}
+
+inline bool InsideBounds(const double x[3], const double bounds[6],
+                         double pad)
+{
+  return bounds[0] - pad <= x[0] && x[0] <= bounds[1] + pad &&
+         bounds[2] - pad <= x[1] && x[1] <= bounds[3] + pad &&
+         bounds[4] - pad <= x[2] && x[2] <= bounds[5] + pad;
+}
+
+inline bool OverlapBounds(const double a[6], const double b[6], double pad)
+{
+  return a[0] - pad <= b[1] && b[0] <= a[1] + pad &&
+         a[2] - pad <= b[3] && b[2] <= a[3] + pad &&
+         a[4] - pad <= b[5] && b[4] <= a[5] + pad;
+}
+
+// A finite line a0 + t*(a1-a0), 0 <= t <= 1, clipped against boxes enlarged
+// by a tolerance.
+class BVHSegment
+{
+public:
+  BVHSegment(const double a0[3], const double a1[3], double tol)
+    {
+    this->Tolerance = tol;
+    for (int i = 0; i < 3; ++i)
+      {
+      this->Origin[i] = a0[i];
+      double d = a1[i] - a0[i];
+      this->Parallel[i] = (d == 0.0);
+      this->Inverse[i] = (d == 0.0 ? 0.0 : 1.0 / d);
+      }
+    }
+
+  // Return whether the line intersects the box, and the parameter at which
+  // it enters the box.
+  bool Intersect(const double bounds[6], double &tEnter) const
+    {
+    double t0 = 0.0, t1 = 1.0;
+    for (int i = 0; i < 3; ++i)
+      {
+      double lo = bounds[2*i] - this->Tolerance;
+      double hi = bounds[2*i+1] + this->Tolerance;
+      if (this->Parallel[i])
+        {
+        if (this->Origin[i] < lo || this->Origin[i] > hi)
+          {
+          return false;
+          }
+        continue;
+        }
+      double tLo = (lo - this->Origin[i]) * this->Inverse[i];
+      double tHi = (hi - this->Origin[i]) * this->Inverse[i];
+      if (tLo > tHi)
+        {
+        std::swap(tLo, tHi);
+        }
+      t0 = (tLo > t0 ? tLo : t0);
+      t1 = (tHi < t1 ? tHi : t1);
+      if (t0 > t1)
+        {
+        return false;
+        }
+      }
+    tEnter = t0;
+    return true;
+    }
+
+private:
+  double Origin[3];
+  double Inverse[3];
+  bool Parallel[3];
+  double Tolerance;
+};
+
+// Weights passed to vtkCell::EvaluatePosition(), on the stack unless the
+// cells are unusually large.
+class BVHWeights
+{
+public:
+  BVHWeights(int size)
+    {
+    this->Data = this->Stack;
+    if (size > VTK_CELL_SIZE)
+      {
+      this->Heap.resize(size);
+      this->Data = &this->Heap[0];
+      }
+    }
+  double *Data;
+
+private:
+  double Stack[VTK_CELL_SIZE];
+  std::vector<double> Heap;
+};
+
+//-----------------------------------------------------------------------------
+// Compute the bounds and centers of the cells. Empty cells are given a
+// negative id.
+struct BVHCellBounds
+{
+  vtkDataSet *DataSet;
+  BVHPrimitive *Primitives;
+  bool UseCellBounds; // whether GetCellBounds() avoids building cells
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+
+  BVHCellBounds(vtkDataSet *dataSet, BVHPrimitive *primitives) :
+    DataSet(dataSet), Primitives(primitives)
+    {
+    this->UseCellBounds = (vtkUnstructuredGrid::SafeDownCast(dataSet) ||
+                           vtkPolyData::SafeDownCast(dataSet) ||
+                           vtkImageData::SafeDownCast(dataSet));
+    }
+
+  void Initialize()
+    {
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    vtkGenericCell *cell = this->Cell.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      BVHPrimitive &primitive = this->Primitives[cellId];
+      primitive.CellId = -1;
+      if (this->UseCellBounds)
+        {
+        if (this->DataSet->GetCellType(cellId) == VTK_EMPTY_CELL)
+          {
+          continue;
+          }
+        this->DataSet->GetCellBounds(cellId, primitive.Bounds);
+        }
+      else
+        {
+        this->DataSet->GetCell(cellId, cell);
+        if (cell->GetNumberOfPoints() == 0)
+          {
+          continue;
+          }
+        cell->GetBounds(primitive.Bounds);
+        }
+      if (primitive.Bounds[0] > primitive.Bounds[1])
+        {
+        continue;
+        }
+      for (int i = 0; i < 3; ++i)
+        {
+        primitive.Center[i] =
+          0.5 * (primitive.Bounds[2*i] + primitive.Bounds[2*i+1]);
+        }
+      primitive.CellId = cellId;
+      }
+    }
+
+  void Reduce()
+    {
+    }
+};
+
+struct BVHRangeBoundsData
+{
+  double Bounds[6];
+  double CenterBounds[6];
+};
+
+// Compute the bounds of a range of cells, and the bounds of their centers.
+struct BVHRangeBounds
+{
+  const BVHPrimitive *Primitives;
+  vtkSMPThreadLocal<BVHRangeBoundsData> Local;
+  BVHRangeBoundsData Result;
+
+  BVHRangeBounds(const BVHPrimitive *primitives) : Primitives(primitives)
+    {
+    InitializeBounds(this->Result.Bounds);
+    InitializeBounds(this->Result.CenterBounds);
+    }
+
+  void Initialize()
+    {
+    BVHRangeBoundsData &local = this->Local.Local();
+    InitializeBounds(local.Bounds);
+    InitializeBounds(local.CenterBounds);
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    BVHRangeBoundsData &local = this->Local.Local();
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      AddBounds(local.Bounds, this->Primitives[i].Bounds);
+      AddPoint(local.CenterBounds, this->Primitives[i].Center);
+      }
+    }
+
+  void Reduce()
+    {
+    vtkSMPThreadLocal<BVHRangeBoundsData>::iterator end = this->Local.end();
+    for (vtkSMPThreadLocal<BVHRangeBoundsData>::iterator it =
+           this->Local.begin(); it != end; ++it)
+      {
+      AddBounds(this->Result.Bounds, it->Bounds);
+      AddBounds(this->Result.CenterBounds, it->CenterBounds);
+      }
+    }
+};
+
+// Map the cell centers of a node to bins along each axis.
+struct BVHBinMap
+{
+  double Min[3];
+  double Scale[3]; // 0 along the axes where the centers do not spread
+
+  BVHBinMap(const double centerBounds[6])
+    {
+    for (int i = 0; i < 3; ++i)
+      {
+      double extent = centerBounds[2*i+1] - centerBounds[2*i];
+      this->Min[i] = centerBounds[2*i];
+      this->Scale[i] = (extent > 0.0 ? VTK_BVH_NUMBER_OF_BINS / extent : 0.0);
+      }
+    }
+
+  int GetBin(const double center[3], int axis) const
+    {
+    int bin = static_cast<int>(
+      (center[axis] - this->Min[axis]) * this->Scale[axis]);
+    return (bin < 0 ? 0 :
+            (bin >= VTK_BVH_NUMBER_OF_BINS ? VTK_BVH_NUMBER_OF_BINS-1 : bin));
+    }
+};
+
+struct BVHBins
+{
+  vtkIdType Counts[3][VTK_BVH_NUMBER_OF_BINS];
+  double Bounds[3][VTK_BVH_NUMBER_OF_BINS][6];
+
+  void Initialize()
+    {
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      for (int bin = 0; bin < VTK_BVH_NUMBER_OF_BINS; ++bin)
+        {
+        this->Counts[axis][bin] = 0;
+        InitializeBounds(this->Bounds[axis][bin]);
+        }
+      }
+    }
+
+  void Merge(const BVHBins &other)
+    {
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      for (int bin = 0; bin < VTK_BVH_NUMBER_OF_BINS; ++bin)
+        {
+        this->Counts[axis][bin] += other.Counts[axis][bin];
+        AddBounds(this->Bounds[axis][bin], other.Bounds[axis][bin]);
+        }
+      }
+    }
+};
+
+// Count the cells of a node falling in each bin, and bound them.
+struct BVHBinning
+{
+  const BVHPrimitive *Primitives;
+  const BVHBinMap &Map;
+  vtkSMPThreadLocal<BVHBins> Local;
+  BVHBins Result;
+
+  BVHBinning(const BVHPrimitive *primitives, const BVHBinMap &map) :
+    Primitives(primitives), Map(map)
+    {
+    this->Result.Initialize();
+    }
+
+  void Initialize()
+    {
+    this->Local.Local().Initialize();
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    BVHBins &bins = this->Local.Local();
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      const BVHPrimitive &primitive = this->Primitives[i];
+      for (int axis = 0; axis < 3; ++axis)
+        {
+        if (this->Map.Scale[axis] > 0.0)
+          {
+          int bin = this->Map.GetBin(primitive.Center, axis);
+          bins.Counts[axis][bin]++;
+          AddBounds(bins.Bounds[axis][bin], primitive.Bounds);
+          }
+        }
+      }
+    }
+
+  void Reduce()
+    {
+    vtkSMPThreadLocal<BVHBins>::iterator end = this->Local.end();
+    for (vtkSMPThreadLocal<BVHBins>::iterator it = this->Local.begin();
+         it != end; ++it)
+      {
+      this->Result.Merge(*it);
+      }
+    }
+};
+
+// Whether the cells of a node go to the first child.
+struct BVHInFirstChild
+{
+  const BVHBinMap &Map;
+  int Axis;
+  int Bin;
+
+  BVHInFirstChild(const BVHBinMap &map, int axis, int bin) :
+    Map(map), Axis(axis), Bin(bin)
+    {
+    }
+
+  bool operator()(const BVHPrimitive &primitive) const
+    {
+    return this->Map.GetBin(primitive.Center, this->Axis) < this->Bin;
+    }
+};
+
+// Split the cells [begin,end) of a node having the given bounds (and cell
+// center bounds) by evaluating the SAH between bins, and partition them.
+// Returns the start of the second child, or begin to make a leaf.
+vtkIdType SplitNode(BVHPrimitive *primitives, vtkIdType begin, vtkIdType end,
+                    const double bounds[6], const double centerBounds[6],
+                    int maxCellsPerLeaf, int depth, bool threaded)
+{
+  vtkIdType numCells = end - begin;
+  if (numCells <= 1 || depth >= VTK_BVH_MAX_DEPTH)
+    {
+    return begin;
+    }
+
+  BVHBinMap map(centerBounds);
+  if (map.Scale[0] == 0.0 && map.Scale[1] == 0.0 && map.Scale[2] == 0.0)
+    {
+    // The centers coincide: they cannot be separated, so just halve large
+    // nodes.
+    return (numCells <= maxCellsPerLeaf ? begin : begin + numCells / 2);
+    }
+
+  BVHBinning binning(primitives + begin, map);
+  ExecuteRange(0, numCells, threaded && numCells > VTK_BVH_SUBTREE_SIZE,
+               binning);
+  const BVHBins &bins = binning.Result;
+
+  int measure = (BoxMeasure(bounds, 0) > 0.0 ? 0 : 1);
+  double bestCost = VTK_DOUBLE_MAX;
+  int bestAxis = -1, bestBin = 0;
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    if (map.Scale[axis] == 0.0)
+      {
+      continue;
+      }
+    // Sweep from the right, then from the left, the split being before bin.
+    double rightCosts[VTK_BVH_NUMBER_OF_BINS];
+    vtkIdType count = 0;
+    double box[6];
+    InitializeBounds(box);
+    for (int bin = VTK_BVH_NUMBER_OF_BINS - 1; bin > 0; --bin)
+      {
+      count += bins.Counts[axis][bin];
+      AddBounds(box, bins.Bounds[axis][bin]);
+      rightCosts[bin] = (count > 0 ? count * BoxMeasure(box, measure) : -1.0);
+      }
+    count = 0;
+    InitializeBounds(box);
+    for (int bin = 1; bin < VTK_BVH_NUMBER_OF_BINS; ++bin)
+      {
+      count += bins.Counts[axis][bin-1];
+      AddBounds(box, bins.Bounds[axis][bin-1]);
+      if (count == 0 || rightCosts[bin] < 0.0)
+        {
+        continue;
+        }
+      double cost = count * BoxMeasure(box, measure) + rightCosts[bin];
+      if (cost < bestCost)
+        {
+        bestCost = cost;
+        bestAxis = axis;
+        bestBin = bin;
+        }
+      }
+    }
+
+  double nodeMeasure = BoxMeasure(bounds, measure);
+  if (bestAxis < 0 || nodeMeasure <= 0.0)
+    {
+    return (numCells <= maxCellsPerLeaf ? begin : begin + numCells / 2);
+    }
+  // A traversal step costs as much as a cell test.
+  if (numCells <= maxCellsPerLeaf &&
+      1.0 + bestCost / nodeMeasure >= static_cast<double>(numCells))
+    {
+    return begin;
+    }
+  BVHPrimitive *middle =
+    std::partition(primitives + begin, primitives + end,
+                   BVHInFirstChild(map, bestAxis, bestBin));
+  return static_cast<vtkIdType>(middle - primitives);
+}
+
+// Build a subtree serially, into its own array of nodes.
+class BVHSubtreeBuilder
+{
+public:
+  BVHPrimitive *Primitives;
+  int MaxCellsPerLeaf;
+  std::vector<vtkBVHNode> Nodes;
+
+  void Build(vtkIdType begin, vtkIdType end, int depth)
+    {
+    this->Nodes.resize(1);
+    this->BuildNode(0, begin, end, depth);
+    }
+
+private:
+  void BuildNode(vtkIdType nodeId, vtkIdType begin, vtkIdType end, int depth)
+    {
+    double centerBounds[6];
+    double *bounds = this->Nodes[nodeId].Bounds;
+    InitializeBounds(bounds);
+    InitializeBounds(centerBounds);
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      AddBounds(bounds, this->Primitives[i].Bounds);
+      AddPoint(centerBounds, this->Primitives[i].Center);
+      }
+    vtkIdType middle = SplitNode(this->Primitives, begin, end, bounds,
+                                 centerBounds, this->MaxCellsPerLeaf, depth,
+                                 false);
+    if (middle == begin)
+      {
+      this->Nodes[nodeId].Offset = begin;
+      this->Nodes[nodeId].NumberOfCells = end - begin;
+      return;
+      }
+    // Note: resizing invalidates the bounds pointer.
+    vtkIdType child = static_cast<vtkIdType>(this->Nodes.size());
+    this->Nodes.resize(child + 2);
+    this->Nodes[nodeId].Offset = child;
+    this->Nodes[nodeId].NumberOfCells = 0;
+    this->BuildNode(child, begin, middle, depth + 1);
+    this->BuildNode(child + 1, middle, end, depth + 1);
+    }
+};
+
+// A node whose subtree remains to be built.
+struct BVHTask
+{
+  vtkIdType NodeId;
+  vtkIdType Begin;
+  vtkIdType End;
+  int Depth;
+};
+
+// Build the subtrees of the tasks in parallel.
+struct BVHBuildSubtrees
+{
+  BVHPrimitive *Primitives;
+  int MaxCellsPerLeaf;
+  const std::vector<BVHTask> &Tasks;
+  std::vector<std::vector<vtkBVHNode> > &Subtrees;
+
+  BVHBuildSubtrees(BVHPrimitive *primitives, int maxCellsPerLeaf,
+                   const std::vector<BVHTask> &tasks,
+                   std::vector<std::vector<vtkBVHNode> > &subtrees) :
+    Primitives(primitives), MaxCellsPerLeaf(maxCellsPerLeaf), Tasks(tasks),
+    Subtrees(subtrees)
+    {
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+    {
+    BVHSubtreeBuilder builder;
+    builder.Primitives = this->Primitives;
+    builder.MaxCellsPerLeaf = this->MaxCellsPerLeaf;
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      const BVHTask &task = this->Tasks[i];
+      builder.Build(task.Begin, task.End, task.Depth);
+      this->Subtrees[i].swap(builder.Nodes);
+      }
+    }
+};
+}
+
+//-----------------------------------------------------------------------------
+// The hierarchy, and the cells of its leaves with their bounds.
+class vtkBVHTree
+{
+public:
+  vtkDataSet *DataSet;
+  std::vector<vtkBVHNode> Nodes;
+  std::vector<vtkIdType> CellIds; // in leaf order
+  std::vector<double> CellBounds; // 6 per cell, in leaf order
+  int MaxCellSize;
+  double Padding; // enlarges the boxes to absorb roundoff
+
+  vtkBVHTree(vtkDataSet *dataSet) :
+    DataSet(dataSet), MaxCellSize(0), Padding(0.0)
+    {
+    }
+
+  void Build(int maxCellsPerLeaf, bool threaded);
+
+  int IntersectWithLine(const double a0[3], const double a1[3], double tol,
+                        double &t, double x[3], double pcoords[3],
+                        int &subId, vtkIdType &cellId,
+                        vtkGenericCell *cell) const;
+  void IntersectWithLineAll(const double a0[3], const double a1[3],
+                            std::vector<BVHHit> &hits,
+                            vtkGenericCell *cell) const;
+  int FindClosestPoint(const double x[3], double maxDist2,
+                       double closestPoint[3], vtkGenericCell *cell,
+                       vtkIdType &cellId, int &subId, double &dist2,
+                       int &inside) const;
+  vtkIdType FindCell(const double x[3], vtkGenericCell *cell,
+                     double pcoords[3], double *weights) const;
+  void FindCellsWithinBounds(const double bbox[6], vtkIdList *cells) const;
+  void FindCellsAlongLine(const double a0[3], const double a1[3],
+                          double tol, vtkIdList *cells) const;
+};
+
+//-----------------------------------------------------------------------------
+void vtkBVHTree::Build(int maxCellsPerLeaf, bool threaded)
+{
+  vtkIdType numCells = this->DataSet->GetNumberOfCells();
+  std::vector<BVHPrimitive> primitives(numCells);
+  BVHCellBounds cellBounds(this->DataSet, numCells ? &primitives[0] : NULL);
+  ExecuteRange(0, numCells, threaded, cellBounds);
+  this->MaxCellSize = this->DataSet->GetMaxCellSize();
+  primitives.erase(std::remove_if(primitives.begin(), primitives.end(),
+                                  BVHHasNoCell()), primitives.end());
+  vtkIdType numPrimitives = static_cast<vtkIdType>(primitives.size());
+  if (numPrimitives == 0)
+    {
+    return;
+    }
+  BVHPrimitive *prims = &primitives[0];
+
+  // Split the large nodes from this thread.
+  std::vector<BVHTask> pending, tasks;
+  BVHTask root = { 0, 0, numPrimitives, 0 };
+  pending.push_back(root);
+  this->Nodes.resize(1);
+  while (!pending.empty())
+    {
+    BVHTask task = pending.back();
+    pending.pop_back();
+    if (task.End - task.Begin <= VTK_BVH_SUBTREE_SIZE)
+      {
+      tasks.push_back(task);
+      continue;
+      }
+    BVHRangeBounds rangeBounds(prims + task.Begin);
+    ExecuteRange(0, task.End - task.Begin, true, rangeBounds);
+    std::copy(rangeBounds.Result.Bounds, rangeBounds.Result.Bounds + 6,
+              this->Nodes[task.NodeId].Bounds);
+    vtkIdType middle = SplitNode(prims, task.Begin, task.End,
+                                 rangeBounds.Result.Bounds,
+                                 rangeBounds.Result.CenterBounds,
+                                 maxCellsPerLeaf, task.Depth, true);
+    if (middle == task.Begin)
+      {
+      this->Nodes[task.NodeId].Offset = task.Begin;
+      this->Nodes[task.NodeId].NumberOfCells = task.End - task.Begin;
+      continue;
+      }
+    vtkIdType child = static_cast<vtkIdType>(this->Nodes.size());
+    this->Nodes.resize(child + 2);
+    this->Nodes[task.NodeId].Offset = child;
+    this->Nodes[task.NodeId].NumberOfCells = 0;
+    BVHTask second = { child + 1, middle, task.End, task.Depth + 1 };
+    BVHTask first = { child, task.Begin, middle, task.Depth + 1 };
+    pending.push_back(second);
+    pending.push_back(first);
+    }
+
+  // Build the subtrees in parallel, and append them.
+  vtkIdType numTasks = static_cast<vtkIdType>(tasks.size());
+  std::vector<std::vector<vtkBVHNode> > subtrees(numTasks);
+  BVHBuildSubtrees buildSubtrees(prims, maxCellsPerLeaf, tasks, subtrees);
+  vtkSMPTools::For(0, numTasks, 1, buildSubtrees);
+  for (vtkIdType i = 0; i < numTasks; ++i)
+    {
+    std::vector<vtkBVHNode> &subtree = subtrees[i];
+    vtkIdType shift = static_cast<vtkIdType>(this->Nodes.size()) - 1;
+    for (size_t j = 0; j < subtree.size(); ++j)
+      {
+      if (subtree[j].NumberOfCells == 0)
+        {
+        subtree[j].Offset += shift;
+        }
+      }
+    this->Nodes[tasks[i].NodeId] = subtree[0];
+    this->Nodes.insert(this->Nodes.end(), subtree.begin() + 1, subtree.end());
+    std::vector<vtkBVHNode>().swap(subtree);
+    }
+
+  // Store the cells in leaf order.
+  this->CellIds.resize(numPrimitives);
+  this->CellBounds.resize(6 * numPrimitives);
+  for (vtkIdType i = 0; i < numPrimitives; ++i)
+    {
+    this->CellIds[i] = prims[i].CellId;
+    std::copy(prims[i].Bounds, prims[i].Bounds + 6, &this->CellBounds[6*i]);
+    }
+  double size = 0.0;
+  for (int i = 0; i < 6; ++i)
+    {
+    size = std::max(size, fabs(this->Nodes[0].Bounds[i]));
+    }
+  this->Padding = 1.0e-10 * size;
+}
+
+//-----------------------------------------------------------------------------
+int vtkBVHTree::IntersectWithLine(const double a0[3], const double a1[3],
+                                  double tol, double &t, double x[3],
+                                  double pcoords[3], int &subId,
+                                  vtkIdType &cellId,
+                                  vtkGenericCell *cell) const
+{
+  if (this->Nodes.empty())
+    {
+    return 0;
+    }
+  double p1[3] = { a0[0], a0[1], a0[2] };
+  double p2[3] = { a1[0], a1[1], a1[2] };
+  BVHSegment segment(a0, a1, tol + this->Padding);
+
+  // Intersections closer than tol along the line are ranked by their
+  // parametric distance to their cell.
+  double length = sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
+  double deltaT = (length > 0.0 ? tol / length : 0.0);
+  double bestT = VTK_DOUBLE_MAX, bestPDistance = VTK_DOUBLE_MAX;
+  vtkIdType bestCellId = -1, currentCellId = -1;
+  double tCell, xCell[3], pcoordsCell[3];
+  int subIdCell;
+
+  vtkIdType stack[VTK_BVH_STACK_SIZE];
+  double stackT[VTK_BVH_STACK_SIZE];
+  int top = 0;
+  if (segment.Intersect(this->Nodes[0].Bounds, stackT[0]))
+    {
+    stack[top++] = 0;
+    }
+  while (top > 0)
+    {
+    --top;
+    if (stackT[top] > bestT + deltaT)
+      {
+      continue;
+      }
+    const vtkBVHNode &node = this->Nodes[stack[top]];
+    if (node.NumberOfCells == 0)
+      {
+      // Visit the nearest child first.
+      double t0, t1;
+      bool hit0 = segment.Intersect(this->Nodes[node.Offset].Bounds, t0);
+      bool hit1 = segment.Intersect(this->Nodes[node.Offset+1].Bounds, t1);
+      if (hit0 && hit1 && t0 <= t1)
+        {
+        stack[top] = node.Offset + 1;
+        stackT[top++] = t1;
+        stack[top] = node.Offset;
+        stackT[top++] = t0;
+        }
+      else
+        {
+        if (hit0)
+          {
+          stack[top] = node.Offset;
+          stackT[top++] = t0;
+          }
+        if (hit1)
+          {
+          stack[top] = node.Offset + 1;
+          stackT[top++] = t1;
+          }
+        }
+      continue;
+      }
+    vtkIdType last = node.Offset + node.NumberOfCells;
+    for (vtkIdType i = node.Offset; i < last; ++i)
+      {
+      double tEnter;
+      if (!segment.Intersect(&this->CellBounds[6*i], tEnter) ||
+          tEnter > bestT + deltaT)
+        {
+        continue;
+        }
+      this->DataSet->GetCell(this->CellIds[i], cell);
+      currentCellId = this->CellIds[i];
+      if (!cell->IntersectWithLine(p1, p2, tol, tCell, xCell, pcoordsCell,
+                                   subIdCell))
+        {
+        continue;
+        }
+      double pDistance = cell->GetParametricDistance(pcoordsCell);
+      if (tCell < bestT - deltaT ||
+          (tCell <= bestT + deltaT &&
+           (pDistance < bestPDistance ||
+            (pDistance == bestPDistance && tCell < bestT))))
+        {
+        bestT = tCell;
+        bestPDistance = pDistance;
+        bestCellId = currentCellId;
+        t = tCell;
+        subId = subIdCell;
+        for (int j = 0; j < 3; ++j)
+          {
+          x[j] = xCell[j];
+          pcoords[j] = pcoordsCell[j];
+          }
+        }
+      }
+    }
+
+  if (bestCellId < 0)
+    {
+    return 0;
+    }
+  if (currentCellId != bestCellId)
+    {
+    this->DataSet->GetCell(bestCellId, cell);
+    }
+  cellId = bestCellId;
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHTree::IntersectWithLineAll(const double a0[3], const double a1[3],
+                                      std::vector<BVHHit> &hits,
+                                      vtkGenericCell *cell) const
+{
+  hits.clear();
+  if (this->Nodes.empty())
+    {
+    return;
+    }
+  double p1[3] = { a0[0], a0[1], a0[2] };
+  double p2[3] = { a1[0], a1[1], a1[2] };
+  BVHSegment segment(a0, a1, this->Padding);
+  double pcoords[3], tEnter;
+  int subId;
+  BVHHit hit;
+
+  vtkIdType stack[VTK_BVH_STACK_SIZE];
+  int top = 0;
+  if (segment.Intersect(this->Nodes[0].Bounds, tEnter))
+    {
+    stack[top++] = 0;
+    }
+  while (top > 0)
+    {
+    const vtkBVHNode &node = this->Nodes[stack[--top]];
+    if (node.NumberOfCells == 0)
+      {
+      for (vtkIdType child = node.Offset; child < node.Offset + 2; ++child)
+        {
+        if (segment.Intersect(this->Nodes[child].Bounds, tEnter))
+          {
+          stack[top++] = child;
+          }
+        }
+      continue;
+      }
+    vtkIdType last = node.Offset + node.NumberOfCells;
+    for (vtkIdType i = node.Offset; i < last; ++i)
+      {
+      if (!segment.Intersect(&this->CellBounds[6*i], tEnter))
+        {
+        continue;
+        }
+      this->DataSet->GetCell(this->CellIds[i], cell);
+      if (cell->IntersectWithLine(p1, p2, 0.0, hit.T, hit.X, pcoords, subId))
+        {
+        hit.CellId = this->CellIds[i];
+        hits.push_back(hit);
+        }
+      }
+    }
+  std::sort(hits.begin(), hits.end());
+}
+
+//-----------------------------------------------------------------------------
+int vtkBVHTree::FindClosestPoint(const double x[3], double maxDist2,
+                                 double closestPoint[3], vtkGenericCell *cell,
+                                 vtkIdType &cellId, int &subId, double &dist2,
+                                 int &inside) const
+{
+  if (this->Nodes.empty())
+    {
+    return 0;
+    }
+  double point[3] = { x[0], x[1], x[2] };
+  BVHWeights weights(this->MaxCellSize);
+  double bestDist2 = maxDist2;
+  vtkIdType bestCellId = -1, currentCellId = -1;
+  double cellPoint[3], pcoords[3], cellDist2;
+  int cellSubId;
+
+  vtkIdType stack[VTK_BVH_STACK_SIZE];
+  double stackDist2[VTK_BVH_STACK_SIZE];
+  int top = 0;
+  stack[0] = 0;
+  stackDist2[top++] = Distance2ToBounds(x, this->Nodes[0].Bounds);
+  while (top > 0)
+    {
+    --top;
+    if (stackDist2[top] >= bestDist2)
+      {
+      continue;
+      }
+    const vtkBVHNode &node = this->Nodes[stack[top]];
+    if (node.NumberOfCells == 0)
+      {
+      // Visit the nearest child first.
+      double d0 = Distance2ToBounds(x, this->Nodes[node.Offset].Bounds);
+      double d1 = Distance2ToBounds(x, this->Nodes[node.Offset+1].Bounds);
+      int first = (d0 <= d1 ? 0 : 1);
+      double d[2] = { d0, d1 };
+      if (d[1-first] < bestDist2)
+        {
+        stack[top] = node.Offset + 1 - first;
+        stackDist2[top++] = d[1-first];
+        }
+      if (d[first] < bestDist2)
+        {
+        stack[top] = node.Offset + first;
+        stackDist2[top++] = d[first];
+        }
+      continue;
+      }
+    vtkIdType last = node.Offset + node.NumberOfCells;
+    for (vtkIdType i = node.Offset; i < last; ++i)
+      {
+      if (Distance2ToBounds(x, &this->CellBounds[6*i]) >= bestDist2)
+        {
+        continue;
+        }
+      this->DataSet->GetCell(this->CellIds[i], cell);
+      currentCellId = this->CellIds[i];
+      int status = cell->EvaluatePosition(point, cellPoint, cellSubId,
+                                          pcoords, cellDist2, weights.Data);
+      if (status != -1 && cellDist2 < bestDist2)
+        {
+        bestDist2 = cellDist2;
+        bestCellId = currentCellId;
+        subId = cellSubId;
+        inside = status;
+        closestPoint[0] = cellPoint[0];
+        closestPoint[1] = cellPoint[1];
+        closestPoint[2] = cellPoint[2];
+        }
+      }
+    }
+
+  if (bestCellId < 0)
+    {
+    return 0;
+    }
+  if (currentCellId != bestCellId)
+    {
+    this->DataSet->GetCell(bestCellId, cell);
+    }
+  cellId = bestCellId;
+  dist2 = bestDist2;
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkBVHTree::FindCell(const double x[3], vtkGenericCell *cell,
+                               double pcoords[3], double *weights) const
+{
+  if (this->Nodes.empty() ||
+      !InsideBounds(x, this->Nodes[0].Bounds, this->Padding))
+    {
+    return -1;
+    }
+  double point[3] = { x[0], x[1], x[2] };
+  double dist2;
+  int subId;
+
+  vtkIdType stack[VTK_BVH_STACK_SIZE];
+  int top = 0;
+  stack[top++] = 0;
+  while (top > 0)
+    {
+    const vtkBVHNode &node = this->Nodes[stack[--top]];
+    if (node.NumberOfCells == 0)
+      {
+      for (vtkIdType child = node.Offset + 1; child >= node.Offset; --child)
+        {
+        if (InsideBounds(x, this->Nodes[child].Bounds, this->Padding))
+          {
+          stack[top++] = child;
+          }
+        }
+      continue;
+      }
+    vtkIdType last = node.Offset + node.NumberOfCells;
+    for (vtkIdType i = node.Offset; i < last; ++i)
+      {
+      if (InsideBounds(x, &this->CellBounds[6*i], this->Padding))
+        {
+        this->DataSet->GetCell(this->CellIds[i], cell);
+        if (cell->EvaluatePosition(point, NULL, subId, pcoords, dist2,
+                                   weights) == 1)
+          {
+          return this->CellIds[i];
+          }
+        }
+      }
+    }
+  return -1;
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHTree::FindCellsWithinBounds(const double bbox[6],
+                                       vtkIdList *cells) const
+{
+  if (this->Nodes.empty() || !OverlapBounds(this->Nodes[0].Bounds, bbox, 0.0))
+    {
+    return;
+    }
+  vtkIdType stack[VTK_BVH_STACK_SIZE];
+  int top = 0;
+  stack[top++] = 0;
+  while (top > 0)
+    {
+    const vtkBVHNode &node = this->Nodes[stack[--top]];
+    if (node.NumberOfCells == 0)
+      {
+      for (vtkIdType child = node.Offset + 1; child >= node.Offset; --child)
+        {
+        if (OverlapBounds(this->Nodes[child].Bounds, bbox, 0.0))
+          {
+          stack[top++] = child;
+          }
+        }
+      continue;
+      }
+    vtkIdType last = node.Offset + node.NumberOfCells;
+    for (vtkIdType i = node.Offset; i < last; ++i)
+      {
+      if (OverlapBounds(&this->CellBounds[6*i], bbox, 0.0))
+        {
+        cells->InsertNextId(this->CellIds[i]);
+        }
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHTree::FindCellsAlongLine(const double a0[3], const double a1[3],
+                                    double tol, vtkIdList *cells) const
+{
+  if (this->Nodes.empty())
+    {
+    return;
+    }
+  BVHSegment segment(a0, a1, tol + this->Padding);
+  double tEnter;
+  vtkIdType stack[VTK_BVH_STACK_SIZE];
+  int top = 0;
+  if (segment.Intersect(this->Nodes[0].Bounds, tEnter))
+    {
+    stack[top++] = 0;
+    }
+  while (top > 0)
+    {
+    const vtkBVHNode &node = this->Nodes[stack[--top]];
+    if (node.NumberOfCells == 0)
+      {
+      for (vtkIdType child = node.Offset + 1; child >= node.Offset; --child)
+        {
+        if (segment.Intersect(this->Nodes[child].Bounds, tEnter))
+          {
+          stack[top++] = child;
+          }
+        }
+      continue;
+      }
+    vtkIdType last = node.Offset + node.NumberOfCells;
+    for (vtkIdType i = node.Offset; i < last; ++i)
+      {
+      if (segment.Intersect(&this->CellBounds[6*i], tEnter))
+        {
+        cells->InsertNextId(this->CellIds[i]);
+        }
+      }
+    }
+}
+
+namespace
+{
+// Intersect lines with the cells in parallel.
+struct BVHIntersectLines
+{
+  const vtkBVHTree *Tree;
+  vtkPoints *P1;
+  vtkPoints *P2;
+  double Tolerance;
+  vtkIdType *CellIds;
+  vtkPoints *Points;
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+
+  BVHIntersectLines(const vtkBVHTree *tree, vtkPoints *p1, vtkPoints *p2,
+                    double tol, vtkIdType *cellIds, vtkPoints *points) :
+    Tree(tree), P1(p1), P2(p2), Tolerance(tol), CellIds(cellIds),
+    Points(points)
+    {
+    }
+
+  void Initialize()
+    {
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    vtkGenericCell *cell = this->Cell.Local();
+    double a0[3], a1[3], t, x[3], pcoords[3];
+    int subId;
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->P1->GetPoint(i, a0);
+      this->P2->GetPoint(i, a1);
+      if (!this->Tree->IntersectWithLine(a0, a1, this->Tolerance, t, x,
+                                         pcoords, subId, this->CellIds[i],
+                                         cell))
+        {
+        this->CellIds[i] = -1;
+        x[0] = a1[0];
+        x[1] = a1[1];
+        x[2] = a1[2];
+        }
+      if (this->Points)
+        {
+        this->Points->SetPoint(i, x);
+        }
+      }
+    }
+
+  void Reduce()
+    {
+    }
+};
+
+// Find the closest cells to points in parallel.
+struct BVHFindClosestPoints
+{
+  const vtkBVHTree *Tree;
+  vtkPoints *Points;
+  vtkIdType *CellIds;
+  vtkPoints *ClosestPoints;
+  double *Distances2;
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+
+  BVHFindClosestPoints(const vtkBVHTree *tree, vtkPoints *points,
+                       vtkIdType *cellIds, vtkPoints *closestPoints,
+                       double *distances2) :
+    Tree(tree), Points(points), CellIds(cellIds),
+    ClosestPoints(closestPoints), Distances2(distances2)
+    {
+    }
+
+  void Initialize()
+    {
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    vtkGenericCell *cell = this->Cell.Local();
+    double x[3], closestPoint[3], dist2;
+    int subId, inside;
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Points->GetPoint(i, x);
+      if (!this->Tree->FindClosestPoint(x, VTK_DOUBLE_MAX, closestPoint, cell,
+                                        this->CellIds[i], subId, dist2,
+                                        inside))
+        {
+        this->CellIds[i] = -1;
+        closestPoint[0] = x[0];
+        closestPoint[1] = x[1];
+        closestPoint[2] = x[2];
+        dist2 = VTK_DOUBLE_MAX;
+        }
+      if (this->ClosestPoints)
+        {
+        this->ClosestPoints->SetPoint(i, closestPoint);
+        }
+      if (this->Distances2)
+        {
+        this->Distances2[i] = dist2;
+        }
+      }
+    }
+
+  void Reduce()
+    {
+    }
+};
+}
+
+//-----------------------------------------------------------------------------
+vtkBVHCellLocator::vtkBVHCellLocator()
+{
+  this->NumberOfCellsPerNode = 8;
+  this->Tree = NULL;
+}
+
+//-----------------------------------------------------------------------------
+vtkBVHCellLocator::~vtkBVHCellLocator()
+{
+  this->FreeSearchStructure();
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::FreeSearchStructure()
+{
+  delete this->Tree;
+  this->Tree = NULL;
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::BuildLocator()
+{
+  if (this->LazyEvaluation)
+    {
+    return;
+    }
+  this->ForceBuildLocator();
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::BuildLocatorIfNeeded()
+{
+  if (this->LazyEvaluation)
+    {
+    if (!this->Tree || (this->MTime > this->BuildTime))
+      {
+      this->Modified();
+      vtkDebugMacro(<< "Forcing BuildLocator");
+      this->ForceBuildLocator();
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::ForceBuildLocator()
+{
+  // Don't rebuild if build time is newer than modified and dataset modified
+  // time.
+  if (this->Tree && this->BuildTime > this->MTime &&
+      this->BuildTime > this->DataSet->GetMTime())
+    {
+    return;
+    }
+  // Don't rebuild if UseExistingSearchStructure is ON and a tree exists.
+  if (this->Tree && this->UseExistingSearchStructure)
+    {
+    this->BuildTime.Modified();
+    vtkDebugMacro(<< "BuildLocator exited - UseExistingSearchStructure");
+    return;
+    }
+  this->BuildLocatorInternal();
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::BuildLocatorInternal()
+{
+  this->FreeSearchStructure();
+  if (!this->DataSet)
+    {
+    vtkErrorMacro(<< "No dataset to build the locator from");
+    return;
+    }
+
+  vtkDebugMacro(<< "Building the hierarchy of "
+                << this->DataSet->GetNumberOfCells() << " cells");
+
+  // Build, from this thread, what the dataset builds on demand.
+  if (this->DataSet->GetNumberOfCells() > 0)
+    {
+    this->DataSet->GetCell(0, this->GenericCell);
+    }
+  this->Tree = new vtkBVHTree(this->DataSet);
+  this->Tree->Build(this->NumberOfCellsPerNode,
+                    CanAccessConcurrently(this->DataSet));
+  this->BuildTime.Modified();
+}
+
+//-----------------------------------------------------------------------------
+int vtkBVHCellLocator::IntersectWithLine(double a0[3], double a1[3],
+                                         double tol, double& t, double x[3],
+                                         double pcoords[3], int &subId,
+                                         vtkIdType &cellId,
+                                         vtkGenericCell *cell)
+{
+  this->BuildLocatorIfNeeded();
+  cellId = -1;
+  if (!this->Tree)
+    {
+    return 0;
+    }
+  return this->Tree->IntersectWithLine(a0, a1, tol, t, x, pcoords, subId,
+                                       cellId, cell);
+}
+
+//-----------------------------------------------------------------------------
+int vtkBVHCellLocator::IntersectWithLine(const double p1[3],
+                                         const double p2[3],
+                                         vtkPoints *points,
+                                         vtkIdList *cellIds)
+{
+  this->BuildLocatorIfNeeded();
+  if (points)
+    {
+    points->Reset();
+    }
+  if (cellIds)
+    {
+    cellIds->Reset();
+    }
+  if (!this->Tree)
+    {
+    return 0;
+    }
+  std::vector<BVHHit> hits;
+  this->Tree->IntersectWithLineAll(p1, p2, hits, this->GenericCell);
+  for (size_t i = 0; i < hits.size(); ++i)
+    {
+    if (points)
+      {
+      points->InsertNextPoint(hits[i].X);
+      }
+    if (cellIds)
+      {
+      cellIds->InsertNextId(hits[i].CellId);
+      }
+    }
+  return hits.empty() ? 0 : 1;
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::FindClosestPoint(double x[3], double closestPoint[3],
+                                         vtkGenericCell *cell,
+                                         vtkIdType &cellId, int &subId,
+                                         double& dist2)
+{
+  this->BuildLocatorIfNeeded();
+  int inside;
+  cellId = -1;
+  subId = -1;
+  dist2 = VTK_DOUBLE_MAX;
+  if (this->Tree)
+    {
+    this->Tree->FindClosestPoint(x, VTK_DOUBLE_MAX, closestPoint, cell,
+                                 cellId, subId, dist2, inside);
+    }
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkBVHCellLocator::FindClosestPointWithinRadius(
+  double x[3], double radius, double closestPoint[3], vtkGenericCell *cell,
+  vtkIdType &cellId, int &subId, double& dist2, int &inside)
+{
+  this->BuildLocatorIfNeeded();
+  cellId = -1;
+  if (!this->Tree)
+    {
+    return 0;
+    }
+  return this->Tree->FindClosestPoint(x, radius * radius, closestPoint, cell,
+                                      cellId, subId, dist2, inside);
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkBVHCellLocator::FindCell(double x[3], double vtkNotUsed(tol2),
+                                      vtkGenericCell *cell,
+                                      double pcoords[3], double *weights)
+{
+  this->BuildLocatorIfNeeded();
+  if (!this->Tree)
+    {
+    return -1;
+    }
+  return this->Tree->FindCell(x, cell, pcoords, weights);
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::FindCellsWithinBounds(double *bbox, vtkIdList *cells)
+{
+  this->BuildLocatorIfNeeded();
+  cells->Reset();
+  if (this->Tree)
+    {
+    this->Tree->FindCellsWithinBounds(bbox, cells);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::FindCellsAlongLine(double p1[3], double p2[3],
+                                           double tolerance, vtkIdList *cells)
+{
+  this->BuildLocatorIfNeeded();
+  cells->Reset();
+  if (this->Tree)
+    {
+    this->Tree->FindCellsAlongLine(p1, p2, tolerance, cells);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::IntersectWithLines(vtkPoints *p1, vtkPoints *p2,
+                                           double tol, vtkIdList *cellIds,
+                                           vtkPoints *points)
+{
+  vtkIdType numLines = p1->GetNumberOfPoints();
+  if (p2->GetNumberOfPoints() != numLines)
+    {
+    vtkErrorMacro(<< "The lines must have as many end points as start points");
+    return;
+    }
+  cellIds->SetNumberOfIds(numLines);
+  if (points)
+    {
+    points->SetNumberOfPoints(numLines);
+    }
+  this->BuildLocatorIfNeeded();
+  if (!this->Tree)
+    {
+    this->BuildLocator();
+    }
+  if (!this->Tree || numLines == 0)
+    {
+    for (vtkIdType i = 0; i < numLines; ++i)
+      {
+      cellIds->SetId(i, -1);
+      if (points)
+        {
+        points->SetPoint(i, p2->GetPoint(i));
+        }
+      }
+    return;
+    }
+
+  BVHIntersectLines intersect(this->Tree, p1, p2, tol, cellIds->GetPointer(0),
+                              points);
+  ExecuteRange(0, numLines, CanAccessConcurrently(this->DataSet), intersect);
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::FindClosestPoints(vtkPoints *points,
+                                          vtkIdList *cellIds,
+                                          vtkPoints *closestPoints,
+                                          vtkDoubleArray *distances2)
+{
+  vtkIdType numPts = points->GetNumberOfPoints();
+  cellIds->SetNumberOfIds(numPts);
+  if (closestPoints)
+    {
+    closestPoints->SetNumberOfPoints(numPts);
+    }
+  if (distances2)
+    {
+    distances2->SetNumberOfComponents(1);
+    distances2->SetNumberOfTuples(numPts);
+    }
+  this->BuildLocatorIfNeeded();
+  if (!this->Tree)
+    {
+    this->BuildLocator();
+    }
+  if (!this->Tree || numPts == 0)
+    {
+    for (vtkIdType i = 0; i < numPts; ++i)
+      {
+      cellIds->SetId(i, -1);
+      if (closestPoints)
+        {
+        closestPoints->SetPoint(i, points->GetPoint(i));
+        }
+      if (distances2)
+        {
+        distances2->SetValue(i, VTK_DOUBLE_MAX);
+        }
+      }
+    return;
+    }
+
+  BVHFindClosestPoints find(this->Tree, points, cellIds->GetPointer(0),
+                            closestPoints,
+                            distances2 ? distances2->GetPointer(0) : NULL);
+  ExecuteRange(0, numPts, CanAccessConcurrently(this->DataSet), find);
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkBVHCellLocator::GetNumberOfNodes()
+{
+  return this->Tree ? static_cast<vtkIdType>(this->Tree->Nodes.size()) : 0;
+}
+
+//-----------------------------------------------------------------------------
+// Represent the boxes of the nodes at the given depth, and of the leaves
+// above it.
+void vtkBVHCellLocator::GenerateRepresentation(int level, vtkPolyData *pd)
+{
+  if (!this->Tree || this->Tree->Nodes.empty())
+    {
+    vtkWarningMacro(<< "No hierarchy to represent");
+    return;
+    }
+
+  vtkPoints *pts = vtkPoints::New();
+  vtkCellArray *polys = vtkCellArray::New();
+  static const vtkIdType faces[6][4] = {
+    { 0, 2, 6, 4 }, { 1, 5, 7, 3 }, { 0, 4, 5, 1 },
+    { 2, 3, 7, 6 }, { 0, 1, 3, 2 }, { 4, 6, 7, 5 } };
+
+  std::vector<std::pair<vtkIdType, int> > stack(1, std::make_pair(0, 0));
+  while (!stack.empty())
+    {
+    vtkIdType nodeId = stack.back().first;
+    int depth = stack.back().second;
+    stack.pop_back();
+    const vtkBVHNode &node = this->Tree->Nodes[nodeId];
+    if (node.NumberOfCells == 0 && depth < level)
+      {
+      stack.push_back(std::make_pair(node.Offset + 1, depth + 1));
+      stack.push_back(std::make_pair(node.Offset, depth + 1));
+      continue;
+      }
+    vtkIdType first = pts->GetNumberOfPoints();
+    for (int k = 0; k < 2; ++k)
+      {
+      for (int j = 0; j < 2; ++j)
+        {
+        for (int i = 0; i < 2; ++i)
+          {
+          pts->InsertNextPoint(node.Bounds[i], node.Bounds[2+j],
+                               node.Bounds[4+k]);
+          }
+        }
+      }
+    for (int f = 0; f < 6; ++f)
+      {
+      vtkIdType quad[4];
+      for (int i = 0; i < 4; ++i)
+        {
+        quad[i] = first + faces[f][i];
+        }
+      polys->InsertNextCell(4, quad);
+      }
+    }
+
+  pd->SetPoints(pts);
+  pts->Delete();
+  pd->SetPolys(polys);
+  polys->Delete();
+  pd->Squeeze();
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number Of Nodes: " << this->GetNumberOfNodes() << "\n";
+}
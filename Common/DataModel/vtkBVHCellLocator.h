@@ -0,0 +1,182 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBVHCellLocator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkBVHCellLocator - threaded bounding volume hierarchy to locate cells
+// .SECTION Description
+// vtkBVHCellLocator is a spatial search object to quickly locate cells in
+// 3D. It organizes the cells of a dataset in a bounding volume hierarchy
+// (BVH): a binary tree of axis-aligned boxes, each box bounding the cells
+// of its subtree, whose leaves hold at most NumberOfCellsPerNode cells
+// (unless the cells cannot be separated). The cells of a node are split
+// with the surface area heuristic (SAH), evaluated over the cell centers
+// gathered in a few bins along each axis.
+//
+// The hierarchy is built with vtkSMPTools: the cell bounds, the binning of
+// the large nodes at the top of the tree, and the subtrees below them are
+// computed in parallel. The nodes are stored in a single flat array, the
+// two children of a node next to each other and each subtree built in
+// parallel contiguously, and the cells of each leaf are stored contiguously
+// together with their bounds. The cell bounds are thus always kept, and
+// CacheCellBounds is ignored.
+//
+// Once the locator has been built from a single thread (BuildLocator()),
+// the queries taking a vtkGenericCell only read the hierarchy and are
+// thread safe, provided each thread uses its own cell. The batched queries
+// IntersectWithLines() and FindClosestPoints() answer a whole array of
+// queries this way with vtkSMPTools.
+
+// .SECTION Caveats
+// The hierarchy is built once and is not updated incrementally: it is
+// rebuilt when the dataset is modified. Cells without points are ignored.
+//
+// The threaded construction and batched queries access the cells of the
+// dataset concurrently. For datasets other than images, rectilinear,
+// structured and unstructured grids and polydata, which are not known to
+// support it, they run serially instead.
+
+// .SECTION See Also
+// vtkAbstractCellLocator vtkCellLocator vtkStaticPointLocator vtkSMPTools
+
+#ifndef vtkBVHCellLocator_h
+#define vtkBVHCellLocator_h
+
+#include "vtkCommonDataModelModule.h" // For export macro
+#include "vtkAbstractCellLocator.h"
+
+class vtkBVHTree;
+class vtkDoubleArray;
+
+class VTKCOMMONDATAMODEL_EXPORT vtkBVHCellLocator : public vtkAbstractCellLocator
+{
+public:
+  // Description:
+  // Construct with at most 8 cells per leaf.
+  static vtkBVHCellLocator *New();
+
+  // Description:
+  // Standard type and print methods.
+  vtkTypeMacro(vtkBVHCellLocator,vtkAbstractCellLocator);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Re-use any superclass signatures that we don't override.
+  using vtkAbstractCellLocator::IntersectWithLine;
+  using vtkAbstractCellLocator::FindCell;
+  using vtkAbstractCellLocator::FindClosestPoint;
+  using vtkAbstractCellLocator::FindClosestPointWithinRadius;
+
+  // Description:
+  // Return the first intersection (if any) of the finite line (a0,a1) with
+  // the cells, and the cell intersected. Among the intersections closer
+  // than tol to each other along the line, the one nearest to the inside of
+  // its cell is returned. The cell is returned as a cell id and as a
+  // generic cell. This method is thread safe once the locator is built.
+  virtual int IntersectWithLine(double a0[3], double a1[3], double tol,
+                                double& t, double x[3], double pcoords[3],
+                                int &subId, vtkIdType &cellId,
+                                vtkGenericCell *cell);
+
+  // Description:
+  // Return all the intersections of the finite line (p1,p2) with the cells,
+  // sorted along the line, and the ids of the cells intersected. Either
+  // output may be NULL. Returns 1 if the line intersects at least one cell.
+  virtual int IntersectWithLine(const double p1[3], const double p2[3],
+                                vtkPoints *points, vtkIdList *cellIds);
+
+  // Description:
+  // Return the closest point and the cell which is closest to the point x.
+  // The closest point is somewhere on a cell, it need not be one of the
+  // vertices of the cell. If a cell is found, "cell" contains the points
+  // and ptIds for the cell "cellId" upon exit. This method is thread safe
+  // once the locator is built.
+  virtual void FindClosestPoint(
+    double x[3], double closestPoint[3],
+    vtkGenericCell *cell, vtkIdType &cellId,
+    int &subId, double& dist2);
+
+  // Description:
+  // Return the closest point within a specified radius and the cell which
+  // is closest to the point x. This method returns 1 if a point is found
+  // within the specified radius, and 0 otherwise; "inside" returns the
+  // value returned by EvaluatePosition() for the closest cell. This method
+  // is thread safe once the locator is built.
+  virtual vtkIdType FindClosestPointWithinRadius(
+    double x[3], double radius, double closestPoint[3],
+    vtkGenericCell *cell, vtkIdType &cellId,
+    int &subId, double& dist2, int &inside);
+
+  // Description:
+  // Find the cell containing a given point. Returns -1 if no cell is found.
+  // The cell parameters are copied into the supplied variables; a cell must
+  // be provided to store the information. This method is thread safe once
+  // the locator is built.
+  virtual vtkIdType FindCell(
+    double x[3], double tol2, vtkGenericCell *GenCell,
+    double pcoords[3], double *weights);
+
+  // Description:
+  // Return the ids of the cells whose bounds intersect the given bounding
+  // box. The user must provide the vtkIdList to populate.
+  virtual void FindCellsWithinBounds(double *bbox, vtkIdList *cells);
+
+  // Description:
+  // Given a finite line defined by the two points (p1,p2), return the ids
+  // of the cells whose bounds, enlarged by the tolerance, intersect the
+  // line. The user must provide the vtkIdList to populate.
+  virtual void FindCellsAlongLine(
+    double p1[3], double p2[3], double tolerance, vtkIdList *cells);
+
+  // Description:
+  // Intersect the lines going from each point of p1 to the matching point
+  // of p2 with the cells, in parallel. The id of the first cell intersected
+  // by each line (or -1) is returned in cellIds, and, if points is not
+  // NULL, the intersection point (or the end of the line when there is no
+  // intersection) in points. See IntersectWithLine() for the tolerance.
+  void IntersectWithLines(vtkPoints *p1, vtkPoints *p2, double tol,
+                          vtkIdList *cellIds, vtkPoints *points);
+
+  // Description:
+  // Find the closest cell to each of the given points, in parallel. The id
+  // of the closest cell (or -1 when there are no cells) is returned in
+  // cellIds. If they are not NULL, closestPoints and distances2 return the
+  // closest point on that cell and its squared distance to the point.
+  void FindClosestPoints(vtkPoints *points, vtkIdList *cellIds,
+                         vtkPoints *closestPoints,
+                         vtkDoubleArray *distances2);
+
+  // Description:
+  // Return the number of nodes in the hierarchy, or 0 if it is not built.
+  vtkIdType GetNumberOfNodes();
+
+  // Description:
+  // Satisfy vtkLocator abstract interface. These methods are not thread
+  // safe.
+  virtual void FreeSearchStructure();
+  virtual void BuildLocator();
+  virtual void BuildLocatorIfNeeded();
+  virtual void ForceBuildLocator();
+  virtual void BuildLocatorInternal();
+  virtual void GenerateRepresentation(int level, vtkPolyData *pd);
+
+protected:
+  vtkBVHCellLocator();
+  ~vtkBVHCellLocator();
+
+  vtkBVHTree *Tree; // The hierarchy, with the cells of its leaves
+
+private:
+  vtkBVHCellLocator(const vtkBVHCellLocator&);  // Not implemented.
+  void operator=(const vtkBVHCellLocator&);  // Not implemented.
+};
+
+#endif
@@ -13,10 +13,141 @@
 
 =========================================================================*/
 #include "vtkCellArray.h"
+
+#include "vtkArrayDispatch.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPThreadLocalObject.h"
+
+#include <algorithm>
 
 vtkStandardNewMacro(vtkCellArray);
 
+//----------------------------------------------------------------------------
+// The vtkIdType copies of the cells returned by the pointer versions of
+// GetCell() with 32-bit storage, and by GetLegacyCell() with the offsets
+// layout, one per thread.
+class vtkCellArrayTempCells
+{
+public:
+  vtkSMPThreadLocalObject<vtkIdList> Cells;
+};
+
+namespace
+{
+// Dispatch the offsets and connectivity arrays of the offsets layout, which
+// always share the same type.
+typedef vtkArrayDispatch::Dispatch2ByArrayWithSameValueType<
+  vtkCellArray::StorageArrayList, vtkCellArray::StorageArrayList>
+  StorageDispatch;
+
+// Rebuild the legacy (n,id1,...,idn) list from the offsets layout.
+struct BuildLegacyWorker
+{
+  vtkIdTypeArray *Legacy;
+  vtkIdType NumberOfCells;
+
+  template <typename ArrayT>
+  void operator()(ArrayT *offsetsArray, ArrayT *connArray)
+  {
+    typedef typename ArrayT::ValueType ValueType;
+    const ValueType *offsets = offsetsArray->GetPointer(0);
+    const ValueType *conn = connArray->GetPointer(0);
+    vtkIdType *legacy = this->Legacy->WritePointer(
+      0, this->NumberOfCells + offsets[this->NumberOfCells]);
+    for (vtkIdType i=0; i < this->NumberOfCells; i++)
+      {
+      *legacy++ = offsets[i+1] - offsets[i];
+      legacy = std::copy(conn+offsets[i], conn+offsets[i+1], legacy);
+      }
+  }
+};
+
+// Size of the largest cell of the offsets layout.
+struct MaxCellSizeWorker
+{
+  vtkIdType NumberOfCells;
+  int MaxCellSize;
+
+  template <typename ArrayT>
+  void operator()(ArrayT *offsetsArray, ArrayT *)
+  {
+    typedef typename ArrayT::ValueType ValueType;
+    const ValueType *offsets = offsetsArray->GetPointer(0);
+    int npts;
+    this->MaxCellSize = 0;
+    for (vtkIdType cellId=0; cellId < this->NumberOfCells; cellId++)
+      {
+      if ( (npts=static_cast<int>(offsets[cellId+1]-offsets[cellId])) >
+           this->MaxCellSize )
+        {
+        this->MaxCellSize = npts;
+        }
+      }
+  }
+};
+
+// Per-cell helpers working directly on the storage of the offsets layout.
+template <typename ValueType>
+vtkIdType *CopyLegacyCell(const ValueType *offsets, const ValueType *conn,
+                          vtkIdList *cell)
+{
+  vtkIdType npts = offsets[1] - offsets[0];
+  vtkIdType *block = cell->WritePointer(0, npts+1);
+  block[0] = npts;
+  std::copy(conn+offsets[0], conn+offsets[1], block+1);
+  return block;
+}
+
+template <typename ArrayT>
+void CopyCell(ArrayT *offsetsArray, ArrayT *connArray, vtkIdType cellId,
+              vtkIdList *pts)
+{
+  typedef typename ArrayT::ValueType ValueType;
+  const ValueType *offsets = offsetsArray->GetPointer(cellId);
+  const ValueType *conn = connArray->GetPointer(offsets[0]);
+  vtkIdType npts = offsets[1] - offsets[0];
+  pts->Reset();
+  std::copy(conn, conn+npts, pts->WritePointer(0, npts));
+}
+
+template <typename ArrayT>
+void ReverseCellIds(ArrayT *offsetsArray, ArrayT *connArray, vtkIdType cellId)
+{
+  typedef typename ArrayT::ValueType ValueType;
+  const ValueType *offsets = offsetsArray->GetPointer(cellId);
+  ValueType *conn = connArray->GetPointer(0);
+  std::reverse(conn+offsets[0], conn+offsets[1]);
+}
+
+template <typename ArrayT>
+void ReplaceCellIds(ArrayT *offsetsArray, ArrayT *connArray, vtkIdType cellId,
+                    int npts, const vtkIdType *pts)
+{
+  typedef typename ArrayT::ValueType ValueType;
+  ValueType *conn =
+    connArray->GetPointer(0) + offsetsArray->GetValue(cellId);
+  for (int i=0; i < npts; i++)
+    {
+    conn[i] = static_cast<ValueType>(pts[i]);
+    }
+}
+
+template <typename ArrayT>
+void ReplaceCellPointId(ArrayT *offsetsArray, ArrayT *connArray,
+                        vtkIdType cellId, vtkIdType oldPtId, vtkIdType newPtId)
+{
+  typedef typename ArrayT::ValueType ValueType;
+  const ValueType *offsets = offsetsArray->GetPointer(cellId);
+  ValueType *conn = connArray->GetPointer(0);
+  ValueType *pt = std::find(conn+offsets[0], conn+offsets[1],
+                            static_cast<ValueType>(oldPtId));
+  if ( pt != conn+offsets[1] )
+    {
+    *pt = static_cast<ValueType>(newPtId);
+    }
+}
+}
+
 //----------------------------------------------------------------------------
 vtkCellArray::vtkCellArray()
 {
@@ -24,6 +155,11 @@ vtkCellArray::vtkCellArray()
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+  this->StorageLayout = vtkCellArray::LEGACY_LAYOUT;
+  this->Offsets = NULL;
+  this->Connectivity = NULL;
+  this->Storage32Bit = 0;
+  this->TempCells = NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -35,7 +171,25 @@ void vtkCellArray::DeepCopy (vtkCellArray *ca)
     return;
     }
 
-  this->Ia->DeepCopy(ca->Ia);
+  this->Reset();
+  if ( ca->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    // keep the storage type of the source
+    vtkDataArray *offsets = ca->Offsets->NewInstance();
+    offsets->DeepCopy(ca->Offsets);
+    vtkDataArray *conn = ca->Connectivity->NewInstance();
+    conn->DeepCopy(ca->Connectivity);
+    this->SetStorageArrays(offsets, conn);
+    offsets->Delete();
+    conn->Delete();
+    this->StorageLayout = vtkCellArray::OFFSETS_LAYOUT;
+    this->Ia->Initialize();
+    }
+  else
+    {
+    this->SetStorageLayoutToLegacy();
+    this->Ia->DeepCopy(ca->Ia);
+    }
   this->NumberOfCells = ca->NumberOfCells;
   this->InsertLocation = ca->InsertLocation;
   this->TraversalLocation = ca->TraversalLocation;
@@ -45,6 +199,15 @@ void vtkCellArray::DeepCopy (vtkCellArray *ca)
 vtkCellArray::~vtkCellArray()
 {
   this->Ia->Delete();
+  if ( this->Offsets )
+    {
+    this->Offsets->Delete();
+    }
+  if ( this->Connectivity )
+    {
+    this->Connectivity->Delete();
+    }
+  delete this->TempCells;
 }
 
 //----------------------------------------------------------------------------
@@ -54,6 +217,263 @@ void vtkCellArray::Initialize()
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    this->Connectivity->Initialize();
+    this->Offsets->Initialize();
+    this->Offsets->InsertNextTuple1(0);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetStorageLayout(int layout)
+{
+  layout = (layout == vtkCellArray::OFFSETS_LAYOUT ?
+            vtkCellArray::OFFSETS_LAYOUT : vtkCellArray::LEGACY_LAYOUT);
+  if ( layout == this->StorageLayout )
+    {
+    return;
+    }
+
+  vtkDebugMacro(<< "Switching to the "
+                << (layout == vtkCellArray::OFFSETS_LAYOUT ? "offsets" :
+                    "legacy") << " layout");
+  vtkIdType i, npts;
+  if ( layout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    // Split the legacy (n,id1,...,idn) list into offsets and connectivity.
+    // The number of cells is taken from the list itself.
+    vtkIdType numEntries = this->Ia->GetMaxId() + 1;
+    const vtkIdType *legacy = this->Ia->GetPointer(0);
+    vtkIdType numCells = 0;
+    for (i=0; i < numEntries; i += legacy[i] + 1)
+      {
+      numCells++;
+      }
+
+    vtkIdTypeArray *offsetsArray = vtkIdTypeArray::New();
+    vtkIdTypeArray *connArray = vtkIdTypeArray::New();
+    vtkIdType *offsets = offsetsArray->WritePointer(0, numCells+1);
+    vtkIdType *conn = connArray->WritePointer(0, numEntries-numCells);
+    vtkIdType loc = 0;
+    offsets[0] = 0;
+    for (i=0; i < numCells; i++)
+      {
+      npts = *legacy++;
+      std::copy(legacy, legacy+npts, conn+loc);
+      legacy += npts;
+      loc += npts;
+      offsets[i+1] = loc;
+      }
+    this->SetStorageArrays(offsetsArray, connArray);
+    offsetsArray->Delete();
+    connArray->Delete();
+    this->Ia->Initialize();
+    this->NumberOfCells = numCells;
+    this->InsertLocation = loc;
+    }
+  else
+    {
+    this->BuildLegacyData();
+    this->SetStorageArrays(NULL, NULL);
+    this->InsertLocation = this->Ia->GetMaxId() + 1;
+    }
+
+  this->StorageLayout = layout;
+  this->TraversalLocation = 0;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+// Rebuild the legacy (n,id1,...,idn) list from the offsets layout.
+void vtkCellArray::BuildLegacyData()
+{
+  BuildLegacyWorker worker;
+  worker.Legacy = this->Ia;
+  worker.NumberOfCells = this->NumberOfCells;
+  StorageDispatch::Execute(this->Offsets, this->Connectivity, worker);
+}
+
+//----------------------------------------------------------------------------
+// Replace the offsets and connectivity arrays (NULL releases them).
+void vtkCellArray::SetStorageArrays(vtkDataArray *offsets,
+                                    vtkDataArray *connectivity)
+{
+  if ( offsets )
+    {
+    offsets->Register(this);
+    connectivity->Register(this);
+    }
+  if ( this->Offsets )
+    {
+    this->Offsets->Delete();
+    this->Connectivity->Delete();
+    }
+  this->Offsets = offsets;
+  this->Connectivity = connectivity;
+
+  this->Storage32Bit = (offsets && !vtkArrayDownCast<vtkIdTypeArray>(offsets));
+  if ( offsets && !this->TempCells )
+    {
+    this->TempCells = new vtkCellArrayTempCells;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Copy a cell of the 32-bit storage into the buffer of the calling thread.
+vtkIdType *vtkCellArray::CopyCell32(vtkIdType cellId, vtkIdType &npts)
+{
+  const vtkTypeInt32 *offsets =
+    static_cast<vtkTypeInt32Array*>(this->Offsets)->GetPointer(cellId);
+  const vtkTypeInt32 *conn = static_cast<vtkTypeInt32Array*>(
+    this->Connectivity)->GetPointer(offsets[0]);
+  npts = offsets[1] - offsets[0];
+  vtkIdType *pts = this->TempCells->Cells.Local()->WritePointer(0, npts);
+  std::copy(conn, conn+npts, pts);
+  return pts;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType *vtkCellArray::GetLegacyCell(vtkIdType loc)
+{
+  if ( this->StorageLayout != vtkCellArray::OFFSETS_LAYOUT )
+    {
+    return this->Ia->GetPointer(loc);
+    }
+  vtkIdList *cell = this->TempCells->Cells.Local();
+  if ( this->Storage32Bit )
+    {
+    return CopyLegacyCell(
+      static_cast<vtkTypeInt32Array*>(this->Offsets)->GetPointer(loc),
+      static_cast<vtkTypeInt32Array*>(this->Connectivity)->GetPointer(0),
+      cell);
+    }
+  return CopyLegacyCell(
+    static_cast<vtkIdTypeArray*>(this->Offsets)->GetPointer(loc),
+    static_cast<vtkIdTypeArray*>(this->Connectivity)->GetPointer(0), cell);
+}
+
+//----------------------------------------------------------------------------
+int vtkCellArray::CanConvertTo32BitStorage(vtkIdType numPoints)
+{
+  vtkIdType numEntries = (this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT ?
+    this->Connectivity->GetMaxId() : this->Ia->GetMaxId()) + 1;
+  return (numPoints <= VTK_INT_MAX && numEntries <= VTK_INT_MAX);
+}
+
+//----------------------------------------------------------------------------
+int vtkCellArray::ConvertTo32BitStorage(vtkIdType numPoints)
+{
+  if ( !this->CanConvertTo32BitStorage(numPoints) )
+    {
+    return 0;
+    }
+  this->SetStorageLayoutToOffsets();
+  if ( this->Storage32Bit || sizeof(vtkIdType) == sizeof(vtkTypeInt32) )
+    {
+    return 1; // nothing to gain
+    }
+
+  vtkTypeInt32Array *offsets = vtkTypeInt32Array::New();
+  offsets->DeepCopy(this->Offsets);
+  vtkTypeInt32Array *conn = vtkTypeInt32Array::New();
+  conn->DeepCopy(this->Connectivity);
+  this->SetStorageArrays(offsets, conn);
+  offsets->Delete();
+  conn->Delete();
+  this->Modified();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ConvertToIdTypeStorage()
+{
+  if ( !this->Storage32Bit )
+    {
+    return;
+    }
+
+  vtkIdTypeArray *offsets = vtkIdTypeArray::New();
+  offsets->DeepCopy(this->Offsets);
+  vtkIdTypeArray *conn = vtkIdTypeArray::New();
+  conn->DeepCopy(this->Connectivity);
+  this->SetStorageArrays(offsets, conn);
+  offsets->Delete();
+  conn->Delete();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ConvertToSmallestStorage(vtkIdType numPoints)
+{
+  if ( this->StorageLayout != vtkCellArray::OFFSETS_LAYOUT )
+    {
+    return;
+    }
+  if ( !this->ConvertTo32BitStorage(numPoints) )
+    {
+    this->ConvertToIdTypeStorage();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkCellArray::AllocateOffsetsLayout(const vtkIdType sz, const int ext)
+{
+  this->NumberOfCells = 0;
+  this->InsertLocation = 0;
+  this->TraversalLocation = 0;
+  this->Offsets->Initialize();
+  this->Offsets->InsertNextTuple1(0);
+  return this->Connectivity->Allocate(sz,ext);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::AllocateExact(vtkIdType numCells, vtkIdType connSize)
+{
+  this->Reset();
+  this->SetStorageLayoutToOffsets();
+  if ( this->Storage32Bit && connSize > VTK_INT_MAX )
+    {
+    this->ConvertToIdTypeStorage();
+    }
+  this->Ia->Initialize();
+  this->Offsets->SetNumberOfTuples(numCells+1);
+  this->Offsets->SetTuple1(0,0);
+  this->Connectivity->SetNumberOfValues(connSize);
+  this->NumberOfCells = numCells;
+  this->InsertLocation = connSize;
+  this->TraversalLocation = 0;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetData(vtkDataArray *offsets,
+                           vtkDataArray *connectivity)
+{
+  if ( !offsets || !connectivity || offsets->GetNumberOfTuples() < 1 )
+    {
+    vtkErrorMacro("Offsets (with at least one value) and connectivity "
+                  "arrays are required.");
+    return;
+    }
+  int is32Bit = (vtkArrayDownCast<vtkTypeInt32Array>(offsets) &&
+                 vtkArrayDownCast<vtkTypeInt32Array>(connectivity));
+  if ( !is32Bit && !(vtkArrayDownCast<vtkIdTypeArray>(offsets) &&
+                     vtkArrayDownCast<vtkIdTypeArray>(connectivity)) )
+    {
+    vtkErrorMacro("Offsets and connectivity must both be vtkIdTypeArray or "
+                  "both be vtkTypeInt32Array.");
+    return;
+    }
+
+  this->Ia->Initialize();
+  this->StorageLayout = vtkCellArray::OFFSETS_LAYOUT;
+  this->SetStorageArrays(offsets, connectivity);
+
+  this->NumberOfCells = offsets->GetNumberOfTuples() - 1;
+  this->InsertLocation = connectivity->GetMaxId() + 1;
+  this->TraversalLocation = 0;
+  this->Modified();
 }
 
 //----------------------------------------------------------------------------
@@ -63,6 +483,15 @@ int vtkCellArray::GetMaxCellSize()
 {
   int i, npts=0, maxSize=0;
 
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    MaxCellSizeWorker worker;
+    worker.NumberOfCells = this->NumberOfCells;
+    worker.MaxCellSize = 0;
+    StorageDispatch::Execute(this->Offsets, this->Connectivity, worker);
+    return worker.MaxCellSize;
+    }
+
   for (i=0; i<this->Ia->GetMaxId(); i+=(npts+1))
     {
     if ( (npts=this->Ia->GetValue(i)) > maxSize )
@@ -79,6 +508,11 @@ void vtkCellArray::SetCells(vtkIdType ncells, vtkIdTypeArray *cells)
 {
   if ( cells && cells != this->Ia )
     {
+    if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+      {
+      this->SetStorageArrays(NULL, NULL);
+      this->StorageLayout = vtkCellArray::LEGACY_LAYOUT;
+      }
     this->Modified();
     this->Ia->Delete();
     this->Ia = cells;
@@ -93,12 +527,28 @@ void vtkCellArray::SetCells(vtkIdType ncells, vtkIdTypeArray *cells)
 //----------------------------------------------------------------------------
 unsigned long vtkCellArray::GetActualMemorySize()
 {
-  return this->Ia->GetActualMemorySize();
+  unsigned long size = this->Ia->GetActualMemorySize();
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    size += this->Offsets->GetActualMemorySize() +
+      this->Connectivity->GetActualMemorySize();
+    }
+  return size;
 }
 
 //----------------------------------------------------------------------------
 int vtkCellArray::GetNextCell(vtkIdList *pts)
 {
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    if ( this->TraversalLocation < this->NumberOfCells )
+      {
+      this->GetCellAtId(this->TraversalLocation++, pts);
+      return 1;
+      }
+    return 0;
+    }
+
   vtkIdType npts, *ppts;
   if (this->GetNextCell(npts, ppts))
     {
@@ -115,8 +565,14 @@ int vtkCellArray::GetNextCell(vtkIdList *pts)
 //----------------------------------------------------------------------------
 void vtkCellArray::GetCell(vtkIdType loc, vtkIdList *pts)
 {
-  vtkIdType npts = this->Ia->GetValue(loc++);
-  vtkIdType *ppts = this->Ia->GetPointer(loc);
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    this->GetCellAtId(loc, pts);
+    return;
+    }
+
+  vtkIdType npts, *ppts;
+  this->GetCell(loc, npts, ppts);
   pts->SetNumberOfIds(npts);
   for (vtkIdType i = 0; i < npts; i++)
     {
@@ -124,6 +580,112 @@ void vtkCellArray::GetCell(vtkIdType loc, vtkIdList *pts)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdList *pts)
+{
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    // copy directly from the storage, without the buffer used by the
+    // pointer returning methods
+    if ( this->Storage32Bit )
+      {
+      CopyCell(static_cast<vtkTypeInt32Array*>(this->Offsets),
+               static_cast<vtkTypeInt32Array*>(this->Connectivity),
+               cellId, pts);
+      }
+    else
+      {
+      CopyCell(static_cast<vtkIdTypeArray*>(this->Offsets),
+               static_cast<vtkIdTypeArray*>(this->Connectivity),
+               cellId, pts);
+      }
+    return;
+    }
+
+  vtkIdType npts, *ppts;
+  this->GetCellAtId(cellId, npts, ppts);
+  pts->SetNumberOfIds(npts);
+  std::copy(ppts, ppts+npts, pts->GetPointer(0));
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReverseCell(vtkIdType loc)
+{
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    if ( this->Storage32Bit )
+      {
+      ReverseCellIds(static_cast<vtkTypeInt32Array*>(this->Offsets),
+                     static_cast<vtkTypeInt32Array*>(this->Connectivity), loc);
+      }
+    else
+      {
+      ReverseCellIds(static_cast<vtkIdTypeArray*>(this->Offsets),
+                     static_cast<vtkIdTypeArray*>(this->Connectivity), loc);
+      }
+    return;
+    }
+
+  vtkIdType npts, *pts;
+  this->GetCell(loc, npts, pts);
+  std::reverse(pts, pts+npts);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReplaceCell(vtkIdType loc, int npts, const vtkIdType *pts)
+{
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    if ( this->Storage32Bit )
+      {
+      ReplaceCellIds(static_cast<vtkTypeInt32Array*>(this->Offsets),
+                     static_cast<vtkTypeInt32Array*>(this->Connectivity),
+                     loc, npts, pts);
+      }
+    else
+      {
+      ReplaceCellIds(static_cast<vtkIdTypeArray*>(this->Offsets),
+                     static_cast<vtkIdTypeArray*>(this->Connectivity),
+                     loc, npts, pts);
+      }
+    return;
+    }
+
+  vtkIdType oldNpts, *oldPts;
+  this->GetCell(loc, oldNpts, oldPts);
+  std::copy(pts, pts+npts, oldPts);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReplaceCellPoint(vtkIdType loc, vtkIdType oldPtId,
+                                    vtkIdType newPtId)
+{
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    if ( this->Storage32Bit )
+      {
+      ReplaceCellPointId(static_cast<vtkTypeInt32Array*>(this->Offsets),
+                         static_cast<vtkTypeInt32Array*>(this->Connectivity),
+                         loc, oldPtId, newPtId);
+      }
+    else
+      {
+      ReplaceCellPointId(static_cast<vtkIdTypeArray*>(this->Offsets),
+                         static_cast<vtkIdTypeArray*>(this->Connectivity),
+                         loc, oldPtId, newPtId);
+      }
+    return;
+    }
+
+  vtkIdType npts, *pts;
+  this->GetCell(loc, npts, pts);
+  vtkIdType *pt = std::find(pts, pts+npts, oldPtId);
+  if ( pt != pts+npts )
+    {
+    *pt = newPtId;
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkCellArray::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -132,4 +694,9 @@ void vtkCellArray::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Number Of Cells: " << this->NumberOfCells << endl;
   os << indent << "Insert Location: " << this->InsertLocation << endl;
   os << indent << "Traversal Location: " << this->TraversalLocation << endl;
+  os << indent << "Storage Layout: "
+     << (this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT ?
+         "Offsets" : "Legacy") << endl;
+  os << indent << "Storage 32 Bit: "
+     << (this->Storage32Bit ? "On" : "Off") << endl;
 }
@@ -26,6 +26,34 @@
 // using the vtkCellTypes and vtkCellLinks objects to extend the definition of
 // the data structure.
 //
+// Alternatively, the cell array can be switched to an offsets layout (see
+// SetStorageLayout()). In this layout the connectivity is stored as two
+// arrays: a connectivity list (id1,id2,...,idn, id1,id2,...,idn, ...) and an
+// offsets list of size (numCells+1) where cell i uses the point ids in the
+// range [offsets[i], offsets[i+1]). Cell i can then be accessed in constant
+// time (see GetCellAtId()), and the arrays can be allocated up front and
+// filled concurrently (see AllocateExact()). When the offsets layout is in
+// use, the "locations" used by GetCell(loc,...), GetInsertLocation() and
+// GetTraversalLocation() are cell ids rather than offsets into the legacy
+// list. The methods exposing the legacy list itself (GetData(),
+// GetPointer(), WritePointer() and SetCells()) switch the cell array back
+// to the legacy layout, once; vtkPolyData and vtkUnstructuredGrid update the
+// locations of their cells when the layout of their cell arrays changes.
+//
+// With the offsets layout, the offsets and connectivity may also be stored
+// as 32-bit integers instead of vtkIdType when the number of points (and the
+// size of the connectivity) allow it, which halves the memory used by the
+// cells (see ConvertToSmallestStorage(), which vtkPolyData::Squeeze() and
+// vtkUnstructuredGrid::Squeeze() call). Inserting a cell that does not fit
+// converts the cells back to vtkIdType storage. With 32-bit storage the
+// methods returning a vtkIdType pointer to a cell (GetCell(), GetNextCell(),
+// GetCellAtId()) copy it into a buffer owned by the calling thread, valid
+// until its next call, so writes through the pointer are lost (use
+// ReplaceCell(), ReplaceCellPoint() or ReverseCell() instead). Threaded code
+// should rather copy the cells into its own lists with the vtkIdList
+// versions, or dispatch the offsets and connectivity arrays over
+// StorageArrayList to read them without any copy.
+//
 // .SECTION See Also
 // vtkCellTypes vtkCellLinks
 
@@ -36,8 +64,12 @@
 #include "vtkObject.h"
 
 #include "vtkIdTypeArray.h" // Needed for inline methods
+#include "vtkTypeInt32Array.h" // Needed for inline methods
+#include "vtkTypeList.h" // For StorageArrayList
 #include "vtkCell.h" // Needed for inline methods
 
+class vtkCellArrayTempCells;
+
 class VTKCOMMONDATAMODEL_EXPORT vtkCellArray : public vtkObject
 {
 public:
@@ -49,9 +81,116 @@ public:
   static vtkCellArray *New();
 
   // Description:
-  // Allocate memory and set the size to extend by.
+  // Allocate memory and set the size to extend by. The size is expressed in
+  // legacy connectivity entries (see EstimateSize()) for both layouts.
   int Allocate(const vtkIdType sz, const int ext=1000)
-    {return this->Ia->Allocate(sz,ext);}
+    {
+    if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+      {
+      return this->AllocateOffsetsLayout(sz,ext);
+      }
+    return this->Ia->Allocate(sz,ext);
+    }
+
+  // Description:
+  // Storage layouts of the cell array. The legacy layout is the single
+  // (n,id1,id2,...,idn, ...) list; the offsets layout uses separate offsets
+  // and connectivity arrays.
+  enum StorageLayouts
+  {
+    LEGACY_LAYOUT=0,
+    OFFSETS_LAYOUT=1
+  };
+
+  // Description:
+  // Specify the storage layout of the cell array. Changing the layout
+  // converts any cells already present and resets the traversal location.
+  // Since locations have a different meaning in each layout, change the
+  // layout before handing the cell array to a dataset (e.g. with
+  // vtkUnstructuredGrid::SetCells()), or rebuild the dataset's cells
+  // afterwards (e.g. vtkPolyData::BuildCells()).
+  void SetStorageLayout(int layout);
+  vtkGetMacro(StorageLayout,int);
+  void SetStorageLayoutToLegacy()
+    {this->SetStorageLayout(vtkCellArray::LEGACY_LAYOUT);}
+  void SetStorageLayoutToOffsets()
+    {this->SetStorageLayout(vtkCellArray::OFFSETS_LAYOUT);}
+
+  // Description:
+  // Allocate exactly numCells cells using connSize point ids in total, and
+  // switch to the offsets layout. The offsets array is sized (numCells+1) and
+  // the connectivity array connSize; both must be filled by the caller (e.g.
+  // after computing the offsets with a prefix sum, disjoint ranges of cells
+  // may be written from several threads). Any previous content is discarded;
+  // the storage type is kept (see ConvertTo32BitStorage()).
+  void AllocateExact(vtkIdType numCells, vtkIdType connSize);
+
+  // Description:
+  // Define the cells with an offsets array of size (numCells+1) and the
+  // associated connectivity array, and switch to the offsets layout. The
+  // arrays must both be vtkIdTypeArray or both be vtkTypeInt32Array (see
+  // StorageArrayList). The arrays are reference counted, not copied.
+  void SetData(vtkDataArray *offsets, vtkDataArray *connectivity);
+
+  // Description:
+  // Return the offsets and connectivity arrays when the offsets layout is in
+  // use, or NULL otherwise. They are vtkIdTypeArray, or vtkTypeInt32Array
+  // when IsStorage32Bit() is true.
+  vtkDataArray* GetOffsetsArray()
+    {return this->Offsets;}
+  vtkDataArray* GetConnectivityArray()
+    {return this->Connectivity;}
+
+#ifndef __WRAP__
+  // Description:
+  // The array types that may be used by the offsets layout. Use this list
+  // with vtkArrayDispatch (e.g. Dispatch2ByArrayWithSameValueType) on the
+  // offsets and connectivity arrays to process the cells with code
+  // specialized for each storage type.
+  typedef vtkTypeList_Create_2(vtkIdTypeArray, vtkTypeInt32Array)
+    StorageArrayList;
+#endif
+
+  // Description:
+  // Return whether the offsets layout stores its offsets and connectivity
+  // as 32-bit integers.
+  int IsStorage32Bit()
+    {return this->Storage32Bit;}
+
+  // Description:
+  // Return whether the cells can be stored as 32-bit integers, given the
+  // number of points they refer to.
+  int CanConvertTo32BitStorage(vtkIdType numPoints);
+
+  // Description:
+  // Store the offsets and connectivity as 32-bit integers (switching to the
+  // offsets layout if needed). Nothing is done and 0 is returned if the
+  // cells cannot be represented, see CanConvertTo32BitStorage(). Inserting
+  // a cell which does not fit afterwards converts back to vtkIdType storage.
+  int ConvertTo32BitStorage(vtkIdType numPoints);
+
+  // Description:
+  // Store the offsets and connectivity as vtkIdType.
+  void ConvertToIdTypeStorage();
+
+  // Description:
+  // Use 32-bit storage when possible (see ConvertTo32BitStorage()), and
+  // vtkIdType storage otherwise. Nothing is done with the legacy layout.
+  void ConvertToSmallestStorage(vtkIdType numPoints);
+
+  // Description:
+  // Random access to the cell with id cellId. This is a constant time
+  // operation with the offsets layout; with the legacy layout the list is
+  // traversed from the beginning. With 32-bit storage the pts pointer refers
+  // to a copy of the cell which is valid until the next call from the same
+  // thread; the vtkIdList version does not use an intermediate copy.
+  void GetCellAtId(vtkIdType cellId, vtkIdType &npts, vtkIdType* &pts);
+  void GetCellAtId(vtkIdType cellId, vtkIdList *pts);
+
+  // Description:
+  // Return the number of points of the cell with id cellId (see
+  // GetCellAtId() for complexity).
+  vtkIdType GetCellSize(vtkIdType cellId);
 
   // Description:
   // Free any memory and reset to an empty state.
@@ -85,7 +224,9 @@ public:
   // A cell traversal methods that is more efficient than vtkDataSet traversal
   // methods.  GetNextCell() gets the next cell in the list. If end of list
   // is encountered, 0 is returned. A value of 1 is returned whenever
-  // npts and pts have been updated without error.
+  // npts and pts have been updated without error. With 32-bit storage the
+  // pts pointer refers to a copy of the cell valid until the next call from
+  // the same thread.
   int GetNextCell(vtkIdType& npts, vtkIdType* &pts);
 
   // Description:
@@ -95,20 +236,35 @@ public:
   int GetNextCell(vtkIdList *pts);
 
   // Description:
-  // Get the size of the allocated connectivity array.
+  // Get the size of the allocated connectivity array (the offsets and
+  // connectivity arrays combined for the offsets layout).
   vtkIdType GetSize()
-    {return this->Ia->GetSize();}
+    {
+    if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+      {
+      return this->Offsets->GetSize()+this->Connectivity->GetSize();
+      }
+    return this->Ia->GetSize();
+    }
 
   // Description:
   // Get the total number of entries (i.e., data values) in the connectivity
   // array. This may be much less than the allocated size (i.e., return value
-  // from GetSize().)
+  // from GetSize().) With the offsets layout the number of entries of the
+  // equivalent legacy list (point ids plus one count per cell) is returned.
   vtkIdType GetNumberOfConnectivityEntries()
-    {return this->Ia->GetMaxId()+1;}
+    {
+    if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+      {
+      return this->Connectivity->GetMaxId()+1+this->NumberOfCells;
+      }
+    return this->Ia->GetMaxId()+1;
+    }
 
   // Description:
   // Internal method used to retrieve a cell given an offset into
-  // the internal array.
+  // the internal array. With 32-bit storage the pts pointer refers to a copy
+  // of the cell valid until the next call from the same thread.
   void GetCell(vtkIdType loc, vtkIdType &npts, vtkIdType* &pts);
 
   // Description:
@@ -116,6 +272,14 @@ public:
   // the internal array.
   void GetCell(vtkIdType loc, vtkIdList* pts);
 
+  // Description:
+  // Return the cell at the given location as the block (npts,id1,...,idn)
+  // of the legacy list. The offsets layout stores no such block: the cell is
+  // then copied from the offsets and connectivity arrays into a buffer of the
+  // calling thread, valid until its next call, and writes through the
+  // returned pointer are lost.
+  vtkIdType *GetLegacyCell(vtkIdType loc);
+
   // Description:
   // Insert a cell object. Return the cell id of the cell.
   vtkIdType InsertNextCell(vtkCell *cell);
@@ -149,9 +313,16 @@ public:
 
   // Description:
   // Computes the current insertion location within the internal array.
-  // Used in conjunction with GetCell(int loc,...).
+  // Used in conjunction with GetCell(int loc,...). With the offsets layout
+  // this is the id of the last inserted cell.
   vtkIdType GetInsertLocation(int npts)
-    {return (this->InsertLocation - npts - 1);};
+    {
+    if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+      {
+      return (this->NumberOfCells - 1);
+      }
+    return (this->InsertLocation - npts - 1);
+    }
 
   // Description:
   // Get/Set the current traversal location.
@@ -162,9 +333,16 @@ public:
 
   // Description:
   // Computes the current traversal location within the internal array. Used
-  // in conjunction with GetCell(int loc,...).
+  // in conjunction with GetCell(int loc,...). With the offsets layout this
+  // is the id of the last traversed cell.
   vtkIdType GetTraversalLocation(vtkIdType npts)
-    {return(this->TraversalLocation-npts-1);}
+    {
+    if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+      {
+      return (this->TraversalLocation - 1);
+      }
+    return (this->TraversalLocation-npts-1);
+    }
 
   // Description:
   // Special method inverts ordering of current cell. Must be called
@@ -175,20 +353,28 @@ public:
   // Replace the point ids of the cell with a different list of point ids.
   void ReplaceCell(vtkIdType loc, int npts, const vtkIdType *pts);
 
+  // Description:
+  // Replace the first occurrence of point id oldPtId in the cell at location
+  // loc with newPtId. Unlike a write through the pointer returned by
+  // GetCell(), this modifies the cell whatever the storage in use.
+  void ReplaceCellPoint(vtkIdType loc, vtkIdType oldPtId, vtkIdType newPtId);
+
   // Description:
   // Returns the size of the largest cell. The size is the number of points
   // defining the cell.
   int GetMaxCellSize();
 
   // Description:
-  // Get pointer to array of cell data.
+  // Get pointer to array of cell data. This switches a cell array using the
+  // offsets layout to the legacy layout (see GetData()).
   vtkIdType *GetPointer()
-    {return this->Ia->GetPointer(0);}
+    {return this->GetData()->GetPointer(0);}
 
   // Description:
   // Get pointer to data array for purpose of direct writes of data. Size is the
   // total storage consumed by the cell array. ncells is the number of cells
-  // represented in the array.
+  // represented in the array. This switches the cell array to the legacy
+  // layout (see GetData()).
   vtkIdType *WritePointer(const vtkIdType ncells, const vtkIdType size);
 
   // Description:
@@ -198,7 +384,7 @@ public:
   // referring these cells becomes invalid (for example, if BuildCells() has
   // been called see vtkPolyData).  The traversal location is reset to the
   // beginning of the list; the insertion location is set to the end of the
-  // list.
+  // list. This switches the cell array to the legacy layout (see GetData()).
   void SetCells(vtkIdType ncells, vtkIdTypeArray *cells);
 
   // Description:
@@ -206,9 +392,20 @@ public:
   void DeepCopy(vtkCellArray *ca);
 
   // Description:
-  // Return the underlying data as a data array.
+  // Return the underlying data as a data array. The (n,id1,...,idn) list
+  // only exists in the legacy layout: a cell array using the offsets layout
+  // is switched back to it, so that the returned array holds the cells
+  // themselves and may be modified. This is not thread safe; code meant to
+  // keep the offsets layout reads the cells through GetCell() and
+  // GetCellAtId(), or through GetOffsetsArray() and GetConnectivityArray().
   vtkIdTypeArray* GetData()
-    {return this->Ia;}
+    {
+    if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+      {
+      this->SetStorageLayoutToLegacy();
+      }
+    return this->Ia;
+    }
 
   // Description:
   // Reuse list. Reset to initial condition.
@@ -217,7 +414,15 @@ public:
   // Description:
   // Reclaim any extra memory.
   void Squeeze()
-    {this->Ia->Squeeze();}
+    {
+    if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+      {
+      this->Offsets->Squeeze();
+      this->Connectivity->Squeeze();
+      return;
+      }
+    this->Ia->Squeeze();
+    }
 
   // Description:
   // Return the memory in kibibytes (1024 bytes) consumed by this cell array. Used to
@@ -232,21 +437,68 @@ protected:
   vtkCellArray();
   ~vtkCellArray();
 
+  // Helpers for the offsets layout.
+  int AllocateOffsetsLayout(const vtkIdType sz, const int ext);
+  void BuildLegacyData();
+  void SetStorageArrays(vtkDataArray *offsets, vtkDataArray *connectivity);
+  vtkIdType *CopyCell32(vtkIdType cellId, vtkIdType &npts);
+  int Fits32BitStorage(vtkIdType npts, const vtkIdType *pts);
+  static int Fits32Bit(vtkIdType value)
+    {return (value >= VTK_INT_MIN && value <= VTK_INT_MAX);}
+
   vtkIdType NumberOfCells;
   vtkIdType InsertLocation;     //keep track of current insertion point
   vtkIdType TraversalLocation;   //keep track of traversal position
   vtkIdTypeArray *Ia;
 
+  int StorageLayout;
+  vtkDataArray *Offsets;      //offsets layout: numCells+1 offsets
+  vtkDataArray *Connectivity; //offsets layout: point ids
+  int Storage32Bit;           //offsets layout uses vtkTypeInt32Array
+  vtkCellArrayTempCells *TempCells; //offsets layout: per-thread cell copies
+
 private:
   vtkCellArray(const vtkCellArray&);  // Not implemented.
   void operator=(const vtkCellArray&);  // Not implemented.
 };
 
-
 //----------------------------------------------------------------------------
 inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
                                               const vtkIdType* pts)
 {
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    if ( this->Storage32Bit && !this->Fits32BitStorage(npts, pts) )
+      {
+      this->ConvertToIdTypeStorage();
+      }
+    vtkIdType loc = this->Connectivity->GetMaxId() + 1;
+    this->InsertLocation = loc + npts;
+    if ( this->Storage32Bit )
+      {
+      vtkTypeInt32 *ptr = static_cast<vtkTypeInt32Array*>(
+        this->Connectivity)->WritePointer(loc, npts);
+      for (vtkIdType i = 0; i < npts; i++)
+        {
+        *ptr++ = static_cast<vtkTypeInt32>(*pts++);
+        }
+      static_cast<vtkTypeInt32Array*>(this->Offsets)->InsertNextValue(
+        static_cast<vtkTypeInt32>(this->InsertLocation));
+      }
+    else
+      {
+      vtkIdType *ptr = static_cast<vtkIdTypeArray*>(
+        this->Connectivity)->WritePointer(loc, npts);
+      for (vtkIdType i = 0; i < npts; i++)
+        {
+        *ptr++ = *pts++;
+        }
+      static_cast<vtkIdTypeArray*>(this->Offsets)->InsertNextValue(
+        this->InsertLocation);
+      }
+    return this->NumberOfCells++;
+    }
+
   vtkIdType i = this->Ia->GetMaxId() + 1;
   vtkIdType *ptr = this->Ia->WritePointer(i, npts+1);
 
@@ -264,6 +516,27 @@ inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
 //----------------------------------------------------------------------------
 inline vtkIdType vtkCellArray::InsertNextCell(int npts)
 {
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    this->InsertLocation = this->Connectivity->GetMaxId() + 1;
+    if ( this->Storage32Bit &&
+         !vtkCellArray::Fits32Bit(this->InsertLocation + npts) )
+      {
+      this->ConvertToIdTypeStorage();
+      }
+    if ( this->Storage32Bit )
+      {
+      static_cast<vtkTypeInt32Array*>(this->Offsets)->InsertNextValue(
+        static_cast<vtkTypeInt32>(this->InsertLocation + npts));
+      }
+    else
+      {
+      static_cast<vtkIdTypeArray*>(this->Offsets)->InsertNextValue(
+        this->InsertLocation + npts);
+      }
+    return this->NumberOfCells++;
+    }
+
   this->InsertLocation = this->Ia->InsertNextValue(npts) + 1;
   this->NumberOfCells++;
 
@@ -273,12 +546,52 @@ inline vtkIdType vtkCellArray::InsertNextCell(int npts)
 //----------------------------------------------------------------------------
 inline void vtkCellArray::InsertCellPoint(vtkIdType id)
 {
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    if ( this->Storage32Bit && !(vtkCellArray::Fits32Bit(id) &&
+         vtkCellArray::Fits32Bit(this->InsertLocation + 1)) )
+      {
+      this->ConvertToIdTypeStorage();
+      }
+    if ( this->Storage32Bit )
+      {
+      static_cast<vtkTypeInt32Array*>(this->Connectivity)->InsertValue(
+        this->InsertLocation++, static_cast<vtkTypeInt32>(id));
+      }
+    else
+      {
+      static_cast<vtkIdTypeArray*>(this->Connectivity)->InsertValue(
+        this->InsertLocation++, id);
+      }
+    return;
+    }
   this->Ia->InsertValue(this->InsertLocation++, id);
 }
 
 //----------------------------------------------------------------------------
 inline void vtkCellArray::UpdateCellCount(int npts)
 {
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    if ( this->Storage32Bit )
+      {
+      vtkTypeInt32Array *offsets =
+        static_cast<vtkTypeInt32Array*>(this->Offsets);
+      vtkIdType offset =
+        static_cast<vtkIdType>(offsets->GetValue(this->NumberOfCells-1)) + npts;
+      if ( vtkCellArray::Fits32Bit(offset) )
+        {
+        offsets->SetValue(this->NumberOfCells,
+                          static_cast<vtkTypeInt32>(offset));
+        return;
+        }
+      this->ConvertToIdTypeStorage();
+      }
+    vtkIdTypeArray *offsets = static_cast<vtkIdTypeArray*>(this->Offsets);
+    offsets->SetValue(this->NumberOfCells,
+      offsets->GetValue(this->NumberOfCells-1) + npts);
+    return;
+    }
   this->Ia->SetValue(this->InsertLocation-npts-1, npts);
 }
 
@@ -302,11 +615,47 @@ inline void vtkCellArray::Reset()
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
   this->Ia->Reset();
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    this->Connectivity->Reset();
+    this->Offsets->Reset();
+    this->Offsets->InsertNextTuple1(0);
+    }
+}
+
+//----------------------------------------------------------------------------
+inline int vtkCellArray::Fits32BitStorage(vtkIdType npts,
+                                          const vtkIdType *pts)
+{
+  if ( !vtkCellArray::Fits32Bit(this->Connectivity->GetMaxId() + 1 + npts) )
+    {
+    return 0;
+    }
+  for (vtkIdType i = 0; i < npts; i++)
+    {
+    if ( !vtkCellArray::Fits32Bit(pts[i]) )
+      {
+      return 0;
+      }
+    }
+  return 1;
 }
 
 //----------------------------------------------------------------------------
 inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
 {
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    if ( this->TraversalLocation < this->NumberOfCells )
+      {
+      this->GetCell(this->TraversalLocation++, npts, pts);
+      return 1;
+      }
+    npts=0;
+    pts=0;
+    return 0;
+    }
+
   if ( this->Ia->GetMaxId() >= 0 &&
        this->TraversalLocation <= this->Ia->GetMaxId() )
     {
@@ -324,40 +673,70 @@ inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
 inline void vtkCellArray::GetCell(vtkIdType loc, vtkIdType &npts,
                                   vtkIdType* &pts)
 {
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    if ( this->Storage32Bit )
+      {
+      pts = this->CopyCell32(loc, npts);
+      return;
+      }
+    const vtkIdType *offsets =
+      static_cast<vtkIdTypeArray*>(this->Offsets)->GetPointer(loc);
+    npts = offsets[1] - offsets[0];
+    pts = static_cast<vtkIdTypeArray*>(
+      this->Connectivity)->GetPointer(offsets[0]);
+    return;
+    }
   npts = this->Ia->GetValue(loc++);
   pts  = this->Ia->GetPointer(loc);
 }
 
 //----------------------------------------------------------------------------
-inline void vtkCellArray::ReverseCell(vtkIdType loc)
+inline void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdType &npts,
+                                      vtkIdType* &pts)
 {
-  int i;
-  vtkIdType tmp;
-  vtkIdType npts=this->Ia->GetValue(loc);
-  vtkIdType *pts=this->Ia->GetPointer(loc+1);
-  for (i=0; i < (npts/2); i++)
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
     {
-    tmp = pts[i];
-    pts[i] = pts[npts-i-1];
-    pts[npts-i-1] = tmp;
+    this->GetCell(cellId, npts, pts);
+    return;
     }
+  vtkIdType loc = 0;
+  for (vtkIdType i = 0; i < cellId; i++)
+    {
+    loc += this->Ia->GetValue(loc) + 1;
+    }
+  this->GetCell(loc, npts, pts);
 }
 
 //----------------------------------------------------------------------------
-inline void vtkCellArray::ReplaceCell(vtkIdType loc, int npts,
-                                      const vtkIdType *pts)
+inline vtkIdType vtkCellArray::GetCellSize(vtkIdType cellId)
 {
-  vtkIdType *oldPts=this->Ia->GetPointer(loc+1);
-  for (int i=0; i < npts; i++)
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
     {
-    oldPts[i] = pts[i];
+    if ( this->Storage32Bit )
+      {
+      const vtkTypeInt32 *offsets =
+        static_cast<vtkTypeInt32Array*>(this->Offsets)->GetPointer(cellId);
+      return offsets[1] - offsets[0];
+      }
+    const vtkIdType *offsets =
+      static_cast<vtkIdTypeArray*>(this->Offsets)->GetPointer(cellId);
+    return offsets[1] - offsets[0];
     }
+  vtkIdType npts, *pts;
+  this->GetCellAtId(cellId, npts, pts);
+  return npts;
 }
 
 //----------------------------------------------------------------------------
 inline vtkIdType *vtkCellArray::WritePointer(const vtkIdType ncells,
                                              const vtkIdType size)
 {
+  if ( this->StorageLayout == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    this->Reset();
+    this->SetStorageLayoutToLegacy();
+    }
   this->NumberOfCells = ncells;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
@@ -397,9 +397,9 @@ void vtkCellLocator::FindClosestPoint(double x[3], double closestPoint[3],
   int ijk[3];
   double minDist2, refinedRadius2, distance2ToBucket;
   double distance2ToCellBounds, cellBounds[6];
-  double pcoords[3], point[3], cachedPoint[3], weightsArray[6];
+  double pcoords[3], point[3], cachedPoint[3], weightsArray[VTK_CELL_SIZE];
   double *weights = weightsArray;
-  int nWeights = 6, nPoints;
+  int nWeights = VTK_CELL_SIZE, nPoints;
   vtkIdList *cellIds;
   int stat;
   //int minStat=0; //save this variable it is used for debugging
@@ -497,7 +497,7 @@ void vtkCellLocator::FindClosestPoint(double x[3], double closestPoint[3],
                 nPoints = cell->GetPointIds()->GetNumberOfIds();
                 if (nPoints > nWeights)
                   {
-                  if (nWeights > 6)
+                  if (nWeights > VTK_CELL_SIZE)
                     {
                     delete [] weights;
                     }
@@ -607,7 +607,7 @@ void vtkCellLocator::FindClosestPoint(double x[3], double closestPoint[3],
                 nPoints = cell->GetPointIds()->GetNumberOfIds();
                 if (nPoints > nWeights)
                   {
-                  if (nWeights > 6)
+                  if (nWeights > VTK_CELL_SIZE)
                     {
                     delete [] weights;
                     }
@@ -648,7 +648,7 @@ void vtkCellLocator::FindClosestPoint(double x[3], double closestPoint[3],
     this->DataSet->GetCell(cellId, cell);
     }
 
-  if (nWeights > 6)
+  if (nWeights > VTK_CELL_SIZE)
     {
     delete [] weights;
     }
@@ -668,9 +668,9 @@ vtkIdType vtkCellLocator::FindClosestPointWithinRadius(double x[3], double radiu
   int closestSubCell = -1;
   int leafStart;
   int ijk[3];
-  double pcoords[3], point[3], cachedPoint[3], weightsArray[6];
+  double pcoords[3], point[3], cachedPoint[3], weightsArray[VTK_CELL_SIZE];
   double *weights = weightsArray;
-  int nWeights = 6, nPoints;
+  int nWeights = VTK_CELL_SIZE, nPoints;
   int returnVal = 0;
   vtkIdList *cellIds;
 
@@ -758,7 +758,7 @@ vtkIdType vtkCellLocator::FindClosestPointWithinRadius(double x[3], double radiu
           nPoints = cell->GetPointIds()->GetNumberOfIds();
           if (nPoints > nWeights)
             {
-            if (nWeights > 6)
+            if (nWeights > VTK_CELL_SIZE)
               {
               delete [] weights;
               }
@@ -890,7 +890,7 @@ vtkIdType vtkCellLocator::FindClosestPointWithinRadius(double x[3], double radiu
                 nPoints = cell->GetPointIds()->GetNumberOfIds();
                 if (nPoints > nWeights)
                   {
-                  if (nWeights > 6)
+                  if (nWeights > VTK_CELL_SIZE)
                     {
                     delete [] weights;
                     }
@@ -946,7 +946,7 @@ vtkIdType vtkCellLocator::FindClosestPointWithinRadius(double x[3], double radiu
     returnVal = 1;
     }
 
-  if (nWeights > 6)
+  if (nWeights > VTK_CELL_SIZE)
     {
     delete [] weights;
     }
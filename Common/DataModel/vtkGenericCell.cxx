@@ -59,13 +59,24 @@ vtkStandardNewMacro(vtkGenericCell);
 // Construct cell.
 vtkGenericCell::vtkGenericCell()
 {
+  for (int i=0; i < VTK_NUMBER_OF_CELL_TYPES; ++i)
+    {
+    this->CellStore[i] = NULL;
+    }
   this->Cell = vtkEmptyCell::New();
+  this->CellStore[VTK_EMPTY_CELL] = this->Cell;
 }
 
 //----------------------------------------------------------------------------
 vtkGenericCell::~vtkGenericCell()
 {
-  this->Cell->Delete();
+  for (int i=0; i < VTK_NUMBER_OF_CELL_TYPES; ++i)
+    {
+    if ( this->CellStore[i] )
+      {
+      this->CellStore[i]->Delete();
+      }
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -355,7 +366,9 @@ vtkCell *vtkGenericCell::InstantiateCell(int cellType)
 
 //----------------------------------------------------------------------------
 // Set the type of dereferenced cell. Checks to see whether cell type
-// has changed and creates a new cell only if necessary.
+// has changed and creates a new cell only if necessary. The cells are kept
+// once instantiated so that iterating over a dataset with mixed cell types
+// does not create and delete a cell every time the type changes.
 void vtkGenericCell::SetCellType(int cellType)
 {
   if ( this->Cell->GetCellType() != cellType )
@@ -363,15 +376,23 @@ void vtkGenericCell::SetCellType(int cellType)
     this->Points->UnRegister(this);
     this->PointIds->UnRegister(this);
     this->PointIds = NULL;
-    this->Cell->Delete();
 
-    vtkCell *cell = vtkGenericCell::InstantiateCell(cellType);
+    vtkCell *cell = NULL;
+    if ( cellType >= 0 && cellType < VTK_NUMBER_OF_CELL_TYPES )
+      {
+      cell = this->CellStore[cellType];
+      if ( !cell )
+        {
+        cell = vtkGenericCell::InstantiateCell(cellType);
+        this->CellStore[cellType] = cell;
+        }
+      }
 
     if( !cell )
       {
       vtkErrorMacro( << "Unsupported cell type: " << cellType
                      << " Setting to vtkEmptyCell" );
-      cell = vtkEmptyCell::New();
+      cell = this->CellStore[VTK_EMPTY_CELL];
       }
 
     this->Cell = cell;
@@ -102,7 +102,9 @@ public:
   // method. It allows vtkGenericCell to act like any cell type by
   // dereferencing an internal instance of a concrete cell type. When
   // you set the cell type, you are resetting a pointer to an internal
-  // cell which is then used for computation.
+  // cell which is then used for computation. The internal cells are kept
+  // once created, so that changing the type back and forth (as when
+  // traversing a dataset with mixed cell types) does not reallocate them.
   void SetCellType(int cellType);
   void SetCellTypeToEmptyCell() {this->SetCellType(VTK_EMPTY_CELL);}
   void SetCellTypeToVertex() {this->SetCellType(VTK_VERTEX);}
@@ -152,6 +154,7 @@ protected:
   ~vtkGenericCell();
 
   vtkCell *Cell;
+  vtkCell *CellStore[VTK_NUMBER_OF_CELL_TYPES];
 
 private:
   vtkGenericCell(const vtkGenericCell&);  // Not implemented.
@@ -469,6 +469,12 @@ int *vtkHexahedron::GetFaceArray(int faceId)
   return faces[faceId];
 }
 
+//----------------------------------------------------------------------------
+int *vtkHexahedron::GetTriangleCases(int caseId)
+{
+  return vtkMarchingCubesTriangleCases::GetCases()[caseId].edges;
+}
+
 //----------------------------------------------------------------------------
 vtkCell *vtkHexahedron::GetFace(int faceId)
 {
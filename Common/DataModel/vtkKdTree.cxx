@@ -41,6 +41,7 @@
 #include "vtkUniformGrid.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkCallbackCommand.h"
+#include "vtkSMPTools.h"
 
 #ifdef _MSC_VER
 #pragma warning ( disable : 4100 )
@@ -50,6 +51,7 @@
 #include <map>
 #include <queue>
 #include <set>
+#include <vector>
 
 
 // Timing data ---------------------------------------------
@@ -100,6 +102,48 @@ static char * makeEntry(const char *s)
 // helper class for ordering the points in vtkKdTree::FindClosestNPoints()
 namespace
 {
+  // Convert a range of points to floats.
+  struct ConvertPointsToFloat
+    {
+    vtkPoints *Points;
+    float *Coords;
+
+    void operator()(vtkIdType begin, vtkIdType end) const
+      {
+      double pt[3];
+      float *coords = this->Coords + 3*begin;
+      for (vtkIdType i = begin; i < end; i++)
+        {
+        this->Points->GetPoint(i, pt);
+        *coords++ = static_cast<float>(pt[0]);
+        *coords++ = static_cast<float>(pt[1]);
+        *coords++ = static_cast<float>(pt[2]);
+        }
+      }
+    };
+
+  // Collect the ids of the regions whose data bounds intersect a sphere,
+  // given its center and the square of its radius. Returns the number of
+  // ids.
+  int RegionsIntersectingSphere2(vtkKdNode *node, int *ids,
+                                 double x, double y, double z,
+                                 double rSquared)
+    {
+    if (!node->IntersectsSphere2(x, y, z, rSquared, 1))
+      {
+      return 0;
+      }
+    if (node->GetLeft() == NULL)
+      {
+      ids[0] = node->GetID();
+      return 1;
+      }
+    int nnodes =
+      RegionsIntersectingSphere2(node->GetLeft(), ids, x, y, z, rSquared);
+    return nnodes + RegionsIntersectingSphere2(node->GetRight(), ids + nnodes,
+                                               x, y, z, rSquared);
+    }
+
   class OrderPoints
   {
   public:
@@ -895,7 +939,7 @@ void vtkKdTree::BuildLocator()
 
     this->ProgressOffset += this->ProgressScale;
     this->ProgressScale = 0.7;
-    this->DivideRegion(kd, ptarray, NULL, 0);
+    this->DivideRegionsInParallel(kd, ptarray, NULL);
 
     TIMERDONE("Build tree");
 
@@ -1222,7 +1266,73 @@ int vtkKdTree::DivideTest(int size, int level)
   return 1;
 }
 //----------------------------------------------------------------------------
-int vtkKdTree::DivideRegion(vtkKdNode *kd, float *c1, int *ids, int level)
+// A region of the tree to divide, with its points (or cell centers) and
+// their ids.
+struct vtkKdTreeRegionToDivide
+{
+  vtkKdNode *Node;
+  float *Coords;
+  int *Ids;
+};
+
+// Divide the regions of a level of the tree. The regions own disjoint
+// ranges of the point array, so they can be divided concurrently.
+class vtkKdTreeDivideLevel
+{
+public:
+  vtkKdTree *Tree;
+  const std::vector<vtkKdTreeRegionToDivide> *Regions;
+  int Level;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+    {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      const vtkKdTreeRegionToDivide &region = (*this->Regions)[i];
+      this->Tree->DivideRegionOnce(region.Node, region.Coords, region.Ids,
+                                   this->Level);
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+void vtkKdTree::DivideRegionsInParallel(vtkKdNode *kd, float *c1, int *ids)
+{
+  std::vector<vtkKdTreeRegionToDivide> regions, children;
+  vtkKdTreeRegionToDivide top = { kd, c1, ids };
+  regions.push_back(top);
+
+  vtkKdTreeDivideLevel divider;
+  divider.Tree = this;
+  divider.Regions = &regions;
+  for (int level = 0; !regions.empty(); level++)
+    {
+    divider.Level = level;
+    vtkSMPTools::For(0, static_cast<vtkIdType>(regions.size()), 1, divider);
+
+    children.clear();
+    for (size_t i = 0; i < regions.size(); i++)
+      {
+      const vtkKdTreeRegionToDivide &region = regions[i];
+      if (region.Node->GetLeft() == NULL)
+        {
+        continue;
+        }
+      int nleft = region.Node->GetLeft()->GetNumberOfPoints();
+      vtkKdTreeRegionToDivide left =
+        { region.Node->GetLeft(), region.Coords, region.Ids };
+      vtkKdTreeRegionToDivide right =
+        { region.Node->GetRight(), region.Coords + nleft*3,
+          region.Ids ? region.Ids + nleft : NULL };
+      children.push_back(left);
+      children.push_back(right);
+      }
+    regions.swap(children);
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkKdTree::DivideRegionOnce(vtkKdNode *kd, float *c1, int *ids, int level)
 {
   int ok = this->DivideTest(kd->GetNumberOfPoints(), level);
 
@@ -1277,21 +1387,304 @@ int vtkKdTree::DivideRegion(vtkKdNode *kd, float *c1, int *ids, int level)
 
   this->DoMedianFind(kd, c1, ids, dim1, dim2, dim3);
 
-  if (kd->GetLeft() == NULL)
+  return (kd->GetLeft() != NULL);
+}
+
+//----------------------------------------------------------------------------
+// Parallel version of vtkKdTree::Select() for the large regions of the first
+// levels, which are few and otherwise divided by a single thread. The
+// median value is searched among the values lying between two values of a
+// sample, which are counted and gathered in parallel, then the points below
+// the median are moved in parallel, in order, before the others. The cut
+// is the same as the one of Select(); only the order of the points in each
+// half differs.
+namespace
+{
+// The regions with at least this number of points are divided in parallel.
+const int vtkKdTreeParallelSelectSize = 100000;
+
+// The points of a region are processed in blocks of this size.
+const int vtkKdTreeSelectBlockSize = 16384;
+
+// The values of a coordinate lying in a range, whose bounds are optional.
+struct vtkKdTreeValueRange
+{
+  float Low;
+  float High;
+  bool HasLow;
+  bool HasHigh;
+
+  bool IsBelow(float x) const
+    {
+    return this->HasLow && x < this->Low;
+    }
+  bool Contains(float x) const
+    {
+    return (!this->HasLow || x >= this->Low) &&
+      (!this->HasHigh || x <= this->High);
+    }
+};
+
+// Count, in each block, the values below the range and in the range, then
+// gather the latter once the offsets of the blocks are known.
+class vtkKdTreeCountInRange
+{
+public:
+  const float *X;
+  int NumberOfPoints;
+  vtkKdTreeValueRange Range;
+  int *NumberBelow;
+  int *NumberInRange;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+    {
+    for (vtkIdType block = begin; block < end; ++block)
+      {
+      int first = static_cast<int>(block) * vtkKdTreeSelectBlockSize;
+      int last = std::min(first + vtkKdTreeSelectBlockSize,
+                          this->NumberOfPoints);
+      int below = 0;
+      int inRange = 0;
+      for (int i = first; i < last; ++i)
+        {
+        float x = this->X[3*i];
+        below += this->Range.IsBelow(x);
+        inRange += this->Range.Contains(x);
+        }
+      this->NumberBelow[block] = below;
+      this->NumberInRange[block] = inRange;
+      }
+    }
+};
+
+class vtkKdTreeGatherInRange
+{
+public:
+  const float *X;
+  int NumberOfPoints;
+  vtkKdTreeValueRange Range;
+  const int *Offsets;
+  float *Values;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
     {
-    return 0;   // unable to divide region further
+    for (vtkIdType block = begin; block < end; ++block)
+      {
+      int first = static_cast<int>(block) * vtkKdTreeSelectBlockSize;
+      int last = std::min(first + vtkKdTreeSelectBlockSize,
+                          this->NumberOfPoints);
+      float *value = this->Values + this->Offsets[block];
+      for (int i = first; i < last; ++i)
+        {
+        float x = this->X[3*i];
+        if (this->Range.Contains(x))
+          {
+          *value++ = x;
+          }
+        }
+      }
     }
+};
 
-  int nleft = kd->GetLeft()->GetNumberOfPoints();
+// Count, in each block, the values below the median and their maximum, then
+// move the points below the median, and the others after them, keeping
+// their order.
+class vtkKdTreeCountBelow
+{
+public:
+  const float *X;
+  int NumberOfPoints;
+  float Median;
+  int *NumberBelow;
+  float *MaxBelow;
 
-  int *leftIds  = ids;
-  int *rightIds = ids ? ids + nleft : NULL;
+  void operator()(vtkIdType begin, vtkIdType end) const
+    {
+    for (vtkIdType block = begin; block < end; ++block)
+      {
+      int first = static_cast<int>(block) * vtkKdTreeSelectBlockSize;
+      int last = std::min(first + vtkKdTreeSelectBlockSize,
+                          this->NumberOfPoints);
+      int below = 0;
+      float maxBelow = this->Median;
+      for (int i = first; i < last; ++i)
+        {
+        float x = this->X[3*i];
+        if (x < this->Median)
+          {
+          maxBelow = (below == 0 || x > maxBelow) ? x : maxBelow;
+          ++below;
+          }
+        }
+      this->NumberBelow[block] = below;
+      this->MaxBelow[block] = maxBelow;
+      }
+    }
+};
 
-  this->DivideRegion(kd->GetLeft(), c1, leftIds, level + 1);
+class vtkKdTreeSplitPoints
+{
+public:
+  const float *C1;
+  const int *Ids;
+  int Dim;
+  int NumberOfPoints;
+  float Median;
+  const int *LeftOffsets;
+  const int *RightOffsets;
+  float *NewC1;
+  int *NewIds;
 
-  this->DivideRegion(kd->GetRight(), c1 + nleft*3, rightIds, level + 1);
+  void operator()(vtkIdType begin, vtkIdType end) const
+    {
+    for (vtkIdType block = begin; block < end; ++block)
+      {
+      int first = static_cast<int>(block) * vtkKdTreeSelectBlockSize;
+      int last = std::min(first + vtkKdTreeSelectBlockSize,
+                          this->NumberOfPoints);
+      int left = this->LeftOffsets[block];
+      int right = this->RightOffsets[block];
+      for (int i = first; i < last; ++i)
+        {
+        int j = (this->C1[3*i + this->Dim] < this->Median) ?
+          left++ : right++;
+        this->NewC1[3*j] = this->C1[3*i];
+        this->NewC1[3*j + 1] = this->C1[3*i + 1];
+        this->NewC1[3*j + 2] = this->C1[3*i + 2];
+        if (this->Ids)
+          {
+          this->NewIds[j] = this->Ids[i];
+          }
+        }
+      }
+    }
+};
 
-  return 0;
+class vtkKdTreeCopyPoints
+{
+public:
+  const float *NewC1;
+  const int *NewIds;
+  float *C1;
+  int *Ids;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+    {
+    std::copy(this->NewC1 + 3*begin, this->NewC1 + 3*end, this->C1 + 3*begin);
+    if (this->Ids)
+      {
+      std::copy(this->NewIds + begin, this->NewIds + end, this->Ids + begin);
+      }
+    }
+};
+
+// Return the value of the given rank among the values of a coordinate.
+float vtkKdTreeFindMedian(const float *X, int nvals, int rank,
+                          int numBlocks)
+{
+  // Bracket the rank between two values of a regular sample.
+  const int sampleSize = 4096;
+  const int margin = 192;
+  std::vector<float> sample(sampleSize);
+  for (int i = 0; i < sampleSize; ++i)
+    {
+    sample[i] = X[3 * static_cast<int>(
+                    static_cast<vtkTypeInt64>(i) * nvals / sampleSize)];
+    }
+  std::sort(sample.begin(), sample.end());
+  int sampleRank = static_cast<int>(
+    static_cast<vtkTypeInt64>(rank) * sampleSize / nvals);
+  vtkKdTreeValueRange range;
+  range.HasLow = (sampleRank - margin >= 0);
+  range.Low = range.HasLow ? sample[sampleRank - margin] : 0.0f;
+  range.HasHigh = (sampleRank + margin < sampleSize);
+  range.High = range.HasHigh ? sample[sampleRank + margin] : 0.0f;
+
+  std::vector<int> below(numBlocks), inRange(numBlocks + 1);
+  vtkKdTreeCountInRange counter =
+    { X, nvals, range, &below[0], &inRange[0] };
+  vtkSMPTools::For(0, numBlocks, 1, counter);
+  int numBelow = 0;
+  int offset = 0;
+  for (int block = 0; block < numBlocks; ++block)
+    {
+    numBelow += below[block];
+    int count = inRange[block];
+    inRange[block] = offset;
+    offset += count;
+    }
+  inRange[numBlocks] = offset;
+
+  if (numBelow > rank || numBelow + offset <= rank)
+    {
+    // The sample missed the rank: search among all the values.
+    range.HasLow = range.HasHigh = false;
+    numBelow = 0;
+    for (int block = 0; block <= numBlocks; ++block)
+      {
+      inRange[block] = std::min(block * vtkKdTreeSelectBlockSize, nvals);
+      }
+    }
+
+  std::vector<float> values(inRange[numBlocks]);
+  vtkKdTreeGatherInRange gatherer = { X, nvals, range, &inRange[0],
+                                      &values[0] };
+  vtkSMPTools::For(0, numBlocks, 1, gatherer);
+  std::nth_element(values.begin(), values.begin() + (rank - numBelow),
+                   values.end());
+  return values[rank - numBelow];
+}
+
+int vtkKdTreeSelectInParallel(int dim, float *c1, int *ids, int nvals,
+                              double &coord)
+{
+  int numBlocks =
+    (nvals + vtkKdTreeSelectBlockSize - 1) / vtkKdTreeSelectBlockSize;
+  float median = vtkKdTreeFindMedian(c1 + dim, nvals, nvals / 2, numBlocks);
+
+  std::vector<int> below(numBlocks), leftOffsets(numBlocks),
+    rightOffsets(numBlocks);
+  std::vector<float> maxBelow(numBlocks);
+  vtkKdTreeCountBelow counter =
+    { c1 + dim, nvals, median, &below[0], &maxBelow[0] };
+  vtkSMPTools::For(0, numBlocks, 1, counter);
+  int nleft = 0;
+  float leftMax = median;
+  for (int block = 0; block < numBlocks; ++block)
+    {
+    leftOffsets[block] = nleft;
+    if (below[block] > 0)
+      {
+      leftMax = (nleft == 0 || maxBelow[block] > leftMax) ?
+        maxBelow[block] : leftMax;
+      nleft += below[block];
+      }
+    }
+  if (nleft == 0)
+    {
+    return 0;     // failed to divide region
+    }
+  int nright = nleft;
+  for (int block = 0; block < numBlocks; ++block)
+    {
+    int first = block * vtkKdTreeSelectBlockSize;
+    rightOffsets[block] = nright;
+    nright += std::min(vtkKdTreeSelectBlockSize, nvals - first) - below[block];
+    }
+
+  std::vector<float> newC1(3 * static_cast<size_t>(nvals));
+  std::vector<int> newIds(ids ? nvals : 0);
+  vtkKdTreeSplitPoints splitter =
+    { c1, ids, dim, nvals, median, &leftOffsets[0], &rightOffsets[0],
+      &newC1[0], ids ? &newIds[0] : NULL };
+  vtkSMPTools::For(0, numBlocks, 1, splitter);
+  vtkKdTreeCopyPoints copier =
+    { &newC1[0], ids ? &newIds[0] : NULL, c1, ids };
+  vtkSMPTools::For(0, nvals, copier);
+
+  coord = (static_cast<double>(median) + static_cast<double>(leftMax)) / 2.0;
+  return nleft;
+}
 }
 
 //----------------------------------------------------------------------------
@@ -1316,7 +1709,9 @@ void vtkKdTree::DoMedianFind(vtkKdNode *kd, float *c1, int *ids,
       break;
       }
 
-    midpt = vtkKdTree::Select(dims[dim], c1, ids, npoints, coord);
+    midpt = (npoints >= vtkKdTreeParallelSelectSize) ?
+      vtkKdTreeSelectInParallel(dims[dim], c1, ids, npoints, coord) :
+      vtkKdTree::Select(dims[dim], c1, ids, npoints, coord);
 
     if (midpt == 0)
       {
@@ -1824,22 +2219,17 @@ void vtkKdTree::BuildLocatorFromPoints(vtkPoints **ptArrays, int numPtArrays)
     else
       {
       // Hopefully point arrays are usually floats.  This conversion will
-      // really slow things down.
+      // really slow things down, so it is done in parallel.
 
-      for (vtkIdType ii=0; ii<npoints; ii++)
-        {
-        double *pt = ptArrays[i]->GetPoint(ii);
-
-        points[ptId++] = static_cast<float>(pt[0]);
-        points[ptId++] = static_cast<float>(pt[1]);
-        points[ptId++] = static_cast<float>(pt[2]);
-        }
+      ConvertPointsToFloat converter = { ptArrays[i], points + ptId };
+      vtkSMPTools::For(0, npoints, converter);
+      ptId += nvals;
       }
     }
 
   for (ptId=0; ptId<totalNumPoints; ptId++)
     {
-    // _Select dominates DivideRegion algorithm, operating on
+    // _Select dominates the division of the regions, operating on
     // ints is much fast than operating on long longs
 
     ptIds[ptId] = ptId;
@@ -1849,7 +2239,7 @@ void vtkKdTree::BuildLocatorFromPoints(vtkPoints **ptArrays, int numPtArrays)
 
   TIMER("Build tree");
 
-  this->DivideRegion(kd, points, ptIds, 0);
+  this->DivideRegionsInParallel(kd, points, ptIds);
 
   this->SetActualLevel();
   this->BuildRegionList();
@@ -2368,12 +2758,11 @@ int vtkKdTree::FindClosestPointInSphere(double x, double y, double z,
     }
   int *regionIds = new int [this->NumberOfRegions];
 
-  this->BSPCalculator->ComputeIntersectionsUsingDataBoundsOn();
-
+  // Walk the tree directly rather than through BSPCalculator: switching its
+  // ComputeIntersectionsUsingDataBounds option would race with concurrent
+  // queries.
   int nRegions =
-    this->BSPCalculator->IntersectsSphere2(regionIds, this->NumberOfRegions, x, y, z, radius*radius);
-
-  this->BSPCalculator->ComputeIntersectionsUsingDataBoundsOff();
+    RegionsIntersectingSphere2(this->Top, regionIds, x, y, z, radius*radius);
 
   double minDistance2 = 4 * this->MaxWidth * this->MaxWidth;
   int localCloseId = -1;
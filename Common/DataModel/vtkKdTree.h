@@ -678,7 +678,14 @@ protected:
   // Recursive helper for public FindPointsInArea
   void AddAllPointsInRegion(vtkKdNode* node, vtkIdTypeArray* ids);
 
-  int DivideRegion(vtkKdNode *kd, float *c1, int *ids, int nlevels);
+  // Divide a region in two, without dividing its children. Returns 1 if the
+  // region has been divided.
+  int DivideRegionOnce(vtkKdNode *kd, float *c1, int *ids, int level);
+
+  // Divide a region and its children, level by level, the regions of each
+  // level being divided in parallel with vtkSMPTools.
+  void DivideRegionsInParallel(vtkKdNode *kd, float *c1, int *ids);
+  friend class vtkKdTreeDivideLevel;
 
   void DoMedianFind(vtkKdNode *kd, float *c1, int *ids, int d1, int d2, int d3);
 
@@ -73,19 +73,25 @@ void vtkKdTreePointLocator::FreeSearchStructure()
 
 void vtkKdTreePointLocator::BuildLocator()
 {
-  if(!this->KdTree)
+  // Rebuild only if the locator or the points have changed, so that the
+  // queries do not modify the locator once it is built.
+  if(this->KdTree && this->DataSet &&
+     (this->BuildTime > this->MTime) &&
+     (this->BuildTime > this->DataSet->GetMTime()))
     {
-    vtkPointSet* pointSet = vtkPointSet::SafeDownCast(this->GetDataSet());
-    if(!pointSet)
-      {
-      vtkErrorMacro("vtkKdTreePointLocator requires a PointSet to build locator.");
-      return;
-      }
-    this->KdTree = vtkKdTree::New();
-    this->KdTree->BuildLocatorFromPoints(pointSet);
-    this->KdTree->GetBounds(this->Bounds);
-    this->Modified();
+    return;
     }
+  vtkPointSet* pointSet = vtkPointSet::SafeDownCast(this->GetDataSet());
+  if(!pointSet)
+    {
+    vtkErrorMacro("vtkKdTreePointLocator requires a PointSet to build locator.");
+    return;
+    }
+  this->FreeSearchStructure();
+  this->KdTree = vtkKdTree::New();
+  this->KdTree->BuildLocatorFromPoints(pointSet);
+  this->KdTree->GetBounds(this->Bounds);
+  this->BuildTime.Modified();
 }
 
 void vtkKdTreePointLocator::GenerateRepresentation(int level, vtkPolyData *pd)
@@ -21,10 +21,7 @@
 #include "vtkInformationVector.h"
 #include "vtkPointLocator.h"
 #include "vtkPointSetCellIterator.h"
-
-#include "vtkSmartPointer.h"
-#define VTK_CREATE(type, name) \
-  vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
+#include "vtkScratchPool.h"
 
 #include <set>
 
@@ -35,6 +32,7 @@ vtkPointSet::vtkPointSet ()
 {
   this->Points = NULL;
   this->Locator = NULL;
+  this->ScratchPool = vtkScratchPool::New();
 }
 
 //----------------------------------------------------------------------------
@@ -47,6 +45,7 @@ vtkPointSet::~vtkPointSet ()
     this->Locator->UnRegister(this);
     this->Locator = NULL;
     }
+  this->ScratchPool->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -265,18 +264,18 @@ vtkIdType vtkPointSet::FindCell(double x[3], vtkCell *cell,
     this->Locator->SetDataSet(this);
     this->Locator->BuildLocator();
     }
-
   if ( this->Points->GetMTime() > this->Locator->GetBuildTime() )
     {
     this->Locator->SetDataSet(this);
     this->Locator->BuildLocator();
     }
 
+  // The id lists are taken from a per-thread pool instead of being created
+  // for every query.
   std::set<vtkIdType> visitedCells;
-  VTK_CREATE(vtkIdList, ptIds);
-  ptIds->Allocate(8, 100);
-  VTK_CREATE(vtkIdList, neighbors);
-  neighbors->Allocate(8, 100);
+  vtkScratchPool::Scope scope(this->ScratchPool);
+  vtkIdList *ptIds = this->ScratchPool->GetIdList();
+  vtkIdList *neighbors = this->ScratchPool->GetIdList();
 
   // If we are given a starting cell, try that.
   if (cell && (cellId >= 0))
@@ -287,8 +286,7 @@ vtkIdType vtkPointSet::FindCell(double x[3], vtkCell *cell,
     if (foundCell >= 0) return foundCell;
     }
 
-  VTK_CREATE(vtkIdList, cellIds);
-  cellIds->Allocate(8,100);
+  vtkIdList *cellIds = this->ScratchPool->GetIdList();
 
   // Now find the point closest to the coordinates given and search from the
   // adjacent cells.
@@ -309,8 +307,7 @@ vtkIdType vtkPointSet::FindCell(double x[3], vtkCell *cell,
   // unnecessary.
   double ptCoord[3];
   this->GetPoint(ptId, ptCoord);
-  VTK_CREATE(vtkIdList, coincidentPtIds);
-  coincidentPtIds->Allocate(8, 100);
+  vtkIdList *coincidentPtIds = this->ScratchPool->GetIdList();
   this->Locator->FindPointsWithinRadius(tol2, ptCoord, coincidentPtIds);
   coincidentPtIds->DeleteId(ptId);      // Already searched this one.
   for (vtkIdType i = 0; i < coincidentPtIds->GetNumberOfIds(); i++)
@@ -32,6 +32,7 @@
 #include "vtkPoints.h" // Needed for inline methods
 
 class vtkPointLocator;
+class vtkScratchPool;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkPointSet : public vtkDataSet
 {
@@ -116,6 +117,7 @@ protected:
 
   vtkPoints *Points;
   vtkPointLocator *Locator;
+  vtkScratchPool *ScratchPool; // id lists used by FindCell()
 
   virtual void ReportReferences(vtkGarbageCollector*);
 private:
@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkPolyData.h"
 
+#include "vtkCallbackCommand.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCriticalSection.h"
@@ -36,6 +37,9 @@
 
 #include "vtkSmartPointer.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkPolyData);
 
 //----------------------------------------------------------------------------
@@ -66,11 +70,29 @@ vtkPolyData::vtkPolyData () :
   this->Information->Set(vtkDataObject::DATA_PIECE_NUMBER(), -1);
   this->Information->Set(vtkDataObject::DATA_NUMBER_OF_PIECES(), 1);
   this->Information->Set(vtkDataObject::DATA_NUMBER_OF_GHOST_LEVELS(), 0);
+
+  this->CellArraysObserver = vtkCallbackCommand::New();
+  this->CellArraysObserver->SetCallback(&vtkPolyData::OnCellArrayModified);
+  this->CellArraysObserver->SetClientData(this);
+  std::fill_n(this->CellArrayLayouts, 4, vtkCellArray::LEGACY_LAYOUT);
 }
 
 //----------------------------------------------------------------------------
 vtkPolyData::~vtkPolyData()
 {
+  // the cell arrays may outlive this data set
+  this->CellArraysObserver->SetClientData(NULL);
+  vtkCellArray *arrays[4] = { this->Verts, this->Lines, this->Polys,
+                              this->Strips };
+  for (int i = 0; i < 4; ++i)
+    {
+    if ( arrays[i] )
+      {
+      arrays[i]->RemoveObserver(this->CellArraysObserver);
+      }
+    }
+  this->CellArraysObserver->Delete();
+
   this->Cleanup();
 
   if (this->Vertex)
@@ -947,11 +969,24 @@ void vtkPolyData::BuildCells()
   vtkIntArray *locs = vtkIntArray::New();
   int *pLocs = locs->WritePointer(0, nCells);
 
-  // record locations and type of each cell.
+  // record locations and type of each cell. With the offsets layout of
+  // vtkCellArray the location of a cell is its id within the cell array.
   // verts
   vtkIdType numCellPts;
   vtkIdType nextCellPts;
-  if (nVerts)
+  if (nVerts &&
+      vertCells->GetStorageLayout() == vtkCellArray::OFFSETS_LAYOUT)
+    {
+    for (vtkIdType i = 0; i < nVerts; ++i)
+      {
+      numCellPts = vertCells->GetCellSize(i);
+      pLocs[i] = i;
+      pTypes[i] = numCellPts > 1 ? VTK_POLY_VERTEX : VTK_VERTEX;
+      }
+    pLocs += nVerts;
+    pTypes += nVerts;
+    }
+  else if (nVerts)
     {
     vtkIdType *pVerts = vertCells->GetData()->GetPointer(0);
     numCellPts = pVerts[0];
@@ -970,7 +1005,19 @@ void vtkPolyData::BuildCells()
     }
 
   // lines
-  if (nLines)
+  if (nLines &&
+      lineCells->GetStorageLayout() == vtkCellArray::OFFSETS_LAYOUT)
+    {
+    for (vtkIdType i = 0; i < nLines; ++i)
+      {
+      numCellPts = lineCells->GetCellSize(i);
+      pLocs[i] = i;
+      pTypes[i] = numCellPts > 2 ? VTK_POLY_LINE : VTK_LINE;
+      }
+    pLocs += nLines;
+    pTypes += nLines;
+    }
+  else if (nLines)
     {
     vtkIdType *pLines = lineCells->GetData()->GetPointer(0);
     numCellPts = pLines[0];
@@ -989,7 +1036,20 @@ void vtkPolyData::BuildCells()
     }
 
   // polys
-  if (nPolys)
+  if (nPolys &&
+      polyCells->GetStorageLayout() == vtkCellArray::OFFSETS_LAYOUT)
+    {
+    for (vtkIdType i = 0; i < nPolys; ++i)
+      {
+      numCellPts = polyCells->GetCellSize(i);
+      pLocs[i] = i;
+      pTypes[i] = numCellPts == 3 ? VTK_TRIANGLE :
+        numCellPts == 4 ? VTK_QUAD : VTK_POLYGON;
+      }
+    pLocs += nPolys;
+    pTypes += nPolys;
+    }
+  else if (nPolys)
     {
     vtkIdType *pPolys = polyCells->GetData()->GetPointer(0);
     numCellPts = pPolys[0];
@@ -1010,7 +1070,16 @@ void vtkPolyData::BuildCells()
     }
 
   // strips
-  if (nStrips)
+  if (nStrips &&
+      stripCells->GetStorageLayout() == vtkCellArray::OFFSETS_LAYOUT)
+    {
+    std::fill_n(pTypes, nStrips, VTK_TRIANGLE_STRIP);
+    for (vtkIdType i = 0; i < nStrips; ++i)
+      {
+      pLocs[i] = i;
+      }
+    }
+  else if (nStrips)
     {
     std::fill_n(pTypes, nStrips, VTK_TRIANGLE_STRIP);
     vtkIdType *pStrips = stripCells->GetData()->GetPointer(0);
@@ -1032,6 +1101,7 @@ void vtkPolyData::BuildCells()
   this->Cells->Delete();
   types->Delete();
   locs->Delete();
+  this->ObserveCellArrays();
 }
 
 //----------------------------------------------------------------------------
@@ -1074,25 +1144,126 @@ void vtkPolyData::BuildLinks(int initialSize)
   this->Links->BuildLinks(this);
 }
 
+//----------------------------------------------------------------------------
+// Record the storage layouts in which the locations of the cells are
+// expressed, and observe the cell arrays to follow their changes.
+void vtkPolyData::ObserveCellArrays()
+{
+  vtkCellArray *arrays[4] = { this->Verts, this->Lines, this->Polys,
+                              this->Strips };
+  for (int i = 0; i < 4; ++i)
+    {
+    if ( arrays[i] )
+      {
+      this->CellArrayLayouts[i] = arrays[i]->GetStorageLayout();
+      if ( !arrays[i]->HasObserver(vtkCommand::ModifiedEvent,
+                                   this->CellArraysObserver) )
+        {
+        arrays[i]->AddObserver(vtkCommand::ModifiedEvent,
+                               this->CellArraysObserver);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPolyData::OnCellArrayModified(vtkObject *source, unsigned long,
+                                      void *clientdata, void *)
+{
+  vtkPolyData *self = static_cast<vtkPolyData*>(clientdata);
+  if ( !self || !self->Cells )
+    {
+    return;
+    }
+  vtkCellArray *arrays[4] = { self->Verts, self->Lines, self->Polys,
+                              self->Strips };
+  for (int i = 0; i < 4; ++i)
+    {
+    if ( arrays[i] == source &&
+         arrays[i]->GetStorageLayout() != self->CellArrayLayouts[i] )
+      {
+      self->UpdateCellLocations(arrays[i]);
+      self->CellArrayLayouts[i] = arrays[i]->GetStorageLayout();
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Express the locations of the cells of a cell array in its new storage
+// layout: offsets into the legacy list become cell ids, and conversely. The
+// cell types may be shared with shallow copies, so they are replaced by an
+// updated copy.
+void vtkPolyData::UpdateCellLocations(vtkCellArray *cells)
+{
+  // the offsets of the cells in the legacy list
+  std::vector<vtkIdType> legacyLocs;
+  legacyLocs.reserve(cells->GetNumberOfCells());
+  int toLegacy = (cells->GetStorageLayout() == vtkCellArray::LEGACY_LAYOUT);
+  vtkIdType loc = 0;
+  if ( toLegacy )
+    {
+    vtkIdTypeArray *data = cells->GetData();
+    for (; loc <= data->GetMaxId(); loc += data->GetValue(loc) + 1)
+      {
+      legacyLocs.push_back(loc);
+      }
+    }
+  else
+    {
+    for (vtkIdType i = 0; i < cells->GetNumberOfCells(); ++i)
+      {
+      legacyLocs.push_back(loc);
+      loc += cells->GetCellSize(i) + 1;
+      }
+    }
+
+  vtkIdType numLocs = static_cast<vtkIdType>(legacyLocs.size());
+  vtkIdType numCells = this->Cells->GetNumberOfTypes();
+  vtkCellTypes *cellTypes = vtkCellTypes::New();
+  cellTypes->Allocate(numCells, 3*numCells);
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+    unsigned char type = this->Cells->GetCellType(cellId);
+    loc = this->Cells->GetCellLocation(cellId);
+    if ( this->GetCellArrayForType(type) == cells && toLegacy )
+      {
+      loc = (loc < numLocs ? legacyLocs[loc] : loc);
+      }
+    else if ( this->GetCellArrayForType(type) == cells )
+      {
+      loc = std::lower_bound(legacyLocs.begin(), legacyLocs.end(), loc) -
+        legacyLocs.begin();
+      }
+    cellTypes->InsertCell(cellId, type, static_cast<int>(loc));
+    }
+
+  this->Cells->UnRegister(this);
+  this->Cells = cellTypes;
+  this->Cells->Register(this);
+  cellTypes->Delete();
+}
+
 //----------------------------------------------------------------------------
 // Copy a cells point ids into list provided. (Less efficient.)
 void vtkPolyData::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
 {
-  vtkIdType i;
-  vtkIdType *pts, npts;
-
   ptIds->Reset();
   if ( this->Cells == NULL )
     {
     this->BuildCells();
     }
 
-  this->vtkPolyData::GetCellPoints(cellId, npts, pts);
-  ptIds->InsertId (npts-1,pts[npts-1]);
-  for (i=0; i<npts-1; i++)
+  vtkCellArray *cells =
+    this->GetCellArrayForType(this->Cells->GetCellType(cellId));
+  if ( !cells )
     {
-    ptIds->SetId(i,pts[i]);
+    return;
     }
+
+  // copy straight into the list: the pointer version may go through the
+  // buffer shared by the callers of a cell array using 32-bit storage,
+  // which would make this method unsafe to call from several threads
+  cells->GetCell(this->Cells->GetCellLocation(cellId), ptIds);
 }
 
 //----------------------------------------------------------------------------
@@ -1154,6 +1325,7 @@ void vtkPolyData::Allocate(vtkIdType numCells, int extSize)
   cells->Allocate(numCells,extSize);
   this->SetStrips(cells);
   cells->Delete();
+  this->ObserveCellArrays();
 }
 
 void vtkPolyData::Allocate(vtkPolyData *inPolyData, vtkIdType numCells,
@@ -1212,6 +1384,7 @@ void vtkPolyData::Allocate(vtkPolyData *inPolyData, vtkIdType numCells,
     this->SetStrips(cells);
     cells->Delete();
     }
+  this->ObserveCellArrays();
 }
 
 //----------------------------------------------------------------------------
@@ -1230,6 +1403,7 @@ vtkIdType vtkPolyData::InsertNextCell(int type, int npts, vtkIdType *pts)
     // number of cells, so this guess is as good as any
     this->Cells = vtkCellTypes::New();
     this->Cells->Allocate(5000,10000);
+    this->ObserveCellArrays();
     }
 
   switch (type)
@@ -1293,6 +1467,7 @@ vtkIdType vtkPolyData::InsertNextCell(int type, vtkIdList *pts)
     {
     this->Cells = vtkCellTypes::New();
     this->Cells->Allocate(5000,10000);
+    this->ObserveCellArrays();
     }
 
   switch (type)
@@ -1351,18 +1526,22 @@ void vtkPolyData::Squeeze()
 {
   if ( this->Verts != NULL )
     {
+    this->Verts->ConvertToSmallestStorage(this->GetNumberOfPoints());
     this->Verts->Squeeze();
     }
   if ( this->Lines != NULL )
     {
+    this->Lines->ConvertToSmallestStorage(this->GetNumberOfPoints());
     this->Lines->Squeeze();
     }
   if ( this->Polys != NULL )
     {
+    this->Polys->ConvertToSmallestStorage(this->GetNumberOfPoints());
     this->Polys->Squeeze();
     }
   if ( this->Strips != NULL )
     {
+    this->Strips->ConvertToSmallestStorage(this->GetNumberOfPoints());
     this->Strips->Squeeze();
     }
 
@@ -1786,6 +1965,7 @@ void vtkPolyData::ShallowCopy(vtkDataObject *dataObject)
     if (this->Cells)
       {
       this->Cells->Register(this);
+      this->ObserveCellArrays();
       }
 
     if (this->Links)
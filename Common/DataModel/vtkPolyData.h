@@ -61,6 +61,7 @@
 #include "vtkCellLinks.h" // Needed for inline methods
 #include "vtkCellArray.h" // Needed for inline methods
 
+class vtkCallbackCommand;
 class vtkVertex;
 class vtkPolyVertex;
 class vtkLine;
@@ -123,7 +124,9 @@ public:
   // Recover extra allocated memory when creating data whose initial size
   // is unknown. Examples include using the InsertNextCell() method, or
   // when using the CellArray::EstimateSize() method to create vertices,
-  // lines, polygons, or triangle strips.
+  // lines, polygons, or triangle strips. Cell arrays using the offsets
+  // layout are also converted to the smallest integer storage able to index
+  // the points (see vtkCellArray::ConvertToSmallestStorage()).
   void Squeeze();
 
   // Description:
@@ -268,7 +271,9 @@ public:
   // Get a pointer to the cell, ie [npts pid1 .. pidn]. More efficient
   // because pointer points directly to cell array internals and this
   // is not a virtual call. However, this requires that cells have been
-  // built (with BuildCells()). The cell type is returned.
+  // built (with BuildCells()). The cell type is returned. With the offsets
+  // layout of vtkCellArray, which stores no such block, the cell is copied
+  // into a buffer of the calling thread (see vtkCellArray::GetLegacyCell()).
   unsigned char GetCell(vtkIdType cellId, vtkIdType* &pts);
 
   // Description:
@@ -479,6 +484,20 @@ protected:
   vtkCellTypes *Cells;
   vtkCellLinks *Links;
 
+  // The cell array holding the cells of the given type (NULL for the types
+  // that vtkPolyData does not hold).
+  vtkCellArray *GetCellArrayForType(unsigned char type);
+
+  // The locations of the cells depend on the storage layout of the cell
+  // arrays (see vtkCellArray::SetStorageLayout()), which are observed once
+  // the cells are built to update the locations when it changes.
+  vtkCallbackCommand *CellArraysObserver;
+  int CellArrayLayouts[4]; // layouts of Verts, Lines, Polys and Strips
+  void ObserveCellArrays();
+  void UpdateCellLocations(vtkCellArray *cells);
+  static void OnCellArrayModified(vtkObject *source, unsigned long eid,
+                                  void *clientdata, void *calldata);
+
 private:
   // Hide these from the user and the compiler.
 
@@ -584,54 +603,54 @@ inline void vtkPolyData::ResizeCellList(vtkIdType ptId, int size)
   this->Links->ResizeCellList(ptId,size);
 }
 
-inline void vtkPolyData::ReplaceCellPoint(vtkIdType cellId, vtkIdType oldPtId,
-                                          vtkIdType newPtId)
+inline vtkCellArray *vtkPolyData::GetCellArrayForType(unsigned char type)
 {
-  int i;
-  vtkIdType *verts, nverts;
-
-  this->GetCellPoints(cellId,nverts,verts);
-  for ( i=0; i < nverts; i++ )
-    {
-    if ( verts[i] == oldPtId )
-      {
-      verts[i] = newPtId; // this is very nasty! direct write!
-      return;
-      }
-    }
-}
-
-inline unsigned char vtkPolyData::GetCellPoints(
-    vtkIdType cellId, vtkIdType& npts, vtkIdType* &pts)
-{
-  unsigned char type = this->Cells->GetCellType(cellId);
-  vtkCellArray *cells;
   switch (type)
     {
     case VTK_VERTEX: case VTK_POLY_VERTEX:
-      cells = this->Verts;
-      break;
+      return this->Verts;
 
     case VTK_LINE: case VTK_POLY_LINE:
-      cells = this->Lines;
-      break;
+      return this->Lines;
 
     case VTK_TRIANGLE: case VTK_QUAD: case VTK_POLYGON:
-      cells = this->Polys;
-      break;
+      return this->Polys;
 
     case VTK_TRIANGLE_STRIP:
-      cells = this->Strips;
-      break;
+      return this->Strips;
 
     default:
-      cells = NULL;
-      npts = 0;
-      pts = NULL;
-      return 0;
+      return NULL;
     }
-  int loc = this->Cells->GetCellLocation(cellId);
-  cells->GetCell(loc, npts, pts);
+}
+
+inline void vtkPolyData::ReplaceCellPoint(vtkIdType cellId, vtkIdType oldPtId,
+                                          vtkIdType newPtId)
+{
+  vtkCellArray *cells =
+    this->GetCellArrayForType(this->Cells->GetCellType(cellId));
+  if ( !cells )
+    {
+    return;
+    }
+  // written through the cell array, since the pointer returned by
+  // GetCellPoints() may refer to a copy of the cell (32-bit storage)
+  cells->ReplaceCellPoint(this->Cells->GetCellLocation(cellId),
+                          oldPtId, newPtId);
+}
+
+inline unsigned char vtkPolyData::GetCellPoints(
+    vtkIdType cellId, vtkIdType& npts, vtkIdType* &pts)
+{
+  unsigned char type = this->Cells->GetCellType(cellId);
+  vtkCellArray *cells = this->GetCellArrayForType(type);
+  if ( !cells )
+    {
+    npts = 0;
+    pts = NULL;
+    return 0;
+    }
+  cells->GetCell(this->Cells->GetCellLocation(cellId), npts, pts);
   return type;
 }
 
@@ -639,32 +658,13 @@ inline unsigned char vtkPolyData::GetCell(
     vtkIdType cellId, vtkIdType* &cell)
 {
   unsigned char type = this->Cells->GetCellType(cellId);
-  vtkCellArray *cells;
-  switch (type)
+  vtkCellArray *cells = this->GetCellArrayForType(type);
+  if ( !cells )
     {
-    case VTK_VERTEX: case VTK_POLY_VERTEX:
-      cells = this->Verts;
-      break;
-
-    case VTK_LINE: case VTK_POLY_LINE:
-      cells = this->Lines;
-      break;
-
-    case VTK_TRIANGLE: case VTK_QUAD: case VTK_POLYGON:
-      cells = this->Polys;
-      break;
-
-    case VTK_TRIANGLE_STRIP:
-      cells = this->Strips;
-      break;
-
-    default:
-      cells = NULL;
-      cell = NULL;
-      return 0;
+    cell = NULL;
+    return 0;
     }
-  int loc = this->Cells->GetCellLocation(cellId);
-  cell = cells->GetData()->GetPointer(loc);
+  cell = cells->GetLegacyCell(this->Cells->GetCellLocation(cellId));
   return type;
 }
 
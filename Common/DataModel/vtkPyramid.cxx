@@ -485,6 +485,12 @@ int *vtkPyramid::GetFaceArray(int faceId)
   return faces[faceId];
 }
 
+//----------------------------------------------------------------------------
+int *vtkPyramid::GetTriangleCases(int caseId)
+{
+  return triCases[caseId].edges;
+}
+
 //----------------------------------------------------------------------------
 vtkCell *vtkPyramid::GetFace(int faceId)
 {
@@ -0,0 +1,167 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkScratchPool.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkScratchPool.h"
+
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkSMPThreadLocal.h"
+
+#include <vector>
+
+vtkStandardNewMacro(vtkScratchPool);
+
+//----------------------------------------------------------------------------
+// The objects owned by the pool of one thread. The first NumberOfXXX
+// objects of each vector are in use.
+struct vtkScratchPoolStorage
+{
+  std::vector<vtkIdList*> IdLists;
+  std::vector<vtkGenericCell*> Cells;
+  std::vector<vtkPoints*> Points;
+  size_t NumberOfIdLists;
+  size_t NumberOfCells;
+  size_t NumberOfPoints;
+
+  vtkScratchPoolStorage() :
+    NumberOfIdLists(0), NumberOfCells(0), NumberOfPoints(0)
+  {
+  }
+};
+
+class vtkScratchPoolInternals
+{
+public:
+  vtkSMPThreadLocal<vtkScratchPoolStorage> Storage;
+};
+
+namespace
+{
+// Return the next free object of the given vector, creating it if needed.
+template <class T>
+T *vtkScratchPoolNext(std::vector<T*> &objects, size_t &numberInUse)
+{
+  if (numberInUse == objects.size())
+    {
+    objects.push_back(T::New());
+    }
+  return objects[numberInUse++];
+}
+
+template <class T>
+void vtkScratchPoolDelete(std::vector<T*> &objects)
+{
+  for (size_t i=0; i < objects.size(); ++i)
+    {
+    objects[i]->Delete();
+    }
+  objects.clear();
+}
+}
+
+//----------------------------------------------------------------------------
+vtkScratchPool::vtkScratchPool()
+{
+  this->Internals = new vtkScratchPoolInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkScratchPool::~vtkScratchPool()
+{
+  this->ReleaseAll();
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+vtkIdList *vtkScratchPool::GetIdList()
+{
+  vtkScratchPoolStorage &storage = this->Internals->Storage.Local();
+  vtkIdList *ids =
+    vtkScratchPoolNext(storage.IdLists, storage.NumberOfIdLists);
+  ids->Reset();
+  return ids;
+}
+
+//----------------------------------------------------------------------------
+vtkGenericCell *vtkScratchPool::GetGenericCell()
+{
+  vtkScratchPoolStorage &storage = this->Internals->Storage.Local();
+  return vtkScratchPoolNext(storage.Cells, storage.NumberOfCells);
+}
+
+//----------------------------------------------------------------------------
+vtkPoints *vtkScratchPool::GetPoints()
+{
+  vtkScratchPoolStorage &storage = this->Internals->Storage.Local();
+  vtkPoints *points =
+    vtkScratchPoolNext(storage.Points, storage.NumberOfPoints);
+  points->Reset();
+  return points;
+}
+
+//----------------------------------------------------------------------------
+void vtkScratchPool::ReleaseAll()
+{
+  vtkSMPThreadLocal<vtkScratchPoolStorage>::iterator iter;
+  for (iter = this->Internals->Storage.begin();
+       iter != this->Internals->Storage.end(); ++iter)
+    {
+    vtkScratchPoolDelete(iter->IdLists);
+    vtkScratchPoolDelete(iter->Cells);
+    vtkScratchPoolDelete(iter->Points);
+    iter->NumberOfIdLists = iter->NumberOfCells = iter->NumberOfPoints = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkScratchPool::GetNumberOfPooledObjects()
+{
+  vtkIdType number = 0;
+  vtkSMPThreadLocal<vtkScratchPoolStorage>::iterator iter;
+  for (iter = this->Internals->Storage.begin();
+       iter != this->Internals->Storage.end(); ++iter)
+    {
+    number += static_cast<vtkIdType>(
+      iter->IdLists.size() + iter->Cells.size() + iter->Points.size());
+    }
+  return number;
+}
+
+//----------------------------------------------------------------------------
+vtkScratchPool::Scope::Scope(vtkScratchPool *pool)
+{
+  this->Storage = &pool->Internals->Storage.Local();
+  this->NumberOfIdLists = this->Storage->NumberOfIdLists;
+  this->NumberOfCells = this->Storage->NumberOfCells;
+  this->NumberOfPoints = this->Storage->NumberOfPoints;
+}
+
+//----------------------------------------------------------------------------
+vtkScratchPool::Scope::~Scope()
+{
+  this->Storage->NumberOfIdLists = this->NumberOfIdLists;
+  this->Storage->NumberOfCells = this->NumberOfCells;
+  this->Storage->NumberOfPoints = this->NumberOfPoints;
+}
+
+//----------------------------------------------------------------------------
+void vtkScratchPool::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number Of Pooled Objects: "
+     << this->GetNumberOfPooledObjects() << "\n";
+}
@@ -0,0 +1,111 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkScratchPool.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkScratchPool - per-thread pool of scratch objects for cell loops
+// .SECTION Description
+// vtkScratchPool hands out the temporary vtkIdList, vtkGenericCell and
+// vtkPoints instances used while iterating over cells, so that hot loops
+// do not create and delete them (and go through the reference counting
+// machinery) for every cell. Each thread gets its own storage, so the same
+// pool may be used from within vtkSMPTools::For().
+//
+// Objects are requested inside a vtkScratchPool::Scope. They remain valid
+// until the scope in which they were obtained ends, at which point they are
+// given back to the pool of the calling thread, without being deleted, and
+// handed out again by later requests:
+// \code
+// vtkScratchPool::Scope scope(pool);
+// vtkIdList *ids = pool->GetIdList();
+// vtkGenericCell *cell = pool->GetGenericCell();
+// \endcode
+// Scopes may be nested. Objects requested outside of any scope are only
+// given back by ReleaseAll().
+
+// .SECTION Caveats
+// Pooled objects are owned by the pool: do not Delete() them, and do not
+// keep references to them once their scope is closed. The id lists and
+// points are Reset() when handed out, which keeps their allocated memory
+// (and, for vtkPoints, their data type).
+
+// .SECTION See Also
+// vtkSMPThreadLocal vtkGenericCell
+
+#ifndef vtkScratchPool_h
+#define vtkScratchPool_h
+
+#include "vtkCommonDataModelModule.h" // For export macro
+#include "vtkObject.h"
+
+class vtkGenericCell;
+class vtkIdList;
+class vtkPoints;
+class vtkScratchPoolInternals;
+struct vtkScratchPoolStorage;
+
+class VTKCOMMONDATAMODEL_EXPORT vtkScratchPool : public vtkObject
+{
+public:
+  static vtkScratchPool *New();
+  vtkTypeMacro(vtkScratchPool,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Return an empty id list, a generic cell or an empty set of points
+  // owned by the pool of the calling thread. They remain valid until the
+  // innermost enclosing Scope ends.
+  vtkIdList *GetIdList();
+  vtkGenericCell *GetGenericCell();
+  vtkPoints *GetPoints();
+
+  // Description:
+  // Delete the pooled objects of all threads. This must not be called
+  // while objects are in use or from within a parallel section.
+  void ReleaseAll();
+
+  // Description:
+  // Return the total number of objects held by the pool, over all threads.
+  // Intended for diagnostics and testing.
+  vtkIdType GetNumberOfPooledObjects();
+
+  // Description:
+  // Record the objects in use by the calling thread when constructed and
+  // give back to the pool those requested since then when destroyed.
+  class VTKCOMMONDATAMODEL_EXPORT Scope
+  {
+  public:
+    Scope(vtkScratchPool *pool);
+    ~Scope();
+
+  private:
+    vtkScratchPoolStorage *Storage;
+    size_t NumberOfIdLists;
+    size_t NumberOfCells;
+    size_t NumberOfPoints;
+
+    Scope(const Scope&);  // Not implemented.
+    void operator=(const Scope&);  // Not implemented.
+  };
+
+protected:
+  vtkScratchPool();
+  ~vtkScratchPool();
+
+  vtkScratchPoolInternals *Internals;
+
+private:
+  vtkScratchPool(const vtkScratchPool&);  // Not implemented.
+  void operator=(const vtkScratchPool&);  // Not implemented.
+};
+
+#endif
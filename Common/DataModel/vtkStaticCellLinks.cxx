@@ -13,7 +13,14 @@
 
 =========================================================================*/
 #include "vtkStaticCellLinks.h"
+
+#include "vtkCellArray.h"
+#include "vtkIdList.h"
 #include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
 
 vtkStandardNewMacro(vtkStaticCellLinks);
 
@@ -21,16 +28,102 @@ vtkStandardNewMacro(vtkStaticCellLinks);
 vtkStaticCellLinks::vtkStaticCellLinks()
 {
   this->Impl = new vtkStaticCellLinksTemplate<vtkIdType>;
+  this->Impl32 = NULL;
+  this->TempCells = vtkIdList::New();
+  this->EnableSMP = false;
 }
 
 //----------------------------------------------------------------------------
 vtkStaticCellLinks::~vtkStaticCellLinks()
 {
   delete this->Impl;
+  delete this->Impl32;
+  this->TempCells->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLinks::Initialize()
+{
+  this->Impl->Initialize();
+  delete this->Impl32;
+  this->Impl32 = NULL;
+}
+
+//----------------------------------------------------------------------------
+// Pick 32-bit links when the points, cells and connectivity of a dataset
+// storing its cells in vtkCellArrays fit; other datasets use vtkIdType.
+void vtkStaticCellLinks::BuildLinks(vtkDataSet *ds)
+{
+  this->Initialize();
+
+  int idType = VTK_ID_TYPE;
+  vtkIdType numPts = ds->GetNumberOfPoints();
+  vtkIdType numCells = ds->GetNumberOfCells();
+  if ( ds->GetDataObjectType() == VTK_UNSTRUCTURED_GRID )
+    {
+    vtkCellArray *cells = static_cast<vtkUnstructuredGrid*>(ds)->GetCells();
+    if ( cells )
+      {
+      idType = vtkAbstractCellLinks::GetIdType(numPts, numCells, cells);
+      }
+    }
+  else if ( ds->GetDataObjectType() == VTK_POLY_DATA )
+    {
+    vtkPolyData *pd = static_cast<vtkPolyData*>(ds);
+    vtkIdType numEntries =
+      pd->GetVerts()->GetNumberOfConnectivityEntries() +
+      pd->GetLines()->GetNumberOfConnectivityEntries() +
+      pd->GetPolys()->GetNumberOfConnectivityEntries() +
+      pd->GetStrips()->GetNumberOfConnectivityEntries();
+    vtkIdType max = std::max(std::max(numPts, numCells), numEntries);
+    idType = (max >= VTK_INT_MAX ? VTK_ID_TYPE : VTK_INT);
+    }
+
+  if ( idType != VTK_ID_TYPE && sizeof(vtkIdType) > sizeof(int) )
+    {
+    this->Impl32 = new vtkStaticCellLinksTemplate<int>;
+    this->Impl32->SetEnableSMP(this->EnableSMP);
+    this->Impl32->BuildLinks(ds);
+    }
+  else
+    {
+    this->Impl->SetEnableSMP(this->EnableSMP);
+    this->Impl->BuildLinks(ds);
+    }
+}
+
+//----------------------------------------------------------------------------
+const vtkIdType *vtkStaticCellLinks::CopyCells32(vtkIdType ptId)
+{
+  this->GetCells(ptId, this->TempCells);
+  return this->TempCells->GetPointer(0);
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLinks::GetCells(vtkIdType ptId, vtkIdList *cells)
+{
+  vtkIdType ncells = this->GetNumberOfCells(ptId);
+  cells->Reset();
+  vtkIdType *ids = cells->WritePointer(0, ncells);
+  if ( this->Impl32 )
+    {
+    const int *links = this->Impl32->GetCells(ptId);
+    std::copy(links, links+ncells, ids);
+    }
+  else
+    {
+    const vtkIdType *links = this->Impl->GetCells(ptId);
+    std::copy(links, links+ncells, ids);
+    }
 }
 
 //----------------------------------------------------------------------------
 void vtkStaticCellLinks::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Storage 32 Bit: "
+     << (this->Impl32 ? "On" : "Off") << endl;
+  os << indent << "Enable SMP: "
+     << (this->EnableSMP ? "On" : "Off") << endl;
 }
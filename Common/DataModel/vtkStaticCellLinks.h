@@ -29,11 +29,16 @@
 // .SECTION Caveats
 // This is a drop-in replacement for vtkCellLinks using static link
 // construction. It uses the templated vtkStaticCellLinksTemplate class,
-// instantiating vtkStaticCellLinksTemplate with a vtkIdType template
-// parameter. Note that for best performance, the vtkStaticCellLinksTemplate
-// class may be used directly, instantiating it with the appropriate id
-// type. This class is also wrappable and can be used from an interpreted
-// language such as Python.
+// instantiated with either an int or a vtkIdType template parameter: when
+// links are built for a vtkPolyData or vtkUnstructuredGrid whose points,
+// cells and connectivity can be indexed with 32-bit integers, the smaller
+// type is chosen at run time (see vtkAbstractCellLinks::GetIdType()) which
+// halves the memory used by the links. In that case GetCells() returns a
+// vtkIdType copy of the link which is valid until the next call; use the
+// vtkIdList version of GetCells() from several threads. Note that for best
+// performance, the vtkStaticCellLinksTemplate class may be used directly,
+// instantiating it with the appropriate id type. This class is also
+// wrappable and can be used from an interpreted language such as Python.
 
 // .SECTION See Also
 // vtkCellLinks vtkStaticCellLinksTemplate
@@ -47,6 +52,7 @@
 
 class vtkDataSet;
 class vtkCellArray;
+class vtkIdList;
 
 
 class VTKCOMMONDATAMODEL_EXPORT vtkStaticCellLinks : public vtkAbstractCellLinks
@@ -60,13 +66,28 @@ public:
 
   // Description:
   // Build the link list array. Satisfy the superclass API.
-  virtual void BuildLinks(vtkDataSet *ds)
-    {this->Impl->BuildLinks(ds);}
+  virtual void BuildLinks(vtkDataSet *ds);
+
+  // Description:
+  // Build the links of vtkPolyData and vtkUnstructuredGrid in parallel with
+  // vtkSMPTools. The links are the same as with the serial build. Off by
+  // default.
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+
+  // Description:
+  // Return whether the links are stored with 32-bit integers.
+  int IsStorage32Bit()
+    {return this->Impl32 != NULL;}
 
   // Description:
   // Get the number of cells using the point specified by ptId.
   vtkIdType GetNumberOfCells(vtkIdType ptId)
-    {return this->Impl->GetNumberOfCells(ptId);}
+    {
+    return (this->Impl32 ? this->Impl32->GetNumberOfCells(ptId) :
+            this->Impl->GetNumberOfCells(ptId));
+    }
 
   // Description:
   // Get the number of cells using the point specified by ptId. This is an
@@ -75,20 +96,33 @@ public:
     { return static_cast<unsigned short>(this->GetNumberOfCells(ptId)); }
 
   // Description:
-  // Return a list of cell ids using the specified point.
+  // Return a list of cell ids using the specified point. With 32-bit
+  // storage the list is a copy valid until the next call.
   const vtkIdType *GetCells(vtkIdType ptId)
-    {return this->Impl->GetCells(ptId);}
+    {
+    return (this->Impl32 ? this->CopyCells32(ptId) :
+            this->Impl->GetCells(ptId));
+    }
+
+  // Description:
+  // Copy the list of cell ids using the specified point. This method is
+  // thread safe.
+  void GetCells(vtkIdType ptId, vtkIdList *cells);
 
   // Description:
   // Make sure any previously created links are cleaned up.
-  void Initialize()
-    {this->Impl->Initialize();}
+  void Initialize();
 
 protected:
   vtkStaticCellLinks();
   virtual ~vtkStaticCellLinks();
 
+  const vtkIdType *CopyCells32(vtkIdType ptId);
+
   vtkStaticCellLinksTemplate<vtkIdType> *Impl;
+  vtkStaticCellLinksTemplate<int> *Impl32; //non-NULL when 32-bit is used
+  vtkIdList *TempCells;
+  bool EnableSMP;
 
 private:
   vtkStaticCellLinks(const vtkStaticCellLinks&);  // Not implemented.
@@ -35,6 +35,10 @@
 // non-templated class vtkStaticCellLinks can be used for convenience;
 // although it uses vtkIdType and thereby loses some speed and memory
 // advantage.
+//
+// The links of vtkPolyData and vtkUnstructuredGrid can be built in parallel
+// with vtkSMPTools (see SetEnableSMP()). The cell ids of each link are then
+// in the same order as with the serial build.
 
 // .SECTION See Also
 // vtkCellLinks vtkStaticCellLinks
@@ -55,7 +59,8 @@ public:
   // Description:
   // Default constructor. BuildLinks() does most of the work.
   vtkStaticCellLinksTemplate() :
-    LinksSize(0), NumPts(0), NumCells(0), Links(NULL), Offsets(NULL)
+    LinksSize(0), NumPts(0), NumCells(0), Links(NULL), Offsets(NULL),
+    EnableSMP(false)
     {
     }
 
@@ -80,6 +85,16 @@ public:
   // Build the link list array for vtkUnstructuredGrid.
   void BuildLinks(vtkUnstructuredGrid *ugrid);
 
+  // Description:
+  // Build the links of vtkPolyData and vtkUnstructuredGrid in parallel:
+  // point uses are counted with atomics, the offsets are a parallel prefix
+  // sum, and the cells are inserted concurrently then sorted in each link.
+  // Off by default.
+  void SetEnableSMP(bool enable)
+    {this->EnableSMP = enable;}
+  bool GetEnableSMP()
+    {return this->EnableSMP;}
+
   // Description:
   // Get the number of cells using the point specified by ptId.
   TIds GetNumberOfCells(vtkIdType ptId)
@@ -95,6 +110,13 @@ public:
     }
 
 protected:
+  // Helpers reading the cells of a cell array, whatever its storage.
+  void CountPointUses(vtkCellArray *cellArray);
+  void InsertCells(vtkCellArray *cellArray, vtkIdType cellIdOffset);
+
+  // Threaded build from the cell arrays of a dataset, numbered in order.
+  void ThreadedBuildLinks(vtkCellArray **cellArrays, int numCellArrays);
+
   // The various templated data members
   TIds LinksSize;
   TIds NumPts;
@@ -104,6 +126,8 @@ protected:
   TIds *Links; //contiguous runs of cell ids
   TIds *Offsets; //offsets for each point into the link array
 
+  bool EnableSMP;
+
 private:
   vtkStaticCellLinksTemplate(const vtkStaticCellLinksTemplate&);  // Not implemented.
   void operator=(const vtkStaticCellLinksTemplate&);  // Not implemented.
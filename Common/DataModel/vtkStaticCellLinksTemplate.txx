@@ -17,16 +17,25 @@
 #ifndef vtkStaticCellLinksTemplate_txx
 #define vtkStaticCellLinksTemplate_txx
 
+#include "vtkArrayDispatch.h"
+#include "vtkAtomic.h"
 #include "vtkCellArray.h"
 #include "vtkDataSet.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <functional>
+#include <vector>
+
 //----------------------------------------------------------------------------
-// Note: this class is a faster, serial version of vtkCellLinks. Future work
-// to parallelize this class is possible. This includes:
-// = using a parallel prefix sum operation
-// = using atomics to update counts (i.e., number of cells using a point)
+// Note: this class is a faster, serial version of vtkCellLinks. The cells
+// are read directly from either storage of vtkCellArray (legacy list, or
+// offsets and connectivity arrays of vtkIdType or 32-bit ids). The links of
+// vtkPolyData and vtkUnstructuredGrid can also be built in parallel (see
+// ThreadedBuildLinks()): the counts are updated with atomics, and the
+// offsets are a parallel prefix sum.
 
 //----------------------------------------------------------------------------
 // Clean up any previously allocated memory
@@ -65,6 +74,7 @@ BuildLinks(vtkDataSet *ds)
   // Any other type of dataset. Generally this is not called as datasets have
   // their own, more efficient ways of getting similar information.
   // Make sure that we clear out previous allocation.
+  this->Initialize();
   this->NumCells = ds->GetNumberOfCells();
   this->NumPts = ds->GetNumberOfPoints();
 
@@ -118,18 +128,338 @@ BuildLinks(vtkDataSet *ds)
   cellPts->Delete();
 }
 
+//----------------------------------------------------------------------------
+// Count the point uses of, or insert the ids of, the cells of a cell array
+// using the offsets layout. The loops are instantiated for each storage type
+// of the cell array (vtkArrayDispatch).
+template <typename TIds>
+struct vtkStaticCellLinksBuildWorker
+{
+  TIds *Offsets;
+  TIds *Links;
+  vtkIdType NumCells;
+  vtkIdType CellIdOffset;
+  bool Insert;
+
+  template <typename ArrayT>
+  void operator()(ArrayT *offsetsArray, ArrayT *connArray)
+  {
+    typedef typename ArrayT::ValueType ValueType;
+    const ValueType *offsets = offsetsArray->GetPointer(0);
+    const ValueType *conn = connArray->GetPointer(0);
+    vtkIdType ptId;
+
+    if ( !this->Insert )
+      {
+      const ValueType *connEnd = conn + offsets[this->NumCells];
+      for ( ; conn < connEnd; ++conn )
+        {
+        this->Offsets[*conn]++;
+        }
+      return;
+      }
+
+    for ( vtkIdType cellId=0; cellId < this->NumCells; ++cellId )
+      {
+      const ValueType *cellEnd = conn + offsets[cellId+1];
+      for ( const ValueType *cell=conn+offsets[cellId]; cell < cellEnd; ++cell )
+        {
+        ptId = *cell;
+        this->Offsets[ptId]--;
+        this->Links[this->Offsets[ptId]] =
+          static_cast<TIds>(this->CellIdOffset + cellId);
+        }
+      }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Count the number of uses of each point by the cells of a cell array.
+template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
+CountPointUses(vtkCellArray *cellArray)
+{
+  vtkIdType numCells = cellArray->GetNumberOfCells();
+  if ( cellArray->GetStorageLayout() == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    vtkStaticCellLinksBuildWorker<TIds> worker;
+    worker.Offsets = this->Offsets;
+    worker.Links = this->Links;
+    worker.NumCells = numCells;
+    worker.CellIdOffset = 0;
+    worker.Insert = false;
+    vtkArrayDispatch::Dispatch2ByArrayWithSameValueType<
+      vtkCellArray::StorageArrayList, vtkCellArray::StorageArrayList>::
+      Execute(cellArray->GetOffsetsArray(), cellArray->GetConnectivityArray(),
+              worker);
+    return;
+    }
+
+  const vtkIdType *cell = cellArray->GetPointer();
+  vtkIdType npts, cellId, i;
+  for ( cellId=0; cellId < numCells; ++cellId )
+    {
+    npts = *cell++;
+    for (i=0; i<npts; ++i)
+      {
+      this->Offsets[*cell++]++;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Insert the cells of a cell array in the links, numbering them from
+// cellIdOffset. Each time a cell is inserted, the offset of its points is
+// decremented.
+template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
+InsertCells(vtkCellArray *cellArray, vtkIdType cellIdOffset)
+{
+  vtkIdType numCells = cellArray->GetNumberOfCells();
+  if ( cellArray->GetStorageLayout() == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    vtkStaticCellLinksBuildWorker<TIds> worker;
+    worker.Offsets = this->Offsets;
+    worker.Links = this->Links;
+    worker.NumCells = numCells;
+    worker.CellIdOffset = cellIdOffset;
+    worker.Insert = true;
+    vtkArrayDispatch::Dispatch2ByArrayWithSameValueType<
+      vtkCellArray::StorageArrayList, vtkCellArray::StorageArrayList>::
+      Execute(cellArray->GetOffsetsArray(), cellArray->GetConnectivityArray(),
+              worker);
+    return;
+    }
+
+  const vtkIdType *cell = cellArray->GetPointer();
+  vtkIdType npts, cellId, i;
+  for ( cellId=0; cellId < numCells; ++cellId )
+    {
+    npts = *cell++;
+    for (i=0; i<npts; ++i)
+      {
+      this->Offsets[*cell]--;
+      this->Links[this->Offsets[*cell++]] =
+        static_cast<TIds>(cellIdOffset + cellId);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Count the point uses of, or insert the ids of, a range of cells in
+// parallel. The points of cell i are Conn[Locs[i]+Shift] up to
+// Conn[Locs[i+1]]: Shift is 0 with the offsets layout, and 1 with the legacy
+// layout (Locs are the cell locations, skipping the number of points).
+// Cells are inserted by decrementing the atomic end of their points' links.
+template <typename TIds, typename T>
+struct vtkStaticCellLinksThreadedWorker
+{
+  const T *Conn;
+  const T *Locs;
+  int Shift;
+  vtkIdType CellIdOffset;
+  vtkAtomic<TIds> *Counts;
+  TIds *Links;
+  bool Insert;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    for ( ; cellId < endCellId; ++cellId )
+      {
+      const T *cell = this->Conn + this->Locs[cellId] + this->Shift;
+      const T *cellEnd = this->Conn + this->Locs[cellId+1];
+      if ( !this->Insert )
+        {
+        for ( ; cell < cellEnd; ++cell )
+          {
+          ++this->Counts[*cell];
+          }
+        }
+      else
+        {
+        for ( ; cell < cellEnd; ++cell )
+          {
+          this->Links[--this->Counts[*cell]] =
+            static_cast<TIds>(this->CellIdOffset + cellId);
+          }
+        }
+      }
+  }
+};
+
+// Run the threaded worker on the arrays of a cell array using the offsets
+// layout, whatever their value type (vtkArrayDispatch).
+template <typename TIds>
+struct vtkStaticCellLinksThreadedDispatch
+{
+  vtkIdType NumCells;
+  vtkIdType CellIdOffset;
+  vtkAtomic<TIds> *Counts;
+  TIds *Links;
+  bool Insert;
+
+  template <typename ArrayT>
+  void operator()(ArrayT *offsetsArray, ArrayT *connArray)
+  {
+    vtkStaticCellLinksThreadedWorker<TIds, typename ArrayT::ValueType> worker;
+    worker.Conn = connArray->GetPointer(0);
+    worker.Locs = offsetsArray->GetPointer(0);
+    worker.Shift = 0;
+    worker.CellIdOffset = this->CellIdOffset;
+    worker.Counts = this->Counts;
+    worker.Links = this->Links;
+    worker.Insert = this->Insert;
+    vtkSMPTools::For(0, this->NumCells, worker);
+  }
+};
+
+// Start the insertion of the cells at the end of each link.
+template <typename TIds>
+struct vtkStaticCellLinksLinkEnds
+{
+  const TIds *Offsets;
+  vtkAtomic<TIds> *Counts;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId )
+      {
+      this->Counts[ptId] = this->Offsets[ptId+1];
+      }
+  }
+};
+
+// Restore the order of the serial build (decreasing cell ids) in each link.
+template <typename TIds>
+struct vtkStaticCellLinksSortLinks
+{
+  const TIds *Offsets;
+  TIds *Links;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId )
+      {
+      std::sort(this->Links + this->Offsets[ptId],
+                this->Links + this->Offsets[ptId+1], std::greater<TIds>());
+      }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Build the links from a list of cell arrays in parallel. The cells of each
+// array are numbered after those of the previous arrays.
+template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
+ThreadedBuildLinks(vtkCellArray **cellArrays, int numCellArrays)
+{
+  this->LinksSize = 0;
+  for ( int i=0; i < numCellArrays; ++i )
+    {
+    if ( cellArrays[i] )
+      {
+      this->LinksSize += cellArrays[i]->GetNumberOfConnectivityEntries() -
+        cellArrays[i]->GetNumberOfCells();
+      }
+    }
+  this->Links = new TIds[this->LinksSize+1];
+  this->Links[this->LinksSize] = this->NumPts;
+  this->Offsets = new TIds[this->NumPts+1];
+  vtkAtomic<TIds> *counts = new vtkAtomic<TIds>[this->NumPts];
+
+  // The locations of the cells of the arrays using the legacy layout.
+  std::vector<std::vector<vtkIdType> > locations(numCellArrays);
+  for ( int i=0; i < numCellArrays; ++i )
+    {
+    if ( cellArrays[i] && cellArrays[i]->GetNumberOfCells() > 0 &&
+         cellArrays[i]->GetStorageLayout() != vtkCellArray::OFFSETS_LAYOUT )
+      {
+      vtkIdType numCells = cellArrays[i]->GetNumberOfCells();
+      const vtkIdType *cells = cellArrays[i]->GetPointer();
+      locations[i].resize(numCells+1);
+      vtkIdType loc = 0;
+      for ( vtkIdType cellId=0; cellId < numCells; ++cellId )
+        {
+        locations[i][cellId] = loc;
+        loc += cells[loc] + 1;
+        }
+      locations[i][numCells] = loc;
+      }
+    }
+
+  // Count the point uses (pass 0), then insert the cells (pass 1).
+  for ( int pass=0; pass < 2; ++pass )
+    {
+    if ( pass == 1 )
+      {
+      this->Offsets[this->NumPts] =
+        vtkSMPTools::ExclusiveScan(counts, counts + this->NumPts,
+                                   this->Offsets, static_cast<TIds>(0));
+      vtkStaticCellLinksLinkEnds<TIds> linkEnds;
+      linkEnds.Offsets = this->Offsets;
+      linkEnds.Counts = counts;
+      vtkSMPTools::For(0, this->NumPts, linkEnds);
+      }
+    vtkIdType cellIdOffset = 0;
+    for ( int i=0; i < numCellArrays; ++i )
+      {
+      vtkIdType numCells =
+        (cellArrays[i] ? cellArrays[i]->GetNumberOfCells() : 0);
+      if ( numCells <= 0 )
+        {
+        continue;
+        }
+      if ( cellArrays[i]->GetStorageLayout() == vtkCellArray::OFFSETS_LAYOUT )
+        {
+        vtkStaticCellLinksThreadedDispatch<TIds> dispatcher;
+        dispatcher.NumCells = numCells;
+        dispatcher.CellIdOffset = cellIdOffset;
+        dispatcher.Counts = counts;
+        dispatcher.Links = this->Links;
+        dispatcher.Insert = (pass == 1);
+        vtkArrayDispatch::Dispatch2ByArrayWithSameValueType<
+          vtkCellArray::StorageArrayList, vtkCellArray::StorageArrayList>::
+          Execute(cellArrays[i]->GetOffsetsArray(),
+                  cellArrays[i]->GetConnectivityArray(), dispatcher);
+        }
+      else
+        {
+        vtkStaticCellLinksThreadedWorker<TIds, vtkIdType> worker;
+        worker.Conn = cellArrays[i]->GetPointer();
+        worker.Locs = &locations[i][0];
+        worker.Shift = 1;
+        worker.CellIdOffset = cellIdOffset;
+        worker.Counts = counts;
+        worker.Links = this->Links;
+        worker.Insert = (pass == 1);
+        vtkSMPTools::For(0, numCells, worker);
+        }
+      cellIdOffset += numCells;
+      }
+    }
+  delete [] counts;
+
+  vtkStaticCellLinksSortLinks<TIds> sorter;
+  sorter.Offsets = this->Offsets;
+  sorter.Links = this->Links;
+  vtkSMPTools::For(0, this->NumPts, sorter);
+}
+
 //----------------------------------------------------------------------------
 // Build the link list array for unstructured grids
 template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
 BuildLinks(vtkUnstructuredGrid *ugrid)
 {
+  this->Initialize();
+
   // Basic information about the grid
   this->NumCells = ugrid->GetNumberOfCells();
   this->NumPts = ugrid->GetNumberOfPoints();
 
   // We're going to get into the guts of the class
   vtkCellArray *cellArray = ugrid->GetCells();
-  const vtkIdType *cells = cellArray->GetPointer();
+  if ( this->EnableSMP )
+    {
+    this->ThreadedBuildLinks(&cellArray, 1);
+    return;
+    }
 
   // I love this trick: the size of the Links array is equal to
   // the size of the cell array, minus the number of cells.
@@ -142,22 +472,11 @@ BuildLinks(vtkUnstructuredGrid *ugrid)
   this->Offsets = new TIds[this->NumPts+1];
   std::fill_n(this->Offsets, this->NumPts, 0);
 
-  // Now create the links.
-  vtkIdType npts, cellId, ptId;
-  const vtkIdType *cell=cells;
-  int i;
-
   // Count number of point uses
-  for ( cellId=0; cellId < this->NumCells; ++cellId )
-    {
-    npts = *cell++;
-    for (i=0; i<npts; ++i)
-      {
-      this->Offsets[*cell++]++;
-      }
-    }
+  this->CountPointUses(cellArray);
 
   // Perform prefix sum
+  vtkIdType npts, ptId;
   for ( ptId=0; ptId < this->NumPts; ++ptId )
     {
     npts = this->Offsets[ptId+1];
@@ -168,15 +487,7 @@ BuildLinks(vtkUnstructuredGrid *ugrid)
   // the cells are to be inserted. Each time a cell is inserted, the offset
   // is decremented. In the end, the offset array is also constructed as it
   // points to the beginning of each cell run.
-  for ( cell=cells, cellId=0; cellId < this->NumCells; ++cellId )
-    {
-    npts = *cell++;
-    for (i=0; i<npts; ++i)
-      {
-      this->Offsets[*cell]--;
-      this->Links[this->Offsets[*cell++]] = cellId;
-      }
-    }
+  this->InsertCells(cellArray, 0);
   this->Offsets[this->NumPts] = this->LinksSize;
 }
 
@@ -186,6 +497,8 @@ BuildLinks(vtkUnstructuredGrid *ugrid)
 template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
 BuildLinks(vtkPolyData *pd)
 {
+  this->Initialize();
+
   // Basic information about the grid
   this->NumCells = pd->GetNumberOfCells();
   this->NumPts = pd->GetNumberOfPoints();
@@ -199,6 +512,11 @@ BuildLinks(vtkPolyData *pd)
   cellArrays[1] = pd->GetLines();
   cellArrays[2] = pd->GetPolys();
   cellArrays[3] = pd->GetStrips();
+  if ( this->EnableSMP )
+    {
+    this->ThreadedBuildLinks(cellArrays, 4);
+    return;
+    }
 
   for (i=0; i<4; ++i)
     {
@@ -222,27 +540,17 @@ BuildLinks(vtkPolyData *pd)
   this->Offsets[this->NumPts] = this->LinksSize;
   std::fill_n(this->Offsets, this->NumPts, 0);
 
-  // Now create the links.
-  vtkIdType npts, cellId, CellId, ptId;
-  const vtkIdType *cell;
-
-  // Visit the four arrays
-  for ( CellId=0, j=0; j < 4; ++j )
+  // Visit the four arrays and count number of point uses
+  for ( j=0; j < 4; ++j )
     {
-    // Count number of point uses
-    cell = cellArrays[j]->GetPointer();
-    for ( cellId=0; cellId < numCells[j]; ++cellId )
+    if ( numCells[j] > 0 )
       {
-      npts = *cell++;
-      for (i=0; i<npts; ++i)
-        {
-        this->Offsets[CellId+(*cell++)]++;
-        }
+      this->CountPointUses(cellArrays[j]);
       }
-    CellId += numCells[j];
     } //for each of the four polydata cell arrays
 
   // Perform prefix sum
+  vtkIdType npts, ptId, CellId;
   for ( ptId=0; ptId < this->NumPts; ++ptId )
     {
     npts = this->Offsets[ptId+1];
@@ -255,15 +563,9 @@ BuildLinks(vtkPolyData *pd)
   // points to the beginning of each cell run.
   for ( CellId=0, j=0; j < 4; ++j )
     {
-    cell = cellArrays[j]->GetPointer();
-    for ( cellId=0; cellId < numCells[j]; ++cellId )
+    if ( numCells[j] > 0 )
       {
-      npts = *cell++;
-      for (i=0; i<npts; ++i)
-        {
-        this->Offsets[*cell]--;
-        this->Links[this->Offsets[*cell++]] = CellId+cellId;
-        }
+      this->InsertCells(cellArrays[j], CellId);
       }
     CellId += numCells[j];
     }//for each of the four polydata arrays
@@ -355,6 +355,12 @@ int *vtkTetra::GetFaceArray(int faceId)
   return faces[faceId];
 }
 
+//----------------------------------------------------------------------------
+int *vtkTetra::GetTriangleCases(int caseId)
+{
+  return triCases[caseId].edges;
+}
+
 //----------------------------------------------------------------------------
 vtkCell *vtkTetra::GetFace(int faceId)
 {
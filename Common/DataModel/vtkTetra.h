@@ -160,6 +160,13 @@ public:
   static int *GetEdgeArray(int edgeId);
   static int *GetFaceArray(int faceId);
 
+  // Description:
+  // Return the contour case caseId of the cell (bit i of caseId being set
+  // when the scalar of vertex i is above the contour value), as used by
+  // Contour(): a list of edge ids (see GetEdgeArray()), three per output
+  // triangle, terminated by -1.
+  static int *GetTriangleCases(int caseId);
+
 protected:
   vtkTetra();
   ~vtkTetra();
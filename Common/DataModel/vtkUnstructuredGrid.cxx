@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkUnstructuredGrid.h"
 
+#include "vtkCallbackCommand.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellLinks.h"
@@ -114,6 +115,10 @@ vtkUnstructuredGrid::vtkUnstructuredGrid ()
   this->Links = NULL;
   this->Types = NULL;
   this->Locations = NULL;
+  this->ConnectivityObserver = vtkCallbackCommand::New();
+  this->ConnectivityObserver->SetCallback(
+    &vtkUnstructuredGrid::OnConnectivityModified);
+  this->ConnectivityObserver->SetClientData(this);
 
   this->Faces = NULL;
   this->FaceLocations = NULL;
@@ -135,14 +140,10 @@ void vtkUnstructuredGrid::Allocate (vtkIdType numCells, int extSize)
     extSize = 1000;
     }
 
-  if ( this->Connectivity )
-    {
-    this->Connectivity->UnRegister(this);
-    }
-  this->Connectivity = vtkCellArray::New();
-  this->Connectivity->Allocate(numCells,4*extSize);
-  this->Connectivity->Register(this);
-  this->Connectivity->Delete();
+  vtkCellArray *cells = vtkCellArray::New();
+  cells->Allocate(numCells,4*extSize);
+  this->SetConnectivity(cells);
+  cells->Delete();
 
   if ( this->Types )
     {
@@ -167,6 +168,7 @@ void vtkUnstructuredGrid::Allocate (vtkIdType numCells, int extSize)
 vtkUnstructuredGrid::~vtkUnstructuredGrid()
 {
   this->Cleanup();
+  this->ConnectivityObserver->Delete();
 
   if(this->Vertex)
     {
@@ -336,18 +338,7 @@ void vtkUnstructuredGrid::CopyStructure(vtkDataSet *ds)
   // If ds is a vtkUnstructuredGrid, do a shallow copy of the cell data.
   if (vtkUnstructuredGrid *ug = vtkUnstructuredGrid::SafeDownCast(ds))
     {
-    if (this->Connectivity != ug->Connectivity)
-      {
-      if ( this->Connectivity )
-        {
-        this->Connectivity->UnRegister(this);
-        }
-      this->Connectivity = ug->Connectivity;
-      if (this->Connectivity)
-        {
-        this->Connectivity->Register(this);
-        }
-      }
+    this->SetConnectivity(ug->Connectivity);
 
     if (this->Links != ug->Links)
       {
@@ -421,11 +412,7 @@ void vtkUnstructuredGrid::CopyStructure(vtkDataSet *ds)
 //----------------------------------------------------------------------------
 void vtkUnstructuredGrid::Cleanup()
 {
-  if ( this->Connectivity )
-    {
-    this->Connectivity->UnRegister(this);
-    this->Connectivity = NULL;
-    }
+  this->SetConnectivity(NULL);
 
   if ( this->Links )
     {
@@ -481,6 +468,14 @@ int vtkUnstructuredGrid::GetCellType(vtkIdType cellId)
   return static_cast<int>(this->Types->GetValue(cellId));
 }
 
+//----------------------------------------------------------------------------
+vtkIdType vtkUnstructuredGrid::GetCellLocation(vtkIdType cellId)
+{
+  return (this->Connectivity->GetStorageLayout() ==
+          vtkCellArray::OFFSETS_LAYOUT ? cellId :
+          this->Locations->GetValue(cellId));
+}
+
 //----------------------------------------------------------------------------
 vtkCell *vtkUnstructuredGrid::GetCell(vtkIdType cellId)
 {
@@ -489,7 +484,7 @@ vtkCell *vtkUnstructuredGrid::GetCell(vtkIdType cellId)
   vtkCell *cell = NULL;
   vtkIdType *pts, numPts;
 
-  loc = this->Locations->GetValue(cellId);
+  loc = this->GetCellLocation(cellId);
   vtkDebugMacro(<< "location = " <<  loc);
   this->Connectivity->GetCell(loc,numPts,pts);
 
@@ -803,18 +798,12 @@ vtkCell *vtkUnstructuredGrid::GetCell(vtkIdType cellId)
 //----------------------------------------------------------------------------
 void vtkUnstructuredGrid::GetCell(vtkIdType cellId, vtkGenericCell *cell)
 {
-  vtkIdType loc;
-  vtkIdType *pts, numPts;
-
   int cellType = static_cast<int>(this->Types->GetValue(cellId));
   cell->SetCellType(cellType);
 
-  loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
-
-  cell->PointIds->SetNumberOfIds(numPts);
-
-  std::copy(pts, pts + numPts, cell->PointIds->GetPointer(0));
+  // copies the point ids without going through a shared buffer, so that
+  // this method stays thread safe whatever the cell array storage
+  this->Connectivity->GetCell(this->GetCellLocation(cellId), cell->PointIds);
   this->Points->GetPoints(cell->PointIds, cell->Points);
 
   // Explicit face representation
@@ -841,7 +830,7 @@ void vtkUnstructuredGrid::GetCellBounds(vtkIdType cellId, double bounds[6])
   double x[3];
   vtkIdType *pts, numPts;
 
-  loc = this->Locations->GetValue(cellId);
+  loc = this->GetCellLocation(cellId);
   this->Connectivity->GetCell(loc,numPts,pts);
 
   // carefully compute the bounds
@@ -913,7 +902,11 @@ vtkIdType vtkUnstructuredGrid::InsertNextCell(int type, vtkIdList *ptIds)
   // insert type and storage information
   vtkDebugMacro(<< "insert location "
                 << this->Connectivity->GetInsertLocation(npts));
-  this->Locations->InsertNextValue(this->Connectivity->GetInsertLocation(npts));
+  if ( this->Connectivity->GetStorageLayout() == vtkCellArray::LEGACY_LAYOUT )
+    {
+    this->Locations->InsertNextValue(
+      this->Connectivity->GetInsertLocation(npts));
+    }
 
   // If faces have been created, we need to pad them (we are not creating
   // a polyhedral cell in this method)
@@ -940,8 +933,12 @@ vtkIdType vtkUnstructuredGrid::InsertNextCell(int type, vtkIdType npts,
     // insert type and storage information
     vtkDebugMacro(<< "insert location "
                   << this->Connectivity->GetInsertLocation(npts));
-    this->Locations->InsertNextValue(
-      this->Connectivity->GetInsertLocation(npts));
+    if ( this->Connectivity->GetStorageLayout() ==
+         vtkCellArray::LEGACY_LAYOUT )
+      {
+      this->Locations->InsertNextValue(
+        this->Connectivity->GetInsertLocation(npts));
+      }
 
     // If faces have been created, we need to pad them (we are not creating
     // a polyhedral cell in this method)
@@ -972,7 +969,12 @@ vtkIdType vtkUnstructuredGrid::InsertNextCell(int type, vtkIdType npts,
       }
 
     // insert cell location
-    this->Locations->InsertNextValue(this->Connectivity->GetData()->GetMaxId()+1);
+    if ( this->Connectivity->GetStorageLayout() ==
+         vtkCellArray::LEGACY_LAYOUT )
+      {
+      this->Locations->InsertNextValue(
+        this->Connectivity->GetData()->GetMaxId()+1);
+      }
     // insert face location
     this->FaceLocations->InsertNextValue(this->Faces->GetMaxId()+1);
     // insert cell connectivity and faces stream
@@ -995,8 +997,11 @@ InsertNextCell(int type, vtkIdType npts, vtkIdType *pts,
   this->Connectivity->InsertNextCell(npts,pts);
 
   // Insert location of cell in connectivity array
-  this->Locations->InsertNextValue(
-    this->Connectivity->GetInsertLocation(npts));
+  if ( this->Connectivity->GetStorageLayout() == vtkCellArray::LEGACY_LAYOUT )
+    {
+    this->Locations->InsertNextValue(
+      this->Connectivity->GetInsertLocation(npts));
+    }
 
   // Now insert faces; allocate storage if necessary.
   // We defer allocation for the faces because they are not commonly used and
@@ -1112,7 +1117,21 @@ void vtkUnstructuredGrid::SetCells(int *types, vtkCellArray *cells)
 
   if (!containPolyhedron)
     {
-    // only need to build types and locations
+    // only need to build types and locations (cells are accessed by id with
+    // the offsets layout)
+    if ( cells->GetStorageLayout() == vtkCellArray::OFFSETS_LAYOUT )
+      {
+      unsigned char *typesPtr = cellTypes->WritePointer(0, ncells);
+      for (i=0; i < ncells; i++)
+        {
+        typesPtr[i] = static_cast<unsigned char>(types[i]);
+        }
+      this->SetCells(cellTypes, NULL, cells, NULL, NULL);
+      cellTypes->Delete();
+      cellLocations->Delete();
+      return;
+      }
+
     for (i=0, cells->InitTraversal(); cells->GetNextCell(npts,pts); i++)
       {
       cellTypes->InsertNextValue(static_cast<unsigned char>(types[i]));
@@ -1234,15 +1253,7 @@ void vtkUnstructuredGrid::SetCells(vtkUnsignedCharArray *cellTypes,
                                    vtkIdTypeArray *faceLocations,
                                    vtkIdTypeArray *faces)
 {
-  if ( this->Connectivity )
-    {
-    this->Connectivity->UnRegister(this);
-    }
-  this->Connectivity = cells;
-  if ( this->Connectivity )
-    {
-    this->Connectivity->Register(this);
-    }
+  this->SetConnectivity(cells);
 
   if ( this->Types )
     {
@@ -1258,6 +1269,12 @@ void vtkUnstructuredGrid::SetCells(vtkUnsignedCharArray *cellTypes,
     {
     this->Locations->UnRegister(this);
     }
+  // Cells are accessed by id with the offsets layout
+  if ( cells &&
+       cells->GetStorageLayout() == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    cellLocations = NULL;
+    }
   this->Locations = cellLocations;
   if ( this->Locations )
     {
@@ -1285,6 +1302,78 @@ void vtkUnstructuredGrid::SetCells(vtkUnsignedCharArray *cellTypes,
     }
 }
 
+//----------------------------------------------------------------------------
+vtkIdTypeArray* vtkUnstructuredGrid::GetCellLocationsArray()
+{
+  if ( this->Connectivity &&
+       this->Connectivity->GetStorageLayout() == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    // the locations are built by OnConnectivityModified()
+    this->Connectivity->SetStorageLayoutToLegacy();
+    }
+  return this->Locations;
+}
+
+//----------------------------------------------------------------------------
+// Replace the connectivity, observing the changes of its storage layout.
+void vtkUnstructuredGrid::SetConnectivity(vtkCellArray *cells)
+{
+  if ( cells == this->Connectivity )
+    {
+    return;
+    }
+  if ( this->Connectivity )
+    {
+    this->Connectivity->RemoveObserver(this->ConnectivityObserver);
+    this->Connectivity->UnRegister(this);
+    }
+  this->Connectivity = cells;
+  if ( this->Connectivity )
+    {
+    this->Connectivity->Register(this);
+    this->Connectivity->AddObserver(vtkCommand::ModifiedEvent,
+                                    this->ConnectivityObserver);
+    }
+}
+
+//----------------------------------------------------------------------------
+// The locations are only stored with the legacy layout: they are built when
+// the connectivity switches to it, and released when it switches to the
+// offsets layout.
+void vtkUnstructuredGrid::OnConnectivityModified(vtkObject *source,
+                                                 unsigned long,
+                                                 void *clientdata, void *)
+{
+  vtkUnstructuredGrid *self = static_cast<vtkUnstructuredGrid*>(clientdata);
+  vtkCellArray *cells = self->Connectivity;
+  if ( source != cells )
+    {
+    return;
+    }
+  if ( cells->GetStorageLayout() == vtkCellArray::OFFSETS_LAYOUT )
+    {
+    if ( self->Locations )
+      {
+      self->Locations->UnRegister(self);
+      self->Locations = NULL;
+      }
+    }
+  else if ( !self->Locations )
+    {
+    vtkIdTypeArray *data = cells->GetData();
+    vtkIdTypeArray *locations = vtkIdTypeArray::New();
+    locations->Allocate(cells->GetNumberOfCells());
+    for (vtkIdType loc=0; loc <= data->GetMaxId();
+         loc += data->GetValue(loc) + 1)
+      {
+      locations->InsertNextValue(loc);
+      }
+    self->Locations = locations;
+    self->Locations->Register(self);
+    locations->Delete();
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkUnstructuredGrid::BuildLinks()
 {
@@ -1304,17 +1393,7 @@ void vtkUnstructuredGrid::BuildLinks()
 //----------------------------------------------------------------------------
 void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
 {
-  vtkIdType i, loc;
-  vtkIdType *pts, numPts;
-
-  loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
-  ptIds->SetNumberOfIds(numPts);
-  for (i=0; i<numPts; i++)
-    {
-    ptIds->SetId(i,pts[i]);
-    }
-
+  this->Connectivity->GetCell(this->GetCellLocation(cellId), ptIds);
 }
 
 //----------------------------------------------------------------------------
@@ -1325,7 +1404,7 @@ void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdType& npts,
 {
   vtkIdType loc;
 
-  loc = this->Locations->GetValue(cellId);
+  loc = this->GetCellLocation(cellId);
 
   this->Connectivity->GetCell(loc,npts,pts);
 }
@@ -1449,6 +1528,7 @@ void vtkUnstructuredGrid::Squeeze()
 {
   if ( this->Connectivity )
     {
+    this->Connectivity->ConvertToSmallestStorage(this->GetNumberOfPoints());
     this->Connectivity->Squeeze();
     }
   if ( this->Links )
@@ -1514,7 +1594,7 @@ void vtkUnstructuredGrid::ReplaceCell(vtkIdType cellId, int npts,
 {
   vtkIdType loc;
 
-  loc = this->Locations->GetValue(cellId);
+  loc = this->GetCellLocation(cellId);
   this->Connectivity->ReplaceCell(loc,npts,pts);
 }
 
@@ -1582,15 +1662,7 @@ void vtkUnstructuredGrid::ShallowCopy(vtkDataObject *dataObject)
     {
     // I do not know if this is correct but.
 
-    if (this->Connectivity)
-      {
-      this->Connectivity->UnRegister(this);
-      }
-    this->Connectivity = grid->Connectivity;
-    if (this->Connectivity)
-      {
-      this->Connectivity->Register(this);
-      }
+    this->SetConnectivity(grid->Connectivity);
 
     if (this->Links)
       {
@@ -1670,17 +1742,13 @@ void vtkUnstructuredGrid::DeepCopy(vtkDataObject *dataObject)
 
   if ( grid != NULL )
     {
-    if ( this->Connectivity )
-      {
-      this->Connectivity->UnRegister(this);
-      this->Connectivity = NULL;
-      }
+    this->SetConnectivity(NULL);
     if (grid->Connectivity)
       {
-      this->Connectivity = vtkCellArray::New();
-      this->Connectivity->DeepCopy(grid->Connectivity);
-      this->Connectivity->Register(this);
-      this->Connectivity->Delete();
+      vtkCellArray *cells = vtkCellArray::New();
+      cells->DeepCopy(grid->Connectivity);
+      this->SetConnectivity(cells);
+      cells->Delete();
       }
 
     if ( this->Links )
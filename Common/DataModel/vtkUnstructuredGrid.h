@@ -27,6 +27,7 @@
 #include "vtkCommonDataModelModule.h" // For export macro
 #include "vtkUnstructuredGridBase.h"
 
+class vtkCallbackCommand;
 class vtkCellArray;
 class vtkCellLinks;
 class vtkConvexPointSet;
@@ -134,7 +135,18 @@ public:
 
   int GetCellType(vtkIdType cellId);
   vtkUnsignedCharArray* GetCellTypesArray() { return this->Types; }
-  vtkIdTypeArray* GetCellLocationsArray() { return this->Locations; }
+
+  // Description:
+  // Return the offsets of the cells in the legacy connectivity list (see
+  // vtkCellArray::GetData()). Cells using the offsets layout of vtkCellArray
+  // have no such offsets: like vtkCellArray::GetData(), this switches them
+  // back to the legacy layout, which is not thread safe.
+  vtkIdTypeArray* GetCellLocationsArray();
+
+  // Description:
+  // Reclaim any extra memory. Cells using the offsets layout of vtkCellArray
+  // are also converted to the smallest integer storage able to index the
+  // points (see vtkCellArray::ConvertToSmallestStorage()).
   void Squeeze();
   void Initialize();
   int GetMaxCellSize();
@@ -171,6 +183,9 @@ public:
   // (numCellFaces, numFace0Pts, id1, id2, id3, numFace1Pts,id1, id2, id3, ...)
   // The functions use vtkPolyhedron::DecomposeAPolyhedronCell() to convert
   // polyhedron cells into standard format.
+  // If the cell array uses the offsets layout (see
+  // vtkCellArray::SetStorageLayout()) cells are accessed by cell id, so
+  // cellLocations are ignored and no location array is stored.
   void SetCells(int type, vtkCellArray *cells);
   void SetCells(int *types, vtkCellArray *cells);
   void SetCells(vtkUnsignedCharArray *cellTypes, vtkIdTypeArray *cellLocations,
@@ -359,7 +374,18 @@ protected:
   vtkCellArray *Connectivity;
   vtkCellLinks *Links;
   vtkUnsignedCharArray *Types;
-  vtkIdTypeArray *Locations;
+  vtkIdTypeArray *Locations; //NULL with the offsets layout
+
+  // Return the location of the cell in the connectivity array, i.e. the
+  // cell id itself with the offsets layout.
+  vtkIdType GetCellLocation(vtkIdType cellId);
+
+  // The locations follow the storage layout of the connectivity (see
+  // vtkCellArray::SetStorageLayout()), which is observed.
+  vtkCallbackCommand *ConnectivityObserver;
+  void SetConnectivity(vtkCellArray *cells);
+  static void OnConnectivityModified(vtkObject *source, unsigned long eid,
+                                     void *clientdata, void *calldata);
 
   // Special support for polyhedra/cells with explicit face representations.
   // The Faces class represents polygonal faces using a modified vtkCellArray
@@ -480,6 +480,12 @@ int *vtkWedge::GetFaceArray(int faceId)
   return faces[faceId];
 }
 
+//----------------------------------------------------------------------------
+int *vtkWedge::GetTriangleCases(int caseId)
+{
+  return triCases[caseId].edges;
+}
+
 //----------------------------------------------------------------------------
 vtkCell *vtkWedge::GetFace(int faceId)
 {
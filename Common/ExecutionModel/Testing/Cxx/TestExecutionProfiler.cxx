@@ -0,0 +1,139 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestExecutionProfiler.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Test the recording of the pipeline passes by vtkExecutionProfiler.
+
+#include "vtkElevationFilter.h"
+#include "vtkPolyData.h"
+#include "vtkExecutionProfiler.h"
+#include "vtkNew.h"
+#include "vtkSphereSource.h"
+#include "vtkTable.h"
+#include "vtkTestUtilities.h"
+#include "vtkVariant.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#define TEST_ASSERT(cond, msg) \
+  if (!(cond)) \
+    { \
+    cerr << "Failure at line " << __LINE__ << ": " << msg << endl; \
+    return EXIT_FAILURE; \
+    }
+
+namespace
+{
+// Return the row of the RequestData pass of the given algorithm, or -1.
+vtkIdType FindRequestData(vtkTable *table, const char *algorithm)
+{
+  for (vtkIdType row=0; row < table->GetNumberOfRows(); ++row)
+    {
+    if (table->GetValueByName(row, "Algorithm").ToString() == algorithm &&
+        table->GetValueByName(row, "Pass").ToString() == "RequestData")
+      {
+      return row;
+      }
+    }
+  return -1;
+}
+}
+
+int TestExecutionProfiler(int argc, char *argv[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(64);
+  sphere->SetPhiResolution(64);
+  vtkNew<vtkElevationFilter> elevation;
+  elevation->SetInputConnection(sphere->GetOutputPort());
+
+  vtkNew<vtkExecutionProfiler> profiler;
+  TEST_ASSERT(vtkExecutionProfiler::GetActiveProfiler() == NULL,
+              "profiler active by default");
+  profiler->StartProfiling();
+  TEST_ASSERT(profiler->IsProfiling() &&
+              vtkExecutionProfiler::GetActiveProfiler() ==
+              profiler.GetPointer(), "profiler not active");
+  elevation->Update();
+  profiler->StopProfiling();
+  TEST_ASSERT(!profiler->IsProfiling(), "profiler still active");
+
+  // Both algorithms go through the information, update extent and data
+  // passes.
+  vtkIdType numRecords = profiler->GetNumberOfRecords();
+  TEST_ASSERT(numRecords >= 6, "missing records");
+  vtkNew<vtkTable> table;
+  profiler->GetRecords(table.GetPointer());
+  TEST_ASSERT(table->GetNumberOfRows() == numRecords &&
+              table->GetNumberOfColumns() == 11, "wrong table size");
+  int numInformation = 0, numUpdateExtent = 0;
+  for (vtkIdType row=0; row < numRecords; ++row)
+    {
+    std::string pass = table->GetValueByName(row, "Pass").ToString();
+    numInformation += pass == "RequestInformation";
+    numUpdateExtent += pass == "RequestUpdateExtent";
+    TEST_ASSERT(table->GetValueByName(row, "WallTime").ToDouble() >= 0.0 &&
+                table->GetValueByName(row, "StartTime").ToDouble() >= 0.0,
+                "wrong times");
+    TEST_ASSERT(table->GetValueByName(row, "Depth").ToInt() == 0,
+                "wrong depth");
+    TEST_ASSERT(pass == "RequestData" ||
+                table->GetValueByName(row, "OutputSize").ToTypeInt64() == -1,
+                "output size of a pass other than RequestData");
+    }
+  TEST_ASSERT(numInformation == 2 && numUpdateExtent >= 1,
+              "wrong number of passes");
+
+  vtkIdType sphereRow = FindRequestData(table.GetPointer(), "vtkSphereSource");
+  vtkIdType elevationRow =
+    FindRequestData(table.GetPointer(), "vtkElevationFilter");
+  TEST_ASSERT(sphereRow >= 0 && elevationRow > sphereRow,
+              "wrong RequestData passes");
+  TEST_ASSERT(table->GetValueByName(sphereRow, "AlgorithmId").ToInt() !=
+              table->GetValueByName(elevationRow, "AlgorithmId").ToInt(),
+              "same algorithm ids");
+  TEST_ASSERT(table->GetValueByName(elevationRow, "OutputSize").ToTypeInt64()
+              == 1024 * static_cast<vtkTypeInt64>(
+                elevation->GetOutput()->GetActualMemorySize()),
+              "wrong output size");
+
+  // Nothing is recorded once stopped.
+  sphere->Modified();
+  elevation->Update();
+  TEST_ASSERT(profiler->GetNumberOfRecords() == numRecords,
+              "records added while stopped");
+
+  // Chrome trace
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  std::string fileName = std::string(tempDir) + "/TestExecutionProfiler.json";
+  delete [] tempDir;
+  TEST_ASSERT(profiler->WriteChromeTrace(fileName.c_str()),
+              "cannot write the trace");
+  std::ifstream file(fileName.c_str());
+  std::stringstream contents;
+  contents << file.rdbuf();
+  std::string trace = contents.str();
+  TEST_ASSERT(trace.find("{\"traceEvents\":[") == 0 &&
+              trace.find("\"name\":\"vtkElevationFilter\"") !=
+              std::string::npos &&
+              trace.find("\"cat\":\"RequestData\",\"ph\":\"X\"") !=
+              std::string::npos, "wrong trace");
+
+  profiler->ClearRecords();
+  TEST_ASSERT(profiler->GetNumberOfRecords() == 0, "records not cleared");
+
+  return EXIT_SUCCESS;
+}
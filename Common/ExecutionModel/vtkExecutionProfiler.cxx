@@ -0,0 +1,465 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkExecutionProfiler.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkExecutionProfiler.h"
+
+#include "vtkAlgorithm.h"
+#include "vtkAtomic.h"
+#include "vtkDataObject.h"
+#include "vtkDemandDrivenPipeline.h"
+#include "vtkDoubleArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkIntArray.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+#include "vtkSimpleCriticalSection.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkStringArray.h"
+#include "vtkTable.h"
+#include "vtkTimerLog.h"
+#include "vtkTypeInt64Array.h"
+
+#include <vtksys/SystemInformation.hxx>
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+vtkStandardNewMacro(vtkExecutionProfiler);
+
+//----------------------------------------------------------------------------
+namespace
+{
+struct vtkExecutionProfilerRecord
+{
+  std::string Algorithm;
+  int AlgorithmId;
+  const char *Pass;
+  int Thread;
+  int Depth;
+  double StartTime;
+  double WallTime;
+  double StartCPUTime;
+  double CPUTime;
+  double ThreadUtilization;
+  vtkTypeInt64 StartMemory;
+  vtkTypeInt64 MemoryDelta;
+  vtkTypeInt64 OutputSize;
+  bool Done;
+};
+
+// The profiler recording the passes, if any. It is read by the executives
+// of all threads, hence atomic.
+vtkAtomic<vtkExecutionProfiler*> vtkExecutionProfilerActive;
+
+// Return the name of the pass for the given request.
+const char *vtkExecutionProfilerPassName(vtkInformation *request)
+{
+  if (request->Has(vtkDemandDrivenPipeline::REQUEST_DATA()))
+    {
+    return "RequestData";
+    }
+  if (request->Has(vtkStreamingDemandDrivenPipeline::REQUEST_UPDATE_EXTENT()))
+    {
+    return "RequestUpdateExtent";
+    }
+  if (request->Has(vtkDemandDrivenPipeline::REQUEST_INFORMATION()))
+    {
+    return "RequestInformation";
+    }
+  if (request->Has(vtkDemandDrivenPipeline::REQUEST_DATA_OBJECT()))
+    {
+    return "RequestDataObject";
+    }
+  if (request->Has(vtkStreamingDemandDrivenPipeline::REQUEST_UPDATE_TIME()))
+    {
+    return "RequestUpdateTime";
+    }
+  if (request->Has(
+        vtkStreamingDemandDrivenPipeline::REQUEST_TIME_DEPENDENT_INFORMATION()))
+    {
+    return "RequestTimeDependentInformation";
+    }
+  if (request->Has(vtkDemandDrivenPipeline::REQUEST_DATA_NOT_GENERATED()))
+    {
+    return "RequestDataNotGenerated";
+    }
+  return "Other";
+}
+
+// Write a string as a JSON string, escaping the special characters.
+void vtkExecutionProfilerWriteString(ostream& os, const std::string& str)
+{
+  os << '"';
+  for (size_t i=0; i < str.size(); ++i)
+    {
+    char c = str[i];
+    if (c == '"' || c == '\\')
+      {
+      os << '\\' << c;
+      }
+    else if (static_cast<unsigned char>(c) >= 0x20)
+      {
+      os << c;
+      }
+    }
+  os << '"';
+}
+}
+
+//----------------------------------------------------------------------------
+class vtkExecutionProfilerInternals
+{
+public:
+  vtkExecutionProfilerInternals() : Origin(-1.0)
+  {
+  }
+
+  // Return the index of the calling thread, numbered in order of
+  // appearance.
+  int GetThreadIndex()
+  {
+    vtkMultiThreaderIDType id = vtkMultiThreader::GetCurrentThreadID();
+    for (size_t i=0; i < this->Threads.size(); ++i)
+      {
+      if (vtkMultiThreader::ThreadsEqual(this->Threads[i], id))
+        {
+        return static_cast<int>(i);
+        }
+      }
+    this->Threads.push_back(id);
+    this->OpenPasses.push_back(0);
+    return static_cast<int>(this->Threads.size() - 1);
+  }
+
+  // Return the memory used by the process, in bytes.
+  vtkTypeInt64 GetMemoryUsed()
+  {
+    long long used =
+      this->SystemInformation.GetProcMemoryUsed();
+    return used < 0 ? -1 : static_cast<vtkTypeInt64>(used) * 1024;
+  }
+
+  vtkSimpleCriticalSection Lock;
+  std::vector<vtkExecutionProfilerRecord> Records;
+  std::map<vtkAlgorithm*, int> AlgorithmIds;
+  std::vector<vtkMultiThreaderIDType> Threads;
+  std::vector<int> OpenPasses;
+  vtksys::SystemInformation SystemInformation;
+  double Origin;
+};
+
+//----------------------------------------------------------------------------
+vtkExecutionProfiler::vtkExecutionProfiler()
+{
+  this->MeasureMemory = 1;
+  this->Internals = new vtkExecutionProfilerInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkExecutionProfiler::~vtkExecutionProfiler()
+{
+  this->StopProfiling();
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkExecutionProfiler::StartProfiling()
+{
+  this->Internals->Lock.Lock();
+  if (this->Internals->Origin < 0.0)
+    {
+    this->Internals->Origin = vtkTimerLog::GetUniversalTime();
+    }
+  this->Internals->Lock.Unlock();
+  vtkExecutionProfilerActive.store(this);
+}
+
+//----------------------------------------------------------------------------
+void vtkExecutionProfiler::StopProfiling()
+{
+  if (vtkExecutionProfilerActive.load() == this)
+    {
+    vtkExecutionProfilerActive.store(NULL);
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkExecutionProfiler::IsProfiling()
+{
+  return vtkExecutionProfilerActive.load() == this;
+}
+
+//----------------------------------------------------------------------------
+vtkExecutionProfiler *vtkExecutionProfiler::GetActiveProfiler()
+{
+  return vtkExecutionProfilerActive.load();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkExecutionProfiler::GetNumberOfRecords()
+{
+  this->Internals->Lock.Lock();
+  vtkIdType number = static_cast<vtkIdType>(this->Internals->Records.size());
+  this->Internals->Lock.Unlock();
+  return number;
+}
+
+//----------------------------------------------------------------------------
+void vtkExecutionProfiler::ClearRecords()
+{
+  this->Internals->Lock.Lock();
+  this->Internals->Records.clear();
+  this->Internals->AlgorithmIds.clear();
+  this->Internals->Origin = this->IsProfiling() ?
+    vtkTimerLog::GetUniversalTime() : -1.0;
+  this->Internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkExecutionProfiler::BeginPass(vtkAlgorithm *algorithm,
+                                          vtkInformation *request)
+{
+  vtkExecutionProfilerRecord record;
+  record.Algorithm = algorithm->GetClassName();
+  record.Pass = vtkExecutionProfilerPassName(request);
+  record.WallTime = record.CPUTime = record.ThreadUtilization = 0.0;
+  record.MemoryDelta = record.OutputSize = -1;
+  record.Done = false;
+  record.StartMemory = this->MeasureMemory ?
+    this->Internals->GetMemoryUsed() : -1;
+
+  vtkExecutionProfilerInternals *internals = this->Internals;
+  internals->Lock.Lock();
+  std::map<vtkAlgorithm*, int>::iterator id =
+    internals->AlgorithmIds.find(algorithm);
+  if (id == internals->AlgorithmIds.end())
+    {
+    id = internals->AlgorithmIds.insert(std::make_pair(
+      algorithm, static_cast<int>(internals->AlgorithmIds.size()))).first;
+    }
+  record.AlgorithmId = id->second;
+  record.Thread = internals->GetThreadIndex();
+  record.Depth = internals->OpenPasses[record.Thread]++;
+  record.StartCPUTime = vtkTimerLog::GetCPUTime();
+  record.StartTime = vtkTimerLog::GetUniversalTime() - internals->Origin;
+  vtkIdType recordId = static_cast<vtkIdType>(internals->Records.size());
+  internals->Records.push_back(record);
+  internals->Lock.Unlock();
+  return recordId;
+}
+
+//----------------------------------------------------------------------------
+void vtkExecutionProfiler::EndPass(vtkIdType recordId,
+                                   vtkInformation *request,
+                                   vtkInformationVector *outInfo)
+{
+  double endTime = vtkTimerLog::GetUniversalTime();
+  double endCPUTime = vtkTimerLog::GetCPUTime();
+  vtkTypeInt64 endMemory = this->MeasureMemory ?
+    this->Internals->GetMemoryUsed() : -1;
+
+  // The size of the outputs, once they have been generated.
+  vtkTypeInt64 outputSize = -1;
+  if (outInfo && request->Has(vtkDemandDrivenPipeline::REQUEST_DATA()))
+    {
+    outputSize = 0;
+    for (int i=0; i < outInfo->GetNumberOfInformationObjects(); ++i)
+      {
+      vtkDataObject *output =
+        outInfo->GetInformationObject(i)->Get(vtkDataObject::DATA_OBJECT());
+      if (output)
+        {
+        outputSize += static_cast<vtkTypeInt64>(
+          output->GetActualMemorySize()) * 1024;
+        }
+      }
+    }
+
+  vtkExecutionProfilerInternals *internals = this->Internals;
+  internals->Lock.Lock();
+  if (recordId >= 0 &&
+      recordId < static_cast<vtkIdType>(internals->Records.size()))
+    {
+    vtkExecutionProfilerRecord &record = internals->Records[recordId];
+    record.WallTime = endTime - internals->Origin - record.StartTime;
+    record.CPUTime = endCPUTime - record.StartCPUTime;
+    if (record.WallTime > 0.0)
+      {
+      record.ThreadUtilization = record.CPUTime / (record.WallTime *
+        vtkSMPTools::GetEstimatedNumberOfThreads());
+      }
+    if (record.StartMemory >= 0 && endMemory >= 0)
+      {
+      record.MemoryDelta = endMemory - record.StartMemory;
+      }
+    record.OutputSize = outputSize;
+    record.Done = true;
+    internals->OpenPasses[record.Thread]--;
+    }
+  internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkExecutionProfiler::GetRecords(vtkTable *table)
+{
+  if (!table)
+    {
+    return;
+    }
+
+  vtkStringArray *algorithms = vtkStringArray::New();
+  algorithms->SetName("Algorithm");
+  vtkIntArray *algorithmIds = vtkIntArray::New();
+  algorithmIds->SetName("AlgorithmId");
+  vtkStringArray *passes = vtkStringArray::New();
+  passes->SetName("Pass");
+  vtkIntArray *threads = vtkIntArray::New();
+  threads->SetName("Thread");
+  vtkIntArray *depths = vtkIntArray::New();
+  depths->SetName("Depth");
+  vtkDoubleArray *startTimes = vtkDoubleArray::New();
+  startTimes->SetName("StartTime");
+  vtkDoubleArray *wallTimes = vtkDoubleArray::New();
+  wallTimes->SetName("WallTime");
+  vtkDoubleArray *cpuTimes = vtkDoubleArray::New();
+  cpuTimes->SetName("CPUTime");
+  vtkDoubleArray *utilizations = vtkDoubleArray::New();
+  utilizations->SetName("ThreadUtilization");
+  vtkTypeInt64Array *memoryDeltas = vtkTypeInt64Array::New();
+  memoryDeltas->SetName("MemoryDelta");
+  vtkTypeInt64Array *outputSizes = vtkTypeInt64Array::New();
+  outputSizes->SetName("OutputSize");
+
+  this->Internals->Lock.Lock();
+  std::vector<vtkExecutionProfilerRecord> &records = this->Internals->Records;
+  vtkIdType numRecords = static_cast<vtkIdType>(records.size());
+  algorithms->SetNumberOfValues(numRecords);
+  algorithmIds->SetNumberOfValues(numRecords);
+  passes->SetNumberOfValues(numRecords);
+  threads->SetNumberOfValues(numRecords);
+  depths->SetNumberOfValues(numRecords);
+  startTimes->SetNumberOfValues(numRecords);
+  wallTimes->SetNumberOfValues(numRecords);
+  cpuTimes->SetNumberOfValues(numRecords);
+  utilizations->SetNumberOfValues(numRecords);
+  memoryDeltas->SetNumberOfValues(numRecords);
+  outputSizes->SetNumberOfValues(numRecords);
+  for (vtkIdType i=0; i < numRecords; ++i)
+    {
+    const vtkExecutionProfilerRecord &record = records[i];
+    algorithms->SetValue(i, record.Algorithm);
+    algorithmIds->SetValue(i, record.AlgorithmId);
+    passes->SetValue(i, record.Pass);
+    threads->SetValue(i, record.Thread);
+    depths->SetValue(i, record.Depth);
+    startTimes->SetValue(i, record.StartTime);
+    wallTimes->SetValue(i, record.WallTime);
+    cpuTimes->SetValue(i, record.CPUTime);
+    utilizations->SetValue(i, record.ThreadUtilization);
+    memoryDeltas->SetValue(i, record.MemoryDelta);
+    outputSizes->SetValue(i, record.OutputSize);
+    }
+  this->Internals->Lock.Unlock();
+
+  table->Initialize();
+  table->AddColumn(algorithms);
+  table->AddColumn(algorithmIds);
+  table->AddColumn(passes);
+  table->AddColumn(threads);
+  table->AddColumn(depths);
+  table->AddColumn(startTimes);
+  table->AddColumn(wallTimes);
+  table->AddColumn(cpuTimes);
+  table->AddColumn(utilizations);
+  table->AddColumn(memoryDeltas);
+  table->AddColumn(outputSizes);
+
+  algorithms->Delete();
+  algorithmIds->Delete();
+  passes->Delete();
+  threads->Delete();
+  depths->Delete();
+  startTimes->Delete();
+  wallTimes->Delete();
+  cpuTimes->Delete();
+  utilizations->Delete();
+  memoryDeltas->Delete();
+  outputSizes->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkExecutionProfiler::WriteChromeTrace(ostream& os)
+{
+  // Complete events ("ph":"X"), with times in microseconds.
+  os << "{\"traceEvents\":[";
+  this->Internals->Lock.Lock();
+  std::vector<vtkExecutionProfilerRecord> &records = this->Internals->Records;
+  bool first = true;
+  for (size_t i=0; i < records.size(); ++i)
+    {
+    const vtkExecutionProfilerRecord &record = records[i];
+    if (!record.Done)
+      {
+      continue;
+      }
+    os << (first ? "\n" : ",\n") << "{\"name\":";
+    first = false;
+    vtkExecutionProfilerWriteString(os, record.Algorithm);
+    os << ",\"cat\":\"" << record.Pass << "\",\"ph\":\"X\""
+       << ",\"ts\":" << record.StartTime * 1.0e6
+       << ",\"dur\":" << record.WallTime * 1.0e6
+       << ",\"pid\":0,\"tid\":" << record.Thread
+       << ",\"args\":{\"pass\":\"" << record.Pass << "\""
+       << ",\"algorithm_id\":" << record.AlgorithmId
+       << ",\"cpu_time\":" << record.CPUTime
+       << ",\"thread_utilization\":" << record.ThreadUtilization
+       << ",\"memory_delta\":" << record.MemoryDelta
+       << ",\"output_size\":" << record.OutputSize << "}}";
+    }
+  this->Internals->Lock.Unlock();
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+//----------------------------------------------------------------------------
+bool vtkExecutionProfiler::WriteChromeTrace(const char *fileName)
+{
+  if (!fileName)
+    {
+    vtkErrorMacro("No file name specified.");
+    return false;
+    }
+  ofstream os(fileName);
+  if (!os)
+    {
+    vtkErrorMacro("Cannot open " << fileName << " for writing.");
+    return false;
+    }
+  os.precision(15);
+  this->WriteChromeTrace(os);
+  return !os.fail();
+}
+
+//----------------------------------------------------------------------------
+void vtkExecutionProfiler::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Profiling: " << (this->IsProfiling() ? "On\n" : "Off\n");
+  os << indent << "MeasureMemory: " << this->MeasureMemory << "\n";
+  os << indent << "Number Of Records: " << this->GetNumberOfRecords() << "\n";
+}
@@ -0,0 +1,134 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkExecutionProfiler.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkExecutionProfiler - record the passes executed by all algorithms
+// .SECTION Description
+// vtkExecutionProfiler records, while it is active, every request pass
+// (RequestDataObject, RequestInformation, RequestUpdateExtent, RequestData,
+// ...) that the executives of a process hand to their algorithms. Unlike
+// vtkExecutionTimer, which observes a single filter, it gives a breakdown of
+// a whole pipeline without any change to the filters:
+// \code
+// vtkExecutionProfiler *profiler = vtkExecutionProfiler::New();
+// profiler->StartProfiling();
+// writer->Update();
+// profiler->StopProfiling();
+// profiler->GetRecords(table);
+// profiler->WriteChromeTrace("pipeline.json");
+// \endcode
+//
+// For each pass, the following metrics are recorded:
+// - the wall time and the CPU time of the process during the pass;
+// - the thread utilization, that is the CPU time divided by the wall time
+//   and by the number of threads vtkSMPTools may use (see Caveats);
+// - the change of the memory used by the process during the pass;
+// - the memory used by the output data objects, for RequestData passes.
+//
+// The records can be retrieved as a vtkTable, with one row per pass, or
+// written in the trace event format of the Chrome tracing tool
+// (chrome://tracing), in which the nested passes of algorithms running
+// internal pipelines show up as stacked slices.
+
+// .SECTION Caveats
+// Only one profiler is active at a time. The CPU time and the memory are
+// measured for the whole process, so passes executed concurrently by
+// several threads (vtkThreadedCompositeDataPipeline, or pipelines updated
+// from different threads) are not separated: each of them is charged the
+// CPU time and memory of all the others. The thread utilization of such
+// passes is therefore meaningless; it is only an estimate of how well a
+// pass uses vtkSMPTools when it is the only one executing.
+
+// .SECTION See Also
+// vtkExecutionTimer vtkExecutive vtkTimerLog
+
+#ifndef vtkExecutionProfiler_h
+#define vtkExecutionProfiler_h
+
+#include "vtkCommonExecutionModelModule.h" // For export macro
+#include "vtkObject.h"
+
+class vtkAlgorithm;
+class vtkExecutionProfilerInternals;
+class vtkInformation;
+class vtkInformationVector;
+class vtkTable;
+
+class VTKCOMMONEXECUTIONMODEL_EXPORT vtkExecutionProfiler : public vtkObject
+{
+public:
+  static vtkExecutionProfiler *New();
+  vtkTypeMacro(vtkExecutionProfiler,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Start recording the passes of all executives, replacing the profiler
+  // active until now if any, or stop recording. Start times are relative
+  // to the first call to StartProfiling() since the records were cleared.
+  void StartProfiling();
+  void StopProfiling();
+  bool IsProfiling();
+
+  // Description:
+  // Return the active profiler, or NULL if no profiler is active.
+  static vtkExecutionProfiler *GetActiveProfiler();
+
+  // Description:
+  // Turn on/off the measure of the memory used by the process, which
+  // queries the operating system twice per pass. On by default.
+  vtkSetMacro(MeasureMemory, int);
+  vtkGetMacro(MeasureMemory, int);
+  vtkBooleanMacro(MeasureMemory, int);
+
+  // Description:
+  // Return the number of recorded passes, or discard them. The records
+  // must not be cleared while the pipeline executes.
+  vtkIdType GetNumberOfRecords();
+  void ClearRecords();
+
+  // Description:
+  // Fill the table with one row per recorded pass, in the order in which
+  // the passes started. The columns are Algorithm (class name), AlgorithmId
+  // (a number identifying the algorithm instance), Pass, Thread, Depth (the
+  // number of enclosing passes), StartTime, WallTime and CPUTime (in
+  // seconds), ThreadUtilization, MemoryDelta and OutputSize (in bytes, -1
+  // when not measured). CPUTime, ThreadUtilization and MemoryDelta are
+  // process-wide and include the work of concurrently executing passes.
+  void GetRecords(vtkTable *table);
+
+  // Description:
+  // Write the records in the Chrome trace event JSON format.
+  void WriteChromeTrace(ostream& os);
+  bool WriteChromeTrace(const char *fileName);
+
+  // Description:
+  // Called by vtkExecutive around each call to the algorithm. BeginPass()
+  // returns the identifier of the new record, to pass to EndPass().
+  vtkIdType BeginPass(vtkAlgorithm *algorithm, vtkInformation *request);
+  void EndPass(vtkIdType recordId, vtkInformation *request,
+               vtkInformationVector *outInfo);
+
+protected:
+  vtkExecutionProfiler();
+  ~vtkExecutionProfiler();
+
+  int MeasureMemory;
+
+  vtkExecutionProfilerInternals *Internals;
+
+private:
+  vtkExecutionProfiler(const vtkExecutionProfiler&);  // Not implemented.
+  void operator=(const vtkExecutionProfiler&);  // Not implemented.
+};
+
+#endif
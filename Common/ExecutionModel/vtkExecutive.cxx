@@ -17,6 +17,7 @@
 #include "vtkAlgorithm.h"
 #include "vtkAlgorithmOutput.h"
 #include "vtkDataObject.h"
+#include "vtkExecutionProfiler.h"
 #include "vtkGarbageCollector.h"
 #include "vtkInformation.h"
 #include "vtkInformationExecutivePortKey.h"
@@ -770,11 +771,26 @@ int vtkExecutive::CallAlgorithm(vtkInformation* request, int direction,
   // Copy default information in the direction of information flow.
   this->CopyDefaultInformation(request, direction, inInfo, outInfo);
 
+  // Record the pass if the pipeline is being profiled. The profiler is
+  // only referenced when one is active.
+  vtkSmartPointer<vtkExecutionProfiler> profiler;
+  vtkIdType recordId = -1;
+  if(vtkExecutionProfiler *active = vtkExecutionProfiler::GetActiveProfiler())
+    {
+    profiler = active;
+    recordId = profiler->BeginPass(this->Algorithm, request);
+    }
+
   // Invoke the request on the algorithm.
   this->InAlgorithm = 1;
   int result = this->Algorithm->ProcessRequest(request, inInfo, outInfo);
   this->InAlgorithm = 0;
 
+  if(profiler)
+    {
+    profiler->EndPass(recordId, request, outInfo);
+    }
+
   // If the algorithm failed report it now.
   if(!result)
     {
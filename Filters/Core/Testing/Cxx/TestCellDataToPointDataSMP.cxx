@@ -0,0 +1,267 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellDataToPointDataSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded executions (EnableSMP) of vtkCellDataToPointData
+// and vtkPointDataToCellData produce the data of the serial ones, on image
+// data, rectilinear and structured grids (with blanking), unstructured grids
+// and polydata.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCellDataToPointData.h>
+#include <vtkCellType.h>
+#include <vtkDataArray.h>
+#include <vtkDataSetTriangleFilter.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkPointDataToCellData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkRectilinearGrid.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
+#include <vtkStructuredGrid.h>
+#include <vtkTestDataSetComparison.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cmath>
+
+namespace
+{
+// Add a named 3-component array, a named float array and unnamed scalars.
+void AddArrays(vtkDataSetAttributes *data, vtkIdType num)
+{
+  vtkSmartPointer<vtkDoubleArray> vectors =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vtkSmartPointer<vtkFloatArray> values = vtkSmartPointer<vtkFloatArray>::New();
+  values->SetName("Values");
+  vtkSmartPointer<vtkDoubleArray> scalars =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  for (vtkIdType i = 0; i < num; ++i)
+    {
+    vectors->InsertNextTuple3(sin(0.1 * i), 0.5 * i, cos(0.3 * i));
+    values->InsertNextValue(static_cast<float>(i % 17) - 3.5f);
+    scalars->InsertNextValue(1.0 / (1.0 + i));
+    }
+  data->AddArray(vectors);
+  data->AddArray(values);
+  data->SetScalars(scalars);
+}
+
+bool SameData(vtkDataSetAttributes *a, vtkDataSetAttributes *b)
+{
+  return a->GetArray("Vectors") && a->GetArray("Values") && a->GetScalars() &&
+         vtkTest::SameAttributes(a, b, 1.0e-5);
+}
+
+// Convert the data of a dataset with and without threads.
+bool CheckConversions(vtkDataSet *input, const char *name)
+{
+  AddArrays(input->GetPointData(), input->GetNumberOfPoints());
+  AddArrays(input->GetCellData(), input->GetNumberOfCells());
+
+  vtkSmartPointer<vtkCellDataToPointData> c2p[2];
+  vtkSmartPointer<vtkPointDataToCellData> p2c[2];
+  for (int i = 0; i < 2; ++i)
+    {
+    c2p[i] = vtkSmartPointer<vtkCellDataToPointData>::New();
+    c2p[i]->SetInputData(input);
+    c2p[i]->SetEnableSMP(i == 1);
+    c2p[i]->Update();
+    p2c[i] = vtkSmartPointer<vtkPointDataToCellData>::New();
+    p2c[i]->SetInputData(input);
+    p2c[i]->SetEnableSMP(i == 1);
+    p2c[i]->Update();
+    }
+  if (!SameData(c2p[0]->GetOutput()->GetPointData(),
+                c2p[1]->GetOutput()->GetPointData()))
+    {
+    cerr << "Different point data for the " << name << endl;
+    return false;
+    }
+  if (!SameData(p2c[0]->GetOutput()->GetCellData(),
+                p2c[1]->GetOutput()->GetCellData()))
+    {
+    cerr << "Different cell data for the " << name << endl;
+    return false;
+    }
+  return true;
+}
+}
+
+int TestCellDataToPointDataSMP(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(-3, 20, 2, 19, 0, 15);
+  vtkSmartPointer<vtkImageData> slice = vtkSmartPointer<vtkImageData>::New();
+  slice->SetExtent(0, 30, 4, 4, -5, 12);
+  vtkSmartPointer<vtkImageData> line = vtkSmartPointer<vtkImageData>::New();
+  line->SetExtent(0, 0, 0, 40, 0, 0);
+
+  vtkSmartPointer<vtkRectilinearGrid> rGrid =
+    vtkSmartPointer<vtkRectilinearGrid>::New();
+  rGrid->SetDimensions(12, 9, 14);
+  vtkSmartPointer<vtkDoubleArray> coordinates[3];
+  for (int i = 0; i < 3; ++i)
+    {
+    coordinates[i] = vtkSmartPointer<vtkDoubleArray>::New();
+    for (int j = 0; j < rGrid->GetDimensions()[i]; ++j)
+      {
+      coordinates[i]->InsertNextValue(j * j * 0.1);
+      }
+    }
+  rGrid->SetXCoordinates(coordinates[0]);
+  rGrid->SetYCoordinates(coordinates[1]);
+  rGrid->SetZCoordinates(coordinates[2]);
+
+  // A structured grid with blanked cells.
+  vtkSmartPointer<vtkStructuredGrid> sGrid =
+    vtkSmartPointer<vtkStructuredGrid>::New();
+  sGrid->SetDimensions(10, 13, 11);
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  for (int k = 0; k < 11; ++k)
+    {
+    for (int j = 0; j < 13; ++j)
+      {
+      for (int i = 0; i < 10; ++i)
+        {
+        points->InsertNextPoint(i + 0.1 * j, j, k + 0.2 * i);
+        }
+      }
+    }
+  sGrid->SetPoints(points);
+  for (vtkIdType cellId = 0; cellId < sGrid->GetNumberOfCells(); cellId += 7)
+    {
+    sGrid->BlankCell(cellId);
+    }
+
+  // Tetrahedra, and polydata with vertices, lines, triangles and quads.
+  vtkSmartPointer<vtkImageData> tetImage =
+    vtkSmartPointer<vtkImageData>::New();
+  tetImage->SetDimensions(9, 8, 10);
+  vtkSmartPointer<vtkDataSetTriangleFilter> tetrahedralize =
+    vtkSmartPointer<vtkDataSetTriangleFilter>::New();
+  tetrahedralize->SetInputData(tetImage);
+  tetrahedralize->Update();
+  vtkSmartPointer<vtkUnstructuredGrid> uGrid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  uGrid->ShallowCopy(tetrahedralize->GetOutput());
+
+  const int size = 30;
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  vtkSmartPointer<vtkPoints> polyPoints = vtkSmartPointer<vtkPoints>::New();
+  for (int j = 0; j < size; ++j)
+    {
+    for (int i = 0; i < size; ++i)
+      {
+      polyPoints->InsertNextPoint(i, j, sin(0.2 * i * j));
+      }
+    }
+  // An unused point.
+  polyPoints->InsertNextPoint(-1.0, -1.0, 0.0);
+  polyData->SetPoints(polyPoints);
+  polyData->Allocate();
+  for (int j = 0; j < size - 1; ++j)
+    {
+    for (int i = 0; i < size - 1; ++i)
+      {
+      vtkIdType p = j * size + i;
+      if ((i + j) % 3)
+        {
+        vtkIdType quad[4] = { p, p + 1, p + size + 1, p + size };
+        polyData->InsertNextCell(VTK_QUAD, 4, quad);
+        }
+      else
+        {
+        vtkIdType tri1[3] = { p, p + 1, p + size + 1 };
+        vtkIdType tri2[3] = { p, p + size + 1, p + size };
+        polyData->InsertNextCell(VTK_TRIANGLE, 3, tri1);
+        polyData->InsertNextCell(VTK_TRIANGLE, 3, tri2);
+        }
+      }
+    }
+  vtkIdType vertex = 5;
+  vtkIdType segment[2] = { 7, 8 };
+  polyData->InsertNextCell(VTK_VERTEX, 1, &vertex);
+  polyData->InsertNextCell(VTK_LINE, 2, segment);
+
+  if (!CheckConversions(image, "image") ||
+      !CheckConversions(slice, "slice") ||
+      !CheckConversions(line, "line") ||
+      !CheckConversions(rGrid, "rectilinear grid") ||
+      !CheckConversions(sGrid, "structured grid") ||
+      !CheckConversions(uGrid, "unstructured grid") ||
+      !CheckConversions(polyData, "polydata"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Polydata with cells in 32-bit storage, selected by Squeeze(), and then
+  // string arrays, which are converted by the serial executions.
+  vtkSmartPointer<vtkPolyData> polyData32 = vtkSmartPointer<vtkPolyData>::New();
+  polyData32->DeepCopy(polyData);
+  polyData32->GetPolys()->SetStorageLayoutToOffsets();
+  polyData32->DeleteCells();
+  polyData32->Squeeze();
+  if ((sizeof(vtkIdType) > 4 && !polyData32->GetPolys()->IsStorage32Bit()) ||
+      !CheckConversions(polyData32, "polydata with 32-bit cells"))
+    {
+    return EXIT_FAILURE;
+    }
+  vtkSmartPointer<vtkStringArray> labels =
+    vtkSmartPointer<vtkStringArray>::New();
+  labels->SetName("Labels");
+  for (vtkIdType i = 0; i < polyData32->GetNumberOfPoints(); ++i)
+    {
+    labels->InsertNextValue(i % 2 ? "odd" : "even");
+    }
+  polyData32->GetPointData()->AddArray(labels);
+  vtkSmartPointer<vtkStringArray> cellLabels =
+    vtkSmartPointer<vtkStringArray>::New();
+  cellLabels->SetName("Labels");
+  for (vtkIdType i = 0; i < polyData32->GetNumberOfCells(); ++i)
+    {
+    cellLabels->InsertNextValue(i % 3 ? "side" : "corner");
+    }
+  polyData32->GetCellData()->AddArray(cellLabels);
+  if (!CheckConversions(polyData32, "polydata with string arrays"))
+    {
+    return EXIT_FAILURE;
+    }
+  vtkSmartPointer<vtkPointDataToCellData> p2c =
+    vtkSmartPointer<vtkPointDataToCellData>::New();
+  p2c->SetInputData(polyData32);
+  p2c->SetEnableSMP(true);
+  p2c->Update();
+  vtkSmartPointer<vtkCellDataToPointData> c2p =
+    vtkSmartPointer<vtkCellDataToPointData>::New();
+  c2p->SetInputData(polyData32);
+  c2p->SetEnableSMP(true);
+  c2p->Update();
+  if (!p2c->GetOutput()->GetCellData()->GetAbstractArray("Labels") ||
+      !c2p->GetOutput()->GetPointData()->GetAbstractArray("Labels"))
+    {
+    cerr << "String array not converted" << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,257 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCleanPolyDataSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded execution of vtkCleanPolyData (EnableSMP)
+// produces the same cells as the serial one. The output points are
+// numbered differently, so the cells are compared through the coordinates
+// and the data of their points. String arrays are also passed.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCleanPolyData.h>
+#include <vtkFloatArray.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkMinimalStandardRandomSequence.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
+#include <vtkTestDataSetComparison.h>
+
+namespace
+{
+const int GridSize = 20;
+
+// A grid of quads whose points are duplicated (the copies being shifted by
+// jitter), each corner using one of the copies at random. Some quads are
+// collapsed into triangles, lines or points, and the mesh also has verts,
+// lines, strips, unused points and point and cell scalars.
+vtkSmartPointer<vtkPolyData> CreateMesh(double jitter)
+{
+  vtkSmartPointer<vtkMinimalStandardRandomSequence> random =
+    vtkSmartPointer<vtkMinimalStandardRandomSequence>::New();
+  random->SetSeed(1);
+
+  const int numGridPts = GridSize * GridSize;
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkFloatArray> pointScalars =
+    vtkSmartPointer<vtkFloatArray>::New();
+  pointScalars->SetName("GridIndex");
+  for (int copy = 0; copy < 2; ++copy)
+    {
+    for (int i = 0; i < numGridPts; ++i)
+      {
+      points->InsertNextPoint(i % GridSize + copy * jitter,
+                              i / GridSize, 0.1 * (i % 3));
+      pointScalars->InsertNextValue(static_cast<float>(i));
+      }
+    }
+  for (int i = 0; i < 5; ++i)
+    {
+    points->InsertNextPoint(-1.0 - i, -1.0, 0.0);
+    pointScalars->InsertNextValue(-1.0f);
+    }
+
+  vtkIdType ids[GridSize];
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  for (int j = 0; j < GridSize - 1; ++j)
+    {
+    for (int i = 0; i < GridSize - 1; ++i)
+      {
+      int corners[4] = { j * GridSize + i, j * GridSize + i + 1,
+                         (j + 1) * GridSize + i + 1, (j + 1) * GridSize + i };
+      int cellId = j * GridSize + i;
+      if (cellId % 5 == 0)
+        {
+        corners[1] = corners[0];
+        }
+      if (cellId % 11 == 0)
+        {
+        corners[2] = corners[3];
+        }
+      if (cellId % 17 == 0)
+        {
+        corners[3] = corners[0];
+        }
+      for (int k = 0; k < 4; ++k)
+        {
+        random->Next();
+        ids[k] = corners[k] + (random->GetValue() < 0.5 ? 0 : numGridPts);
+        }
+      polys->InsertNextCell(4, ids);
+      }
+    }
+
+  vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New();
+  vtkSmartPointer<vtkCellArray> verts = vtkSmartPointer<vtkCellArray>::New();
+  vtkSmartPointer<vtkCellArray> strips = vtkSmartPointer<vtkCellArray>::New();
+  for (int j = 0; j < GridSize; j += 3)
+    {
+    for (int i = 0; i < GridSize; ++i)
+      {
+      ids[i] = j * GridSize + i + (i % 2) * numGridPts;
+      }
+    lines->InsertNextCell(GridSize, ids);
+    ids[1] = ids[0] + numGridPts;
+    lines->InsertNextCell(2, ids);
+    verts->InsertNextCell(3, ids);
+    strips->InsertNextCell(4, ids + 1);
+    strips->InsertNextCell(8, ids + 4);
+    ids[5] = ids[4] + numGridPts;
+    strips->InsertNextCell(3, ids + 4);
+    }
+
+  vtkSmartPointer<vtkPolyData> mesh = vtkSmartPointer<vtkPolyData>::New();
+  mesh->SetPoints(points);
+  mesh->SetVerts(verts);
+  mesh->SetLines(lines);
+  mesh->SetPolys(polys);
+  mesh->SetStrips(strips);
+  mesh->GetPointData()->SetScalars(pointScalars);
+
+  vtkSmartPointer<vtkIdTypeArray> cellScalars =
+    vtkSmartPointer<vtkIdTypeArray>::New();
+  cellScalars->SetName("CellIds");
+  for (vtkIdType i = 0; i < mesh->GetNumberOfCells(); ++i)
+    {
+    cellScalars->InsertNextValue(i);
+    }
+  mesh->GetCellData()->SetScalars(cellScalars);
+  return mesh;
+}
+
+bool SameCells(vtkPolyData *a, vtkCellArray *cellsA,
+               vtkPolyData *b, vtkCellArray *cellsB, double tolerance)
+{
+  if (cellsA->GetNumberOfCells() != cellsB->GetNumberOfCells())
+    {
+    return false;
+    }
+  vtkDataArray *scalarsA = a->GetPointData()->GetScalars();
+  vtkDataArray *scalarsB = b->GetPointData()->GetScalars();
+  vtkSmartPointer<vtkIdList> ptsA = vtkSmartPointer<vtkIdList>::New();
+  vtkSmartPointer<vtkIdList> ptsB = vtkSmartPointer<vtkIdList>::New();
+  for (vtkIdType cellId = 0; cellId < cellsA->GetNumberOfCells(); ++cellId)
+    {
+    cellsA->GetCellAtId(cellId, ptsA);
+    cellsB->GetCellAtId(cellId, ptsB);
+    if (ptsA->GetNumberOfIds() != ptsB->GetNumberOfIds())
+      {
+      return false;
+      }
+    for (vtkIdType i = 0; i < ptsA->GetNumberOfIds(); ++i)
+      {
+      if (!vtkTest::SameTuples(a->GetPoints()->GetData(), ptsA->GetId(i),
+                               b->GetPoints()->GetData(), ptsB->GetId(i),
+                               tolerance) ||
+          !vtkTest::SameTuples(scalarsA, ptsA->GetId(i),
+                               scalarsB, ptsB->GetId(i)))
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+bool SameOutputs(vtkPolyData *a, vtkPolyData *b, double tolerance)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      !SameCells(a, a->GetVerts(), b, b->GetVerts(), tolerance) ||
+      !SameCells(a, a->GetLines(), b, b->GetLines(), tolerance) ||
+      !SameCells(a, a->GetPolys(), b, b->GetPolys(), tolerance) ||
+      !SameCells(a, a->GetStrips(), b, b->GetStrips(), tolerance))
+    {
+    return false;
+    }
+  vtkDataArray *cellScalarsA = a->GetCellData()->GetScalars();
+  return cellScalarsA &&
+    vtkTest::SameArrays(cellScalarsA, b->GetCellData()->GetScalars());
+}
+}
+
+int TestCleanPolyDataSMP(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+
+  vtkSmartPointer<vtkPolyData> meshes[3];
+  meshes[0] = CreateMesh(0.0);
+  meshes[1] = CreateMesh(1.0e-4);
+  meshes[2] = vtkSmartPointer<vtkPolyData>::New();
+  meshes[2]->DeepCopy(meshes[0]);
+  meshes[2]->GetPolys()->ConvertTo32BitStorage(
+    meshes[2]->GetNumberOfPoints());
+  meshes[2]->GetLines()->SetStorageLayoutToOffsets();
+
+  vtkSmartPointer<vtkCleanPolyData> serial =
+    vtkSmartPointer<vtkCleanPolyData>::New();
+  vtkSmartPointer<vtkCleanPolyData> threaded =
+    vtkSmartPointer<vtkCleanPolyData>::New();
+  threaded->EnableSMPOn();
+
+  for (int option = 0; option < 48; ++option)
+    {
+    vtkPolyData *mesh = meshes[option / 16];
+    vtkCleanPolyData *filters[2] = { serial, threaded };
+    for (int f = 0; f < 2; ++f)
+      {
+      filters[f]->SetInputData(mesh);
+      filters[f]->SetPointMerging((option & 1) == 0);
+      filters[f]->SetToleranceIsAbsolute(1);
+      filters[f]->SetAbsoluteTolerance((option & 2) ? 1.0e-3 : 0.0);
+      filters[f]->SetConvertLinesToPoints((option & 4) != 0);
+      filters[f]->SetConvertPolysToLines((option & 8) != 0);
+      filters[f]->SetConvertStripsToPolys(option % 3 != 0);
+      filters[f]->Update();
+      }
+    if (!SameOutputs(serial->GetOutput(), threaded->GetOutput(), 1.0e-3))
+      {
+      cerr << "Different outputs with options " << option << endl;
+      return EXIT_FAILURE;
+      }
+    vtkIdType numMerged = mesh->GetNumberOfPoints() -
+      threaded->GetOutput()->GetNumberOfPoints();
+    bool merging = (option & 1) == 0 && (mesh != meshes[1] || (option & 2));
+    if (merging != (numMerged > GridSize * GridSize))
+      {
+      cerr << "Unexpected number of points (" << numMerged
+           << " removed) with options " << option << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // The string arrays are passed like with the serial execution.
+  vtkSmartPointer<vtkStringArray> labels =
+    vtkSmartPointer<vtkStringArray>::New();
+  labels->SetName("Labels");
+  for (vtkIdType i = 0; i < meshes[0]->GetNumberOfCells(); ++i)
+    {
+    labels->InsertNextValue(i % 2 ? "odd" : "even");
+    }
+  meshes[0]->GetCellData()->AddArray(labels);
+  threaded->SetInputData(meshes[0]);
+  threaded->Update();
+  vtkStringArray *outLabels = vtkStringArray::SafeDownCast(
+    threaded->GetOutput()->GetCellData()->GetAbstractArray("Labels"));
+  if (!outLabels || outLabels->GetNumberOfValues() !=
+        threaded->GetOutput()->GetNumberOfCells())
+    {
+    cerr << "String array not passed" << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,344 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestConnectivityFilterSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded connectivity filters find the same regions, and
+// extract the same cells, as the serial ones, in all extraction modes,
+// including on polydata whose cells use 32-bit storage.
+
+#include "vtkAppendFilter.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkConnectivityFilter.h"
+#include "vtkDataSet.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataConnectivityFilter.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+namespace
+{
+void AddCellIds(vtkDataSet *data)
+{
+  vtkSmartPointer<vtkIntArray> cellIds = vtkSmartPointer<vtkIntArray>::New();
+  cellIds->SetName("CellIds");
+  for (vtkIdType cellId = 0; cellId < data->GetNumberOfCells(); ++cellId)
+    {
+    cellIds->InsertNextValue(static_cast<int>(cellId));
+    }
+  data->GetCellData()->AddArray(cellIds);
+}
+
+vtkSmartPointer<vtkFloatArray> RandomScalars(vtkIdType numPts)
+{
+  vtkSmartPointer<vtkFloatArray> scalars =
+    vtkSmartPointer<vtkFloatArray>::New();
+  scalars->SetName("Scalars");
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+    {
+    scalars->InsertNextValue(vtkMath::Random());
+    }
+  return scalars;
+}
+
+// Compare the extracted cells (by their input id), their points and the
+// regions of their points. When sameRegions is set, the regions of the
+// cells are compared as well.
+bool SameOutputs(vtkDataSet *serial, vtkDataSet *smp, bool samePoints,
+                 bool sameRegions, const char *name)
+{
+  vtkDataArray *serialCellIds = serial->GetCellData()->GetArray("CellIds");
+  vtkDataArray *smpCellIds = smp->GetCellData()->GetArray("CellIds");
+  vtkDataArray *serialPtRegions = serial->GetPointData()->GetArray("RegionId");
+  vtkDataArray *smpPtRegions = smp->GetPointData()->GetArray("RegionId");
+  vtkDataArray *smpScalars = smp->GetPointData()->GetArray("Scalars");
+  if ( !serialCellIds || !smpCellIds || !serialPtRegions || !smpPtRegions ||
+       !smpScalars || smp->GetPointData()->GetScalars() != smpPtRegions ||
+       serial->GetNumberOfCells() != smp->GetNumberOfCells() ||
+       smp->GetNumberOfCells() == 0 ||
+       (samePoints && serial->GetNumberOfPoints() != smp->GetNumberOfPoints()))
+    {
+    cerr << "Different outputs for " << name << endl;
+    return false;
+    }
+  vtkDataArray *serialCellRegions = serial->GetCellData()->GetArray("RegionId");
+  vtkDataArray *smpCellRegions = smp->GetCellData()->GetArray("RegionId");
+
+  vtkSmartPointer<vtkIdList> pts1 = vtkSmartPointer<vtkIdList>::New();
+  vtkSmartPointer<vtkIdList> pts2 = vtkSmartPointer<vtkIdList>::New();
+  for (vtkIdType cellId = 0; cellId < smp->GetNumberOfCells(); ++cellId)
+    {
+    serial->GetCellPoints(cellId, pts1);
+    smp->GetCellPoints(cellId, pts2);
+    bool same = ( serial->GetCellType(cellId) == smp->GetCellType(cellId) &&
+                  pts1->GetNumberOfIds() == pts2->GetNumberOfIds() &&
+                  serialCellIds->GetComponent(cellId, 0) ==
+                  smpCellIds->GetComponent(cellId, 0) );
+    if ( same && sameRegions )
+      {
+      same = ( serialCellRegions && smpCellRegions &&
+               serialCellRegions->GetComponent(cellId, 0) ==
+               smpCellRegions->GetComponent(cellId, 0) );
+      }
+    for (vtkIdType i = 0; same && i < pts1->GetNumberOfIds(); ++i)
+      {
+      vtkIdType pt1 = pts1->GetId(i);
+      vtkIdType pt2 = pts2->GetId(i);
+      double x1[3], x2[3];
+      serial->GetPoint(pt1, x1);
+      smp->GetPoint(pt2, x2);
+      same = ( x1[0] == x2[0] && x1[1] == x2[1] && x1[2] == x2[2] &&
+               serialPtRegions->GetComponent(pt1, 0) ==
+               smpPtRegions->GetComponent(pt2, 0) &&
+               serial->GetPointData()->GetArray("Scalars")->GetComponent(
+                 pt1, 0) == smpScalars->GetComponent(pt2, 0) );
+      }
+    if ( !same )
+      {
+      cerr << "Different cell " << cellId << " for " << name << endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+bool SameSizes(vtkIdTypeArray *serial, vtkIdTypeArray *smp,
+               const char *name)
+{
+  if ( serial->GetNumberOfTuples() != smp->GetNumberOfTuples() )
+    {
+    cerr << "Different numbers of regions for " << name << ": "
+         << serial->GetNumberOfTuples() << " and "
+         << smp->GetNumberOfTuples() << endl;
+    return false;
+    }
+  for (vtkIdType i = 0; i < serial->GetNumberOfTuples(); ++i)
+    {
+    if ( serial->GetValue(i) != smp->GetValue(i) )
+      {
+      cerr << "Different size of region " << i << " for " << name << endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+// The extraction modes, with the seeds and regions they use.
+void SetMode(vtkConnectivityFilter *connectivity,
+             vtkPolyDataConnectivityFilter *pdConnectivity, int mode)
+{
+  if ( connectivity )
+    {
+    connectivity->SetExtractionMode(mode);
+    connectivity->InitializeSeedList();
+    connectivity->AddSeed(mode == VTK_EXTRACT_CELL_SEEDED_REGIONS ? 17 : 41);
+    connectivity->AddSeed(mode == VTK_EXTRACT_CELL_SEEDED_REGIONS ? 400 : 703);
+    connectivity->InitializeSpecifiedRegionList();
+    connectivity->AddSpecifiedRegion(0);
+    connectivity->AddSpecifiedRegion(4);
+    connectivity->AddSpecifiedRegion(9);
+    connectivity->SetClosestPoint(3.2, 4.1, 2.0);
+    }
+  else
+    {
+    pdConnectivity->SetExtractionMode(mode);
+    pdConnectivity->InitializeSeedList();
+    pdConnectivity->AddSeed(mode == VTK_EXTRACT_CELL_SEEDED_REGIONS ? 17 : 41);
+    pdConnectivity->AddSeed(mode == VTK_EXTRACT_CELL_SEEDED_REGIONS ? 400 :
+                            703);
+    pdConnectivity->InitializeSpecifiedRegionList();
+    pdConnectivity->AddSpecifiedRegion(0);
+    pdConnectivity->AddSpecifiedRegion(4);
+    pdConnectivity->AddSpecifiedRegion(9);
+    pdConnectivity->SetClosestPoint(3.2, 4.1, 0.0);
+    }
+}
+
+bool CheckConnectivityFilter(vtkDataSet *input, bool scalarConnectivity,
+                             const char *name)
+{
+  for (int mode = VTK_EXTRACT_POINT_SEEDED_REGIONS;
+       mode <= VTK_EXTRACT_CLOSEST_POINT_REGION; ++mode)
+    {
+    vtkSmartPointer<vtkConnectivityFilter> filters[2];
+    for (int smp = 0; smp < 2; ++smp)
+      {
+      filters[smp] = vtkSmartPointer<vtkConnectivityFilter>::New();
+      filters[smp]->SetInputData(input);
+      filters[smp]->SetScalarConnectivity(scalarConnectivity);
+      filters[smp]->SetScalarRange(-1.0, 0.03);
+      filters[smp]->ColorRegionsOn();
+      filters[smp]->SetEnableSMP(smp == 1);
+      SetMode(filters[smp], NULL, mode);
+      filters[smp]->Update();
+      }
+    cout << name << ", " << filters[0]->GetExtractionModeAsString() << ": "
+         << filters[1]->GetNumberOfExtractedRegions() << " region(s), "
+         << filters[1]->GetOutput()->GetNumberOfCells() << " cells" << endl;
+    bool allCells = ( mode != VTK_EXTRACT_LARGEST_REGION &&
+                      mode != VTK_EXTRACT_SPECIFIED_REGIONS );
+    if ( filters[0]->GetNumberOfExtractedRegions() !=
+         filters[1]->GetNumberOfExtractedRegions() )
+      {
+      cerr << "Different numbers of regions for " << name << endl;
+      return false;
+      }
+    if ( !SameOutputs(filters[0]->GetOutput(), filters[1]->GetOutput(),
+                      allCells, mode == VTK_EXTRACT_ALL_REGIONS, name) )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+bool CheckPolyDataConnectivityFilter(vtkPolyData *input,
+                                     bool scalarConnectivity,
+                                     bool fullScalarConnectivity,
+                                     const char *name)
+{
+  for (int mode = VTK_EXTRACT_POINT_SEEDED_REGIONS;
+       mode <= VTK_EXTRACT_CLOSEST_POINT_REGION; ++mode)
+    {
+    vtkSmartPointer<vtkPolyDataConnectivityFilter> filters[2];
+    for (int smp = 0; smp < 2; ++smp)
+      {
+      filters[smp] = vtkSmartPointer<vtkPolyDataConnectivityFilter>::New();
+      filters[smp]->SetInputData(input);
+      filters[smp]->SetScalarConnectivity(scalarConnectivity);
+      filters[smp]->SetFullScalarConnectivity(fullScalarConnectivity);
+      filters[smp]->SetScalarRange(fullScalarConnectivity ? 0.2 : 0.45,
+                                   fullScalarConnectivity ? 0.8 : 0.5);
+      filters[smp]->ColorRegionsOn();
+      filters[smp]->SetEnableSMP(smp == 1);
+      SetMode(NULL, filters[smp], mode);
+      filters[smp]->Update();
+      }
+    cout << name << ", " << filters[0]->GetExtractionModeAsString() << ": "
+         << filters[1]->GetNumberOfExtractedRegions() << " region(s), "
+         << filters[1]->GetOutput()->GetNumberOfCells() << " cells" << endl;
+    bool allCells = ( mode != VTK_EXTRACT_LARGEST_REGION &&
+                      mode != VTK_EXTRACT_SPECIFIED_REGIONS );
+    if ( !SameSizes(filters[0]->GetRegionSizes(),
+                    filters[1]->GetRegionSizes(), name) ||
+         !SameOutputs(filters[0]->GetOutput(), filters[1]->GetOutput(),
+                      allCells, false, name) )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int TestConnectivityFilterSMP(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+  vtkMath::RandomSeed(5297);
+
+  // Voxels, as an image and as an unstructured grid.
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(12, 11, 10);
+  image->GetPointData()->SetScalars(
+    RandomScalars(image->GetNumberOfPoints()));
+  AddCellIds(image);
+  vtkSmartPointer<vtkAppendFilter> append =
+    vtkSmartPointer<vtkAppendFilter>::New();
+  append->AddInputData(image);
+  append->Update();
+  vtkUnstructuredGrid *grid = append->GetOutput();
+
+  if ( !CheckConnectivityFilter(image, false, "image") ||
+       !CheckConnectivityFilter(image, true, "image, scalar connectivity") ||
+       !CheckConnectivityFilter(grid, true, "grid, scalar connectivity") )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Triangles, lines and vertices, with a few separate pieces.
+  const int N = 30;
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  for (int j = 0; j < N; ++j)
+    {
+    for (int i = 0; i < N; ++i)
+      {
+      points->InsertNextPoint(0.2 * i, 0.2 * j, 0.0);
+      }
+    }
+  vtkSmartPointer<vtkCellArray> verts = vtkSmartPointer<vtkCellArray>::New();
+  vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New();
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  for (int j = 0; j + 1 < N; ++j)
+    {
+    for (int i = 0; i + 1 < N; ++i)
+      {
+      vtkIdType p = i + N * j;
+      if ( i % 10 == 9 )
+        {
+        vtkIdType line[2] = { p, p + N };
+        lines->InsertNextCell(2, line);
+        if ( j % 7 == 0 )
+          {
+          verts->InsertNextCell(1, &p);
+          }
+        continue;
+        }
+      vtkIdType tri1[3] = { p, p + 1, p + N + 1 };
+      vtkIdType tri2[3] = { p, p + N + 1, p + N };
+      polys->InsertNextCell(3, tri1);
+      polys->InsertNextCell(3, tri2);
+      }
+    }
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->SetPoints(points);
+  polyData->SetVerts(verts);
+  polyData->SetLines(lines);
+  polyData->SetPolys(polys);
+  polyData->GetPointData()->SetScalars(RandomScalars(N * N));
+  AddCellIds(polyData);
+
+  if ( !CheckPolyDataConnectivityFilter(polyData, false, false,
+                                        "polydata") ||
+       !CheckPolyDataConnectivityFilter(polyData, true, false,
+                                        "polydata, scalar connectivity") ||
+       !CheckPolyDataConnectivityFilter(polyData, true, true,
+                                        "polydata, full scalar connectivity") ||
+       !CheckConnectivityFilter(polyData, true, "polydata as a dataset") )
+    {
+    return EXIT_FAILURE;
+    }
+
+  vtkSmartPointer<vtkPolyData> polyData32 =
+    vtkSmartPointer<vtkPolyData>::New();
+  polyData32->DeepCopy(polyData);
+  polyData32->GetPolys()->SetStorageLayoutToOffsets();
+  polyData32->DeleteCells();
+  polyData32->Squeeze();
+  if ( (sizeof(vtkIdType) > 4 && !polyData32->GetPolys()->IsStorage32Bit()) ||
+       !CheckPolyDataConnectivityFilter(polyData32, true, false,
+                                        "polydata, 32-bit storage") )
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
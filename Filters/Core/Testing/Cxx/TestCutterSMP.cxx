@@ -0,0 +1,216 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCutterSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded execution of vtkCutter (EnableSMP) on an
+// unstructured grid of linear 3D cells, in vtkIdType or 32-bit storage,
+// produces the same triangles as the serial one, without duplicate points,
+// and passes the string arrays.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCleanPolyData.h>
+#include <vtkCutter.h>
+#include <vtkDataArray.h>
+#include <vtkPlane.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphere.h>
+#include <vtkStringArray.h>
+#include <vtkTestCellLattice.h>
+#include <vtkTestDataSetComparison.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cmath>
+
+namespace
+{
+// The serial filter merges the points with a locator, so that the same
+// edge intersection computed by two cells of different types can yield two
+// points whose coordinates differ by a rounding error. The triangles are
+// thus compared through the coordinates and the data of their points.
+bool SameOutputs(vtkPolyData *a, vtkPolyData *b, double tolerance)
+{
+  vtkDataArray *cellIdsA = a->GetCellData()->GetArray("CellIds");
+  vtkDataArray *cellIdsB = b->GetCellData()->GetArray("CellIds");
+  if (a->GetNumberOfPolys() != b->GetNumberOfPolys() ||
+      !cellIdsA || !cellIdsB ||
+      cellIdsA->GetNumberOfTuples() != cellIdsB->GetNumberOfTuples())
+    {
+    return false;
+    }
+  const char *names[3] = { "Scalars", "Vectors", NULL };
+  vtkIdType nptsA, *ptsA, nptsB, *ptsB;
+  vtkCellArray *polysA = a->GetPolys();
+  vtkCellArray *polysB = b->GetPolys();
+  polysA->InitTraversal();
+  polysB->InitTraversal();
+  for (vtkIdType cellId = 0; polysA->GetNextCell(nptsA, ptsA); ++cellId)
+    {
+    polysB->GetNextCell(nptsB, ptsB);
+    if (nptsA != nptsB ||
+        cellIdsA->GetTuple1(cellId) != cellIdsB->GetTuple1(cellId))
+      {
+      return false;
+      }
+    for (vtkIdType i = 0; i < nptsA; ++i)
+      {
+      if (!vtkTest::SameTuples(a->GetPoints()->GetData(), ptsA[i],
+                               b->GetPoints()->GetData(), ptsB[i],
+                               tolerance))
+        {
+        return false;
+        }
+      for (int n = 0; names[n]; ++n)
+        {
+        if (!vtkTest::SameTuples(a->GetPointData()->GetArray(names[n]),
+                                 ptsA[i],
+                                 b->GetPointData()->GetArray(names[n]),
+                                 ptsB[i], tolerance))
+          {
+          return false;
+          }
+        }
+      if (!vtkTest::SameTuples(a->GetPointData()->GetScalars(), ptsA[i],
+                               b->GetPointData()->GetScalars(), ptsB[i],
+                               tolerance))
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+}
+
+int TestCutterSMP(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+
+  // Linear 3D cells, and vertices, poly-vertices and empty cells.
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkTest::CreateCellLattice(9, vtkTest::LatticePointCells);
+  // The same cells in 32-bit storage.
+  vtkSmartPointer<vtkUnstructuredGrid> grid32 =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid32->DeepCopy(grid);
+  grid32->GetCells()->SetStorageLayoutToOffsets();
+  grid32->Squeeze();
+
+  // A sphere in general position, and a plane through grid points.
+  vtkSmartPointer<vtkSphere> sphere = vtkSmartPointer<vtkSphere>::New();
+  sphere->SetCenter(3.7, 4.13, 3.9);
+  vtkSmartPointer<vtkPlane> plane = vtkSmartPointer<vtkPlane>::New();
+  plane->SetOrigin(0.0, 0.0, 0.0);
+  plane->SetNormal(0.0, 0.0, 1.0);
+
+  vtkSmartPointer<vtkCutter> serial = vtkSmartPointer<vtkCutter>::New();
+  vtkSmartPointer<vtkCutter> threaded = vtkSmartPointer<vtkCutter>::New();
+  threaded->EnableSMPOn();
+  vtkSmartPointer<vtkCleanPolyData> clean =
+    vtkSmartPointer<vtkCleanPolyData>::New();
+  clean->ToleranceIsAbsoluteOn();
+  clean->SetAbsoluteTolerance(1.0e-5);
+  clean->ConvertPolysToLinesOff();
+
+  for (int option = 0; option < 16; ++option)
+    {
+    vtkCutter *filters[2] = { serial, threaded };
+    for (int f = 0; f < 2; ++f)
+      {
+      filters[f]->SetInputData((option & 8) ? grid32 : grid);
+      filters[f]->SetGenerateCutScalars((option & 4) != 0);
+      if (option & 1)
+        {
+        filters[f]->SetCutFunction(plane);
+        filters[f]->GenerateValues(3, 2.0, 6.0);
+        }
+      else
+        {
+        filters[f]->SetCutFunction(sphere);
+        filters[f]->SetNumberOfContours(2);
+        filters[f]->SetValue(0, 2.3 * 2.3);
+        filters[f]->SetValue(1, 3.1 * 3.1);
+        }
+      filters[f]->SetOutputPointsPrecision((option & 2) ?
+        vtkAlgorithm::DOUBLE_PRECISION : vtkAlgorithm::DEFAULT_PRECISION);
+      filters[f]->Update();
+      }
+    if (serial->GetOutput()->GetNumberOfPolys() == 0 ||
+        !SameOutputs(serial->GetOutput(), threaded->GetOutput(), 1.0e-5))
+      {
+      cerr << "Different outputs with options " << option << endl;
+      return EXIT_FAILURE;
+      }
+
+    // The threaded filter merges the points by edge, leaving no duplicate.
+    clean->SetInputData(serial->GetOutput());
+    clean->Update();
+    if (clean->GetOutput()->GetNumberOfPoints() !=
+        threaded->GetOutput()->GetNumberOfPoints())
+      {
+      cerr << "Unexpected number of points ("
+           << threaded->GetOutput()->GetNumberOfPoints() << " instead of "
+           << clean->GetOutput()->GetNumberOfPoints() << ") with options "
+           << option << endl;
+      return EXIT_FAILURE;
+      }
+
+    // Sorted by cell, the triangles of each contour value come together.
+    vtkIdType numPts = threaded->GetOutput()->GetNumberOfPoints();
+    vtkIdType numPolys = threaded->GetOutput()->GetNumberOfPolys();
+    for (int f = 0; f < 2; ++f)
+      {
+      filters[f]->SetSortByToSortByCell();
+      filters[f]->Update();
+      }
+    vtkDataArray *values = threaded->GetOutput()->GetPointData()->GetScalars();
+    if (!SameOutputs(serial->GetOutput(), threaded->GetOutput(), 1.0e-5) ||
+        threaded->GetOutput()->GetNumberOfPoints() != numPts ||
+        threaded->GetOutput()->GetNumberOfPolys() != numPolys ||
+        ((option & 4) &&
+         fabs(values->GetTuple1(0) - threaded->GetValue(0)) > 1.0e-6))
+      {
+      cerr << "Different outputs sorted by cell with options " << option
+           << endl;
+      return EXIT_FAILURE;
+      }
+    for (int f = 0; f < 2; ++f)
+      {
+      filters[f]->SetSortByToSortByValue();
+      }
+    }
+
+  vtkSmartPointer<vtkStringArray> labels =
+    vtkSmartPointer<vtkStringArray>::New();
+  labels->SetName("Labels");
+  for (vtkIdType i = 0; i < grid->GetNumberOfCells(); ++i)
+    {
+    labels->InsertNextValue(i % 2 ? "odd" : "even");
+    }
+  grid->GetCellData()->AddArray(labels);
+  threaded->SetInputData(grid);
+  threaded->Update();
+  vtkStringArray *outLabels = vtkStringArray::SafeDownCast(
+    threaded->GetOutput()->GetCellData()->GetAbstractArray("Labels"));
+  if (!outLabels || outLabels->GetNumberOfValues() !=
+        threaded->GetOutput()->GetNumberOfCells())
+    {
+    cerr << "String array not passed" << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
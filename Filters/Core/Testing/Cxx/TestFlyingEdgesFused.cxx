@@ -0,0 +1,142 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestFlyingEdgesFused.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkFlyingEdges3D produces the same output when processing all
+// the contour values together (FuseContours) as when processing them one at
+// a time, and that the contour indices match the contour values.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFlyingEdges3D.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkIntArray.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkTestDataSetComparison.h>
+
+#include <cmath>
+
+namespace
+{
+// A volume whose scalars, of the given type, are a sum of waves, with a
+// second point data array to interpolate.
+vtkSmartPointer<vtkImageData> CreateVolume(int dataType)
+{
+  vtkSmartPointer<vtkImageData> volume = vtkSmartPointer<vtkImageData>::New();
+  volume->SetExtent(-3, 36, 2, 33, 0, 27);
+  volume->SetOrigin(0.5, -1.0, 2.0);
+  volume->SetSpacing(0.3, 0.25, 0.4);
+
+  vtkSmartPointer<vtkDataArray> scalars;
+  scalars.TakeReference(vtkDataArray::CreateDataArray(dataType));
+  scalars->SetName("Scalars");
+  vtkSmartPointer<vtkFloatArray> extra = vtkSmartPointer<vtkFloatArray>::New();
+  extra->SetName("Extra");
+  vtkIdType numPts = volume->GetNumberOfPoints();
+  scalars->SetNumberOfTuples(numPts);
+  extra->SetNumberOfTuples(numPts);
+  double x[3];
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    volume->GetPoint(i, x);
+    scalars->SetTuple1(i, sin(0.8 * x[0]) * cos(0.6 * x[1]) + 0.15 * x[2]);
+    extra->SetValue(i, static_cast<float>(x[0] * x[1]));
+    }
+  volume->GetPointData()->SetScalars(scalars);
+  volume->GetPointData()->AddArray(extra);
+  return volume;
+}
+
+// Check that the points of each triangle have the scalar of its contour.
+bool CheckContourIndices(vtkFlyingEdges3D *contour)
+{
+  vtkPolyData *output = contour->GetOutput();
+  vtkDataArray *indices = output->GetCellData()->GetArray("ContourIndex");
+  vtkDataArray *scalars = output->GetPointData()->GetScalars();
+  if (!indices || indices->GetNumberOfTuples() != output->GetNumberOfPolys())
+    {
+    return false;
+    }
+  vtkIdType npts, *pts;
+  vtkCellArray *polys = output->GetPolys();
+  polys->InitTraversal();
+  for (vtkIdType cellId = 0; polys->GetNextCell(npts, pts); ++cellId)
+    {
+    double value = contour->GetValue(static_cast<int>(
+      indices->GetTuple1(cellId)));
+    for (vtkIdType i = 0; i < npts; ++i)
+      {
+      if (fabs(scalars->GetTuple1(pts[i]) - value) > 1.0e-6)
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+}
+
+int TestFlyingEdgesFused(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+
+  vtkSmartPointer<vtkFlyingEdges3D> separate =
+    vtkSmartPointer<vtkFlyingEdges3D>::New();
+  vtkSmartPointer<vtkFlyingEdges3D> fused =
+    vtkSmartPointer<vtkFlyingEdges3D>::New();
+  fused->FuseContoursOn();
+
+  // Unsorted contour values, including a repeated one and one out of range.
+  double values[6] = { 0.9, -0.4, 2.5, 0.1, 10.0, 0.9 };
+
+  for (int option = 0; option < 8; ++option)
+    {
+    vtkSmartPointer<vtkImageData> volume =
+      CreateVolume((option & 1) ? VTK_DOUBLE : VTK_FLOAT);
+    vtkFlyingEdges3D *filters[2] = { separate, fused };
+    for (int f = 0; f < 2; ++f)
+      {
+      filters[f]->SetInputData(volume);
+      filters[f]->SetNumberOfContours((option & 4) ? 1 : 6);
+      for (int i = 0; i < filters[f]->GetNumberOfContours(); ++i)
+        {
+        filters[f]->SetValue(i, values[i]);
+        }
+      filters[f]->SetComputeNormals((option & 2) != 0);
+      filters[f]->SetComputeGradients((option & 2) != 0);
+      filters[f]->SetInterpolateAttributes((option & 2) == 0);
+      filters[f]->ComputeContourIndicesOn();
+      filters[f]->Update();
+      }
+    if (separate->GetOutput()->GetNumberOfPolys() == 0 ||
+        !vtkTest::SameOutputs(separate->GetOutput(), fused->GetOutput()))
+      {
+      cerr << "Different outputs with options " << option << endl;
+      return EXIT_FAILURE;
+      }
+    if (!CheckContourIndices(fused))
+      {
+      cerr << "Wrong contour indices with options " << option << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
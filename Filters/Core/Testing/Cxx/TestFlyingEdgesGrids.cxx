@@ -0,0 +1,240 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestFlyingEdgesGrids.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check vtkFlyingEdges3D on structured and rectilinear grids: grids having
+// the points of an image produce the output of the image, and the
+// isosurfaces of a linear field on a skewed grid are planes with the
+// gradient of the field, keeping the double precision of the grid points,
+// and the normals on a collapsed grid fall back to index space.
+
+#include <vtkCellArray.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFlyingEdges3D.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkRectilinearGrid.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkStructuredGrid.h>
+#include <vtkTestDataSetComparison.h>
+
+#include <cmath>
+
+namespace
+{
+const int Extent[6] = { -2, 21, 0, 19, 3, 20 };
+
+double Field(const double x[3])
+{
+  return sin(x[0]) * cos(0.8 * x[1]) + 0.2 * x[2];
+}
+
+// Set the scalars (computed from the points) and an extra array.
+void SetPointData(vtkDataSet *dataSet)
+{
+  vtkSmartPointer<vtkDoubleArray> scalars =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  scalars->SetName("Scalars");
+  vtkSmartPointer<vtkFloatArray> extra = vtkSmartPointer<vtkFloatArray>::New();
+  extra->SetName("Extra");
+  double x[3];
+  for (vtkIdType i = 0; i < dataSet->GetNumberOfPoints(); ++i)
+    {
+    dataSet->GetPoint(i, x);
+    scalars->InsertNextValue(Field(x));
+    extra->InsertNextValue(static_cast<float>(x[0] + x[1] * x[2]));
+    }
+  dataSet->GetPointData()->SetScalars(scalars);
+  dataSet->GetPointData()->AddArray(extra);
+}
+
+vtkSmartPointer<vtkPolyData> Contour(vtkDataSet *input, bool fuse)
+{
+  vtkSmartPointer<vtkFlyingEdges3D> contour =
+    vtkSmartPointer<vtkFlyingEdges3D>::New();
+  contour->SetInputData(input);
+  contour->GenerateValues(4, -0.5, 3.5);
+  contour->ComputeNormalsOn();
+  contour->ComputeGradientsOn();
+  contour->InterpolateAttributesOn();
+  contour->SetFuseContours(fuse);
+  contour->Update();
+  return contour->GetOutput();
+}
+}
+
+int TestFlyingEdgesGrids(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+
+  // An image, and grids with the same points.
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(const_cast<int*>(Extent));
+  image->SetOrigin(0.5, -1.0, 2.0);
+  image->SetSpacing(0.5, 0.375, 0.25);
+  SetPointData(image);
+
+  vtkSmartPointer<vtkRectilinearGrid> rectGrid =
+    vtkSmartPointer<vtkRectilinearGrid>::New();
+  rectGrid->SetExtent(const_cast<int*>(Extent));
+  vtkSmartPointer<vtkDoubleArray> coordinates[3];
+  for (int i = 0; i < 3; ++i)
+    {
+    coordinates[i] = vtkSmartPointer<vtkDoubleArray>::New();
+    for (int j = Extent[2 * i]; j <= Extent[2 * i + 1]; ++j)
+      {
+      coordinates[i]->InsertNextValue(image->GetOrigin()[i] +
+                                      j * image->GetSpacing()[i]);
+      }
+    }
+  rectGrid->SetXCoordinates(coordinates[0]);
+  rectGrid->SetYCoordinates(coordinates[1]);
+  rectGrid->SetZCoordinates(coordinates[2]);
+  SetPointData(rectGrid);
+
+  vtkSmartPointer<vtkStructuredGrid> grid =
+    vtkSmartPointer<vtkStructuredGrid>::New();
+  grid->SetExtent(const_cast<int*>(Extent));
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    points->InsertNextPoint(image->GetPoint(i));
+    }
+  grid->SetPoints(points);
+  SetPointData(grid);
+
+  for (int fuse = 0; fuse < 2; ++fuse)
+    {
+    vtkSmartPointer<vtkPolyData> reference = Contour(image, fuse != 0);
+    if (reference->GetNumberOfPolys() == 0 ||
+        !reference->GetPointData()->GetArray("Normals") ||
+        !reference->GetPointData()->GetArray("Gradients") ||
+        !vtkTest::SameOutputs(reference, Contour(rectGrid, fuse != 0),
+                              1.0e-4) ||
+        !vtkTest::SameOutputs(reference, Contour(grid, fuse != 0), 1.0e-4))
+      {
+      cerr << "Grid outputs differ from the image output" << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // The same grid collapsed on a plane: the Jacobian is singular, the
+  // normals are computed in index space.
+  vtkSmartPointer<vtkStructuredGrid> flat =
+    vtkSmartPointer<vtkStructuredGrid>::New();
+  flat->SetExtent(const_cast<int*>(Extent));
+  vtkSmartPointer<vtkPoints> flatPoints = vtkSmartPointer<vtkPoints>::New();
+  flatPoints->SetDataTypeToDouble();
+  for (vtkIdType i = 0; i < grid->GetNumberOfPoints(); ++i)
+    {
+    double x[3];
+    grid->GetPoint(i, x);
+    flatPoints->InsertNextPoint(x[0], x[1], 2.0);
+    }
+  flat->SetPoints(flatPoints);
+  flat->GetPointData()->ShallowCopy(grid->GetPointData());
+  vtkSmartPointer<vtkPolyData> flatOutput = Contour(flat, false);
+  vtkDataArray *flatNormals = flatOutput->GetPointData()->GetArray("Normals");
+  if (flatOutput->GetNumberOfPolys() == 0 || !flatNormals)
+    {
+    cerr << "No isosurface on the collapsed grid" << endl;
+    return EXIT_FAILURE;
+    }
+  for (vtkIdType i = 0; i < flatOutput->GetNumberOfPoints(); ++i)
+    {
+    double n[3];
+    flatNormals->GetTuple(i, n);
+    if (fabs(vtkMath::Norm(n) - 1.0) > 1.0e-5)
+      {
+      cerr << "Zero normal " << i << " on the collapsed grid" << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // A skewed grid far from the origin, and a linear field whose gradient
+  // is c.
+  const double c[3] = { 0.3, -1.2, 0.7 };
+  const double offset = 1.0e4;
+  double normal[3] = { -c[0], -c[1], -c[2] };
+  vtkMath::Normalize(normal);
+  vtkSmartPointer<vtkStructuredGrid> skewed =
+    vtkSmartPointer<vtkStructuredGrid>::New();
+  skewed->SetExtent(const_cast<int*>(Extent));
+  vtkSmartPointer<vtkPoints> skewedPoints = vtkSmartPointer<vtkPoints>::New();
+  skewedPoints->SetDataTypeToDouble();
+  vtkSmartPointer<vtkDoubleArray> linear =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  linear->SetName("Scalars");
+  for (int k = Extent[4]; k <= Extent[5]; ++k)
+    {
+    for (int j = Extent[2]; j <= Extent[3]; ++j)
+      {
+      for (int i = Extent[0]; i <= Extent[1]; ++i)
+        {
+        double x[3] = { offset + 0.4 * i + 0.1 * j,
+                        -0.2 * i + 0.3 * j + 0.05 * k, 0.1 * i + 0.35 * k };
+        skewedPoints->InsertNextPoint(x);
+        linear->InsertNextValue(vtkMath::Dot(c, x) - c[0] * offset);
+        }
+      }
+    }
+  skewed->SetPoints(skewedPoints);
+  skewed->GetPointData()->SetScalars(linear);
+
+  vtkSmartPointer<vtkFlyingEdges3D> contour =
+    vtkSmartPointer<vtkFlyingEdges3D>::New();
+  contour->SetInputData(skewed);
+  contour->GenerateValues(5, -2.0, 2.0);
+  contour->ComputeNormalsOn();
+  contour->ComputeGradientsOn();
+  contour->Update();
+  vtkPolyData *output = contour->GetOutput();
+  vtkDataArray *normals = output->GetPointData()->GetArray("Normals");
+  vtkDataArray *gradients = output->GetPointData()->GetArray("Gradients");
+  vtkDataArray *scalars = output->GetPointData()->GetScalars();
+  if (output->GetNumberOfPolys() == 0 || !normals || !gradients)
+    {
+    cerr << "No isosurface on the skewed grid" << endl;
+    return EXIT_FAILURE;
+    }
+  if (output->GetPoints()->GetDataType() != VTK_DOUBLE)
+    {
+    cerr << "Float points from the double skewed grid" << endl;
+    return EXIT_FAILURE;
+    }
+  double x[3], n[3], g[3];
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+    {
+    output->GetPoint(i, x);
+    normals->GetTuple(i, n);
+    gradients->GetTuple(i, g);
+    if (fabs(vtkMath::Dot(c, x) - c[0] * offset - scalars->GetTuple1(i)) >
+          1.0e-8 ||
+        fabs(n[0] - normal[0]) > 1.0e-5 || fabs(n[1] - normal[1]) > 1.0e-5 ||
+        fabs(n[2] - normal[2]) > 1.0e-5 || fabs(g[0] - c[0]) > 1.0e-5 ||
+        fabs(g[1] - c[1]) > 1.0e-5 || fabs(g[2] - c[2]) > 1.0e-5)
+      {
+      cerr << "Wrong point " << i << " on the skewed grid" << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,144 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPolyDataNormals.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded execution of vtkPolyDataNormals (EnableSMP)
+// produces the same output as the serial one.
+
+#include <vtkCellArray.h>
+#include <vtkFloatArray.h>
+#include <vtkMinimalStandardRandomSequence.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkTestDataSetComparison.h>
+
+#include <algorithm>
+
+namespace
+{
+// A bumpy sphere with polygons of inconsistent ordering, a non-manifold
+// fin, a triangle strip and a point scalar array.
+vtkSmartPointer<vtkPolyData> CreateMesh()
+{
+  vtkSmartPointer<vtkSphereSource> sphere =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetThetaResolution(40);
+  sphere->SetPhiResolution(30);
+  sphere->Update();
+
+  vtkSmartPointer<vtkPolyData> mesh = vtkSmartPointer<vtkPolyData>::New();
+  mesh->DeepCopy(sphere->GetOutput());
+
+  vtkSmartPointer<vtkMinimalStandardRandomSequence> random =
+    vtkSmartPointer<vtkMinimalStandardRandomSequence>::New();
+  random->SetSeed(1);
+  vtkPoints *points = mesh->GetPoints();
+  double x[3];
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+    {
+    points->GetPoint(i, x);
+    random->Next();
+    double scale = 1.0 + 0.1 * random->GetValue();
+    points->SetPoint(i, scale * x[0], scale * x[1], scale * x[2]);
+    }
+
+  vtkCellArray *polys = mesh->GetPolys();
+  vtkIdType npts, *pts;
+  vtkIdType cellId = 0;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts); ++cellId)
+    {
+    if (cellId % 7 == 0)
+      {
+      std::swap(pts[0], pts[npts - 1]);
+      }
+    }
+
+  vtkIdType fin[3];
+  polys->InitTraversal();
+  polys->GetNextCell(npts, pts);
+  fin[0] = pts[0];
+  fin[1] = pts[1];
+  fin[2] = points->InsertNextPoint(2.0, 0.0, 0.0);
+  polys->InsertNextCell(3, fin);
+
+  vtkSmartPointer<vtkCellArray> strips = vtkSmartPointer<vtkCellArray>::New();
+  strips->InsertNextCell(5);
+  for (int i = 0; i < 5; ++i)
+    {
+    strips->InsertCellPoint(points->InsertNextPoint(
+      3.0 + 0.5 * (i / 2), (i % 2), 0.1 * i * i));
+    }
+  mesh->SetStrips(strips);
+
+  vtkSmartPointer<vtkFloatArray> scalars =
+    vtkSmartPointer<vtkFloatArray>::New();
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(points->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+    {
+    scalars->SetValue(i, static_cast<float>(i));
+    }
+  mesh->GetPointData()->SetScalars(scalars);
+  return mesh;
+}
+}
+
+int TestPolyDataNormals(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+
+  vtkSmartPointer<vtkPolyData> mesh = CreateMesh();
+  vtkSmartPointer<vtkPolyData> mesh32 = vtkSmartPointer<vtkPolyData>::New();
+  mesh32->DeepCopy(mesh);
+  mesh32->SetStrips(NULL);
+  mesh32->GetPolys()->ConvertTo32BitStorage(mesh32->GetNumberOfPoints());
+
+  vtkSmartPointer<vtkPolyDataNormals> serial =
+    vtkSmartPointer<vtkPolyDataNormals>::New();
+  vtkSmartPointer<vtkPolyDataNormals> threaded =
+    vtkSmartPointer<vtkPolyDataNormals>::New();
+  threaded->EnableSMPOn();
+
+  for (int option = 0; option < 64; ++option)
+    {
+    vtkPolyDataNormals *filters[2] = { serial, threaded };
+    for (int f = 0; f < 2; ++f)
+      {
+      filters[f]->SetInputData((option & 32) ? mesh32 : mesh);
+      filters[f]->SetSplitting(option & 1);
+      filters[f]->SetConsistency((option & 2) != 0);
+      filters[f]->SetAutoOrientNormals((option & 4) != 0);
+      filters[f]->SetFlipNormals((option & 8) != 0);
+      filters[f]->SetComputeCellNormals((option & 16) != 0);
+      filters[f]->SetFeatureAngle(option % 3 ? 20.0 : 60.0);
+      filters[f]->Update();
+      }
+    if (!vtkTest::SameOutputs(serial->GetOutput(), threaded->GetOutput()))
+      {
+      cerr << "Different outputs with options " << option << endl;
+      return EXIT_FAILURE;
+      }
+    if ((option & 1) && serial->GetOutput()->GetNumberOfPoints() <=
+        mesh->GetNumberOfPoints())
+      {
+      cerr << "No point split with options " << option << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,264 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestProbeFilterSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded execution of vtkProbeFilter (EnableSMP) produces
+// the output of the serial one: the interpolated point data, the copied
+// cell data, the valid point mask and the valid points, for image and point
+// set inputs probing unstructured grids and polydata (with cells in
+// vtkIdType and 32-bit storage), structured grids and images, with and
+// without a computed tolerance, and for composite sources.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCompositeDataProbeFilter.h>
+#include <vtkDataArray.h>
+#include <vtkDataSetSurfaceFilter.h>
+#include <vtkDataSetTriangleFilter.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkIntArray.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkProbeFilter.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkStructuredGrid.h>
+#include <vtkTestDataSetComparison.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cmath>
+
+namespace
+{
+// Add point data (double vectors, float and integer scalars) and cell data
+// (integer ids and a float array) to a source.
+void AddArrays(vtkDataSet *source)
+{
+  vtkSmartPointer<vtkDoubleArray> vectors =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vtkSmartPointer<vtkFloatArray> values = vtkSmartPointer<vtkFloatArray>::New();
+  values->SetName("Values");
+  vtkSmartPointer<vtkIntArray> labels = vtkSmartPointer<vtkIntArray>::New();
+  labels->SetName("Labels");
+  double x[3];
+  for (vtkIdType i = 0; i < source->GetNumberOfPoints(); ++i)
+    {
+    source->GetPoint(i, x);
+    vectors->InsertNextTuple3(sin(x[0]), x[1] * x[2], cos(x[2]));
+    values->InsertNextValue(static_cast<float>(x[0] - 2.0 * x[1]));
+    labels->InsertNextValue(static_cast<int>(i % 13) - 6);
+    }
+  source->GetPointData()->SetVectors(vectors);
+  source->GetPointData()->SetScalars(values);
+  source->GetPointData()->AddArray(labels);
+
+  vtkSmartPointer<vtkIdTypeArray> cellIds =
+    vtkSmartPointer<vtkIdTypeArray>::New();
+  cellIds->SetName("CellIds");
+  vtkSmartPointer<vtkFloatArray> cellValues =
+    vtkSmartPointer<vtkFloatArray>::New();
+  cellValues->SetName("CellValues");
+  for (vtkIdType i = 0; i < source->GetNumberOfCells(); ++i)
+    {
+    cellIds->InsertNextValue(i);
+    cellValues->InsertNextValue(0.5f * static_cast<float>(i % 7));
+    }
+  source->GetCellData()->AddArray(cellIds);
+  source->GetCellData()->AddArray(cellValues);
+}
+
+// Probe a source with and without threads, and compare the outputs.
+bool CheckProbe(vtkProbeFilter *serial, vtkProbeFilter *threaded,
+                vtkDataSet *input, vtkDataObject *source, const char *name)
+{
+  const char *arrays[6] = { "Vectors", "Values", "Labels", "CellIds",
+                            "CellValues", "vtkValidPointMask" };
+  for (int option = 0; option < 2; ++option)
+    {
+    vtkProbeFilter *filters[2] = { serial, threaded };
+    for (int f = 0; f < 2; ++f)
+      {
+      filters[f]->SetInputData(input);
+      filters[f]->SetSourceData(source);
+      filters[f]->SetComputeTolerance(option == 0);
+      filters[f]->SetTolerance(0.05);
+      filters[f]->SetEnableSMP(f == 1);
+      filters[f]->Update();
+      }
+    vtkPointData *serialPD =
+      vtkDataSet::SafeDownCast(serial->GetOutputDataObject(0))->GetPointData();
+    vtkPointData *threadedPD =
+      vtkDataSet::SafeDownCast(threaded->GetOutputDataObject(0))->GetPointData();
+    vtkDataArray *mask = serialPD->GetArray("vtkValidPointMask");
+    if (!mask || serial->GetValidPoints()->GetNumberOfTuples() == 0 ||
+        serial->GetValidPoints()->GetNumberOfTuples() ==
+        mask->GetNumberOfTuples())
+      {
+      cerr << "The " << name << " should be partly probed" << endl;
+      return false;
+      }
+    for (int i = 0; i < 6; ++i)
+      {
+      if (!serialPD->GetArray(arrays[i]) ||
+          !vtkTest::SameArrays(serialPD->GetArray(arrays[i]),
+                               threadedPD->GetArray(arrays[i])))
+        {
+        cerr << "Different " << arrays[i] << " for the " << name
+             << " with options " << option << endl;
+        return false;
+        }
+      }
+    if (!vtkTest::SameArrays(serial->GetValidPoints(),
+                             threaded->GetValidPoints()))
+      {
+      cerr << "Different valid points for the " << name << " with options "
+           << option << endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int TestProbeFilterSMP(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+
+  // Sources: tetrahedra, their boundary triangles, a skewed structured grid
+  // and an image.
+  vtkSmartPointer<vtkImageData> tetImage =
+    vtkSmartPointer<vtkImageData>::New();
+  tetImage->SetDimensions(9, 8, 10);
+  tetImage->SetSpacing(0.5, 0.4, 0.3);
+  vtkSmartPointer<vtkDataSetTriangleFilter> tetrahedralize =
+    vtkSmartPointer<vtkDataSetTriangleFilter>::New();
+  tetrahedralize->SetInputData(tetImage);
+  tetrahedralize->Update();
+  vtkSmartPointer<vtkUnstructuredGrid> tets =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  tets->DeepCopy(tetrahedralize->GetOutput());
+  AddArrays(tets);
+
+  vtkSmartPointer<vtkDataSetSurfaceFilter> surface =
+    vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
+  surface->SetInputData(tets);
+  surface->Update();
+  vtkSmartPointer<vtkPolyData> triangles = vtkSmartPointer<vtkPolyData>::New();
+  triangles->DeepCopy(surface->GetOutput());
+  AddArrays(triangles);
+
+  vtkSmartPointer<vtkStructuredGrid> sGrid =
+    vtkSmartPointer<vtkStructuredGrid>::New();
+  sGrid->SetDimensions(10, 9, 8);
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  for (int k = 0; k < 8; ++k)
+    {
+    for (int j = 0; j < 9; ++j)
+      {
+      for (int i = 0; i < 10; ++i)
+        {
+        points->InsertNextPoint(0.4 * i + 0.05 * j, 0.35 * j + 0.02 * k,
+                                0.3 * k + 0.03 * i);
+        }
+      }
+    }
+  sGrid->SetPoints(points);
+  AddArrays(sGrid);
+
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(0, 8, 1, 9, 0, 7);
+  image->SetSpacing(0.45, 0.3, 0.35);
+  AddArrays(image);
+
+  // The tetrahedra and triangles with cells in 32-bit storage.
+  vtkSmartPointer<vtkUnstructuredGrid> tets32 =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  tets32->DeepCopy(tets);
+  tets32->GetCells()->SetStorageLayoutToOffsets();
+  tets32->Squeeze();
+  vtkSmartPointer<vtkPolyData> triangles32 =
+    vtkSmartPointer<vtkPolyData>::New();
+  triangles32->DeepCopy(triangles);
+  triangles32->GetPolys()->SetStorageLayoutToOffsets();
+  triangles32->DeleteCells();
+  triangles32->Squeeze();
+
+  // Inputs: an image and scattered points, both extending past the sources.
+  vtkSmartPointer<vtkImageData> volume = vtkSmartPointer<vtkImageData>::New();
+  volume->SetExtent(-2, 30, -1, 25, -3, 22);
+  volume->SetOrigin(0.01, 0.02, 0.015);
+  volume->SetSpacing(0.15, 0.14, 0.13);
+
+  vtkSmartPointer<vtkPolyData> scattered = vtkSmartPointer<vtkPolyData>::New();
+  vtkSmartPointer<vtkPoints> scatteredPoints =
+    vtkSmartPointer<vtkPoints>::New();
+  for (int i = 0; i < 20000; ++i)
+    {
+    scatteredPoints->InsertNextPoint(-0.3 + 5.0 * fabs(sin(0.37 * i)),
+                                     -0.2 + 3.8 * fabs(cos(0.71 * i)),
+                                     -0.4 + 3.3 * fabs(sin(1.13 * i + 0.5)));
+    }
+  scattered->SetPoints(scatteredPoints);
+
+  vtkSmartPointer<vtkProbeFilter> serial =
+    vtkSmartPointer<vtkProbeFilter>::New();
+  vtkSmartPointer<vtkProbeFilter> threaded =
+    vtkSmartPointer<vtkProbeFilter>::New();
+  vtkDataSet *sources[6] = { tets, triangles, sGrid, image, tets32,
+                             triangles32 };
+  const char *names[6] = { "tetrahedra", "triangles", "structured grid",
+                           "image", "32-bit tetrahedra", "32-bit triangles" };
+  // Only the volumetric sources contain points of the volume.
+  const bool volumetric[6] = { true, false, true, true, true, false };
+  for (int i = 0; i < 6; ++i)
+    {
+    if ((volumetric[i] && !CheckProbe(serial, threaded, volume, sources[i],
+                                      names[i])) ||
+        !CheckProbe(serial, threaded, scattered, sources[i], names[i]))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Composite sources, with partial arrays or not.
+  vtkSmartPointer<vtkMultiBlockDataSet> blocks =
+    vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  blocks->SetNumberOfBlocks(2);
+  blocks->SetBlock(0, tets);
+  blocks->SetBlock(1, sGrid);
+  vtkSmartPointer<vtkCompositeDataProbeFilter> serialComposite =
+    vtkSmartPointer<vtkCompositeDataProbeFilter>::New();
+  vtkSmartPointer<vtkCompositeDataProbeFilter> threadedComposite =
+    vtkSmartPointer<vtkCompositeDataProbeFilter>::New();
+  for (int partial = 0; partial < 2; ++partial)
+    {
+    serialComposite->SetPassPartialArrays(partial != 0);
+    threadedComposite->SetPassPartialArrays(partial != 0);
+    if (!CheckProbe(serialComposite, threadedComposite, volume, blocks,
+                    "composite source") ||
+        !CheckProbe(serialComposite, threadedComposite, scattered, blocks,
+                    "composite source"))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,163 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestThresholdSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded execution of vtkThreshold (EnableSMP) produces
+// the same output as the serial one, points and cells in the same order,
+// for all the kinds of cells including polyhedra, with string arrays and
+// with cells in 32-bit storage.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDoubleArray.h>
+#include <vtkIntArray.h>
+#include <vtkPointData.h>
+#include <vtkRTAnalyticSource.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
+#include <vtkTestCellLattice.h>
+#include <vtkTestDataSetComparison.h>
+#include <vtkThreshold.h>
+#include <vtkUnstructuredGrid.h>
+
+namespace
+{
+// The shared lattice of all the kinds of cells, with scattered cell
+// scalars, global ids and a string array.
+vtkSmartPointer<vtkUnstructuredGrid> CreateGrid()
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkTest::CreateCellLattice(8, vtkTest::LatticeAllCells);
+  vtkSmartPointer<vtkIntArray> globalIds = vtkSmartPointer<vtkIntArray>::New();
+  globalIds->SetName("GlobalIds");
+  vtkSmartPointer<vtkStringArray> labels =
+    vtkSmartPointer<vtkStringArray>::New();
+  labels->SetName("Labels");
+  for (vtkIdType i = 0; i < grid->GetNumberOfPoints(); ++i)
+    {
+    globalIds->InsertNextValue(static_cast<int>(i));
+    labels->InsertNextValue(i % 3 ? "inner" : "outer");
+    }
+  grid->GetPointData()->SetGlobalIds(globalIds);
+  grid->GetPointData()->AddArray(labels);
+  vtkSmartPointer<vtkDoubleArray> cellScalars =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  cellScalars->SetName("CellScalars");
+  for (vtkIdType i = 0; i < grid->GetNumberOfCells(); ++i)
+    {
+    cellScalars->InsertNextValue(i % 13);
+    }
+  grid->GetCellData()->AddArray(cellScalars);
+  return grid;
+}
+
+// Compare the outputs, including the precision of their points.
+bool SameOutputs(vtkUnstructuredGrid *a, vtkUnstructuredGrid *b)
+{
+  if (!a->GetPoints() || !b->GetPoints())
+    {
+    return a->GetPoints() == b->GetPoints() && vtkTest::SameOutputs(a, b);
+    }
+  return a->GetPoints()->GetDataType() == b->GetPoints()->GetDataType() &&
+    vtkTest::SameOutputs(a, b);
+}
+}
+
+int TestThresholdSMP(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+
+  vtkSmartPointer<vtkUnstructuredGrid> grid = CreateGrid();
+  vtkSmartPointer<vtkRTAnalyticSource> image =
+    vtkSmartPointer<vtkRTAnalyticSource>::New();
+  image->SetWholeExtent(-5, 5, -5, 5, -5, 5);
+
+  vtkSmartPointer<vtkThreshold> serial = vtkSmartPointer<vtkThreshold>::New();
+  vtkSmartPointer<vtkThreshold> threaded =
+    vtkSmartPointer<vtkThreshold>::New();
+  threaded->EnableSMPOn();
+
+  for (int option = 0; option < 24; ++option)
+    {
+    vtkThreshold *filters[2] = { serial, threaded };
+    for (int f = 0; f < 2; ++f)
+      {
+      if (option & 16)
+        {
+        filters[f]->SetInputConnection(image->GetOutputPort());
+        filters[f]->SetInputArrayToProcess(0, 0, 0,
+          vtkDataObject::FIELD_ASSOCIATION_POINTS, "RTData");
+        filters[f]->ThresholdBetween(100.0, 180.0);
+        }
+      else
+        {
+        filters[f]->SetInputData(grid);
+        if (option & 8)
+          {
+          filters[f]->SetInputArrayToProcess(0, 0, 0,
+            vtkDataObject::FIELD_ASSOCIATION_CELLS, "CellScalars");
+          filters[f]->ThresholdBetween(3.0, 6.5);
+          }
+        else
+          {
+          filters[f]->SetInputArrayToProcess(0, 0, 0,
+            vtkDataObject::FIELD_ASSOCIATION_POINTS, "Scalars");
+          filters[f]->ThresholdBetween(0.5, 1.5);
+          }
+        }
+      filters[f]->SetAllScalars(option & 1);
+      filters[f]->SetUseContinuousCellRange((option & 2) != 0);
+      filters[f]->SetOutputPointsPrecision((option & 4) ?
+        vtkAlgorithm::DOUBLE_PRECISION : vtkAlgorithm::DEFAULT_PRECISION);
+      filters[f]->Update();
+      }
+    vtkUnstructuredGrid *output = threaded->GetOutput();
+    if (!SameOutputs(serial->GetOutput(), output))
+      {
+      cerr << "Different outputs with options " << option << endl;
+      return EXIT_FAILURE;
+      }
+    if (output->GetNumberOfCells() == 0 ||
+        output->GetNumberOfPoints() == grid->GetNumberOfPoints())
+      {
+      cerr << "Unexpected output size with options " << option << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Cells in 32-bit storage, selected by Squeeze().
+  vtkSmartPointer<vtkUnstructuredGrid> grid32 =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid32->DeepCopy(grid);
+  grid32->GetCells()->SetStorageLayoutToOffsets();
+  grid32->Squeeze();
+  vtkThreshold *filters[2] = { serial, threaded };
+  for (int f = 0; f < 2; ++f)
+    {
+    filters[f]->SetInputData(grid32);
+    filters[f]->SetInputArrayToProcess(0, 0, 0,
+      vtkDataObject::FIELD_ASSOCIATION_POINTS, "Scalars");
+    filters[f]->ThresholdBetween(0.5, 1.5);
+    filters[f]->Update();
+    }
+  if ((sizeof(vtkIdType) > 4 && !grid32->GetCells()->IsStorage32Bit()) ||
+      !SameOutputs(serial->GetOutput(), threaded->GetOutput()) ||
+      threaded->GetOutput()->GetNumberOfCells() == 0)
+    {
+    cerr << "Different outputs with 32-bit storage" << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
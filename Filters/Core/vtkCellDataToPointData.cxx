@@ -18,12 +18,17 @@
 #include "vtkCell.h"
 #include "vtkDataSet.h"
 #include "vtkIdList.h"
+#include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticCellLinksTemplate.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnstructuredGrid.h"
@@ -40,6 +45,7 @@ vtkStandardNewMacro(vtkCellDataToPointData);
 vtkCellDataToPointData::vtkCellDataToPointData()
 {
   this->PassCellData = 0;
+  this->EnableSMP = false;
 }
 
 //----------------------------------------------------------------------------
@@ -58,8 +64,21 @@ int vtkCellDataToPointData::RequestData(
 
   vtkDebugMacro(<<"Mapping cell data to point data");
 
+  // Like the special traversal of unstructured grids, the threaded
+  // interpolation only converts the data arrays. The other datasets use the
+  // serial interpolation when their cell data holds other arrays.
+  bool threaded = this->EnableSMP;
+  if (threaded && !input->IsA("vtkUnstructuredGrid"))
+    {
+    vtkCellData *inCD = input->GetCellData();
+    for (int i = 0; threaded && i < inCD->GetNumberOfArrays(); ++i)
+      {
+      threaded = inCD->GetArray(i) != NULL;
+      }
+    }
+
   // Special traversal algorithm for unstructured grid
-  if (input->IsA("vtkUnstructuredGrid"))
+  if (input->IsA("vtkUnstructuredGrid") && !threaded)
     {
     return this->RequestDataForUnstructuredGrid(0, inputVector, outputVector);
     }
@@ -84,7 +103,11 @@ int vtkCellDataToPointData::RequestData(
 
   // Do the interpolation, taking care of masked cells if needed.
   vtkStructuredGrid *sGrid = vtkStructuredGrid::SafeDownCast(input);
-  if (sGrid && sGrid->HasAnyBlankCells())
+  if (threaded)
+    {
+    this->ThreadedInterpolatePointData(input, output);
+    }
+  else if (sGrid && sGrid->HasAnyBlankCells())
     {
     this->interpolatePointDataWithMask(sGrid, output);
     }
@@ -109,6 +132,7 @@ void vtkCellDataToPointData::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "Pass Cell Data: " << (this->PassCellData ? "On\n" : "Off\n");
+  os << indent << "Enable SMP: " << (this->EnableSMP ? "On\n" : "Off\n");
 }
 
 //----------------------------------------------------------------------------
@@ -370,3 +394,197 @@ void vtkCellDataToPointData::interpolatePointDataWithMask(
     }
 }
 
+//----------------------------------------------------------------------------
+// Functors averaging the cell data of the cells using each point.
+namespace
+{
+#include "vtkArrayListTemplate.h" // For processing attribute data
+
+// Image data, rectilinear and structured grids: the cells using a point are
+// those of the 2x2x2 stencil around it, minus the blanked cells of a
+// structured grid.
+struct StructuredCellsToPoints
+{
+  ArrayList *Arrays;
+  int Dims[3];
+  vtkStructuredGrid *Blanking;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    vtkIdType cellDims[2] = { std::max(this->Dims[0] - 1, 1),
+                              std::max(this->Dims[1] - 1, 1) };
+    vtkIdType cellIds[8];
+    int ijk[3], range[3][2];
+    for ( ; ptId < endPtId; ++ptId )
+      {
+      ijk[0] = static_cast<int>(ptId % this->Dims[0]);
+      ijk[1] = static_cast<int>((ptId / this->Dims[0]) % this->Dims[1]);
+      ijk[2] = static_cast<int>(ptId / (static_cast<vtkIdType>(this->Dims[0]) *
+                                        this->Dims[1]));
+      for (int axis = 0; axis < 3; ++axis)
+        {
+        range[axis][0] = std::max(ijk[axis] - 1, 0);
+        range[axis][1] = std::min(ijk[axis], std::max(this->Dims[axis] - 2, 0));
+        }
+      int numCells = 0;
+      for (int k = range[2][0]; k <= range[2][1]; ++k)
+        {
+        for (int j = range[1][0]; j <= range[1][1]; ++j)
+          {
+          for (int i = range[0][0]; i <= range[0][1]; ++i)
+            {
+            vtkIdType cellId = i + (j + k * cellDims[1]) * cellDims[0];
+            if (!this->Blanking || this->Blanking->IsCellVisible(cellId))
+              {
+              cellIds[numCells++] = cellId;
+              }
+            }
+          }
+        }
+      if (numCells > 0)
+        {
+        this->Arrays->Average(numCells, cellIds, ptId);
+        }
+      else
+        {
+        this->Arrays->AssignNullValue(ptId);
+        }
+      }
+  }
+};
+
+// Unstructured grids: the cells using a point are given by static links.
+// (The links of polydata number the cells by cell array, which is not the
+// order of the polydata cells when the cell types were inserted mixed.)
+struct LinksCellsToPoints
+{
+  ArrayList *Arrays;
+  vtkStaticCellLinksTemplate<vtkIdType> *Links;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId )
+      {
+      vtkIdType numCells = this->Links->GetNumberOfCells(ptId);
+      if (numCells > 0)
+        {
+        this->Arrays->Average(static_cast<int>(numCells),
+                              this->Links->GetCells(ptId), ptId);
+        }
+      else
+        {
+        this->Arrays->AssignNullValue(ptId);
+        }
+      }
+  }
+};
+
+// Other datasets, e.g. polydata: GetPointCells() is thread safe once called
+// from a single thread.
+struct DataSetCellsToPoints
+{
+  ArrayList *Arrays;
+  vtkDataSet *Input;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    vtkIdList *cellIds = this->CellIds.Local();
+    for ( ; ptId < endPtId; ++ptId )
+      {
+      this->Input->GetPointCells(ptId, cellIds);
+      vtkIdType numCells = cellIds->GetNumberOfIds();
+      if (numCells > 0)
+        {
+        this->Arrays->Average(static_cast<int>(numCells),
+                              cellIds->GetPointer(0), ptId);
+        }
+      else
+        {
+        this->Arrays->AssignNullValue(ptId);
+        }
+      }
+  }
+};
+}
+
+//----------------------------------------------------------------------------
+void vtkCellDataToPointData::ThreadedInterpolatePointData(vtkDataSet *input,
+                                                          vtkDataSet *output)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkPointData *outPD = output->GetPointData();
+
+  // As for unstructured grids, only the data arrays are converted.
+  vtkSmartPointer<vtkCellData> inCD = vtkSmartPointer<vtkCellData>::New();
+  inCD->PassData(input->GetCellData());
+  for (vtkIdType fid = inCD->GetNumberOfArrays(); fid--;)
+    {
+    if (!inCD->GetAbstractArray(fid)->IsA("vtkDataArray"))
+      {
+      inCD->RemoveArray(fid);
+      }
+    }
+  vtkDataSetAttributes::FieldList cfl(1);
+  cfl.InitializeFieldList(inCD);
+  outPD->InterpolateAllocate(cfl, numPts, numPts);
+
+  ArrayList arrays;
+  arrays.AddArrays(numPts, cfl, 0, inCD, outPD);
+  if (arrays.GetNumberOfArrays() == 0 || input->GetNumberOfCells() < 1)
+    {
+    for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+      {
+      arrays.AssignNullValue(ptId);
+      }
+    return;
+    }
+
+  vtkImageData *image = vtkImageData::SafeDownCast(input);
+  vtkRectilinearGrid *rGrid = vtkRectilinearGrid::SafeDownCast(input);
+  vtkStructuredGrid *sGrid = vtkStructuredGrid::SafeDownCast(input);
+  if (image || rGrid || sGrid)
+    {
+    StructuredCellsToPoints worker;
+    worker.Arrays = &arrays;
+    worker.Blanking = NULL;
+    if (image)
+      {
+      image->GetDimensions(worker.Dims);
+      }
+    else if (rGrid)
+      {
+      rGrid->GetDimensions(worker.Dims);
+      }
+    else
+      {
+      sGrid->GetDimensions(worker.Dims);
+      if (sGrid->HasAnyBlankCells())
+        {
+        sGrid->IsCellVisible(0);
+        worker.Blanking = sGrid;
+        }
+      }
+    vtkSMPTools::For(0, numPts, worker);
+    }
+  else if (input->GetDataObjectType() == VTK_UNSTRUCTURED_GRID)
+    {
+    vtkStaticCellLinksTemplate<vtkIdType> links;
+    links.SetEnableSMP(true);
+    links.BuildLinks(input);
+    LinksCellsToPoints worker;
+    worker.Arrays = &arrays;
+    worker.Links = &links;
+    vtkSMPTools::For(0, numPts, worker);
+    }
+  else
+    {
+    vtkNew<vtkIdList> cellIds;
+    input->GetPointCells(0, cellIds.GetPointer());
+    DataSetCellsToPoints worker;
+    worker.Arrays = &arrays;
+    worker.Input = input;
+    vtkSMPTools::For(0, numPts, worker);
+    }
+  this->UpdateProgress(1.0);
+}
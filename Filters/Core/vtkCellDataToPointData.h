@@ -19,6 +19,12 @@
 // points). The method of transformation is based on averaging the data
 // values of all cells using a particular point. Optionally, the input cell
 // data can be passed through to the output as well.
+//
+// The point data may be computed in parallel with vtkSMPTools (see
+// EnableSMP). The cells using each point are then taken from the structure
+// of image data, rectilinear and structured grids, and from
+// vtkStaticCellLinks built in parallel for unstructured grids.
+// All the data arrays are averaged together for each point.
 
 // .SECTION Caveats
 // This filter is an abstract filter, that is, the output is an abstract type
@@ -53,6 +59,16 @@ public:
   vtkGetMacro(PassCellData,int);
   vtkBooleanMacro(PassCellData,int);
 
+  // Description:
+  // Compute the point data in parallel with vtkSMPTools. The values are
+  // the averages of the serial execution, up to rounding. As in the serial
+  // execution for unstructured grids, only the cell arrays deriving from
+  // vtkDataArray are converted; the other datasets are converted serially
+  // when their cell data holds other arrays. Off by default.
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+
 protected:
   vtkCellDataToPointData();
   ~vtkCellDataToPointData() {}
@@ -71,7 +87,11 @@ protected:
   void interpolatePointDataWithMask(vtkStructuredGrid *input,
                                     vtkDataSet *output);
 
+  // Threaded implementation of the interpolation, see EnableSMP.
+  void ThreadedInterpolatePointData(vtkDataSet *input, vtkDataSet *output);
+
   int PassCellData;
+  bool EnableSMP;
 private:
   vtkCellDataToPointData(const vtkCellDataToPointData&);  // Not implemented.
   void operator=(const vtkCellDataToPointData&);  // Not implemented.
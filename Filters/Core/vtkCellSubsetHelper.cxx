@@ -0,0 +1,647 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkCellSubsetHelper.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCellSubsetHelper.h"
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+#include "vtkArrayListTemplate.h" // For processing attribute data
+
+// Number of ids of the face stream of a polyhedron (nfaces, nface0pts,
+// id0, id1, ..., nface1pts, ...).
+vtkIdType vtkFaceStreamSize(const vtkIdType *faces)
+{
+  vtkIdType size = 1;
+  const vtkIdType *face = faces + 1;
+  for (vtkIdType i = 0; i < faces[0]; ++i)
+    {
+    size += face[0] + 1;
+    face += face[0] + 1;
+    }
+  return size;
+}
+
+// The faces of the cell if it is a polyhedron of an unstructured grid.
+const vtkIdType *vtkGetFaces(vtkUnstructuredGrid *grid, vtkIdType cellId,
+                             int cellType)
+{
+  if ( !grid || cellType != VTK_POLYHEDRON )
+    {
+    return NULL;
+    }
+  return grid->GetFaces(cellId);
+}
+
+// Size the cells, the first pass stores the number of points (in Offsets)
+// and the size of the face stream of each cell, and the second pass writes
+// the input point ids and the face streams.
+class vtkSubsetCellsWorker
+{
+public:
+  vtkDataSet *Input;
+  vtkUnstructuredGrid *InputGrid;
+  const vtkIdType *CellIds;
+  unsigned char *Types;
+  vtkIdType *Offsets;
+  vtkIdType *FaceOffsets;
+  vtkIdType *Connectivity;
+  vtkIdType *Faces;
+  vtkIdType *FaceLocations;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = this->CellPoints.Local();
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      vtkIdType cellId = this->CellIds[i];
+      if ( !this->Connectivity )
+        {
+        this->Types[i] =
+          static_cast<unsigned char>(this->Input->GetCellType(cellId));
+        this->Input->GetCellPoints(cellId, cellPts);
+        this->Offsets[i] = cellPts->GetNumberOfIds();
+        const vtkIdType *faces =
+          vtkGetFaces(this->InputGrid, cellId, this->Types[i]);
+        this->FaceOffsets[i] = (faces ? vtkFaceStreamSize(faces) : 0);
+        continue;
+        }
+      this->Input->GetCellPoints(cellId, cellPts);
+      std::copy(cellPts->GetPointer(0),
+                cellPts->GetPointer(0) + cellPts->GetNumberOfIds(),
+                this->Connectivity + this->Offsets[i]);
+      if ( this->Faces )
+        {
+        const vtkIdType *faces =
+          vtkGetFaces(this->InputGrid, cellId, this->Types[i]);
+        this->FaceLocations[i] = -1;
+        if ( faces )
+          {
+          this->FaceLocations[i] = this->FaceOffsets[i];
+          std::copy(faces, faces + vtkFaceStreamSize(faces),
+                    this->Faces + this->FaceOffsets[i]);
+          }
+        }
+      }
+  }
+};
+
+// Flag the points used by the connectivity.
+class vtkMarkUsedPointsWorker
+{
+public:
+  const vtkIdType *Connectivity;
+  unsigned char *Used;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Used[this->Connectivity[i]] = 1;
+      }
+  }
+};
+
+// Numbering of the used points in the input order: the flags are summed,
+// then the unused points are marked.
+struct vtkUsedToCount
+{
+  vtkIdType operator()(unsigned char used) const
+  {
+    return used;
+  }
+};
+
+struct vtkUnusedToNoId
+{
+  vtkIdType operator()(unsigned char used, vtkIdType newId) const
+  {
+    return (used ? newId : -1);
+  }
+};
+
+// A use of a point by the connectivity.
+struct vtkPointUse
+{
+  vtkIdType PointId;
+  vtkIdType Position;
+
+  bool operator<(const vtkPointUse& other) const
+  {
+    return (this->PointId < other.PointId ||
+            (this->PointId == other.PointId &&
+             this->Position < other.Position));
+  }
+};
+
+class vtkGatherPointUsesWorker
+{
+public:
+  const vtkIdType *Connectivity;
+  vtkPointUse *Uses;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Uses[i].PointId = this->Connectivity[i];
+      this->Uses[i].Position = i;
+      }
+  }
+};
+
+// With the uses sorted by point, flag the first use of each point. Once the
+// flags are summed, give each point the number of first uses before its
+// own.
+class vtkFirstUsesWorker
+{
+public:
+  const vtkPointUse *Uses;
+  vtkIdType *FirstUses;
+  vtkIdType *PointMap;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      if ( i == 0 || this->Uses[i].PointId != this->Uses[i-1].PointId )
+        {
+        if ( this->PointMap )
+          {
+          this->PointMap[this->Uses[i].PointId] =
+            this->FirstUses[this->Uses[i].Position];
+          }
+        else
+          {
+          this->FirstUses[this->Uses[i].Position] = 1;
+          }
+        }
+      }
+  }
+};
+
+// Renumber the points of the cells and of the faces (Types is NULL when
+// there are no polyhedra).
+class vtkRenumberCellsWorker
+{
+public:
+  const unsigned char *Types;
+  const vtkIdType *Offsets;
+  vtkIdType *Connectivity;
+  const vtkIdType *FaceLocations;
+  vtkIdType *Faces;
+  const vtkIdType *PointMap;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      vtkIdType *pts = this->Connectivity + this->Offsets[i];
+      vtkIdType *last = this->Connectivity + this->Offsets[i+1];
+      for (vtkIdType *pt = pts; pt != last; ++pt)
+        {
+        *pt = this->PointMap[*pt];
+        }
+      if ( !this->Types || this->Types[i] != VTK_POLYHEDRON )
+        {
+        continue;
+        }
+      std::sort(pts, last);
+      if ( this->Faces && this->FaceLocations[i] >= 0 )
+        {
+        vtkIdType *face = this->Faces + this->FaceLocations[i];
+        vtkIdType numFaces = *face++;
+        for (vtkIdType f = 0; f < numFaces; ++f)
+          {
+          vtkIdType npts = *face++;
+          for (vtkIdType j = 0; j < npts; ++j, ++face)
+            {
+            *face = this->PointMap[*face];
+            }
+          }
+        }
+      }
+  }
+};
+
+// Copy the used points and their data.
+class vtkCopySubsetPointsWorker
+{
+public:
+  vtkDataSet *Input;
+  const vtkIdType *PointMap;
+  vtkPoints *NewPoints;
+  ArrayList *Arrays;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    double x[3];
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      vtkIdType newId = this->PointMap[ptId];
+      if ( newId >= 0 )
+        {
+        this->Input->GetPoint(ptId, x);
+        this->NewPoints->SetPoint(newId, x);
+        this->Arrays->Copy(ptId, newId);
+        }
+      }
+  }
+};
+
+// Copy the data of the extracted cells.
+class vtkCopySubsetCellDataWorker
+{
+public:
+  const vtkIdType *CellIds;
+  ArrayList *Arrays;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Arrays->Copy(this->CellIds[i], i);
+      }
+  }
+};
+
+// Size the cells of a vtkPolyData (one kind of cells at a time), then write
+// their input point ids.
+class vtkSubsetPolyCellsWorker
+{
+public:
+  vtkPolyData *Input;
+  const vtkIdType *CellIds;
+  vtkIdType *Offsets;
+  vtkIdType *Connectivity;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = this->CellPoints.Local();
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Input->GetCellPoints(this->CellIds[i], cellPts);
+      if ( !this->Connectivity )
+        {
+        this->Offsets[i] = cellPts->GetNumberOfIds();
+        continue;
+        }
+      std::copy(cellPts->GetPointer(0),
+                cellPts->GetPointer(0) + cellPts->GetNumberOfIds(),
+                this->Connectivity + this->Offsets[i]);
+      }
+  }
+};
+
+// Flag the points used by a connectivity array.
+void vtkMarkUsedPoints(const vtkIdType *connectivity, vtkIdType connSize,
+                       unsigned char *used)
+{
+  vtkMarkUsedPointsWorker mark;
+  mark.Connectivity = connectivity;
+  mark.Used = used;
+  vtkSMPTools::For(0, connSize, mark);
+}
+
+// Number the flagged points in the input order, return their number.
+vtkIdType vtkNumberUsedPoints(const unsigned char *used, vtkIdType numPts,
+                              vtkIdType *pointMap)
+{
+  vtkSMPTools::Transform(used, used + numPts, pointMap, vtkUsedToCount());
+  vtkIdType numNewPts = vtkSMPTools::ExclusiveScan(
+    pointMap, pointMap + numPts, pointMap, static_cast<vtkIdType>(0));
+  vtkSMPTools::Transform(used, used + numPts, pointMap, pointMap,
+                         vtkUnusedToNoId());
+  return numNewPts;
+}
+
+// Copy serially the arrays skipped by ArrayList, which only handles the
+// data arrays: the input tuple inIds[i] is copied to the output tuple
+// outIds[i] when it is not negative. A NULL list stands for i.
+void vtkCopyAbstractArrays(vtkDataSetAttributes *inData,
+                           vtkDataSetAttributes *outData,
+                           const vtkIdType *inIds, const vtkIdType *outIds,
+                           vtkIdType numIds, vtkIdType numOutIds)
+{
+  for (int i = 0; i < outData->GetNumberOfArrays(); ++i)
+    {
+    vtkAbstractArray *outArray = outData->GetAbstractArray(i);
+    if ( outData->GetArray(i) || !outArray->GetName() )
+      {
+      continue;
+      }
+    vtkAbstractArray *inArray =
+      inData->GetAbstractArray(outArray->GetName());
+    if ( !inArray )
+      {
+      continue;
+      }
+    outArray->SetNumberOfTuples(numOutIds);
+    for (vtkIdType j = 0; j < numIds; ++j)
+      {
+      vtkIdType outId = (outIds ? outIds[j] : j);
+      if ( outId >= 0 )
+        {
+        outArray->SetTuple(outId, inIds ? inIds[j] : j, inArray);
+        }
+      }
+    }
+}
+
+// Copy the used points and their data, and the data of the cells.
+void vtkCopySubsetPointsAndData(vtkDataSet *input, const vtkIdType *pointMap,
+                                vtkIdType numNewPts,
+                                const vtkIdType *cellIds, vtkIdType numCells,
+                                int pointsDataType, vtkPointSet *output)
+{
+  vtkPoints *newPoints = vtkPoints::New();
+  newPoints->SetDataType(pointsDataType);
+  newPoints->SetNumberOfPoints(numNewPts);
+  vtkPointData *outPD = output->GetPointData();
+  outPD->CopyGlobalIdsOn();
+  outPD->CopyAllocate(input->GetPointData(), numNewPts);
+  ArrayList pointArrays;
+  pointArrays.AddArrays(numNewPts, input->GetPointData(), outPD);
+  vtkCopySubsetPointsWorker copyPoints;
+  copyPoints.Input = input;
+  copyPoints.PointMap = pointMap;
+  copyPoints.NewPoints = newPoints;
+  copyPoints.Arrays = &pointArrays;
+  vtkSMPTools::For(0, input->GetNumberOfPoints(), copyPoints);
+  vtkCopyAbstractArrays(input->GetPointData(), outPD, NULL, pointMap,
+                        input->GetNumberOfPoints(), numNewPts);
+  output->SetPoints(newPoints);
+  newPoints->Delete();
+
+  vtkCellData *outCD = output->GetCellData();
+  outCD->CopyGlobalIdsOn();
+  outCD->CopyAllocate(input->GetCellData(), numCells);
+  ArrayList cellArrays;
+  cellArrays.AddArrays(numCells, input->GetCellData(), outCD);
+  vtkCopySubsetCellDataWorker copyCellData;
+  copyCellData.CellIds = cellIds;
+  copyCellData.Arrays = &cellArrays;
+  vtkSMPTools::For(0, numCells, copyCellData);
+  vtkCopyAbstractArrays(input->GetCellData(), outCD, cellIds, NULL,
+                        numCells, numCells);
+}
+}
+
+//----------------------------------------------------------------------------
+void vtkCellSubsetHelper::ExtractCells(vtkDataSet *input,
+                                       const vtkIdType *cellIds,
+                                       vtkIdType numCells, int pointOrder,
+                                       int pointsDataType,
+                                       vtkUnstructuredGrid *output,
+                                       vtkIdType *pointMapOut)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+
+  // Build the cells of a vtkPolyData before the concurrent accesses.
+  vtkIdList *cellPts = vtkIdList::New();
+  if ( numCells > 0 )
+    {
+    input->GetCellPoints(cellIds[0], cellPts);
+    }
+  cellPts->Delete();
+
+  // Size the cells and allocate the output cells.
+  vtkUnsignedCharArray *types = vtkUnsignedCharArray::New();
+  types->SetNumberOfValues(numCells);
+  vtkIdTypeArray *offsets = vtkIdTypeArray::New();
+  offsets->SetNumberOfValues(numCells + 1);
+  std::vector<vtkIdType> faceOffsets(numCells + 1);
+
+  vtkSubsetCellsWorker cells;
+  cells.Input = input;
+  cells.InputGrid = vtkUnstructuredGrid::SafeDownCast(input);
+  cells.CellIds = cellIds;
+  cells.Types = types->GetPointer(0);
+  cells.Offsets = offsets->GetPointer(0);
+  cells.FaceOffsets = &faceOffsets[0];
+  cells.Connectivity = NULL;
+  cells.Faces = NULL;
+  cells.FaceLocations = NULL;
+  vtkSMPTools::For(0, numCells, cells);
+
+  vtkIdType connSize = vtkSMPTools::ExclusiveScan(
+    cells.Offsets, cells.Offsets + numCells, cells.Offsets,
+    static_cast<vtkIdType>(0));
+  cells.Offsets[numCells] = connSize;
+  vtkIdType facesSize = vtkSMPTools::ExclusiveScan(
+    faceOffsets.begin(), faceOffsets.begin() + numCells,
+    faceOffsets.begin(), static_cast<vtkIdType>(0));
+
+  vtkIdTypeArray *connectivity = vtkIdTypeArray::New();
+  connectivity->SetNumberOfValues(connSize);
+  cells.Connectivity = connectivity->GetPointer(0);
+  vtkIdTypeArray *faces = NULL;
+  vtkIdTypeArray *faceLocations = NULL;
+  if ( facesSize > 0 )
+    {
+    faces = vtkIdTypeArray::New();
+    faces->SetNumberOfValues(facesSize);
+    faceLocations = vtkIdTypeArray::New();
+    faceLocations->SetNumberOfValues(numCells);
+    cells.Faces = faces->GetPointer(0);
+    cells.FaceLocations = faceLocations->GetPointer(0);
+    }
+  vtkSMPTools::For(0, numCells, cells);
+
+  // Number the used points.
+  std::vector<vtkIdType> pointMap(numPts + 1, -1);
+  vtkIdType numNewPts;
+  if ( pointOrder == vtkCellSubsetHelper::FIRST_USE_ORDER )
+    {
+    std::vector<vtkPointUse> uses(connSize + 1);
+    vtkGatherPointUsesWorker gather;
+    gather.Connectivity = cells.Connectivity;
+    gather.Uses = &uses[0];
+    vtkSMPTools::For(0, connSize, gather);
+    vtkSMPTools::Sort(uses.begin(), uses.begin() + connSize);
+
+    std::vector<vtkIdType> firstUses(connSize + 1, 0);
+    vtkFirstUsesWorker firsts;
+    firsts.Uses = &uses[0];
+    firsts.FirstUses = &firstUses[0];
+    firsts.PointMap = NULL;
+    vtkSMPTools::For(0, connSize, firsts);
+    numNewPts = vtkSMPTools::ExclusiveScan(
+      firstUses.begin(), firstUses.begin() + connSize, firstUses.begin(),
+      static_cast<vtkIdType>(0));
+    firsts.PointMap = &pointMap[0];
+    vtkSMPTools::For(0, connSize, firsts);
+    }
+  else
+    {
+    std::vector<unsigned char> used(numPts + 1, 0);
+    vtkMarkUsedPoints(cells.Connectivity, connSize, &used[0]);
+    numNewPts = vtkNumberUsedPoints(&used[0], numPts, &pointMap[0]);
+    }
+
+  vtkRenumberCellsWorker renumber;
+  renumber.Types = cells.Types;
+  renumber.Offsets = cells.Offsets;
+  renumber.Connectivity = cells.Connectivity;
+  renumber.FaceLocations = cells.FaceLocations;
+  renumber.Faces = cells.Faces;
+  renumber.PointMap = &pointMap[0];
+  vtkSMPTools::For(0, numCells, renumber);
+
+  vtkCellArray *cellArray = vtkCellArray::New();
+  cellArray->SetData(offsets, connectivity);
+  output->SetCells(types, NULL, cellArray, faceLocations, faces);
+  cellArray->Delete();
+  offsets->Delete();
+  connectivity->Delete();
+  types->Delete();
+  if ( faces )
+    {
+    faces->Delete();
+    faceLocations->Delete();
+    }
+
+  // Copy the points and the point and cell data.
+  vtkCopySubsetPointsAndData(input, &pointMap[0], numNewPts, cellIds,
+                             numCells, pointsDataType, output);
+  if ( pointMapOut )
+    {
+    std::copy(pointMap.begin(), pointMap.begin() + numPts, pointMapOut);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellSubsetHelper::ExtractPolyDataCells(vtkPolyData *input,
+                                               const vtkIdType *cellIds,
+                                               vtkIdType numCells,
+                                               int pointsDataType,
+                                               vtkPolyData *output,
+                                               vtkIdType *pointMapOut)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+
+  // Build the cells before the concurrent accesses.
+  vtkIdList *cellPts = vtkIdList::New();
+  if ( numCells > 0 )
+    {
+    input->GetCellPoints(cellIds[0], cellPts);
+    }
+  cellPts->Delete();
+
+  // The cells of each kind follow each other in the input ids, and in
+  // cellIds.
+  vtkCellArray *inCells[4] = { input->GetVerts(), input->GetLines(),
+                               input->GetPolys(), input->GetStrips() };
+  const vtkIdType *kindEnds[4];
+  vtkIdType firstCellId = 0;
+  for (int kind = 0; kind < 4; ++kind)
+    {
+    firstCellId += inCells[kind]->GetNumberOfCells();
+    kindEnds[kind] = std::lower_bound(cellIds, cellIds + numCells,
+                                      firstCellId);
+    }
+
+  vtkIdTypeArray *offsets[4];
+  vtkIdTypeArray *connectivity[4];
+  std::vector<unsigned char> used(numPts + 1, 0);
+  vtkSubsetPolyCellsWorker cells;
+  cells.Input = input;
+  const vtkIdType *kindIds = cellIds;
+  for (int kind = 0; kind < 4; ++kind)
+    {
+    vtkIdType numKindCells = kindEnds[kind] - kindIds;
+    offsets[kind] = vtkIdTypeArray::New();
+    offsets[kind]->SetNumberOfValues(numKindCells + 1);
+    cells.CellIds = kindIds;
+    cells.Offsets = offsets[kind]->GetPointer(0);
+    cells.Connectivity = NULL;
+    vtkSMPTools::For(0, numKindCells, cells);
+    vtkIdType connSize = vtkSMPTools::ExclusiveScan(
+      cells.Offsets, cells.Offsets + numKindCells, cells.Offsets,
+      static_cast<vtkIdType>(0));
+    cells.Offsets[numKindCells] = connSize;
+
+    connectivity[kind] = vtkIdTypeArray::New();
+    connectivity[kind]->SetNumberOfValues(connSize);
+    cells.Connectivity = connectivity[kind]->GetPointer(0);
+    vtkSMPTools::For(0, numKindCells, cells);
+    vtkMarkUsedPoints(cells.Connectivity, connSize, &used[0]);
+    kindIds = kindEnds[kind];
+    }
+
+  // Number the used points, renumber the cells.
+  std::vector<vtkIdType> pointMap(numPts + 1, -1);
+  vtkIdType numNewPts = vtkNumberUsedPoints(&used[0], numPts, &pointMap[0]);
+  vtkRenumberCellsWorker renumber;
+  renumber.Types = NULL;
+  renumber.FaceLocations = NULL;
+  renumber.Faces = NULL;
+  renumber.PointMap = &pointMap[0];
+  for (int kind = 0; kind < 4; ++kind)
+    {
+    vtkIdType numKindCells = offsets[kind]->GetNumberOfValues() - 1;
+    renumber.Offsets = offsets[kind]->GetPointer(0);
+    renumber.Connectivity = connectivity[kind]->GetPointer(0);
+    vtkSMPTools::For(0, numKindCells, renumber);
+    if ( numKindCells > 0 )
+      {
+      vtkCellArray *cellArray = vtkCellArray::New();
+      cellArray->SetData(offsets[kind], connectivity[kind]);
+      if ( kind == 0 )
+        {
+        output->SetVerts(cellArray);
+        }
+      else if ( kind == 1 )
+        {
+        output->SetLines(cellArray);
+        }
+      else if ( kind == 2 )
+        {
+        output->SetPolys(cellArray);
+        }
+      else
+        {
+        output->SetStrips(cellArray);
+        }
+      cellArray->Delete();
+      }
+    offsets[kind]->Delete();
+    connectivity[kind]->Delete();
+    }
+
+  // Copy the points and the point and cell data.
+  vtkCopySubsetPointsAndData(input, &pointMap[0], numNewPts, cellIds,
+                             numCells, pointsDataType, output);
+  if ( pointMapOut )
+    {
+    std::copy(pointMap.begin(), pointMap.begin() + numPts, pointMapOut);
+    }
+}
@@ -0,0 +1,85 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkCellSubsetHelper.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkCellSubsetHelper - A utility class extracting cells with threads
+// .SECTION Description
+//  This is a utility class used by the filters extracting a subset of the
+//  cells of a dataset into a vtkUnstructuredGrid or a vtkPolyData
+//  (vtkThreshold, vtkExtractCells, the connectivity filters) to build their
+//  output with vtkSMPTools. The cells are sized concurrently, the offsets
+//  of their connectivity are computed with a prefix sum, and the
+//  connectivity, the used points and the point and cell data are then
+//  copied concurrently into the preallocated output. All cell types are
+//  supported, including polyhedra whose faces are copied. The data arrays
+//  are copied concurrently; the other arrays of the point and cell data,
+//  such as string arrays, are copied afterwards by the calling thread.
+// .SECTION See Also
+// vtkThreshold vtkExtractCells vtkConnectivityFilter
+// vtkPolyDataConnectivityFilter vtkSMPTools
+
+#ifndef vtkCellSubsetHelper_h
+#define vtkCellSubsetHelper_h
+
+#include "vtkFiltersCoreModule.h" // For export macro
+#include "vtkType.h" // For vtkIdType
+
+class vtkDataSet;
+class vtkPolyData;
+class vtkUnstructuredGrid;
+
+class VTKFILTERSCORE_EXPORT vtkCellSubsetHelper
+{
+public:
+  // Description:
+  // Order of the output points: the order of the input points, or the
+  // order in which the extracted cells use them first (as when the points
+  // are inserted while traversing the cells).
+  enum PointOrders
+  {
+    INPUT_ORDER = 0,
+    FIRST_USE_ORDER = 1
+  };
+
+  // Description:
+  // Fill output with the numCells cells of input listed in cellIds (in this
+  // order), the points they use, stored with the given data type, and the
+  // associated point and cell data (global ids included). The point ids of
+  // a polyhedron are sorted, as vtkUnstructuredGrid::InsertNextCell() does.
+  // The cells of a vtkPolyData input are built if needed. When pointMap is
+  // not NULL, it is filled with the output id of each input point (-1 for
+  // the unused points).
+  static void ExtractCells(vtkDataSet *input, const vtkIdType *cellIds,
+                           vtkIdType numCells, int pointOrder,
+                           int pointsDataType, vtkUnstructuredGrid *output,
+                           vtkIdType *pointMap = 0);
+
+  // Description:
+  // Same as ExtractCells() for a vtkPolyData output: the vertices, lines,
+  // polygons and triangle strips of input listed in cellIds, which must be
+  // sorted, are copied in this order. The points keep the input order.
+  static void ExtractPolyDataCells(vtkPolyData *input,
+                                   const vtkIdType *cellIds,
+                                   vtkIdType numCells, int pointsDataType,
+                                   vtkPolyData *output,
+                                   vtkIdType *pointMap = 0);
+
+private:
+  // Not implemented
+  vtkCellSubsetHelper();
+  vtkCellSubsetHelper(const vtkCellSubsetHelper&);
+  vtkCellSubsetHelper& operator=(const vtkCellSubsetHelper&);
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkCellSubsetHelper.h
@@ -16,17 +16,445 @@
 
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkIdList.h"
 #include "vtkMergePoints.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticPointLocator.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkIncrementalPointLocator.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkCleanPolyData);
 
+namespace
+{
+#include "vtkArrayListTemplate.h" // For processing attribute data
+
+// Input cell arrays, in the order of the cells (and of the cell data).
+enum { VTK_CLEAN_VERTS = 0, VTK_CLEAN_LINES, VTK_CLEAN_POLYS,
+       VTK_CLEAN_STRIPS, VTK_CLEAN_NUMBER_OF_TYPES };
+
+// Number of cells processed by a task of the threaded cell cleaning.
+const vtkIdType VTK_CLEAN_CELL_BLOCK_SIZE = 1024;
+
+// Whether all the point and cell arrays of the input are data arrays, the
+// only ones copied by the threaded execution.
+bool vtkCleanHasOnlyDataArrays(vtkPolyData *input)
+{
+  vtkDataSetAttributes *data[2] = { input->GetPointData(),
+                                    input->GetCellData() };
+  for (int d = 0; d < 2; ++d)
+    {
+    for (int i = 0; i < data[d]->GetNumberOfArrays(); ++i)
+      {
+      if ( !data[d]->GetArray(i) )
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+// Random access to the cells of a cell array from several threads. With
+// the legacy layout the locations of the cells are gathered beforehand;
+// cells stored as 32-bit integers are copied into the given id list.
+class vtkCleanCellAccess
+{
+public:
+  vtkCleanCellAccess() : Cells(NULL), Is32Bit(false) {}
+
+  void Initialize(vtkCellArray *cells)
+  {
+    this->Cells = cells;
+    this->Is32Bit = false;
+    this->Locations.clear();
+    if ( cells->GetStorageLayout() == vtkCellArray::OFFSETS_LAYOUT )
+      {
+      this->Is32Bit = (cells->IsStorage32Bit() != 0);
+      return;
+      }
+    this->Locations.resize(cells->GetNumberOfCells());
+    vtkIdType npts, *pts, loc = 0, cellId = 0;
+    for (cells->InitTraversal(); cells->GetNextCell(npts,pts); ++cellId)
+      {
+      this->Locations[cellId] = loc;
+      loc += npts + 1;
+      }
+  }
+
+  void GetCell(vtkIdType cellId, vtkIdType &npts, vtkIdType* &pts,
+               vtkIdList *buffer)
+  {
+    if ( this->Is32Bit )
+      {
+      this->Cells->GetCellAtId(cellId, buffer);
+      npts = buffer->GetNumberOfIds();
+      pts = buffer->GetPointer(0);
+      }
+    else if ( this->Cells->GetStorageLayout() == vtkCellArray::LEGACY_LAYOUT )
+      {
+      this->Cells->GetCell(this->Locations[cellId], npts, pts);
+      }
+    else
+      {
+      this->Cells->GetCellAtId(cellId, npts, pts);
+      }
+  }
+
+private:
+  vtkCellArray *Cells;
+  bool Is32Bit;
+  std::vector<vtkIdType> Locations;
+};
+
+// Number of cells and of point ids of each output cell array.
+struct vtkCleanCellCounts
+{
+  vtkIdType Cells[VTK_CLEAN_NUMBER_OF_TYPES];
+  vtkIdType Conn[VTK_CLEAN_NUMBER_OF_TYPES];
+
+  vtkCleanCellCounts()
+  {
+    for (int t = 0; t < VTK_CLEAN_NUMBER_OF_TYPES; ++t)
+      {
+      this->Cells[t] = this->Conn[t] = 0;
+      }
+  }
+};
+
+// The input cells of all types seen as one list of cells, and the rules
+// applied to the degenerate cells by the serial execution.
+class vtkCleanCells
+{
+public:
+  vtkCleanCellAccess Access[VTK_CLEAN_NUMBER_OF_TYPES];
+  vtkIdType Starts[VTK_CLEAN_NUMBER_OF_TYPES+1];
+  vtkIdType MaxCellSize;
+  const vtkIdType *PointMap;
+  int ConvertLinesToPoints;
+  int ConvertPolysToLines;
+  int ConvertStripsToPolys;
+  vtkSMPThreadLocalObject<vtkIdList> Buffer;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > NewPts;
+
+  vtkIdType GetNumberOfCells()
+  {
+    return this->Starts[VTK_CLEAN_NUMBER_OF_TYPES];
+  }
+
+  void GetCell(vtkIdType cellId, int &type, vtkIdType &npts, vtkIdType* &pts)
+  {
+    type = 0;
+    while ( cellId >= this->Starts[type+1] )
+      {
+      ++type;
+      }
+    this->Access[type].GetCell(cellId - this->Starts[type], npts, pts,
+                               this->Buffer.Local());
+  }
+
+  // Map the points of the cell, remove the duplicate points as the serial
+  // execution does, and return the type of the output cell (-1 if the cell
+  // is discarded). The points are stored in the thread local NewPts.
+  int CleanCell(vtkIdType cellId, vtkIdType &numNewPts)
+  {
+    int type;
+    vtkIdType npts, *pts;
+    this->GetCell(cellId, type, npts, pts);
+    std::vector<vtkIdType> &newPtsVector = this->NewPts.Local();
+    if ( static_cast<vtkIdType>(newPtsVector.size()) < this->MaxCellSize )
+      {
+      newPtsVector.resize(this->MaxCellSize);
+      }
+    vtkIdType *newPts = &newPtsVector[0];
+
+    numNewPts = 0;
+    for (vtkIdType i = 0; i < npts; ++i)
+      {
+      vtkIdType ptId = this->PointMap[pts[i]];
+      if ( type == VTK_CLEAN_VERTS || i == 0 || ptId != newPts[numNewPts-1] )
+        {
+        newPts[numNewPts++] = ptId;
+        }
+      }
+
+    switch (type)
+      {
+      case VTK_CLEAN_VERTS:
+        return (numNewPts > 0 ? VTK_CLEAN_VERTS : -1);
+      case VTK_CLEAN_STRIPS:
+        if ( (numNewPts > 3) || !this->ConvertStripsToPolys )
+          {
+          return VTK_CLEAN_STRIPS;
+          }
+        if ( numNewPts == 3 )
+          {
+          return VTK_CLEAN_POLYS;
+          }
+        return this->CleanPoly(numNewPts);
+      case VTK_CLEAN_POLYS:
+        if ( numNewPts > 2 && newPts[0] == newPts[numNewPts-1] )
+          {
+          numNewPts--;
+          }
+        return this->CleanPoly(numNewPts);
+      default:
+        return this->CleanLine(numNewPts);
+      }
+  }
+
+  int CleanPoly(vtkIdType numNewPts)
+  {
+    if ( (numNewPts > 2) || !this->ConvertPolysToLines )
+      {
+      return VTK_CLEAN_POLYS;
+      }
+    if ( numNewPts == 2 )
+      {
+      return VTK_CLEAN_LINES;
+      }
+    return this->CleanLine(numNewPts);
+  }
+
+  int CleanLine(vtkIdType numNewPts)
+  {
+    if ( (numNewPts > 1) || !this->ConvertLinesToPoints )
+      {
+      return VTK_CLEAN_LINES;
+      }
+    return (numNewPts == 1 ? VTK_CLEAN_VERTS : -1);
+  }
+};
+
+// Flag the points used by the cells.
+class vtkCleanMarkPointsWorker
+{
+public:
+  vtkCleanCells *Cells;
+  unsigned char *Used;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    int type;
+    vtkIdType npts, *pts;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      this->Cells->GetCell(cellId, type, npts, pts);
+      for (vtkIdType i = 0; i < npts; ++i)
+        {
+        this->Used[pts[i]] = 1;
+        }
+      }
+  }
+};
+
+// Apply OperateOnPoint() to the used points.
+class vtkCleanOperateOnPointsWorker
+{
+public:
+  vtkCleanPolyData *Self;
+  vtkPoints *InPts;
+  const unsigned char *Used;
+  double *X;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    double x[3];
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      this->InPts->GetPoint(ptId, x);
+      if ( this->Used[ptId] )
+        {
+        this->Self->OperateOnPoint(x, this->X + 3*ptId);
+        }
+      else
+        {
+        std::copy(x, x+3, this->X + 3*ptId);
+        }
+      }
+  }
+};
+
+// Map each used point to the coincident used point of lowest id.
+class vtkCleanMergeCoincidentWorker
+{
+public:
+  vtkStaticPointLocator *Locator;
+  const double *X;
+  const unsigned char *Used;
+  vtkIdType *Rep;
+  vtkSMPThreadLocalObject<vtkIdList> Ids;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *ids = this->Ids.Local();
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      this->Rep[ptId] = -1;
+      if ( !this->Used[ptId] )
+        {
+        continue;
+        }
+      this->Locator->FindPointsWithinRadius(0.0, this->X + 3*ptId, ids);
+      vtkIdType rep = ptId;
+      for (vtkIdType i = 0; i < ids->GetNumberOfIds(); ++i)
+        {
+        vtkIdType id = ids->GetId(i);
+        if ( id < rep && this->Used[id] )
+          {
+          rep = id;
+          }
+        }
+      this->Rep[ptId] = rep;
+      }
+  }
+};
+
+// Gather, for each used point, the used points of lower id within the
+// tolerance, in ascending order. The first pass only counts them.
+class vtkCleanFindNeighborsWorker
+{
+public:
+  vtkStaticPointLocator *Locator;
+  const double *X;
+  const unsigned char *Used;
+  double Tolerance;
+  vtkIdType *Counts;
+  const vtkIdType *Offsets;
+  vtkIdType *Neighbors;
+  vtkSMPThreadLocalObject<vtkIdList> Ids;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *ids = this->Ids.Local();
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      if ( !this->Used[ptId] )
+        {
+        if ( !this->Offsets )
+          {
+          this->Counts[ptId] = 0;
+          }
+        continue;
+        }
+      this->Locator->FindPointsWithinRadius(this->Tolerance,
+                                            this->X + 3*ptId, ids);
+      vtkIdType *neighbors = (this->Offsets ?
+                              this->Neighbors + this->Offsets[ptId] : NULL);
+      vtkIdType numNeighbors = 0;
+      for (vtkIdType i = 0; i < ids->GetNumberOfIds(); ++i)
+        {
+        vtkIdType id = ids->GetId(i);
+        if ( id < ptId && this->Used[id] )
+          {
+          if ( neighbors )
+            {
+            neighbors[numNeighbors] = id;
+            }
+          numNeighbors++;
+          }
+        }
+      if ( neighbors )
+        {
+        std::sort(neighbors, neighbors + numNeighbors);
+        }
+      else
+        {
+        this->Counts[ptId] = numNeighbors;
+        }
+      }
+  }
+};
+
+// Copy the kept points and their data to the output.
+class vtkCleanCopyPointsWorker
+{
+public:
+  const double *X;
+  const vtkIdType *Rep;
+  const vtkIdType *NewIds;
+  vtkPoints *NewPts;
+  ArrayList *Arrays;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      if ( this->Rep[ptId] == ptId )
+        {
+        this->NewPts->SetPoint(this->NewIds[ptId], this->X + 3*ptId);
+        this->Arrays->Copy(ptId, this->NewIds[ptId]);
+        }
+      }
+  }
+};
+
+// Count the output cells of each type per block of input cells, then
+// write them, starting from the counts of the previous blocks.
+class vtkCleanCellsWorker
+{
+public:
+  vtkCleanCells *Cells;
+  vtkCleanCellCounts *Counts;
+  vtkIdType *Offsets[VTK_CLEAN_NUMBER_OF_TYPES];
+  vtkIdType *Conn[VTK_CLEAN_NUMBER_OF_TYPES];
+  vtkIdType Bases[VTK_CLEAN_NUMBER_OF_TYPES];
+  ArrayList *Arrays;
+  bool Fill;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdType numCells = this->Cells->GetNumberOfCells();
+    for (vtkIdType block = begin; block < end; ++block)
+      {
+      vtkCleanCellCounts counts;
+      if ( this->Fill )
+        {
+        counts = this->Counts[block];
+        }
+      vtkIdType last = std::min((block+1) * VTK_CLEAN_CELL_BLOCK_SIZE,
+                                numCells);
+      for (vtkIdType cellId = block * VTK_CLEAN_CELL_BLOCK_SIZE;
+           cellId < last; ++cellId)
+        {
+        vtkIdType numNewPts;
+        int type = this->Cells->CleanCell(cellId, numNewPts);
+        if ( type < 0 )
+          {
+          continue;
+          }
+        if ( this->Fill )
+          {
+          vtkIdType cellIndex = counts.Cells[type];
+          this->Offsets[type][cellIndex] = counts.Conn[type];
+          const vtkIdType *newPts = &this->Cells->NewPts.Local()[0];
+          std::copy(newPts, newPts + numNewPts,
+                    this->Conn[type] + counts.Conn[type]);
+          this->Arrays->Copy(cellId, this->Bases[type] + cellIndex);
+          }
+        counts.Cells[type]++;
+        counts.Conn[type] += numNewPts;
+        }
+      if ( !this->Fill )
+        {
+        this->Counts[block] = counts;
+        }
+      }
+  }
+};
+}
+
+
 //---------------------------------------------------------------------------
 // Specify a spatial locator for speeding the search process. By
 // default an instance of vtkPointLocator is used.
@@ -46,6 +474,7 @@ vtkCleanPolyData::vtkCleanPolyData()
   this->Locator = NULL;
   this->PieceInvariant = 1;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->EnableSMP = false;
 }
 
 //--------------------------------------------------------------------------
@@ -138,6 +567,10 @@ int vtkCleanPolyData::RequestData(
     vtkDebugMacro(<<"No data to Operate On!");
     return 1;
     }
+  if ( this->EnableSMP && vtkCleanHasOnlyDataArrays(input) )
+    {
+    return this->ThreadedRequestData(input, output);
+    }
   vtkIdType *updatedPts = new vtkIdType[input->GetMaxCellSize()];
 
   vtkIdType numNewPts;
@@ -594,6 +1027,259 @@ int vtkCleanPolyData::RequestData(
   return 1;
 }
 
+//--------------------------------------------------------------------------
+// The points used by the cells are merged by looking for the neighbors of
+// every point in a vtkStaticPointLocator concurrently, the kept points are
+// numbered with a prefix sum, and the cells are cleaned twice: once to
+// count the output cells of each type per block of cells, and once to
+// write them at the offsets given by these counts. The output cells are
+// thus ordered as with the serial execution.
+int vtkCleanPolyData::ThreadedRequestData(vtkPolyData *input,
+                                          vtkPolyData *output)
+{
+  vtkPoints *inPts = input->GetPoints();
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkPointData *inputPD = input->GetPointData();
+  vtkCellData *inputCD = input->GetCellData();
+  vtkPointData *outputPD = output->GetPointData();
+  vtkCellData *outputCD = output->GetCellData();
+
+  vtkCellArray *inCells[VTK_CLEAN_NUMBER_OF_TYPES] =
+    { input->GetVerts(), input->GetLines(), input->GetPolys(),
+      input->GetStrips() };
+  vtkCleanCells cells;
+  cells.Starts[0] = 0;
+  for (int type = 0; type < VTK_CLEAN_NUMBER_OF_TYPES; ++type)
+    {
+    cells.Access[type].Initialize(inCells[type]);
+    cells.Starts[type+1] =
+      cells.Starts[type] + inCells[type]->GetNumberOfCells();
+    }
+  cells.MaxCellSize = input->GetMaxCellSize();
+  cells.PointMap = NULL;
+  cells.ConvertLinesToPoints = this->ConvertLinesToPoints;
+  cells.ConvertPolysToLines = this->ConvertPolysToLines;
+  cells.ConvertStripsToPolys = this->ConvertStripsToPolys;
+  vtkIdType numCells = cells.GetNumberOfCells();
+
+  // Flag the used points and apply OperateOnPoint() to them.
+  std::vector<unsigned char> used(numPts, 0);
+  vtkCleanMarkPointsWorker marker;
+  marker.Cells = &cells;
+  marker.Used = &used[0];
+  vtkSMPTools::For(0, numCells, marker);
+
+  vtkPoints *mappedPts = vtkPoints::New();
+  mappedPts->SetDataTypeToDouble();
+  mappedPts->SetNumberOfPoints(numPts);
+  double *x = static_cast<double*>(mappedPts->GetVoidPointer(0));
+  vtkCleanOperateOnPointsWorker operate;
+  operate.Self = this;
+  operate.InPts = inPts;
+  operate.Used = &used[0];
+  operate.X = x;
+  vtkSMPTools::For(0, numPts, operate);
+
+  // Map every used point to the point it is merged into (itself if kept).
+  std::vector<vtkIdType> rep(numPts);
+  if ( this->PointMerging )
+    {
+    double tol = (this->ToleranceIsAbsolute ? this->AbsoluteTolerance :
+                  this->Tolerance*input->GetLength());
+    vtkPolyData *mappedData = vtkPolyData::New();
+    mappedData->SetPoints(mappedPts);
+    vtkStaticPointLocator *locator = vtkStaticPointLocator::New();
+    locator->SetDataSet(mappedData);
+    locator->BuildLocator();
+    if ( tol == 0.0 )
+      {
+      vtkCleanMergeCoincidentWorker merger;
+      merger.Locator = locator;
+      merger.X = x;
+      merger.Used = &used[0];
+      merger.Rep = &rep[0];
+      vtkSMPTools::For(0, numPts, merger);
+      }
+    else
+      {
+      // A point is kept unless a kept point of lower id lies within the
+      // tolerance, which is decided in ascending order once the neighbors
+      // are known.
+      std::vector<vtkIdType> offsets(numPts+1);
+      vtkCleanFindNeighborsWorker finder;
+      finder.Locator = locator;
+      finder.X = x;
+      finder.Used = &used[0];
+      finder.Tolerance = tol;
+      finder.Counts = &offsets[0];
+      finder.Offsets = NULL;
+      finder.Neighbors = NULL;
+      vtkSMPTools::For(0, numPts, finder);
+      offsets[numPts] = vtkSMPTools::ExclusiveScan(
+        offsets.begin(), offsets.begin() + numPts, offsets.begin(),
+        static_cast<vtkIdType>(0));
+      std::vector<vtkIdType> neighbors(offsets[numPts] + 1);
+      finder.Offsets = &offsets[0];
+      finder.Neighbors = &neighbors[0];
+      vtkSMPTools::For(0, numPts, finder);
+
+      for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+        {
+        rep[ptId] = (used[ptId] ? ptId : -1);
+        for (vtkIdType i = offsets[ptId]; i < offsets[ptId+1]; ++i)
+          {
+          if ( rep[neighbors[i]] == neighbors[i] )
+            {
+            rep[ptId] = neighbors[i];
+            break;
+            }
+          }
+        }
+      }
+    locator->Delete();
+    mappedData->Delete();
+    }
+  else
+    {
+    for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+      {
+      rep[ptId] = (used[ptId] ? ptId : -1);
+      }
+    }
+
+  // Number the kept points in the input order and build the point map.
+  std::vector<vtkIdType> newIds(numPts);
+  std::vector<vtkIdType> pointMap(numPts, -1);
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+    {
+    newIds[ptId] = (rep[ptId] == ptId ? 1 : 0);
+    }
+  vtkIdType numNewPts = vtkSMPTools::ExclusiveScan(
+    newIds.begin(), newIds.end(), newIds.begin(), static_cast<vtkIdType>(0));
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+    {
+    if ( rep[ptId] >= 0 )
+      {
+      pointMap[ptId] = newIds[rep[ptId]];
+      }
+    }
+  this->UpdateProgress(0.25);
+
+  vtkPoints *newPts = inPts->NewInstance();
+  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+    {
+    newPts->SetDataType(inPts->GetDataType());
+    }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+    {
+    newPts->SetDataType(VTK_FLOAT);
+    }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+    {
+    newPts->SetDataType(VTK_DOUBLE);
+    }
+  newPts->SetNumberOfPoints(numNewPts);
+  outputPD->CopyAllocate(inputPD, numNewPts);
+  ArrayList pointArrays;
+  pointArrays.AddArrays(numNewPts, inputPD, outputPD);
+  vtkCleanCopyPointsWorker copier;
+  copier.X = x;
+  copier.Rep = &rep[0];
+  copier.NewIds = &newIds[0];
+  copier.NewPts = newPts;
+  copier.Arrays = &pointArrays;
+  vtkSMPTools::For(0, numPts, copier);
+  output->SetPoints(newPts);
+  newPts->Delete();
+  mappedPts->Delete();
+  this->UpdateProgress(0.50);
+
+  // Count the output cells of each block, and compute where each block
+  // writes its cells.
+  cells.PointMap = &pointMap[0];
+  vtkIdType numBlocks = (numCells + VTK_CLEAN_CELL_BLOCK_SIZE - 1) /
+    VTK_CLEAN_CELL_BLOCK_SIZE;
+  std::vector<vtkCleanCellCounts> counts(numBlocks);
+  vtkCleanCellsWorker cleaner;
+  cleaner.Cells = &cells;
+  cleaner.Counts = (numBlocks > 0 ? &counts[0] : NULL);
+  cleaner.Arrays = NULL;
+  cleaner.Fill = false;
+  vtkSMPTools::For(0, numBlocks, 1, cleaner);
+
+  vtkCleanCellCounts totals;
+  for (vtkIdType block = 0; block < numBlocks; ++block)
+    {
+    for (int type = 0; type < VTK_CLEAN_NUMBER_OF_TYPES; ++type)
+      {
+      vtkIdType numBlockCells = counts[block].Cells[type];
+      vtkIdType blockConnSize = counts[block].Conn[type];
+      counts[block].Cells[type] = totals.Cells[type];
+      counts[block].Conn[type] = totals.Conn[type];
+      totals.Cells[type] += numBlockCells;
+      totals.Conn[type] += blockConnSize;
+      }
+    }
+  this->UpdateProgress(0.75);
+
+  vtkCellArray *newCells[VTK_CLEAN_NUMBER_OF_TYPES];
+  vtkIdType numNewCells = 0;
+  for (int type = 0; type < VTK_CLEAN_NUMBER_OF_TYPES; ++type)
+    {
+    cleaner.Offsets[type] = cleaner.Conn[type] = NULL;
+    cleaner.Bases[type] = numNewCells;
+    numNewCells += totals.Cells[type];
+    newCells[type] = NULL;
+    if ( inCells[type]->GetNumberOfCells() > 0 || totals.Cells[type] > 0 )
+      {
+      newCells[type] = vtkCellArray::New();
+      newCells[type]->AllocateExact(totals.Cells[type], totals.Conn[type]);
+      vtkIdTypeArray *offsets =
+        static_cast<vtkIdTypeArray*>(newCells[type]->GetOffsetsArray());
+      offsets->SetValue(totals.Cells[type], totals.Conn[type]);
+      cleaner.Offsets[type] = offsets->GetPointer(0);
+      cleaner.Conn[type] = static_cast<vtkIdTypeArray*>(
+        newCells[type]->GetConnectivityArray())->GetPointer(0);
+      }
+    }
+
+  outputCD->CopyAllocate(inputCD, numNewCells);
+  ArrayList cellArrays;
+  cellArrays.AddArrays(numNewCells, inputCD, outputCD);
+  cleaner.Arrays = &cellArrays;
+  cleaner.Fill = true;
+  vtkSMPTools::For(0, numBlocks, 1, cleaner);
+
+  if ( newCells[VTK_CLEAN_VERTS] )
+    {
+    output->SetVerts(newCells[VTK_CLEAN_VERTS]);
+    }
+  if ( newCells[VTK_CLEAN_LINES] )
+    {
+    output->SetLines(newCells[VTK_CLEAN_LINES]);
+    }
+  if ( newCells[VTK_CLEAN_POLYS] )
+    {
+    output->SetPolys(newCells[VTK_CLEAN_POLYS]);
+    }
+  if ( newCells[VTK_CLEAN_STRIPS] )
+    {
+    output->SetStrips(newCells[VTK_CLEAN_STRIPS]);
+    }
+  for (int type = 0; type < VTK_CLEAN_NUMBER_OF_TYPES; ++type)
+    {
+    if ( newCells[type] )
+      {
+      newCells[type]->Delete();
+      }
+    }
+
+  vtkDebugMacro(<<"Removed " << numPts - numNewPts << " points and "
+                << numCells - numNewCells << " cells");
+
+  return 1;
+}
+
 //--------------------------------------------------------------------------
 // Method manages creation of locators. It takes into account the potential
 // change of tolerance (zero to non-zero).
@@ -675,6 +1361,7 @@ void vtkCleanPolyData::PrintSelf(ostream& os, vtkIndent indent)
      << (this->PieceInvariant ? "On\n" : "Off\n");
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision
      << "\n";
+  os << indent << "Enable SMP: " << (this->EnableSMP ? "On\n" : "Off\n");
 }
 
 //--------------------------------------------------------------------------
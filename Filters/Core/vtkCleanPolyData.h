@@ -161,6 +161,20 @@ public:
   vtkSetMacro(OutputPointsPrecision,int);
   vtkGetMacro(OutputPointsPrecision,int);
 
+  // Description:
+  // Turn on/off the use of vtkSMPTools to merge the points and to clean the
+  // cells with several threads. The points are then binned and merged with
+  // a vtkStaticPointLocator instead of the Locator, and OperateOnPoint() is
+  // invoked concurrently. The output points keep the order of the input
+  // points (instead of the order of their first use by the cells), and
+  // with a non-zero tolerance a point is merged into the kept point of
+  // lowest id within the tolerance. The cells and their data are the same
+  // as with the serial execution. Inputs with string or other non-numeric
+  // point or cell arrays are cleaned serially. Off by default.
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+
 protected:
   vtkCleanPolyData();
  ~vtkCleanPolyData();
@@ -169,6 +183,9 @@ protected:
   virtual int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
   virtual int RequestUpdateExtent(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
 
+  // Threaded implementation of RequestData(), see EnableSMP.
+  int ThreadedRequestData(vtkPolyData *input, vtkPolyData *output);
+
   int   PointMerging;
   double Tolerance;
   double AbsoluteTolerance;
@@ -180,6 +197,7 @@ protected:
 
   int PieceInvariant;
   int OutputPointsPrecision;
+  bool EnableSMP;
 private:
   vtkCleanPolyData(const vtkCleanPolyData&);  // Not implemented.
   void operator=(const vtkCleanPolyData&);  // Not implemented.
@@ -0,0 +1,832 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConnectedRegionsHelper.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkConnectedRegionsHelper.h"
+
+#include "vtkAtomic.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <vector>
+
+namespace
+{
+typedef vtkAtomic<vtkIdType> vtkAtomicId;
+
+// Lower value to v if v is smaller. Without compare-and-swap, a concurrent
+// store may replace v by a larger value: the passes using this function
+// are repeated until none of them lowers a value.
+inline bool vtkLowerValue(vtkAtomicId &value, vtkIdType v)
+{
+  if ( v < value.load() )
+    {
+    value.store(v);
+    return true;
+    }
+  return false;
+}
+
+// Root of an element of the union-find. The parent of an element is never
+// larger than the element, and roots are their own parent.
+inline vtkIdType vtkFindRoot(const vtkAtomicId *parents, vtkIdType id)
+{
+  vtkIdType parent;
+  while ( (parent = parents[id].load()) != id )
+    {
+    id = parent;
+    }
+  return id;
+}
+
+inline bool vtkIsConnectable(const unsigned char *connectable,
+                             vtkIdType cellId)
+{
+  return ( !connectable || connectable[cellId] );
+}
+
+// Evaluate the scalar connectivity criterion on each cell.
+class vtkClassifyCellsWorker
+{
+public:
+  vtkDataSet *Input;
+  vtkDataArray *Scalars;
+  double Range[2];
+  bool AllPointsInRange;
+  unsigned char *Connectable;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = this->CellPoints.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      this->Input->GetCellPoints(cellId, cellPts);
+      double range[2] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+      for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+        {
+        double s = static_cast<float>(
+          this->Scalars->GetComponent(cellPts->GetId(i), 0));
+        range[0] = (s < range[0] ? s : range[0]);
+        range[1] = (s > range[1] ? s : range[1]);
+        }
+      if ( this->AllPointsInRange )
+        {
+        this->Connectable[cellId] = ( range[0] >= this->Range[0] &&
+                                      range[1] <= this->Range[1] );
+        }
+      else
+        {
+        this->Connectable[cellId] = ( range[1] >= this->Range[0] &&
+                                      range[0] <= this->Range[1] );
+        }
+      }
+  }
+};
+
+// The union-find of the connectable cells and of their points: cell
+// cellId is element cellId, and point ptId is element numCells + ptId.
+// A pass links the roots of each cell and of its points to the smallest of
+// them; it is repeated until no roots had to be linked.
+class vtkLinkCellsWorker
+{
+public:
+  vtkDataSet *Input;
+  const unsigned char *Connectable;
+  vtkIdType NumberOfCells;
+  vtkAtomicId *Parents;
+  vtkAtomic<int> Linked;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = this->CellPoints.Local();
+    bool linked = false;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      if ( !vtkIsConnectable(this->Connectable, cellId) )
+        {
+        continue;
+        }
+      this->Input->GetCellPoints(cellId, cellPts);
+      vtkIdType numPts = cellPts->GetNumberOfIds();
+      vtkIdType *pts = cellPts->GetPointer(0);
+      vtkIdType root = vtkFindRoot(this->Parents, cellId);
+      for (vtkIdType i = 0; i < numPts; ++i)
+        {
+        vtkIdType ptRoot =
+          vtkFindRoot(this->Parents, this->NumberOfCells + pts[i]);
+        root = (ptRoot < root ? ptRoot : root);
+        }
+      for (vtkIdType i = -1; i < numPts; ++i)
+        {
+        vtkIdType other = vtkFindRoot(this->Parents,
+          (i < 0 ? cellId : this->NumberOfCells + pts[i]));
+        if ( other > root )
+          {
+          this->Parents[other].store(root);
+          linked = true;
+          }
+        else if ( other < root )
+          {
+          // Linked concurrently to a smaller root, see the next pass.
+          linked = true;
+          }
+        }
+      }
+    if ( linked )
+      {
+      this->Linked = 1;
+      }
+  }
+};
+
+// Path compression: link every element to its root.
+class vtkCompressWorker
+{
+public:
+  vtkAtomicId *Parents;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType id = begin; id < end; ++id)
+      {
+      this->Parents[id].store(vtkFindRoot(this->Parents, id));
+      }
+  }
+};
+
+class vtkInitializeWorker
+{
+public:
+  vtkAtomicId *Values;
+  vtkIdType Value; // the index of the value when negative
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType id = begin; id < end; ++id)
+      {
+      this->Values[id].store(this->Value < 0 ? id : this->Value);
+      }
+  }
+};
+
+// Label each connected component of the connectable cells with its
+// smallest cell id: on return, Parents[cellId] is the label of cellId (a
+// cell which is not connectable is its own label). Parents must be
+// allocated for the cells and the points.
+void vtkFindComponents(vtkDataSet *input, const unsigned char *connectable,
+                       vtkAtomicId *parents)
+{
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkIdType numIds = numCells + input->GetNumberOfPoints();
+  vtkInitializeWorker init;
+  init.Values = parents;
+  init.Value = -1;
+  vtkSMPTools::For(0, numIds, init);
+
+  vtkLinkCellsWorker link;
+  link.Input = input;
+  link.Connectable = connectable;
+  link.NumberOfCells = numCells;
+  link.Parents = parents;
+  vtkCompressWorker compress;
+  compress.Parents = parents;
+  do
+    {
+    link.Linked = 0;
+    vtkSMPTools::For(0, numCells, link);
+    vtkSMPTools::For(0, numIds, compress);
+    }
+  while ( link.Linked );
+}
+
+// Lower the value of each point of the cells to the id of the cell (the
+// first cell using the point), or to its region if Regions is set, for the
+// cells that are not connectable, or have a region, respectively.
+class vtkLowerPointsWorker
+{
+public:
+  vtkDataSet *Input;
+  const unsigned char *Connectable;
+  const vtkIdType *Regions;
+  vtkAtomicId *Values;
+  vtkAtomic<int> Lowered;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = this->CellPoints.Local();
+    bool lowered = false;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      vtkIdType value = cellId;
+      if ( this->Regions )
+        {
+        if ( (value = this->Regions[cellId]) < 0 )
+          {
+          continue;
+          }
+        }
+      else if ( this->Connectable[cellId] )
+        {
+        continue;
+        }
+      this->Input->GetCellPoints(cellId, cellPts);
+      for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+        {
+        lowered |= vtkLowerValue(this->Values[cellPts->GetId(i)], value);
+        }
+      }
+    if ( lowered )
+      {
+      this->Lowered = 1;
+      }
+  }
+};
+
+void vtkLowerPoints(vtkLowerPointsWorker &lower, vtkIdType numCells)
+{
+  do
+    {
+    lower.Lowered = 0;
+    vtkSMPTools::For(0, numCells, lower);
+    }
+  while ( lower.Lowered );
+}
+
+// The first cell of the region of a component is the first cell which is
+// not connectable and uses one of its points, if it comes before the first
+// cell of the component. Claims[label] is lowered to the id of these cells.
+class vtkClaimComponentsWorker
+{
+public:
+  vtkDataSet *Input;
+  const unsigned char *Connectable;
+  const vtkAtomicId *Labels;
+  const vtkAtomicId *FirstCells; // the first non connectable cell of points
+  vtkAtomicId *Claims;
+  vtkAtomic<int> Lowered;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = this->CellPoints.Local();
+    bool lowered = false;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      if ( !this->Connectable[cellId] )
+        {
+        continue;
+        }
+      this->Input->GetCellPoints(cellId, cellPts);
+      vtkIdType first = cellId;
+      for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+        {
+        vtkIdType ptFirst = this->FirstCells[cellPts->GetId(i)].load();
+        first = (ptFirst < first ? ptFirst : first);
+        }
+      lowered |= vtkLowerValue(this->Claims[this->Labels[cellId].load()],
+                               first);
+      }
+    if ( lowered )
+      {
+      this->Lowered = 1;
+      }
+  }
+};
+
+// Number the regions: flag the first cell of each region, sum the flags,
+// and give each cell the number of the first cell of its region.
+class vtkNumberRegionsWorker
+{
+public:
+  const unsigned char *Connectable;
+  const vtkAtomicId *Labels;
+  const vtkAtomicId *Claims; // NULL when all the cells are connectable
+  vtkIdType *RegionIds;
+  bool Flag;
+
+  // The first cell of the region of cellId.
+  vtkIdType GetFirstCell(vtkIdType cellId) const
+  {
+    if ( !vtkIsConnectable(this->Connectable, cellId) )
+      {
+      return cellId;
+      }
+    vtkIdType label = this->Labels[cellId].load();
+    return ( this->Claims ? this->Claims[label].load() : label );
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      vtkIdType first = this->GetFirstCell(cellId);
+      if ( this->Flag )
+        {
+        this->RegionIds[cellId] = (first == cellId ? 1 : 0);
+        }
+      else if ( first != cellId )
+        {
+        this->RegionIds[cellId] = this->RegionIds[first];
+        }
+      }
+  }
+};
+
+// Count the cells of the regions, adding the runs of cells of the same
+// region.
+class vtkCountRegionCellsWorker
+{
+public:
+  const vtkIdType *RegionIds;
+  vtkAtomicId *Sizes;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdType regionId = this->RegionIds[begin];
+    vtkIdType count = 0;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      if ( this->RegionIds[cellId] != regionId )
+        {
+        this->Sizes[regionId] += count;
+        regionId = this->RegionIds[cellId];
+        count = 0;
+        }
+      ++count;
+      }
+    this->Sizes[regionId] += count;
+  }
+};
+
+// Select the components of the seeds, and those using the points of the
+// seeds which are not connectable, then flag the cells reached.
+class vtkSeededRegionWorker
+{
+public:
+  vtkDataSet *Input;
+  const unsigned char *Connectable;
+  const unsigned char *Seeds;
+  const vtkAtomicId *Labels;
+  unsigned char *SeedPoints;
+  unsigned char *Selected;
+  vtkIdType *RegionIds;
+  vtkAtomicId NumberOfCells;
+  int Pass;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = this->CellPoints.Local();
+    vtkIdType numReached = 0;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      bool connectable = vtkIsConnectable(this->Connectable, cellId);
+      if ( this->Pass == 0 )
+        {
+        if ( this->Seeds[cellId] && !connectable )
+          {
+          this->Input->GetCellPoints(cellId, cellPts);
+          for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+            {
+            this->SeedPoints[cellPts->GetId(i)] = 1;
+            }
+          }
+        }
+      else if ( this->Pass == 1 )
+        {
+        if ( !connectable )
+          {
+          continue;
+          }
+        bool selected = (this->Seeds[cellId] != 0);
+        if ( !selected )
+          {
+          this->Input->GetCellPoints(cellId, cellPts);
+          for (vtkIdType i = 0; !selected && i < cellPts->GetNumberOfIds();
+               ++i)
+            {
+            selected = (this->SeedPoints[cellPts->GetId(i)] != 0);
+            }
+          }
+        if ( selected )
+          {
+          this->Selected[this->Labels[cellId].load()] = 1;
+          }
+        }
+      else
+        {
+        bool reached = ( this->Seeds[cellId] || (connectable &&
+          this->Selected[this->Labels[cellId].load()]) );
+        this->RegionIds[cellId] = (reached ? 0 : -1);
+        numReached += (reached ? 1 : 0);
+        }
+      }
+    if ( numReached > 0 )
+      {
+      this->NumberOfCells += numReached;
+      }
+  }
+};
+
+class vtkFlagCellsWorker
+{
+public:
+  vtkDataSet *Input;
+  const unsigned char *Points;
+  unsigned char *Cells;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = this->CellPoints.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      this->Input->GetCellPoints(cellId, cellPts);
+      this->Cells[cellId] = 0;
+      for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+        {
+        if ( this->Points[cellPts->GetId(i)] )
+          {
+          this->Cells[cellId] = 1;
+          break;
+          }
+        }
+      }
+  }
+};
+
+// Write the region of the output points, and the ids of the output cells
+// (Offsets is NULL when counting them).
+class vtkOutputRegionsWorker
+{
+public:
+  const vtkIdType *RegionIds;
+  const unsigned char *Extracted;
+  vtkIdType *Offsets;
+  vtkIdType *CellIds;
+  const vtkAtomicId *PointRegions;
+  const vtkIdType *PointMap;
+  vtkIdType *NewPointRegions;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType id = begin; id < end; ++id)
+      {
+      if ( this->PointRegions )
+        {
+        if ( this->PointMap[id] >= 0 )
+          {
+          vtkIdType regionId = this->PointRegions[id].load();
+          this->NewPointRegions[this->PointMap[id]] =
+            (regionId == VTK_ID_MAX ? -1 : regionId);
+          }
+        continue;
+        }
+      vtkIdType regionId = this->RegionIds[id];
+      bool extracted = ( regionId >= 0 && this->Extracted[regionId] );
+      if ( !this->CellIds )
+        {
+        this->Offsets[id] = (extracted ? 1 : 0);
+        }
+      else if ( extracted )
+        {
+        this->CellIds[this->Offsets[id]] = id;
+        }
+      }
+  }
+};
+
+class vtkGatherRegionsWorker
+{
+public:
+  const vtkIdType *RegionIds;
+  const vtkIdType *CellIds;
+  vtkIdType *NewRegionIds;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->NewRegionIds[i] = this->RegionIds[this->CellIds[i]];
+      }
+  }
+};
+
+// The closest point of each thread, then of all of them.
+struct vtkClosestPoint
+{
+  double Distance2;
+  vtkIdType Id;
+
+  void Update(double dist2, vtkIdType id)
+  {
+    if ( dist2 < this->Distance2 ||
+         (dist2 == this->Distance2 && id < this->Id) )
+      {
+      this->Distance2 = dist2;
+      this->Id = id;
+      }
+  }
+};
+
+class vtkClosestPointWorker
+{
+public:
+  vtkDataSet *Input;
+  const double *X;
+  vtkSMPThreadLocal<vtkClosestPoint> Closest;
+  vtkClosestPoint Result;
+
+  void Initialize()
+  {
+    vtkClosestPoint& closest = this->Closest.Local();
+    closest.Distance2 = VTK_DOUBLE_MAX;
+    closest.Id = -1;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkClosestPoint& closest = this->Closest.Local();
+    double x[3];
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      this->Input->GetPoint(ptId, x);
+      closest.Update(vtkMath::Distance2BetweenPoints(x, this->X), ptId);
+      }
+  }
+
+  void Reduce()
+  {
+    this->Result.Distance2 = VTK_DOUBLE_MAX;
+    this->Result.Id = -1;
+    vtkSMPThreadLocal<vtkClosestPoint>::iterator iter;
+    for (iter = this->Closest.begin(); iter != this->Closest.end(); ++iter)
+      {
+      if ( (*iter).Id >= 0 )
+        {
+        this->Result.Update((*iter).Distance2, (*iter).Id);
+        }
+      }
+  }
+};
+
+// Make the cells of a vtkPolyData, and the structures of the other
+// datasets, before the concurrent accesses.
+void vtkPrepareCellAccess(vtkDataSet *input)
+{
+  if ( input->GetNumberOfCells() > 0 )
+    {
+    vtkIdList *cellPts = vtkIdList::New();
+    input->GetCellPoints(0, cellPts);
+    cellPts->Delete();
+    }
+}
+}
+
+//----------------------------------------------------------------------------
+void vtkConnectedRegionsHelper::ClassifyCells(vtkDataSet *input,
+                                              vtkDataArray *scalars,
+                                              const double range[2],
+                                              bool allPointsInRange,
+                                              unsigned char *connectable)
+{
+  vtkPrepareCellAccess(input);
+  vtkClassifyCellsWorker classify;
+  classify.Input = input;
+  classify.Scalars = scalars;
+  classify.Range[0] = range[0];
+  classify.Range[1] = range[1];
+  classify.AllPointsInRange = allPointsInRange;
+  classify.Connectable = connectable;
+  vtkSMPTools::For(0, input->GetNumberOfCells(), classify);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConnectedRegionsHelper::LabelRegions(
+  vtkDataSet *input, const unsigned char *connectable, vtkIdType *regionIds,
+  vtkIdTypeArray *regionSizes)
+{
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkIdType numPts = input->GetNumberOfPoints();
+  regionSizes->Reset();
+  if ( numCells < 1 )
+    {
+    return 0;
+    }
+  vtkPrepareCellAccess(input);
+
+  vtkAtomicId *labels = new vtkAtomicId[numCells + numPts];
+  vtkFindComponents(input, connectable, labels);
+
+  // A cell which is not connectable starts a region with the components
+  // using its points, unless one of them has already been visited.
+  vtkAtomicId *claims = NULL;
+  if ( connectable )
+    {
+    vtkAtomicId *firstCells = labels + numCells; // the points are done
+    vtkInitializeWorker init;
+    init.Values = firstCells;
+    init.Value = VTK_ID_MAX;
+    vtkSMPTools::For(0, numPts, init);
+    vtkLowerPointsWorker lower;
+    lower.Input = input;
+    lower.Connectable = connectable;
+    lower.Regions = NULL;
+    lower.Values = firstCells;
+    vtkLowerPoints(lower, numCells);
+
+    claims = new vtkAtomicId[numCells];
+    init.Values = claims;
+    init.Value = -1;
+    vtkSMPTools::For(0, numCells, init);
+    vtkClaimComponentsWorker claim;
+    claim.Input = input;
+    claim.Connectable = connectable;
+    claim.Labels = labels;
+    claim.FirstCells = firstCells;
+    claim.Claims = claims;
+    do
+      {
+      claim.Lowered = 0;
+      vtkSMPTools::For(0, numCells, claim);
+      }
+    while ( claim.Lowered );
+    }
+
+  vtkNumberRegionsWorker number;
+  number.Connectable = connectable;
+  number.Labels = labels;
+  number.Claims = claims;
+  number.RegionIds = regionIds;
+  number.Flag = true;
+  vtkSMPTools::For(0, numCells, number);
+  vtkIdType numRegions = vtkSMPTools::ExclusiveScan(
+    regionIds, regionIds + numCells, regionIds, static_cast<vtkIdType>(0));
+  number.Flag = false;
+  vtkSMPTools::For(0, numCells, number);
+  delete [] labels;
+  delete [] claims;
+
+  vtkAtomicId *sizes = new vtkAtomicId[numRegions];
+  vtkCountRegionCellsWorker count;
+  count.RegionIds = regionIds;
+  count.Sizes = sizes;
+  vtkSMPTools::For(0, numCells, count);
+  regionSizes->SetNumberOfValues(numRegions);
+  for (vtkIdType regionId = 0; regionId < numRegions; ++regionId)
+    {
+    regionSizes->SetValue(regionId, sizes[regionId].load());
+    }
+  delete [] sizes;
+
+  return numRegions;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConnectedRegionsHelper::LabelSeededRegion(
+  vtkDataSet *input, const unsigned char *connectable,
+  const unsigned char *seeds, vtkIdType *regionIds)
+{
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkIdType numPts = input->GetNumberOfPoints();
+  if ( numCells < 1 )
+    {
+    return 0;
+    }
+  vtkPrepareCellAccess(input);
+
+  vtkAtomicId *labels = new vtkAtomicId[numCells + numPts];
+  vtkFindComponents(input, connectable, labels);
+
+  std::vector<unsigned char> seedPoints(numPts + 1, 0);
+  std::vector<unsigned char> selected(numCells, 0);
+  vtkSeededRegionWorker seeded;
+  seeded.Input = input;
+  seeded.Connectable = connectable;
+  seeded.Seeds = seeds;
+  seeded.Labels = labels;
+  seeded.SeedPoints = &seedPoints[0];
+  seeded.Selected = &selected[0];
+  seeded.RegionIds = regionIds;
+  seeded.NumberOfCells = 0;
+  for (seeded.Pass = 0; seeded.Pass < 3; ++seeded.Pass)
+    {
+    vtkSMPTools::For(0, numCells, seeded);
+    }
+  delete [] labels;
+
+  return seeded.NumberOfCells.load();
+}
+
+//----------------------------------------------------------------------------
+void vtkConnectedRegionsHelper::FlagCellsUsingPoints(
+  vtkDataSet *input, const unsigned char *points, unsigned char *cells)
+{
+  vtkPrepareCellAccess(input);
+  vtkFlagCellsWorker flag;
+  flag.Input = input;
+  flag.Points = points;
+  flag.Cells = cells;
+  vtkSMPTools::For(0, input->GetNumberOfCells(), flag);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConnectedRegionsHelper::GatherCells(vtkIdType numCells,
+                                                 const vtkIdType *regionIds,
+                                                 const unsigned char *extracted,
+                                                 vtkIdType *cellIds)
+{
+  std::vector<vtkIdType> offsets(numCells + 1);
+  vtkOutputRegionsWorker gather;
+  gather.RegionIds = regionIds;
+  gather.Extracted = extracted;
+  gather.Offsets = &offsets[0];
+  gather.CellIds = NULL;
+  gather.PointRegions = NULL;
+  vtkSMPTools::For(0, numCells, gather);
+  vtkIdType numNewCells = vtkSMPTools::ExclusiveScan(
+    offsets.begin(), offsets.begin() + numCells, offsets.begin(),
+    static_cast<vtkIdType>(0));
+  gather.CellIds = cellIds;
+  vtkSMPTools::For(0, numCells, gather);
+  return numNewCells;
+}
+
+//----------------------------------------------------------------------------
+vtkIdTypeArray *vtkConnectedRegionsHelper::NewPointRegionIds(
+  vtkDataSet *input, const vtkIdType *regionIds, const vtkIdType *pointMap,
+  vtkIdType numNewPts)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkPrepareCellAccess(input);
+
+  vtkAtomicId *pointRegions = new vtkAtomicId[numPts];
+  vtkInitializeWorker init;
+  init.Values = pointRegions;
+  init.Value = VTK_ID_MAX;
+  vtkSMPTools::For(0, numPts, init);
+  vtkLowerPointsWorker lower;
+  lower.Input = input;
+  lower.Connectable = NULL;
+  lower.Regions = regionIds;
+  lower.Values = pointRegions;
+  vtkLowerPoints(lower, input->GetNumberOfCells());
+
+  vtkIdTypeArray *newRegionIds = vtkIdTypeArray::New();
+  newRegionIds->SetName("RegionId");
+  newRegionIds->SetNumberOfValues(numNewPts);
+  vtkOutputRegionsWorker scatter;
+  scatter.PointRegions = pointRegions;
+  scatter.PointMap = pointMap;
+  scatter.NewPointRegions = newRegionIds->GetPointer(0);
+  vtkSMPTools::For(0, numPts, scatter);
+  delete [] pointRegions;
+
+  return newRegionIds;
+}
+
+//----------------------------------------------------------------------------
+vtkIdTypeArray *vtkConnectedRegionsHelper::NewCellRegionIds(
+  const vtkIdType *regionIds, const vtkIdType *cellIds, vtkIdType numCells)
+{
+  vtkIdTypeArray *newRegionIds = vtkIdTypeArray::New();
+  newRegionIds->SetName("RegionId");
+  newRegionIds->SetNumberOfValues(numCells);
+  vtkGatherRegionsWorker gather;
+  gather.RegionIds = regionIds;
+  gather.CellIds = cellIds;
+  gather.NewRegionIds = newRegionIds->GetPointer(0);
+  vtkSMPTools::For(0, numCells, gather);
+  return newRegionIds;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConnectedRegionsHelper::FindClosestPoint(vtkDataSet *input,
+                                                      const double x[3])
+{
+  vtkClosestPointWorker closest;
+  closest.Input = input;
+  closest.X = x;
+  closest.Result.Id = -1;
+  vtkSMPTools::For(0, input->GetNumberOfPoints(), closest);
+  return closest.Result.Id;
+}
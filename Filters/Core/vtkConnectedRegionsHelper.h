@@ -0,0 +1,123 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConnectedRegionsHelper.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkConnectedRegionsHelper - A utility class labeling connected cells with threads
+// .SECTION Description
+//  This is a utility class used by the connectivity filters
+//  (vtkConnectivityFilter, vtkPolyDataConnectivityFilter) to find their
+//  regions with vtkSMPTools instead of a wave propagation.
+//
+//  The connected components of the cells are found with a concurrent
+//  union-find over the cells and their points: each connectable cell is
+//  joined with its points. vtkAtomic provides no compare-and-swap, so the
+//  roots are linked with atomic stores, always to a smaller id, and the
+//  passes over the cells are repeated (with path compression in between)
+//  until no link is missing. Each component ends up labeled with its
+//  smallest cell id, whatever the number of threads.
+//
+//  The regions are then numbered as by the serial traversal of the
+//  filters, which visits the cells in order: a cell that is not
+//  connectable (see ScalarConnectivity) starts its own region, and pulls
+//  into it the components it touches which were not visited yet.
+// .SECTION See Also
+// vtkConnectivityFilter vtkPolyDataConnectivityFilter vtkCellSubsetHelper
+
+#ifndef vtkConnectedRegionsHelper_h
+#define vtkConnectedRegionsHelper_h
+
+#include "vtkFiltersCoreModule.h" // For export macro
+#include "vtkType.h" // For vtkIdType
+
+class vtkDataArray;
+class vtkDataSet;
+class vtkIdTypeArray;
+
+class VTKFILTERSCORE_EXPORT vtkConnectedRegionsHelper
+{
+public:
+  // Description:
+  // Flag the cells of input that may be added to a region: those whose
+  // range of point scalars (first component) overlaps the given range, or
+  // lies within it when allPointsInRange is true. The scalars are compared
+  // as floats, as by the serial filters.
+  static void ClassifyCells(vtkDataSet *input, vtkDataArray *scalars,
+                            const double range[2], bool allPointsInRange,
+                            unsigned char *connectable);
+
+  // Description:
+  // Give each cell of input the number of its region (regionIds has one
+  // value per cell), and fill regionSizes with the number of cells of each
+  // region. The regions are numbered in the order of their first cell.
+  // All the cells are connectable when connectable is NULL. Return the
+  // number of regions.
+  static vtkIdType LabelRegions(vtkDataSet *input,
+                                const unsigned char *connectable,
+                                vtkIdType *regionIds,
+                                vtkIdTypeArray *regionSizes);
+
+  // Description:
+  // Give region number 0 to the cells reached from the flagged seed cells
+  // (seeds has one flag per cell), -1 to the others. The seeds are always
+  // reached, even if they are not connectable. Return the number of cells
+  // reached.
+  static vtkIdType LabelSeededRegion(vtkDataSet *input,
+                                     const unsigned char *connectable,
+                                     const unsigned char *seeds,
+                                     vtkIdType *regionIds);
+
+  // Description:
+  // Flag the cells of input using one of the flagged points.
+  static void FlagCellsUsingPoints(vtkDataSet *input,
+                                   const unsigned char *points,
+                                   unsigned char *cells);
+
+  // Description:
+  // Write into cellIds (which must hold one id per cell) the ids of the
+  // cells whose region is flagged in extracted (one flag per region), in
+  // increasing order. Return their number.
+  static vtkIdType GatherCells(vtkIdType numCells, const vtkIdType *regionIds,
+                               const unsigned char *extracted,
+                               vtkIdType *cellIds);
+
+  // Description:
+  // Return a new "RegionId" array giving each output point the smallest
+  // region number of the input cells using it, ignoring the cells with a
+  // negative region number. pointMap is the output id of each input point
+  // (-1 for the points which are not output).
+  static vtkIdTypeArray *NewPointRegionIds(vtkDataSet *input,
+                                           const vtkIdType *regionIds,
+                                           const vtkIdType *pointMap,
+                                           vtkIdType numNewPts);
+
+  // Description:
+  // Return a new "RegionId" array with the region number of the numCells
+  // extracted cells listed in cellIds.
+  static vtkIdTypeArray *NewCellRegionIds(const vtkIdType *regionIds,
+                                          const vtkIdType *cellIds,
+                                          vtkIdType numCells);
+
+  // Description:
+  // Return the id of the point of input closest to x (the smallest id
+  // among equally close points), or -1 when input has no points.
+  static vtkIdType FindClosestPoint(vtkDataSet *input, const double x[3]);
+
+private:
+  // Not implemented
+  vtkConnectedRegionsHelper();
+  vtkConnectedRegionsHelper(const vtkConnectedRegionsHelper&);
+  vtkConnectedRegionsHelper& operator=(const vtkConnectedRegionsHelper&);
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkConnectedRegionsHelper.h
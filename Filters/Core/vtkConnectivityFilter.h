@@ -40,9 +40,14 @@
 // connectivity will pull out all voxels "containing" the anatomical
 // structure. These voxels can then be contoured or processed by other
 // visualization filters.
+//
+// The regions may be found with several threads (see EnableSMP): a
+// concurrent union-find labels the components of the cells sharing points
+// instead of the wave propagation, then the regions are numbered and
+// extracted as by the serial execution.
 
 // .SECTION See Also
-// vtkPolyDataConnectivityFilter
+// vtkPolyDataConnectivityFilter vtkConnectedRegionsHelper
 
 #ifndef vtkConnectivityFilter_h
 #define vtkConnectivityFilter_h
@@ -152,6 +157,21 @@ public:
   vtkSetMacro(OutputPointsPrecision,int);
   vtkGetMacro(OutputPointsPrecision,int);
 
+  // Description:
+  // Turn on/off the use of vtkSMPTools to find the regions (with a
+  // concurrent union-find, see vtkConnectedRegionsHelper) and to copy the
+  // extracted cells, their points and their data with several threads. The
+  // regions, their numbers and sizes, and the extracted cells are the same
+  // as with the serial execution, for all extraction modes and with scalar
+  // connectivity. The differences are: the output only has the points used
+  // by the extracted cells (the serial execution also keeps those of the
+  // other regions when extracting the largest or specified regions), in
+  // the input order rather than in the traversal order; and the cell
+  // "RegionId" array has the values of the output cells. Off by default.
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+
 protected:
   vtkConnectivityFilter();
   ~vtkConnectivityFilter();
@@ -174,6 +194,12 @@ protected:
 
   void TraverseAndMark(vtkDataSet *input);
 
+  // Threaded implementation of RequestData(), see EnableSMP.
+  int ThreadedRequestData(vtkDataSet *input, int pointsDataType,
+                          vtkUnstructuredGrid *output);
+
+  bool EnableSMP;
+
 private:
   // used to support algorithm execution
   vtkFloatArray *CellScalars;
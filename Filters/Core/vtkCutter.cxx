@@ -26,24 +26,35 @@
 #include "vtkFloatArray.h"
 #include "vtkGenericCell.h"
 #include "vtkGridSynchronizedTemplates3D.h"
+#include "vtkHexahedron.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkImplicitFunction.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMarchingCubesTriangleCases.h"
 #include "vtkMergePoints.h"
-#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPlane.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkPyramid.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearSynchronizedTemplates.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkScratchPool.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkSynchronizedTemplates3D.h"
 #include "vtkSynchronizedTemplatesCutter3D.h"
+#include "vtkTetra.h"
+#include "vtkUnstructuredGrid.h"
 #include "vtkUnstructuredGridBase.h"
+#include "vtkVoxel.h"
+#include "vtkWedge.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkIncrementalPointLocator.h"
 #include "vtkTimerLog.h"
@@ -52,6 +63,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
 vtkStandardNewMacro(vtkCutter);
 vtkCxxSetObjectMacro(vtkCutter,CutFunction,vtkImplicitFunction);
@@ -69,11 +81,13 @@ vtkCutter::vtkCutter(vtkImplicitFunction *cf)
   this->Locator = NULL;
   this->GenerateTriangles = 1;
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->EnableSMP = false;
 
   this->SynchronizedTemplates3D = vtkSynchronizedTemplates3D::New();
   this->SynchronizedTemplatesCutter3D = vtkSynchronizedTemplatesCutter3D::New();
   this->GridSynchronizedTemplates = vtkGridSynchronizedTemplates3D::New();
   this->RectilinearSynchronizedTemplates = vtkRectilinearSynchronizedTemplates::New();
+  this->ScratchPool = vtkScratchPool::New();
 }
 
 //----------------------------------------------------------------------------
@@ -87,6 +101,7 @@ vtkCutter::~vtkCutter()
   this->SynchronizedTemplatesCutter3D->Delete();
   this->GridSynchronizedTemplates->Delete();
   this->RectilinearSynchronizedTemplates->Delete();
+  this->ScratchPool->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -587,7 +602,8 @@ void vtkCutter::DataSetCutter(vtkDataSet *input, vtkPolyData *output)
 
   // Compute some information for progress methods
   //
-  cell = vtkGenericCell::New();
+  vtkScratchPool::Scope scope(this->ScratchPool);
+  cell = this->ScratchPool->GetGenericCell();
   vtkIdType numCuts = numContours*numCells;
   vtkIdType progressInterval = numCuts/20 + 1;
   int cut=0;
@@ -703,7 +719,6 @@ void vtkCutter::DataSetCutter(vtkDataSet *input, vtkPolyData *output)
   // Update ourselves.  Because we don't know upfront how many verts, lines,
   // polys we've created, take care to reclaim memory.
   //
-  cell->Delete();
   cellScalars->Delete();
   cutScalars->Delete();
 
@@ -737,9 +752,397 @@ void vtkCutter::DataSetCutter(vtkDataSet *input, vtkPolyData *output)
   output->Squeeze();
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+#include "vtkArrayListTemplate.h" // For processing attribute data
+
+// A point of the cut surface referenced by a vertex of an output triangle.
+// The point lies on the input edge (P1,P2) at the parametric coordinate T,
+// as computed by vtkCell::Contour(). Key identifies the point for merging:
+// the contour value index and the sorted ids of the edge, or -1 and twice
+// the id of the input point hit when T is 0 or 1. Ref is the rank of the
+// reference in the serial traversal.
+struct vtkCutterPointRef
+{
+  vtkIdType Key[3];
+  vtkIdType Ref;
+  vtkIdType P1;
+  vtkIdType P2;
+  double T;
+
+  bool operator<(const vtkCutterPointRef &other) const
+  {
+    if ( this->Key[0] != other.Key[0] )
+      {
+      return this->Key[0] < other.Key[0];
+      }
+    if ( this->Key[1] != other.Key[1] )
+      {
+      return this->Key[1] < other.Key[1];
+      }
+    if ( this->Key[2] != other.Key[2] )
+      {
+      return this->Key[2] < other.Key[2];
+      }
+    return this->Ref < other.Ref;
+  }
+
+  bool IsSamePoint(const vtkCutterPointRef &other) const
+  {
+    return this->Key[0] == other.Key[0] && this->Key[1] == other.Key[1] &&
+      this->Key[2] == other.Key[2];
+  }
+};
+
+// Return whether the threaded cutter handles a cell type: the linear 3D
+// cells, and the 0D cells which are never cut.
+bool vtkCutterIsThreadedCellType(int cellType)
+{
+  switch (cellType)
+    {
+    case VTK_EMPTY_CELL:
+    case VTK_VERTEX:
+    case VTK_POLY_VERTEX:
+    case VTK_TETRA:
+    case VTK_HEXAHEDRON:
+    case VTK_VOXEL:
+    case VTK_WEDGE:
+    case VTK_PYRAMID:
+      return true;
+    }
+  return false;
+}
+
+// Evaluate the cut function at the points of the input.
+class vtkCutterFunctionWorker
+{
+public:
+  vtkDataSet *Input;
+  vtkImplicitFunction *Function;
+  double *Scalars;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    double x[3];
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Input->GetPoint(i, x);
+      this->Scalars[i] = this->Function->FunctionValue(x);
+      }
+  }
+};
+
+// Contour the linear 3D cells with their case tables, as their Contour()
+// method does. A work item is a (cell, contour value) pair, the items being
+// numbered in the order of the serial traversal. The first pass counts the
+// point references and the output triangles of each item (a degenerate
+// triangle is not output, but its points are, as with the serial locator).
+// Once the counts are summed into offsets, the second pass writes the
+// references and the triangles, whose connectivity holds reference ranks.
+class vtkCutterContourWorker
+{
+public:
+  vtkUnstructuredGrid *Input;
+  const double *Scalars;
+  const double *Values;
+  vtkIdType NumberOfCells;
+  int NumberOfContours;
+  int SortBy;
+
+  // Per item: counts, then offsets.
+  vtkIdType *RefOffsets;
+  vtkIdType *TriOffsets;
+
+  // Output of the second pass, NULL during the first one.
+  vtkCutterPointRef *Refs;
+  vtkIdType *Offsets;
+  vtkIdType *Connectivity;
+  vtkIdType *SourceCells;
+
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    static const int voxelMap[8] = { 0, 1, 3, 2, 4, 5, 7, 6 };
+    vtkIdList *cellPts = this->CellPoints.Local();
+    vtkCutterPointRef tri[3];
+    double s[8];
+
+    for (vtkIdType item = begin; item < end; ++item)
+      {
+      vtkIdType cellId;
+      int iter;
+      if ( this->SortBy == VTK_SORT_BY_CELL )
+        {
+        iter = static_cast<int>(item / this->NumberOfCells);
+        cellId = item % this->NumberOfCells;
+        }
+      else
+        {
+        cellId = item / this->NumberOfContours;
+        iter = static_cast<int>(item % this->NumberOfContours);
+        }
+      double value = this->Values[iter];
+
+      int *(*getEdge)(int) = NULL;
+      int numVerts = 0;
+      int cellType = this->Input->GetCellType(cellId);
+      switch (cellType)
+        {
+        case VTK_TETRA:
+          getEdge = vtkTetra::GetEdgeArray;
+          numVerts = 4;
+          break;
+        case VTK_HEXAHEDRON:
+          getEdge = vtkHexahedron::GetEdgeArray;
+          numVerts = 8;
+          break;
+        case VTK_VOXEL:
+          getEdge = vtkVoxel::GetEdgeArray;
+          numVerts = 8;
+          break;
+        case VTK_WEDGE:
+          getEdge = vtkWedge::GetEdgeArray;
+          numVerts = 6;
+          break;
+        case VTK_PYRAMID:
+          getEdge = vtkPyramid::GetEdgeArray;
+          numVerts = 5;
+          break;
+        }
+
+      vtkIdType numRefs = 0;
+      vtkIdType numTris = 0;
+      if ( numVerts > 0 )
+        {
+        this->Input->GetCellPoints(cellId, cellPts);
+        const vtkIdType *ids = cellPts->GetPointer(0);
+        int index = 0;
+        for (int i = 0; i < numVerts; ++i)
+          {
+          s[i] = this->Scalars[ids[i]];
+          }
+        for (int i = 0; i < numVerts; ++i)
+          {
+          int v = (cellType == VTK_VOXEL ? voxelMap[i] : i);
+          if ( s[v] >= value )
+            {
+            index |= (1 << i);
+            }
+          }
+
+        int *edge = NULL;
+        switch (cellType)
+          {
+          case VTK_TETRA:
+            edge = vtkTetra::GetTriangleCases(index);
+            break;
+          case VTK_HEXAHEDRON:
+            edge = vtkHexahedron::GetTriangleCases(index);
+            break;
+          case VTK_VOXEL:
+            edge = vtkMarchingCubesTriangleCases::GetCases()[index].edges;
+            break;
+          case VTK_WEDGE:
+            edge = vtkWedge::GetTriangleCases(index);
+            break;
+          case VTK_PYRAMID:
+            edge = vtkPyramid::GetTriangleCases(index);
+            break;
+          }
+
+        for ( ; edge[0] > -1; edge += 3 )
+          {
+          for (int i = 0; i < 3; ++i)
+            {
+            int *vert = getEdge(edge[i]);
+            int v1 = vert[0];
+            int v2 = vert[1];
+            double t;
+            if ( cellType == VTK_VOXEL )
+              {
+              t = (value - s[v1]) / (s[v2] - s[v1]);
+              }
+            else
+              {
+              // the preferred interpolation direction of Contour()
+              double deltaScalar = s[v2] - s[v1];
+              if ( deltaScalar <= 0 )
+                {
+                std::swap(v1, v2);
+                deltaScalar = -deltaScalar;
+                }
+              t = (deltaScalar == 0.0 ? 0.0 : (value - s[v1]) / deltaScalar);
+              }
+
+            vtkCutterPointRef &ref = tri[i];
+            ref.P1 = ids[v1];
+            ref.P2 = ids[v2];
+            ref.T = t;
+            if ( t == 0.0 || t == 1.0 )
+              {
+              ref.Key[0] = -1;
+              ref.Key[1] = ref.Key[2] = (t == 0.0 ? ref.P1 : ref.P2);
+              }
+            else
+              {
+              ref.Key[0] = iter;
+              ref.Key[1] = std::min(ref.P1, ref.P2);
+              ref.Key[2] = std::max(ref.P1, ref.P2);
+              }
+            }
+
+          bool degenerate = tri[0].IsSamePoint(tri[1]) ||
+            tri[0].IsSamePoint(tri[2]) || tri[1].IsSamePoint(tri[2]);
+          if ( this->Refs )
+            {
+            vtkIdType refId = this->RefOffsets[item] + numRefs;
+            vtkIdType triId = this->TriOffsets[item] + numTris;
+            for (int i = 0; i < 3; ++i)
+              {
+              tri[i].Ref = refId + i;
+              this->Refs[refId + i] = tri[i];
+              if ( !degenerate )
+                {
+                this->Connectivity[3 * triId + i] = refId + i;
+                }
+              }
+            if ( !degenerate )
+              {
+              this->Offsets[triId] = 3 * triId;
+              this->SourceCells[triId] = cellId;
+              }
+            }
+          numRefs += 3;
+          numTris += (degenerate ? 0 : 1);
+          }
+        }
+
+      if ( !this->Refs )
+        {
+        this->RefOffsets[item] = numRefs;
+        this->TriOffsets[item] = numTris;
+        }
+      }
+  }
+};
+
+// Merge the sorted references to the same point. The first pass flags the
+// first reference of each point (by reference rank). Once the flags are
+// summed, the points are numbered in the order of their first reference as
+// with the serial locator, and the second pass maps each reference to its
+// point and each point to its first reference (sorted position).
+class vtkCutterMergePointsWorker
+{
+public:
+  const vtkCutterPointRef *Refs;
+  vtkIdType *FirstRefs;
+  vtkIdType *PointIds;
+  vtkIdType *PointRefs;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      if ( !this->PointIds )
+        {
+        this->FirstRefs[this->Refs[i].Ref] =
+          (i == 0 || !this->Refs[i].IsSamePoint(this->Refs[i - 1]));
+        continue;
+        }
+      vtkIdType first = i;
+      while ( first > 0 && this->Refs[first - 1].IsSamePoint(this->Refs[i]) )
+        {
+        --first;
+        }
+      vtkIdType ptId = this->FirstRefs[this->Refs[first].Ref];
+      this->PointIds[this->Refs[i].Ref] = ptId;
+      if ( first == i )
+        {
+        this->PointRefs[ptId] = i;
+        }
+      }
+  }
+};
+
+// Replace the reference ranks of the triangles by their point ids.
+class vtkCutterRenumberWorker
+{
+public:
+  const vtkIdType *PointIds;
+  vtkIdType *Connectivity;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Connectivity[i] = this->PointIds[this->Connectivity[i]];
+      }
+  }
+};
+
+// Interpolate the output points and their data from their first reference.
+// The cut scalars, which are unnamed, are interpolated separately.
+class vtkCutterPointsWorker
+{
+public:
+  vtkDataSet *Input;
+  const vtkCutterPointRef *Refs;
+  const vtkIdType *PointRefs;
+  vtkPoints *NewPoints;
+  ArrayList *Arrays;
+  const double *Scalars;
+  double *CutScalars;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    double x1[3], x2[3], x[3];
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      const vtkCutterPointRef &ref = this->Refs[this->PointRefs[ptId]];
+      this->Input->GetPoint(ref.P1, x1);
+      this->Input->GetPoint(ref.P2, x2);
+      for (int j = 0; j < 3; ++j)
+        {
+        x[j] = x1[j] + ref.T * (x2[j] - x1[j]);
+        }
+      this->NewPoints->SetPoint(ptId, x);
+      this->Arrays->InterpolateEdge(ref.P1, ref.P2, ref.T, ptId);
+      if ( this->CutScalars )
+        {
+        double s1 = this->Scalars[ref.P1];
+        this->CutScalars[ptId] = s1 + ref.T * (this->Scalars[ref.P2] - s1);
+        }
+      }
+  }
+};
+
+// Copy the data of the cut cells to their triangles.
+class vtkCutterCellDataWorker
+{
+public:
+  const vtkIdType *SourceCells;
+  ArrayList *Arrays;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Arrays->Copy(this->SourceCells[i], i);
+      }
+  }
+};
+}
+
 //----------------------------------------------------------------------------
 void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
 {
+  if ( this->EnableSMP && this->ThreadedUnstructuredGridCutter(input, output) )
+    {
+    return;
+    }
+
   vtkIdType i;
   int iter;
   vtkDoubleArray *cellScalars;
@@ -843,7 +1246,8 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
 
   vtkSmartPointer<vtkCellIterator> cellIter =
       vtkSmartPointer<vtkCellIterator>::Take(input->NewCellIterator());
-  vtkNew<vtkGenericCell> cell;
+  vtkScratchPool::Scope scope(this->ScratchPool);
+  vtkGenericCell *cell = this->ScratchPool->GetGenericCell();
   vtkIdList *pointIdList;
   double *scalarArrayPtr = cutScalars->GetPointer(0);
   double tempScalar;
@@ -857,6 +1261,8 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
     // Loop over all contour values.  Then for each contour value,
     // loop over all cells.
     //
+    unsigned char cellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+    vtkCutter::GetCellTypeDimensions(cellTypeDimensions);
     for (iter=0; iter < numContours && !abortExecute; iter++)
       {
       // Loop over all cells; get scalar values for all cell points
@@ -873,6 +1279,15 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
           abortExecute = this->GetAbortExecute();
           }
 
+        // Skip the 0d cells (points), which cannot be cut, as when sorting
+        // by value.
+        int cellType = cellIter->GetCellType();
+        if (cellType >= VTK_NUMBER_OF_CELL_TYPES ||
+            cellTypeDimensions[cellType] == 0)
+          {
+          continue;
+          }
+
         pointIdList = cellIter->GetPointIds();
         numCellPts = pointIdList->GetNumberOfIds();
         ptIds = pointIdList->GetPointer(0);
@@ -887,32 +1302,15 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
           range[1] = std::max(range[1], tempScalar);
           } // for all points in this cell
 
-        int needCell = 0;
-        double val = this->ContourValues->GetValue(iter);
-        if (val >= range[0] && val <= range[1])
-          {
-          needCell = 1;
-          }
-
-        if (needCell)
+        // Contour the cell with the current value only.
+        value = this->ContourValues->GetValue(iter);
+        if (value >= range[0] && value <= range[1])
           {
-          cellIter->GetCell(cell.GetPointer());
+          cellIter->GetCell(cell);
           cellIds = cell->GetPointIds();
           cutScalars->GetTuples(cellIds,cellScalars);
-          // Loop over all contour values.
-          for (iter=0; iter < numContours && !abortExecute; iter++)
-            {
-            if ( !(++cut % progressInterval) )
-              {
-              vtkDebugMacro(<<"Cutting #" << cut);
-              this->UpdateProgress (static_cast<double>(cut)/numCuts);
-              abortExecute = this->GetAbortExecute();
-              }
-            value = this->ContourValues->GetValue(iter);
-
-            helper.Contour(cell.GetPointer(), value, cellScalars,
-                           cellIter->GetCellId());
-            }
+          helper.Contour(cell, value, cellScalars,
+                         cellIter->GetCellId());
           }
 
         } // for all cells
@@ -994,7 +1392,7 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
         if (needCell)
           {
           // Fetch the full cell -- most expensive.
-          cellIter->GetCell(cell.GetPointer());
+          cellIter->GetCell(cell);
           cutScalars->GetTuples(pointIdList, cellScalars);
           // Loop over all contour values.
           for (contourIter = contourValues; contourIter != contourValuesEnd;
@@ -1006,7 +1404,7 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
               this->UpdateProgress (static_cast<double>(cut)/numCuts);
               abortExecute = this->GetAbortExecute();
               }
-            helper.Contour(cell.GetPointer(), *contourIter, cellScalars,
+            helper.Contour(cell, *contourIter, cellScalars,
                            cellIter->GetCellId());
             } // for all contour values
           } // if need cell
@@ -1050,6 +1448,198 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
   output->Squeeze();
 }
 
+//----------------------------------------------------------------------------
+// The threaded version of UnstructuredGridCutter(), see EnableSMP. The cells
+// are contoured in two passes (counting the triangles of each cell and
+// contour value, then writing them once the counts are summed into offsets).
+// The triangles reference their points by the input edges they lie on, and
+// the references to the same point are merged by sorting them. Return 0,
+// doing nothing, if the input is not handled.
+int vtkCutter::ThreadedUnstructuredGridCutter(vtkDataSet *dataSetInput,
+                                              vtkPolyData *output)
+{
+  vtkUnstructuredGrid *input = vtkUnstructuredGrid::SafeDownCast(dataSetInput);
+  if ( !input || !this->GenerateTriangles )
+    {
+    return 0;
+    }
+  // Only the data arrays are interpolated concurrently.
+  vtkDataSetAttributes *inData[2] = { input->GetPointData(),
+                                      input->GetCellData() };
+  for (int d = 0; d < 2; ++d)
+    {
+    for (int j = 0; j < inData[d]->GetNumberOfArrays(); ++j)
+      {
+      if ( !inData[d]->GetArray(j) )
+        {
+        return 0;
+        }
+      }
+    }
+  vtkIdType i;
+  vtkIdType numCells = input->GetNumberOfCells();
+  for (i = 0; i < numCells; ++i)
+    {
+    if ( !vtkCutterIsThreadedCellType(input->GetCellType(i)) )
+      {
+      return 0;
+      }
+    }
+
+  vtkIdType numPts = input->GetNumberOfPoints();
+  int numContours = this->ContourValues->GetNumberOfContours();
+  vtkPointData *inPD;
+  vtkPointData *outPD = output->GetPointData();
+  vtkCellData *inCD = input->GetCellData();
+  vtkCellData *outCD = output->GetCellData();
+
+  // Loop over all points evaluating scalar function at each point. The first
+  // evaluation is serial, for the functions updating their state then.
+  vtkDoubleArray *cutScalars = vtkDoubleArray::New();
+  cutScalars->SetNumberOfTuples(numPts);
+  cutScalars->SetValue(0, this->CutFunction->FunctionValue(input->GetPoint(0)));
+  vtkCutterFunctionWorker evaluate;
+  evaluate.Input = input;
+  evaluate.Function = this->CutFunction;
+  evaluate.Scalars = cutScalars->GetPointer(0);
+  vtkSMPTools::For(1, numPts, evaluate);
+  this->UpdateProgress(0.25);
+
+  // Count, then generate the triangles of each cell and contour value.
+  vtkIdType numItems = numCells * numContours;
+  std::vector<vtkIdType> refOffsets(numItems + 1, 0);
+  std::vector<vtkIdType> triOffsets(numItems + 1, 0);
+  vtkCutterContourWorker contour;
+  contour.Input = input;
+  contour.Scalars = cutScalars->GetPointer(0);
+  contour.Values = this->ContourValues->GetValues();
+  contour.NumberOfCells = numCells;
+  contour.NumberOfContours = numContours;
+  contour.SortBy = this->SortBy;
+  contour.RefOffsets = &refOffsets[0];
+  contour.TriOffsets = &triOffsets[0];
+  contour.Refs = NULL;
+  contour.Offsets = NULL;
+  contour.Connectivity = NULL;
+  contour.SourceCells = NULL;
+  vtkSMPTools::For(0, numItems, contour);
+
+  vtkIdType numRefs = vtkSMPTools::ExclusiveScan(refOffsets.begin(),
+    refOffsets.begin() + numItems, refOffsets.begin(), vtkIdType(0));
+  vtkIdType numTris = vtkSMPTools::ExclusiveScan(triOffsets.begin(),
+    triOffsets.begin() + numItems, triOffsets.begin(), vtkIdType(0));
+
+  vtkCellArray *newPolys = vtkCellArray::New();
+  newPolys->AllocateExact(numTris, 3 * numTris);
+  vtkIdType *offsets = static_cast<vtkIdTypeArray*>(
+    newPolys->GetOffsetsArray())->GetPointer(0);
+  offsets[numTris] = 3 * numTris;
+  std::vector<vtkCutterPointRef> refs(numRefs + 1);
+  std::vector<vtkIdType> sourceCells(numTris + 1);
+  contour.Refs = &refs[0];
+  contour.Offsets = offsets;
+  contour.Connectivity = static_cast<vtkIdTypeArray*>(
+    newPolys->GetConnectivityArray())->GetPointer(0);
+  contour.SourceCells = &sourceCells[0];
+  vtkSMPTools::For(0, numItems, contour);
+  this->UpdateProgress(0.5);
+
+  // Merge the points referenced several times.
+  vtkSMPTools::Sort(refs.begin(), refs.begin() + numRefs);
+  std::vector<vtkIdType> firstRefs(numRefs + 1, 0);
+  std::vector<vtkIdType> pointIds(numRefs + 1);
+  std::vector<vtkIdType> pointRefs(numRefs + 1);
+  vtkCutterMergePointsWorker merge;
+  merge.Refs = &refs[0];
+  merge.FirstRefs = &firstRefs[0];
+  merge.PointIds = NULL;
+  merge.PointRefs = &pointRefs[0];
+  vtkSMPTools::For(0, numRefs, merge);
+  vtkIdType numNewPts = vtkSMPTools::ExclusiveScan(firstRefs.begin(),
+    firstRefs.begin() + numRefs, firstRefs.begin(), vtkIdType(0));
+  merge.PointIds = &pointIds[0];
+  vtkSMPTools::For(0, numRefs, merge);
+
+  vtkCutterRenumberWorker renumber;
+  renumber.PointIds = &pointIds[0];
+  renumber.Connectivity = contour.Connectivity;
+  vtkSMPTools::For(0, 3 * numTris, renumber);
+  this->UpdateProgress(0.75);
+
+  // Interpolate the points and their data, and copy the cell data.
+  vtkPoints *newPoints = vtkPoints::New();
+  // set precision for the points in the output
+  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+    {
+    newPoints->SetDataType(input->GetPoints()->GetDataType());
+    }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+    {
+    newPoints->SetDataType(VTK_FLOAT);
+    }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+    {
+    newPoints->SetDataType(VTK_DOUBLE);
+    }
+  newPoints->SetNumberOfPoints(numNewPts);
+
+  // Interpolate data along edge. If generating cut scalars, do necessary setup
+  if ( this->GenerateCutScalars )
+    {
+    inPD = vtkPointData::New();
+    inPD->ShallowCopy(input->GetPointData());//copies original attributes
+    inPD->SetScalars(cutScalars);
+    }
+  else
+    {
+    inPD = input->GetPointData();
+    }
+  outPD->InterpolateAllocate(inPD, numNewPts);
+  ArrayList pointArrays;
+  pointArrays.AddArrays(numNewPts, inPD, outPD);
+  vtkCutterPointsWorker points;
+  points.Input = input;
+  points.Refs = &refs[0];
+  points.PointRefs = &pointRefs[0];
+  points.NewPoints = newPoints;
+  points.Arrays = &pointArrays;
+  points.Scalars = cutScalars->GetPointer(0);
+  points.CutScalars = NULL;
+  vtkDoubleArray *newScalars = vtkDoubleArray::SafeDownCast(
+    this->GenerateCutScalars ? outPD->GetScalars() : NULL);
+  if ( newScalars )
+    {
+    newScalars->SetNumberOfTuples(numNewPts);
+    points.CutScalars = newScalars->GetPointer(0);
+    }
+  vtkSMPTools::For(0, numNewPts, points);
+
+  outCD->CopyAllocate(inCD, numTris);
+  ArrayList cellArrays;
+  cellArrays.AddArrays(numTris, inCD, outCD);
+  vtkCutterCellDataWorker cellData;
+  cellData.SourceCells = &sourceCells[0];
+  cellData.Arrays = &cellArrays;
+  vtkSMPTools::For(0, numTris, cellData);
+
+  cutScalars->Delete();
+  if ( this->GenerateCutScalars )
+    {
+    inPD->Delete();
+    }
+
+  output->SetPoints(newPoints);
+  newPoints->Delete();
+
+  if (newPolys->GetNumberOfCells())
+    {
+    output->SetPolys(newPolys);
+    }
+  newPolys->Delete();
+
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 // Specify a spatial locator for merging points. By default,
 // an instance of vtkMergePoints is used.
@@ -1105,4 +1695,6 @@ void vtkCutter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Precision of the output points: "
      << this->OutputPointsPrecision << "\n";
+
+  os << indent << "Enable SMP: " << (this->EnableSMP ? "On\n" : "Off\n");
 }
@@ -56,6 +56,7 @@ class vtkSynchronizedTemplates3D;
 class vtkSynchronizedTemplatesCutter3D;
 class vtkGridSynchronizedTemplates3D;
 class vtkRectilinearSynchronizedTemplates;
+class vtkScratchPool;
 
 class VTKFILTERSCORE_EXPORT vtkCutter : public vtkPolyDataAlgorithm
 {
@@ -190,6 +191,24 @@ public:
   vtkSetClampMacro(OutputPointsPrecision, int, SINGLE_PRECISION, DEFAULT_PRECISION);
   vtkGetMacro(OutputPointsPrecision, int);
 
+  // Description:
+  // Turn on/off the use of vtkSMPTools to cut a vtkUnstructuredGrid made of
+  // linear 3D cells (tetrahedra, hexahedra, voxels, wedges and pyramids,
+  // 0D cells being ignored) with several threads when GenerateTriangles is
+  // on. The cut function is evaluated at the points concurrently, and the
+  // cells are contoured with their case tables. The output points are
+  // merged by the input edge they lie on (or the input point they hit)
+  // instead of the locator, so that the output does not depend on the
+  // number of threads; sorted by value, the triangles are the ones of the
+  // serial execution, without the duplicate points the locator leaves when
+  // two cells compute the same edge point with different rounding errors.
+  // Other inputs are cut serially, as are grids with string or other
+  // non-numeric point or cell arrays. The cut function must support
+  // concurrent evaluations. Off by default.
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+
 protected:
   vtkCutter(vtkImplicitFunction *cf=NULL);
   ~vtkCutter();
@@ -198,6 +217,8 @@ protected:
   virtual int RequestUpdateExtent(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
   virtual int FillInputPortInformation(int port, vtkInformation *info);
   void UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output);
+  // Threaded implementation of UnstructuredGridCutter(), see EnableSMP.
+  int ThreadedUnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output);
   void DataSetCutter(vtkDataSet *input, vtkPolyData *output);
   void StructuredPointsCutter(vtkDataSet *, vtkPolyData *,
                               vtkInformation *, vtkInformationVector **,
@@ -213,10 +234,12 @@ protected:
   vtkRectilinearSynchronizedTemplates *RectilinearSynchronizedTemplates;
 
   vtkIncrementalPointLocator *Locator;
+  vtkScratchPool *ScratchPool; // cells reused from one execution to the next
   int SortBy;
   vtkContourValues *ContourValues;
   int GenerateCutScalars;
   int OutputPointsPrecision;
+  bool EnableSMP;
 private:
   vtkCutter(const vtkCutter&);  // Not implemented.
   void operator=(const vtkCutter&);  // Not implemented.
@@ -23,12 +23,18 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkStructuredGrid.h"
+#include "vtkCellData.h"
 #include "vtkFloatArray.h"
+#include "vtkIntArray.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkMarchingCubesTriangleCases.h"
 #include "vtkSMPTools.h"
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 vtkStandardNewMacro(vtkFlyingEdges3D);
 
@@ -98,6 +104,15 @@ public:
   unsigned char *XCases;
   vtkIdType *EdgeMetaData;
 
+  // Algorithm-derived data when all the contour values are processed
+  // together (see vtkFlyingEdges3D::FuseContours). Levels gives for each
+  // point the number of SortedValues its scalar reaches, so that a point is
+  // above the value of rank k when its level is greater than k: the x-edge
+  // cases of all the values are derived from it. EdgeMetaData then holds
+  // the edge metadata of each value, value after value in rank order.
+  unsigned char *Levels;
+  std::vector<double> SortedValues;
+
   // Internal variables used by the various algorithm methods. Interfaces VTK
   // image data in a form more convenient to the algorithm.
   T        *Scalars;
@@ -116,10 +131,21 @@ public:
   int Max2;
   int Inc2;
 
+  // Explicit geometry of structured and rectilinear grids (NULL for image
+  // data, whose geometry is given by Origin and Spacing): the points of the
+  // structured grid, or the coordinates of the rectilinear grid along each
+  // axis. A point ijk of the processed extent has the index ijk+GridOffsets
+  // in the extent of the grid, whose point increments are GridIncs.
+  vtkDataArray *GridPoints;
+  vtkDataArray *GridCoordinates[3];
+  vtkIdType GridOffsets[3];
+  vtkIdType GridIncs[3];
+
   // Output data. Threads write to partitioned memory.
   T         *NewScalars;
   vtkIdType *NewTris;
   float     *NewPoints;
+  double    *NewDoublePoints; //replaces NewPoints for double grid geometry
   float     *NewGradients;
   float     *NewNormals;
   bool       NeedGradients;
@@ -129,6 +155,52 @@ public:
   // Setup algorithm
   vtkFlyingEdges3DAlgorithm();
 
+  // Indicate whether the point coordinates are given explicitly.
+  bool HasGridGeometry()
+    {return this->GridPoints != NULL || this->GridCoordinates[0] != NULL;}
+
+  // Get the coordinates of the point ijk from the grid geometry.
+  void GetGridPoint(const vtkIdType ijk[3], double x[3])
+    {
+    if ( this->GridPoints )
+      {
+      this->GridPoints->GetTuple((ijk[0]+this->GridOffsets[0])*this->GridIncs[0] +
+                                 (ijk[1]+this->GridOffsets[1])*this->GridIncs[1] +
+                                 (ijk[2]+this->GridOffsets[2])*this->GridIncs[2], x);
+      }
+    else
+      {
+      for (int i=0; i < 3; ++i)
+        {
+        x[i] = this->GridCoordinates[i]->GetComponent(ijk[i]+this->GridOffsets[i],0);
+        }
+      }
+    }
+
+  // Store the output point vId interpolated between x0 and x1.
+  void InterpolatePoint(vtkIdType vId, double t,
+                        const double x0[3], const double x1[3])
+    {
+    if ( this->NewDoublePoints )
+      {
+      double *x = this->NewDoublePoints + 3*vId;
+      x[0] = x0[0] + t*(x1[0]-x0[0]);
+      x[1] = x0[1] + t*(x1[1]-x0[1]);
+      x[2] = x0[2] + t*(x1[2]-x0[2]);
+      }
+    else
+      {
+      float *x = this->NewPoints + 3*vId;
+      x[0] = x0[0] + t*(x1[0]-x0[0]);
+      x[1] = x0[1] + t*(x1[1]-x0[1]);
+      x[2] = x0[2] + t*(x1[2]-x0[2]);
+      }
+    }
+
+  // Transform a gradient computed in index space (i.e., with a unit
+  // spacing) into world space with the Jacobian of the grid geometry.
+  void TransformGradient(vtkIdType ijk[3], float g[3]);
+
   // Adjust the origin to the lower-left corner of the volume (if necessary)
   void AdjustOrigin()
     {
@@ -142,15 +214,81 @@ public:
   void ProcessYZEdges(vtkIdType row, vtkIdType slice); //PASS 2
   void GenerateOutput(double value, T* inPtr, vtkIdType row, vtkIdType slice);//PASS 3
 
+  // The same passes when all the contour values are processed together.
+  // PASS 1 computes the levels of the points and the x-edge metadata of all
+  // values, PASS 2 and PASS 4 process one value on the voxel x-row bounded
+  // by the given x-edge rows and metadata.
+  void ProcessXEdgeLevels(T const * const inPtr, vtkIdType row, vtkIdType slice);
+  template <class TRows>
+  void ProcessYZEdges(const TRows &rows, vtkIdType *eMD[4],
+                      vtkIdType row, vtkIdType slice);
+  template <class TRows>
+  void GenerateOutput(double value, T* inPtr, const TRows &rows,
+                      vtkIdType *eMD[4], vtkIdType row, vtkIdType slice);
+
+  // The x-edge cases of the four x-edge rows bounding a voxel x-row, as
+  // stored in XCases by PASS 1.
+  struct XCaseRows
+    {
+    const unsigned char *Rows[4];
+    unsigned char GetCase(int r, vtkIdType i) const
+      {return this->Rows[r][i];}
+    };
+
+  // The x-edge cases of the four x-edge rows bounding a voxel x-row for the
+  // contour value of rank Rank, derived from the point levels.
+  struct LevelRows
+    {
+    const unsigned char *Rows[4];
+    unsigned char Rank;
+    unsigned char GetCase(int r, vtkIdType i) const
+      {
+      return (this->Rows[r][i] > this->Rank ? LeftAbove : Below) |
+        (this->Rows[r][i+1] > this->Rank ? RightAbove : Below);
+      }
+    };
+
+  // Locate the x-edge rows and their metadata bounding a voxel x-row. The
+  // metadata start at eMD0, the one of the contour value for fused contours.
+  void GetEdgeMetaData(vtkIdType *eMD0, vtkIdType row, vtkIdType slice,
+                       vtkIdType *eMD[4])
+    {
+    eMD[0] = eMD0 + (slice*this->Dims[1] + row)*6; //this x-edge
+    eMD[1] = eMD[0] + 6; //x-edge in +y direction
+    eMD[2] = eMD[0] + this->Dims[1]*6; //x-edge in +z direction
+    eMD[3] = eMD[2] + 6; //x-edge in +y+z direction
+    }
+  XCaseRows GetXCaseRows(vtkIdType row, vtkIdType slice)
+    {
+    XCaseRows rows;
+    rows.Rows[0] = this->XCases + slice*this->SliceOffset + row*(this->Dims[0]-1);
+    rows.Rows[1] = rows.Rows[0] + this->Dims[0]-1;
+    rows.Rows[2] = rows.Rows[0] + this->SliceOffset;
+    rows.Rows[3] = rows.Rows[2] + this->Dims[0]-1;
+    return rows;
+    }
+  LevelRows GetLevelRows(int rank, vtkIdType row, vtkIdType slice)
+    {
+    LevelRows rows;
+    rows.Rows[0] = this->Levels + (slice*this->Dims[1] + row)*this->Dims[0];
+    rows.Rows[1] = rows.Rows[0] + this->Dims[0];
+    rows.Rows[2] = rows.Rows[0] + this->Dims[1]*this->Dims[0];
+    rows.Rows[3] = rows.Rows[2] + this->Dims[0];
+    rows.Rank = static_cast<unsigned char>(rank);
+    return rows;
+    }
+
   // Place holder for now in case fancy bit fiddling is needed later.
   void SetXEdge(unsigned char *ePtr, unsigned char edgeCase)
     {*ePtr = edgeCase;}
 
-  // Given the four x-edge cases defining this voxel, return the voxel case
-  // number.
-  unsigned char GetEdgeCase(unsigned char *ePtr[4])
+  // Given the four x-edge rows bounding a voxel x-row, return the case
+  // number of the ith voxel.
+  template <class TRows>
+  unsigned char GetEdgeCase(const TRows &rows, vtkIdType i)
     {
-    return (*(ePtr[0]) | ((*(ePtr[1]))<<2) | ((*(ePtr[2]))<<4) | ((*(ePtr[3]))<<6));
+    return (rows.GetCase(0,i) | (rows.GetCase(1,i)<<2) |
+            (rows.GetCase(2,i)<<4) | (rows.GetCase(3,i)<<6));
     }
 
   // Return the number of contouring primitives for a particular edge case number.
@@ -197,6 +335,10 @@ public:
         g[0] = 0.5*( (*s0_start - *s0_end) / this->Spacing[0] );
         g[1] = 0.5*( (*s1_start - *s1_end) / this->Spacing[1] );
         g[2] = 0.5*( (*s2_start - *s2_end) / this->Spacing[2] );
+        if ( this->HasGridGeometry() )
+          {
+          this->TransformGradient(ijk, g);
+          }
         }
       else
         {
@@ -211,20 +353,16 @@ public:
 
   // Interpolate along a voxel axes edge.
   void InterpolateAxesEdge(double t, unsigned char loc,
-                           float x0[3],
+                           double x0[3],
                            T const * const s,
                            const int incs[3],
-                           float x1[3],
+                           double x1[3],
                            vtkIdType vId,
                            vtkIdType ijk0[3],
                            vtkIdType ijk1[3],
                            float g0[3])
     {
-
-      float *x = this->NewPoints + 3*vId;
-      x[0] = x0[0] + t*(x1[0]-x0[0]);
-      x[1] = x0[1] + t*(x1[1]-x0[1]);
-      x[2] = x0[2] + t*(x1[2]-x0[2]);
+      this->InterpolatePoint(vId, t, x0, x1);
 
       if ( this->NeedGradients )
         {
@@ -270,7 +408,7 @@ public:
   // neighborhood information (e.g., gradients).
   void InterpolateEdge(double value, vtkIdType ijk[3],
                        T const * const s, const int incs[3],
-                       float x[3],
+                       double x[3],
                        unsigned char edgeNum,
                        unsigned char const* const edgeUses,
                        vtkIdType *eIds);
@@ -278,14 +416,15 @@ public:
   // Produce the output points on the voxel axes for this voxel cell.
   void GeneratePoints(double value, unsigned char loc, vtkIdType ijk[3],
                       T const * const sPtr, const int incs[3],
-                      float x[3], unsigned char const * const edgeUses,
+                      double x[3], unsigned char const * const edgeUses,
                       vtkIdType *eIds);
 
   // Helper function to set up the point ids on voxel edges.
-  unsigned char InitVoxelIds(unsigned char *ePtr[4], vtkIdType *eMD[4],
+  template <class TRows>
+  unsigned char InitVoxelIds(const TRows &rows, vtkIdType i, vtkIdType *eMD[4],
                              vtkIdType *eIds)
     {
-      unsigned char eCase = GetEdgeCase(ePtr);
+      unsigned char eCase = GetEdgeCase(rows,i);
       eIds[0] = eMD[0][0]; //x-edges
       eIds[1] = eMD[1][0];
       eIds[2] = eMD[2][0];
@@ -389,13 +528,99 @@ public:
         }
     };
 
+  // The passes processing all the contour values together. A volume x-row
+  // is read once, then its voxel rows are processed for every value.
+  template <class TT> class FusedPass1
+    {
+    public:
+      vtkFlyingEdges3DAlgorithm<TT> *Algo;
+      FusedPass1(vtkFlyingEdges3DAlgorithm<TT> *algo)
+        {this->Algo = algo;}
+      void  operator()(vtkIdType slice, vtkIdType end)
+        {
+        vtkIdType row;
+        TT *rowPtr, *slicePtr = this->Algo->Scalars + slice*this->Algo->Inc2;
+        for ( ; slice < end; ++slice )
+          {
+          for (row=0, rowPtr=slicePtr; row < this->Algo->Dims[1]; ++row)
+            {
+            this->Algo->ProcessXEdgeLevels(rowPtr, row, slice);
+            rowPtr += this->Algo->Inc1;
+            }//for all rows in this slice
+          slicePtr += this->Algo->Inc2;
+          }//for all slices in this batch
+        }
+    };
+  template <class TT> class FusedPass2
+    {
+    public:
+      FusedPass2(vtkFlyingEdges3DAlgorithm<TT> *algo)
+        {this->Algo = algo;}
+      vtkFlyingEdges3DAlgorithm<TT> *Algo;
+      void  operator()(vtkIdType slice, vtkIdType end)
+        {
+        int numValues = static_cast<int>(this->Algo->SortedValues.size());
+        vtkIdType valueOffset = 6*this->Algo->NumberOfEdges;
+        vtkIdType *eMD[4];
+        for ( ; slice < end; ++slice)
+          {
+          for ( vtkIdType row=0; row < (this->Algo->Dims[1]-1); ++row)
+            {
+            for (int k=0; k < numValues; ++k)
+              {
+              this->Algo->GetEdgeMetaData(
+                this->Algo->EdgeMetaData + k*valueOffset, row, slice, eMD);
+              this->Algo->ProcessYZEdges(
+                this->Algo->GetLevelRows(k, row, slice), eMD, row, slice);
+              }//for all contour values
+            }//for all rows in this slice
+          }//for all slices in this batch
+        }
+    };
+  template <class TT> class FusedPass4
+    {
+    public:
+      FusedPass4(vtkFlyingEdges3DAlgorithm<TT> *algo)
+        {this->Algo = algo;}
+      vtkFlyingEdges3DAlgorithm<TT> *Algo;
+      void  operator()(vtkIdType slice, vtkIdType end)
+        {
+        int numValues = static_cast<int>(this->Algo->SortedValues.size());
+        vtkIdType valueOffset = 6*this->Algo->NumberOfEdges;
+        vtkIdType row, *eMD[4];
+        TT *rowPtr, *slicePtr = this->Algo->Scalars + slice*this->Algo->Inc2;
+        for ( ; slice < end; ++slice )
+          {
+          for (row=0, rowPtr=slicePtr; row < this->Algo->Dims[1]-1; ++row)
+            {
+            for (int k=0; k < numValues; ++k)
+              {
+              this->Algo->GetEdgeMetaData(
+                this->Algo->EdgeMetaData + k*valueOffset, row, slice, eMD);
+              this->Algo->GenerateOutput(this->Algo->SortedValues[k], rowPtr,
+                this->Algo->GetLevelRows(k, row, slice), eMD, row, slice);
+              }//for all contour values
+            rowPtr += this->Algo->Inc1;
+            }//for all rows in this slice
+          slicePtr += this->Algo->Inc2;
+          }//for all slices in this batch
+        }
+    };
+
   // Interface between VTK and templated functions
-  static void Contour(vtkFlyingEdges3D *self, vtkImageData *input,
+  static void Contour(vtkFlyingEdges3D *self, vtkDataSet *input,
                       vtkDataArray *inScalars,
                       int extent[6], vtkIdType *incs, T *scalars,
                       vtkPolyData *output, vtkPoints *newPts, vtkCellArray *newTris,
                       vtkDataArray *newScalars,vtkFloatArray *newNormals,
-                      vtkFloatArray *newGradients);
+                      vtkFloatArray *newGradients, vtkIntArray *newIndices);
+
+  // Run the passes of the algorithm for all the contour values together.
+  void FusedContour(vtkFlyingEdges3D *self, vtkDataSet *input,
+                    vtkDataArray *inScalars, vtkPolyData *output,
+                    vtkPoints *newPts, vtkCellArray *newTris,
+                    vtkDataArray *newScalars, vtkFloatArray *newNormals,
+                    vtkFloatArray *newGradients, vtkIntArray *newIndices);
 };
 
 //----------------------------------------------------------------------------
@@ -421,9 +646,10 @@ VertOffsets[8][3] = {{0,0,0}, {1,0,0}, {0,1,0}, {1,1,0},
 // marching cubes case table. Some of this code is borrowed shamelessly from
 // vtkVoxel::Contour() method.
 template <class T> vtkFlyingEdges3DAlgorithm<T>::
-vtkFlyingEdges3DAlgorithm():XCases(NULL),EdgeMetaData(NULL),NewScalars(NULL),
-                            NewTris(NULL),NewPoints(NULL),NewGradients(NULL),
-                            NewNormals(NULL)
+vtkFlyingEdges3DAlgorithm():XCases(NULL),EdgeMetaData(NULL),Levels(NULL),
+                            GridPoints(NULL),NewScalars(NULL),
+                            NewTris(NULL),NewPoints(NULL),NewDoublePoints(NULL),
+                            NewGradients(NULL),NewNormals(NULL)
 {
   int i, j, k, l, ii, eCase, index, numTris;
   static int vertMap[8] = {0,1,3,2,4,5,7,6};
@@ -432,6 +658,9 @@ vtkFlyingEdges3DAlgorithm():XCases(NULL),EdgeMetaData(NULL),NewScalars(NULL),
   vtkMarchingCubesTriangleCases *triCase;
   unsigned char *edgeCase;
 
+  this->GridCoordinates[0] = this->GridCoordinates[1] =
+    this->GridCoordinates[2] = NULL;
+
   // Initialize cases, increments, and edge intersection flags
   for (eCase=0; eCase<256; ++eCase)
     {
@@ -614,6 +843,63 @@ ComputeBoundaryGradient(vtkIdType ijk[3],
     {
     g[2] = 0.5 * ( (*s2_start - *s2_end) / this->Spacing[2] );
     }
+
+  if ( this->HasGridGeometry() )
+    {
+    this->TransformGradient(ijk, g);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Transform a gradient computed in index space into world space. The
+// Jacobian of the grid (the derivatives of the point coordinates with
+// respect to the point indices) is computed with the same differences as
+// the gradient; the index space gradient is its transpose times the world
+// space one.
+template <class T> void vtkFlyingEdges3DAlgorithm<T>::
+TransformGradient(vtkIdType ijk[3], float g[3])
+{
+  double J[3][3], JI[3][3];
+  double x0[3], x1[3];
+  for (int j=0; j < 3; ++j)
+    {
+    vtkIdType ijk0[3] = { ijk[0], ijk[1], ijk[2] };
+    vtkIdType ijk1[3] = { ijk[0], ijk[1], ijk[2] };
+    double scale = 1.0;
+    if ( ijk[j] == 0 )
+      {
+      ++ijk1[j];
+      }
+    else if ( ijk[j] >= (this->Dims[j]-1) )
+      {
+      --ijk0[j];
+      }
+    else
+      {
+      --ijk0[j];
+      ++ijk1[j];
+      scale = 0.5;
+      }
+    this->GetGridPoint(ijk0, x0);
+    this->GetGridPoint(ijk1, x1);
+    for (int i=0; i < 3; ++i)
+      {
+      J[i][j] = scale * (x1[i] - x0[i]);
+      }
+    }
+
+  // A degenerate grid has no inverse Jacobian; keep the index space
+  // gradient, which still points across the contour.
+  if ( vtkMath::Determinant3x3(J) == 0.0 )
+    {
+    return;
+    }
+  vtkMath::Invert3x3(J, JI);
+  double gIndex[3] = { g[0], g[1], g[2] };
+  for (int i=0; i < 3; ++i)
+    {
+    g[i] = JI[0][i]*gIndex[0] + JI[1][i]*gIndex[1] + JI[2][i]*gIndex[2];
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -623,7 +909,7 @@ template <class T> void vtkFlyingEdges3DAlgorithm<T>::
 InterpolateEdge(double value, vtkIdType ijk[3],
                 T const * const s,
                 const int incs[3],
-                float x[3],
+                double x[3],
                 unsigned char edgeNum,
                 unsigned char const * const edgeUses,
                 vtkIdType *eIds)
@@ -637,7 +923,7 @@ InterpolateEdge(double value, vtkIdType ijk[3],
   // build the edge information
   const unsigned char *vertMap = this->VertMap[edgeNum];
 
-  float x0[3], x1[3];
+  double x0[3], x1[3];
   vtkIdType ijk0[3], ijk1[3], vId=eIds[edgeNum];
   int i;
 
@@ -660,13 +946,15 @@ InterpolateEdge(double value, vtkIdType ijk[3],
     ijk1[i] = ijk[i] + offsets[i];
     x1[i] = x[i] + offsets[i]*this->Spacing[i];
     }
+  if ( this->HasGridGeometry() )
+    {
+    this->GetGridPoint(ijk0, x0);
+    this->GetGridPoint(ijk1, x1);
+    }
 
   // Okay interpolate
   double t = (value - *s0) / (*s1 - *s0);
-  float *xPtr = this->NewPoints + 3*vId;
-  xPtr[0] = x0[0] + t*(x1[0]-x0[0]);
-  xPtr[1] = x0[1] + t*(x1[1]-x0[1]);
-  xPtr[2] = x0[2] + t*(x1[2]-x0[2]);
+  this->InterpolatePoint(vId, t, x0, x1);
 
   if ( this->NeedGradients )
     {
@@ -711,7 +999,7 @@ InterpolateEdge(double value, vtkIdType ijk[3],
 template <class T> void vtkFlyingEdges3DAlgorithm<T>::
 GeneratePoints(double value, unsigned char loc, vtkIdType ijk[3],
                T const * const sPtr, const int incs[3],
-               float x[3],
+               double x[3],
                unsigned char const * const edgeUses,
                vtkIdType *eIds)
 {
@@ -726,6 +1014,14 @@ GeneratePoints(double value, unsigned char loc, vtkIdType ijk[3],
                           g0);
     }
 
+  // The voxel axes origin, from the grid geometry if any.
+  double x0[3] = { x[0], x[1], x[2] };
+  if ( this->HasGridGeometry() &&
+       (edgeUses[0] || edgeUses[4] || edgeUses[8]) )
+    {
+    this->GetGridPoint(ijk, x0);
+    }
+
   // Interpolate the cell axes edges
   for(int i=0; i < 3; ++i)
     {
@@ -734,12 +1030,16 @@ GeneratePoints(double value, unsigned char loc, vtkIdType ijk[3],
       //edgesUses[0] == x axes edge
       //edgesUses[4] == y axes edge
       //edgesUses[8] == z axes edge
-      float x1[3] = {x[0], x[1], x[2] }; x1[i] += this->Spacing[i];
+      double x1[3] = {x[0], x[1], x[2] }; x1[i] += this->Spacing[i];
       vtkIdType ijk1[3] = { ijk[0], ijk[1], ijk[2] }; ++ijk1[i];
+      if ( this->HasGridGeometry() )
+        {
+        this->GetGridPoint(ijk1, x1);
+        }
 
       T const * const sPtr2 = (sPtr+incs[i]);
       double t = (value - *sPtr) / (*sPtr2 - *sPtr);
-      this->InterpolateAxesEdge(t, loc, x, sPtr2, incs, x1, eIds[i*4], ijk, ijk1, g0);
+      this->InterpolateAxesEdge(t, loc, x0, sPtr2, incs, x1, eIds[i*4], ijk, ijk1, g0);
       }
     }
 
@@ -866,6 +1166,62 @@ ProcessXEdge(double value, T const* const inPtr, vtkIdType row, vtkIdType slice)
   edgeMetaData[5] = maxInt; //where intersections end along x edge
 }
 
+//----------------------------------------------------------------------------
+// PASS 1 when all the contour values are processed together: process a
+// single volume x-row, computing the level of its points (the number of
+// sorted contour values that their scalar reaches). An x-edge intersects
+// the contour values ranked between the levels of its two points, whose
+// number of intersections and trim edges are gathered as in ProcessXEdge().
+template <class T> void vtkFlyingEdges3DAlgorithm<T>::
+ProcessXEdgeLevels(T const* const inPtr, vtkIdType row, vtkIdType slice)
+{
+  vtkIdType nxcells=this->Dims[0]-1;
+  int numValues = static_cast<int>(this->SortedValues.size());
+  const double *values = &this->SortedValues[0];
+  const double *valuesEnd = values + numValues;
+  unsigned char *lPtr =
+    this->Levels + (slice*this->Dims[1] + row)*this->Dims[0];
+  vtkIdType valueOffset = 6*this->NumberOfEdges;
+  vtkIdType *edgeMetaData = this->EdgeMetaData + (slice*this->Dims[1] + row)*6;
+  vtkIdType *eMD;
+  int k;
+
+  for (k=0, eMD=edgeMetaData; k < numValues; ++k, eMD+=valueOffset)
+    {
+    std::fill_n(eMD, 6, 0);
+    eMD[4] = nxcells; //where intersections start along x edge
+    }
+
+  //pull this out help reduce false sharing
+  vtkIdType inc0 = this->Inc0;
+
+  lPtr[0] = static_cast<unsigned char>(
+    std::upper_bound(values, valuesEnd, static_cast<double>(*inPtr)) - values);
+  for (vtkIdType i=0; i < nxcells; ++i)
+    {
+    double s1 = static_cast<double>(*(inPtr + (i+1)*inc0));
+    lPtr[i+1] = static_cast<unsigned char>(
+      std::upper_bound(values, valuesEnd, s1) - values);
+
+    // the values ranked in [kMin,kMax) intersect this x-edge
+    int kMin = lPtr[i], kMax = lPtr[i+1];
+    if ( kMin > kMax )
+      {
+      std::swap(kMin, kMax);
+      }
+    for (k=kMin, eMD=edgeMetaData+kMin*valueOffset; k < kMax;
+         ++k, eMD+=valueOffset)
+      {
+      ++eMD[0]; //increment number of intersections along x-edge
+      if ( i < eMD[4] )
+        {
+        eMD[4] = i;
+        }
+      eMD[5] = i + 1;
+      }
+    }//for all x-cell edges along this x-edge
+}
+
 //----------------------------------------------------------------------------
 // PASS 2: Process a single x-row of voxels. Count the number of y- and
 // z-intersections by topological reasoning from x-edge cases. Determine the
@@ -876,27 +1232,27 @@ ProcessXEdge(double value, T const* const inPtr, vtkIdType row, vtkIdType slice)
 template <class T> void vtkFlyingEdges3DAlgorithm<T>::
 ProcessYZEdges(vtkIdType row, vtkIdType slice)
 {
-  // Grab the four edge cases bounding this voxel x-row.
-  unsigned char *ePtr[4], ec0, ec1, ec2, ec3, xInts=1;
-  ePtr[0] = this->XCases + slice*this->SliceOffset + row*(this->Dims[0]-1);
-  ePtr[1] = ePtr[0] + this->Dims[0]-1;
-  ePtr[2] = ePtr[0] + this->SliceOffset;
-  ePtr[3] = ePtr[2] + this->Dims[0]-1;
-
-  // Grab the edge meta data surrounding the voxel row.
+  // Grab the four edge cases bounding this voxel x-row, and the edge meta
+  // data surrounding the voxel row.
   vtkIdType *eMD[4];
-  eMD[0] = this->EdgeMetaData + (slice*this->Dims[1] + row)*6; //this x-edge
-  eMD[1] = eMD[0] + 6; //x-edge in +y direction
-  eMD[2] = eMD[0] + this->Dims[1]*6; //x-edge in +z direction
-  eMD[3] = eMD[2] + 6; //x-edge in +y+z direction
+  this->GetEdgeMetaData(this->EdgeMetaData, row, slice, eMD);
+  this->ProcessYZEdges(this->GetXCaseRows(row, slice), eMD, row, slice);
+}
+
+template <class T> template <class TRows> void vtkFlyingEdges3DAlgorithm<T>::
+ProcessYZEdges(const TRows &rows, vtkIdType *eMD[4],
+               vtkIdType row, vtkIdType slice)
+{
+  unsigned char ec0, ec1, ec2, ec3, xInts=1;
 
   // Determine whether this row of x-cells needs processing. If there are no
   // x-edge intersections, and the state of the four bounding x-edges is the
   // same, then there is no need for processing.
   if ( (eMD[0][0] | eMD[1][0] | eMD[2][0] | eMD[3][0]) == 0 ) //any x-ints?
     {
-    if ( *(ePtr[0]) == *(ePtr[1]) &&  *(ePtr[1]) == *(ePtr[2]) &&
-         *(ePtr[2]) == *(ePtr[3]) )
+    ec0 = rows.GetCase(0,0); ec1 = rows.GetCase(1,0);
+    ec2 = rows.GetCase(2,0); ec3 = rows.GetCase(3,0);
+    if ( ec0 == ec1 && ec1 == ec2 && ec2 == ec3 )
       {
       return; //there are no y- or z-ints, thus no contour, skip voxel row
       }
@@ -930,8 +1286,8 @@ ProcessYZEdges(vtkIdType row, vtkIdType slice)
 
     if ( xL > 0 ) //if trimmed in the -x direction
       {
-      ec0 = *(ePtr[0]+xL); ec1 = *(ePtr[1]+xL);
-      ec2 = *(ePtr[2]+xL); ec3 = *(ePtr[3]+xL);
+      ec0 = rows.GetCase(0,xL); ec1 = rows.GetCase(1,xL);
+      ec2 = rows.GetCase(2,xL); ec3 = rows.GetCase(3,xL);
       if ( (ec0 & 0x1) != (ec1 & 0x1) || (ec1 & 0x1) != (ec2 & 0x1) ||
            (ec2 & 0x1) != (ec3 & 0x1) )
         {
@@ -941,8 +1297,8 @@ ProcessYZEdges(vtkIdType row, vtkIdType slice)
 
     if ( xR < (this->Dims[0]-1) ) //if trimmed in the +x direction
       {
-      ec0 = *(ePtr[0]+xR); ec1 = *(ePtr[1]+xR);
-      ec2 = *(ePtr[2]+xR); ec3 = *(ePtr[3]+xR);
+      ec0 = rows.GetCase(0,xR); ec1 = rows.GetCase(1,xR);
+      ec2 = rows.GetCase(2,xR); ec3 = rows.GetCase(3,xR);
       if ( (ec0 & 0x2) != (ec1 & 0x2) || (ec1 & 0x2) != (ec2 & 0x2) ||
            (ec2 & 0x2) != (ec3 & 0x2) )
         {
@@ -960,11 +1316,10 @@ ProcessYZEdges(vtkIdType row, vtkIdType slice)
   // z-intersections. Here we are just checking y,z edges that make up the
   // voxel axes. Also check the number of primitives generated.
   unsigned char *edgeUses, eCase, numTris;
-  ePtr[0] += xL; ePtr[1] += xL; ePtr[2] += xL; ePtr[3] += xL;
   const vtkIdType dim0Wall = this->Dims[0]-2;
   for (i=xL; i < xR; ++i) //run along the trimmed x-voxels
     {
-    eCase = this->GetEdgeCase(ePtr);
+    eCase = this->GetEdgeCase(rows,i);
     if ( (numTris=this->GetNumberOfPrimitives(eCase)) > 0 )
       {
       // Okay let's increment the triangle count.
@@ -982,9 +1337,6 @@ ProcessYZEdges(vtkIdType row, vtkIdType slice)
         this->CountBoundaryYZInts(loc,edgeUses,eMD);
         }
       }//if cell contains contour
-
-    // advance the four pointers along voxel row
-    ePtr[0]++; ePtr[1]++; ePtr[2]++; ePtr[3]++;
     }//for all voxels along this x-edge
 }
 
@@ -995,13 +1347,18 @@ ProcessYZEdges(vtkIdType row, vtkIdType slice)
 template <class T> void vtkFlyingEdges3DAlgorithm<T>::
 GenerateOutput(double value, T* rowPtr, vtkIdType row, vtkIdType slice)
 {
-  // Grab the edge meta data surrounding the voxel row.
+  // Grab the edge meta data surrounding the voxel row, and the four edge
+  // cases bounding this voxel x-row.
   vtkIdType *eMD[4];
-  eMD[0] = this->EdgeMetaData + (slice*this->Dims[1] + row)*6; //this x-edge
-  eMD[1] = eMD[0] + 6; //x-edge in +y direction
-  eMD[2] = eMD[0] + this->Dims[1]*6; //x-edge in +z direction
-  eMD[3] = eMD[2] + 6; //x-edge in +y+z direction
+  this->GetEdgeMetaData(this->EdgeMetaData, row, slice, eMD);
+  this->GenerateOutput(value, rowPtr, this->GetXCaseRows(row, slice), eMD,
+                       row, slice);
+}
 
+template <class T> template <class TRows> void vtkFlyingEdges3DAlgorithm<T>::
+GenerateOutput(double value, T* rowPtr, const TRows &rows, vtkIdType *eMD[4],
+               vtkIdType row, vtkIdType slice)
+{
   // Return if there is nothing to do (i.e., no triangles to generate)
   if ( eMD[0][3] == eMD[1][3] )
     {
@@ -1018,20 +1375,13 @@ GenerateOutput(double value, T* rowPtr, vtkIdType row, vtkIdType slice)
     xR = ( eMD[i][5] > xR ? eMD[i][5] : xR);
     }
 
-  // Grab the four edge cases bounding this voxel x-row. Begin at left trim edge.
-  unsigned char *ePtr[4];
-  ePtr[0] = this->XCases + slice*this->SliceOffset + row*(this->Dims[0]-1) + xL;
-  ePtr[1] = ePtr[0] + this->Dims[0]-1;
-  ePtr[2] = ePtr[0] + this->SliceOffset;
-  ePtr[3] = ePtr[2] + this->Dims[0]-1;
-
   // Traverse all voxels in this row, those containing the contour are
   // further identified for processing, meaning generating points and
   // triangles. Begin by setting up point ids on voxel edges.
   vtkIdType triId = eMD[0][3];
   vtkIdType eIds[12]; //the ids of generated points
 
-  unsigned char eCase = this->InitVoxelIds(ePtr,eMD,eIds);
+  unsigned char eCase = this->InitVoxelIds(rows,xL,eMD,eIds);
 
   // Determine the proximity to the boundary of volume. This information is
   // used to generate edge intersections.
@@ -1045,7 +1395,7 @@ GenerateOutput(double value, T* rowPtr, vtkIdType row, vtkIdType slice)
   // Run along voxels in x-row direction and generate output primitives. Note
   // that active voxel axes edges are interpolated to produce points and
   // possibly interpolate attribute data.
-  float x[3];
+  double x[3];
   x[0] = this->Origin[0] + xL*this->Spacing[0];
   x[1] = this->Origin[1] + row*this->Spacing[1];
   x[2] = this->Origin[2] + slice*this->Spacing[2];
@@ -1082,8 +1432,7 @@ GenerateOutput(double value, T* rowPtr, vtkIdType row, vtkIdType slice)
       }
 
     // advance along voxel row
-    ePtr[0]++; ePtr[1]++; ePtr[2]++; ePtr[3]++;
-    eCase = this->GetEdgeCase(ePtr);
+    eCase = this->GetEdgeCase(rows,i+1);
 
     ++ijk[0];
     sPtr += incs[0];
@@ -1096,10 +1445,11 @@ GenerateOutput(double value, T* rowPtr, vtkIdType row, vtkIdType slice)
 // interfaces the vtkFlyingEdges3D class with the templated algorithm
 // class. It also invokes the three passes of the Flying Edges algorithm.
 template <class T> void vtkFlyingEdges3DAlgorithm<T>::
-Contour(vtkFlyingEdges3D *self, vtkImageData *input, vtkDataArray *inScalars,
+Contour(vtkFlyingEdges3D *self, vtkDataSet *input, vtkDataArray *inScalars,
         int extent[6], vtkIdType *incs, T *scalars, vtkPolyData *output,
         vtkPoints *newPts, vtkCellArray *newTris, vtkDataArray *newScalars,
-        vtkFloatArray *newNormals, vtkFloatArray *newGradients)
+        vtkFloatArray *newNormals, vtkFloatArray *newGradients,
+        vtkIntArray *newIndices)
 {
   double value, *values = self->GetValues();
   int numContours = self->GetNumberOfContours();
@@ -1113,8 +1463,41 @@ Contour(vtkFlyingEdges3D *self, vtkImageData *input, vtkDataArray *inScalars,
   // subsequent processing.
   vtkFlyingEdges3DAlgorithm<T> algo;
   algo.Scalars = scalars;
-  input->GetOrigin(algo.Origin);
-  input->GetSpacing(algo.Spacing);
+  vtkImageData *image = vtkImageData::SafeDownCast(input);
+  if ( image )
+    {
+    image->GetOrigin(algo.Origin);
+    image->GetSpacing(algo.Spacing);
+    }
+  else
+    {
+    // The points of structured and rectilinear grids are given explicitly,
+    // the algorithm then works in index space.
+    vtkStructuredGrid *grid = vtkStructuredGrid::SafeDownCast(input);
+    vtkRectilinearGrid *rectGrid = vtkRectilinearGrid::SafeDownCast(input);
+    int *inExt;
+    if ( grid )
+      {
+      inExt = grid->GetExtent();
+      algo.GridPoints = grid->GetPoints()->GetData();
+      }
+    else
+      {
+      inExt = rectGrid->GetExtent();
+      algo.GridCoordinates[0] = rectGrid->GetXCoordinates();
+      algo.GridCoordinates[1] = rectGrid->GetYCoordinates();
+      algo.GridCoordinates[2] = rectGrid->GetZCoordinates();
+      }
+    for (int i=0; i < 3; ++i)
+      {
+      algo.Origin[i] = 0.0;
+      algo.Spacing[i] = 1.0;
+      algo.GridOffsets[i] = extent[2*i] - inExt[2*i];
+      }
+    algo.GridIncs[0] = 1;
+    algo.GridIncs[1] = inExt[1] - inExt[0] + 1;
+    algo.GridIncs[2] = algo.GridIncs[1] * (inExt[3] - inExt[2] + 1);
+    }
   algo.Min0 = extent[0];
   algo.Max0 = extent[1];
   algo.Inc0 = incs[0];
@@ -1126,12 +1509,28 @@ Contour(vtkFlyingEdges3D *self, vtkImageData *input, vtkDataArray *inScalars,
   algo.Inc2 = incs[2];
   algo.AdjustOrigin();
 
+  // Interpolating attributes and other stuff. Interpolate extra attributes only if they
+  // exist and the user requests it.
+  algo.NeedGradients = (newGradients || newNormals);
+  algo.InterpolateAttributes = (self->GetInterpolateAttributes() &&
+                                 input->GetPointData()->GetNumberOfArrays() > 1) ? true : false;
+
   // Now allocate working arrays. The XCases array tracks x-edge cases.
   algo.Dims[0] = algo.Max0 - algo.Min0 + 1;
   algo.Dims[1] = algo.Max1 - algo.Min1 + 1;
   algo.Dims[2] = algo.Max2 - algo.Min2 + 1;
   algo.NumberOfEdges = algo.Dims[1]*algo.Dims[2];
   algo.SliceOffset = (algo.Dims[0]-1) * algo.Dims[1];
+
+  // The point levels used to process the contour values together are
+  // stored in a byte.
+  if ( self->GetFuseContours() && numContours > 1 && numContours < 256 )
+    {
+    algo.FusedContour(self, input, inScalars, output, newPts, newTris,
+                      newScalars, newNormals, newGradients, newIndices);
+    return;
+    }
+
   algo.XCases = new unsigned char [(algo.Dims[0]-1)*algo.NumberOfEdges];
 
   // Also allocate the characterization (metadata) array for the x edges.
@@ -1142,12 +1541,6 @@ Contour(vtkFlyingEdges3D *self, vtkImageData *input, vtkDataArray *inScalars,
   // for computational trimming).
   algo.EdgeMetaData = new vtkIdType [algo.NumberOfEdges*6];
 
-  // Interpolating attributes and other stuff. Interpolate extra attributes only if they
-  // exist and the user requests it.
-  algo.NeedGradients = (newGradients || newNormals);
-  algo.InterpolateAttributes = (self->GetInterpolateAttributes() &&
-                                 input->GetPointData()->GetNumberOfArrays() > 1) ? true : false;
-
   // Loop across each contour value. This encompasses all three passes.
   for (vidx = 0; vidx < numContours; vidx++)
     {
@@ -1207,9 +1600,22 @@ Contour(vtkFlyingEdges3D *self, vtkImageData *input, vtkDataArray *inScalars,
     if ( totalPts > 0 )
       {
       newPts->GetData()->WriteVoidPointer(0,3*totalPts);
-      algo.NewPoints = static_cast<float*>(newPts->GetVoidPointer(0));
+      if ( newPts->GetDataType() == VTK_DOUBLE )
+        {
+        algo.NewDoublePoints = static_cast<double*>(newPts->GetVoidPointer(0));
+        }
+      else
+        {
+        algo.NewPoints = static_cast<float*>(newPts->GetVoidPointer(0));
+        }
       newTris->WritePointer(numOutTris,4*numOutTris);
       algo.NewTris = static_cast<vtkIdType*>(newTris->GetPointer());
+      if (newIndices && numOutTris > startTris)
+        {
+        int *indices = newIndices->WritePointer(0,numOutTris);
+        std::fill_n(indices+startTris, numOutTris-startTris,
+                    static_cast<int>(vidx));
+        }
       if (newScalars)
         {
         vtkIdType numPrevPts = newScalars->GetNumberOfTuples();
@@ -1231,7 +1637,7 @@ Contour(vtkFlyingEdges3D *self, vtkImageData *input, vtkDataArray *inScalars,
         }
       if ( algo.InterpolateAttributes )
         {
-        if ( vidx == 0 ) //first contour
+        if ( startXPts + startYPts + startZPts == 0 ) //first contour with points
           {
           // Make sure we don't interpolate the input scalars twice; or generate scalars
           // when ComputeScalars is off.
@@ -1266,6 +1672,148 @@ Contour(vtkFlyingEdges3D *self, vtkImageData *input, vtkDataArray *inScalars,
   delete [] algo.EdgeMetaData;
 }
 
+//----------------------------------------------------------------------------
+// Process all the contour values in a single set of passes: the volume is
+// read once to classify its points against all the values, then the voxel
+// rows are processed for each value from the point levels. The output is
+// laid out as if the values were processed one after the other.
+template <class T> void vtkFlyingEdges3DAlgorithm<T>::
+FusedContour(vtkFlyingEdges3D *self, vtkDataSet *input,
+             vtkDataArray *inScalars, vtkPolyData *output, vtkPoints *newPts,
+             vtkCellArray *newTris, vtkDataArray *newScalars,
+             vtkFloatArray *newNormals, vtkFloatArray *newGradients,
+             vtkIntArray *newIndices)
+{
+  double *values = self->GetValues();
+  int vidx, k, numContours = self->GetNumberOfContours();
+  vtkIdType i, *eMD;
+  vtkIdType numOutXPts, numOutYPts, numOutZPts, numOutTris;
+  vtkIdType numXPts, numYPts, numZPts, numTris;
+  numOutXPts = numOutYPts = numOutZPts = numOutTris = 0;
+
+  // Sort the contour values, keeping the rank of each value.
+  std::vector<std::pair<double,int> > sortedValues(numContours);
+  std::vector<int> ranks(numContours);
+  for (vidx=0; vidx < numContours; ++vidx)
+    {
+    sortedValues[vidx] = std::make_pair(values[vidx], vidx);
+    }
+  std::sort(sortedValues.begin(), sortedValues.end());
+  this->SortedValues.resize(numContours);
+  for (k=0; k < numContours; ++k)
+    {
+    this->SortedValues[k] = sortedValues[k].first;
+    ranks[sortedValues[k].second] = k;
+    }
+
+  // Allocate the point levels (padded since the cases of the voxel past the
+  // last one may be looked up) and the edge metadata of all the values.
+  vtkIdType numLevels = this->Dims[0]*this->NumberOfEdges;
+  this->Levels = new unsigned char [numLevels + 1];
+  this->Levels[numLevels] = 0;
+  this->EdgeMetaData = new vtkIdType [numContours*this->NumberOfEdges*6];
+
+  // PASS 1: Traverse all x-rows computing the point levels, and counting the
+  // number of intersections of each contour value along the x-rows.
+  FusedPass1<T> pass1(this);
+  vtkSMPTools::For(0,this->Dims[2], pass1);
+
+  // PASS 2: Traverse all voxel x-rows and process voxel y&z edges for each
+  // contour value.
+  FusedPass2<T> pass2(this);
+  vtkSMPTools::For(0,this->Dims[2]-1, pass2);
+
+  // PASS 3: Partition the output, value after value in the order of the
+  // contour values.
+  std::vector<vtkIdType> ptOffsets(numContours+1, 0);
+  std::vector<vtkIdType> triOffsets(numContours+1, 0);
+  for (vidx=0; vidx < numContours; ++vidx)
+    {
+    eMD = this->EdgeMetaData + ranks[vidx]*this->NumberOfEdges*6;
+    for (i=0; i < this->NumberOfEdges; ++i, eMD+=6)
+      {
+      numXPts = eMD[0];
+      numYPts = eMD[1];
+      numZPts = eMD[2];
+      numTris = eMD[3];
+      eMD[0] = numOutXPts + numOutYPts + numOutZPts;
+      eMD[1] = eMD[0] + numXPts;
+      eMD[2] = eMD[1] + numYPts;
+      eMD[3] = numOutTris;
+      numOutXPts += numXPts;
+      numOutYPts += numYPts;
+      numOutZPts += numZPts;
+      numOutTris += numTris;
+      }
+    ptOffsets[vidx+1] = numOutXPts + numOutYPts + numOutZPts;
+    triOffsets[vidx+1] = numOutTris;
+    }
+
+  // Output can now be allocated.
+  vtkIdType totalPts = ptOffsets[numContours];
+  if ( totalPts > 0 )
+    {
+    newPts->GetData()->WriteVoidPointer(0,3*totalPts);
+    if ( newPts->GetDataType() == VTK_DOUBLE )
+      {
+      this->NewDoublePoints = static_cast<double*>(newPts->GetVoidPointer(0));
+      }
+    else
+      {
+      this->NewPoints = static_cast<float*>(newPts->GetVoidPointer(0));
+      }
+    newTris->WritePointer(numOutTris,4*numOutTris);
+    this->NewTris = static_cast<vtkIdType*>(newTris->GetPointer());
+    if (newIndices && numOutTris > 0)
+      {
+      int *indices = newIndices->WritePointer(0,numOutTris);
+      for (vidx=0; vidx < numContours; ++vidx)
+        {
+        std::fill_n(indices+triOffsets[vidx],
+                    triOffsets[vidx+1]-triOffsets[vidx], vidx);
+        }
+      }
+    if (newScalars)
+      {
+      newScalars->WriteVoidPointer(0,totalPts);
+      this->NewScalars = static_cast<T*>(newScalars->GetVoidPointer(0));
+      for (vidx=0; vidx < numContours; ++vidx)
+        {
+        std::fill_n(this->NewScalars+ptOffsets[vidx],
+                    ptOffsets[vidx+1]-ptOffsets[vidx],
+                    static_cast<T>(values[vidx]));
+        }
+      }
+    if (newGradients)
+      {
+      newGradients->WriteVoidPointer(0,3*totalPts);
+      this->NewGradients = static_cast<float*>(newGradients->GetVoidPointer(0));
+      }
+    if (newNormals)
+      {
+      newNormals->WriteVoidPointer(0,3*totalPts);
+      this->NewNormals = static_cast<float*>(newNormals->GetVoidPointer(0));
+      }
+    if ( this->InterpolateAttributes )
+      {
+      // Make sure we don't interpolate the input scalars twice; or generate scalars
+      // when ComputeScalars is off.
+      output->GetPointData()->InterpolateAllocate(input->GetPointData(),totalPts);
+      output->GetPointData()->RemoveArray(inScalars->GetName());
+      this->Arrays.ExcludeArray(inScalars);
+      this->Arrays.AddArrays(totalPts,input->GetPointData(),output->GetPointData());
+      }
+
+    // PASS 4: Process voxel rows and generate the output of all the values.
+    FusedPass4<T> pass4(this);
+    vtkSMPTools::For(0,this->Dims[2]-1, pass4);
+    }//if anything generated
+
+  // Clean up and return
+  delete [] this->Levels;
+  delete [] this->EdgeMetaData;
+}
+
 }//anonymous namespace
 
 //----------------------------------------------------------------------------
@@ -1278,6 +1826,8 @@ vtkFlyingEdges3D::vtkFlyingEdges3D()
   this->ComputeGradients = 0;
   this->ComputeScalars = 1;
   this->InterpolateAttributes = 0;
+  this->ComputeContourIndices = 0;
+  this->FuseContours = 0;
   this->ArrayComponent = 0;
 
   // by default process active point scalars
@@ -1337,17 +1887,21 @@ int vtkFlyingEdges3D::RequestData(
   vtkInformation *outInfo = outputVector->GetInformationObject(0);
 
   // get the input and output
-  vtkImageData *input = vtkImageData::SafeDownCast(
+  vtkDataSet *input = vtkDataSet::SafeDownCast(
     inInfo->Get(vtkDataObject::DATA_OBJECT()));
   vtkPolyData *output = vtkPolyData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkImageData *image = vtkImageData::SafeDownCast(input);
+  vtkStructuredGrid *grid = vtkStructuredGrid::SafeDownCast(input);
+  vtkRectilinearGrid *rectGrid = vtkRectilinearGrid::SafeDownCast(input);
 
   // to be safe recompute the update extent
   this->RequestUpdateExtent(request,inputVector,outputVector);
   vtkDataArray *inScalars = this->GetInputArrayToProcess(0,inputVector);
 
   // Determine extent
-  int* inExt = input->GetExtent();
+  int* inExt = (image ? image->GetExtent() :
+                (grid ? grid->GetExtent() : rectGrid->GetExtent()));
   int exExt[6];
   inInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), exExt);
   for (int i=0; i<3; i++)
@@ -1366,6 +1920,14 @@ int vtkFlyingEdges3D::RequestData(
     vtkDebugMacro(<<"3D structured contours requires 3D data");
     return 0;
     }
+  if ( (grid && !grid->GetPoints()) ||
+       (rectGrid && (!rectGrid->GetXCoordinates() ||
+                     !rectGrid->GetYCoordinates() ||
+                     !rectGrid->GetZCoordinates())) )
+    {
+    vtkDebugMacro(<<"No points for contouring.");
+    return 0;
+    }
 
   // Check data type and execute appropriate function
   //
@@ -1386,11 +1948,24 @@ int vtkFlyingEdges3D::RequestData(
   // Create necessary objects to hold output. We will defer the
   // actual allocation to a later point.
   vtkCellArray *newTris = vtkCellArray::New();
+  // Double grid geometry produces double points so that the contour keeps
+  // the precision of the grid.
   vtkPoints *newPts = vtkPoints::New();
-  newPts->SetDataTypeToFloat();
+  if ( (grid && grid->GetPoints()->GetDataType() == VTK_DOUBLE) ||
+       (rectGrid && (rectGrid->GetXCoordinates()->GetDataType() == VTK_DOUBLE ||
+                     rectGrid->GetYCoordinates()->GetDataType() == VTK_DOUBLE ||
+                     rectGrid->GetZCoordinates()->GetDataType() == VTK_DOUBLE)) )
+    {
+    newPts->SetDataTypeToDouble();
+    }
+  else
+    {
+    newPts->SetDataTypeToFloat();
+    }
   vtkDataArray *newScalars = NULL;
   vtkFloatArray *newNormals = NULL;
   vtkFloatArray *newGradients = NULL;
+  vtkIntArray *newIndices = NULL;
 
   if (this->ComputeScalars)
     {
@@ -1410,15 +1985,34 @@ int vtkFlyingEdges3D::RequestData(
     newGradients->SetNumberOfComponents(3);
     newGradients->SetName("Gradients");
     }
+  if (this->ComputeContourIndices)
+    {
+    newIndices = vtkIntArray::New();
+    newIndices->SetName("ContourIndex");
+    }
 
-  void *ptr = input->GetArrayPointerForExtent(inScalars, exExt);
-  vtkIdType *incs = input->GetIncrements(inScalars);
+  void *ptr;
+  vtkIdType incs[3];
+  if ( image )
+    {
+    ptr = image->GetArrayPointerForExtent(inScalars, exExt);
+    image->GetIncrements(inScalars, incs);
+    }
+  else
+    {
+    incs[0] = numComps;
+    incs[1] = incs[0] * (inExt[1] - inExt[0] + 1);
+    incs[2] = incs[1] * (inExt[3] - inExt[2] + 1);
+    ptr = inScalars->GetVoidPointer((exExt[0] - inExt[0]) * incs[0] +
+                                    (exExt[2] - inExt[2]) * incs[1] +
+                                    (exExt[4] - inExt[4]) * incs[2]);
+    }
   switch (inScalars->GetDataType())
     {
     vtkTemplateMacro(vtkFlyingEdges3DAlgorithm<VTK_TT>::
                      Contour(this, input, inScalars, exExt, incs, (VTK_TT *)ptr,
                              output, newPts, newTris, newScalars, newNormals,
-                             newGradients));
+                             newGradients, newIndices));
     }
 
   vtkDebugMacro(<<"Created: "
@@ -1454,6 +2048,12 @@ int vtkFlyingEdges3D::RequestData(
     newGradients->Delete();
     }
 
+  if (newIndices)
+    {
+    output->GetCellData()->AddArray(newIndices);
+    newIndices->Delete();
+    }
+
   return 1;
 }
 
@@ -1461,6 +2061,8 @@ int vtkFlyingEdges3D::RequestData(
 int vtkFlyingEdges3D::FillInputPortInformation(int, vtkInformation *info)
 {
   info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkImageData");
+  info->Append(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkStructuredGrid");
+  info->Append(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkRectilinearGrid");
   return 1;
 }
 
@@ -1475,5 +2077,7 @@ void vtkFlyingEdges3D::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Compute Gradients: " << (this->ComputeGradients ? "On\n" : "Off\n");
   os << indent << "Compute Scalars: " << (this->ComputeScalars ? "On\n" : "Off\n");
   os << indent << "Interpolate Attributes: " << (this->InterpolateAttributes ? "On\n" : "Off\n");
+  os << indent << "Compute Contour Indices: " << (this->ComputeContourIndices ? "On\n" : "Off\n");
+  os << indent << "Fuse Contours: " << (this->FuseContours ? "On\n" : "Off\n");
   os << indent << "ArrayComponent: " << this->ArrayComponent << endl;
 }
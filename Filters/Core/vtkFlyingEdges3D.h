@@ -41,10 +41,20 @@
 //
 // See the paper "Flying Edges: A High-Performance Scalable Isocontouring
 // Algorithm" by Schroeder, Maynard, Geveci. Proc. of LDAV 2015. Chicago, IL.
+//
+// Besides image data, the filter accepts structured grids and rectilinear
+// grids, whose points are given explicitly (as points or as coordinates
+// along each axis). The same passes are run on the (i,j,k) topology of the
+// grid, the output points being interpolated from the grid points, and the
+// gradients being computed in index space then mapped to world space with
+// the Jacobian of the grid. The output points are double when the grid
+// points (or any of the axis coordinates) are double, float otherwise.
 
 // .SECTION Caveats
 // This filter is specialized to 3D volumes. This implementation can produce
-// degenerate triangles (i.e., zero-area triangles).
+// degenerate triangles (i.e., zero-area triangles). The blanking of
+// structured grids is ignored. Where the Jacobian of a grid is singular
+// (e.g., collapsed cells), the gradients are left in index space.
 //
 // This class has been threaded with vtkSMPTools. Using TBB or other
 // non-sequential type (set in the CMake variable
@@ -52,7 +62,8 @@
 
 // .SECTION See Also
 // vtkContourFilter vtkFlyingEdges2D vtkSynchronizedTemplates3D
-// vtkMarchingCubes vtkSMPFlyingEdges3D
+// vtkMarchingCubes vtkSMPFlyingEdges3D vtkGridSynchronizedTemplates3D
+// vtkRectilinearSynchronizedTemplates
 
 #ifndef vtkFlyingEdges3D_h
 #define vtkFlyingEdges3D_h
@@ -109,6 +120,30 @@ public:
   vtkGetMacro(InterpolateAttributes,int);
   vtkBooleanMacro(InterpolateAttributes,int);
 
+  // Description:
+  // Set/Get the computation of contour indices. When on, a cell data array
+  // named "ContourIndex" gives for each output triangle the index of the
+  // contour value (see SetValue()) it belongs to.
+  vtkSetMacro(ComputeContourIndices,int);
+  vtkGetMacro(ComputeContourIndices,int);
+  vtkBooleanMacro(ComputeContourIndices,int);
+
+  // Description:
+  // Indicate whether to process all the contour values together. By default
+  // the four passes of the algorithm are run once per contour value, reading
+  // the whole volume each time. When on, the first pass classifies each
+  // point against all the values in a single read of the volume (storing,
+  // per point, the number of values its scalar reaches, from which the
+  // x-edge cases of every value are derived), and each of the other passes
+  // processes all the values at once, row by row. The output is the same,
+  // the triangles and points of each contour value being still grouped in
+  // the order of the values. This requires more memory for the edge
+  // metadata (which is kept per value), and at most 255 contour values:
+  // otherwise the values are processed one at a time.
+  vtkSetMacro(FuseContours,int);
+  vtkGetMacro(FuseContours,int);
+  vtkBooleanMacro(FuseContours,int);
+
   // Description:
   // Set a particular contour value at contour number i. The index i ranges
   // between 0<=i<NumberOfContours.
@@ -167,6 +202,8 @@ protected:
   int ComputeGradients;
   int ComputeScalars;
   int InterpolateAttributes;
+  int ComputeContourIndices;
+  int FuseContours;
   int ArrayComponent;
   vtkContourValues *ContourValues;
 
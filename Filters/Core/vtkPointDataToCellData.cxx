@@ -17,18 +17,45 @@
 #include "vtkCellData.h"
 #include "vtkDataSet.h"
 #include "vtkIdList.h"
+#include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStructuredGrid.h"
+
+#include <algorithm>
 
 vtkStandardNewMacro(vtkPointDataToCellData);
 
+namespace
+{
+// Return whether the cell data of the input can be computed in parallel:
+// all the point arrays must derive from vtkDataArray.
+bool vtkPointDataToCellDataCanThread(vtkDataSet *input)
+{
+  vtkPointData *inPD = input->GetPointData();
+  for (int i = 0; i < inPD->GetNumberOfArrays(); ++i)
+    {
+    if (!inPD->GetArray(i))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+}
+
 //----------------------------------------------------------------------------
 // Instantiate object so that point data is not passed to output.
 vtkPointDataToCellData::vtkPointDataToCellData()
 {
   this->PassPointData = 0;
+  this->EnableSMP = false;
 }
 
 //----------------------------------------------------------------------------
@@ -76,30 +103,37 @@ int vtkPointDataToCellData::RequestData(
   output->GetCellData()->PassData(input->GetCellData());
   output->GetCellData()->CopyFieldOff(vtkDataSetAttributes::GhostArrayName());
 
-  // notice that inPD and outCD are vtkPointData and vtkCellData; respectively.
-  // It's weird, but it works.
-  outCD->InterpolateAllocate(inPD,numCells);
-
-  int abort=0;
-  vtkIdType progressInterval=numCells/20 + 1;
-  for (cellId=0; cellId < numCells && !abort; cellId++)
+  if ( this->EnableSMP && vtkPointDataToCellDataCanThread(input) )
     {
-    if ( !(cellId % progressInterval) )
-      {
-      this->UpdateProgress((double)cellId/numCells);
-      abort = GetAbortExecute();
-      }
+    this->ThreadedInterpolateCellData(input, output);
+    }
+  else
+    {
+    // notice that inPD and outCD are vtkPointData and vtkCellData;
+    // respectively. It's weird, but it works.
+    outCD->InterpolateAllocate(inPD,numCells);
 
-    input->GetCellPoints(cellId, cellPts);
-    numPts = cellPts->GetNumberOfIds();
-    if ( numPts > 0 )
+    int abort=0;
+    vtkIdType progressInterval=numCells/20 + 1;
+    for (cellId=0; cellId < numCells && !abort; cellId++)
       {
-      weight = 1.0 / numPts;
-      for (ptId=0; ptId < numPts; ptId++)
+      if ( !(cellId % progressInterval) )
         {
-        weights[ptId] = weight;
+        this->UpdateProgress((double)cellId/numCells);
+        abort = GetAbortExecute();
+        }
+
+      input->GetCellPoints(cellId, cellPts);
+      numPts = cellPts->GetNumberOfIds();
+      if ( numPts > 0 )
+        {
+        weight = 1.0 / numPts;
+        for (ptId=0; ptId < numPts; ptId++)
+          {
+          weights[ptId] = weight;
+          }
+        outCD->InterpolatePoint(inPD, cellId, cellPts, weights);
         }
-      outCD->InterpolatePoint(inPD, cellId, cellPts, weights);
       }
     }
 
@@ -122,4 +156,137 @@ void vtkPointDataToCellData::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "Pass Point Data: " << (this->PassPointData ? "On\n" : "Off\n");
+  os << indent << "Enable SMP: " << (this->EnableSMP ? "On\n" : "Off\n");
+}
+
+//----------------------------------------------------------------------------
+// Functors averaging the point data of the points of each cell.
+namespace
+{
+#include "vtkArrayListTemplate.h" // For processing attribute data
+
+// Image data, rectilinear and structured grids: the points of a cell are
+// the corners of the cell in the structure, in the order of GetCellPoints().
+struct StructuredPointsToCells
+{
+  ArrayList *Arrays;
+  int Dims[3];
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    int cellDims[3];
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      cellDims[axis] = std::max(this->Dims[axis] - 1, 1);
+      }
+    vtkIdType ptIds[8];
+    int ijk[3], range[3][2];
+    for ( ; cellId < endCellId; ++cellId )
+      {
+      ijk[0] = static_cast<int>(cellId % cellDims[0]);
+      ijk[1] = static_cast<int>((cellId / cellDims[0]) % cellDims[1]);
+      ijk[2] = static_cast<int>(cellId / (static_cast<vtkIdType>(cellDims[0]) *
+                                          cellDims[1]));
+      for (int axis = 0; axis < 3; ++axis)
+        {
+        range[axis][0] = ijk[axis];
+        range[axis][1] = (this->Dims[axis] > 1 ? ijk[axis] + 1 : ijk[axis]);
+        }
+      int numPts = 0;
+      for (int k = range[2][0]; k <= range[2][1]; ++k)
+        {
+        for (int j = range[1][0]; j <= range[1][1]; ++j)
+          {
+          for (int i = range[0][0]; i <= range[0][1]; ++i)
+            {
+            ptIds[numPts++] = i + (j + static_cast<vtkIdType>(k) *
+                                   this->Dims[1]) * this->Dims[0];
+            }
+          }
+        }
+      this->Arrays->Average(numPts, ptIds, cellId);
+      }
+  }
+};
+
+// Other datasets: GetCellPoints() into a vtkIdList is thread safe once
+// called from a single thread.
+struct DataSetPointsToCells
+{
+  ArrayList *Arrays;
+  vtkDataSet *Input;
+  vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *ptIds = this->PointIds.Local();
+    for ( ; cellId < endCellId; ++cellId )
+      {
+      this->Input->GetCellPoints(cellId, ptIds);
+      vtkIdType numPts = ptIds->GetNumberOfIds();
+      if (numPts > 0)
+        {
+        this->Arrays->Average(static_cast<int>(numPts),
+                              ptIds->GetPointer(0), cellId);
+        }
+      else
+        {
+        this->Arrays->AssignNullValue(cellId);
+        }
+      }
+  }
+};
+}
+
+//----------------------------------------------------------------------------
+void vtkPointDataToCellData::ThreadedInterpolateCellData(vtkDataSet *input,
+                                                         vtkDataSet *output)
+{
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkCellData *outCD = output->GetCellData();
+
+  vtkPointData *inPD = input->GetPointData();
+  vtkDataSetAttributes::FieldList pfl(1);
+  pfl.InitializeFieldList(inPD);
+  outCD->InterpolateAllocate(pfl, numCells, numCells);
+
+  ArrayList arrays;
+  arrays.AddArrays(numCells, pfl, 0, inPD, outCD);
+  if (arrays.GetNumberOfArrays() == 0)
+    {
+    return;
+    }
+
+  vtkImageData *image = vtkImageData::SafeDownCast(input);
+  vtkRectilinearGrid *rGrid = vtkRectilinearGrid::SafeDownCast(input);
+  vtkStructuredGrid *sGrid = vtkStructuredGrid::SafeDownCast(input);
+  if (image || rGrid || sGrid)
+    {
+    StructuredPointsToCells worker;
+    worker.Arrays = &arrays;
+    if (image)
+      {
+      image->GetDimensions(worker.Dims);
+      }
+    else if (rGrid)
+      {
+      rGrid->GetDimensions(worker.Dims);
+      }
+    else
+      {
+      sGrid->GetDimensions(worker.Dims);
+      }
+    vtkSMPTools::For(0, numCells, worker);
+    }
+  else
+    {
+    vtkIdList *ptIds = vtkIdList::New();
+    input->GetCellPoints(0, ptIds);
+    ptIds->Delete();
+    DataSetPointsToCells worker;
+    worker.Arrays = &arrays;
+    worker.Input = input;
+    vtkSMPTools::For(0, numCells, worker);
+    }
+  this->UpdateProgress(1.0);
 }
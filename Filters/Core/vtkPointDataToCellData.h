@@ -19,6 +19,11 @@
 // The method of transformation is based on averaging the data
 // values of all points defining a particular cell. Optionally, the input point
 // data can be passed through to the output as well.
+//
+// The cell data may be computed in parallel with vtkSMPTools (see
+// EnableSMP). The points of the cells of image data, rectilinear and
+// structured grids are then taken from their structure, and all the data
+// arrays are averaged together for each cell.
 
 // .SECTION Caveats
 // This filter is an abstract filter, that is, the output is an abstract type
@@ -51,6 +56,15 @@ public:
   vtkGetMacro(PassPointData,int);
   vtkBooleanMacro(PassPointData,int);
 
+  // Description:
+  // Compute the cell data in parallel with vtkSMPTools. The values are
+  // the averages of the serial execution, up to rounding. The serial
+  // execution is used when a point array does not derive from
+  // vtkDataArray. Off by default.
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+
 protected:
   vtkPointDataToCellData();
   ~vtkPointDataToCellData() {}
@@ -59,7 +73,11 @@ protected:
                           vtkInformationVector** inputVector,
                           vtkInformationVector* outputVector);
 
+  // Threaded implementation of the interpolation, see EnableSMP.
+  void ThreadedInterpolateCellData(vtkDataSet *input, vtkDataSet *output);
+
   int PassPointData;
+  bool EnableSMP;
 private:
   vtkPointDataToCellData(const vtkPointDataToCellData&);  // Not implemented.
   void operator=(const vtkPointDataToCellData&);  // Not implemented.
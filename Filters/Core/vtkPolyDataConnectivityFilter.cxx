@@ -17,6 +17,8 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
+#include "vtkCellSubsetHelper.h"
+#include "vtkConnectedRegionsHelper.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
@@ -28,6 +30,7 @@
 #include "vtkPolyData.h"
 
 #include <algorithm> // for fill_n
+#include <vector>
 
 vtkStandardNewMacro(vtkPolyDataConnectivityFilter);
 
@@ -58,6 +61,7 @@ vtkPolyDataConnectivityFilter::vtkPolyDataConnectivityFilter()
   this->VisitedPointIds = vtkIdList::New();
 
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->EnableSMP = false;
 }
 
 vtkPolyDataConnectivityFilter::~vtkPolyDataConnectivityFilter()
@@ -131,6 +135,22 @@ int vtkPolyDataConnectivityFilter::RequestData(
       }
     }
 
+  // Set the desired precision for the points in the output.
+  int pointsDataType = inPts->GetDataType();
+  if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+    {
+    pointsDataType = VTK_FLOAT;
+    }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+    {
+    pointsDataType = VTK_DOUBLE;
+    }
+
+  if ( this->EnableSMP )
+    {
+    return this->ThreadedRequestData(input, pointsDataType, output);
+    }
+
   // Build cell structure
   //
   this->Mesh = vtkPolyData::New();
@@ -153,21 +173,7 @@ int vtkPolyDataConnectivityFilter::RequestData(
   this->NewScalars->SetName("RegionId");
   this->NewScalars->SetNumberOfTuples(numPts);
   newPts = vtkPoints::New();
-
-  // Set the desired precision for the points in the output.
-  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
-    {
-    newPts->SetDataType(inPts->GetDataType());
-    }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
-    {
-    newPts->SetDataType(VTK_FLOAT);
-    }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
-    {
-    newPts->SetDataType(VTK_DOUBLE);
-    }
-
+  newPts->SetDataType(pointsDataType);
   newPts->Allocate(numPts);
 
   // Traverse all cells marking those visited.  Each new search
@@ -446,6 +452,149 @@ int vtkPolyDataConnectivityFilter::RequestData(
   return 1;
 }
 
+// --------------------------------------------------------------------------
+// Label the regions concurrently (see vtkConnectedRegionsHelper), select
+// the cells of the extracted regions with a prefix sum, and let
+// vtkCellSubsetHelper build the output.
+int vtkPolyDataConnectivityFilter::ThreadedRequestData(vtkPolyData *input,
+                                                       int pointsDataType,
+                                                       vtkPolyData *output)
+{
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const vtkIdType numCells = input->GetNumberOfCells();
+
+  this->VisitedPointIds->Reset();
+
+  std::vector<unsigned char> connectable;
+  if ( this->InScalars )
+    {
+    connectable.resize(numCells);
+    vtkConnectedRegionsHelper::ClassifyCells(input, this->InScalars,
+      this->ScalarRange, this->FullScalarConnectivity != 0, &connectable[0]);
+    }
+  const unsigned char *connectablePtr =
+    (this->InScalars ? &connectable[0] : NULL);
+
+  std::vector<vtkIdType> regionIds(numCells);
+  std::vector<unsigned char> extracted;
+  this->RegionSizes->Reset();
+  if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
+  this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
+  this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION )
+    {
+    vtkIdType numRegions = vtkConnectedRegionsHelper::LabelRegions(
+      input, connectablePtr, &regionIds[0], this->RegionSizes);
+    this->UpdateProgress(0.5);
+
+    extracted.resize(numRegions + 1,
+      this->ExtractionMode == VTK_EXTRACT_ALL_REGIONS ? 1 : 0);
+    if ( this->ExtractionMode == VTK_EXTRACT_SPECIFIED_REGIONS )
+      {
+      for (vtkIdType i = 0; i < this->SpecifiedRegionIds->GetNumberOfIds();
+           i++)
+        {
+        vtkIdType regionId = this->SpecifiedRegionIds->GetId(i);
+        if ( regionId >= 0 && regionId < numRegions )
+          {
+          extracted[regionId] = 1;
+          }
+        }
+      }
+    else if ( this->ExtractionMode == VTK_EXTRACT_LARGEST_REGION )
+      {
+      vtkIdType largestRegionId = 0;
+      for (vtkIdType regionId = 1; regionId < numRegions; regionId++)
+        {
+        if ( this->RegionSizes->GetValue(regionId) >
+             this->RegionSizes->GetValue(largestRegionId) )
+          {
+          largestRegionId = regionId;
+          }
+        }
+      extracted[largestRegionId] = 1;
+      }
+    }
+  else // regions have been seeded, everything considered in same region
+    {
+    std::vector<unsigned char> seeds(numCells, 0);
+    if ( this->ExtractionMode == VTK_EXTRACT_CELL_SEEDED_REGIONS )
+      {
+      for (vtkIdType i = 0; i < this->Seeds->GetNumberOfIds(); i++)
+        {
+        vtkIdType cellId = this->Seeds->GetId(i);
+        if ( cellId >= 0 && cellId < numCells )
+          {
+          seeds[cellId] = 1;
+          }
+        }
+      }
+    else
+      {
+      std::vector<unsigned char> seedPoints(numPts, 0);
+      if ( this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS )
+        {
+        for (vtkIdType i = 0; i < this->Seeds->GetNumberOfIds(); i++)
+          {
+          vtkIdType pt = this->Seeds->GetId(i);
+          if ( pt >= 0 && pt < numPts )
+            {
+            seedPoints[pt] = 1;
+            }
+          }
+        }
+      else
+        {
+        vtkIdType minId = vtkConnectedRegionsHelper::FindClosestPoint(
+          input, this->ClosestPoint);
+        seedPoints[minId >= 0 ? minId : 0] = 1;
+        }
+      vtkConnectedRegionsHelper::FlagCellsUsingPoints(input, &seedPoints[0],
+                                                      &seeds[0]);
+      }
+    this->UpdateProgress(0.25);
+
+    this->RegionSizes->InsertValue(0,
+      vtkConnectedRegionsHelper::LabelSeededRegion(input, connectablePtr,
+                                                   &seeds[0], &regionIds[0]));
+    extracted.resize(1, 1);
+    this->UpdateProgress(0.5);
+    }
+
+  std::vector<vtkIdType> cellIds(numCells + 1);
+  vtkIdType numNewCells = vtkConnectedRegionsHelper::GatherCells(
+    numCells, &regionIds[0], &extracted[0], &cellIds[0]);
+  std::vector<vtkIdType> pointMap(numPts + 1);
+  vtkCellSubsetHelper::ExtractPolyDataCells(input, &cellIds[0], numNewCells,
+    pointsDataType, output, &pointMap[0]);
+  vtkIdType numNewPts = output->GetNumberOfPoints();
+
+  // if coloring regions; send down new scalar data
+  if ( this->ColorRegions )
+    {
+    vtkIdTypeArray *newScalars = vtkConnectedRegionsHelper::NewPointRegionIds(
+      input, &regionIds[0], &pointMap[0], numNewPts);
+    int idx = output->GetPointData()->AddArray(newScalars);
+    output->GetPointData()->SetActiveAttribute(idx,
+                                               vtkDataSetAttributes::SCALARS);
+    newScalars->Delete();
+    }
+
+  // All the output points are used by the extracted cells.
+  if ( this->MarkVisitedPointIds )
+    {
+    this->VisitedPointIds->SetNumberOfIds(numNewPts);
+    for (vtkIdType i = 0; i < numNewPts; i++)
+      {
+      this->VisitedPointIds->SetId(i, i);
+      }
+    }
+
+  vtkDebugMacro (<<"Extracted " << this->GetNumberOfExtractedRegions()
+                 << " region(s) and " << numNewCells << " cells");
+
+  return 1;
+}
+
 // Mark current cell as visited and assign region number.  Note:
 // traversal occurs across shared vertices.
 //
@@ -661,4 +810,5 @@ void vtkPolyDataConnectivityFilter::PrintSelf(ostream& os, vtkIndent indent)
     }
 
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Enable SMP: " << (this->EnableSMP ? "On\n" : "Off\n");
 }
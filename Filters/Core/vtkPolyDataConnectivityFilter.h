@@ -41,8 +41,13 @@
 // This use of ScalarConnectivity is particularly useful for selecting cells
 // for later processing.
 //
+// The regions may be found with several threads (see EnableSMP): a
+// concurrent union-find labels the components of the cells sharing points
+// instead of the wave propagation, then the regions are numbered and
+// extracted as by the serial execution.
+//
 // .SECTION See Also
-// vtkConnectivityFilter
+// vtkConnectivityFilter vtkConnectedRegionsHelper
 
 #ifndef vtkPolyDataConnectivityFilter_h
 #define vtkPolyDataConnectivityFilter_h
@@ -180,6 +185,22 @@ public:
   vtkSetMacro(OutputPointsPrecision,int);
   vtkGetMacro(OutputPointsPrecision,int);
 
+  // Description:
+  // Turn on/off the use of vtkSMPTools to find the regions (with a
+  // concurrent union-find, see vtkConnectedRegionsHelper) and to copy the
+  // extracted cells, their points and their data with several threads. The
+  // regions, their numbers and sizes, and the extracted cells are the same
+  // as with the serial execution, for all extraction modes and with scalar
+  // connectivity. The differences are: the output only has the points used
+  // by the extracted cells (the serial execution also keeps those of the
+  // other regions when extracting the largest or specified regions, hence
+  // VisitedPointIds), in the input order rather than in the traversal
+  // order. String arrays are copied by the calling thread. Off by
+  // default.
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+
 protected:
   vtkPolyDataConnectivityFilter();
   ~vtkPolyDataConnectivityFilter();
@@ -205,6 +226,10 @@ protected:
 
   void TraverseAndMark();
 
+  // Threaded implementation of RequestData(), see EnableSMP.
+  int ThreadedRequestData(vtkPolyData *input, int pointsDataType,
+                          vtkPolyData *output);
+
   // used to support algorithm execution
   vtkDataArray *CellScalars;
   vtkIdList *NeighborCellPointIds;
@@ -224,6 +249,7 @@ protected:
 
   int MarkVisitedPointIds;
   int OutputPointsPrecision;
+  bool EnableSMP;
 
 private:
   vtkPolyDataConnectivityFilter(const vtkPolyDataConnectivityFilter&);  // Not implemented.
@@ -24,9 +24,15 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkTriangleStrip.h"
 #include "vtkPriorityQueue.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkPolyDataNormals);
 
 // Construct with feature angle=30, splitting and consistency turned on,
@@ -44,6 +50,7 @@ vtkPolyDataNormals::vtkPolyDataNormals()
   // some internal data
   this->NumFlips = 0;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->EnableSMP = false;
   this->Wave = 0;
   this->Wave2 = 0;
   this->CellIds = 0;
@@ -58,6 +65,361 @@ vtkPolyDataNormals::vtkPolyDataNormals()
 #define VTK_CELL_NOT_VISITED     0
 #define VTK_CELL_VISITED         1
 
+namespace
+{
+// Normalize an accumulated point normal. Both the serial and the threaded
+// executions use this function so that they produce the same values.
+inline void vtkNormalizePointNormal(float *normal, double flipDirection)
+{
+  const double length = sqrt(normal[0] * normal[0] +
+                             normal[1] * normal[1] +
+                             normal[2] * normal[2]) * flipDirection;
+  if (length != 0.0)
+    {
+    normal[0] /= length;
+    normal[1] /= length;
+    normal[2] /= length;
+    }
+}
+
+// Return the index of the first occurrence of cellId in a list of cells.
+inline int vtkFindLinkIndex(const vtkIdType *cells, int ncells,
+                            vtkIdType cellId)
+{
+  int i = 0;
+  while (i < ncells && cells[i] != cellId)
+    {
+    ++i;
+    }
+  return i;
+}
+
+// Compute the normal of each polygon.
+class vtkPolyNormalsWorker
+{
+public:
+  vtkPolyData *Mesh;
+  vtkPoints *Points;
+  float *PolyNormals;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdType npts, *pts;
+    double n[3];
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      vtkPolygon::ComputeNormal(this->Points, npts, pts, n);
+      float *normal = this->PolyNormals + 3 * cellId;
+      normal[0] = static_cast<float>(n[0]);
+      normal[1] = static_cast<float>(n[1]);
+      normal[2] = static_cast<float>(n[2]);
+      }
+  }
+};
+
+// Store the number of cells using each point, to compute the offsets of the
+// point links in the per link entry arrays.
+class vtkLinkSizesWorker
+{
+public:
+  vtkPolyData *Mesh;
+  vtkIdType *Sizes;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    unsigned short ncells;
+    vtkIdType *cells;
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      this->Mesh->GetPointCells(ptId, ncells, cells);
+      this->Sizes[ptId] = ncells;
+      }
+  }
+};
+
+// Label the regions of cells around each point, separated by feature
+// edges, as vtkPolyDataNormals::MarkAndSplit() does. The label of each cell
+// is stored per entry of the point links, and the number of points to
+// create (the number of regions minus one) per point.
+class vtkMarkRegionsWorker
+{
+public:
+  vtkPolyData *Mesh;
+  const float *PolyNormals;
+  double CosAngle;
+  const vtkIdType *LinkOffsets;
+  int *Regions;
+  vtkIdType *NumberOfSplits;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellIds = this->CellIds.Local();
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      this->NumberOfSplits[ptId] = this->MarkRegions(ptId, cellIds);
+      }
+  }
+
+  // Return the point next to ptId in a cell which is not nei, to continue
+  // the traversal of the cells around ptId.
+  vtkIdType NextPoint(vtkIdType cellId, vtkIdType ptId, vtkIdType nei)
+  {
+    vtkIdType numPts, *pts, spot;
+    this->Mesh->GetCellPoints(cellId, numPts, pts);
+    for (spot=0; spot < numPts; spot++)
+      {
+      if ( pts[spot] == ptId )
+        {
+        break;
+        }
+      }
+    if (spot == 0)
+      {
+      return (pts[spot+1] != nei ? pts[spot+1] : pts[numPts-1]);
+      }
+    else if (spot == (numPts-1))
+      {
+      return (pts[spot-1] != nei ? pts[spot-1] : pts[0]);
+      }
+    return (pts[spot+1] != nei ? pts[spot+1] : pts[spot-1]);
+  }
+
+  vtkIdType MarkRegions(vtkIdType ptId, vtkIdList *cellIds)
+  {
+    unsigned short ncells;
+    vtkIdType *cells;
+    this->Mesh->GetPointCells(ptId,ncells,cells);
+    int *regions = this->Regions + this->LinkOffsets[ptId];
+    if ( ncells <= 1 )
+      {
+      std::fill_n(regions, ncells, 0);
+      return 0;
+      }
+
+    // The regions are stored at the first entry of each cell in the links,
+    // then copied to the other entries of cells using the point twice.
+    std::fill_n(regions, ncells, -1);
+    int numRegions = 0;
+    int i, j, k;
+    vtkIdType neiPt[2], nei, cellId, neiCellId;
+    double thisNormal[3], neiNormal[3];
+    for (j=0; j<ncells; j++)
+      {
+      if ( regions[vtkFindLinkIndex(cells, ncells, cells[j])] >= 0 )
+        {
+        continue;
+        }
+      regions[j] = numRegions;
+
+      // the two points next to ptId in the seed cell, as found by
+      // MarkAndSplit()
+      vtkIdType numPts, *pts, spot;
+      this->Mesh->GetCellPoints(cells[j],numPts,pts);
+      for (spot=0; spot < numPts; spot++)
+        {
+        if ( pts[spot] == ptId )
+          {
+          break;
+          }
+        }
+      if ( spot == 0 )
+        {
+        neiPt[0] = pts[spot+1];
+        neiPt[1] = pts[numPts-1];
+        }
+      else if ( spot == (numPts-1) )
+        {
+        neiPt[0] = pts[spot-1];
+        neiPt[1] = pts[0];
+        }
+      else
+        {
+        neiPt[0] = pts[spot+1];
+        neiPt[1] = pts[spot-1];
+        }
+
+      for (i=0; i<2; i++) //for each of the two edges of the seed cell
+        {
+        cellId = cells[j];
+        nei = neiPt[i];
+        while ( cellId >= 0 ) //while we can grow this region
+          {
+          this->Mesh->GetCellEdgeNeighbors(cellId,ptId,nei,cellIds);
+          if ( cellIds->GetNumberOfIds() == 1 &&
+               regions[(k=vtkFindLinkIndex(cells, ncells,
+                          (neiCellId=cellIds->GetId(0))))] < 0 )
+            {
+            const float *n0 = this->PolyNormals + 3 * cellId;
+            const float *n1 = this->PolyNormals + 3 * neiCellId;
+            thisNormal[0] = n0[0]; thisNormal[1] = n0[1]; thisNormal[2] = n0[2];
+            neiNormal[0] = n1[0]; neiNormal[1] = n1[1]; neiNormal[2] = n1[2];
+
+            if ( vtkMath::Dot(thisNormal,neiNormal) > this->CosAngle )
+              {
+              regions[k] = numRegions;
+              cellId = neiCellId;
+              nei = this->NextPoint(cellId, ptId, nei);
+              }
+            else
+              {
+              cellId = -1; //separated by edge angle
+              }
+            }
+          else
+            {
+            cellId = -1;//separated by previous visit, boundary, or non-manifold
+            }
+          }
+        }
+      numRegions++;
+      }
+
+    if ( numRegions <= 1 )
+      {
+      std::fill_n(regions, ncells, 0);
+      return 0;
+      }
+    for (j=0; j<ncells; j++)
+      {
+      regions[j] = regions[vtkFindLinkIndex(cells, ncells, cells[j])];
+      }
+    return numRegions - 1;
+  }
+};
+
+// Replace the split points in the connectivity of each cell by the point
+// created for the region of the cell.
+class vtkSplitCellsWorker
+{
+public:
+  vtkPolyData *OldMesh;
+  vtkPolyData *NewMesh;
+  const vtkIdType *LinkOffsets;
+  const int *Regions;
+  const vtkIdType *SplitOffsets;
+  vtkIdType NumberOfPoints;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdType npts, *pts, ptId;
+    unsigned short ncells;
+    vtkIdType *cells;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      this->NewMesh->GetCellPoints(cellId, npts, pts);
+      for (vtkIdType i = 0; i < npts; ++i)
+        {
+        ptId = pts[i];
+        this->OldMesh->GetPointCells(ptId, ncells, cells);
+        int region = this->Regions[this->LinkOffsets[ptId] +
+                                   vtkFindLinkIndex(cells, ncells, cellId)];
+        if (region > 0)
+          {
+          pts[i] = this->NumberOfPoints + this->SplitOffsets[ptId] +
+            region - 1;
+          }
+        }
+      }
+  }
+};
+
+// Fill the map of the output points to the input points.
+class vtkSplitMapWorker
+{
+public:
+  const vtkIdType *SplitOffsets;
+  vtkIdType NumberOfPoints;
+  vtkIdType *Map;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      this->Map[ptId] = ptId;
+      vtkIdType *newIds = this->Map + this->NumberOfPoints +
+        this->SplitOffsets[ptId];
+      std::fill(newIds, newIds + (this->SplitOffsets[ptId + 1] -
+                                  this->SplitOffsets[ptId]), ptId);
+      }
+  }
+};
+
+// Copy the input points to the output points.
+class vtkCopyPointsWorker
+{
+public:
+  vtkPoints *InPoints;
+  vtkPoints *OutPoints;
+  const vtkIdType *Map;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    double x[3];
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      this->InPoints->GetPoint(this->Map[ptId], x);
+      this->OutPoints->SetPoint(ptId, x);
+      }
+  }
+};
+
+// Sum the normals of the polygons using each input point, in the order of
+// the polygons as the serial execution does, once per region when the
+// point is split, and normalize the sums.
+class vtkPointNormalsWorker
+{
+public:
+  vtkPolyData *Mesh;
+  const float *PolyNormals;
+  const vtkIdType *LinkOffsets;
+  const int *Regions;
+  const vtkIdType *SplitOffsets;
+  vtkIdType NumberOfPoints;
+  double FlipDirection;
+  float *Normals;
+  vtkSMPThreadLocal<std::vector<float> > Sums;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::vector<float> &sums = this->Sums.Local();
+    unsigned short ncells;
+    vtkIdType *cells;
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      this->Mesh->GetPointCells(ptId, ncells, cells);
+      vtkIdType numRegions = 1;
+      const int *regions = NULL;
+      if (this->Regions)
+        {
+        numRegions += this->SplitOffsets[ptId + 1] - this->SplitOffsets[ptId];
+        regions = this->Regions + this->LinkOffsets[ptId];
+        }
+      sums.assign(3 * numRegions, 0.0f);
+      for (int i = 0; i < ncells; ++i)
+        {
+        float *sum = &sums[3 * (regions ? regions[i] : 0)];
+        const float *normal = this->PolyNormals + 3 * cells[i];
+        sum[0] += normal[0];
+        sum[1] += normal[1];
+        sum[2] += normal[2];
+        }
+      for (vtkIdType r = 0; r < numRegions; ++r)
+        {
+        vtkIdType outId = (r == 0 ? ptId : this->NumberOfPoints +
+                           this->SplitOffsets[ptId] + r - 1);
+        float *normal = this->Normals + 3 * outId;
+        normal[0] = sums[3 * r];
+        normal[1] = sums[3 * r + 1];
+        normal[2] = sums[3 * r + 2];
+        vtkNormalizePointNormal(normal, this->FlipDirection);
+        }
+      }
+  }
+};
+}
+
 // Generate normals for polygon meshes
 int vtkPolyDataNormals::RequestData(
   vtkInformation *vtkNotUsed(request),
@@ -91,6 +453,10 @@ int vtkPolyDataNormals::RequestData(
   double n[3];
   vtkCellArray *newPolys;
   vtkIdType ptId, oldId;
+  // With EnableSMP, the region of the cells using each point (per entry of
+  // the point links) and the offsets of the points created by splitting
+  std::vector<vtkIdType> linkOffsets, splitOffsets;
+  std::vector<int> regions;
 
   vtkDebugMacro(<<"Generating surface normals");
 
@@ -144,6 +510,16 @@ int vtkPolyDataNormals::RequestData(
     polys->Delete();
     numPolys = polys->GetNumberOfCells();//added some new triangles
     }
+  else if ( this->EnableSMP && inPolys->IsStorage32Bit() )
+    {
+    // cells stored as 32-bit integers are copied when accessed, which is
+    // not thread safe
+    polys = vtkCellArray::New();
+    polys->DeepCopy(inPolys);
+    polys->ConvertToIdTypeStorage();
+    this->OldMesh->SetPolys(polys);
+    polys->Delete();
+    }
   else
     {
     this->OldMesh->SetPolys(inPolys);
@@ -162,6 +538,8 @@ int vtkPolyDataNormals::RequestData(
   // create a copy because we're modifying it
   newPolys = vtkCellArray::New();
   newPolys->DeepCopy(polys);
+  // the split points are written directly in the connectivity
+  newPolys->ConvertToIdTypeStorage();
   this->NewMesh->SetPolys(newPolys);
   this->NewMesh->BuildCells(); //builds connectivity
 
@@ -323,19 +701,30 @@ int vtkPolyDataNormals::RequestData(
   this->PolyNormals->SetName("Normals");
   this->PolyNormals->SetNumberOfTuples(numPolys);
 
-  for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts);
-       cellId++ )
+  if (this->EnableSMP)
     {
-    if ((cellId % 1000) == 0)
+    vtkPolyNormalsWorker worker;
+    worker.Mesh = this->NewMesh;
+    worker.Points = inPts;
+    worker.PolyNormals = this->PolyNormals->GetPointer(0);
+    vtkSMPTools::For(0, numPolys, worker);
+    }
+  else
+    {
+    for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts);
+         cellId++ )
       {
-      this->UpdateProgress (0.333 + 0.333 * (double) cellId / (double) numPolys);
-      if (this->GetAbortExecute())
+      if ((cellId % 1000) == 0)
         {
-        break;
+        this->UpdateProgress (0.333 + 0.333 * (double) cellId / (double) numPolys);
+        if (this->GetAbortExecute())
+          {
+          break;
+          }
         }
+      vtkPolygon::ComputeNormal(inPts, npts, pts, n);
+      this->PolyNormals->SetTuple(cellId,n);
       }
-    vtkPolygon::ComputeNormal(inPts, npts, pts, n);
-    this->PolyNormals->SetTuple(cellId,n);
     }
 
   // Split mesh if sharp features
@@ -350,16 +739,63 @@ int vtkPolyDataNormals::RequestData(
     // to map new points into old points.
     //
     this->Map = vtkIdList::New();
-    this->Map->SetNumberOfIds(numPts);
-    for (i=0; i < numPts; i++)
+    if (this->EnableSMP)
       {
-      this->Map->SetId(i,i);
+      // Label the regions around all the points, then number the new
+      // points in the order in which MarkAndSplit() creates them.
+      linkOffsets.resize(numPts + 1);
+      vtkLinkSizesWorker sizes;
+      sizes.Mesh = this->OldMesh;
+      sizes.Sizes = &linkOffsets[0];
+      vtkSMPTools::For(0, numPts, sizes);
+      linkOffsets[numPts] = vtkSMPTools::ExclusiveScan(
+        linkOffsets.begin(), linkOffsets.begin() + numPts,
+        linkOffsets.begin(), static_cast<vtkIdType>(0));
+      regions.resize(linkOffsets[numPts] + 1);
+
+      splitOffsets.resize(numPts + 1);
+      vtkMarkRegionsWorker marker;
+      marker.Mesh = this->OldMesh;
+      marker.PolyNormals = this->PolyNormals->GetPointer(0);
+      marker.CosAngle = this->CosAngle;
+      marker.LinkOffsets = &linkOffsets[0];
+      marker.Regions = &regions[0];
+      marker.NumberOfSplits = &splitOffsets[0];
+      vtkSMPTools::For(0, numPts, marker);
+      splitOffsets[numPts] = vtkSMPTools::ExclusiveScan(
+        splitOffsets.begin(), splitOffsets.begin() + numPts,
+        splitOffsets.begin(), static_cast<vtkIdType>(0));
+      numNewPts = numPts + splitOffsets[numPts];
+
+      vtkSplitCellsWorker splitter;
+      splitter.OldMesh = this->OldMesh;
+      splitter.NewMesh = this->NewMesh;
+      splitter.LinkOffsets = &linkOffsets[0];
+      splitter.Regions = &regions[0];
+      splitter.SplitOffsets = &splitOffsets[0];
+      splitter.NumberOfPoints = numPts;
+      vtkSMPTools::For(0, numPolys, splitter);
+
+      this->Map->SetNumberOfIds(numNewPts);
+      vtkSplitMapWorker mapper;
+      mapper.SplitOffsets = &splitOffsets[0];
+      mapper.NumberOfPoints = numPts;
+      mapper.Map = this->Map->GetPointer(0);
+      vtkSMPTools::For(0, numPts, mapper);
       }
-
-    for (ptId=0; ptId < numPts; ptId++)
+    else
       {
-      this->MarkAndSplit(ptId);
-      }//for all input points
+      this->Map->SetNumberOfIds(numPts);
+      for (i=0; i < numPts; i++)
+        {
+        this->Map->SetId(i,i);
+        }
+
+      for (ptId=0; ptId < numPts; ptId++)
+        {
+        this->MarkAndSplit(ptId);
+        }//for all input points
+      }
 
     numNewPts = this->Map->GetNumberOfIds();
 
@@ -395,11 +831,26 @@ int vtkPolyDataNormals::RequestData(
       }
 
     newPts->SetNumberOfPoints(numNewPts);
-    for (ptId=0; ptId < numNewPts; ptId++)
+    if (this->EnableSMP)
+      {
+      vtkCopyPointsWorker copier;
+      copier.InPoints = inPts;
+      copier.OutPoints = newPts;
+      copier.Map = this->Map->GetPointer(0);
+      vtkSMPTools::For(0, numNewPts, copier);
+      for (ptId=0; ptId < numNewPts; ptId++)
+        {
+        outPD->CopyData(pd,this->Map->GetId(ptId),ptId);
+        }
+      }
+    else
       {
-      oldId = this->Map->GetId(ptId);
-      newPts->SetPoint(ptId,inPts->GetPoint(oldId));
-      outPD->CopyData(pd,oldId,ptId);
+      for (ptId=0; ptId < numNewPts; ptId++)
+        {
+        oldId = this->Map->GetId(ptId);
+        newPts->SetPoint(ptId,inPts->GetPoint(oldId));
+        outPD->CopyData(pd,oldId,ptId);
+        }
       }
     this->Map->Delete();
     } //splitting
@@ -436,7 +887,21 @@ int vtkPolyDataNormals::RequestData(
 
   float *fPolyNormals = this->PolyNormals->WritePointer(0, 3 * numPolys);
 
-  if (this->ComputePointNormals)
+  if (this->ComputePointNormals && this->EnableSMP)
+    {
+    // gather the polygon normals through the links of the input points
+    vtkPointNormalsWorker worker;
+    worker.Mesh = this->OldMesh;
+    worker.PolyNormals = fPolyNormals;
+    worker.LinkOffsets = this->Splitting ? &linkOffsets[0] : NULL;
+    worker.Regions = this->Splitting ? &regions[0] : NULL;
+    worker.SplitOffsets = this->Splitting ? &splitOffsets[0] : NULL;
+    worker.NumberOfPoints = numPts;
+    worker.FlipDirection = flipDirection;
+    worker.Normals = fNormals;
+    vtkSMPTools::For(0, numPts, worker);
+    }
+  else if (this->ComputePointNormals)
     {
     for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts);
          ++cellId)
@@ -451,16 +916,7 @@ int vtkPolyDataNormals::RequestData(
 
     for (i = 0; i < numNewPts; ++i)
       {
-      const double length = sqrt(fNormals[3 * i] * fNormals[3 * i] +
-                                 fNormals[3 * i + 1] * fNormals[3 * i + 1] +
-                                 fNormals[3 * i + 2] * fNormals[3 * i + 2]
-                                 ) * flipDirection;
-      if (length != 0.0)
-        {
-        fNormals[3 * i] /= length;
-        fNormals[3 * i + 1] /= length;
-        fNormals[3 * i + 2] /= length;
-        }
+      vtkNormalizePointNormal(fNormals + 3 * i, flipDirection);
       }
     }
 
@@ -753,5 +1209,6 @@ void vtkPolyDataNormals::PrintSelf(ostream& os, vtkIndent indent)
      << (this->NonManifoldTraversal ? "On\n" : "Off\n");
   os << indent << "Precision of the output points: "
      << this->OutputPointsPrecision << "\n";
+  os << indent << "Enable SMP: " << (this->EnableSMP ? "On\n" : "Off\n");
 }
 
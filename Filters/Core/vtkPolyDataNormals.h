@@ -135,6 +135,15 @@ public:
   vtkSetClampMacro(OutputPointsPrecision, int, SINGLE_PRECISION, DEFAULT_PRECISION);
   vtkGetMacro(OutputPointsPrecision, int);
 
+  // Description:
+  // Turn on/off the use of vtkSMPTools to compute the polygon normals, split
+  // the sharp edges and accumulate the point normals with several threads.
+  // The traversal enforcing consistent polygon ordering remains serial. The
+  // output is identical to the one of the serial execution. Off by default.
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+
 protected:
   vtkPolyDataNormals();
   ~vtkPolyDataNormals() {}
@@ -152,6 +161,7 @@ protected:
   int ComputeCellNormals;
   int NumFlips;
   int OutputPointsPrecision;
+  bool EnableSMP;
 
 private:
   vtkIdList *Wave;
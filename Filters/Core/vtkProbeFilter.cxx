@@ -17,15 +17,28 @@
 #include "vtkCell.h"
 #include "vtkCellData.h"
 #include "vtkCharArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkScratchPool.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkStructuredGrid.h"
+#include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <utility>
 #include <vector>
 
 vtkStandardNewMacro(vtkProbeFilter);
@@ -59,6 +72,9 @@ vtkProbeFilter::vtkProbeFilter()
   this->PassFieldArrays = 1;
   this->Tolerance = 1.0;
   this->ComputeTolerance = 1;
+  this->EnableSMP = false;
+
+  this->ScratchPool = vtkScratchPool::New();
 }
 
 //----------------------------------------------------------------------------
@@ -73,6 +89,7 @@ vtkProbeFilter::~vtkProbeFilter()
   this->ValidPoints = NULL;
   this->SetValidPointMaskArrayName(0);
   delete this->CellArrays;
+  this->ScratchPool->Delete();
 
   delete this->PointList;
   delete this->CellList;
@@ -271,9 +288,14 @@ void vtkProbeFilter::DoProbing(vtkDataSet *input, int srcIdx, vtkDataSet *source
     {
     vtkImageData *inImage = vtkImageData::SafeDownCast(input);
     vtkImageData *outImage = vtkImageData::SafeDownCast(output);
-    this->ProbePointsImageData(inImage, srcIdx, source, outImage);
+    if (!this->EnableSMP ||
+        !this->ProbePointsImageDataSMP(inImage, srcIdx, source, outImage))
+      {
+      this->ProbePointsImageData(inImage, srcIdx, source, outImage);
+      }
     }
-  else
+  else if (!this->EnableSMP ||
+           !this->ProbeEmptyPointsSMP(input, srcIdx, source, output))
     {
     this->ProbeEmptyPoints(input, srcIdx, source, output);
     }
@@ -323,6 +345,9 @@ void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input,
 
   char* maskArray = this->MaskPoints->GetPointer(0);
 
+  vtkScratchPool::Scope scope(this->ScratchPool);
+  vtkGenericCell *gcell = this->ScratchPool->GetGenericCell();
+
   tol2 = this->ComputeTolerance ? VTK_DOUBLE_MAX :
          (this->Tolerance * this->Tolerance);
 
@@ -349,10 +374,12 @@ void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input,
     input->GetPoint(ptId, x);
 
     // Find the cell that contains xyz and get it
-    vtkIdType cellId = source->FindCell(x,NULL,-1,tol2,subId,pcoords,weights);
+    vtkIdType cellId =
+      source->FindCell(x,NULL,gcell,-1,tol2,subId,pcoords,weights);
     if (cellId >= 0)
       {
-      cell = source->GetCell(cellId);
+      source->GetCell(cellId, gcell);
+      cell = gcell;
       if (this->ComputeTolerance)
         {
         // If ComputeTolerance is set, compute a tolerance proportional to the
@@ -471,6 +498,9 @@ void vtkProbeFilter::ProbePointsImageData(vtkImageData *input,
   vtkIdType numSrcCells = source->GetNumberOfCells();
   vtkIdType progressInterval = numSrcCells/20 + 1;
 
+  vtkScratchPool::Scope scope(this->ScratchPool);
+  vtkGenericCell *cell = this->ScratchPool->GetGenericCell();
+
   // Loop over all source cells
   int abort = 0;
   for (vtkIdType cellId = 0; cellId < numSrcCells && !abort; cellId++)
@@ -481,7 +511,7 @@ void vtkProbeFilter::ProbePointsImageData(vtkImageData *input,
       abort = GetAbortExecute();
       }
 
-    vtkCell * cell = source->GetCell(cellId);
+    source->GetCell(cellId, cell);
 
     // get coordinates of sampling grids
     double cellBounds[6];
@@ -569,6 +599,519 @@ void vtkProbeFilter::ProbePointsImageData(vtkImageData *input,
     }
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+#include "vtkArrayListTemplate.h" // For processing attribute data
+
+// Number of consecutive (sorted) points probed by a thread at a time.
+const vtkIdType VTK_PROBE_BATCH_SIZE = 1024;
+
+// Whether the cells of the source may be accessed, and located, from
+// several threads once the source was prepared by PrepareSource().
+bool CanProbeConcurrently(vtkDataSet *source)
+{
+  return (vtkImageData::SafeDownCast(source) ||
+          vtkRectilinearGrid::SafeDownCast(source) ||
+          vtkStructuredGrid::SafeDownCast(source) ||
+          vtkUnstructuredGrid::SafeDownCast(source) ||
+          vtkPolyData::SafeDownCast(source));
+}
+
+// Build, from the calling thread, everything the source builds on demand
+// when locating and accessing its cells: bounds, ghost arrays, cells,
+// links, and the point locator of FindCell(). It is only read afterwards.
+void PrepareSource(vtkDataSet *source, std::vector<double> &weights)
+{
+  double bounds[6];
+  source->GetBounds(bounds);
+  source->GetPointGhostArray();
+  source->GetCellGhostArray();
+  if (source->GetNumberOfPoints() < 1 || source->GetNumberOfCells() < 1)
+    {
+    return;
+    }
+  vtkNew<vtkGenericCell> cell;
+  source->GetCell(0, cell.GetPointer());
+  vtkNew<vtkIdList> cellIds;
+  source->GetPointCells(0, cellIds.GetPointer());
+  double x[3], pcoords[3];
+  int subId;
+  source->GetPoint(0, x);
+  source->FindCell(x, NULL, cell.GetPointer(), -1, 0.0, subId, pcoords,
+                   &weights[0]);
+}
+
+// Build the lists of the output arrays interpolated from the point data of
+// the source and copied from its cell data. Returns false when an output
+// array, other than the mask, would not be processed by these lists, in
+// which case the serial code must be used.
+bool BuildArrayLists(vtkDataSetAttributes::FieldList &pointList, int srcIdx,
+                     vtkDataSet *source, vtkPointData *outPD,
+                     const std::vector<vtkDataArray*> &cellOutputs,
+                     vtkIdType numPts, bool nullPoints,
+                     ArrayList &pointArrays, ArrayList &cellArrays)
+{
+  vtkPointData *pd = source->GetPointData();
+  vtkCellData *cd = source->GetCellData();
+
+  // The output arrays that are written, interpolated or nulled.
+  std::vector<vtkAbstractArray*> written;
+  for (int i = 0; i < pointList.GetNumberOfFields(); ++i)
+    {
+    int outIdx = pointList.GetFieldIndex(i);
+    if (outIdx >= 0 && (nullPoints || pointList.GetDSAIndex(srcIdx, i) >= 0))
+      {
+      written.push_back(outPD->GetAbstractArray(outIdx));
+      }
+    }
+  vtkNew<vtkPointData> cellOutPD;
+  for (std::vector<vtkDataArray*>::const_iterator it = cellOutputs.begin();
+       it != cellOutputs.end(); ++it)
+    {
+    cellOutPD->AddArray(*it);
+    if (nullPoints || cd->GetArray((*it)->GetName()))
+      {
+      written.push_back(*it);
+      }
+    }
+
+  pointArrays.AddArrays(numPts, pointList, srcIdx, pd, outPD);
+  cellArrays.AddArrays(numPts, cd, cellOutPD.GetPointer());
+
+  std::vector<vtkAbstractArray*> processed;
+  ArrayList *lists[2] = { &pointArrays, &cellArrays };
+  for (int i = 0; i < 2; ++i)
+    {
+    for (std::vector<BaseArrayPair*>::iterator it = lists[i]->Arrays.begin();
+         it != lists[i]->Arrays.end(); ++it)
+      {
+      processed.push_back((*it)->OutputArray.GetPointer());
+      }
+    }
+  for (std::vector<vtkAbstractArray*>::iterator it = written.begin();
+       it != written.end(); ++it)
+    {
+    if (std::find(processed.begin(), processed.end(), *it) == processed.end())
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+// Interleave the low 10 bits of an integer with zeros (Morton order).
+vtkTypeUInt32 SpreadBits(vtkTypeUInt32 v)
+{
+  v = (v | (v << 16)) & 0x030000FF;
+  v = (v | (v << 8)) & 0x0300F00F;
+  v = (v | (v << 4)) & 0x030C30C3;
+  v = (v | (v << 2)) & 0x09249249;
+  return v;
+}
+
+// Compute the position along a Z-order curve of the points to probe, so
+// that sorting them groups the points close to each other (which are
+// likely in the same cells).
+struct ComputeMortonKeys
+{
+  vtkDataSet *Input;
+  std::pair<vtkTypeUInt32, vtkIdType> *Keys;
+  double Origin[3];
+  double Scale[3];
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    double x[3];
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Input->GetPoint(this->Keys[i].second, x);
+      vtkTypeUInt32 key = 0;
+      for (int j = 0; j < 3; ++j)
+        {
+        double c = (x[j] - this->Origin[j]) * this->Scale[j];
+        vtkTypeUInt32 ic = static_cast<vtkTypeUInt32>(
+          std::min(std::max(c, 0.0), 1023.0));
+        key |= SpreadBits(ic) << j;
+        }
+      this->Keys[i].first = key;
+      }
+  }
+};
+
+// Probe a range of the sorted points, as vtkProbeFilter::ProbeEmptyPoints()
+// does.
+struct ProbePoints
+{
+  vtkDataSet *Input;
+  vtkDataSet *Source;
+  const std::pair<vtkTypeUInt32, vtkIdType> *Points;
+  ArrayList *PointArrays;
+  ArrayList *CellArrays;
+  char *Mask;
+  char *Hits;
+  double Tol2;
+  bool ComputeTolerance;
+  bool NullPoints;
+  size_t NumberOfWeights;
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+  vtkSMPThreadLocal<std::vector<double> > Weights;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkGenericCell *cell = this->Cell.Local();
+    std::vector<double> &weights = this->Weights.Local();
+    weights.resize(this->NumberOfWeights);
+    double x[3], pcoords[3];
+    int subId;
+
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      vtkIdType ptId = this->Points[i].second;
+      this->Input->GetPoint(ptId, x);
+
+      // Find the cell that contains xyz and get it
+      vtkIdType cellId = this->Source->FindCell(x, NULL, cell, -1, this->Tol2,
+                                                subId, pcoords, &weights[0]);
+      if (cellId >= 0)
+        {
+        this->Source->GetCell(cellId, cell);
+        if (this->ComputeTolerance)
+          {
+          double dist2;
+          double closestPoint[3];
+          cell->EvaluatePosition(x, closestPoint, subId, pcoords, dist2,
+                                 &weights[0]);
+          if (dist2 > (cell->GetLength2() * CELL_TOLERANCE_FACTOR_SQR))
+            {
+            cellId = -1;
+            }
+          }
+        }
+
+      if (cellId >= 0)
+        {
+        this->PointArrays->Interpolate(
+          cell->PointIds->GetNumberOfIds(), cell->PointIds->GetPointer(0),
+          &weights[0], ptId);
+        this->CellArrays->Copy(cellId, ptId);
+        this->Mask[ptId] = static_cast<char>(1);
+        this->Hits[ptId] = static_cast<char>(1);
+        }
+      else if (this->NullPoints)
+        {
+        this->PointArrays->AssignNullValue(ptId);
+        this->CellArrays->AssignNullValue(ptId);
+        }
+      }
+  }
+};
+
+// The sampling of an image data input.
+struct ImageSampling
+{
+  double Start[3];
+  double Spacing[3];
+  int Dim[3];
+};
+
+// Find, for a range of source cells, the image points that they contain as
+// vtkProbeFilter::ProbePointsImageData() does.
+struct FindImagePointCells
+{
+  vtkDataSet *Source;
+  ImageSampling Sampling;
+  double UserTol2;
+  bool ComputeTolerance;
+  size_t NumberOfWeights;
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+  vtkSMPThreadLocal<std::vector<double> > Weights;
+  // (point, cell) pairs
+  vtkSMPThreadLocal<std::vector<std::pair<vtkIdType, vtkIdType> > > Hits;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkGenericCell *cell = this->Cell.Local();
+    std::vector<double> &weights = this->Weights.Local();
+    weights.resize(this->NumberOfWeights);
+    std::vector<std::pair<vtkIdType, vtkIdType> > &hits = this->Hits.Local();
+    const double *start = this->Sampling.Start;
+    const double *spacing = this->Sampling.Spacing;
+    const int *dim = this->Sampling.Dim;
+
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      this->Source->GetCell(cellId, cell);
+
+      double cellBounds[6];
+      cell->GetBounds(cellBounds);
+
+      int idxBounds[6];
+      for (int i = 0; i < 3; ++i)
+        {
+        GetPointIdsInRange(cellBounds[2*i], cellBounds[2*i+1], start[i],
+          spacing[i], dim[i], idxBounds[2*i], idxBounds[2*i+1]);
+        }
+      if ((idxBounds[1] - idxBounds[0]) < 0 ||
+          (idxBounds[3] - idxBounds[2]) < 0 ||
+          (idxBounds[5] - idxBounds[4]) < 0)
+        {
+        continue;
+        }
+
+      double tol2 = this->ComputeTolerance ?
+                    (CELL_TOLERANCE_FACTOR_SQR * cell->GetLength2()) :
+                    this->UserTol2;
+      for (int iz=idxBounds[4]; iz<=idxBounds[5]; iz++)
+        {
+        double p[3];
+        p[2] = start[2] + iz*spacing[2];
+        for (int iy=idxBounds[2]; iy<=idxBounds[3]; iy++)
+          {
+          p[1] = start[1] + iy*spacing[1];
+          for (int ix=idxBounds[0]; ix<=idxBounds[1]; ix++)
+            {
+            p[0] = start[0] + ix*spacing[0];
+
+            double closestPoint[3], pcoords[3];
+            double dist2;
+            int subId;
+            int inside = cell->EvaluatePosition(p, closestPoint, subId,
+                                                pcoords, dist2, &weights[0]);
+            if ((inside == 1) && (dist2 <= tol2))
+              {
+              hits.push_back(std::make_pair(
+                ix + static_cast<vtkIdType>(dim[0])*(iy + dim[1]*iz),
+                cellId));
+              }
+            }
+          }
+        }
+      }
+  }
+};
+
+// Interpolate the data of the image points from the cells found for them,
+// or null the points that were not found, for a range of points.
+struct ProbeImagePoints
+{
+  vtkDataSet *Source;
+  ImageSampling Sampling;
+  const vtkIdType *PointCells;
+  ArrayList *PointArrays;
+  ArrayList *CellArrays;
+  char *Mask;
+  bool NullPoints;
+  size_t NumberOfWeights;
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+  vtkSMPThreadLocal<std::vector<double> > Weights;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkGenericCell *cell = this->Cell.Local();
+    std::vector<double> &weights = this->Weights.Local();
+    weights.resize(this->NumberOfWeights);
+    const double *start = this->Sampling.Start;
+    const double *spacing = this->Sampling.Spacing;
+    const int *dim = this->Sampling.Dim;
+    vtkIdType sliceSize = static_cast<vtkIdType>(dim[0]) * dim[1];
+
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      vtkIdType cellId = this->PointCells[ptId];
+      if (cellId < 0)
+        {
+        if (this->NullPoints && !this->Mask[ptId])
+          {
+          this->PointArrays->AssignNullValue(ptId);
+          this->CellArrays->AssignNullValue(ptId);
+          }
+        continue;
+        }
+
+      // Evaluate the cell at the point again to get the weights.
+      int ix = static_cast<int>(ptId % dim[0]);
+      int iy = static_cast<int>((ptId / dim[0]) % dim[1]);
+      int iz = static_cast<int>(ptId / sliceSize);
+      double p[3], closestPoint[3], pcoords[3], dist2;
+      int subId;
+      p[0] = start[0] + ix*spacing[0];
+      p[1] = start[1] + iy*spacing[1];
+      p[2] = start[2] + iz*spacing[2];
+      this->Source->GetCell(cellId, cell);
+      cell->EvaluatePosition(p, closestPoint, subId, pcoords, dist2,
+                             &weights[0]);
+
+      this->PointArrays->Interpolate(
+        cell->PointIds->GetNumberOfIds(), cell->PointIds->GetPointer(0),
+        &weights[0], ptId);
+      this->CellArrays->Copy(cellId, ptId);
+      this->Mask[ptId] = static_cast<char>(1);
+      }
+  }
+};
+}
+
+//----------------------------------------------------------------------------
+bool vtkProbeFilter::ProbeEmptyPointsSMP(vtkDataSet *input, int srcIdx,
+  vtkDataSet *source, vtkDataSet *output)
+{
+  if (!CanProbeConcurrently(source))
+    {
+    return false;
+    }
+
+  vtkDebugMacro(<<"Probing data with threads");
+
+  size_t numWeights = std::max(source->GetMaxCellSize(), 256);
+  std::vector<double> weights(numWeights);
+  PrepareSource(source, weights);
+
+  vtkIdType numPts = input->GetNumberOfPoints();
+  ArrayList pointArrays, cellArrays;
+  if (!BuildArrayLists(*this->PointList, srcIdx, source,
+                       output->GetPointData(), *this->CellArrays, numPts,
+                       this->UseNullPoint, pointArrays, cellArrays))
+    {
+    return false;
+    }
+
+  // Sort the points that were not probed yet along a space filling curve,
+  // so that each batch of points covers a compact region of the source.
+  char* maskArray = this->MaskPoints->GetPointer(0);
+  std::vector<std::pair<vtkTypeUInt32, vtkIdType> > points;
+  points.reserve(numPts);
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+    {
+    if (maskArray[ptId] != static_cast<char>(1))
+      {
+      points.push_back(std::make_pair(static_cast<vtkTypeUInt32>(0), ptId));
+      }
+    }
+  vtkIdType numProbed = static_cast<vtkIdType>(points.size());
+  if (numProbed == 0)
+    {
+    return true;
+    }
+
+  ComputeMortonKeys keys;
+  keys.Input = input;
+  keys.Keys = &points[0];
+  double bounds[6];
+  input->GetBounds(bounds);
+  for (int i = 0; i < 3; ++i)
+    {
+    keys.Origin[i] = bounds[2*i];
+    keys.Scale[i] = (bounds[2*i+1] > bounds[2*i] ?
+                     1024.0 / (bounds[2*i+1] - bounds[2*i]) : 0.0);
+    }
+  vtkSMPTools::For(0, numProbed, keys);
+  vtkSMPTools::Sort(points.begin(), points.end());
+
+  std::vector<char> hits(numPts, 0);
+  ProbePoints probe;
+  probe.Input = input;
+  probe.Source = source;
+  probe.Points = &points[0];
+  probe.PointArrays = &pointArrays;
+  probe.CellArrays = &cellArrays;
+  probe.Mask = maskArray;
+  probe.Hits = &hits[0];
+  probe.Tol2 = this->ComputeTolerance ? VTK_DOUBLE_MAX :
+               (this->Tolerance * this->Tolerance);
+  probe.ComputeTolerance = this->ComputeTolerance;
+  probe.NullPoints = this->UseNullPoint;
+  probe.NumberOfWeights = numWeights;
+  vtkSMPTools::For(0, numProbed, VTK_PROBE_BATCH_SIZE, probe);
+
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+    {
+    if (hits[ptId])
+      {
+      this->ValidPoints->InsertNextValue(ptId);
+      this->NumberOfValidPoints++;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkProbeFilter::ProbePointsImageDataSMP(vtkImageData *input,
+  int srcIdx, vtkDataSet *source, vtkImageData *output)
+{
+  if (!CanProbeConcurrently(source))
+    {
+    return false;
+    }
+
+  size_t numWeights = std::max(source->GetMaxCellSize(), 256);
+  std::vector<double> weights(numWeights);
+  PrepareSource(source, weights);
+
+  vtkIdType numPts = input->GetNumberOfPoints();
+  ArrayList pointArrays, cellArrays;
+  if (!BuildArrayLists(*this->PointList, srcIdx, source,
+                       output->GetPointData(), *this->CellArrays, numPts,
+                       this->UseNullPoint, pointArrays, cellArrays))
+    {
+    return false;
+    }
+
+  ImageSampling sampling;
+  input->GetSpacing(sampling.Spacing);
+  int extent[6];
+  input->GetExtent(extent);
+  input->GetDimensions(sampling.Dim);
+  input->GetOrigin(sampling.Start);
+  sampling.Start[0] += static_cast<double>(extent[0]) * sampling.Spacing[0];
+  sampling.Start[1] += static_cast<double>(extent[2]) * sampling.Spacing[1];
+  sampling.Start[2] += static_cast<double>(extent[4]) * sampling.Spacing[2];
+
+  // Find the points in each source cell. When several cells contain a
+  // point, the serial code keeps the data of the last one.
+  FindImagePointCells find;
+  find.Source = source;
+  find.Sampling = sampling;
+  find.UserTol2 = this->Tolerance * this->Tolerance;
+  find.ComputeTolerance = this->ComputeTolerance;
+  find.NumberOfWeights = numWeights;
+  vtkSMPTools::For(0, source->GetNumberOfCells(), find);
+
+  std::vector<vtkIdType> pointCells(numPts, -1);
+  typedef std::vector<std::pair<vtkIdType, vtkIdType> > HitVector;
+  for (vtkSMPThreadLocal<HitVector>::iterator it = find.Hits.begin();
+       it != find.Hits.end(); ++it)
+    {
+    for (HitVector::iterator hit = it->begin(); hit != it->end(); ++hit)
+      {
+      pointCells[hit->first] = std::max(pointCells[hit->first], hit->second);
+      }
+    }
+
+  char* maskArray = this->MaskPoints->GetPointer(0);
+  ProbeImagePoints probe;
+  probe.Source = source;
+  probe.Sampling = sampling;
+  probe.PointCells = &pointCells[0];
+  probe.PointArrays = &pointArrays;
+  probe.CellArrays = &cellArrays;
+  probe.Mask = maskArray;
+  probe.NullPoints = this->UseNullPoint;
+  probe.NumberOfWeights = numWeights;
+  vtkSMPTools::For(0, numPts, probe);
+
+  // populate ValidPoints
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    if (maskArray[i])
+      {
+      this->ValidPoints->InsertNextValue(i);
+      this->NumberOfValidPoints++;
+      }
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 int vtkProbeFilter::RequestInformation(
   vtkInformation *vtkNotUsed(request),
@@ -726,4 +1269,5 @@ void vtkProbeFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "ValidPoints: " << this->ValidPoints << "\n";
   os << indent << "PassFieldArrays: "
      << (this->PassFieldArrays? "On" : " Off") << "\n";
+  os << indent << "EnableSMP: " << (this->EnableSMP ? "On" : "Off") << "\n";
 }
@@ -31,6 +31,9 @@
 // rendering techniques can be used to visualize the results. Another example:
 // a line or curve can be used to probe data to produce x-y plots along
 // that line or curve.
+//
+// When EnableSMP is on, the points are probed in parallel with vtkSMPTools.
+// The output is the same as the serial one.
 
 #ifndef vtkProbeFilter_h
 #define vtkProbeFilter_h
@@ -43,6 +46,7 @@ class vtkIdTypeArray;
 class vtkCharArray;
 class vtkMaskPoints;
 class vtkImageData;
+class vtkScratchPool;
 
 class VTKFILTERSCORE_EXPORT vtkProbeFilter : public vtkDataSetAlgorithm
 {
@@ -127,6 +131,18 @@ public:
   vtkBooleanMacro(ComputeTolerance, bool);
   vtkGetMacro(ComputeTolerance, bool);
 
+  // Description:
+  // When this flag is on (default is off), the points are probed in
+  // parallel with vtkSMPTools. The input points are sorted along a space
+  // filling curve and probed in batches, each thread using its own cell and
+  // weights, and the locator of the source (or its structure) is built once
+  // before being queried concurrently. Image data inputs are probed cell by
+  // cell, as in serial. Sources other than image data, rectilinear,
+  // structured and unstructured grids and polydata are probed serially.
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+
 //BTX
 protected:
   vtkProbeFilter();
@@ -140,6 +156,7 @@ protected:
 
   double Tolerance;
   bool ComputeTolerance;
+  bool EnableSMP;
 
   virtual int RequestData(vtkInformation *, vtkInformationVector **,
     vtkInformationVector *);
@@ -186,6 +203,8 @@ protected:
 
   vtkDataSetAttributes::FieldList* CellList;
   vtkDataSetAttributes::FieldList* PointList;
+
+  vtkScratchPool *ScratchPool; // cells reused from one execution to the next
 private:
   vtkProbeFilter(const vtkProbeFilter&);  // Not implemented.
   void operator=(const vtkProbeFilter&);  // Not implemented.
@@ -197,6 +216,12 @@ private:
   // A faster implementation for vtkImageData input.
   void ProbePointsImageData(vtkImageData *input, int srcIdx, vtkDataSet *source,
     vtkImageData *output);
+  // Threaded versions of the two methods above. They return false, without
+  // probing, when the source cannot be probed from several threads.
+  bool ProbeEmptyPointsSMP(vtkDataSet *input, int srcIdx, vtkDataSet *source,
+    vtkDataSet *output);
+  bool ProbePointsImageDataSMP(vtkImageData *input, int srcIdx,
+    vtkDataSet *source, vtkImageData *output);
 
   class vtkVectorOfArrays;
   vtkVectorOfArrays* CellArrays;
@@ -24,11 +24,54 @@
 #include "vtkUnstructuredGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkMath.h"
+#include "vtkCellSubsetHelper.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 
 #include <algorithm>
+#include <vector>
 
 vtkStandardNewMacro(vtkThreshold);
 
+namespace
+{
+// Evaluate the criterion on the cells. The first pass stores 1 in Offsets
+// for the kept cells; once Offsets is summed, the second pass stores the
+// ids of the kept cells in CellIds.
+class vtkThresholdCellsWorker
+{
+public:
+  vtkThreshold *Self;
+  vtkDataSet *Input;
+  vtkDataArray *Scalars;
+  bool UsePointScalars;
+  vtkIdType *Offsets;
+  vtkIdType *CellIds;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      if ( this->CellIds )
+        {
+        if ( this->Offsets[cellId+1] != this->Offsets[cellId] )
+          {
+          this->CellIds[this->Offsets[cellId]] = cellId;
+          }
+        continue;
+        }
+      this->Input->GetCellPoints(cellId, cellPts);
+      this->Offsets[cellId] = (cellPts->GetNumberOfIds() > 0 &&
+                               this->Self->KeepCell(this->Scalars, cellId,
+                                                    cellPts,
+                                                    this->UsePointScalars));
+      }
+  }
+};
+}
+
 // Construct with lower threshold=0, upper threshold=1, and threshold
 // function=upper AllScalars=1.
 vtkThreshold::vtkThreshold()
@@ -47,6 +90,7 @@ vtkThreshold::vtkThreshold()
                                vtkDataSetAttributes::SCALARS);
 
   this->UseContinuousCellRange = 0;
+  this->EnableSMP = false;
 }
 
 vtkThreshold::~vtkThreshold()
@@ -133,38 +177,41 @@ int vtkThreshold::RequestData(
     return 1;
     }
 
-  outPD->CopyGlobalIdsOn();
-  outPD->CopyAllocate(pd);
-  outCD->CopyGlobalIdsOn();
-  outCD->CopyAllocate(cd);
-
-  numPts = input->GetNumberOfPoints();
-  output->Allocate(input->GetNumberOfCells());
-
-  newPoints = vtkPoints::New();
+  // are we using pointScalars?
+  int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
+  bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
 
   // set precision for the points in the output
+  int pointsDataType = VTK_FLOAT;
   if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
     {
     vtkPointSet *inputPointSet = vtkPointSet::SafeDownCast(input);
     if(inputPointSet && inputPointSet->GetPoints())
       {
-      newPoints->SetDataType(inputPointSet->GetPoints()->GetDataType());
-      }
-    else
-      {
-      newPoints->SetDataType(VTK_FLOAT);
+      pointsDataType = inputPointSet->GetPoints()->GetDataType();
       }
     }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
     {
-    newPoints->SetDataType(VTK_FLOAT);
+    pointsDataType = VTK_DOUBLE;
     }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+
+  if (this->EnableSMP)
     {
-    newPoints->SetDataType(VTK_DOUBLE);
+    return this->ThreadedRequestData(input, inScalars, usePointScalars,
+                                     pointsDataType, output);
     }
 
+  outPD->CopyGlobalIdsOn();
+  outPD->CopyAllocate(pd);
+  outCD->CopyGlobalIdsOn();
+  outCD->CopyAllocate(cd);
+
+  numPts = input->GetNumberOfPoints();
+  output->Allocate(input->GetNumberOfCells());
+
+  newPoints = vtkPoints::New();
+  newPoints->SetDataType(pointsDataType);
   newPoints->Allocate(numPts);
 
   pointMap = vtkIdList::New(); //maps old point ids into new
@@ -176,10 +223,6 @@ int vtkThreshold::RequestData(
 
   newCellPts = vtkIdList::New();
 
-  // are we using pointScalars?
-  int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
-  bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
-
   // Check that the scalars of each cell satisfy the threshold criterion
   for (cellId=0; cellId < input->GetNumberOfCells(); cellId++)
     {
@@ -187,38 +230,7 @@ int vtkThreshold::RequestData(
     cellPts = cell->GetPointIds();
     numCellPts = cell->GetNumberOfPoints();
 
-    if ( usePointScalars )
-      {
-      if (this->AllScalars)
-        {
-        keepCell = 1;
-        for ( i=0; keepCell && (i < numCellPts); i++)
-          {
-          ptId = cellPts->GetId(i);
-          keepCell = this->EvaluateComponents( inScalars, ptId );
-          }
-        }
-      else
-        {
-        if(!this->UseContinuousCellRange)
-          {
-          keepCell = 0;
-          for ( i=0; (!keepCell) && (i < numCellPts); i++)
-            {
-            ptId = cellPts->GetId(i);
-            keepCell = this->EvaluateComponents( inScalars, ptId );
-            }
-          }
-        else
-          {
-          keepCell = this->EvaluateCell(inScalars, cellPts, numCellPts);
-          }
-        }
-      }
-    else //use cell scalars
-      {
-      keepCell = this->EvaluateComponents( inScalars, cellId );
-      }
+    keepCell = this->KeepCell(inScalars, cellId, cellPts, usePointScalars);
 
     if (  numCellPts > 0 && keepCell )
       {
@@ -266,6 +278,97 @@ int vtkThreshold::RequestData(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkThreshold::KeepCell( vtkDataArray *inScalars, vtkIdType cellId,
+                            vtkIdList* cellPts, bool usePointScalars )
+{
+  int i, keepCell;
+  vtkIdType ptId;
+  int numCellPts = cellPts->GetNumberOfIds();
+
+  if ( usePointScalars )
+    {
+    if (this->AllScalars)
+      {
+      keepCell = 1;
+      for ( i=0; keepCell && (i < numCellPts); i++)
+        {
+        ptId = cellPts->GetId(i);
+        keepCell = this->EvaluateComponents( inScalars, ptId );
+        }
+      }
+    else
+      {
+      if(!this->UseContinuousCellRange)
+        {
+        keepCell = 0;
+        for ( i=0; (!keepCell) && (i < numCellPts); i++)
+          {
+          ptId = cellPts->GetId(i);
+          keepCell = this->EvaluateComponents( inScalars, ptId );
+          }
+        }
+      else
+        {
+        keepCell = this->EvaluateCell(inScalars, cellPts, numCellPts);
+        }
+      }
+    }
+  else //use cell scalars
+    {
+    keepCell = this->EvaluateComponents( inScalars, cellId );
+    }
+
+  return keepCell;
+}
+
+//----------------------------------------------------------------------------
+// Classify the cells concurrently, gather the ids of the kept cells with a
+// prefix sum, and let vtkCellSubsetHelper build the output. The points are
+// numbered in the order of their first use, as by the serial execution.
+int vtkThreshold::ThreadedRequestData(vtkDataSet *input,
+                                      vtkDataArray *inScalars,
+                                      bool usePointScalars,
+                                      int pointsDataType,
+                                      vtkUnstructuredGrid *output)
+{
+  vtkIdType numCells = input->GetNumberOfCells();
+
+  // Build the cells of a vtkPolyData before the concurrent accesses.
+  vtkIdList *cellPts = vtkIdList::New();
+  if (numCells > 0)
+    {
+    input->GetCellPoints(0, cellPts);
+    }
+  cellPts->Delete();
+
+  std::vector<vtkIdType> offsets(numCells + 1);
+  vtkThresholdCellsWorker classify;
+  classify.Self = this;
+  classify.Input = input;
+  classify.Scalars = inScalars;
+  classify.UsePointScalars = usePointScalars;
+  classify.Offsets = &offsets[0];
+  classify.CellIds = NULL;
+  vtkSMPTools::For(0, numCells, classify);
+
+  vtkIdType numNewCells = vtkSMPTools::ExclusiveScan(
+    offsets.begin(), offsets.begin() + numCells, offsets.begin(),
+    static_cast<vtkIdType>(0));
+  offsets[numCells] = numNewCells;
+  std::vector<vtkIdType> cellIds(numNewCells + 1);
+  classify.CellIds = &cellIds[0];
+  vtkSMPTools::For(0, numCells, classify);
+
+  vtkCellSubsetHelper::ExtractCells(input, &cellIds[0], numNewCells,
+    vtkCellSubsetHelper::FIRST_USE_ORDER, pointsDataType, output);
+
+  vtkDebugMacro(<< "Extracted " << output->GetNumberOfCells()
+                << " number of cells.");
+
+  return 1;
+}
+
 int vtkThreshold::EvaluateCell( vtkDataArray *scalars,vtkIdList* cellPts, int numCellPts )
 {
   int c(0);
@@ -450,4 +553,5 @@ void vtkThreshold::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Precision of the output points: "
      << this->OutputPointsPrecision << "\n";
   os << indent << "Use Continuous Cell Range: "<<this->UseContinuousCellRange<<endl;
+  os << indent << "Enable SMP: " << (this->EnableSMP ? "On\n" : "Off\n");
 }
@@ -48,6 +48,7 @@
 
 class vtkDataArray;
 class vtkIdList;
+class vtkUnstructuredGrid;
 
 class VTKFILTERSCORE_EXPORT vtkThreshold : public vtkUnstructuredGridAlgorithm
 {
@@ -153,6 +154,23 @@ public:
   void SetOutputPointsPrecision(int precision);
   int GetOutputPointsPrecision() const;
 
+  // Description:
+  // Turn on/off the use of vtkSMPTools to evaluate the criterion on the
+  // cells and to copy the extracted cells, their points and their data with
+  // several threads (see vtkCellSubsetHelper). The output is the same as
+  // with the serial execution, points and cells being in the same order.
+  // Off by default.
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+
+  // Description:
+  // Return whether the cell with the given point ids satisfies the
+  // threshold criterion, using the point or the cell scalars. This method
+  // is thread safe.
+  int KeepCell( vtkDataArray *scalars, vtkIdType cellId, vtkIdList* cellPts,
+                bool usePointScalars );
+
 protected:
   vtkThreshold();
   ~vtkThreshold();
@@ -162,6 +180,11 @@ protected:
 
   virtual int FillInputPortInformation(int port, vtkInformation *info);
 
+  // Threaded implementation of RequestData(), see EnableSMP.
+  int ThreadedRequestData(vtkDataSet *input, vtkDataArray *inScalars,
+                          bool usePointScalars, int pointsDataType,
+                          vtkUnstructuredGrid *output);
+
 
   int    AllScalars;
   double LowerThreshold;
@@ -171,6 +194,7 @@ protected:
   int    SelectedComponent;
   int OutputPointsPrecision;
   int UseContinuousCellRange;
+  bool EnableSMP;
 
   //BTX
   int (vtkThreshold::*ThresholdFunction)(double s);
@@ -20,6 +20,7 @@
 #include "vtkExtractCells.h"
 
 #include "vtkCellArray.h"
+#include "vtkCellSubsetHelper.h"
 #include "vtkIdTypeArray.h"
 #include "vtkIntArray.h"
 #include "vtkUnsignedCharArray.h"
@@ -37,6 +38,7 @@ vtkStandardNewMacro(vtkExtractCells);
 
 #include <set>
 #include <algorithm>
+#include <vector>
 
 class vtkExtractCellsSTLCloak
 {
@@ -49,6 +51,7 @@ vtkExtractCells::vtkExtractCells()
 {
   this->SubSetUGridCellArraySize = 0;
   this->InputIsUgrid = 0;
+  this->EnableSMP = false;
   this->CellList = new vtkExtractCellsSTLCloak;
 }
 
@@ -167,6 +170,13 @@ int vtkExtractCells::RequestData(
 
     return 1;
     }
+
+  if (this->EnableSMP)
+    {
+    this->ThreadedCopy(input, output);
+    return 1;
+    }
+
   vtkPointData *newPD = output->GetPointData();
   vtkCellData *newCD  = output->GetCellData();
 
@@ -271,6 +281,53 @@ void vtkExtractCells::Copy(vtkDataSet *input, vtkUnstructuredGrid *output)
   return;
 }
 
+//----------------------------------------------------------------------------
+void vtkExtractCells::ThreadedCopy(vtkDataSet *input,
+                                   vtkUnstructuredGrid *output)
+{
+  // The cells are extracted in ascending order, ignoring invalid ids.
+  vtkIdType numCellsInput = input->GetNumberOfCells();
+  std::vector<vtkIdType> cellIds;
+  cellIds.reserve(this->CellList->IdTypeSet.size() + 1);
+  std::set<vtkIdType>::iterator cellPtr;
+  for (cellPtr = this->CellList->IdTypeSet.begin();
+       cellPtr != this->CellList->IdTypeSet.end() && *cellPtr < numCellsInput;
+       ++cellPtr)
+    {
+    if (*cellPtr >= 0)
+      {
+      cellIds.push_back(*cellPtr);
+      }
+    }
+  vtkIdType numCells = static_cast<vtkIdType>(cellIds.size());
+  cellIds.push_back(-1);
+
+  int pointsDataType = VTK_FLOAT;
+  vtkPointSet *inputPS = vtkPointSet::SafeDownCast(input);
+  if (inputPS && inputPS->GetPoints())
+    {
+    // preserve input datatype
+    pointsDataType = inputPS->GetPoints()->GetDataType();
+    }
+
+  vtkCellSubsetHelper::ExtractCells(input, &cellIds[0], numCells,
+    vtkCellSubsetHelper::INPUT_ORDER, pointsDataType, output);
+
+  // We only create vtkOriginalCellIds for the output data set if it does not
+  // exist in the input data set.
+  if (input->GetCellData()->GetArray("vtkOriginalCellIds") == 0)
+    {
+    vtkIdTypeArray *origMap = vtkIdTypeArray::New();
+    origMap->SetNumberOfComponents(1);
+    origMap->SetName("vtkOriginalCellIds");
+    origMap->SetNumberOfValues(numCells);
+    std::copy(cellIds.begin(), cellIds.begin() + numCells,
+              origMap->GetPointer(0));
+    output->GetCellData()->AddArray(origMap);
+    origMap->Delete();
+    }
+}
+
 //----------------------------------------------------------------------------
 vtkIdType vtkExtractCells::findInSortedList(vtkIdList *idList, vtkIdType id)
 {
@@ -577,5 +634,6 @@ int vtkExtractCells::FillInputPortInformation(int, vtkInformation *info)
 void vtkExtractCells::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "Enable SMP: " << (this->EnableSMP ? "On\n" : "Off\n");
 }
 
@@ -61,6 +61,16 @@ public:
 
   void AddCellRange(vtkIdType from, vtkIdType to);
 
+  // Description:
+  // Turn on/off the use of vtkSMPTools to copy the cells, their points and
+  // their data with several threads (see vtkCellSubsetHelper). The points
+  // and cells are in the same order as with the serial execution and the
+  // faces of the polyhedra are passed; string and other non-numeric arrays
+  // are copied by a single thread. Off by default.
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+
 protected:
 
   virtual int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
@@ -72,6 +82,7 @@ protected:
 private:
 
   void Copy(vtkDataSet *input, vtkUnstructuredGrid *output);
+  void ThreadedCopy(vtkDataSet *input, vtkUnstructuredGrid *output);
   static vtkIdType findInSortedList(vtkIdList *idList, vtkIdType id);
   vtkIdList *reMapPointIds(vtkDataSet *grid);
 
@@ -84,6 +95,7 @@ private:
 
   int SubSetUGridCellArraySize;
   char InputIsUgrid;
+  bool EnableSMP;
 
   vtkExtractCells(const vtkExtractCells&); // Not implemented
   void operator=(const vtkExtractCells&); // Not implemented
@@ -0,0 +1,295 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGradientFilterSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded execution of vtkGradientFilter (EnableSMP)
+// produces the gradients, vorticity, divergence and Q-criterion of the
+// serial one on image data, rectilinear, structured and unstructured grids
+// and polydata, for point and cell data, and that the gradient of a linear
+// field is exact.
+
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkDataSetTriangleFilter.h>
+#include <vtkDoubleArray.h>
+#include <vtkGradientFilter.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkRectilinearGrid.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkStructuredGrid.h>
+#include <vtkTestDataSetComparison.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cmath>
+
+namespace
+{
+// The gradient of the linear field, by row.
+const double Gradient[9] = { 0.3, -1.2, 0.7,
+                             1.5, 0.4, -0.2,
+                             -0.6, 0.9, 1.1 };
+
+void LinearField(const double x[3], double v[3])
+{
+  for (int i = 0; i < 3; ++i)
+    {
+    v[i] = Gradient[3 * i] * x[0] + Gradient[3 * i + 1] * x[1] +
+           Gradient[3 * i + 2] * x[2];
+    }
+}
+
+// Add a linear vector field and a nonlinear one to the points and the cells
+// (at their centers) of a dataset.
+void AddArrays(vtkDataSet *dataSet)
+{
+  for (int association = 0; association < 2; ++association)
+    {
+    vtkSmartPointer<vtkDoubleArray> linear =
+      vtkSmartPointer<vtkDoubleArray>::New();
+    linear->SetName("Linear");
+    linear->SetNumberOfComponents(3);
+    vtkSmartPointer<vtkDoubleArray> waves =
+      vtkSmartPointer<vtkDoubleArray>::New();
+    waves->SetName("Waves");
+    waves->SetNumberOfComponents(3);
+    vtkIdType num = (association == 0 ? dataSet->GetNumberOfPoints() :
+                     dataSet->GetNumberOfCells());
+    double x[3], v[3];
+    for (vtkIdType i = 0; i < num; ++i)
+      {
+      if (association == 0)
+        {
+        dataSet->GetPoint(i, x);
+        }
+      else
+        {
+        // Only the threaded and serial outputs are compared for cell data,
+        // so any value will do.
+        x[0] = 0.1 * i;
+        x[1] = 0.03 * (i % 11);
+        x[2] = 0.2 * (i % 7);
+        }
+      LinearField(x, v);
+      linear->InsertNextTuple(v);
+      waves->InsertNextTuple3(sin(x[0]) * cos(x[1]), x[0] * x[2],
+                              cos(x[2] + x[1]));
+      }
+    vtkDataSetAttributes *data = (association == 0 ?
+      static_cast<vtkDataSetAttributes*>(dataSet->GetPointData()) :
+      static_cast<vtkDataSetAttributes*>(dataSet->GetCellData()));
+    data->AddArray(linear);
+    data->AddArray(waves);
+    }
+}
+
+vtkSmartPointer<vtkGradientFilter> Gradients(vtkDataSet *input,
+                                             int association,
+                                             const char *name,
+                                             bool faster, bool smp)
+{
+  vtkSmartPointer<vtkGradientFilter> gradients =
+    vtkSmartPointer<vtkGradientFilter>::New();
+  gradients->SetInputData(input);
+  gradients->SetInputScalars(association, name);
+  gradients->ComputeVorticityOn();
+  gradients->ComputeDivergenceOn();
+  gradients->ComputeQCriterionOn();
+  gradients->SetFasterApproximation(faster);
+  gradients->SetEnableSMP(smp);
+  gradients->Update();
+  return gradients;
+}
+
+// Compare the serial and threaded outputs, and check the gradients of the
+// linear point field when they are computed exactly.
+bool CheckGradients(vtkDataSet *input, const char *name, bool linearExact)
+{
+  AddArrays(input);
+  const char *outputs[4] = { "Gradients", "Vorticity", "Divergence",
+                             "Q-criterion" };
+  const char *fields[2] = { "Linear", "Waves" };
+  for (int option = 0; option < 8; ++option)
+    {
+    int association = (option & 1) ?
+      vtkDataObject::FIELD_ASSOCIATION_CELLS :
+      vtkDataObject::FIELD_ASSOCIATION_POINTS;
+    bool faster = (option & 2) != 0;
+    const char *field = fields[(option & 4) ? 1 : 0];
+    vtkSmartPointer<vtkGradientFilter> serialFilter =
+      Gradients(input, association, field, faster, false);
+    vtkSmartPointer<vtkGradientFilter> threadedFilter =
+      Gradients(input, association, field, faster, true);
+    vtkDataSet *serial = serialFilter->GetOutput();
+    vtkDataSet *threaded = threadedFilter->GetOutput();
+    vtkDataSetAttributes *serialData = (option & 1) ?
+      static_cast<vtkDataSetAttributes*>(serial->GetCellData()) :
+      static_cast<vtkDataSetAttributes*>(serial->GetPointData());
+    vtkDataSetAttributes *threadedData = (option & 1) ?
+      static_cast<vtkDataSetAttributes*>(threaded->GetCellData()) :
+      static_cast<vtkDataSetAttributes*>(threaded->GetPointData());
+    for (int i = 0; i < 4; ++i)
+      {
+      if (!threadedData->GetArray(outputs[i]) ||
+          !vtkTest::SameArrays(serialData->GetArray(outputs[i]),
+                               threadedData->GetArray(outputs[i]), 1.0e-8))
+        {
+        cerr << "Different " << outputs[i] << " for the " << name
+             << " with options " << option << endl;
+        return false;
+        }
+      }
+
+    if (option == 0 && linearExact)
+      {
+      vtkDataArray *gradients = threadedData->GetArray("Gradients");
+      vtkDataArray *divergence = threadedData->GetArray("Divergence");
+      for (vtkIdType i = 0; i < gradients->GetNumberOfTuples(); ++i)
+        {
+        for (int c = 0; c < 9; ++c)
+          {
+          if (fabs(gradients->GetComponent(i, c) - Gradient[c]) > 1.0e-6)
+            {
+            cerr << "Wrong gradient at point " << i << " of the " << name
+                 << endl;
+            return false;
+            }
+          }
+        if (fabs(divergence->GetTuple1(i) -
+                 (Gradient[0] + Gradient[4] + Gradient[8])) > 1.0e-6)
+          {
+          cerr << "Wrong divergence at point " << i << " of the " << name
+               << endl;
+          return false;
+          }
+        }
+      }
+    }
+  return true;
+}
+}
+
+int TestGradientFilterSMP(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(-3, 14, 2, 15, 0, 11);
+  image->SetOrigin(0.5, -1.0, 2.0);
+  image->SetSpacing(0.3, 0.25, 0.4);
+  vtkSmartPointer<vtkImageData> slice = vtkSmartPointer<vtkImageData>::New();
+  slice->SetExtent(0, 20, 4, 4, -5, 12);
+  slice->SetSpacing(0.5, 1.0, 0.2);
+
+  vtkSmartPointer<vtkRectilinearGrid> rGrid =
+    vtkSmartPointer<vtkRectilinearGrid>::New();
+  rGrid->SetDimensions(12, 9, 14);
+  vtkSmartPointer<vtkDoubleArray> coordinates[3];
+  for (int i = 0; i < 3; ++i)
+    {
+    coordinates[i] = vtkSmartPointer<vtkDoubleArray>::New();
+    for (int j = 0; j < rGrid->GetDimensions()[i]; ++j)
+      {
+      coordinates[i]->InsertNextValue(j + j * j * 0.1);
+      }
+    }
+  rGrid->SetXCoordinates(coordinates[0]);
+  rGrid->SetYCoordinates(coordinates[1]);
+  rGrid->SetZCoordinates(coordinates[2]);
+
+  // A skewed structured grid, and a flat one.
+  vtkSmartPointer<vtkStructuredGrid> sGrid =
+    vtkSmartPointer<vtkStructuredGrid>::New();
+  sGrid->SetDimensions(10, 13, 11);
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+  for (int k = 0; k < 11; ++k)
+    {
+    for (int j = 0; j < 13; ++j)
+      {
+      for (int i = 0; i < 10; ++i)
+        {
+        points->InsertNextPoint(0.4 * i + 0.1 * j, -0.2 * i + 0.3 * j + 0.05 * k,
+                                0.1 * i + 0.35 * k);
+        }
+      }
+    }
+  sGrid->SetPoints(points);
+  vtkSmartPointer<vtkStructuredGrid> flatGrid =
+    vtkSmartPointer<vtkStructuredGrid>::New();
+  flatGrid->SetDimensions(15, 1, 12);
+  vtkSmartPointer<vtkPoints> flatPoints = vtkSmartPointer<vtkPoints>::New();
+  flatPoints->SetDataTypeToDouble();
+  for (int k = 0; k < 12; ++k)
+    {
+    for (int i = 0; i < 15; ++i)
+      {
+      flatPoints->InsertNextPoint(0.3 * i + 0.1 * k, 0.0, 0.4 * k);
+      }
+    }
+  flatGrid->SetPoints(flatPoints);
+
+  // Tetrahedra, and the triangles of a surface.
+  vtkSmartPointer<vtkImageData> tetImage =
+    vtkSmartPointer<vtkImageData>::New();
+  tetImage->SetDimensions(9, 8, 10);
+  tetImage->SetSpacing(0.5, 0.4, 0.3);
+  vtkSmartPointer<vtkDataSetTriangleFilter> tetrahedralize =
+    vtkSmartPointer<vtkDataSetTriangleFilter>::New();
+  tetrahedralize->SetInputData(tetImage);
+  tetrahedralize->Update();
+  vtkSmartPointer<vtkUnstructuredGrid> uGrid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  uGrid->ShallowCopy(tetrahedralize->GetOutput());
+
+  const int size = 25;
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  vtkSmartPointer<vtkPoints> polyPoints = vtkSmartPointer<vtkPoints>::New();
+  for (int j = 0; j < size; ++j)
+    {
+    for (int i = 0; i < size; ++i)
+      {
+      polyPoints->InsertNextPoint(0.2 * i, 0.2 * j, sin(0.01 * i * j));
+      }
+    }
+  polyData->SetPoints(polyPoints);
+  polyData->Allocate();
+  for (int j = 0; j < size - 1; ++j)
+    {
+    for (int i = 0; i < size - 1; ++i)
+      {
+      vtkIdType p = j * size + i;
+      vtkIdType tri1[3] = { p, p + 1, p + size + 1 };
+      vtkIdType tri2[3] = { p, p + size + 1, p + size };
+      polyData->InsertNextCell(VTK_TRIANGLE, 3, tri1);
+      polyData->InsertNextCell(VTK_TRIANGLE, 3, tri2);
+      }
+    }
+
+  // The gradients of a linear field are exact on the 3D grids.
+  if (!CheckGradients(image, "image", true) ||
+      !CheckGradients(slice, "slice", false) ||
+      !CheckGradients(rGrid, "rectilinear grid", true) ||
+      !CheckGradients(sGrid, "structured grid", true) ||
+      !CheckGradients(flatGrid, "flat structured grid", false) ||
+      !CheckGradients(uGrid, "unstructured grid", true) ||
+      !CheckGradients(polyData, "polydata", false))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -118,5 +118,33 @@ int TestRectilinearGridToPointSet(int, char*[])
       }
     }
 
+  // Points computed on the fly
+  rect2points->ImplicitPointsOn();
+  rect2points->Update();
+  outData = rect2points->GetOutput();
+  if (numPoints != outData->GetNumberOfPoints())
+    {
+    std::cout << "Got wrong number of implicit points." << std::endl;
+    return EXIT_FAILURE;
+    }
+  for (vtkIdType pointId = 0; pointId < numPoints; pointId++)
+    {
+    double inPoint[3];
+    double outPoint[3];
+
+    inData->GetPoint(pointId, inPoint);
+    outData->GetPoint(pointId, outPoint);
+
+    if (   (inPoint[0] != outPoint[0])
+        || (inPoint[1] != outPoint[1])
+        || (inPoint[2] != outPoint[2]) )
+      {
+      std::cout << "Got mismatched implicit point coordinates." << std::endl;
+      std::cout << "Input: " << inPoint[0] << " " << inPoint[1] << " " << inPoint[2] << std::endl;
+      std::cout << "Output: " << outPoint[0] << " " << outPoint[1] << " " << outPoint[2] << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
   return EXIT_SUCCESS;
 }
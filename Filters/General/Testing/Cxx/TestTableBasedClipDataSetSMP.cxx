@@ -0,0 +1,197 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTableBasedClipDataSetSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded execution of vtkTableBasedClipDataSet (EnableSMP)
+// produces the same cells as the serial one. The output cells and points
+// are ordered differently, so each cell is described by its type, its cell
+// data and the sorted coordinates and data of its points, and the sorted
+// descriptions of the cells are compared, for cells in vtkIdType and in
+// 32-bit storage. String arrays must be passed.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkIdList.h>
+#include <vtkIntArray.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphere.h>
+#include <vtkStringArray.h>
+#include <vtkTableBasedClipDataSet.h>
+#include <vtkTestCellLattice.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+// The shared lattice of all the kinds of cells (the poly-vertices are not
+// handled by the clip tables), with the original node numbers.
+vtkSmartPointer<vtkUnstructuredGrid> CreateGrid()
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkTest::CreateCellLattice(8, vtkTest::LatticeAllCells);
+  vtkSmartPointer<vtkIntArray> nodes = vtkSmartPointer<vtkIntArray>::New();
+  nodes->SetName("avtOriginalNodeNumbers");
+  for (vtkIdType i = 0; i < grid->GetNumberOfPoints(); ++i)
+    {
+    nodes->InsertNextValue(static_cast<int>(i));
+    }
+  grid->GetPointData()->AddArray(nodes);
+  return grid;
+}
+
+// Describe the values of a tuple, rounded to hide the round-off errors.
+void DescribeTuple(vtkDataArray *array, vtkIdType id, std::ostream &os)
+{
+  for (int c = 0; c < array->GetNumberOfComponents(); ++c)
+    {
+    double v = floor(array->GetComponent(id, c) * 1.0e5 + 0.5);
+    os << (v == 0.0 ? 0.0 : v) << ' ';
+    }
+}
+
+// The sorted descriptions of the cells of a clip output.
+std::vector<std::string> DescribeCells(vtkUnstructuredGrid *output)
+{
+  vtkPointData *pd = output->GetPointData();
+  const char *pointArrays[3] =
+    { "Scalars", "Vectors", "avtOriginalNodeNumbers" };
+  std::vector<std::string> cells;
+  vtkSmartPointer<vtkIdList> pts = vtkSmartPointer<vtkIdList>::New();
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+    {
+    output->GetCellPoints(cellId, pts);
+    std::vector<std::string> points;
+    for (vtkIdType i = 0; i < pts->GetNumberOfIds(); ++i)
+      {
+      std::ostringstream point;
+      DescribeTuple(output->GetPoints()->GetData(), pts->GetId(i), point);
+      for (int a = 0; a < 3; ++a)
+        {
+        DescribeTuple(pd->GetArray(pointArrays[a]), pts->GetId(i), point);
+        }
+      points.push_back(point.str());
+      }
+    std::sort(points.begin(), points.end());
+
+    std::ostringstream cell;
+    cell << output->GetCellType(cellId) << ' '
+         << output->GetCellData()->GetArray("CellIds")->GetTuple1(cellId);
+    for (size_t i = 0; i < points.size(); ++i)
+      {
+      cell << " | " << points[i];
+      }
+    cells.push_back(cell.str());
+    }
+  std::sort(cells.begin(), cells.end());
+  return cells;
+}
+
+bool SameOutputs(vtkUnstructuredGrid *a, vtkUnstructuredGrid *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells())
+    {
+    cerr << a->GetNumberOfPoints() << " and " << b->GetNumberOfPoints()
+         << " points, " << a->GetNumberOfCells() << " and "
+         << b->GetNumberOfCells() << " cells" << endl;
+    return false;
+    }
+  return DescribeCells(a) == DescribeCells(b);
+}
+}
+
+int TestTableBasedClipDataSetSMP(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+
+  vtkSmartPointer<vtkUnstructuredGrid> grid = CreateGrid();
+  vtkSmartPointer<vtkUnstructuredGrid> grid32 =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid32->DeepCopy(grid);
+  grid32->GetCells()->SetStorageLayoutToOffsets();
+  grid32->Squeeze();
+  if (sizeof(vtkIdType) > 4 && !grid32->GetCells()->IsStorage32Bit())
+    {
+    cerr << "Cells not converted to 32-bit storage" << endl;
+    return EXIT_FAILURE;
+    }
+  vtkSmartPointer<vtkSphere> sphere = vtkSmartPointer<vtkSphere>::New();
+  sphere->SetCenter(3.3, 3.1, 2.9);
+  sphere->SetRadius(2.7);
+
+  vtkSmartPointer<vtkTableBasedClipDataSet> serial =
+    vtkSmartPointer<vtkTableBasedClipDataSet>::New();
+  vtkSmartPointer<vtkTableBasedClipDataSet> threaded =
+    vtkSmartPointer<vtkTableBasedClipDataSet>::New();
+  threaded->EnableSMPOn();
+
+  for (int option = 0; option < 16; ++option)
+    {
+    vtkTableBasedClipDataSet *filters[2] = { serial, threaded };
+    for (int f = 0; f < 2; ++f)
+      {
+      filters[f]->SetInputData((option & 8) ? grid32 : grid);
+      filters[f]->SetClipFunction((option & 1) ? sphere.GetPointer() : NULL);
+      filters[f]->SetValue((option & 1) ? 0.5 : 1.2);
+      filters[f]->SetInsideOut((option & 2) != 0);
+      filters[f]->SetGenerateClippedOutput((option & 4) != 0);
+      filters[f]->Update();
+      }
+    if (!SameOutputs(serial->GetOutput(), threaded->GetOutput()))
+      {
+      cerr << "Different outputs with options " << option << endl;
+      return EXIT_FAILURE;
+      }
+    if ((option & 4) &&
+        !SameOutputs(serial->GetClippedOutput(), threaded->GetClippedOutput()))
+      {
+      cerr << "Different clipped outputs with options " << option << endl;
+      return EXIT_FAILURE;
+      }
+    vtkIdType numCells = threaded->GetOutput()->GetNumberOfCells();
+    if (numCells == 0 || numCells >= 2 * grid->GetNumberOfCells())
+      {
+      cerr << "Unexpected number of cells (" << numCells
+           << ") with options " << option << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  vtkSmartPointer<vtkStringArray> labels =
+    vtkSmartPointer<vtkStringArray>::New();
+  labels->SetName("Labels");
+  for (vtkIdType i = 0; i < grid->GetNumberOfCells(); ++i)
+    {
+    labels->InsertNextValue(i % 2 ? "odd" : "even");
+    }
+  grid->GetCellData()->AddArray(labels);
+  threaded->SetInputData(grid);
+  threaded->Update();
+  vtkStringArray *outLabels = vtkStringArray::SafeDownCast(
+    threaded->GetOutput()->GetCellData()->GetAbstractArray("Labels"));
+  if (!outLabels || outLabels->GetNumberOfValues() !=
+        threaded->GetOutput()->GetNumberOfCells())
+    {
+    cerr << "String array not passed" << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -25,6 +25,7 @@
 #include "vtkCellDataToPointData.h"
 #include "vtkDataArray.h"
 #include "vtkDataSet.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
@@ -34,12 +35,17 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkPoints.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
 #include <vector>
 
 //-----------------------------------------------------------------------------
@@ -85,24 +91,47 @@ namespace
   void ComputePointGradientsUG(
     vtkDataSet *structure, data_type *array, data_type *gradients,
     int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
-    data_type* divergence);
+    data_type* divergence, bool enableSMP);
 
   int GetCellParametricData(
     vtkIdType pointId, double pointCoord[3], vtkCell *cell, int & subId,
     double parametricCoord[3]);
 
+  int GetCellParametricData(
+    vtkIdType pointId, double pointCoord[3], vtkCell *cell, int & subId,
+    double parametricCoord[3], std::vector<double> &weights);
+
   template<class data_type>
   void ComputeCellGradientsUG(
     vtkDataSet *structure, data_type *array, data_type *gradients,
     int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
-    data_type* divergence);
+    data_type* divergence, bool enableSMP);
 
   // Functions for image data and structured grids
   template<class Grid, class data_type>
   void ComputeGradientsSG(Grid output, data_type* array, data_type* gradients,
                           int numberOfInputComponents, int fieldAssociation,
                           data_type* vorticity, data_type* qCriterion,
-                          data_type* divergence);
+                          data_type* divergence, bool enableSMP);
+
+  // The same computations with vtkSMPTools, used when EnableSMP is on.
+  template<class data_type>
+  void ThreadedPointGradientsUG(
+    vtkDataSet *structure, data_type *array, data_type *gradients,
+    int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
+    data_type* divergence);
+
+  template<class data_type>
+  void ThreadedCellGradientsUG(
+    vtkDataSet *structure, data_type *array, data_type *gradients,
+    int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
+    data_type* divergence);
+
+  template<class Grid, class data_type>
+  void ThreadedGradientsSG(Grid output, data_type* array, data_type* gradients,
+                           int numberOfInputComponents, int fieldAssociation,
+                           data_type* vorticity, data_type* qCriterion,
+                           data_type* divergence);
 
   bool vtkGradientFilterHasArray(vtkFieldData *fieldData,
                                  vtkDataArray *array)
@@ -150,6 +179,7 @@ vtkGradientFilter::vtkGradientFilter()
   this->ComputeDivergence = 0;
   this->ComputeVorticity = 0;
   this->ComputeQCriterion = 0;
+  this->EnableSMP = false;
   this->SetInputScalars(vtkDataObject::FIELD_ASSOCIATION_POINTS_THEN_CELLS,
                         vtkDataSetAttributes::SCALARS);
 }
@@ -181,6 +211,7 @@ void vtkGradientFilter::PrintSelf(ostream &os, vtkIndent indent)
   os << indent << "ComputeDivergence:"  << this->ComputeDivergence << endl;
   os << indent << "ComputeVorticity:" << this->ComputeVorticity << endl;
   os << indent << "ComputeQCriterion:" << this->ComputeQCriterion << endl;
+  os << indent << "EnableSMP:" << this->EnableSMP << endl;
 }
 
 //-----------------------------------------------------------------------------
@@ -412,7 +443,8 @@ int vtkGradientFilter::ComputeUnstructuredGridGradient(
                            (qCriterion == NULL ? NULL :
                             static_cast<VTK_TT *>(qCriterion->GetVoidPointer(0))),
                            (divergence == NULL ? NULL :
-                            static_cast<VTK_TT *>(divergence->GetVoidPointer(0)))));
+                            static_cast<VTK_TT *>(divergence->GetVoidPointer(0))),
+                           this->EnableSMP));
         }
       if(gradients)
         {
@@ -480,7 +512,8 @@ int vtkGradientFilter::ComputeUnstructuredGridGradient(
             (qCriterion == NULL ? NULL :
              static_cast<VTK_TT *>(cellQCriterion->GetVoidPointer(0))),
             (divergence == NULL ? NULL :
-             static_cast<VTK_TT *>(cellDivergence->GetVoidPointer(0)))));
+             static_cast<VTK_TT *>(cellDivergence->GetVoidPointer(0))),
+            this->EnableSMP));
         }
 
       // We need to convert cell Array to points Array.
@@ -507,6 +540,7 @@ int vtkGradientFilter::ComputeUnstructuredGridGradient(
       vtkNew<vtkCellDataToPointData> cd2pd;
       cd2pd->SetInputData(dummy);
       cd2pd->PassCellDataOff();
+      cd2pd->SetEnableSMP(this->EnableSMP);
       cd2pd->Update();
 
       // Set the gradients array in the output and cleanup.
@@ -543,6 +577,7 @@ int vtkGradientFilter::ComputeUnstructuredGridGradient(
     vtkNew<vtkCellDataToPointData> cd2pd;
     cd2pd->SetInputData(dummy);
     cd2pd->PassCellDataOff();
+    cd2pd->SetEnableSMP(this->EnableSMP);
     cd2pd->Update();
     vtkDataArray *pointScalars
       = cd2pd->GetOutput()->GetPointData()->GetScalars();
@@ -561,7 +596,8 @@ int vtkGradientFilter::ComputeUnstructuredGridGradient(
                          (qCriterion == NULL ? NULL :
                           static_cast<VTK_TT *>(qCriterion->GetVoidPointer(0))),
                          (divergence == NULL ? NULL :
-                          static_cast<VTK_TT *>(divergence->GetVoidPointer(0)))));
+                          static_cast<VTK_TT *>(divergence->GetVoidPointer(0))),
+                         this->EnableSMP));
       }
 
     if(gradients)
@@ -666,7 +702,8 @@ int vtkGradientFilter::ComputeRegularGridGradient(
                          (qCriterion == NULL ? NULL :
                           static_cast<VTK_TT *>(qCriterion->GetVoidPointer(0))),
                          (divergence == NULL ? NULL :
-                          static_cast<VTK_TT *>(divergence->GetVoidPointer(0)))));
+                          static_cast<VTK_TT *>(divergence->GetVoidPointer(0))),
+                         this->EnableSMP));
 
       }
     }
@@ -685,7 +722,8 @@ int vtkGradientFilter::ComputeRegularGridGradient(
                          (qCriterion == NULL ? NULL :
                           static_cast<VTK_TT *>(qCriterion->GetVoidPointer(0))),
                          (divergence == NULL ? NULL :
-                          static_cast<VTK_TT *>(divergence->GetVoidPointer(0)))));
+                          static_cast<VTK_TT *>(divergence->GetVoidPointer(0))),
+                         this->EnableSMP));
       }
     }
   else if(vtkRectilinearGrid* rectilinearGrid = vtkRectilinearGrid::SafeDownCast(output))
@@ -703,7 +741,8 @@ int vtkGradientFilter::ComputeRegularGridGradient(
                          (qCriterion == NULL ? NULL :
                           static_cast<VTK_TT *>(qCriterion->GetVoidPointer(0))),
                          (divergence == NULL ? NULL :
-                          static_cast<VTK_TT *>(divergence->GetVoidPointer(0)))));
+                          static_cast<VTK_TT *>(divergence->GetVoidPointer(0))),
+                         this->EnableSMP));
 
       }
     }
@@ -759,8 +798,16 @@ namespace {
   void ComputePointGradientsUG(
     vtkDataSet *structure, data_type *array, data_type *gradients,
     int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
-    data_type* divergence)
+    data_type* divergence, bool enableSMP)
   {
+    if (enableSMP)
+      {
+      ThreadedPointGradientsUG(structure, array, gradients,
+                               numberOfInputComponents, vorticity, qCriterion,
+                               divergence);
+      return;
+      }
+
     vtkNew<vtkIdList> currentPoint;
     currentPoint->SetNumberOfIds(1);
     vtkNew<vtkIdList> cellsOnPoint;
@@ -852,6 +899,17 @@ namespace {
 //-----------------------------------------------------------------------------
   int GetCellParametricData(vtkIdType pointId, double pointCoord[3],
                             vtkCell *cell, int &subId, double parametricCoord[3])
+  {
+    std::vector<double> weights;
+    return GetCellParametricData(pointId, pointCoord, cell, subId,
+                                 parametricCoord, weights);
+  }
+
+//-----------------------------------------------------------------------------
+  // Same as above, with a weights buffer reused between the calls.
+  int GetCellParametricData(vtkIdType pointId, double pointCoord[3],
+                            vtkCell *cell, int &subId, double parametricCoord[3],
+                            std::vector<double> &weights)
   {
     // Watch out for degenerate cells.  They make the derivative calculation
     // fail.
@@ -872,10 +930,13 @@ namespace {
 
     double dummy;
     int numpoints = cell->GetNumberOfPoints();
-    std::vector<double> values(numpoints);
+    if (static_cast<size_t>(numpoints) > weights.size())
+      {
+      weights.resize(numpoints);
+      }
     // Get parametric position of point.
     cell->EvaluatePosition(pointCoord, NULL, subId, parametricCoord,
-                           dummy, &values[0]/*Really another dummy.*/);
+                           dummy, &weights[0]/*Really another dummy.*/);
 
     return 1;
   }
@@ -885,8 +946,16 @@ namespace {
     void ComputeCellGradientsUG(
       vtkDataSet *structure, data_type *array, data_type *gradients,
       int numberOfInputComponents, data_type* vorticity,
-      data_type* qCriterion, data_type* divergence)
+      data_type* qCriterion, data_type* divergence, bool enableSMP)
   {
+    if (enableSMP)
+      {
+      ThreadedCellGradientsUG(structure, array, gradients,
+                              numberOfInputComponents, vorticity, qCriterion,
+                              divergence);
+      return;
+      }
+
     vtkIdType numcells = structure->GetNumberOfCells();
     std::vector<double> values(8);
     std::vector<data_type> cellGradients(3*numberOfInputComponents);
@@ -948,8 +1017,15 @@ namespace {
   void ComputeGradientsSG(Grid output, data_type* array, data_type* gradients,
                           int numberOfInputComponents, int fieldAssociation,
                           data_type* vorticity, data_type* qCriterion,
-                          data_type* divergence)
+                          data_type* divergence, bool enableSMP)
   {
+    if (enableSMP)
+      {
+      ThreadedGradientsSG(output, array, gradients, numberOfInputComponents,
+                          fieldAssociation, vorticity, qCriterion, divergence);
+      return;
+      }
+
     int idx, idx2, inputComponent;
     double xp[3], xm[3], factor;
     xp[0] = xp[1] = xp[2] = xm[0] = xm[1] = xm[2] = factor = 0;
@@ -971,10 +1047,13 @@ namespace {
     output->GetDimensions(dims);
     if(fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS)
       {
-      // reduce the dimensions by 1 for cells
+      // reduce the dimensions by 1 for cells, except the flat ones
       for(int i=0;i<3;i++)
         {
-        dims[i]--;
+        if (dims[i] > 1)
+          {
+          dims[i]--;
+          }
         }
       }
     int ijsize = dims[0]*dims[1];
@@ -1254,4 +1333,575 @@ namespace {
       }
   }
 
+//-----------------------------------------------------------------------------
+  // Threaded versions of the functions above, used when EnableSMP is on.
+  // They compute each point or cell independently with thread local scratch
+  // objects.
+
+//-----------------------------------------------------------------------------
+  // Compute the gradient of a point array at a range of points, averaging
+  // the derivatives of the cells using each point. Thread safe once the
+  // links and the cells of the structure were built from a single thread.
+  template<class data_type>
+  struct PointGradientsUG
+  {
+    vtkDataSet *Structure;
+    data_type *Array;
+    data_type *Gradients;
+    int NumberOfInputComponents;
+    data_type *Vorticity;
+    data_type *QCriterion;
+    data_type *Divergence;
+    vtkSMPThreadLocalObject<vtkIdList> CurrentPoint;
+    vtkSMPThreadLocalObject<vtkIdList> CellsOnPoint;
+    vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      vtkIdList *currentPoint = this->CurrentPoint.Local();
+      currentPoint->SetNumberOfIds(1);
+      vtkIdList *cellsOnPoint = this->CellsOnPoint.Local();
+      vtkGenericCell *cell = this->Cell.Local();
+
+      int numberOfInputComponents = this->NumberOfInputComponents;
+      int numberOfOutputComponents = 3*numberOfInputComponents;
+      std::vector<data_type> g(numberOfOutputComponents);
+      std::vector<double> values(8);
+      std::vector<double> weights(8);
+
+      for (vtkIdType point = begin; point < end; point++)
+        {
+        currentPoint->SetId(0, point);
+        double pointcoords[3];
+        this->Structure->GetPoint(point, pointcoords);
+        // Get all cells touching this point.
+        this->Structure->GetCellNeighbors(-1, currentPoint, cellsOnPoint);
+        vtkIdType numCellNeighbors = cellsOnPoint->GetNumberOfIds();
+
+        for(int i=0;i<numberOfOutputComponents;i++)
+          {
+          g[i] = 0;
+          }
+
+        // Iterate on all cells and find all points connected to current point
+        // by an edge.
+        for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
+          {
+          this->Structure->GetCell(cellsOnPoint->GetId(neighbor), cell);
+          int subId;
+          double parametricCoord[3];
+          if(GetCellParametricData(point, pointcoords, cell,
+                                   subId, parametricCoord, weights))
+            {
+            int NumberOfCellPoints = cell->GetNumberOfPoints();
+            if(static_cast<size_t>(NumberOfCellPoints) > values.size())
+              {
+              values.resize(NumberOfCellPoints);
+              }
+            for(int InputComponent=0;InputComponent<numberOfInputComponents;InputComponent++)
+              {
+              // Get values of Array at cell points.
+              for (int i = 0; i < NumberOfCellPoints; i++)
+                {
+                values[i] = static_cast<double>(
+                  this->Array[cell->GetPointId(i)*numberOfInputComponents+InputComponent]);
+                }
+
+              double derivative[3];
+              // Get derivative of cell at point.
+              cell->Derivatives(subId, parametricCoord, &values[0], 1, derivative);
+
+              g[InputComponent*3] += static_cast<data_type>(derivative[0]);
+              g[InputComponent*3+1] += static_cast<data_type>(derivative[1]);
+              g[InputComponent*3+2] += static_cast<data_type>(derivative[2]);
+              } // iterating over Components
+            } // if(GetCellParametricData())
+          } // iterating over neighbors
+
+        if (numCellNeighbors > 0)
+          {
+          for(int i=0;i<numberOfOutputComponents;i++)
+            {
+            g[i] /= numCellNeighbors;
+            }
+          }
+
+        if(this->Vorticity)
+          {
+          ComputeVorticityFromGradient(&g[0], this->Vorticity+3*point);
+          }
+        if(this->QCriterion)
+          {
+          ComputeQCriterionFromGradient(&g[0], this->QCriterion+point);
+          }
+        if(this->Divergence)
+          {
+          ComputeDivergenceFromGradient(&g[0], this->Divergence+point);
+          }
+        if(this->Gradients)
+          {
+          for(int i=0;i<numberOfOutputComponents;i++)
+            {
+            this->Gradients[point*numberOfOutputComponents+i] = g[i];
+            }
+          }
+        }  // iterating over points in grid
+    }
+  };
+
+//-----------------------------------------------------------------------------
+  template<class data_type>
+  void ThreadedPointGradientsUG(
+    vtkDataSet *structure, data_type *array, data_type *gradients,
+    int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
+    data_type* divergence)
+  {
+    vtkIdType numpts = structure->GetNumberOfPoints();
+    if (numpts < 1)
+      {
+      return;
+      }
+
+    PointGradientsUG<data_type> worker;
+    worker.Structure = structure;
+    worker.Array = array;
+    worker.Gradients = gradients;
+    worker.NumberOfInputComponents = numberOfInputComponents;
+    worker.Vorticity = vorticity;
+    worker.QCriterion = qCriterion;
+    worker.Divergence = divergence;
+
+    // Build the links and the cells from this thread.
+    vtkNew<vtkIdList> currentPoint;
+    currentPoint->InsertNextId(0);
+    vtkNew<vtkIdList> cellsOnPoint;
+    structure->GetCellNeighbors(-1, currentPoint.GetPointer(),
+                                cellsOnPoint.GetPointer());
+    if (structure->GetNumberOfCells() > 0)
+      {
+      structure->GetCell(0, worker.Cell.Local());
+      }
+    vtkSMPTools::For(0, numpts, worker);
+  }
+
+//-----------------------------------------------------------------------------
+  // Compute the gradient of a point array at the center of a range of cells.
+  template<class data_type>
+  struct CellGradientsUG
+  {
+    vtkDataSet *Structure;
+    data_type *Array;
+    data_type *Gradients;
+    int NumberOfInputComponents;
+    data_type *Vorticity;
+    data_type *QCriterion;
+    data_type *Divergence;
+    vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      vtkGenericCell *cell = this->Cell.Local();
+      int numberOfInputComponents = this->NumberOfInputComponents;
+      std::vector<double> values(8);
+      std::vector<data_type> cellGradients(3*numberOfInputComponents);
+      for (vtkIdType cellid = begin; cellid < end; cellid++)
+        {
+        this->Structure->GetCell(cellid, cell);
+
+        int subId;
+        double cellCenter[3];
+        subId = cell->GetParametricCenter(cellCenter);
+
+        int numpoints = cell->GetNumberOfPoints();
+        if(static_cast<size_t>(numpoints) > values.size())
+          {
+          values.resize(numpoints);
+          }
+        double derivative[3];
+        for(int inputComponent=0;inputComponent<numberOfInputComponents;
+            inputComponent++)
+          {
+          for (int i = 0; i < numpoints; i++)
+            {
+            values[i] = static_cast<double>(
+              this->Array[cell->GetPointId(i)*numberOfInputComponents+inputComponent]);
+            }
+
+          cell->Derivatives(subId, cellCenter, &values[0], 1, derivative);
+          cellGradients[inputComponent*3] =
+            static_cast<data_type>(derivative[0]);
+          cellGradients[inputComponent*3+1] =
+            static_cast<data_type>(derivative[1]);
+          cellGradients[inputComponent*3+2] =
+            static_cast<data_type>(derivative[2]);
+          }
+        if(this->Gradients)
+          {
+          for(int i=0;i<3*numberOfInputComponents;i++)
+            {
+            this->Gradients[cellid*3*numberOfInputComponents+i] =
+              cellGradients[i];
+            }
+          }
+        if(this->Vorticity)
+          {
+          ComputeVorticityFromGradient(&cellGradients[0],
+                                       this->Vorticity+3*cellid);
+          }
+        if(this->QCriterion)
+          {
+          ComputeQCriterionFromGradient(&cellGradients[0],
+                                        this->QCriterion+cellid);
+          }
+        if(this->Divergence)
+          {
+          ComputeDivergenceFromGradient(&cellGradients[0],
+                                        this->Divergence+cellid);
+          }
+        }
+    }
+  };
+
+//-----------------------------------------------------------------------------
+  template<class data_type>
+  void ThreadedCellGradientsUG(
+    vtkDataSet *structure, data_type *array, data_type *gradients,
+    int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
+    data_type* divergence)
+  {
+    vtkIdType numcells = structure->GetNumberOfCells();
+    if (numcells < 1)
+      {
+      return;
+      }
+
+    CellGradientsUG<data_type> worker;
+    worker.Structure = structure;
+    worker.Array = array;
+    worker.Gradients = gradients;
+    worker.NumberOfInputComponents = numberOfInputComponents;
+    worker.Vorticity = vorticity;
+    worker.QCriterion = qCriterion;
+    worker.Divergence = divergence;
+
+    // Build the cells from this thread.
+    structure->GetCell(0, worker.Cell.Local());
+    vtkSMPTools::For(0, numcells, worker);
+  }
+
+//-----------------------------------------------------------------------------
+  // The coordinates of the points, or of the cell centers, of a grid given
+  // their structured indices. Image data and rectilinear grids compute them
+  // from their origin and spacing, or coordinates; structured grids read
+  // their points, or evaluate the parametric center of their cells.
+  template<class Grid>
+  struct GridCoordinates;
+
+  template<>
+  struct GridCoordinates<vtkImageData*>
+  {
+    double Origin[3];
+    double Spacing[3];
+
+    void Initialize(vtkImageData *grid, int fieldAssociation)
+    {
+      int *extent = grid->GetExtent();
+      double shift =
+        (fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS ? 0.5 : 0.0);
+      for (int i = 0; i < 3; i++)
+        {
+        this->Spacing[i] = grid->GetSpacing()[i];
+        // Flat dimensions have a single cell "centered" on the points.
+        this->Origin[i] = grid->GetOrigin()[i] + this->Spacing[i] *
+          (extent[2*i] + (extent[2*i] < extent[2*i+1] ? shift : 0.0));
+        }
+    }
+
+    void Get(const int ijk[3], vtkIdType, double x[3])
+    {
+      for (int i = 0; i < 3; i++)
+        {
+        x[i] = this->Origin[i] + this->Spacing[i] * ijk[i];
+        }
+    }
+  };
+
+  template<>
+  struct GridCoordinates<vtkRectilinearGrid*>
+  {
+    vtkDataArray *Coordinates[3];
+    bool Centers[3];
+
+    void Initialize(vtkRectilinearGrid *grid, int fieldAssociation)
+    {
+      this->Coordinates[0] = grid->GetXCoordinates();
+      this->Coordinates[1] = grid->GetYCoordinates();
+      this->Coordinates[2] = grid->GetZCoordinates();
+      for (int i = 0; i < 3; i++)
+        {
+        this->Centers[i] =
+          (fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS &&
+           this->Coordinates[i]->GetNumberOfTuples() > 1);
+        }
+    }
+
+    void Get(const int ijk[3], vtkIdType, double x[3])
+    {
+      for (int i = 0; i < 3; i++)
+        {
+        x[i] = this->Coordinates[i]->GetComponent(ijk[i], 0);
+        if (this->Centers[i])
+          {
+          x[i] = 0.5 * (x[i] + this->Coordinates[i]->GetComponent(ijk[i]+1, 0));
+          }
+        }
+    }
+  };
+
+  template<>
+  struct GridCoordinates<vtkStructuredGrid*>
+  {
+    vtkStructuredGrid *Grid;
+    bool Cells;
+    vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+    vtkSMPThreadLocal<std::vector<double> > Weights;
+
+    void Initialize(vtkStructuredGrid *grid, int fieldAssociation)
+    {
+      this->Grid = grid;
+      this->Cells = (fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS);
+    }
+
+    void Get(const int*, vtkIdType index, double x[3])
+    {
+      if (!this->Cells)
+        {
+        this->Grid->GetPoints()->GetPoint(index, x);
+        return;
+        }
+      vtkGenericCell *cell = this->Cell.Local();
+      this->Grid->GetCell(index, cell);
+      double pcoords[3];
+      int subId = cell->GetParametricCenter(pcoords);
+      std::vector<double> &weights = this->Weights.Local();
+      weights.resize(cell->GetNumberOfPoints()+1);
+      cell->EvaluateLocation(subId, pcoords, x, &weights[0]);
+    }
+  };
+
+//-----------------------------------------------------------------------------
+  // Compute the gradient of an array of a structured grid (at its points or
+  // cells) at a range of entities with finite differences, central in the
+  // interior and one-sided at the boundary, mapped to the grid coordinates
+  // with the inverse of the Jacobian.
+  template<class Grid, class data_type>
+  struct GradientsSG
+  {
+    GridCoordinates<Grid> Coordinates;
+    data_type *Array;
+    data_type *Gradients;
+    int NumberOfInputComponents;
+    data_type *Vorticity;
+    data_type *QCriterion;
+    data_type *Divergence;
+    int Dims[3];
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      int numberOfInputComponents = this->NumberOfInputComponents;
+      const int *dims = this->Dims;
+      vtkIdType ijsize = static_cast<vtkIdType>(dims[0])*dims[1];
+      vtkIdType incs[3] = { 1, dims[0], ijsize };
+      int inputComponent, ijk[3], plusIjk[3], minusIjk[3];
+      double xp[3], xm[3], factor;
+      // The derivatives of the coordinates along the axes (xi, eta, zeta).
+      double xd[3][3];
+      double aj, xix, xiy, xiz, etax, etay, etaz, zetax, zetay, zetaz;
+      // for finite differencing -- the values on the "plus" side and
+      // "minus" side of the point to be computed at
+      std::vector<double> dValues[3];
+      for (int axis = 0; axis < 3; axis++)
+        {
+        dValues[axis].resize(numberOfInputComponents);
+        }
+      std::vector<data_type> localGradients(numberOfInputComponents*3);
+
+      for (vtkIdType idx = begin; idx < end; idx++)
+        {
+        ijk[0] = static_cast<int>(idx % dims[0]);
+        ijk[1] = static_cast<int>((idx / dims[0]) % dims[1]);
+        ijk[2] = static_cast<int>(idx / ijsize);
+
+        for (int axis = 0; axis < 3; axis++)
+          {
+          if ( dims[axis] == 1 ) // 2D in this direction
+            {
+            for (int ii=0; ii<3; ii++)
+              {
+              xd[axis][ii] = (ii == axis ? 1.0 : 0.0);
+              }
+            for(inputComponent=0;inputComponent<numberOfInputComponents;
+                inputComponent++)
+              {
+              dValues[axis][inputComponent] = 0.0;
+              }
+            continue;
+            }
+
+          // One-sided differences at the boundary, central ones inside.
+          vtkIdType plusIdx = idx, minusIdx = idx;
+          factor = 1.0;
+          if ( ijk[axis] == 0 )
+            {
+            plusIdx += incs[axis];
+            }
+          else if ( ijk[axis] == (dims[axis]-1) )
+            {
+            minusIdx -= incs[axis];
+            }
+          else
+            {
+            factor = 0.5;
+            plusIdx += incs[axis];
+            minusIdx -= incs[axis];
+            }
+          for (int ii=0; ii<3; ii++)
+            {
+            plusIjk[ii] = minusIjk[ii] = ijk[ii];
+            }
+          plusIjk[axis] += static_cast<int>((plusIdx - idx) / incs[axis]);
+          minusIjk[axis] += static_cast<int>((minusIdx - idx) / incs[axis]);
+          this->Coordinates.Get(plusIjk, plusIdx, xp);
+          this->Coordinates.Get(minusIjk, minusIdx, xm);
+
+          for (int ii=0; ii<3; ii++)
+            {
+            xd[axis][ii] = factor * (xp[ii] - xm[ii]);
+            }
+          for(inputComponent=0;inputComponent<numberOfInputComponents;
+              inputComponent++)
+            {
+            dValues[axis][inputComponent] = factor *
+              (static_cast<double>(
+                this->Array[plusIdx*numberOfInputComponents+inputComponent]) -
+               static_cast<double>(
+                this->Array[minusIdx*numberOfInputComponents+inputComponent]));
+            }
+          }
+
+        double xxi = xd[0][0], yxi = xd[0][1], zxi = xd[0][2];
+        double xeta = xd[1][0], yeta = xd[1][1], zeta = xd[1][2];
+        double xzeta = xd[2][0], yzeta = xd[2][1], zzeta = xd[2][2];
+
+        // Now calculate the Jacobian.  Grids occasionally have
+        // singularities, or points where the Jacobian is infinite (the
+        // inverse is zero).  For these cases, we'll set the Jacobian to
+        // zero, which will result in a zero derivative.
+        //
+        aj =  xxi*yeta*zzeta+yxi*zeta*xzeta+zxi*xeta*yzeta
+          -zxi*yeta*xzeta-yxi*xeta*zzeta-xxi*zeta*yzeta;
+        if (aj != 0.0)
+          {
+          aj = 1. / aj;
+          }
+
+        //  Xi metrics.
+        xix  =  aj*(yeta*zzeta-zeta*yzeta);
+        xiy  = -aj*(xeta*zzeta-zeta*xzeta);
+        xiz  =  aj*(xeta*yzeta-yeta*xzeta);
+
+        //  Eta metrics.
+        etax = -aj*(yxi*zzeta-zxi*yzeta);
+        etay =  aj*(xxi*zzeta-zxi*xzeta);
+        etaz = -aj*(xxi*yzeta-yxi*xzeta);
+
+        //  Zeta metrics.
+        zetax=  aj*(yxi*zeta-zxi*yeta);
+        zetay= -aj*(xxi*zeta-zxi*xeta);
+        zetaz=  aj*(xxi*yeta-yxi*xeta);
+
+        // Finally compute the actual derivatives
+        for(inputComponent=0;inputComponent<numberOfInputComponents;inputComponent++)
+          {
+          localGradients[inputComponent*3] = static_cast<data_type>(
+            xix*dValues[0][inputComponent]+etax*dValues[1][inputComponent]+
+            zetax*dValues[2][inputComponent]);
+
+          localGradients[inputComponent*3+1] = static_cast<data_type>(
+            xiy*dValues[0][inputComponent]+etay*dValues[1][inputComponent]+
+            zetay*dValues[2][inputComponent]);
+
+          localGradients[inputComponent*3+2] = static_cast<data_type>(
+            xiz*dValues[0][inputComponent]+etaz*dValues[1][inputComponent]+
+            zetaz*dValues[2][inputComponent]);
+          }
+
+        if(this->Gradients)
+          {
+          for(int ii=0;ii<3*numberOfInputComponents;ii++)
+            {
+            this->Gradients[idx*numberOfInputComponents*3+ii] =
+              localGradients[ii];
+            }
+          }
+        if(this->Vorticity)
+          {
+          ComputeVorticityFromGradient(&localGradients[0],
+                                       this->Vorticity+3*idx);
+          }
+        if(this->QCriterion)
+          {
+          ComputeQCriterionFromGradient(&localGradients[0],
+                                        this->QCriterion+idx);
+          }
+        if(this->Divergence)
+          {
+          ComputeDivergenceFromGradient(&localGradients[0],
+                                        this->Divergence+idx);
+          }
+        }
+    }
+  };
+
+//-----------------------------------------------------------------------------
+  template<class Grid, class data_type>
+  void ThreadedGradientsSG(Grid output, data_type* array, data_type* gradients,
+                           int numberOfInputComponents, int fieldAssociation,
+                           data_type* vorticity, data_type* qCriterion,
+                           data_type* divergence)
+  {
+    GradientsSG<Grid, data_type> worker;
+    worker.Coordinates.Initialize(output, fieldAssociation);
+    worker.Array = array;
+    worker.Gradients = gradients;
+    worker.NumberOfInputComponents = numberOfInputComponents;
+    worker.Vorticity = vorticity;
+    worker.QCriterion = qCriterion;
+    worker.Divergence = divergence;
+
+    int *dims = worker.Dims;
+    output->GetDimensions(dims);
+    if(fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS)
+      {
+      // reduce the dimensions by 1 for cells, except the flat ones
+      for(int i=0;i<3;i++)
+        {
+        dims[i] = std::max(dims[i]-1, 1);
+        }
+      }
+
+    vtkIdType size = static_cast<vtkIdType>(dims[0])*dims[1]*dims[2];
+    if (size < 1 || output->GetNumberOfPoints() < 1)
+      {
+      return;
+      }
+    if (fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS)
+      {
+      // Set up the cells from this thread.
+      vtkNew<vtkGenericCell> cell;
+      output->GetCell(0, cell.GetPointer());
+      }
+    vtkSMPTools::For(0, size, worker);
+  }
+
 } // end anonymous namespace
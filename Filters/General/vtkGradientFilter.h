@@ -29,6 +29,8 @@
 // output tuple will be {du/dx, du/dy, du/dz, dv/dx, dv/dy, dv/dz, dw/dx,
 // dw/dy, dw/dz} for an input array {u, v, w}. There are also the options
 // to additionally compute the vorticity and Q criterion of a vector field.
+// When EnableSMP is on, the gradients, and the vorticity, divergence and Q
+// criterion derived from them, are computed with vtkSMPTools.
 
 #ifndef vtkGradientFilter_h
 #define vtkGradientFilter_h
@@ -128,6 +130,16 @@ public:
   vtkGetMacro(ComputeQCriterion, int);
   vtkBooleanMacro(ComputeQCriterion, int);
 
+  // Description:
+  // When this flag is on (default is off), the gradients are computed in
+  // parallel with vtkSMPTools: with finite differences over the points or
+  // cells of image data, rectilinear and structured grids, and cell by cell
+  // (or point by point) for the other datasets. The serial code is used
+  // when the flag is off; both give the same output up to round-off.
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+
 protected:
   vtkGradientFilter();
   ~vtkGradientFilter();
@@ -208,6 +220,10 @@ protected:
   // 3 components.  By default ComputeVorticity is off.
   int ComputeVorticity;
 
+  // Description:
+  // Flag to indicate that the gradients are computed with vtkSMPTools.
+  bool EnableSMP;
+
 private:
   vtkGradientFilter(const vtkGradientFilter &); // Not implemented
   void operator=(const vtkGradientFilter &);    // Not implemented
@@ -20,6 +20,8 @@
 
 #include "vtkCellData.h"
 #include "vtkImageData.h"
+#include "vtkImplicitArray.h"
+#include "vtkImplicitArrayBackends.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
@@ -33,6 +35,7 @@ vtkStandardNewMacro(vtkImageDataToPointSet);
 //-------------------------------------------------------------------------
 vtkImageDataToPointSet::vtkImageDataToPointSet()
 {
+  this->ImplicitPoints = 0;
 }
 
 vtkImageDataToPointSet::~vtkImageDataToPointSet()
@@ -42,6 +45,9 @@ vtkImageDataToPointSet::~vtkImageDataToPointSet()
 void vtkImageDataToPointSet::PrintSelf(ostream &os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "ImplicitPoints: "
+     << (this->ImplicitPoints ? "On" : "Off") << endl;
 }
 
 //-------------------------------------------------------------------------
@@ -72,6 +78,20 @@ int vtkImageDataToPointSet::CopyStructure(vtkStructuredGrid *outData,
   outData->SetExtent(extent);
 
   vtkNew<vtkPoints> points;
+  if (this->ImplicitPoints)
+    {
+    typedef vtkImplicitArray<vtkStructuredPointsImplicitBackend<double> >
+      PointsArray;
+    vtkNew<PointsArray> coords;
+    coords->SetNumberOfComponents(3);
+    coords->SetBackend(
+      vtkStructuredPointsImplicitBackend<double>(extent, origin, spacing));
+    coords->SetNumberOfTuples(inData->GetNumberOfPoints());
+    points->SetData(coords.GetPointer());
+    outData->SetPoints(points.GetPointer());
+    return 1;
+    }
+
   points->SetDataTypeToDouble();
   points->SetNumberOfPoints(inData->GetNumberOfPoints());
 
@@ -44,6 +44,15 @@ public:
 
   static vtkImageDataToPointSet *New();
 
+  // Description:
+  // When on, the points of the output are computed on the fly from the
+  // origin and spacing of the image (see vtkImplicitArray) instead of being
+  // stored, so that they use no memory. Off by default: code accessing the
+  // points through GetVoidPointer() gets a temporary copy of the points.
+  vtkSetMacro(ImplicitPoints, int);
+  vtkGetMacro(ImplicitPoints, int);
+  vtkBooleanMacro(ImplicitPoints, int);
+
 protected:
   vtkImageDataToPointSet();
   ~vtkImageDataToPointSet();
@@ -54,6 +63,8 @@ protected:
 
   virtual int FillInputPortInformation(int port, vtkInformation *info);
 
+  int ImplicitPoints;
+
 private:
   vtkImageDataToPointSet(const vtkImageDataToPointSet &); // Not implemented
   void operator=(const vtkImageDataToPointSet &);         // Not implemented
@@ -19,6 +19,8 @@
 #include "vtkRectilinearGridToPointSet.h"
 
 #include "vtkCellData.h"
+#include "vtkImplicitArray.h"
+#include "vtkImplicitArrayBackends.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
@@ -33,6 +35,7 @@ vtkStandardNewMacro(vtkRectilinearGridToPointSet);
 //-------------------------------------------------------------------------
 vtkRectilinearGridToPointSet::vtkRectilinearGridToPointSet()
 {
+  this->ImplicitPoints = 0;
 }
 
 vtkRectilinearGridToPointSet::~vtkRectilinearGridToPointSet()
@@ -42,6 +45,9 @@ vtkRectilinearGridToPointSet::~vtkRectilinearGridToPointSet()
 void vtkRectilinearGridToPointSet::PrintSelf(ostream &os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "ImplicitPoints: "
+     << (this->ImplicitPoints ? "On" : "Off") << endl;
 }
 
 //-------------------------------------------------------------------------
@@ -70,6 +76,20 @@ int vtkRectilinearGridToPointSet::CopyStructure(vtkStructuredGrid *outData,
   outData->SetExtent(extent);
 
   vtkNew<vtkPoints> points;
+  if (this->ImplicitPoints)
+    {
+    typedef vtkImplicitArray<vtkRectilinearPointsImplicitBackend<double> >
+      PointsArray;
+    vtkNew<PointsArray> coords;
+    coords->SetNumberOfComponents(3);
+    coords->SetBackend(
+      vtkRectilinearPointsImplicitBackend<double>(xcoord, ycoord, zcoord));
+    coords->SetNumberOfTuples(inData->GetNumberOfPoints());
+    points->SetData(coords.GetPointer());
+    outData->SetPoints(points.GetPointer());
+    return 1;
+    }
+
   points->SetDataTypeToDouble();
   points->SetNumberOfPoints(inData->GetNumberOfPoints());
 
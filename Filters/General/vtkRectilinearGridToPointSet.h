@@ -45,6 +45,16 @@ public:
 
   static vtkRectilinearGridToPointSet *New();
 
+  // Description:
+  // When on, the points of the output are computed on the fly from the
+  // coordinates of the grid (see vtkImplicitArray) instead of being stored,
+  // so that they use memory proportional to the sum of the dimensions rather
+  // than to the number of points. Off by default: code accessing the points
+  // through GetVoidPointer() gets a temporary copy of the points.
+  vtkSetMacro(ImplicitPoints, int);
+  vtkGetMacro(ImplicitPoints, int);
+  vtkBooleanMacro(ImplicitPoints, int);
+
 protected:
   vtkRectilinearGridToPointSet();
   ~vtkRectilinearGridToPointSet();
@@ -55,6 +65,8 @@ protected:
 
   virtual int FillInputPortInformation(int port, vtkInformation *info);
 
+  int ImplicitPoints;
+
 private:
   vtkRectilinearGridToPointSet(const vtkRectilinearGridToPointSet &); // Not implemented
   void operator=(const vtkRectilinearGridToPointSet &);         // Not implemented
@@ -58,8 +58,18 @@
 #include "vtkUnstructuredGrid.h"
 #include "vtkGenericCell.h"
 
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkSMPTools.h"
+#include "vtkSMPThreadLocalObject.h"
+
 #include "vtkTableBasedClipCases.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro( vtkTableBasedClipDataSet );
 vtkCxxSetObjectMacro( vtkTableBasedClipDataSet, ClipFunction, vtkImplicitFunction );
 
@@ -1597,6 +1607,644 @@ inline void GetPoint( double * pt, const double * X, const double * Y,
 // ============================================================================
 
 
+// ============================================================================
+// ============== vtkTableBasedClipperThreadedClipping (begin) ================
+// ============================================================================
+
+
+namespace
+{
+#include "vtkArrayListTemplate.h" // For processing attribute data
+
+// Whether the threaded clipping gives the output of the serial one: it only
+// interpolates the data arrays.
+bool vtkTableBasedClipperCanThread( vtkDataSet * input )
+{
+  vtkDataSetAttributes * data[2] = { input->GetPointData(),
+                                     input->GetCellData() };
+  for ( int d = 0; d < 2; d ++ )
+    {
+    for ( int i = 0; i < data[d]->GetNumberOfArrays(); i ++ )
+      {
+      if ( !data[d]->GetArray( i ) )
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+// The local point ids of the edges of a cell, as used by the clip cases.
+typedef const int vtkTableBasedClipperEdge[2];
+
+// Look up the clip case of a cell. Return false if the cell type is not
+// handled by the clip tables.
+bool vtkTableBasedClipperGetCase( int cellType, int caseIndx,
+                                  const unsigned char *& thisCase,
+                                  int & nOutputs,
+                                  vtkTableBasedClipperEdge *& edgeVtxs )
+{
+  using namespace vtkTableBasedClipperClipTables;
+  using namespace vtkTableBasedClipperTriangulationTables;
+
+  switch ( cellType )
+    {
+    case VTK_TETRA:
+      thisCase = &ClipShapesTet[ StartClipShapesTet[ caseIndx ] ];
+      nOutputs = NumClipShapesTet[ caseIndx ];
+      edgeVtxs = TetVerticesFromEdges;
+      return true;
+
+    case VTK_PYRAMID:
+      thisCase = &ClipShapesPyr[ StartClipShapesPyr[ caseIndx ] ];
+      nOutputs = NumClipShapesPyr[ caseIndx ];
+      edgeVtxs = PyramidVerticesFromEdges;
+      return true;
+
+    case VTK_WEDGE:
+      thisCase = &ClipShapesWdg[ StartClipShapesWdg[ caseIndx ] ];
+      nOutputs = NumClipShapesWdg[ caseIndx ];
+      edgeVtxs = WedgeVerticesFromEdges;
+      return true;
+
+    case VTK_HEXAHEDRON:
+      thisCase = &ClipShapesHex[ StartClipShapesHex[ caseIndx ] ];
+      nOutputs = NumClipShapesHex[ caseIndx ];
+      edgeVtxs = HexVerticesFromEdges;
+      return true;
+
+    case VTK_VOXEL:
+      thisCase = &ClipShapesVox[ StartClipShapesVox[ caseIndx ] ];
+      nOutputs = NumClipShapesVox[ caseIndx ];
+      edgeVtxs = VoxVerticesFromEdges;
+      return true;
+
+    case VTK_TRIANGLE:
+      thisCase = &ClipShapesTri[ StartClipShapesTri[ caseIndx ] ];
+      nOutputs = NumClipShapesTri[ caseIndx ];
+      edgeVtxs = TriVerticesFromEdges;
+      return true;
+
+    case VTK_QUAD:
+      thisCase = &ClipShapesQua[ StartClipShapesQua[ caseIndx ] ];
+      nOutputs = NumClipShapesQua[ caseIndx ];
+      edgeVtxs = QuadVerticesFromEdges;
+      return true;
+
+    case VTK_PIXEL:
+      thisCase = &ClipShapesPix[ StartClipShapesPix[ caseIndx ] ];
+      nOutputs = NumClipShapesPix[ caseIndx ];
+      edgeVtxs = PixelVerticesFromEdges;
+      return true;
+
+    case VTK_LINE:
+      thisCase = &ClipShapesLin[ StartClipShapesLin[ caseIndx ] ];
+      nOutputs = NumClipShapesLin[ caseIndx ];
+      edgeVtxs = LineVerticesFromEdges;
+      return true;
+
+    case VTK_VERTEX:
+      thisCase = &ClipShapesVtx[ StartClipShapesVtx[ caseIndx ] ];
+      nOutputs = NumClipShapesVtx[ caseIndx ];
+      edgeVtxs = NULL;
+      return true;
+    }
+
+  return false;
+}
+
+// The number of points of a shape of the clip cases.
+int vtkTableBasedClipperShapeSize( unsigned char shape )
+{
+  switch ( shape )
+    {
+    case ST_HEX: return 8;
+    case ST_WDG: return 6;
+    case ST_PYR: return 5;
+    case ST_TET: case ST_QUA: return 4;
+    case ST_TRI: return 3;
+    case ST_LIN: return 2;
+    }
+  return 1;
+}
+
+// The VTK cell type of a shape of the clip cases.
+unsigned char vtkTableBasedClipperShapeType( unsigned char shape )
+{
+  switch ( shape )
+    {
+    case ST_HEX: return VTK_HEXAHEDRON;
+    case ST_WDG: return VTK_WEDGE;
+    case ST_PYR: return VTK_PYRAMID;
+    case ST_TET: return VTK_TETRA;
+    case ST_QUA: return VTK_QUAD;
+    case ST_TRI: return VTK_TRIANGLE;
+    case ST_LIN: return VTK_LINE;
+    }
+  return VTK_VERTEX;
+}
+
+// A reference of a cell to an intersected edge, (Ids[0], Ids[1]) being the
+// input points of the edge (Ids[0] < Ids[1]) and Percent the weight of
+// Ids[0]. The references are sorted to merge the points of the edges shared
+// by several cells.
+struct vtkTableBasedClipperEdgeRef
+{
+  vtkIdType Ids[2];
+  vtkIdType Ref;
+  double    Percent;
+
+  bool operator<( const vtkTableBasedClipperEdgeRef & other ) const
+  {
+    if ( this->Ids[0] != other.Ids[0] )
+      {
+      return this->Ids[0] < other.Ids[0];
+      }
+    if ( this->Ids[1] != other.Ids[1] )
+      {
+      return this->Ids[1] < other.Ids[1];
+      }
+    return this->Ref < other.Ref;
+  }
+
+  bool IsSameEdge( const vtkTableBasedClipperEdgeRef & other ) const
+  {
+    return this->Ids[0] == other.Ids[0] && this->Ids[1] == other.Ids[1];
+  }
+};
+
+// Clip the cells with the clip cases. The first pass counts, for each input
+// cell, the output cells, their connectivity size, the edge references and
+// the centroid points (and their number of points). Once these counts are
+// summed into offsets, the second pass writes the output cells, the edge
+// references and the centroids. The output point ids are written encoded:
+// an input point keeps its id, the point of an edge reference r is
+// NumberOfPoints + r and the centroid c is NumberOfPoints + NumberOfEdges + c.
+class vtkTableBasedClipperCellsWorker
+{
+public:
+  vtkUnstructuredGrid * Input;
+  vtkDataArray * ClipArray;
+  double IsoValue;
+  int InsideOut;
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfEdges;
+
+  // Per input cell: counts, then offsets.
+  vtkIdType * CellOffsets;
+  vtkIdType * ConnOffsets;
+  vtkIdType * EdgeOffsets;
+  vtkIdType * CentroidOffsets;
+  vtkIdType * CentroidConnOffsets;
+  unsigned char * Specials;
+
+  // Output of the second pass, NULL during the first one.
+  unsigned char * Types;
+  vtkIdType * Offsets;
+  vtkIdType * Connectivity;
+  vtkIdType * SourceCells;
+  vtkTableBasedClipperEdgeRef * Edges;
+  vtkIdType * CentroidPtOffsets;
+  vtkIdType * CentroidConn;
+
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+
+  void operator()( vtkIdType begin, vtkIdType end )
+  {
+    vtkIdList * cellPts = this->CellPoints.Local();
+    bool fill = ( this->Connectivity != NULL );
+
+    for ( vtkIdType i = begin; i < end; i ++ )
+      {
+      int cellType = this->Input->GetCellType( i );
+      this->Input->GetCellPoints( i, cellPts );
+      const vtkIdType * pntIndxs = cellPts->GetPointer( 0 );
+      int numbPnts = static_cast<int>( cellPts->GetNumberOfIds() );
+
+      const unsigned char * thisCase = NULL;
+      int nOutputs = 0;
+      vtkTableBasedClipperEdge * edgeVtxs = NULL;
+      int caseIndx = 0;
+      double grdDiffs[8];
+      bool bCanClip = ( numbPnts <= 8 );
+      if ( bCanClip )
+        {
+        for ( int j = numbPnts - 1; j >= 0; j -- )
+          {
+          grdDiffs[j] = this->ClipArray->GetComponent( pntIndxs[j], 0 ) -
+                        this->IsoValue;
+          caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
+          caseIndx  <<= (  1 - ( !j )  );
+          }
+        bCanClip = vtkTableBasedClipperGetCase( cellType, caseIndx,
+                                                thisCase, nOutputs, edgeVtxs );
+        }
+
+      vtkIdType numCells = 0;
+      vtkIdType connSize = 0;
+      vtkIdType numEdges = 0;
+      vtkIdType numCentroids = 0;
+      vtkIdType centroidConnSize = 0;
+      vtkIdType intrpIds[4];
+      for ( int j = 0; bCanClip && j < nOutputs; j ++ )
+        {
+        int nCellPts = 0;
+        int theColor = -1;
+        int intrpIdx = -1;
+        unsigned char theShape = *thisCase ++;
+
+        if ( theShape == ST_PNT )
+          {
+          intrpIdx = *thisCase ++;
+          theColor = *thisCase ++;
+          nCellPts = *thisCase ++;
+          }
+        else
+          {
+          theColor = *thisCase ++;
+          nCellPts = vtkTableBasedClipperShapeSize( theShape );
+          }
+
+        if ( (!this->InsideOut && theColor == COLOR0 ) ||
+             ( this->InsideOut && theColor == COLOR1 )
+           )
+          {
+          // We don't want this one; it's the wrong side.
+          thisCase += nCellPts;
+          continue;
+          }
+
+        vtkIdType shapeIds[8];
+        for ( int p = 0; p < nCellPts; p ++ )
+          {
+          unsigned char pntIndex = *thisCase ++;
+
+          if ( pntIndex <= P7 )
+            {
+            shapeIds[p] = pntIndxs[ pntIndex ];
+            }
+          else
+          if ( pntIndex >= EA && pntIndex <= EL )
+            {
+            if ( fill )
+              {
+              int pt1Index = edgeVtxs[ pntIndex - EA ][0];
+              int pt2Index = edgeVtxs[ pntIndex - EA ][1];
+              if ( pt2Index < pt1Index )
+                {
+                std::swap( pt1Index, pt2Index );
+                }
+              double pt1ToPt2 = grdDiffs[ pt2Index ] - grdDiffs[ pt1Index ];
+              double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
+              double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
+
+              vtkIdType ref = this->EdgeOffsets[i] + numEdges;
+              vtkTableBasedClipperEdgeRef & edge = this->Edges[ ref ];
+              edge.Ref = ref;
+              if ( pntIndxs[ pt2Index ] < pntIndxs[ pt1Index ] )
+                {
+                edge.Ids[0]  = pntIndxs[ pt2Index ];
+                edge.Ids[1]  = pntIndxs[ pt1Index ];
+                edge.Percent = 1.0 - p1Weight;
+                }
+              else
+                {
+                edge.Ids[0]  = pntIndxs[ pt1Index ];
+                edge.Ids[1]  = pntIndxs[ pt2Index ];
+                edge.Percent = p1Weight;
+                }
+              shapeIds[p] = this->NumberOfPoints + ref;
+              }
+            numEdges ++;
+            }
+          else
+          if ( pntIndex >= N0 && pntIndex <= N3 )
+            {
+            shapeIds[p] = intrpIds[ pntIndex - N0 ];
+            }
+          }
+
+        if ( theShape == ST_PNT )
+          {
+          if ( fill )
+            {
+            vtkIdType centroid = this->CentroidOffsets[i] + numCentroids;
+            vtkIdType loc = this->CentroidConnOffsets[i] + centroidConnSize;
+            this->CentroidPtOffsets[ centroid ] = loc;
+            std::copy( shapeIds, shapeIds + nCellPts,
+                       this->CentroidConn + loc );
+            intrpIds[ intrpIdx ] =
+              this->NumberOfPoints + this->NumberOfEdges + centroid;
+            }
+          numCentroids ++;
+          centroidConnSize += nCellPts;
+          continue;
+          }
+
+        if ( fill )
+          {
+          vtkIdType cellId = this->CellOffsets[i] + numCells;
+          vtkIdType loc = this->ConnOffsets[i] + connSize;
+          this->Types[ cellId ] = vtkTableBasedClipperShapeType( theShape );
+          this->Offsets[ cellId ] = loc;
+          this->SourceCells[ cellId ] = i;
+          std::copy( shapeIds, shapeIds + nCellPts,
+                     this->Connectivity + loc );
+          }
+        numCells ++;
+        connSize += nCellPts;
+        }
+
+      if ( !fill )
+        {
+        this->Specials[i] = !bCanClip;
+        this->CellOffsets[i] = numCells;
+        this->ConnOffsets[i] = connSize;
+        this->EdgeOffsets[i] = numEdges;
+        this->CentroidOffsets[i] = numCentroids;
+        this->CentroidConnOffsets[i] = centroidConnSize;
+        }
+      }
+  }
+};
+
+// Flag the first reference of each edge in the sorted references. Once the
+// flags are summed, map each reference to the output point of its edge.
+class vtkTableBasedClipperMergeEdgesWorker
+{
+public:
+  const vtkTableBasedClipperEdgeRef * Edges;
+  vtkIdType * FirstRefs;
+  vtkIdType * EdgeMap;
+  vtkIdType * UniqueEdges;
+
+  void operator()( vtkIdType begin, vtkIdType end )
+  {
+    for ( vtkIdType i = begin; i < end; i ++ )
+      {
+      bool first = ( i == 0 || !this->Edges[i].IsSameEdge( this->Edges[i-1] ) );
+      if ( !this->EdgeMap )
+        {
+        this->FirstRefs[i] = first;
+        continue;
+        }
+      vtkIdType edgeId = this->FirstRefs[i] - ( first ? 0 : 1 );
+      this->EdgeMap[ this->Edges[i].Ref ] = edgeId;
+      if ( first )
+        {
+        this->UniqueEdges[ edgeId ] = i;
+        }
+      }
+  }
+};
+
+// Flag the input points used by the output.
+class vtkTableBasedClipperMarkPointsWorker
+{
+public:
+  const vtkIdType * Ids;
+  vtkIdType NumberOfPoints;
+  unsigned char * Used;
+
+  void operator()( vtkIdType begin, vtkIdType end )
+  {
+    for ( vtkIdType i = begin; i < end; i ++ )
+      {
+      if ( this->Ids[i] < this->NumberOfPoints )
+        {
+        this->Used[ this->Ids[i] ] = 1;
+        }
+      }
+  }
+};
+
+struct vtkTableBasedClipperUsedToCount
+{
+  vtkIdType operator()( unsigned char used ) const
+  {
+    return used;
+  }
+};
+
+struct vtkTableBasedClipperUnusedToNoId
+{
+  vtkIdType operator()( unsigned char used, vtkIdType newId ) const
+  {
+    return ( used ? newId : -1 );
+  }
+};
+
+// Decode the output point ids: the used input points come first, then the
+// points of the edges and the centroids.
+class vtkTableBasedClipperRenumberWorker
+{
+public:
+  vtkIdType * Ids;
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfEdges;
+  const vtkIdType * PointMap;
+  const vtkIdType * EdgeMap;
+  vtkIdType NumberOfUsedPoints;
+  vtkIdType NumberOfUniqueEdges;
+
+  void operator()( vtkIdType begin, vtkIdType end )
+  {
+    for ( vtkIdType i = begin; i < end; i ++ )
+      {
+      vtkIdType id = this->Ids[i];
+      if ( id < this->NumberOfPoints )
+        {
+        this->Ids[i] = this->PointMap[ id ];
+        }
+      else
+      if ( id < this->NumberOfPoints + this->NumberOfEdges )
+        {
+        this->Ids[i] = this->NumberOfUsedPoints +
+                       this->EdgeMap[ id - this->NumberOfPoints ];
+        }
+      else
+        {
+        this->Ids[i] = this->NumberOfUsedPoints + this->NumberOfUniqueEdges +
+                       ( id - this->NumberOfPoints - this->NumberOfEdges );
+        }
+      }
+  }
+};
+
+// Copy the used input points and their data.
+class vtkTableBasedClipperCopyPointsWorker
+{
+public:
+  vtkDataSet * Input;
+  const vtkIdType * PointMap;
+  vtkPoints * OutPoints;
+  ArrayList * Arrays;
+  vtkIntArray * OrigNodes;
+  vtkIntArray * NewOrigNodes;
+
+  void operator()( vtkIdType begin, vtkIdType end )
+  {
+    double x[3];
+    for ( vtkIdType i = begin; i < end; i ++ )
+      {
+      vtkIdType newId = this->PointMap[i];
+      if ( newId < 0 )
+        {
+        continue;
+        }
+      this->Input->GetPoint( i, x );
+      this->OutPoints->SetPoint( newId, x );
+      this->Arrays->Copy( i, newId );
+      if ( this->NewOrigNodes )
+        {
+        int nComps = this->OrigNodes->GetNumberOfComponents();
+        std::copy( this->OrigNodes->GetPointer( i * nComps ),
+                   this->OrigNodes->GetPointer( i * nComps ) + nComps,
+                   this->NewOrigNodes->GetPointer( newId * nComps ) );
+        }
+      }
+  }
+};
+
+// Interpolate the points of the intersected edges and their data.
+class vtkTableBasedClipperEdgePointsWorker
+{
+public:
+  vtkDataSet * Input;
+  const vtkTableBasedClipperEdgeRef * Edges;
+  const vtkIdType * UniqueEdges;
+  vtkIdType FirstId;
+  vtkPoints * OutPoints;
+  ArrayList * Arrays;
+  vtkIntArray * OrigNodes;
+  vtkIntArray * NewOrigNodes;
+
+  void operator()( vtkIdType begin, vtkIdType end )
+  {
+    double pt1[3], pt2[3], pt[3];
+    for ( vtkIdType i = begin; i < end; i ++ )
+      {
+      const vtkTableBasedClipperEdgeRef & pe = this->Edges[ this->UniqueEdges[i] ];
+      vtkIdType ptIdx = this->FirstId + i;
+      this->Input->GetPoint( pe.Ids[0], pt1 );
+      this->Input->GetPoint( pe.Ids[1], pt2 );
+      double p  = pe.Percent;
+      double bp = 1.0 - p;
+      pt[0] = pt1[0] * p + pt2[0] * bp;
+      pt[1] = pt1[1] * p + pt2[1] * bp;
+      pt[2] = pt1[2] * p + pt2[2] * bp;
+      this->OutPoints->SetPoint( ptIdx, pt );
+      this->Arrays->InterpolateEdge( pe.Ids[0], pe.Ids[1], bp, ptIdx );
+      if ( this->NewOrigNodes )
+        {
+        int nComps = this->OrigNodes->GetNumberOfComponents();
+        vtkIdType id = ( bp <= 0.5 ? pe.Ids[0] : pe.Ids[1] );
+        std::copy( this->OrigNodes->GetPointer( id * nComps ),
+                   this->OrigNodes->GetPointer( id * nComps ) + nComps,
+                   this->NewOrigNodes->GetPointer( ptIdx * nComps ) );
+        }
+      }
+  }
+};
+
+// Compute the centroid points, averaging output points. A centroid may
+// use the previous centroids of its cell, so those of a cell are computed
+// in order.
+class vtkTableBasedClipperCentroidsWorker
+{
+public:
+  const vtkIdType * CentroidOffsets;
+  const vtkIdType * CentroidPtOffsets;
+  const vtkIdType * CentroidConn;
+  vtkIdType FirstId;
+  vtkPoints * OutPoints;
+  ArrayList * Arrays;
+  vtkIntArray * NewOrigNodes;
+
+  void operator()( vtkIdType begin, vtkIdType end )
+  {
+    double weights[8];
+    double x[3];
+    for ( vtkIdType i = begin; i < end; i ++ )
+      {
+      for ( vtkIdType c = this->CentroidOffsets[i];
+            c < this->CentroidOffsets[i+1]; c ++ )
+        {
+        const vtkIdType * ids = this->CentroidConn + this->CentroidPtOffsets[c];
+        int nPts = static_cast<int>( this->CentroidPtOffsets[c+1] -
+                                     this->CentroidPtOffsets[c] );
+        double weight_factor = 1.0 / nPts;
+        double pt[3] = { 0.0, 0.0, 0.0 };
+        for ( int k = 0; k < nPts; k ++ )
+          {
+          weights[k] = weight_factor;
+          this->OutPoints->GetPoint( ids[k], x );
+          pt[0] += x[0];
+          pt[1] += x[1];
+          pt[2] += x[2];
+          }
+        pt[0] *= weight_factor;
+        pt[1] *= weight_factor;
+        pt[2] *= weight_factor;
+
+        vtkIdType ptIdx = this->FirstId + c;
+        this->OutPoints->SetPoint( ptIdx, pt );
+        this->Arrays->Interpolate( nPts, ids, weights, ptIdx );
+        if ( this->NewOrigNodes )
+          {
+          // these 'created' nodes have no original designation
+          for ( int z = 0; z < this->NewOrigNodes->GetNumberOfComponents(); z ++ )
+            {
+            this->NewOrigNodes->SetComponent( ptIdx, z, -1 );
+            }
+          }
+        }
+      }
+  }
+};
+
+// Copy the data of the input cells to their output pieces.
+class vtkTableBasedClipperCellDataWorker
+{
+public:
+  const vtkIdType * SourceCells;
+  ArrayList * Arrays;
+
+  void operator()( vtkIdType begin, vtkIdType end )
+  {
+    for ( vtkIdType i = begin; i < end; i ++ )
+      {
+      this->Arrays->Copy( this->SourceCells[i], i );
+      }
+  }
+};
+
+// Evaluate the clip function at the points of the input.
+class vtkTableBasedClipperFunctionWorker
+{
+public:
+  vtkDataSet * Input;
+  vtkImplicitFunction * Function;
+  vtkDoubleArray * Scalars;
+
+  void operator()( vtkIdType begin, vtkIdType end )
+  {
+    double x[3];
+    for ( vtkIdType i = begin; i < end; i ++ )
+      {
+      this->Input->GetPoint( i, x );
+      this->Scalars->SetValue( i, this->Function->FunctionValue( x ) );
+      }
+  }
+};
+}
+
+// ============================================================================
+// =============== vtkTableBasedClipperThreadedClipping ( end ) ===============
+// ============================================================================
+
+
 //-----------------------------------------------------------------------------
 // Construct with user-specified implicit function; InsideOut turned off; value
 // set to 0.0; and generate clip scalars turned off.
@@ -1619,6 +2267,7 @@ vtkTableBasedClipDataSet::vtkTableBasedClipDataSet( vtkImplicitFunction * cf )
   this->GenerateClippedOutput = 0;
 
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->EnableSMP = false;
 
   this->SetNumberOfOutputPorts( 2 );
   vtkUnstructuredGrid * output2 = vtkUnstructuredGrid::New();
@@ -1810,10 +2459,26 @@ int vtkTableBasedClipDataSet::RequestData( vtkInformation * vtkNotUsed( request
       cpyInput->GetPointData()->SetScalars( pScalars );
       }
 
-    for ( i = 0; i < numbPnts; i ++ )
+    if ( this->EnableSMP )
+      {
+      // the first evaluation is serial, for the functions that update their
+      // internal state then
+      double s = this->ClipFunction->FunctionValue(  cpyInput->GetPoint( 0 )  );
+      pScalars->SetTuple1( 0, s );
+
+      vtkTableBasedClipperFunctionWorker evaluate;
+      evaluate.Input    = cpyInput.GetPointer();
+      evaluate.Function = this->ClipFunction;
+      evaluate.Scalars  = pScalars;
+      vtkSMPTools::For( 1, numbPnts, evaluate );
+      }
+    else
       {
-      double s = this->ClipFunction->FunctionValue(  cpyInput->GetPoint( i )  );
-      pScalars->SetTuple1( i, s );
+      for ( i = 0; i < numbPnts; i ++ )
+        {
+        double s = this->ClipFunction->FunctionValue(  cpyInput->GetPoint( i )  );
+        pScalars->SetTuple1( i, s );
+        }
       }
 
     clipAray = pScalars;
@@ -3027,6 +3692,13 @@ void vtkTableBasedClipDataSet::ClipStructuredGridData( vtkDataSet * inputGrd,
 void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
      vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
 {
+  if ( this->EnableSMP && vtkTableBasedClipperCanThread( inputGrd ) )
+    {
+    this->ThreadedClipUnstructuredGridData( inputGrd, clipAray, isoValue,
+                                            outputUG );
+    return;
+    }
+
   vtkUnstructuredGrid * unstruct = vtkUnstructuredGrid::SafeDownCast( inputGrd );
 
   vtkIdType   i, j;
@@ -3429,6 +4101,307 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
   unstruct = NULL;
 }
 
+//-----------------------------------------------------------------------------
+// The same clipping as ClipUnstructuredGridData(), processing the cells with
+// vtkSMPTools. The cells are clipped in two passes (counting the output of
+// each input cell, then writing it once the counts are summed into offsets).
+// The points of the edges shared by several cells are merged by sorting the
+// references of the cells to their edges. The output cells are ordered as
+// the input cells they come from, and the output points are the used input
+// points (in input order) followed by the points of the edges (sorted by
+// point ids) and the centroids (in cell order).
+void vtkTableBasedClipDataSet::ThreadedClipUnstructuredGridData
+   ( vtkDataSet * inputGrd, vtkDataArray * clipAray, double isoValue,
+     vtkUnstructuredGrid * outputUG )
+{
+  vtkUnstructuredGrid * unstruct = vtkUnstructuredGrid::SafeDownCast( inputGrd );
+
+  vtkIdType   i;
+  vtkIdType   numbPnts = unstruct->GetNumberOfPoints();
+  vtkIdType   numCells = unstruct->GetNumberOfCells();
+
+  // first pass: count the output of each cell
+  std::vector< vtkIdType >     cellOffsets( numCells + 1, 0 );
+  std::vector< vtkIdType >     connOffsets( numCells + 1, 0 );
+  std::vector< vtkIdType >     edgeOffsets( numCells + 1, 0 );
+  std::vector< vtkIdType >     centroidOffsets( numCells + 1, 0 );
+  std::vector< vtkIdType >     centroidConnOffsets( numCells + 1, 0 );
+  std::vector< unsigned char > specials( numCells + 1, 0 );
+
+  vtkTableBasedClipperCellsWorker clipCells;
+  clipCells.Input      = unstruct;
+  clipCells.ClipArray  = clipAray;
+  clipCells.IsoValue   = isoValue;
+  clipCells.InsideOut  = this->InsideOut;
+  clipCells.NumberOfPoints  = numbPnts;
+  clipCells.NumberOfEdges   = 0;
+  clipCells.CellOffsets     = &cellOffsets[0];
+  clipCells.ConnOffsets     = &connOffsets[0];
+  clipCells.EdgeOffsets     = &edgeOffsets[0];
+  clipCells.CentroidOffsets = &centroidOffsets[0];
+  clipCells.CentroidConnOffsets = &centroidConnOffsets[0];
+  clipCells.Specials          = &specials[0];
+  clipCells.Types             = NULL;
+  clipCells.Offsets           = NULL;
+  clipCells.Connectivity      = NULL;
+  clipCells.SourceCells       = NULL;
+  clipCells.Edges             = NULL;
+  clipCells.CentroidPtOffsets = NULL;
+  clipCells.CentroidConn      = NULL;
+  vtkSMPTools::For( 0, numCells, clipCells );
+
+  vtkIdType numOutCells = vtkSMPTools::ExclusiveScan( cellOffsets.begin(),
+    cellOffsets.begin() + numCells, cellOffsets.begin(), vtkIdType( 0 ) );
+  vtkIdType connSize = vtkSMPTools::ExclusiveScan( connOffsets.begin(),
+    connOffsets.begin() + numCells, connOffsets.begin(), vtkIdType( 0 ) );
+  vtkIdType numbEdges = vtkSMPTools::ExclusiveScan( edgeOffsets.begin(),
+    edgeOffsets.begin() + numCells, edgeOffsets.begin(), vtkIdType( 0 ) );
+  vtkIdType numCentroids = vtkSMPTools::ExclusiveScan( centroidOffsets.begin(),
+    centroidOffsets.begin() + numCells, centroidOffsets.begin(),
+    vtkIdType( 0 ) );
+  centroidOffsets[ numCells ] = numCentroids;
+  vtkIdType centroidConnSize = vtkSMPTools::ExclusiveScan(
+    centroidConnOffsets.begin(), centroidConnOffsets.begin() + numCells,
+    centroidConnOffsets.begin(), vtkIdType( 0 ) );
+
+  // second pass: write the output cells, the edges and the centroids
+  vtkUnsignedCharArray * cellTypes = vtkUnsignedCharArray::New();
+  cellTypes->SetNumberOfValues( numOutCells );
+  vtkIdTypeArray * offsets = vtkIdTypeArray::New();
+  offsets->SetNumberOfValues( numOutCells + 1 );
+  offsets->SetValue( numOutCells, connSize );
+  vtkIdTypeArray * connectivity = vtkIdTypeArray::New();
+  connectivity->SetNumberOfValues( connSize );
+  std::vector< vtkIdType > sourceCells( numOutCells + 1 );
+  std::vector< vtkTableBasedClipperEdgeRef > edges( numbEdges + 1 );
+  std::vector< vtkIdType > centroidPtOffsets( numCentroids + 1 );
+  std::vector< vtkIdType > centroidConn( centroidConnSize + 1 );
+  centroidPtOffsets[ numCentroids ] = centroidConnSize;
+
+  clipCells.NumberOfEdges     = numbEdges;
+  clipCells.Types             = cellTypes->GetPointer( 0 );
+  clipCells.Offsets           = offsets->GetPointer( 0 );
+  clipCells.Connectivity      = connectivity->GetPointer( 0 );
+  clipCells.SourceCells       = &sourceCells[0];
+  clipCells.Edges             = &edges[0];
+  clipCells.CentroidPtOffsets = &centroidPtOffsets[0];
+  clipCells.CentroidConn      = &centroidConn[0];
+  vtkSMPTools::For( 0, numCells, clipCells );
+
+  // merge the points of the edges shared by several cells
+  vtkSMPTools::Sort( edges.begin(), edges.begin() + numbEdges );
+  std::vector< vtkIdType > firstRefs( numbEdges + 1, 0 );
+  std::vector< vtkIdType > edgeMap( numbEdges + 1 );
+  std::vector< vtkIdType > uniqueEdges( numbEdges + 1 );
+  vtkTableBasedClipperMergeEdgesWorker mergeEdges;
+  mergeEdges.Edges       = &edges[0];
+  mergeEdges.FirstRefs   = &firstRefs[0];
+  mergeEdges.EdgeMap     = NULL;
+  mergeEdges.UniqueEdges = &uniqueEdges[0];
+  vtkSMPTools::For( 0, numbEdges, mergeEdges );
+  vtkIdType numUnique = vtkSMPTools::ExclusiveScan( firstRefs.begin(),
+    firstRefs.begin() + numbEdges, firstRefs.begin(), vtkIdType( 0 ) );
+  mergeEdges.EdgeMap = &edgeMap[0];
+  vtkSMPTools::For( 0, numbEdges, mergeEdges );
+
+  // number the input points used by the cells and the centroids
+  std::vector< unsigned char > used( numbPnts + 1, 0 );
+  std::vector< vtkIdType >     pointMap( numbPnts + 1, -1 );
+  vtkTableBasedClipperMarkPointsWorker markPoints;
+  markPoints.NumberOfPoints = numbPnts;
+  markPoints.Used = &used[0];
+  markPoints.Ids  = clipCells.Connectivity;
+  vtkSMPTools::For( 0, connSize, markPoints );
+  markPoints.Ids  = &centroidConn[0];
+  vtkSMPTools::For( 0, centroidConnSize, markPoints );
+  vtkSMPTools::Transform( used.begin(), used.begin() + numbPnts,
+                          pointMap.begin(),
+                          vtkTableBasedClipperUsedToCount() );
+  vtkIdType numUsed = vtkSMPTools::ExclusiveScan( pointMap.begin(),
+    pointMap.begin() + numbPnts, pointMap.begin(), vtkIdType( 0 ) );
+  vtkSMPTools::Transform( used.begin(), used.begin() + numbPnts,
+                          pointMap.begin(), pointMap.begin(),
+                          vtkTableBasedClipperUnusedToNoId() );
+
+  vtkTableBasedClipperRenumberWorker renumber;
+  renumber.NumberOfPoints      = numbPnts;
+  renumber.NumberOfEdges       = numbEdges;
+  renumber.PointMap            = &pointMap[0];
+  renumber.EdgeMap             = &edgeMap[0];
+  renumber.NumberOfUsedPoints  = numUsed;
+  renumber.NumberOfUniqueEdges = numUnique;
+  renumber.Ids = clipCells.Connectivity;
+  vtkSMPTools::For( 0, connSize, renumber );
+  renumber.Ids = &centroidConn[0];
+  vtkSMPTools::For( 0, centroidConnSize, renumber );
+
+  // the cells that can not be clipped by this filter
+  int numCants = 0;
+  vtkUnstructuredGrid * visItGrd = outputUG;
+  vtkUnstructuredGrid * vtkUGrid = NULL;
+  for ( i = 0; i < numCells && numCants == 0; i ++ )
+    {
+    numCants = specials[i];
+    }
+  if ( numCants > 0 )
+    {
+    vtkUnstructuredGrid * specialGrd = vtkUnstructuredGrid::New();
+    specialGrd->SetPoints( unstruct->GetPoints() );
+    specialGrd->GetPointData()->ShallowCopy( unstruct->GetPointData() );
+    specialGrd->Allocate( numCells );
+    specialGrd->GetCellData()
+              ->CopyAllocate( unstruct->GetCellData(), numCells );
+    vtkIdList * cellPts = vtkIdList::New();
+    numCants = 0;
+    for ( i = 0; i < numCells; i ++ )
+      {
+      if ( !specials[i] )
+        {
+        continue;
+        }
+      int cellType = unstruct->GetCellType( i );
+      if ( cellType == VTK_POLYHEDRON )
+        {
+        vtkIdType nfaces, *facePtIds;
+        unstruct->GetFaceStream( i, nfaces, facePtIds );
+        specialGrd->InsertNextCell( cellType, nfaces, facePtIds );
+        }
+      else
+        {
+        unstruct->GetCellPoints( i, cellPts );
+        specialGrd->InsertNextCell( cellType, cellPts );
+        }
+      specialGrd->GetCellData()
+                ->CopyData( unstruct->GetCellData(), i, numCants );
+      numCants ++;
+      }
+    cellPts->Delete();
+
+    vtkUGrid = vtkUnstructuredGrid::New();
+    this->ClipDataSet( specialGrd, clipAray, vtkUGrid );
+    specialGrd->Delete();
+    visItGrd = vtkUnstructuredGrid::New();
+    }
+
+  vtkCellArray * cellArray = vtkCellArray::New();
+  cellArray->SetData( offsets, connectivity );
+  visItGrd->SetCells( cellTypes, NULL, cellArray, NULL, NULL );
+  cellArray->Delete();
+  cellTypes->Delete();
+  offsets->Delete();
+  connectivity->Delete();
+
+  // the points and their data
+  vtkIdType nOutPts = numUsed + numUnique + numCentroids;
+  vtkPoints * outPts = vtkPoints::New();
+  if ( this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION )
+    {
+    outPts->SetDataType( unstruct->GetPoints()->GetDataType() );
+    }
+  else
+  if ( this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION )
+    {
+    outPts->SetDataType( VTK_FLOAT );
+    }
+  else
+  if ( this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION )
+    {
+    outPts->SetDataType( VTK_DOUBLE );
+    }
+  outPts->SetNumberOfPoints( nOutPts );
+
+  vtkPointData * inPD  = unstruct->GetPointData();
+  vtkPointData * outPD = visItGrd->GetPointData();
+  outPD->CopyAllocate( inPD, nOutPts );
+
+  vtkIntArray * newOrigNodes = NULL;
+  vtkIntArray * origNodes = vtkIntArray::SafeDownCast
+                (  inPD->GetArray( "avtOriginalNodeNumbers" )  );
+  if ( origNodes != NULL )
+    {
+    newOrigNodes = vtkIntArray::New();
+    newOrigNodes->SetNumberOfComponents( origNodes->GetNumberOfComponents() );
+    newOrigNodes->SetNumberOfTuples( nOutPts );
+    newOrigNodes->SetName( origNodes->GetName() );
+    // AddArray will overwrite an already existing array with
+    // the same name, exactly what we want here.
+    outPD->AddArray( newOrigNodes );
+    newOrigNodes->Delete();
+    }
+
+  // the centroids average the output points, hence their data
+  ArrayList pointArrays;
+  ArrayList centroidArrays;
+  if ( newOrigNodes )
+    {
+    pointArrays.ExcludeArray( origNodes );
+    centroidArrays.ExcludeArray( newOrigNodes );
+    }
+  pointArrays.AddArrays( nOutPts, inPD, outPD );
+  centroidArrays.AddArrays( nOutPts, outPD, outPD );
+
+  vtkTableBasedClipperCopyPointsWorker copyPoints;
+  copyPoints.Input        = unstruct;
+  copyPoints.PointMap     = &pointMap[0];
+  copyPoints.OutPoints    = outPts;
+  copyPoints.Arrays       = &pointArrays;
+  copyPoints.OrigNodes    = origNodes;
+  copyPoints.NewOrigNodes = newOrigNodes;
+  vtkSMPTools::For( 0, numbPnts, copyPoints );
+
+  vtkTableBasedClipperEdgePointsWorker edgePoints;
+  edgePoints.Input        = unstruct;
+  edgePoints.Edges        = &edges[0];
+  edgePoints.UniqueEdges  = &uniqueEdges[0];
+  edgePoints.FirstId      = numUsed;
+  edgePoints.OutPoints    = outPts;
+  edgePoints.Arrays       = &pointArrays;
+  edgePoints.OrigNodes    = origNodes;
+  edgePoints.NewOrigNodes = newOrigNodes;
+  vtkSMPTools::For( 0, numUnique, edgePoints );
+
+  vtkTableBasedClipperCentroidsWorker centroids;
+  centroids.CentroidOffsets   = &centroidOffsets[0];
+  centroids.CentroidPtOffsets = &centroidPtOffsets[0];
+  centroids.CentroidConn      = &centroidConn[0];
+  centroids.FirstId           = numUsed + numUnique;
+  centroids.OutPoints         = outPts;
+  centroids.Arrays            = &centroidArrays;
+  centroids.NewOrigNodes      = newOrigNodes;
+  vtkSMPTools::For( 0, numCells, centroids );
+
+  visItGrd->SetPoints( outPts );
+  outPts->Delete();
+
+  // the cell data
+  vtkCellData * inCD  = unstruct->GetCellData();
+  vtkCellData * outCD = visItGrd->GetCellData();
+  outCD->CopyAllocate( inCD, numOutCells );
+  ArrayList cellArrays;
+  cellArrays.AddArrays( numOutCells, inCD, outCD );
+  vtkTableBasedClipperCellDataWorker copyCellData;
+  copyCellData.SourceCells = &sourceCells[0];
+  copyCellData.Arrays      = &cellArrays;
+  vtkSMPTools::For( 0, numOutCells, copyCellData );
+
+  if ( vtkUGrid )
+    {
+    vtkAppendFilter * appender = vtkAppendFilter::New();
+    appender->AddInputData( vtkUGrid );
+    appender->AddInputData( visItGrd );
+    appender->Update();
+
+    outputUG->ShallowCopy( appender->GetOutput() );
+
+    appender->Delete();
+    visItGrd->Delete();
+    vtkUGrid->Delete();
+    }
+  visItGrd = NULL;
+  vtkUGrid = NULL;
+  unstruct = NULL;
+}
+
 //-----------------------------------------------------------------------------
 void vtkTableBasedClipDataSet::PrintSelf( ostream & os, vtkIndent indent )
 {
@@ -3465,4 +4438,7 @@ void vtkTableBasedClipDataSet::PrintSelf( ostream & os, vtkIndent indent )
 
   os << indent << "Precision of the output points: "
      << this->OutputPointsPrecision << "\n";
+
+  os << indent << "Enable SMP: "
+     << (this->EnableSMP ? "On\n" : "Off\n");
 }
@@ -195,6 +195,19 @@ public:
   vtkSetClampMacro(OutputPointsPrecision, int, SINGLE_PRECISION, DEFAULT_PRECISION);
   vtkGetMacro(OutputPointsPrecision, int);
 
+  // Description:
+  // Turn on/off the use of vtkSMPTools to evaluate the clip function at the
+  // points and to clip the cells of a vtkUnstructuredGrid with several
+  // threads. The output has the same cells as with the serial execution,
+  // but they are ordered as the input cells they come from and the points
+  // are numbered differently. The cells are clipped serially when the
+  // input has string or other non-numeric point or cell arrays, which are
+  // not interpolated concurrently. The clip function must support
+  // concurrent evaluations. Off by default.
+  vtkSetMacro( EnableSMP, bool );
+  vtkGetMacro( EnableSMP, bool );
+  vtkBooleanMacro( EnableSMP, bool );
+
 protected:
   vtkTableBasedClipDataSet( vtkImplicitFunction * cf = NULL );
   ~vtkTableBasedClipDataSet();
@@ -248,6 +261,13 @@ protected:
   void ClipUnstructuredGridData( vtkDataSet * inputGrd, vtkDataArray * clipAray,
                                  double isoValue, vtkUnstructuredGrid * outputUG );
 
+  // Description:
+  // Threaded implementation of ClipUnstructuredGridData(), see EnableSMP.
+  void ThreadedClipUnstructuredGridData( vtkDataSet * inputGrd,
+                                         vtkDataArray * clipAray,
+                                         double isoValue,
+                                         vtkUnstructuredGrid * outputUG );
+
 
   // Description:
   // Register a callback function with the InternalProgressObserver.
@@ -270,6 +290,7 @@ protected:
   vtkIncrementalPointLocator * Locator;
 
   int OutputPointsPrecision;
+  bool EnableSMP;
 
 private:
   vtkTableBasedClipDataSet( const vtkTableBasedClipDataSet &); // Not implemented.
@@ -0,0 +1,276 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetSurfaceFilterSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the threaded extraction of the surface of unstructured grids
+// gives the same polygons as the serial one.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkDataSetSurfaceFilter.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkIntArray.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+namespace
+{
+const int N = 8;
+
+vtkIdType PointId(int i, int j, int k)
+{
+  return i + (N + 1) * (j + (N + 1) * k);
+}
+
+// A block of N^3 cubes: layers of hexahedra, voxels, tetrahedra (six per
+// cube, conforming) and wedges (two per cube), and a few empty cells.
+vtkSmartPointer<vtkUnstructuredGrid> MakeGrid()
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkFloatArray> scalars =
+    vtkSmartPointer<vtkFloatArray>::New();
+  scalars->SetName("Scalars");
+  for (int k = 0; k <= N; ++k)
+    {
+    for (int j = 0; j <= N; ++j)
+      {
+      for (int i = 0; i <= N; ++i)
+        {
+        points->InsertNextPoint(i, j + 0.1 * i, k);
+        scalars->InsertNextValue(i + 10 * j + 100 * k);
+        }
+      }
+    }
+  grid->SetPoints(points);
+  grid->GetPointData()->AddArray(scalars);
+  grid->Allocate(6 * N * N * N);
+
+  const int kuhn[6][4] = { {0,1,3,7}, {0,1,5,7}, {0,2,3,7}, {0,2,6,7},
+                           {0,4,5,7}, {0,4,6,7} };
+  for (int k = 0; k < N; ++k)
+    {
+    for (int j = 0; j < N; ++j)
+      {
+      for (int i = 0; i < N; ++i)
+        {
+        // The corners of the cube, in voxel order.
+        vtkIdType c[8];
+        for (int l = 0; l < 8; ++l)
+          {
+          c[l] = PointId(i + (l & 1), j + ((l >> 1) & 1), k + (l >> 2));
+          }
+        int layer = 4 * k / N;
+        if (layer == 0)
+          {
+          vtkIdType hex[8] = { c[0], c[1], c[3], c[2], c[4], c[5], c[7], c[6] };
+          grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+          }
+        else if (layer == 1)
+          {
+          grid->InsertNextCell(VTK_VOXEL, 8, c);
+          if (i == j)
+            {
+            grid->InsertNextCell(VTK_EMPTY_CELL, 0, c);
+            }
+          }
+        else if (layer == 2)
+          {
+          for (int t = 0; t < 6; ++t)
+            {
+            vtkIdType tet[4] = { c[kuhn[t][0]], c[kuhn[t][1]], c[kuhn[t][2]],
+                                 c[kuhn[t][3]] };
+            grid->InsertNextCell(VTK_TETRA, 4, tet);
+            }
+          }
+        else
+          {
+          vtkIdType wedge1[6] = { c[0], c[1], c[2], c[4], c[5], c[6] };
+          vtkIdType wedge2[6] = { c[1], c[3], c[2], c[5], c[7], c[6] };
+          grid->InsertNextCell(VTK_WEDGE, 6, wedge1);
+          grid->InsertNextCell(VTK_WEDGE, 6, wedge2);
+          }
+        }
+      }
+    }
+
+  vtkSmartPointer<vtkIntArray> cellIds = vtkSmartPointer<vtkIntArray>::New();
+  cellIds->SetName("CellIds");
+  for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); ++cellId)
+    {
+    cellIds->InsertNextValue(static_cast<int>(cellId));
+    }
+  grid->GetCellData()->AddArray(cellIds);
+  return grid;
+}
+
+vtkPolyData *ExtractSurface(vtkDataSetSurfaceFilter *surface,
+                            vtkUnstructuredGrid *grid, bool smp)
+{
+  surface->SetInputData(grid);
+  surface->SetEnableSMP(smp);
+  surface->PassThroughCellIdsOn();
+  surface->PassThroughPointIdsOn();
+  surface->Update();
+  return surface->GetOutput();
+}
+
+// Compare the polygons, in terms of input points and cells. The points of
+// the threaded output are ordered by input id.
+bool SameSurfaces(vtkPolyData *serial, vtkPolyData *smp, bool threaded,
+                  const char *name)
+{
+  vtkIdTypeArray *serialCellIds = vtkIdTypeArray::SafeDownCast(
+    serial->GetCellData()->GetArray("vtkOriginalCellIds"));
+  vtkIdTypeArray *smpCellIds = vtkIdTypeArray::SafeDownCast(
+    smp->GetCellData()->GetArray("vtkOriginalCellIds"));
+  vtkIdTypeArray *serialPointIds = vtkIdTypeArray::SafeDownCast(
+    serial->GetPointData()->GetArray("vtkOriginalPointIds"));
+  vtkIdTypeArray *smpPointIds = vtkIdTypeArray::SafeDownCast(
+    smp->GetPointData()->GetArray("vtkOriginalPointIds"));
+  vtkDataArray *serialCellData = serial->GetCellData()->GetArray("CellIds");
+  vtkDataArray *smpCellData = smp->GetCellData()->GetArray("CellIds");
+  vtkDataArray *smpScalars = smp->GetPointData()->GetArray("Scalars");
+  if (!serialCellIds || !smpCellIds || !serialPointIds || !smpPointIds ||
+      !serialCellData || !smpCellData || !smpScalars ||
+      serial->GetNumberOfPolys() != smp->GetNumberOfPolys() ||
+      serial->GetNumberOfPoints() != smp->GetNumberOfPoints() ||
+      smp->GetNumberOfPolys() == 0)
+    {
+    cerr << "Different outputs for " << name << endl;
+    return false;
+    }
+
+  vtkIdType npts1, *pts1, npts2, *pts2;
+  vtkCellArray *polys1 = serial->GetPolys();
+  vtkCellArray *polys2 = smp->GetPolys();
+  polys1->InitTraversal();
+  polys2->InitTraversal();
+  for (vtkIdType cellId = 0; cellId < smp->GetNumberOfPolys(); ++cellId)
+    {
+    polys1->GetNextCell(npts1, pts1);
+    polys2->GetNextCell(npts2, pts2);
+    bool same = (npts1 == npts2 &&
+                 serialCellIds->GetValue(cellId) ==
+                 smpCellIds->GetValue(cellId) &&
+                 serialCellData->GetComponent(cellId, 0) ==
+                 smpCellData->GetComponent(cellId, 0));
+    for (vtkIdType i = 0; i < npts1 && same; ++i)
+      {
+      same = (serialPointIds->GetValue(pts1[i]) ==
+              smpPointIds->GetValue(pts2[i]));
+      }
+    if (!same)
+      {
+      cerr << "Different polygon " << cellId << " for " << name << endl;
+      return false;
+      }
+    }
+
+  // The points have the coordinates and data of the input points.
+  for (vtkIdType ptId = 0; ptId < smp->GetNumberOfPoints(); ++ptId)
+    {
+    vtkIdType inPtId = smpPointIds->GetValue(ptId);
+    int i = static_cast<int>(inPtId % (N + 1));
+    int j = static_cast<int>(inPtId / (N + 1) % (N + 1));
+    int k = static_cast<int>(inPtId / ((N + 1) * (N + 1)));
+    double x[3];
+    smp->GetPoint(ptId, x);
+    if ((threaded && ptId > 0 && inPtId <= smpPointIds->GetValue(ptId - 1)) ||
+        x[0] != i || x[1] != static_cast<float>(j + 0.1 * i) || x[2] != k ||
+        smpScalars->GetComponent(ptId, 0) != i + 10 * j + 100 * k)
+      {
+      cerr << "Wrong point " << ptId << " for " << name << endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int TestDataSetSurfaceFilterSMP(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+
+  vtkSmartPointer<vtkUnstructuredGrid> grid = MakeGrid();
+  vtkSmartPointer<vtkDataSetSurfaceFilter> serialSurface =
+    vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
+  vtkSmartPointer<vtkDataSetSurfaceFilter> smpSurface =
+    vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
+  if (!SameSurfaces(ExtractSurface(serialSurface, grid, false),
+                    ExtractSurface(smpSurface, grid, true), true,
+                    "mixed cells"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Only the faces of the boundary of the hexahedra are kept.
+  vtkSmartPointer<vtkUnstructuredGrid> hexahedra =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  hexahedra->SetPoints(grid->GetPoints());
+  hexahedra->Allocate(N * N * N / 4);
+  for (vtkIdType cellId = 0; cellId < N * N * N / 4; ++cellId)
+    {
+    hexahedra->InsertNextCell(grid->GetCellType(cellId),
+                              grid->GetCell(cellId)->GetPointIds());
+    }
+  vtkPolyData *surface = ExtractSurface(smpSurface, hexahedra, true);
+  if (surface->GetNumberOfPolys() != 2 * N * N + 4 * N * N / 4 ||
+      surface->GetNumberOfPoints() !=
+      (N + 1) * (N + 1) * (N / 4 + 1) - (N - 1) * (N - 1) * (N / 4 - 1))
+    {
+    cerr << "Wrong surface of the hexahedra" << endl;
+    return EXIT_FAILURE;
+    }
+
+  // With ghost points, the faces made only of ghost points are removed.
+  vtkSmartPointer<vtkUnsignedCharArray> ghosts =
+    vtkSmartPointer<vtkUnsignedCharArray>::New();
+  ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+  for (vtkIdType ptId = 0; ptId < grid->GetNumberOfPoints(); ++ptId)
+    {
+    ghosts->InsertNextValue(ptId % (N + 1) == 0 ?
+                            vtkDataSetAttributes::DUPLICATEPOINT : 0);
+    }
+  grid->GetPointData()->AddArray(ghosts);
+  if (!SameSurfaces(ExtractSurface(serialSurface, grid, false),
+                    ExtractSurface(smpSurface, grid, true), true,
+                    "ghost points"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Grids with other cells are processed serially.
+  vtkIdType quad[4] = { PointId(0, 0, 0), PointId(1, 0, 0), PointId(1, 1, 0),
+                        PointId(0, 1, 0) };
+  grid->InsertNextCell(VTK_QUAD, 4, quad);
+  grid->GetCellData()->GetArray("CellIds")->InsertNextTuple1(
+    grid->GetNumberOfCells() - 1);
+  if (!SameSurfaces(ExtractSurface(serialSurface, grid, false),
+                    ExtractSurface(smpSurface, grid, true), false,
+                    "mixed dimensions"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -44,8 +44,14 @@
 #include "vtkVoxel.h"
 #include "vtkWedge.h"
 #include "vtkStructuredData.h"
+#include "vtkArrayListTemplate.h" // For processing attribute data
+#include "vtkIdList.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 
 #include <algorithm>
+#include <utility>
+#include <vector>
 #include <vtksys/hash_map.hxx>
 
 #include <cassert>
@@ -66,6 +72,108 @@ static inline int sizeofFastQuad(int numPts)
     }
 }
 
+// Rotate the point ids of a face so that the first one, which selects the
+// hash bin, is the smallest one. The orientation of the face is kept.
+// The serial hash and the threaded extraction both use these functions, so
+// that they find the same faces.
+static inline void vtkOrderTriIds(vtkIdType ids[3])
+{
+  vtkIdType tmp;
+  if (ids[1] < ids[0] && ids[1] < ids[2])
+    {
+    tmp = ids[0];
+    ids[0] = ids[1];
+    ids[1] = ids[2];
+    ids[2] = tmp;
+    }
+  else if (ids[2] < ids[0] && ids[2] < ids[1])
+    {
+    tmp = ids[0];
+    ids[0] = ids[2];
+    ids[2] = ids[1];
+    ids[1] = tmp;
+    }
+  // We can't put the second smallest in ids[1] because it might change the
+  // order of the vertices in the final triangle.
+}
+
+static inline void vtkOrderQuadIds(vtkIdType ids[4])
+{
+  vtkIdType tmp;
+  if (ids[1] < ids[0] && ids[1] < ids[2] && ids[1] < ids[3])
+    {
+    tmp = ids[0];
+    ids[0] = ids[1];
+    ids[1] = ids[2];
+    ids[2] = ids[3];
+    ids[3] = tmp;
+    }
+  else if (ids[2] < ids[0] && ids[2] < ids[1] && ids[2] < ids[3])
+    {
+    std::swap(ids[0], ids[2]);
+    std::swap(ids[1], ids[3]);
+    }
+  else if (ids[3] < ids[0] && ids[3] < ids[1] && ids[3] < ids[2])
+    {
+    tmp = ids[0];
+    ids[0] = ids[3];
+    ids[3] = ids[2];
+    ids[2] = ids[1];
+    ids[1] = tmp;
+    }
+}
+
+static inline void vtkOrderPolygonIds(vtkIdType *ids, int numPts)
+{
+  int offset = 0;
+  for (int i = 1; i < numPts; i++)
+    {
+    if (ids[i] < ids[offset])
+      {
+      offset = i;
+      }
+    }
+  std::rotate(ids, ids + offset, ids + numPts);
+}
+
+// Return whether two faces with the same number of points, ordered as
+// above, are the same face (with either orientation).
+static inline bool vtkSameFaceIds(const vtkIdType *ids, const vtkIdType *other,
+                                  int numPts)
+{
+  if (ids[0] != other[0])
+    {
+    return false;
+    }
+  if (numPts == 3)
+    {
+    return (ids[1] == other[1] && ids[2] == other[2]) ||
+      (ids[1] == other[2] && ids[2] == other[1]);
+    }
+  if (numPts == 4)
+    {
+    // The third point does not depend on the orientation.
+    return ids[2] == other[2] &&
+      ((ids[1] == other[1] && ids[3] == other[3]) ||
+       (ids[1] == other[3] && ids[3] == other[1]));
+    }
+  int i;
+  if (ids[1] == other[1])
+    {
+    for (i = 2; i < numPts && ids[i] == other[i]; ++i)
+      {
+      }
+    }
+  else
+    {
+    // check if the points go in the opposite direction
+    for (i = 1; i < numPts && ids[numPts-i] == other[i]; ++i)
+      {
+      }
+    }
+  return i == numPts;
+}
+
 class vtkDataSetSurfaceFilter::vtkEdgeInterpolationMap
 {
 public:
@@ -128,6 +236,8 @@ vtkDataSetSurfaceFilter::vtkDataSetSurfaceFilter()
   this->OriginalPointIdsName = NULL;
 
   this->NonlinearSubdivisionLevel = 1;
+
+  this->EnableSMP = false;
 }
 
 //----------------------------------------------------------------------------
@@ -1291,6 +1401,7 @@ void vtkDataSetSurfaceFilter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "NonlinearSubdivisionLevel: "
      << this->NonlinearSubdivisionLevel << endl;
+  os << indent << "EnableSMP: " << (this->EnableSMP ? "On\n" : "Off\n");
 }
 
 //========================================================================
@@ -1303,6 +1414,12 @@ void vtkDataSetSurfaceFilter::PrintSelf(ostream& os, vtkIndent indent)
 int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
                                                      vtkPolyData *output)
 {
+  if (this->EnableSMP &&
+      this->UnstructuredGridExecuteSMP(dataSetInput, output))
+    {
+    return 1;
+    }
+
   vtkUnstructuredGridBase *input =
       vtkUnstructuredGridBase::SafeDownCast(dataSetInput);
 
@@ -2000,6 +2117,451 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
   return 1;
 }
 
+//----------------------------------------------------------------------------
+// Helper classes to support efficient computing, and threaded execution.
+namespace {
+
+typedef std::pair<vtkIdType, vtkIdType> vtkSurfaceFaceKey; // (bin, face id)
+
+// The faces of the cells processed in parallel: the number of faces, then
+// the number of points and the cell point indices of each face. They are
+// listed in the order UnstructuredGridExecute() inserts them in the hash
+// (the wedge and pyramid faces are those of vtkWedge and vtkPyramid).
+const int EmptyCellFaces[] = { 0 };
+const int TetraFaces[] = { 4,
+  3, 0,1,3,  3, 0,2,1,  3, 0,3,2,  3, 1,2,3 };
+const int HexahedronFaces[] = { 6,
+  4, 0,1,5,4,  4, 0,3,2,1,  4, 0,4,7,3,  4, 1,2,6,5,  4, 2,3,7,6,
+  4, 4,5,6,7 };
+const int VoxelFaces[] = { 6,
+  4, 0,1,5,4,  4, 0,2,3,1,  4, 0,4,6,2,  4, 1,3,7,5,  4, 2,6,7,3,
+  4, 4,5,7,6 };
+const int WedgeFaces[] = { 5,
+  3, 0,1,2,  3, 3,5,4,  4, 0,3,4,1,  4, 1,4,5,2,  4, 2,5,3,0 };
+const int PyramidFaces[] = { 5,
+  4, 0,3,2,1,  3, 0,1,4,  3, 1,2,4,  3, 2,3,4,  3, 3,0,4 };
+const int PentagonalPrismFaces[] = { 7,
+  4, 0,1,6,5,  4, 1,2,7,6,  4, 2,3,8,7,  4, 3,4,9,8,  4, 4,0,5,9,
+  5, 0,1,2,3,4,  5, 5,6,7,8,9 };
+const int HexagonalPrismFaces[] = { 8,
+  4, 0,1,7,6,  4, 1,2,8,7,  4, 2,3,9,8,  4, 3,4,10,9,  4, 4,5,11,10,
+  4, 5,0,6,11,  6, 0,1,2,3,4,5,  6, 6,7,8,9,10,11 };
+
+const int *GetFaces(int cellType)
+{
+  switch (cellType)
+    {
+    case VTK_EMPTY_CELL:
+      return EmptyCellFaces;
+    case VTK_TETRA:
+      return TetraFaces;
+    case VTK_HEXAHEDRON:
+      return HexahedronFaces;
+    case VTK_VOXEL:
+      return VoxelFaces;
+    case VTK_WEDGE:
+      return WedgeFaces;
+    case VTK_PYRAMID:
+      return PyramidFaces;
+    case VTK_PENTAGONAL_PRISM:
+      return PentagonalPrismFaces;
+    case VTK_HEXAGONAL_PRISM:
+      return HexagonalPrismFaces;
+    default:
+      return NULL;
+    }
+}
+
+// Whether the arrays of attribute data can all be copied by an ArrayList,
+// which matches the input and output arrays by name.
+bool CanCopyArrays(vtkDataSetAttributes *attributes)
+{
+  for (int i = 0; i < attributes->GetNumberOfArrays(); ++i)
+    {
+    vtkAbstractArray *array = attributes->GetAbstractArray(i);
+    if (!vtkDataArray::SafeDownCast(array) || !array->GetName())
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+// Gather the faces of the cells, with their point ids ordered as in the
+// hash, and the keys used to sort them in the order of the hash traversal.
+struct GatherFaces
+{
+  vtkUnstructuredGrid *Input;
+  const vtkIdType *FaceOffsets;
+  int MaxFaceSize;
+  vtkSurfaceFaceKey *Keys;
+  unsigned char *FaceSizes;
+  vtkIdType *FacePoints;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    vtkIdList *cellPts = this->CellPoints.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      const int *faces = GetFaces(this->Input->GetCellType(cellId));
+      int numFaces = *faces++;
+      if (numFaces == 0)
+        {
+        continue;
+        }
+      this->Input->GetCellPoints(cellId, cellPts);
+      const vtkIdType *ids = cellPts->GetPointer(0);
+      vtkIdType faceId = this->FaceOffsets[cellId];
+      for (int i = 0; i < numFaces; ++i, ++faceId)
+        {
+        int numFacePts = *faces++;
+        vtkIdType *facePts = this->FacePoints + faceId * this->MaxFaceSize;
+        for (int j = 0; j < numFacePts; ++j)
+          {
+          facePts[j] = ids[*faces++];
+          }
+        if (numFacePts == 3)
+          {
+          vtkOrderTriIds(facePts);
+          }
+        else if (numFacePts == 4)
+          {
+          vtkOrderQuadIds(facePts);
+          }
+        else
+          {
+          vtkOrderPolygonIds(facePts, numFacePts);
+          }
+        this->FaceSizes[faceId] = static_cast<unsigned char>(numFacePts);
+        this->Keys[faceId] = vtkSurfaceFaceKey(facePts[0], faceId);
+        }
+      }
+    }
+};
+
+// Find the faces used by a single cell. As in the hash, each face is
+// compared with the other faces of its bin (the faces with the same first
+// point id). A range of sorted keys processes the bins starting in it.
+// The points of the faces are flagged in PointMap; several threads may set
+// the same flag.
+struct ClassifyFaces
+{
+  const vtkSurfaceFaceKey *Keys;
+  vtkIdType NumberOfFaces;
+  const unsigned char *FaceSizes;
+  const vtkIdType *FacePoints;
+  int MaxFaceSize;
+  vtkUnsignedCharArray *Ghosts;
+  vtkIdType *CellOffsets;
+  vtkIdType *ConnOffsets;
+  vtkIdType *PointMap;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+    {
+    vtkIdType binStart = begin;
+    while (binStart < end && binStart > 0 &&
+           this->Keys[binStart].first == this->Keys[binStart-1].first)
+      {
+      ++binStart;
+      }
+    while (binStart < end)
+      {
+      vtkIdType binEnd = binStart + 1;
+      while (binEnd < this->NumberOfFaces &&
+             this->Keys[binEnd].first == this->Keys[binStart].first)
+        {
+        ++binEnd;
+        }
+      for (vtkIdType i = binStart; i < binEnd; ++i)
+        {
+        vtkIdType faceId = this->Keys[i].second;
+        int numPts = this->FaceSizes[faceId];
+        const vtkIdType *pts = this->FacePoints + faceId * this->MaxFaceSize;
+        bool visible = true;
+        for (vtkIdType j = binStart; j < binEnd && visible; ++j)
+          {
+          vtkIdType otherId = this->Keys[j].second;
+          visible = (j == i || this->FaceSizes[otherId] != numPts ||
+                     !vtkSameFaceIds(pts, this->FacePoints +
+                                     otherId * this->MaxFaceSize, numPts));
+          }
+        for (int k = 0; k < numPts && visible; ++k)
+          {
+          this->PointMap[pts[k]] = 1;
+          }
+        if (visible && this->Ghosts)
+          {
+          // If all points of the face are ghosts, we throw it away. As in
+          // the serial path, its points are still output.
+          visible = false;
+          for (int k = 0; k < numPts && !visible; ++k)
+            {
+            visible = (this->Ghosts->GetValue(pts[k]) == 0);
+            }
+          }
+        this->CellOffsets[i] = (visible ? 1 : 0);
+        this->ConnOffsets[i] = (visible ? numPts : 0);
+        }
+      binStart = binEnd;
+      }
+    }
+};
+
+// Copy the used points and their data. Point ptId is used when
+// PointMap[ptId+1] != PointMap[ptId].
+struct CopyPoints
+{
+  vtkPoints *InPoints;
+  vtkPoints *OutPoints;
+  const vtkIdType *PointMap;
+  ArrayList *Arrays;
+  vtkIdType *OriginalPointIds;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+    {
+    double x[3];
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      vtkIdType outId = this->PointMap[ptId];
+      if (this->PointMap[ptId+1] == outId)
+        {
+        continue;
+        }
+      this->InPoints->GetPoint(ptId, x);
+      this->OutPoints->SetPoint(outId, x);
+      this->Arrays->Copy(ptId, outId);
+      if (this->OriginalPointIds)
+        {
+        this->OriginalPointIds[outId] = ptId;
+        }
+      }
+    }
+};
+
+// Write the output polygons and their data, in the order of the sorted keys.
+struct FillPolys
+{
+  const vtkSurfaceFaceKey *Keys;
+  const unsigned char *FaceSizes;
+  const vtkIdType *FacePoints;
+  int MaxFaceSize;
+  const vtkIdType *FaceOffsets;
+  vtkIdType NumberOfCells;
+  const vtkIdType *CellOffsets;
+  const vtkIdType *ConnOffsets;
+  const vtkIdType *PointMap;
+  vtkIdType *Offsets;
+  vtkIdType *Connectivity;
+  ArrayList *Arrays;
+  vtkIdType *OriginalCellIds;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+    {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      vtkIdType outId = this->CellOffsets[i];
+      if (this->CellOffsets[i+1] == outId)
+        {
+        continue;
+        }
+      vtkIdType faceId = this->Keys[i].second;
+      int numPts = this->FaceSizes[faceId];
+      const vtkIdType *pts = this->FacePoints + faceId * this->MaxFaceSize;
+      vtkIdType *outPts = this->Connectivity + this->ConnOffsets[i];
+      this->Offsets[outId] = this->ConnOffsets[i];
+      for (int k = 0; k < numPts; ++k)
+        {
+        outPts[k] = this->PointMap[pts[k]];
+        }
+      // The cell owning the face (cells without faces have empty ranges).
+      vtkIdType cellId = static_cast<vtkIdType>(
+        std::upper_bound(this->FaceOffsets,
+                         this->FaceOffsets + this->NumberOfCells + 1,
+                         faceId) - this->FaceOffsets) - 1;
+      this->Arrays->Copy(cellId, outId);
+      if (this->OriginalCellIds)
+        {
+        this->OriginalCellIds[outId] = cellId;
+        }
+      }
+    }
+};
+
+} //anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkDataSetSurfaceFilter::UnstructuredGridExecuteSMP(
+  vtkDataSet *dataSetInput, vtkPolyData *output)
+{
+  vtkUnstructuredGrid *input = vtkUnstructuredGrid::SafeDownCast(dataSetInput);
+  vtkIdType numCells = (input ? input->GetNumberOfCells() : 0);
+  if (numCells < 1 || !input->GetPoints() ||
+      !CanCopyArrays(input->GetPointData()) ||
+      !CanCopyArrays(input->GetCellData()))
+    {
+    return 0;
+    }
+  vtkIdType numPts = input->GetNumberOfPoints();
+
+  // Only grids of linear 3D cells whose faces are known are processed.
+  vtkUnsignedCharArray *types = input->GetCellTypesArray();
+  bool usedTypes[VTK_NUMBER_OF_CELL_TYPES] = { false };
+  std::vector<vtkIdType> faceOffsets(numCells + 1);
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+    unsigned char cellType = types->GetValue(cellId);
+    const int *faces = GetFaces(cellType);
+    if (!faces)
+      {
+      return 0;
+      }
+    usedTypes[cellType] = true;
+    faceOffsets[cellId] = faces[0];
+    }
+  int maxFaceSize = 0;
+  for (int cellType = 0; cellType < VTK_NUMBER_OF_CELL_TYPES; ++cellType)
+    {
+    const int *faces = (usedTypes[cellType] ? GetFaces(cellType) : NULL);
+    for (int i = 0, f = 1; faces && i < faces[0]; ++i, f += faces[f] + 1)
+      {
+      maxFaceSize = std::max(maxFaceSize, faces[f]);
+      }
+    }
+  vtkIdType numFaces = vtkSMPTools::ExclusiveScan(faceOffsets.begin(),
+    faceOffsets.begin() + numCells, faceOffsets.begin(), vtkIdType(0));
+  faceOffsets[numCells] = numFaces;
+  if (numFaces == 0)
+    {
+    return 0;
+    }
+
+  // Gather the faces, then sort them by bin and face id: this is the order
+  // in which the serial hash is traversed.
+  std::vector<vtkSurfaceFaceKey> keys(numFaces);
+  std::vector<unsigned char> faceSizes(numFaces);
+  std::vector<vtkIdType> facePoints(numFaces * maxFaceSize);
+  GatherFaces gather;
+  gather.Input = input;
+  gather.FaceOffsets = &faceOffsets[0];
+  gather.MaxFaceSize = maxFaceSize;
+  gather.Keys = &keys[0];
+  gather.FaceSizes = &faceSizes[0];
+  gather.FacePoints = &facePoints[0];
+  vtkSMPTools::For(0, numCells, gather);
+  this->UpdateProgress(0.25);
+  vtkSMPTools::Sort(keys.begin(), keys.end());
+  this->UpdateProgress(0.5);
+
+  // Keep the faces used by a single cell, and number them and their points.
+  std::vector<vtkIdType> cellOffsets(numFaces + 1);
+  std::vector<vtkIdType> connOffsets(numFaces + 1);
+  std::vector<vtkIdType> pointMap(numPts + 1, 0);
+  ClassifyFaces classify;
+  classify.Keys = &keys[0];
+  classify.NumberOfFaces = numFaces;
+  classify.FaceSizes = &faceSizes[0];
+  classify.FacePoints = &facePoints[0];
+  classify.MaxFaceSize = maxFaceSize;
+  classify.Ghosts = input->GetPointGhostArray();
+  classify.CellOffsets = &cellOffsets[0];
+  classify.ConnOffsets = &connOffsets[0];
+  classify.PointMap = &pointMap[0];
+  vtkSMPTools::For(0, numFaces, classify);
+  vtkIdType numOutCells = vtkSMPTools::ExclusiveScan(cellOffsets.begin(),
+    cellOffsets.begin() + numFaces, cellOffsets.begin(), vtkIdType(0));
+  cellOffsets[numFaces] = numOutCells;
+  vtkIdType connSize = vtkSMPTools::ExclusiveScan(connOffsets.begin(),
+    connOffsets.begin() + numFaces, connOffsets.begin(), vtkIdType(0));
+  connOffsets[numFaces] = connSize;
+  vtkIdType numOutPts = vtkSMPTools::ExclusiveScan(pointMap.begin(),
+    pointMap.begin() + numPts, pointMap.begin(), vtkIdType(0));
+  pointMap[numPts] = numOutPts;
+  this->UpdateProgress(0.75);
+
+  // Shallow copy field data not associated with points or cells
+  output->GetFieldData()->ShallowCopy(input->GetFieldData());
+
+  // The points and their data.
+  vtkPointData *inputPD = input->GetPointData();
+  vtkPointData *outputPD = output->GetPointData();
+  vtkPoints *newPts = vtkPoints::New();
+  newPts->SetDataType(input->GetPoints()->GetData()->GetDataType());
+  newPts->SetNumberOfPoints(numOutPts);
+  outputPD->CopyGlobalIdsOn();
+  outputPD->CopyAllocate(inputPD, numOutPts);
+  ArrayList pointArrays;
+  pointArrays.AddArrays(numOutPts, inputPD, outputPD);
+  vtkIdTypeArray *origPointIds = NULL;
+  if (this->PassThroughPointIds)
+    {
+    origPointIds = vtkIdTypeArray::New();
+    origPointIds->SetName(this->GetOriginalPointIdsName());
+    origPointIds->SetNumberOfTuples(numOutPts);
+    }
+  CopyPoints copyPoints;
+  copyPoints.InPoints = input->GetPoints();
+  copyPoints.OutPoints = newPts;
+  copyPoints.PointMap = &pointMap[0];
+  copyPoints.Arrays = &pointArrays;
+  copyPoints.OriginalPointIds =
+    (origPointIds ? origPointIds->GetPointer(0) : NULL);
+  vtkSMPTools::For(0, numPts, copyPoints);
+
+  // The polygons and their data.
+  vtkCellData *inputCD = input->GetCellData();
+  vtkCellData *outputCD = output->GetCellData();
+  vtkCellArray *newPolys = vtkCellArray::New();
+  newPolys->AllocateExact(numOutCells, connSize);
+  vtkIdType *offsets = static_cast<vtkIdTypeArray*>(
+    newPolys->GetOffsetsArray())->GetPointer(0);
+  offsets[numOutCells] = connSize;
+  outputCD->CopyGlobalIdsOn();
+  outputCD->CopyAllocate(inputCD, numOutCells);
+  ArrayList cellArrays;
+  cellArrays.AddArrays(numOutCells, inputCD, outputCD);
+  vtkIdTypeArray *origCellIds = NULL;
+  if (this->PassThroughCellIds)
+    {
+    origCellIds = vtkIdTypeArray::New();
+    origCellIds->SetName(this->GetOriginalCellIdsName());
+    origCellIds->SetNumberOfTuples(numOutCells);
+    }
+  FillPolys fill;
+  fill.Keys = &keys[0];
+  fill.FaceSizes = &faceSizes[0];
+  fill.FacePoints = &facePoints[0];
+  fill.MaxFaceSize = maxFaceSize;
+  fill.FaceOffsets = &faceOffsets[0];
+  fill.NumberOfCells = numCells;
+  fill.CellOffsets = &cellOffsets[0];
+  fill.ConnOffsets = &connOffsets[0];
+  fill.PointMap = &pointMap[0];
+  fill.Offsets = offsets;
+  fill.Connectivity = static_cast<vtkIdTypeArray*>(
+    newPolys->GetConnectivityArray())->GetPointer(0);
+  fill.Arrays = &cellArrays;
+  fill.OriginalCellIds = (origCellIds ? origCellIds->GetPointer(0) : NULL);
+  vtkSMPTools::For(0, numFaces, fill);
+
+  output->SetPoints(newPts);
+  newPts->Delete();
+  output->SetPolys(newPolys);
+  newPolys->Delete();
+  if (origCellIds)
+    {
+    outputCD->AddArray(origCellIds);
+    origCellIds->Delete();
+    }
+  if (origPointIds)
+    {
+    outputPD->AddArray(origPointIds);
+    origPointIds->Delete();
+    }
+
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 void vtkDataSetSurfaceFilter::InitializeQuadHash(vtkIdType numPoints)
 {
@@ -2050,54 +2612,25 @@ void vtkDataSetSurfaceFilter::InsertQuadInHash(vtkIdType a, vtkIdType b,
                                                vtkIdType c, vtkIdType d,
                                                vtkIdType sourceId)
 {
-  vtkIdType tmp;
   vtkFastGeomQuad *quad, **end;
 
-  // Reorder to get smallest id in a.
-  if (b < a && b < c && b < d)
-    {
-    tmp = a;
-    a = b;
-    b = c;
-    c = d;
-    d = tmp;
-    }
-  else if (c < a && c < b && c < d)
-    {
-    tmp = a;
-    a = c;
-    c = tmp;
-    tmp = b;
-    b = d;
-    d = tmp;
-    }
-  else if (d < a && d < b && d < c)
-    {
-    tmp = a;
-    a = d;
-    d = c;
-    c = b;
-    b = tmp;
-    }
+  // Reorder to get smallest id in ids[0].
+  vtkIdType ids[4] = {a, b, c, d};
+  vtkOrderQuadIds(ids);
 
   // Look for existing quad in the hash;
-  end = this->QuadHash + a;
+  end = this->QuadHash + ids[0];
   quad = *end;
   while (quad)
     {
     end = &(quad->Next);
-    // a has to match in this bin.
-    // c should be independent of point order.
-    if (quad->numPts == 4 && c == quad->ptArray[2])
+    // ids[0] has to match in this bin.
+    if (quad->numPts == 4 && vtkSameFaceIds(ids, quad->ptArray, 4))
       {
-      // Check boh orders for b and d.
-      if ((b == quad->ptArray[1] && d == quad->ptArray[3]) || (b == quad->ptArray[3] && d == quad->ptArray[1]))
-        {
-        // We have a match.
-        quad->SourceId = -1;
-        // That is all we need to do.  Hide any quad shared by two or more cells.
-        return;
-        }
+      // We have a match.
+      quad->SourceId = -1;
+      // That is all we need to do.  Hide any quad shared by two or more cells.
+      return;
       }
     quad = *end;
     }
@@ -2106,10 +2639,7 @@ void vtkDataSetSurfaceFilter::InsertQuadInHash(vtkIdType a, vtkIdType b,
   quad = this->NewFastGeomQuad(4);
   quad->Next = NULL;
   quad->SourceId = sourceId;
-  quad->ptArray[0] = a;
-  quad->ptArray[1] = b;
-  quad->ptArray[2] = c;
-  quad->ptArray[3] = d;
+  std::copy(ids, ids + 4, quad->ptArray);
   *end = quad;
 }
 
@@ -2118,43 +2648,25 @@ void vtkDataSetSurfaceFilter::InsertTriInHash(vtkIdType a, vtkIdType b,
                                               vtkIdType c, vtkIdType sourceId,
                                               vtkIdType vtkNotUsed(faceId)/*= -1*/)
 {
-  vtkIdType tmp;
   vtkFastGeomQuad *quad, **end;
 
-  // Reorder to get smallest id in a.
-  if (b < a && b < c)
-    {
-    tmp = a;
-    a = b;
-    b = c;
-    c = tmp;
-    }
-  else if (c < a && c < b)
-    {
-    tmp = a;
-    a = c;
-    c = b;
-    b = tmp;
-    }
-  // We can't put the second smnallest in b because it might change the order
-  // of the vertices in the final triangle.
+  // Reorder to get smallest id in ids[0].
+  vtkIdType ids[3] = {a, b, c};
+  vtkOrderTriIds(ids);
 
   // Look for existing tri in the hash;
-  end = this->QuadHash + a;
+  end = this->QuadHash + ids[0];
   quad = *end;
   while (quad)
     {
     end = &(quad->Next);
-    // a has to match in this bin.
-    if (quad->numPts == 3)
+    // ids[0] has to match in this bin.
+    if (quad->numPts == 3 && vtkSameFaceIds(ids, quad->ptArray, 3))
       {
-      if ((b == quad->ptArray[1] && c == quad->ptArray[2]) || (b == quad->ptArray[2] && c == quad->ptArray[1]))
-        {
-        // We have a match.
-        quad->SourceId = -1;
-        // That is all we need to do. Hide any tri shared by two or more cells.
-        return;
-        }
+      // We have a match.
+      quad->SourceId = -1;
+      // That is all we need to do. Hide any tri shared by two or more cells.
+      return;
       }
     quad = *end;
     }
@@ -2163,9 +2675,7 @@ void vtkDataSetSurfaceFilter::InsertTriInHash(vtkIdType a, vtkIdType b,
   quad = this->NewFastGeomQuad(3);
   quad->Next = NULL;
   quad->SourceId = sourceId;
-  quad->ptArray[0] = a;
-  quad->ptArray[1] = b;
-  quad->ptArray[2] = c;
+  std::copy(ids, ids + 3, quad->ptArray);
   *end = quad;
 }
 
@@ -2180,22 +2690,10 @@ void vtkDataSetSurfaceFilter::InsertPolygonInHash(vtkIdType* ids,
 {
   vtkFastGeomQuad *quad, **end;
 
-  // find the index to the smallest id
-  vtkIdType offset = 0;
-  for(int i=0; i < numPts; i++)
-    {
-    if(ids[i] < ids[offset])
-      {
-      offset = i;
-      }
-    }
-
   // copy ids into ordered array with smallest id first
   vtkIdType* tab = new vtkIdType[numPts];
-  for(int i=0; i<numPts; i++)
-    {
-    tab[i] = ids[(offset+i)%numPts];
-    }
+  std::copy(ids, ids + numPts, tab);
+  vtkOrderPolygonIds(tab, numPts);
 
   // Look for existing hex in the hash;
   end = this->QuadHash + tab[0];
@@ -2205,55 +2703,14 @@ void vtkDataSetSurfaceFilter::InsertPolygonInHash(vtkIdType* ids,
     end = &(quad->Next);
     // a has to match in this bin.
     // first just check the polygon size.
-    bool match = true;
-    if (numPts == quad->numPts)
-      {
-      if ( tab[0] == quad->ptArray[0])
-        {
-        // if the first two points match loop through forwards
-        // checking all points
-        if (tab[1] == quad->ptArray[1])
-          {
-          for (int i = 2; i < numPts; ++i)
-            {
-            if ( tab[i] != quad->ptArray[i])
-              {
-              match = false;
-              break;
-              }
-            }
-          }
-        else
-          {
-          // check if the points go in the opposite direction
-          for (int i = 1; i < numPts; ++i)
-            {
-            if ( tab[numPts-i] != quad->ptArray[i])
-              {
-              match = false;
-              break;
-              }
-            }
-          }
-        }
-      else
-        {
-        match = false;
-        }
-      }
-    else
+    if (numPts == quad->numPts && vtkSameFaceIds(tab, quad->ptArray, numPts))
       {
-      match = false;
+      // We have a match.
+      quad->SourceId = -1;
+      // That is all we need to do. Hide any tri shared by two or more cells.
+      delete [] tab;
+      return;
       }
-
-      if (match)
-        {
-        // We have a match.
-        quad->SourceId = -1;
-        // That is all we need to do. Hide any tri shared by two or more cells.
-        delete [] tab;
-        return;
-        }
     quad = *end;
     }
 
@@ -2262,10 +2719,7 @@ void vtkDataSetSurfaceFilter::InsertPolygonInHash(vtkIdType* ids,
   // mark the structure as a polygon
   quad->Next = NULL;
   quad->SourceId = sourceId;
-  for (int i = 0; i < numPts; i++)
-    {
-      quad->ptArray[i] = tab[i];
-    }
+  std::copy(tab, tab + numPts, quad->ptArray);
   *end = quad;
 
   delete [] tab;
@@ -18,6 +18,9 @@
 // does not have an option to select bounds.  It may use more memory than
 // vtkGeometryFilter.  It only has one option: whether to use triangle strips
 // when the input type is structured.
+//
+// When EnableSMP is on, the external faces of unstructured grids made of
+// linear 3D cells are extracted in parallel with vtkSMPTools.
 
 // .SECTION See Also
 // vtkGeometryFilter vtkStructuredGridGeometryFilter.
@@ -112,6 +115,22 @@ public:
   vtkSetMacro(NonlinearSubdivisionLevel, int);
   vtkGetMacro(NonlinearSubdivisionLevel, int);
 
+  // Description:
+  // When this flag is on (default is off), the external faces of
+  // unstructured grids made only of tetrahedra, hexahedra, voxels, wedges,
+  // pyramids, and pentagonal and hexagonal prisms are extracted in parallel
+  // with vtkSMPTools. The faces of the cells are gathered and sorted by
+  // their smallest point id, the faces used by a single cell are kept, and
+  // the output points, polygons and attributes are filled concurrently.
+  // The output polygons (and their cell data and original cell ids) are the
+  // same as the serial ones, in the same order; the output points are
+  // ordered by input point id instead of by first use. Other inputs, and
+  // inputs with attribute arrays that are not named data arrays, are
+  // processed serially.
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+
   // Description:
   // Direct access methods that can be used to use the this class as an
   // algorithm without using it as a filter.
@@ -132,6 +151,11 @@ public:
 #endif
   virtual int UnstructuredGridExecute(vtkDataSet *input,
                                       vtkPolyData *output);
+  // Threaded version of UnstructuredGridExecute(), see EnableSMP. It returns
+  // 0, without producing any output, when the input cannot be processed in
+  // parallel.
+  virtual int UnstructuredGridExecuteSMP(vtkDataSet *input,
+                                         vtkPolyData *output);
   virtual int DataSetExecute(vtkDataSet *input, vtkPolyData *output);
   virtual int UniformGridExecute(
       vtkDataSet *input, vtkPolyData *output,
@@ -245,6 +269,8 @@ protected:
 
   int NonlinearSubdivisionLevel;
 
+  bool EnableSMP;
+
 private:
   vtkDataSetSurfaceFilter(const vtkDataSetSurfaceFilter&);  // Not implemented.
   void operator=(const vtkDataSetSurfaceFilter&);  // Not implemented.
@@ -0,0 +1,171 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestNearestNeighborGraph.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check the k-nearest neighbor graph, computed with several threads and
+// with different locators, against brute force.
+
+#include "vtkCellArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkKdTreePointLocator.h"
+#include "vtkMath.h"
+#include "vtkNearestNeighborGraph.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticPointLocator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace
+{
+bool CheckGraph(vtkPolyData *input, vtkAbstractPointLocator *locator,
+                const char *name)
+{
+  const int N = 5;
+  vtkSmartPointer<vtkNearestNeighborGraph> graph =
+    vtkSmartPointer<vtkNearestNeighborGraph>::New();
+  graph->SetInputData(input);
+  graph->SetNumberOfNeighbors(N);
+  graph->SetLocator(locator);
+  graph->Update();
+  vtkPolyData *output = graph->GetOutput();
+
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkIdTypeArray *neighbors = vtkIdTypeArray::SafeDownCast(
+    output->GetPointData()->GetArray("NeighborIds"));
+  vtkFloatArray *distances = vtkFloatArray::SafeDownCast(
+    output->GetPointData()->GetArray("NeighborDistances"));
+  if (output->GetNumberOfPoints() != numPts || !neighbors || !distances ||
+      neighbors->GetNumberOfComponents() != N ||
+      neighbors->GetNumberOfTuples() != numPts ||
+      distances->GetNumberOfTuples() != numPts)
+    {
+    cerr << "Wrong output arrays with " << name << endl;
+    return false;
+    }
+
+  std::vector<double> expected(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    double x[3];
+    input->GetPoint(i, x);
+    for (vtkIdType j = 0; j < numPts; ++j)
+      {
+      expected[j] = (i == j ? VTK_DOUBLE_MAX : sqrt(
+        vtkMath::Distance2BetweenPoints(x, input->GetPoint(j))));
+      }
+    std::sort(expected.begin(), expected.end());
+    for (int j = 0; j < N; ++j)
+      {
+      vtkIdType neighbor = neighbors->GetComponent(i, j);
+      if (neighbor == i || neighbor < 0 || neighbor >= numPts ||
+          fabs(distances->GetComponent(i, j) - expected[j]) > 1.0e-5)
+        {
+        cerr << "Wrong neighbor " << j << " of " << i << " with " << name
+             << endl;
+        return false;
+        }
+      }
+    }
+
+  // Each edge joins a point and one of its neighbors, and appears once.
+  std::set<std::pair<vtkIdType, vtkIdType> > edges;
+  vtkCellArray *lines = output->GetLines();
+  vtkIdType npts, *pts;
+  for (lines->InitTraversal(); lines->GetNextCell(npts, pts); )
+    {
+    std::pair<vtkIdType, vtkIdType> edge(std::min(pts[0], pts[1]),
+                                         std::max(pts[0], pts[1]));
+    if (npts != 2 || !edges.insert(edge).second)
+      {
+      cerr << "Wrong or duplicated edge with " << name << endl;
+      return false;
+      }
+    }
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    for (int j = 0; j < N; ++j)
+      {
+      vtkIdType neighbor = neighbors->GetComponent(i, j);
+      if (!edges.count(std::make_pair(std::min(i, neighbor),
+                                      std::max(i, neighbor))))
+        {
+        cerr << "Missing edge between " << i << " and " << neighbor
+             << " with " << name << endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+}
+
+int TestNearestNeighborGraph(int, char*[])
+{
+  vtkSMPTools::Initialize(4);
+  vtkMath::RandomSeed(8775);
+
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+  for (int i = 0; i < 2000; ++i)
+    {
+    points->InsertNextPoint(vtkMath::Random(), vtkMath::Random(),
+                            vtkMath::Random());
+    }
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->SetPoints(points);
+
+  vtkSmartPointer<vtkStaticPointLocator> staticLocator =
+    vtkSmartPointer<vtkStaticPointLocator>::New();
+  vtkSmartPointer<vtkKdTreePointLocator> kdTreeLocator =
+    vtkSmartPointer<vtkKdTreePointLocator>::New();
+  if (!CheckGraph(input, staticLocator, "vtkStaticPointLocator") ||
+      !CheckGraph(input, kdTreeLocator, "vtkKdTreePointLocator"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // With fewer points than neighbors, the neighbors are padded with -1.
+  vtkSmartPointer<vtkPoints> fewPoints = vtkSmartPointer<vtkPoints>::New();
+  fewPoints->InsertNextPoint(0.0, 0.0, 0.0);
+  fewPoints->InsertNextPoint(1.0, 0.0, 0.0);
+  fewPoints->InsertNextPoint(0.0, 2.0, 0.0);
+  vtkSmartPointer<vtkPolyData> few = vtkSmartPointer<vtkPolyData>::New();
+  few->SetPoints(fewPoints);
+  vtkSmartPointer<vtkNearestNeighborGraph> graph =
+    vtkSmartPointer<vtkNearestNeighborGraph>::New();
+  graph->SetInputData(few);
+  graph->SetNumberOfNeighbors(4);
+  graph->Update();
+  vtkIdTypeArray *neighbors = vtkIdTypeArray::SafeDownCast(
+    graph->GetOutput()->GetPointData()->GetArray("NeighborIds"));
+  if (neighbors->GetComponent(0, 0) != 1 ||
+      neighbors->GetComponent(0, 1) != 2 ||
+      neighbors->GetComponent(0, 2) != -1 ||
+      neighbors->GetComponent(0, 3) != -1 ||
+      graph->GetOutput()->GetNumberOfLines() != 3)
+    {
+    cerr << "Wrong graph with fewer points than neighbors" << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
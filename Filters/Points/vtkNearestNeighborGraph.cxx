@@ -0,0 +1,302 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkNearestNeighborGraph.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkNearestNeighborGraph.h"
+
+#include "vtkAbstractPointLocator.h"
+#include "vtkCellArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMath.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticPointLocator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+vtkStandardNewMacro(vtkNearestNeighborGraph);
+vtkCxxSetObjectMacro(vtkNearestNeighborGraph,Locator,vtkAbstractPointLocator);
+
+//----------------------------------------------------------------------------
+// Helper classes to support efficient computing, and threaded execution.
+namespace {
+
+// Find the N+1 closest points of each point, and write them into the
+// output arrays without the point itself. The point is usually the first
+// one found, but coincident points may come before it; when it is not found
+// (too many coincident points), the farthest point is dropped instead.
+struct FindNeighbors
+{
+  vtkAbstractPointLocator *Locator;
+  vtkPoints *Points;
+  int N;
+  int NumberOfFound; // N+1, or the number of points when smaller
+  vtkIdType *Neighbors;
+  float *Distances;
+  vtkSMPThreadLocalObject<vtkIdList> Closest;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    vtkIdList *closest = this->Closest.Local();
+    double x[3], p[3];
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      this->Points->GetPoint(ptId, x);
+      this->Locator->FindClosestNPoints(this->NumberOfFound, x, closest);
+      vtkIdType numFound = closest->GetNumberOfIds();
+      const vtkIdType *ids = closest->GetPointer(0);
+      int self = this->N;
+      for (int i = 0; i < this->N && i < numFound; ++i)
+        {
+        if (ids[i] == ptId)
+          {
+          self = i;
+          break;
+          }
+        }
+      vtkIdType *neighbors = this->Neighbors + ptId * this->N;
+      float *distances = (this->Distances ? this->Distances + ptId * this->N :
+                          NULL);
+      for (int i = 0; i <= this->N; ++i)
+        {
+        if (i == self)
+          {
+          continue;
+          }
+        vtkIdType neighbor = (i < numFound ? ids[i] : -1);
+        *neighbors++ = neighbor;
+        if (distances)
+          {
+          if (neighbor < 0)
+            {
+            *distances++ = VTK_FLOAT_MAX;
+            }
+          else
+            {
+            this->Points->GetPoint(neighbor, p);
+            *distances++ = static_cast<float>(
+              sqrt(vtkMath::Distance2BetweenPoints(x, p)));
+            }
+          }
+        }
+      }
+    }
+};
+
+// Count, then generate, the edges of the undirected graph. The edge between
+// a point and one of its neighbors belongs to the point, unless the point
+// is also a neighbor of the neighbor and has the larger id.
+struct EdgeGenerator
+{
+  const vtkIdType *Neighbors;
+  int N;
+  vtkIdType *EdgeOffsets; // number of edges of each point, then offsets
+  vtkIdType *Offsets; // NULL when counting
+  vtkIdType *Connectivity;
+
+  bool OwnsEdge(vtkIdType ptId, vtkIdType neighbor) const
+    {
+    if (neighbor < 0)
+      {
+      return false;
+      }
+    if (neighbor > ptId)
+      {
+      return true;
+      }
+    const vtkIdType *neighbors = this->Neighbors + neighbor * this->N;
+    for (int i = 0; i < this->N; ++i)
+      {
+      if (neighbors[i] == ptId)
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+    {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      const vtkIdType *neighbors = this->Neighbors + ptId * this->N;
+      vtkIdType edgeId = this->EdgeOffsets[ptId];
+      vtkIdType numEdges = 0;
+      for (int i = 0; i < this->N; ++i)
+        {
+        if (!this->OwnsEdge(ptId, neighbors[i]))
+          {
+          continue;
+          }
+        if (this->Offsets)
+          {
+          this->Offsets[edgeId] = 2 * edgeId;
+          this->Connectivity[2 * edgeId] = ptId;
+          this->Connectivity[2 * edgeId + 1] = neighbors[i];
+          ++edgeId;
+          }
+        ++numEdges;
+        }
+      if (!this->Offsets)
+        {
+        this->EdgeOffsets[ptId] = numEdges;
+        }
+      }
+    }
+};
+
+} //anonymous namespace
+
+//================= Begin class proper =======================================
+//----------------------------------------------------------------------------
+vtkNearestNeighborGraph::vtkNearestNeighborGraph()
+{
+  this->NumberOfNeighbors = 6;
+  this->Locator = vtkStaticPointLocator::New();
+  this->GenerateDistances = 1;
+  this->GenerateEdges = 1;
+}
+
+//----------------------------------------------------------------------------
+vtkNearestNeighborGraph::~vtkNearestNeighborGraph()
+{
+  this->SetLocator(NULL);
+}
+
+//----------------------------------------------------------------------------
+int vtkNearestNeighborGraph::RequestData(
+  vtkInformation *vtkNotUsed(request),
+  vtkInformationVector **inputVector,
+  vtkInformationVector *outputVector)
+{
+  // get the info objects
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+
+  // get the input and output
+  vtkPointSet *input = vtkPointSet::SafeDownCast(
+    inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkPolyData *output = vtkPolyData::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  vtkPoints *inPts = input->GetPoints();
+  vtkIdType numPts = input->GetNumberOfPoints();
+  if (!inPts || numPts < 1)
+    {
+    vtkDebugMacro(<<"No points to process");
+    return 1;
+    }
+  if (!this->Locator)
+    {
+    vtkErrorMacro(<<"Point locator required\n");
+    return 0;
+    }
+
+  // Find the closest points of each point, writing them directly into the
+  // output arrays.
+  int N = this->NumberOfNeighbors;
+  this->Locator->SetDataSet(input);
+  this->Locator->BuildLocator();
+
+  vtkIdTypeArray *neighbors = vtkIdTypeArray::New();
+  neighbors->SetName("NeighborIds");
+  neighbors->SetNumberOfComponents(N);
+  neighbors->SetNumberOfTuples(numPts);
+  vtkFloatArray *distances = NULL;
+  if (this->GenerateDistances)
+    {
+    distances = vtkFloatArray::New();
+    distances->SetName("NeighborDistances");
+    distances->SetNumberOfComponents(N);
+    distances->SetNumberOfTuples(numPts);
+    }
+  FindNeighbors find;
+  find.Locator = this->Locator;
+  find.Points = inPts;
+  find.N = N;
+  find.NumberOfFound = static_cast<int>(
+    std::min(static_cast<vtkIdType>(N) + 1, numPts));
+  find.Neighbors = neighbors->GetPointer(0);
+  find.Distances = (distances ? distances->GetPointer(0) : NULL);
+  vtkSMPTools::For(0, numPts, find);
+  this->UpdateProgress(0.8);
+
+  // Pass the points and their data.
+  output->SetPoints(inPts);
+  output->GetPointData()->PassData(input->GetPointData());
+  output->GetPointData()->AddArray(neighbors);
+  neighbors->Delete();
+  if (distances)
+    {
+    output->GetPointData()->AddArray(distances);
+    distances->Delete();
+    }
+
+  if (this->GenerateEdges)
+    {
+    std::vector<vtkIdType> edgeOffsets(numPts + 1, 0);
+    EdgeGenerator edges;
+    edges.Neighbors = find.Neighbors;
+    edges.N = N;
+    edges.EdgeOffsets = &edgeOffsets[0];
+    edges.Offsets = NULL;
+    edges.Connectivity = NULL;
+    vtkSMPTools::For(0, numPts, edges);
+    vtkIdType numEdges = vtkSMPTools::ExclusiveScan(edgeOffsets.begin(),
+      edgeOffsets.begin() + numPts, edgeOffsets.begin(), vtkIdType(0));
+
+    vtkCellArray *lines = vtkCellArray::New();
+    lines->AllocateExact(numEdges, 2 * numEdges);
+    edges.Offsets = static_cast<vtkIdTypeArray*>(
+      lines->GetOffsetsArray())->GetPointer(0);
+    edges.Offsets[numEdges] = 2 * numEdges;
+    edges.Connectivity = static_cast<vtkIdTypeArray*>(
+      lines->GetConnectivityArray())->GetPointer(0);
+    vtkSMPTools::For(0, numPts, edges);
+    output->SetLines(lines);
+    lines->Delete();
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkNearestNeighborGraph::FillInputPortInformation(int, vtkInformation *info)
+{
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkPointSet");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkNearestNeighborGraph::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number Of Neighbors: " << this->NumberOfNeighbors << "\n";
+  os << indent << "Locator: " << this->Locator << "\n";
+  os << indent << "Generate Distances: "
+     << (this->GenerateDistances ? "On" : "Off") << "\n";
+  os << indent << "Generate Edges: "
+     << (this->GenerateEdges ? "On" : "Off") << "\n";
+}
@@ -0,0 +1,110 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkNearestNeighborGraph.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkNearestNeighborGraph - compute the k-nearest neighbor graph of a point cloud
+
+// .SECTION Description
+// vtkNearestNeighborGraph finds, for each point of its input, the
+// NumberOfNeighbors closest other points. The output has the points and the
+// point data of the input, and a "NeighborIds" point data array
+// (vtkIdTypeArray) with NumberOfNeighbors components: the ids of the
+// neighbors of each point, sorted from closest to farthest, padded with -1
+// when the input has too few points. Since every point has the same number
+// of neighbors, this array is the graph in compressed sparse row form: the
+// neighbors of point i start at value i*NumberOfNeighbors.
+//
+// Optionally, the distances to the neighbors are output in a
+// "NeighborDistances" point data array, and the edges of the graph as line
+// cells. The lines form the undirected graph: two points are connected
+// (once) when either is one of the neighbors of the other.
+//
+// The neighbors are found with a point locator, by default a
+// vtkStaticPointLocator. Other locators (e.g. vtkKdTreePointLocator) may
+// perform better with highly non-uniform point distributions.
+
+// .SECTION Caveats
+// This class has been threaded with vtkSMPTools. Using TBB or other
+// non-sequential type (set in the CMake variable
+// VTK_SMP_IMPLEMENTATION_TYPE) may improve performance significantly.
+//
+// A point is never its own neighbor, but the points coincident with it are
+// neighbors at a null distance.
+
+// .SECTION See Also
+// vtkAbstractPointLocator vtkStaticPointLocator vtkKdTreePointLocator
+// vtkPointInterpolator
+
+#ifndef vtkNearestNeighborGraph_h
+#define vtkNearestNeighborGraph_h
+
+#include "vtkFiltersPointsModule.h" // For export macro
+#include "vtkPolyDataAlgorithm.h"
+
+class vtkAbstractPointLocator;
+
+class VTKFILTERSPOINTS_EXPORT vtkNearestNeighborGraph : public vtkPolyDataAlgorithm
+{
+public:
+  // Description:
+  // Standard methods for instantiating, obtaining type information, and
+  // printing.
+  static vtkNearestNeighborGraph *New();
+  vtkTypeMacro(vtkNearestNeighborGraph,vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Specify the number of neighbors of each point. By default, 6.
+  vtkSetClampMacro(NumberOfNeighbors,int,1,VTK_INT_MAX);
+  vtkGetMacro(NumberOfNeighbors,int);
+
+  // Description:
+  // Specify a point locator. By default a vtkStaticPointLocator is
+  // used. The locator performs efficient searches to find the neighbors of
+  // the points.
+  void SetLocator(vtkAbstractPointLocator *locator);
+  vtkGetObjectMacro(Locator,vtkAbstractPointLocator);
+
+  // Description:
+  // Indicate whether to output the distances to the neighbors in a
+  // "NeighborDistances" point data array (vtkFloatArray). By default, on.
+  vtkSetMacro(GenerateDistances,int);
+  vtkGetMacro(GenerateDistances,int);
+  vtkBooleanMacro(GenerateDistances,int);
+
+  // Description:
+  // Indicate whether to output the edges of the undirected graph as line
+  // cells. By default, on.
+  vtkSetMacro(GenerateEdges,int);
+  vtkGetMacro(GenerateEdges,int);
+  vtkBooleanMacro(GenerateEdges,int);
+
+protected:
+  vtkNearestNeighborGraph();
+  ~vtkNearestNeighborGraph();
+
+  int NumberOfNeighbors;
+  vtkAbstractPointLocator *Locator;
+  int GenerateDistances;
+  int GenerateEdges;
+
+  virtual int RequestData(vtkInformation *, vtkInformationVector **,
+                          vtkInformationVector *);
+  virtual int FillInputPortInformation(int port, vtkInformation *info);
+
+private:
+  vtkNearestNeighborGraph(const vtkNearestNeighborGraph&);  // Not implemented.
+  void operator=(const vtkNearestNeighborGraph&);  // Not implemented.
+};
+
+#endif
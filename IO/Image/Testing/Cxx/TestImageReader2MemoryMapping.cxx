@@ -0,0 +1,138 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageReader2MemoryMapping.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Test the memory mapping of raw files by vtkImageReader2.
+
+#include "vtkImageData.h"
+#include "vtkImageReader2.h"
+#include "vtkMemoryMappedFile.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnsignedShortArray.h"
+
+#include <cstdio>
+#include <string>
+
+#define TEST_ASSERT(cond, msg) \
+  if (!(cond)) \
+    { \
+    cerr << "Failure at line " << __LINE__ << ": " << msg << endl; \
+    return EXIT_FAILURE; \
+    }
+
+// Read an extent. The reader is modified so that it does not keep a larger
+// extent read before.
+static vtkImageData *ReadExtent(vtkImageReader2 *reader, int extent[6])
+{
+  reader->Modified();
+  reader->UpdateExtent(extent);
+  return reader->GetOutput();
+}
+
+int TestImageReader2MemoryMapping(int argc, char *argv[])
+{
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  std::string fileName =
+    std::string(tempDir) + "/TestImageReader2MemoryMapping.raw";
+  delete [] tempDir;
+
+  // A 20x30x40 volume after a header of 16 bytes
+  const int dims[3] = { 20, 30, 40 };
+  FILE *file = fopen(fileName.c_str(), "wb");
+  TEST_ASSERT(file != NULL, "cannot create " << fileName);
+  char header[16] = { 0 };
+  fwrite(header, 1, sizeof(header), file);
+  for (int i = 0; i < dims[0]*dims[1]*dims[2]; ++i)
+    {
+    unsigned short value = static_cast<unsigned short>(i % 65536);
+    fwrite(&value, sizeof(value), 1, file);
+    }
+  fclose(file);
+
+  vtkNew<vtkImageReader2> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->SetFileDimensionality(3);
+  reader->SetDataScalarTypeToUnsignedShort();
+  reader->SetDataExtent(0, dims[0]-1, 0, dims[1]-1, 0, dims[2]-1);
+  reader->FileLowerLeftOn();
+  reader->MemoryMappingOn();
+  reader->Update();
+
+  vtkImageData *image = reader->GetOutput();
+  vtkUnsignedShortArray *scalars = vtkArrayDownCast<vtkUnsignedShortArray>(
+    image->GetPointData()->GetScalars());
+  TEST_ASSERT(scalars, "no scalars");
+  TEST_ASSERT(scalars->IsMapped() == vtkMemoryMappedFile::IsSupported(),
+              "scalars not mapped");
+  TEST_ASSERT(scalars->GetNumberOfTuples() == dims[0]*dims[1]*dims[2],
+              "wrong number of values");
+  TEST_ASSERT(image->GetScalarComponentAsDouble(5, 6, 7, 0) ==
+              5 + dims[0]*(6 + dims[1]*7), "wrong mapped value");
+
+  // A range of slices
+  int slices[6] = { 0, dims[0]-1, 0, dims[1]-1, 10, 12 };
+  image = ReadExtent(reader.GetPointer(), slices);
+  TEST_ASSERT(image->GetPointData()->GetScalars()->GetNumberOfTuples() ==
+              dims[0]*dims[1]*3, "wrong number of values in slices");
+  TEST_ASSERT(image->GetScalarComponentAsDouble(1, 2, 11, 0) ==
+              1 + dims[0]*(2 + dims[1]*11), "wrong value in slices");
+
+  // Extents that are not contiguous are read
+  int subExtent[6] = { 2, 5, 0, dims[1]-1, 10, 12 };
+  image = ReadExtent(reader.GetPointer(), subExtent);
+  scalars = vtkArrayDownCast<vtkUnsignedShortArray>(
+    image->GetPointData()->GetScalars());
+  TEST_ASSERT(!scalars->IsMapped(), "sub-extent mapped");
+  TEST_ASSERT(image->GetScalarComponentAsDouble(3, 2, 11, 0) ==
+              3 + dims[0]*(2 + dims[1]*11), "wrong value in sub-extent");
+
+  // A single row across several slices is not contiguous
+  int rows[6] = { 0, dims[0]-1, 6, 6, 10, 12 };
+  image = ReadExtent(reader.GetPointer(), rows);
+  scalars = vtkArrayDownCast<vtkUnsignedShortArray>(
+    image->GetPointData()->GetScalars());
+  TEST_ASSERT(!scalars->IsMapped(), "rows of several slices mapped");
+  TEST_ASSERT(image->GetScalarComponentAsDouble(3, 6, 12, 0) ==
+              3 + dims[0]*(6 + dims[1]*12), "wrong value in rows");
+
+  // A single row of a file stored upper left first
+  reader->FileLowerLeftOff();
+  int row[6] = { 0, dims[0]-1, 6, 6, 11, 11 };
+  image = ReadExtent(reader.GetPointer(), row);
+  scalars = vtkArrayDownCast<vtkUnsignedShortArray>(
+    image->GetPointData()->GetScalars());
+  TEST_ASSERT(scalars->IsMapped() == vtkMemoryMappedFile::IsSupported(),
+              "upper left row not mapped");
+  TEST_ASSERT(image->GetScalarComponentAsDouble(3, 6, 11, 0) ==
+              3 + dims[0]*(dims[1]-1-6 + dims[1]*11),
+              "wrong value in upper left row");
+  reader->FileLowerLeftOn();
+
+  // The data are the same without memory mapping
+  reader->MemoryMappingOff();
+  reader->UpdateWholeExtent();
+  image = reader->GetOutput();
+  scalars = vtkArrayDownCast<vtkUnsignedShortArray>(
+    image->GetPointData()->GetScalars());
+  TEST_ASSERT(!scalars->IsMapped(), "mapped without memory mapping");
+  TEST_ASSERT(image->GetScalarComponentAsDouble(5, 6, 7, 0) ==
+              5 + dims[0]*(6 + dims[1]*7), "wrong read value");
+
+  image->Initialize();
+  remove(fileName.c_str());
+
+  return EXIT_SUCCESS;
+}
@@ -417,7 +417,19 @@ void vtkImageReaderUpdate1(vtkImageReader *self, vtkImageData *data, T *inPtr)
 void vtkImageReader::ExecuteDataWithInformation(vtkDataObject *output,
                                                 vtkInformation *outInfo)
 {
-  vtkImageData *data = this->AllocateOutputData(output, outInfo);
+  // The values can only be mapped when they are used as they are stored.
+  vtkImageData *data = NULL;
+  if (!this->Transform && this->DataMask == static_cast<vtkTypeUInt64>(~0UL))
+    {
+    data = this->MapOutputData(output, outInfo);
+    }
+  if (data)
+    {
+    data->GetPointData()->GetScalars()->SetName(this->ScalarArrayName);
+    return;
+    }
+
+  data = this->AllocateOutputData(output, outInfo);
 
   void *ptr = NULL;
 
@@ -14,11 +14,13 @@
 =========================================================================*/
 #include "vtkImageReader2.h"
 
+#include "vtkAOSDataArrayTemplate.h"
 #include "vtkByteSwap.h"
 #include "vtkDataArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMemoryMappedFile.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkErrorCode.h"
@@ -72,6 +74,8 @@ vtkImageReader2::vtkImageReader2()
   this->FileNameSliceOffset = 0;
   this->FileNameSliceSpacing = 1;
 
+  this->MemoryMapping = 0;
+
   // Left over from short reader
   this->SwapBytes = 0;
   this->FileLowerLeft = 0;
@@ -447,6 +451,9 @@ void vtkImageReader2::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "HeaderSize: " << this->HeaderSize << "\n";
 
+  os << indent << "MemoryMapping: " <<
+    (this->MemoryMapping ? "On\n" : "Off\n");
+
   if ( this->InternalFileName )
     {
     os << indent << "Internal File Name: " << this->InternalFileName << "\n";
@@ -766,13 +773,153 @@ void vtkImageReader2Update(vtkImageReader2 *self, vtkImageData *data, OT *outPtr
     }
 }
 
+//----------------------------------------------------------------------------
+// Use the values of a memory mapped file in an array of the matching type.
+template <class T>
+int vtkImageReader2MapArray(vtkDataArray *array, vtkMemoryMappedFile *mapping,
+                            vtkIdType numValues, T*)
+{
+  vtkAOSDataArrayTemplate<T> *aos =
+    vtkArrayDownCast<vtkAOSDataArrayTemplate<T> >(array);
+  return aos && aos->SetMappedArray(mapping, numValues);
+}
+
+//----------------------------------------------------------------------------
+// Whether an array uses the values of a memory mapped file.
+template <class T>
+bool vtkImageReader2IsMappedArray(vtkDataArray *array, T*)
+{
+  vtkAOSDataArrayTemplate<T> *aos =
+    vtkArrayDownCast<vtkAOSDataArrayTemplate<T> >(array);
+  return aos && aos->IsMapped();
+}
+
+//----------------------------------------------------------------------------
+vtkImageData *vtkImageReader2::MapOutputData(vtkDataObject *output,
+                                             vtkInformation *outInfo)
+{
+  vtkImageData *data = vtkImageData::SafeDownCast(output);
+  if (!this->MemoryMapping || !data || this->MemoryBuffer ||
+      !vtkMemoryMappedFile::IsSupported() ||
+      (!this->FileName && !this->FilePattern && !this->FileNames))
+    {
+    return NULL;
+    }
+  int *uExt = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT());
+  if (vtkImageData::GetScalarType(outInfo) != this->DataScalarType ||
+      vtkImageData::GetNumberOfScalarComponents(outInfo) !=
+        this->NumberOfScalarComponents)
+    {
+    return NULL;
+    }
+
+  this->ComputeDataIncrements();
+  int scalarSize = static_cast<int>(this->DataIncrements[0] /
+                                    this->NumberOfScalarComponents);
+  // The requested values must be contiguous in a single file and usable as
+  // they are stored: whole rows, whole slices (stored lower left first)
+  // unless a single row is requested, and whole slices in a single 3D
+  // file unless a single slice is requested.
+  bool wholeSlices = (uExt[2] == this->DataExtent[2] &&
+                      uExt[3] == this->DataExtent[3]);
+  if ((this->SwapBytes && scalarSize > 1) ||
+      uExt[0] != this->DataExtent[0] || uExt[1] != this->DataExtent[1] ||
+      (uExt[2] != uExt[3] && (!this->FileLowerLeft || !wholeSlices)) ||
+      (uExt[4] != uExt[5] &&
+       (this->FileDimensionality != 3 || !wholeSlices)) ||
+      this->FileDimensionality < 2 || this->FileDimensionality > 3)
+    {
+    return NULL;
+    }
+
+  // Same offset as the one used by SeekFile().
+  vtkTypeInt64 offset = this->GetHeaderSize(uExt[4]);
+  vtkTypeInt64 row = (this->FileLowerLeft ?
+                      uExt[2] - this->DataExtent[2] :
+                      this->DataExtent[3] - this->DataExtent[2] - uExt[2]);
+  offset += row * static_cast<vtkTypeInt64>(this->DataIncrements[1]);
+  if (this->FileDimensionality == 3)
+    {
+    offset += static_cast<vtkTypeInt64>(uExt[4] - this->DataExtent[4]) *
+      static_cast<vtkTypeInt64>(this->DataIncrements[2]);
+    }
+  vtkIdType numValues = static_cast<vtkIdType>(uExt[1] - uExt[0] + 1) *
+    (uExt[3] - uExt[2] + 1) * (uExt[5] - uExt[4] + 1) *
+    this->NumberOfScalarComponents;
+  if (numValues <= 0 || offset % scalarSize != 0)
+    {
+    return NULL;
+    }
+
+  this->ComputeInternalFileName(uExt[4]);
+  vtkMemoryMappedFile *mapping = vtkMemoryMappedFile::New();
+  mapping->SetModeToCopyOnWrite();
+  vtkDataArray *array = NULL;
+  if (mapping->Map(this->InternalFileName, offset,
+                   static_cast<vtkTypeInt64>(numValues) * scalarSize))
+    {
+    array = vtkDataArray::CreateDataArray(this->DataScalarType);
+    array->SetNumberOfComponents(this->NumberOfScalarComponents);
+    int mapped = 0;
+    switch (this->DataScalarType)
+      {
+      vtkTemplateMacro(mapped = vtkImageReader2MapArray(
+                         array, mapping, numValues, static_cast<VTK_TT*>(0)));
+      }
+    if (!mapped)
+      {
+      array->Delete();
+      array = NULL;
+      }
+    }
+  // The array keeps the mapping alive.
+  mapping->Delete();
+  if (!array)
+    {
+    return NULL;
+    }
+
+  vtkDebugMacro("Mapping extent: " << uExt[0] << ", " << uExt[1] << ", "
+                << uExt[2] << ", " << uExt[3] << ", "
+                << uExt[4] << ", " << uExt[5]);
+  data->SetExtent(uExt);
+  data->GetPointData()->SetScalars(array);
+  array->Delete();
+  return data;
+}
+
 //----------------------------------------------------------------------------
 // This function reads a data from a file.  The datas extent/axes
 // are assumed to be the same as the file extent/order.
 void vtkImageReader2::ExecuteDataWithInformation(vtkDataObject *output,
                                                  vtkInformation *outInfo)
 {
-  vtkImageData *data = this->AllocateOutputData(output, outInfo);
+  vtkImageData *data = this->MapOutputData(output, outInfo);
+  if (data)
+    {
+    data->GetPointData()->GetScalars()->SetName("ImageFile");
+    return;
+    }
+
+  // Read into new scalars rather than into the values mapped by a previous
+  // update, which AllocateOutputData() would reuse.
+  data = vtkImageData::SafeDownCast(output);
+  vtkDataArray *scalars = data ? data->GetPointData()->GetScalars() : NULL;
+  bool mapped = false;
+  if (scalars)
+    {
+    switch (scalars->GetDataType())
+      {
+      vtkTemplateMacro(mapped = vtkImageReader2IsMappedArray(
+                         scalars, static_cast<VTK_TT*>(0)));
+      }
+    }
+  if (mapped)
+    {
+    data->GetPointData()->SetScalars(NULL);
+    }
+
+  data = this->AllocateOutputData(output, outInfo);
 
   void *ptr;
 
@@ -206,6 +206,18 @@ public:
   vtkGetMacro(FileLowerLeft, int);
   vtkSetMacro(FileLowerLeft, int);
 
+  // Description:
+  // Set/Get whether the output scalars may use the file memory mapped
+  // (copy-on-write) instead of reading it (default off). This is only done
+  // when the requested extent is stored contiguously in a single file and
+  // the bytes do not need to be swapped: whole rows, FileLowerLeft on (or a
+  // single row), and a single slice for 2D files. The pages of the file are
+  // then only read when they are accessed. Otherwise the file is read as
+  // usual.
+  vtkSetMacro(MemoryMapping, int);
+  vtkGetMacro(MemoryMapping, int);
+  vtkBooleanMacro(MemoryMapping, int);
+
   // Description:
   // Set/Get the internal file name
   virtual void ComputeInternalFileName(int slice);
@@ -271,6 +283,14 @@ protected:
   int FileNameSliceOffset;
   int FileNameSliceSpacing;
 
+  int MemoryMapping;
+
+  // Description:
+  // Set the extent of the output to the update extent and use the memory
+  // mapped file as its scalars, if MemoryMapping is on and the update extent
+  // can be mapped. Returns the output, or NULL if the data must be read.
+  vtkImageData *MapOutputData(vtkDataObject *output, vtkInformation *outInfo);
+
   virtual int RequestInformation(vtkInformation* request,
                                  vtkInformationVector** inputVector,
                                  vtkInformationVector* outputVector);
@@ -1,2 +1,4 @@
 vtk_module(vtkTestingCore
+  DEPENDS
+    vtkCommonDataModel
   EXCLUDE_FROM_WRAPPING)
@@ -0,0 +1,220 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTestCellLattice.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// An unstructured grid mixing the kinds of cells, to compare the serial and
+// threaded (EnableSMP) executions of the filters processing such grids.
+//
+// CreateCellLattice(size, cells) returns a lattice of size^3 points, at
+// (i, j + 0.1 * i, k), whose cubes hold in turn a hexahedron, a voxel, two
+// wedges, a pyramid and a tetrahedron, three tetrahedra, and a hexahedron
+// or a polyhedron. The cells flags add polyhedra, vertices, poly-vertices
+// and empty cells, and lines, poly-lines, triangles, quads, pixels and
+// polygons on the bottom face, inserted among the 3D cells. The points have
+// "Scalars" and "Vectors" arrays, the cells a "CellIds" array.
+
+#ifndef vtkTestCellLattice_h
+#define vtkTestCellLattice_h
+
+#include <vtkCellData.h>
+#include <vtkCellType.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cmath> // Needed for sin and cos
+
+namespace vtkTest
+{
+// The cells added to the 3D cells of CreateCellLattice().
+enum LatticeCells
+{
+  LatticePolyhedra = 1,
+  LatticePointCells = 2,
+  LatticeSurfaceCells = 4,
+  LatticeAllCells = 7
+};
+
+inline vtkSmartPointer<vtkUnstructuredGrid> CreateCellLattice(int size,
+                                                              int cells = 0)
+{
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+  vtkSmartPointer<vtkDoubleArray> scalars =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  scalars->SetName("Scalars");
+  vtkSmartPointer<vtkDoubleArray> vectors =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  for (int k = 0; k < size; ++k)
+    {
+    for (int j = 0; j < size; ++j)
+      {
+      for (int i = 0; i < size; ++i)
+        {
+        double x[3] = { static_cast<double>(i), j + 0.1 * i,
+                        static_cast<double>(k) };
+        points->InsertNextPoint(x);
+        scalars->InsertNextValue(sin(0.7 * x[0]) + cos(0.5 * x[1]) +
+                                 0.3 * x[2]);
+        vectors->InsertNextTuple3(x[1], x[2], x[0] * x[1]);
+        }
+      }
+    }
+
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(points);
+  grid->Allocate();
+  const int quads[6][4] = { { 0, 3, 2, 1 }, { 4, 5, 6, 7 }, { 0, 1, 5, 4 },
+                            { 1, 2, 6, 5 }, { 2, 3, 7, 6 }, { 3, 0, 4, 7 } };
+  for (int k = 0; k < size - 1; ++k)
+    {
+    for (int j = 0; j < size - 1; ++j)
+      {
+      for (int i = 0; i < size - 1; ++i)
+        {
+        // The corners of the cube, in hexahedron order.
+        vtkIdType c[8];
+        for (int l = 0; l < 8; ++l)
+          {
+          int di = ((l + 1) / 2) % 2;
+          int dj = (l / 2) % 2;
+          int dk = l / 4;
+          c[l] = ((k + dk) * size + j + dj) * size + i + di;
+          }
+        switch ((i + 2 * j + 3 * k) % 6)
+          {
+          case 0:
+            grid->InsertNextCell(VTK_HEXAHEDRON, 8, c);
+            break;
+          case 1:
+            {
+            vtkIdType v[8] = { c[0], c[1], c[3], c[2],
+                               c[4], c[5], c[7], c[6] };
+            grid->InsertNextCell(VTK_VOXEL, 8, v);
+            }
+            break;
+          case 2:
+            {
+            vtkIdType w1[6] = { c[0], c[1], c[3], c[4], c[5], c[7] };
+            vtkIdType w2[6] = { c[1], c[2], c[3], c[5], c[6], c[7] };
+            grid->InsertNextCell(VTK_WEDGE, 6, w1);
+            grid->InsertNextCell(VTK_WEDGE, 6, w2);
+            }
+            break;
+          case 3:
+            {
+            vtkIdType p[5] = { c[0], c[1], c[2], c[3], c[6] };
+            vtkIdType t[4] = { c[0], c[4], c[5], c[6] };
+            grid->InsertNextCell(VTK_PYRAMID, 5, p);
+            grid->InsertNextCell(VTK_TETRA, 4, t);
+            }
+            break;
+          case 4:
+            {
+            vtkIdType t1[4] = { c[0], c[1], c[3], c[4] };
+            vtkIdType t2[4] = { c[1], c[2], c[3], c[6] };
+            vtkIdType t3[4] = { c[1], c[6], c[4], c[5] };
+            grid->InsertNextCell(VTK_TETRA, 4, t1);
+            grid->InsertNextCell(VTK_TETRA, 4, t2);
+            grid->InsertNextCell(VTK_TETRA, 4, t3);
+            }
+            break;
+          default:
+            if (cells & LatticePolyhedra)
+              {
+              vtkIdType faces[30];
+              for (int f = 0; f < 6; ++f)
+                {
+                faces[5 * f] = 4;
+                for (int v = 0; v < 4; ++v)
+                  {
+                  faces[5 * f + 1 + v] = c[quads[f][v]];
+                  }
+                }
+              grid->InsertNextCell(VTK_POLYHEDRON, 8, c, 6, faces);
+              }
+            else
+              {
+              grid->InsertNextCell(VTK_HEXAHEDRON, 8, c);
+              }
+            break;
+          }
+
+        if ((cells & LatticePointCells) && (i + j + k) % 5 == 0)
+          {
+          grid->InsertNextCell(VTK_VERTEX, 1, c + 6);
+          if (i == j && j == k)
+            {
+            grid->InsertNextCell(VTK_EMPTY_CELL, 0, c);
+            vtkIdType pv[3] = { c[0], c[6], c[3] };
+            grid->InsertNextCell(VTK_POLY_VERTEX, 3, pv);
+            }
+          }
+
+        if ((cells & LatticeSurfaceCells) && k == 0)
+          {
+          switch ((i + j * size) % 6)
+            {
+            case 0:
+              grid->InsertNextCell(VTK_QUAD, 4, c);
+              break;
+            case 1:
+              {
+              vtkIdType pixel[4] = { c[0], c[1], c[3], c[2] };
+              grid->InsertNextCell(VTK_PIXEL, 4, pixel);
+              }
+              break;
+            case 2:
+              grid->InsertNextCell(VTK_TRIANGLE, 3, c);
+              grid->InsertNextCell(VTK_TRIANGLE, 3, c + 1);
+              break;
+            case 3:
+              grid->InsertNextCell(VTK_LINE, 2, c);
+              grid->InsertNextCell(VTK_LINE, 2, c + 1);
+              break;
+            case 4:
+              grid->InsertNextCell(VTK_POLY_LINE, 4, c);
+              break;
+            default:
+              {
+              vtkIdType polygon[5] = { c[0], c[1], c[2], c[3], c[7] };
+              grid->InsertNextCell(VTK_POLYGON, 5, polygon);
+              }
+              break;
+            }
+          }
+        }
+      }
+    }
+
+  grid->GetPointData()->SetScalars(scalars);
+  grid->GetPointData()->SetVectors(vectors);
+  vtkSmartPointer<vtkIdTypeArray> cellIds =
+    vtkSmartPointer<vtkIdTypeArray>::New();
+  cellIds->SetName("CellIds");
+  for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); ++cellId)
+    {
+    cellIds->InsertNextValue(cellId);
+    }
+  grid->GetCellData()->AddArray(cellIds);
+  return grid;
+}
+}
+
+#endif
@@ -0,0 +1,217 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTestDataSetComparison.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Helpers comparing two outputs of a filter, typically its serial and
+// threaded (EnableSMP) outputs: arrays, attributes, cells and datasets.
+// Values are the same when they differ by at most tolerance * (1 + |x|),
+// so that a zero tolerance asks for identical values; two NaNs are the same.
+
+#ifndef vtkTestDataSetComparison_h
+#define vtkTestDataSetComparison_h
+
+#include <vtkAbstractArray.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkUnstructuredGrid.h>
+#include <vtkVariant.h>
+
+#include <cmath> // Needed for fabs
+#include <cstring> // Needed for memcmp
+
+namespace vtkTest
+{
+inline bool SameValues(double x, double y, double tolerance)
+{
+  return x == y || fabs(x - y) <= tolerance * (1.0 + fabs(x)) ||
+    (vtkMath::IsNan(x) && vtkMath::IsNan(y));
+}
+
+// Compare the tuple i of a with the tuple j of b. Two NULL arrays are the
+// same.
+inline bool SameTuples(vtkDataArray *a, vtkIdType i, vtkDataArray *b,
+                       vtkIdType j, double tolerance = 0.0)
+{
+  if (!a || !b)
+    {
+    return a == b;
+    }
+  if (a->GetNumberOfComponents() != b->GetNumberOfComponents())
+    {
+    return false;
+    }
+  for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+    {
+    if (!SameValues(a->GetComponent(i, c), b->GetComponent(j, c), tolerance))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+// Compare two arrays value by value: data arrays numerically, the other
+// arrays (e.g., string arrays) through their variant values. Two NULL
+// arrays are the same.
+inline bool SameArrays(vtkAbstractArray *a, vtkAbstractArray *b,
+                       double tolerance = 0.0)
+{
+  if (!a || !b)
+    {
+    return a == b;
+    }
+  if (a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+    {
+    return false;
+    }
+  vtkDataArray *dataA = vtkDataArray::SafeDownCast(a);
+  vtkDataArray *dataB = vtkDataArray::SafeDownCast(b);
+  if (dataA && dataB)
+    {
+    for (vtkIdType i = 0; i < a->GetNumberOfTuples(); ++i)
+      {
+      if (!SameTuples(dataA, i, dataB, i, tolerance))
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+  if (dataA || dataB)
+    {
+    return false;
+    }
+  for (vtkIdType i = 0; i < a->GetNumberOfValues(); ++i)
+    {
+    if (!(a->GetVariantValue(i) == b->GetVariantValue(i)))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+// Compare the arrays of two field data, by name, and the active attributes
+// of dataset attributes.
+inline bool SameAttributes(vtkFieldData *a, vtkFieldData *b,
+                           double tolerance = 0.0)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+    {
+    return false;
+    }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+    {
+    const char *name = a->GetArrayName(i);
+    vtkAbstractArray *other = (name ? b->GetAbstractArray(name) :
+                               b->GetAbstractArray(i));
+    if (!other || !SameArrays(a->GetAbstractArray(i), other, tolerance))
+      {
+      return false;
+      }
+    }
+  vtkDataSetAttributes *attributesA = vtkDataSetAttributes::SafeDownCast(a);
+  vtkDataSetAttributes *attributesB = vtkDataSetAttributes::SafeDownCast(b);
+  for (int i = 0; attributesA && attributesB &&
+         i < vtkDataSetAttributes::NUM_ATTRIBUTES; ++i)
+    {
+    vtkAbstractArray *attributeA = attributesA->GetAbstractAttribute(i);
+    vtkAbstractArray *attributeB = attributesB->GetAbstractAttribute(i);
+    if ((!attributeA || !attributeB) ? attributeA != attributeB :
+        !SameArrays(attributeA, attributeB, tolerance))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+inline bool SameIds(vtkIdList *a, vtkIdList *b)
+{
+  return a->GetNumberOfIds() == b->GetNumberOfIds() &&
+    (a->GetNumberOfIds() == 0 ||
+     memcmp(a->GetPointer(0), b->GetPointer(0),
+            a->GetNumberOfIds() * sizeof(vtkIdType)) == 0);
+}
+
+// Compare the types and the point ids of the cells of two datasets, and
+// the faces of their polyhedra.
+inline bool SameCells(vtkDataSet *a, vtkDataSet *b)
+{
+  if (a->GetNumberOfCells() != b->GetNumberOfCells())
+    {
+    return false;
+    }
+  vtkUnstructuredGrid *gridA = vtkUnstructuredGrid::SafeDownCast(a);
+  vtkUnstructuredGrid *gridB = vtkUnstructuredGrid::SafeDownCast(b);
+  vtkNew<vtkIdList> ptsA;
+  vtkNew<vtkIdList> ptsB;
+  for (vtkIdType cellId = 0; cellId < a->GetNumberOfCells(); ++cellId)
+    {
+    if (a->GetCellType(cellId) != b->GetCellType(cellId))
+      {
+      return false;
+      }
+    a->GetCellPoints(cellId, ptsA.GetPointer());
+    b->GetCellPoints(cellId, ptsB.GetPointer());
+    if (!SameIds(ptsA.GetPointer(), ptsB.GetPointer()))
+      {
+      return false;
+      }
+    if (gridA && gridB && a->GetCellType(cellId) == VTK_POLYHEDRON)
+      {
+      gridA->GetFaceStream(cellId, ptsA.GetPointer());
+      gridB->GetFaceStream(cellId, ptsB.GetPointer());
+      if (!SameIds(ptsA.GetPointer(), ptsB.GetPointer()))
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+// Compare two datasets: their points, point data, cell data and cells.
+inline bool SameOutputs(vtkDataSet *a, vtkDataSet *b, double tolerance = 0.0)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints())
+    {
+    return false;
+    }
+  double xA[3], xB[3];
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+    {
+    a->GetPoint(i, xA);
+    b->GetPoint(i, xB);
+    for (int c = 0; c < 3; ++c)
+      {
+      if (!SameValues(xA[c], xB[c], tolerance))
+        {
+        return false;
+        }
+      }
+    }
+  return SameAttributes(a->GetPointData(), b->GetPointData(), tolerance) &&
+    SameAttributes(a->GetCellData(), b->GetCellData(), tolerance) &&
+    SameCells(a, b);
+}
+}
+
+#endif